@@ -0,0 +1,61 @@
+#!/bin/bash
+
+# Skrypt porównujący algorytmy wyszukiwania dróg krajowych.
+#
+# Użycie:
+# ./bench.sh MAP_PATH FILE_PATH [OPTION ...]
+# gdzie MAP_PATH to ścieżka do programu map, a FILE_PATH to ścieżka do
+# pliku z poleceniami. Pozostałe argumenty (np. "-t 4") są przekazywane
+# do programu map.
+#
+# Działanie:
+# Skrypt uruchamia program dla każdego algorytmu wyszukiwania (opcja -e)
+# z włączonymi licznikami (opcja -s) i wypisuje czas działania, liczbę
+# wyszukanych dróg oraz liczbę miast zdjętych ze sterty. Sprawdza też,
+# czy wyniki dla wszystkich algorytmów są identyczne. Jeśli parametry są
+# niepoprawne lub wyniki się różnią, skrypt kończy się kodem wyjścia 1.
+
+
+# Jeśli za mało parametrów.
+if (( $# < 2 ))
+	then
+		exit 1
+fi
+
+map="$1"
+file="$2"
+shift 2
+
+# Jeśli ścieżki są niepoprawne.
+if ! [ -x "$map" ] || ! [ -f "$file" ]
+	then
+		exit 1
+fi
+
+output=$(mktemp)
+reference=$(mktemp)
+statistics=$(mktemp)
+trap 'rm -f "$output" "$reference" "$statistics"' EXIT
+
+result=0
+for engine in dijkstra bidirectional alt ch
+	do
+		start=$(date +%s%N)
+		"$map" -e "$engine" -s "$@" < "$file" > "$output" 2> "$statistics"
+		end=$(date +%s%N)
+
+		echo "$engine: $(( (end - start) / 1000000 )) ms"
+		grep -E '^(searches|settled cities|landmark index builds|hierarchy builds|shortcuts|connectivity [a-z]+): ' "$statistics" | sed 's/^/  /'
+
+		# Wyniki pierwszego algorytmu są wzorcowe.
+		if [ "$engine" == "dijkstra" ]
+			then
+				cp "$output" "$reference"
+		elif ! cmp -s "$output" "$reference"
+			then
+				echo "  wyniki różnią się od algorytmu dijkstra"
+				result=1
+		fi
+	done
+
+exit $result
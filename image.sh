@@ -0,0 +1,65 @@
+#!/bin/bash
+
+# Skrypt sprawdzający zapytania do mapy odwzorowanej z obrazu.
+#
+# Użycie:
+# ./image.sh MAP_PATH MAP_FILE QUERIES_FILE [OPTION ...]
+# gdzie MAP_PATH to ścieżka do programu map, MAP_FILE to ścieżka do pliku
+# z poleceniami budującymi mapę, a QUERIES_FILE to ścieżka do pliku
+# z poleceniami, które jej nie zmieniają (np. "queryRoute",
+# "distanceMatrix", "getRouteDescription"). Pozostałe argumenty są
+# przekazywane do programu map.
+#
+# Działanie:
+# Skrypt buduje mapę poleceniami z pliku MAP_FILE i zapisuje ją zarówno
+# jako punkt kontrolny (opcja -w), jak i jako obraz (opcja -M). Następnie
+# dla każdego algorytmu wyszukiwania (opcja -e) wykonuje polecenia z pliku
+# QUERIES_FILE na mapie wczytanej z punktu kontrolnego (opcja -r) i na
+# mapie odwzorowanej z obrazu (opcja -m) i sprawdza, czy wyniki są
+# identyczne. Jeśli parametry są niepoprawne lub wyniki się różnią, skrypt
+# kończy się kodem wyjścia 1.
+
+
+# Jeśli za mało parametrów.
+if (( $# < 3 ))
+	then
+		exit 1
+fi
+
+map="$1"
+mapFile="$2"
+queriesFile="$3"
+shift 3
+
+# Jeśli ścieżki są niepoprawne.
+if ! [ -x "$map" ] || ! [ -f "$mapFile" ] || ! [ -f "$queriesFile" ]
+	then
+		exit 1
+fi
+
+directory=$(mktemp -d)
+trap 'rm -rf "$directory"' EXIT
+
+if ! "$map" "$@" -w "$directory/snapshot" -M "$directory/image" \
+		< "$mapFile" > /dev/null 2>&1
+	then
+		exit 1
+fi
+
+result=0
+for engine in dijkstra bidirectional alt ch
+	do
+		"$map" -e "$engine" "$@" -r "$directory/snapshot" \
+			< "$queriesFile" > "$directory/reference" 2> /dev/null
+		"$map" -e "$engine" "$@" -m "$directory/image" \
+			< "$queriesFile" > "$directory/output" 2> /dev/null
+
+		if ! cmp -s "$directory/output" "$directory/reference"
+			then
+				echo "$engine: wyniki dla obrazu różnią się od wyników dla punktu kontrolnego"
+				diff "$directory/reference" "$directory/output" | sed 's/^/  /'
+				result=1
+		fi
+	done
+
+exit $result
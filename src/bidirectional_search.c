@@ -0,0 +1,457 @@
+/** @file
+ * Implementacja dwukierunkowego algorytmu dijkstry szukającego dróg krajowych.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "bidirectional_search.h"
+#include "heap.h"
+#include "road.h"
+
+#include <stdlib.h>
+#include <assert.h>
+
+#define FORWARD_SETTLED 1   ///< miasto obsłużone w kierunku od startu
+#define BACKWARD_SETTLED 2  ///< miasto obsłużone w kierunku od celu
+
+/**
+ * Struktura przechowująca jeden kierunek dwukierunkowego algorytmu dijkstry.
+ */
+typedef struct SearchDirection {
+    Heap *heap;                     ///< sterta kierunku
+    int64_t *distance;              ///< odległości w danym kierunku
+    int64_t *oldestRoadOnRoute;     ///< najstarsze odcinki w danym kierunku
+    bool *isRouteUnequivocal;       ///< jednoznaczności w danym kierunku
+    City **parent;                  ///< poprzednik w drzewie danego kierunku
+    uint8_t settledFlag;            ///< flaga obsłużenia w danym kierunku
+    bool isRootSettled;             ///< czy obsłużono miasto startowe kierunku
+} SearchDirection;
+
+/** @brief Najlepsza znaleziona droga łącząca oba kierunki.
+ */
+typedef struct MeetingLabel {
+    int64_t distance;               ///< długość drogi
+    int64_t oldestRoad;             ///< najdawniej wybudowany odcinek drogi
+} MeetingLabel;
+
+/** @brief Klucz wierzchołka sterty danego kierunku.
+ * @param[in] direction         - wskaźnik na kierunek.
+ * @return Odległość na wierzchołku sterty lub @ref INFINITY, jeśli sterta
+ * jest pusta.
+ */
+int64_t topDistanceDirection(SearchDirection *direction) {
+    if (direction->heap->size == 0) {
+        return INFINITY;
+    }
+
+    return direction->heap->keys[1]->distance;
+}
+
+/** @brief Rozpoczyna jedno przejście dwukierunkowego algorytmu.
+ * Oznacza miasta drogi krajowej jako wykluczone (odległość @p -1 w obu
+ * kierunkach) i wstawia miasta startowe kierunków na sterty.
+ * @param[in] route             - wskaźnik na drogę krajową;
+ * @param[in] from              - wskaźnik na miasto startowe;
+ * @param[in] to                - wskaźnik na miasto docelowe;
+ * @param[in,out] state         - wskaźnik na stan algorytmu;
+ * @param[in,out] forward       - wskaźnik na kierunek od startu;
+ * @param[in,out] backward      - wskaźnik na kierunek od celu.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool startPassBidirectional(Route *route, City *from, City *to,
+                            SearchState *state, SearchDirection *forward,
+                            SearchDirection *backward) {
+    nextStampSearchState(state);
+
+    if (route->cities != NULL) {
+        ListIterator *iterator = route->cities->begin;
+        while (iterator != route->cities->end) {
+            uint32_t id = ((City *)iterator->data)->id;
+            touchCitySearchState(state, id);
+            state->distance[id] = -1;
+            state->backwardDistance[id] = -1;
+            iterator = iterator->next;
+        }
+    }
+
+    SearchDirection *directions[2] = {forward, backward};
+    City *roots[2] = {from, to};
+    for (int i = 0; i < 2; i++) {
+        uint32_t id = roots[i]->id;
+        touchCitySearchState(state, id);
+        state->distance[id] = INFINITY;
+        state->backwardDistance[id] = INFINITY;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        uint32_t id = roots[i]->id;
+        directions[i]->distance[id] = 0;
+        directions[i]->oldestRoadOnRoute[id] = INFINITY;
+        directions[i]->isRouteUnequivocal[id] = true;
+        directions[i]->isRootSettled = false;
+        if (!pushHeap(directions[i]->heap, 0, INFINITY, roots[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** @brief Obsługuje miasto z wierzchołka sterty danego kierunku.
+ * Zdejmuje miasto ze sterty i próbuje "poprawić" jego sąsiadów. Jeśli
+ * @p meeting nie jest NULL (pierwsze przejście), to dla każdego odcinka
+ * prowadzącego do miasta osiągniętego z drugiego kierunku sprawdza, czy
+ * złożona droga jest lepsza niż @p meeting.
+ * @param[in,out] state         - wskaźnik na stan algorytmu;
+ * @param[in,out] direction     - wskaźnik na obsługiwany kierunek;
+ * @param[in] other             - wskaźnik na drugi kierunek;
+ * @param[in] knownOldestRoad   - rok, od którego uwzględniamy odcinki lub
+ *                                @p 0 w pierwszym przejściu;
+ * @param[in,out] meeting       - wskaźnik na najlepszą drogę lub NULL.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool settleBidirectional(SearchState *state, SearchDirection *direction,
+                         SearchDirection *other, int64_t knownOldestRoad,
+                         MeetingLabel *meeting) {
+    Heap *heap = direction->heap;
+    City *ptr = heap->data[1];
+    uint32_t id = ptr->id;
+
+    /* Pomijamy nieaktualne wpisy na stercie. */
+    if (heap->keys[1]->distance != direction->distance[id] ||
+            (knownOldestRoad == 0 &&
+             heap->keys[1]->oldestRoad != direction->oldestRoadOnRoute[id]) ||
+            (state->settled[id] & direction->settledFlag)) {
+        popHeap(heap);
+        return true;
+    }
+
+    popHeap(heap);
+    state->settled[id] |= direction->settledFlag;
+    state->statistics.settledCitiesCount++;
+    direction->isRootSettled = true;
+    if (direction->settledFlag == FORWARD_SETTLED) {
+        state->settledCities[state->settledCitiesSize++] = ptr;
+    }
+
+    ListIterator *iterator = ptr->roads->begin;
+    while (iterator != ptr->roads->end) {
+        Road *road = iterator->data;
+        iterator = iterator->next;
+
+        if (road->isDeleted || road == state->skippedRoads[0] ||
+                road == state->skippedRoads[1] || (knownOldestRoad != 0 &&
+                knownOldestRoad > road->buildYearOrLastRepairYear)) {
+            continue;
+        }
+
+        uint32_t destination = road->destination->id;
+        touchCitySearchState(state, destination);
+        if (direction->distance[destination] < 0) {
+            continue;
+        }
+
+        int64_t distance = direction->distance[id] + road->length;
+        int64_t oldestRoute = minInt64_t(direction->oldestRoadOnRoute[id],
+                                         road->buildYearOrLastRepairYear);
+
+        /* Sprawdzamy drogę przechodzącą przez ten odcinek i kończącą się
+         * drogą z drugiego kierunku. */
+        if (meeting != NULL && other->distance[destination] != INFINITY) {
+            int64_t meetingDistance = distance + other->distance[destination];
+            int64_t meetingOldestRoad =
+                    minInt64_t(oldestRoute, other->oldestRoadOnRoute[destination]);
+
+            if (compareRoutes(meetingDistance, meetingOldestRoad,
+                              meeting->distance, meeting->oldestRoad) < 0) {
+                meeting->distance = meetingDistance;
+                meeting->oldestRoad = meetingOldestRoad;
+            }
+        }
+
+        int64_t compare;
+        if (knownOldestRoad == 0) {
+            compare = compareRoutes(distance, oldestRoute,
+                                    direction->distance[destination],
+                                    direction->oldestRoadOnRoute[destination]);
+        } else {
+            compare = distance - direction->distance[destination];
+        }
+
+        if (compare < 0) {
+            direction->distance[destination] = distance;
+            direction->oldestRoadOnRoute[destination] = oldestRoute;
+            direction->isRouteUnequivocal[destination] =
+                    direction->isRouteUnequivocal[id];
+            direction->parent[destination] = ptr;
+
+            if (!pushHeap(heap, distance, oldestRoute, road->destination)) {
+                return false;
+            }
+        } else if (compare == 0) {
+            direction->isRouteUnequivocal[destination] = false;
+        }
+    }
+
+    return true;
+}
+
+/** @brief Wykonuje jedno przejście dwukierunkowego algorytmu.
+ * Obsługuje naprzemiennie kierunek z mniejszym kluczem na wierzchołku sterty,
+ * aż suma kluczy obu kierunków przekroczy długość @p bound (lub długość
+ * najlepszej znalezionej drogi w pierwszym przejściu).
+ * @param[in,out] state         - wskaźnik na stan algorytmu;
+ * @param[in,out] forward       - wskaźnik na kierunek od startu;
+ * @param[in,out] backward      - wskaźnik na kierunek od celu;
+ * @param[in] knownOldestRoad   - rok, od którego uwzględniamy odcinki lub
+ *                                @p 0 w pierwszym przejściu;
+ * @param[in,out] meeting       - wskaźnik na najlepszą drogę lub NULL;
+ * @param[in] bound             - długość szukanej drogi (drugie przejście).
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool passBidirectional(SearchState *state, SearchDirection *forward,
+                       SearchDirection *backward, int64_t knownOldestRoad,
+                       MeetingLabel *meeting, int64_t bound) {
+    while (forward->heap->size != 0 || backward->heap->size != 0) {
+        int64_t forwardTop = topDistanceDirection(forward);
+        int64_t backwardTop = topDistanceDirection(backward);
+
+        if (meeting != NULL) {
+            bound = meeting->distance;
+        }
+
+        if (forward->isRootSettled && backward->isRootSettled &&
+                forwardTop + backwardTop > bound) {
+            break;
+        }
+
+        bool result;
+        if (forwardTop <= backwardTop) {
+            result = settleBidirectional(state, forward, backward,
+                                         knownOldestRoad, meeting);
+        } else {
+            result = settleBidirectional(state, backward, forward,
+                                         knownOldestRoad, meeting);
+        }
+
+        if (!result) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** @brief Odtwarza jednoznaczną drogę przechodzącą przez dany odcinek.
+ * @param[in] state             - wskaźnik na stan algorytmu;
+ * @param[in] from              - wskaźnik na miasto startowe;
+ * @param[in] to                - wskaźnik na miasto docelowe;
+ * @param[in] middle            - pierwsze miasto odcinka;
+ * @param[in] middleNext        - drugie miasto odcinka.
+ * @return Wskaźnik na listę miast drogi lub NULL, jeśli nie udało się
+ * zaalokować pamięci.
+ */
+List *recoverRouteBidirectional(SearchState *state, City *from, City *to,
+                                City *middle, City *middleNext) {
+    List *result = newList();
+    if (result == NULL) {
+        return NULL;
+    }
+
+    City *ptr = middle;
+    while (true) {
+        if (insertList(result->begin, ptr) == NULL) {
+            deleteList(result, false);
+            return NULL;
+        }
+
+        if (ptr == from) {
+            break;
+        }
+
+        ptr = state->previousOnRoute[ptr->id];
+    }
+
+    ptr = middleNext;
+    while (true) {
+        if (insertList(result->end, ptr) == NULL) {
+            deleteList(result, false);
+            return NULL;
+        }
+
+        if (ptr == to) {
+            break;
+        }
+
+        ptr = state->nextOnRoute[ptr->id];
+    }
+
+    return result;
+}
+
+/** @brief Sprawdza jednoznaczność drogi po drugim przejściu i ją odtwarza.
+ * Każda najkrótsza droga zawiera dokładnie jeden odcinek (u, v) taki, że
+ * odległość u od startu jest mniejsza niż @p middle, a odległość v od startu
+ * jest nie mniejsza niż @p middle. Miasto u jest wtedy obsłużone w kierunku od
+ * startu, a v w kierunku od celu, więc najkrótsza droga jest jednoznaczna
+ * wtedy i tylko wtedy, gdy jest dokładnie jeden taki odcinek i drogi do jego
+ * końców są jednoznaczne.
+ * @param[in] state             - wskaźnik na stan algorytmu;
+ * @param[in] from              - wskaźnik na miasto startowe;
+ * @param[in] to                - wskaźnik na miasto docelowe;
+ * @param[in] knownOldestRoad   - rok, od którego uwzględniamy odcinki;
+ * @param[in] distance          - długość szukanej drogi;
+ * @param[in] middle            - próg odległości od startu.
+ * @return Wskaźnik na listę miast drogi lub NULL, jeśli droga nie jest
+ * jednoznaczna lub nie udało się zaalokować pamięci.
+ */
+List *findCrossingRoadBidirectional(SearchState *state, City *from, City *to,
+                                    int64_t knownOldestRoad, int64_t distance,
+                                    int64_t middle) {
+    City *crossingFrom = NULL;
+    City *crossingTo = NULL;
+    uint32_t crossingsCount = 0;
+
+    for (uint32_t i = 0; i < state->settledCitiesSize; i++) {
+        City *city = state->settledCities[i];
+        int64_t cityDistance = state->distance[city->id];
+        if (cityDistance >= middle) {
+            continue;
+        }
+
+        ListIterator *iterator = city->roads->begin;
+        while (iterator != city->roads->end) {
+            Road *road = iterator->data;
+            iterator = iterator->next;
+
+            if (road->isDeleted || road == state->skippedRoads[0] ||
+                    road == state->skippedRoads[1] ||
+                    knownOldestRoad > road->buildYearOrLastRepairYear ||
+                    cityDistance + road->length < middle) {
+                continue;
+            }
+
+            uint32_t destination = road->destination->id;
+            if (state->stamp[destination] != state->currentStamp ||
+                    !(state->settled[destination] & BACKWARD_SETTLED) ||
+                    cityDistance + road->length +
+                    state->backwardDistance[destination] != distance) {
+                continue;
+            }
+
+            crossingsCount++;
+            crossingFrom = city;
+            crossingTo = road->destination;
+        }
+    }
+
+    if (crossingsCount != 1 ||
+            !state->isRouteUnequivocal[crossingFrom->id] ||
+            !state->backwardIsRouteUnequivocal[crossingTo->id]) {
+        return NULL;
+    }
+
+    return recoverRouteBidirectional(state, from, to, crossingFrom, crossingTo);
+}
+
+/** @brief Wykonuje oba przejścia dwukierunkowego algorytmu.
+ * @param[in] route             - wskaźnik na drogę krajową;
+ * @param[in] from              - wskaźnik na miasto startowe algorytmu;
+ * @param[in] to                - wskaźnik na docelowe miasto;
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry;
+ * @param[in,out] forward       - wskaźnik na kierunek od startu;
+ * @param[in,out] backward      - wskaźnik na kierunek od celu.
+ * @return Wskaźnik na listę zawierającą szukaną drogę lub NULL jeśli droga nie
+ * jest jednoznaczna lub nie udało się zaalokować pamięci.
+ */
+List *searchBidirectional(Route *route, City *from, City *to,
+                          SearchState *state, SearchDirection *forward,
+                          SearchDirection *backward) {
+    /* Znajdujemy długość i optymalny najstarszy odcinek szukanej drogi. */
+    MeetingLabel meeting = {INFINITY, INFINITY};
+    if (!startPassBidirectional(route, from, to, state, forward, backward) ||
+            !passBidirectional(state, forward, backward, 0, &meeting, 0)) {
+        return NULL;
+    }
+
+    /* Sprawdzamy czy istnieje jakakolwiek szukana droga krajowa. */
+    if (meeting.distance == INFINITY) {
+        return NULL;
+    }
+
+    /* Liczymy najkrótsze drogi złożone z odcinków nie starszych niż
+     * wyznaczony, aby sprawdzić jednoznaczność. */
+    while (forward->heap->size != 0) {
+        popHeap(forward->heap);
+    }
+    while (backward->heap->size != 0) {
+        popHeap(backward->heap);
+    }
+
+    if (!startPassBidirectional(route, from, to, state, forward, backward) ||
+            !passBidirectional(state, forward, backward, meeting.oldestRoad,
+                               NULL, meeting.distance)) {
+        return NULL;
+    }
+
+    int64_t middle = minInt64_t(topDistanceDirection(forward),
+                                meeting.distance);
+
+    return findCrossingRoadBidirectional(state, from, to, meeting.oldestRoad,
+                                         meeting.distance, middle);
+}
+
+/** @brief Znajduje drogę między miastami dwukierunkowym algorytmem dijkstry.
+ * Działa tak jak @ref findRouteModule dla jednego miasta docelowego, ale
+ * szuka jednocześnie z miasta @p from oraz z miasta @p to i kończy, gdy
+ * przeszukane obszary się spotkają. Najpierw wyznacza optymalną długość
+ * i najstarszy odcinek szukanej drogi, a następnie, biorąc pod uwagę tylko
+ * odcinki nie starsze niż wyznaczony, liczy najkrótsze drogi przecinające
+ * "środek" przeszukanego obszaru, co rozstrzyga o jednoznaczności.
+ * @param[in] route             - wskaźnik na drogę krajową;
+ * @param[in] from              - wskaźnik na miasto startowe algorytmu;
+ * @param[in] to                - wskaźnik na docelowe miasto;
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry.
+ * @return Wskaźnik na listę zawierającą szukaną drogę lub NULL jeśli droga nie
+ * jest jednoznaczna lub nie udało się zaalokować pamięci.
+ */
+List *findRouteBidirectional(Route *route, City *from, City *to,
+                             SearchState *state) {
+    assert(route);
+    assert(from);
+    assert(to);
+    assert(state);
+    assert(from != to);
+
+    if (!prepareSearchState(state)) {
+        return NULL;
+    }
+
+    SearchDirection forward = {newHeap(), state->distance,
+                               state->oldestRoadOnRoute,
+                               state->isRouteUnequivocal,
+                               state->previousOnRoute, FORWARD_SETTLED, false};
+    SearchDirection backward = {newHeap(), state->backwardDistance,
+                                state->backwardOldestRoadOnRoute,
+                                state->backwardIsRouteUnequivocal,
+                                state->nextOnRoute, BACKWARD_SETTLED, false};
+
+    List *result = NULL;
+    if (forward.heap != NULL && backward.heap != NULL) {
+        result = searchBidirectional(route, from, to, state, &forward,
+                                     &backward);
+    }
+
+    if (forward.heap != NULL) {
+        deleteHeap(forward.heap);
+    }
+    if (backward.heap != NULL) {
+        deleteHeap(backward.heap);
+    }
+
+    return result;
+}
@@ -0,0 +1,31 @@
+/** @file
+ * Interfejs dwukierunkowego algorytmu dijkstry szukającego dróg krajowych.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef BIDIRECTIONAL_SEARCH_H
+#define BIDIRECTIONAL_SEARCH_H
+
+#include "route.h"
+#include "search_state.h"
+
+/** @brief Znajduje drogę między miastami dwukierunkowym algorytmem dijkstry.
+ * Działa tak jak @ref findRouteModule dla jednego miasta docelowego, ale
+ * szuka jednocześnie z miasta @p from oraz z miasta @p to i kończy, gdy
+ * przeszukane obszary się spotkają. Najpierw wyznacza optymalną długość
+ * i najstarszy odcinek szukanej drogi, a następnie, biorąc pod uwagę tylko
+ * odcinki nie starsze niż wyznaczony, liczy najkrótsze drogi przecinające
+ * "środek" przeszukanego obszaru, co rozstrzyga o jednoznaczności.
+ * @param[in] route             - wskaźnik na drogę krajową;
+ * @param[in] from              - wskaźnik na miasto startowe algorytmu;
+ * @param[in] to                - wskaźnik na docelowe miasto;
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry.
+ * @return Wskaźnik na listę zawierającą szukaną drogę lub NULL jeśli droga nie
+ * jest jednoznaczna lub nie udało się zaalokować pamięci.
+ */
+List *findRouteBidirectional(Route *route, City *from, City *to,
+                             SearchState *state);
+
+#endif // BIDIRECTIONAL_SEARCH_H
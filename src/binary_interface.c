@@ -0,0 +1,911 @@
+/** @file
+ * Implementacja interfejsu udostępniającego binarny protokół poleceń mapy
+ * dróg.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "binary_interface.h"
+#include "command_parser.h"
+#include "hash_map.h"
+#include "city.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <inttypes.h>
+
+#define MAX_FRAME_SIZE (1u << 26)
+///< największy dopuszczalny rozmiar danych ramki
+
+#define MAX_COMMAND_FIELDS 4
+///< największa liczba pól polecenia o stałej długości
+
+/**
+ * Struktura przechowująca stan odczytu pól ramki.
+ */
+typedef struct BinaryFrameReader {
+    const char *data;               ///< pola ramki (po kodzie polecenia)
+    size_t size;                    ///< rozmiar pól
+    size_t position;                ///< pozycja odczytu
+} BinaryFrameReader;
+
+/**
+ * Struktura przechowująca stan zapisu strumienia binarnego.
+ */
+typedef struct BinaryEncoder {
+    FILE *output;                   ///< plik na strumień binarny
+    HashMap *citiesMap;             ///< haszmapa miast, którym nadano numer
+    List *cities;                   ///< lista miast, którym nadano numer
+} BinaryEncoder;
+
+/** @brief Powiększa tablice polecenia.
+ * @param[in,out] interface - wskaźnik na strukturę odczytu;
+ * @param[in] citiesCount   - liczba miast polecenia.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool reserveCommandBinaryInterface(BinaryInterface *interface,
+                                   uint32_t citiesCount) {
+    if (citiesCount <= interface->commandMemorySize) {
+        return true;
+    }
+
+    Command *command = &interface->command;
+    CityName *cities = realloc(command->cities, sizeof(CityName) * citiesCount);
+    if (cities == NULL) {
+        return false;
+    }
+    command->cities = cities;
+
+    unsigned *lengths = realloc(command->lengths,
+                                sizeof(unsigned) * citiesCount);
+    if (lengths == NULL) {
+        return false;
+    }
+    command->lengths = lengths;
+
+    unsigned *routeIds = realloc(command->routeIds,
+                                 sizeof(unsigned) * citiesCount);
+    if (routeIds == NULL) {
+        return false;
+    }
+    command->routeIds = routeIds;
+
+    int *years = realloc(command->years, sizeof(int) * citiesCount);
+    if (years == NULL) {
+        return false;
+    }
+    command->years = years;
+
+    interface->commandMemorySize = citiesCount;
+    return true;
+}
+
+/** @brief Tworzy strukturę odczytu strumienia binarnego.
+ * Wczytuje i sprawdza nagłówek strumienia.
+ * @param[in,out] input     - wskaźnik na plik ze strumieniem binarnym.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, jeśli strumień nie ma
+ * poprawnego nagłówka lub nie udało się zaalokować pamięci.
+ */
+BinaryInterface *newBinaryInterface(FILE *input) {
+    assert(input);
+
+    BinaryHeader header;
+    if (fread(&header, sizeof(BinaryHeader), 1, input) != 1 ||
+            header.magic != BINARY_MAGIC || header.version != BINARY_VERSION) {
+        return NULL;
+    }
+
+    BinaryInterface *result = calloc(1, sizeof(BinaryInterface));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    result->input = input;
+    if (!reserveCommandBinaryInterface(result, 2)) {
+        deleteBinaryInterface(result);
+        return NULL;
+    }
+
+    return result;
+}
+
+/** @brief Usuwa strukturę odczytu strumienia binarnego.
+ * Nie zamyka pliku. Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] interface     - wskaźnik na usuwaną strukturę.
+ */
+void deleteBinaryInterface(BinaryInterface *interface) {
+    if (interface == NULL) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < interface->citiesCount; i++) {
+        free((char *)interface->cities[i].name);
+    }
+    free(interface->cities);
+    free(interface->frame);
+    free(interface->command.cities);
+    free(interface->command.lengths);
+    free(interface->command.routeIds);
+    free(interface->command.years);
+    free(interface);
+}
+
+/** @brief Wczytuje ramkę strumienia binarnego.
+ * @param[in,out] interface - wskaźnik na strukturę odczytu;
+ * @param[out] size         - wskaźnik na rozmiar danych ramki.
+ * @return Wartość @p 0 jeśli wczytano ramkę,
+ * wartość @p 1 jeśli strumień skończył się w środku ramki lub ramka ma
+ * niepoprawny rozmiar,
+ * wartość @p 2 jeśli nie udało się zaalokować pamięci lub
+ * wartość @p EOF jeśli strumień się skończył.
+ */
+int readFrameBinaryInterface(BinaryInterface *interface, uint32_t *size) {
+    size_t count = fread(size, 1, sizeof(uint32_t), interface->input);
+    if (count == 0) {
+        return EOF;
+    }
+    if (count != sizeof(uint32_t) || *size == 0 || *size > MAX_FRAME_SIZE) {
+        return 1;
+    }
+
+    if (*size > interface->frameMemorySize) {
+        size_t memorySize = interface->frameMemorySize * 2;
+        if (memorySize < *size) {
+            memorySize = *size;
+        }
+
+        char *frame = realloc(interface->frame, memorySize);
+        if (frame == NULL) {
+            return 2;
+        }
+        interface->frame = frame;
+        interface->frameMemorySize = memorySize;
+    }
+
+    if (fread(interface->frame, 1, *size, interface->input) != *size) {
+        return 1;
+    }
+
+    return 0;
+}
+
+/** @brief Nadaje kolejny numer nazwie miasta z ramki @ref BINARY_CITY.
+ * Hasz i poprawność nazwy liczone są raz, przy nadaniu numeru. Nazwa
+ * zawierająca znak o kodzie 0 nie jest zapamiętywana, więc polecenia
+ * odwołujące się do niej są niepoprawne.
+ * @param[in,out] interface - wskaźnik na strukturę odczytu;
+ * @param[in] name          - wskaźnik na znaki nazwy;
+ * @param[in] length        - liczba znaków nazwy.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool addCityBinaryInterface(BinaryInterface *interface, const char *name,
+                            size_t length) {
+    if (interface->citiesCount == interface->citiesMemorySize) {
+        uint32_t memorySize = interface->citiesMemorySize * 2 + 8;
+        CityName *cities = realloc(interface->cities,
+                                   sizeof(CityName) * memorySize);
+        if (cities == NULL) {
+            return false;
+        }
+        interface->cities = cities;
+        interface->citiesMemorySize = memorySize;
+    }
+
+    CityName cityName = cityNameFromString(NULL);
+    if (memchr(name, 0, length) == NULL) {
+        char *nameCopy = malloc(sizeof(char) * (length + 1));
+        if (nameCopy == NULL) {
+            return false;
+        }
+        memcpy(nameCopy, name, length);
+        nameCopy[length] = 0;
+        cityName = cityNameFromString(nameCopy);
+    }
+
+    interface->cities[interface->citiesCount++] = cityName;
+    return true;
+}
+
+/** @brief Odczytuje liczbę z pól ramki.
+ * @param[in,out] reader    - wskaźnik na stan odczytu;
+ * @param[out] value        - wskaźnik na odczytaną liczbę.
+ * @return Wartość @p true lub @p false, jeśli pola się skończyły.
+ */
+bool readUint32BinaryInterface(BinaryFrameReader *reader, uint32_t *value) {
+    if (reader->size - reader->position < sizeof(uint32_t)) {
+        return false;
+    }
+
+    memcpy(value, reader->data + reader->position, sizeof(uint32_t));
+    reader->position += sizeof(uint32_t);
+
+    return true;
+}
+
+/** @brief Odczytuje nazwę miasta o numerze podanym w polu ramki.
+ * @param[in] interface     - wskaźnik na strukturę odczytu;
+ * @param[in,out] reader    - wskaźnik na stan odczytu;
+ * @param[out] cityName     - wskaźnik na opis nazwy miasta.
+ * @return Wartość @p true lub @p false, jeśli pola się skończyły lub miastu
+ * nie nadano tego numeru.
+ */
+bool readCityBinaryInterface(const BinaryInterface *interface,
+                             BinaryFrameReader *reader, CityName *cityName) {
+    uint32_t id;
+    if (!readUint32BinaryInterface(reader, &id) ||
+            id >= interface->citiesCount) {
+        return false;
+    }
+
+    *cityName = interface->cities[id];
+    return cityName->name != NULL;
+}
+
+/** @brief Odczytuje polecenie z ramki @ref BINARY_ADD_ROUTE.
+ * @param[in,out] interface - wskaźnik na strukturę odczytu;
+ * @param[in,out] reader    - wskaźnik na stan odczytu pól ramki.
+ * @return Wartość @p true lub @p false, jeśli ramka jest niepoprawna lub nie
+ * udało się zaalokować pamięci.
+ */
+bool readRouteBinaryInterface(BinaryInterface *interface,
+                              BinaryFrameReader *reader) {
+    uint32_t routeId, citiesCount;
+    if (!readUint32BinaryInterface(reader, &routeId) ||
+            !readUint32BinaryInterface(reader, &citiesCount) ||
+            citiesCount < 2) {
+        return false;
+    }
+
+    /* Rozmiar sprawdzamy przed alokacją tablic. */
+    uint64_t fieldsSize = (3 * (uint64_t)citiesCount - 2) * sizeof(uint32_t);
+    if (reader->size - reader->position != fieldsSize) {
+        return false;
+    }
+
+    if (!reserveCommandBinaryInterface(interface, citiesCount)) {
+        return false;
+    }
+
+    Command *command = &interface->command;
+    command->routeId = routeId;
+    command->citiesCount = citiesCount;
+    if (!readCityBinaryInterface(interface, reader, &command->cities[0])) {
+        return false;
+    }
+
+    for (uint32_t i = 1; i < citiesCount; i++) {
+        uint32_t length, builtYear;
+        if (!readUint32BinaryInterface(reader, &length) ||
+                !readUint32BinaryInterface(reader, &builtYear) ||
+                !readCityBinaryInterface(interface, reader,
+                                         &command->cities[i])) {
+            return false;
+        }
+
+        command->lengths[i - 1] = length;
+        command->years[i - 1] = (int32_t)builtYear;
+    }
+
+    return true;
+}
+
+/** @brief Odczytuje polecenie z ramki @ref BINARY_DISTANCE_MATRIX.
+ * @param[in,out] interface - wskaźnik na strukturę odczytu;
+ * @param[in,out] reader    - wskaźnik na stan odczytu pól ramki.
+ * @return Wartość @p true lub @p false, jeśli ramka jest niepoprawna lub nie
+ * udało się zaalokować pamięci.
+ */
+bool readMatrixBinaryInterface(BinaryInterface *interface,
+                               BinaryFrameReader *reader) {
+    uint32_t sourcesCount, citiesCount;
+    if (!readUint32BinaryInterface(reader, &sourcesCount) ||
+            !readUint32BinaryInterface(reader, &citiesCount) ||
+            citiesCount < 2) {
+        return false;
+    }
+
+    /* Rozmiar sprawdzamy przed alokacją tablic. */
+    uint64_t fieldsSize = (uint64_t)citiesCount * sizeof(uint32_t);
+    if (reader->size - reader->position != fieldsSize ||
+            !reserveCommandBinaryInterface(interface, citiesCount)) {
+        return false;
+    }
+
+    Command *command = &interface->command;
+    command->sourcesCount = sourcesCount;
+    command->citiesCount = citiesCount;
+    for (uint32_t i = 0; i < citiesCount; i++) {
+        if (!readCityBinaryInterface(interface, reader,
+                                     &command->cities[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** @brief Odczytuje polecenie z ramki @ref BINARY_NEW_ROUTES.
+ * @param[in,out] interface - wskaźnik na strukturę odczytu;
+ * @param[in,out] reader    - wskaźnik na stan odczytu pól ramki.
+ * @return Wartość @p true lub @p false, jeśli ramka jest niepoprawna lub nie
+ * udało się zaalokować pamięci.
+ */
+bool readRoutesBinaryInterface(BinaryInterface *interface,
+                               BinaryFrameReader *reader) {
+    uint32_t citiesCount;
+    if (!readUint32BinaryInterface(reader, &citiesCount) || citiesCount < 2) {
+        return false;
+    }
+
+    /* Rozmiar sprawdzamy przed alokacją tablic. */
+    uint64_t fieldsSize = (2 * (uint64_t)citiesCount - 1) * sizeof(uint32_t);
+    if (reader->size - reader->position != fieldsSize ||
+            !reserveCommandBinaryInterface(interface, citiesCount)) {
+        return false;
+    }
+
+    Command *command = &interface->command;
+    command->citiesCount = citiesCount;
+    if (!readCityBinaryInterface(interface, reader, &command->cities[0])) {
+        return false;
+    }
+
+    for (uint32_t i = 1; i < citiesCount; i++) {
+        uint32_t routeId;
+        if (!readUint32BinaryInterface(reader, &routeId) ||
+                !readCityBinaryInterface(interface, reader,
+                                         &command->cities[i])) {
+            return false;
+        }
+
+        command->routeIds[i - 1] = routeId;
+    }
+
+    return true;
+}
+
+/** @brief Odczytuje polecenie z ramki @ref BINARY_REMOVE_ROADS.
+ * @param[in,out] interface - wskaźnik na strukturę odczytu;
+ * @param[in,out] reader    - wskaźnik na stan odczytu pól ramki.
+ * @return Wartość @p true lub @p false, jeśli ramka jest niepoprawna lub nie
+ * udało się zaalokować pamięci.
+ */
+bool readRoadsBinaryInterface(BinaryInterface *interface,
+                              BinaryFrameReader *reader) {
+    uint32_t citiesCount;
+    if (!readUint32BinaryInterface(reader, &citiesCount) || citiesCount < 2 ||
+            citiesCount % 2 != 0) {
+        return false;
+    }
+
+    /* Rozmiar sprawdzamy przed alokacją tablic. */
+    uint64_t fieldsSize = (uint64_t)citiesCount * sizeof(uint32_t);
+    if (reader->size - reader->position != fieldsSize ||
+            !reserveCommandBinaryInterface(interface, citiesCount)) {
+        return false;
+    }
+
+    Command *command = &interface->command;
+    command->citiesCount = citiesCount;
+    for (uint32_t i = 0; i < citiesCount; i++) {
+        if (!readCityBinaryInterface(interface, reader,
+                                     &command->cities[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** @brief Odczytuje miasta polecenia o stałej liczbie pól.
+ * Zapisuje miasta na początku tablicy miast polecenia
+ * @ref BinaryInterface.command i ustawia ich liczbę.
+ * @param[in,out] interface - wskaźnik na strukturę odczytu;
+ * @param[in,out] reader    - wskaźnik na stan odczytu pól ramki;
+ * @param[in] citiesCount   - liczba miast (co najwyżej @p 2).
+ * @return Wartość @p true lub @p false, jeśli pola się skończyły lub
+ * któremuś miastu nie nadano numeru.
+ */
+bool readCitiesBinaryInterface(BinaryInterface *interface,
+                               BinaryFrameReader *reader,
+                               uint32_t citiesCount) {
+    assert(citiesCount <= interface->commandMemorySize);
+
+    interface->command.citiesCount = citiesCount;
+    for (uint32_t i = 0; i < citiesCount; i++) {
+        if (!readCityBinaryInterface(interface, reader,
+                                     &interface->command.cities[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** @brief Zamienia wczytaną ramkę na polecenie.
+ * Wypełnia polecenie @ref BinaryInterface.command.
+ * @param[in,out] interface - wskaźnik na strukturę odczytu;
+ * @param[in] size          - rozmiar danych ramki.
+ * @return Wartość @p 0 jeśli ramka zawiera polecenie,
+ * wartość @p 1 jeśli ramka jest niepoprawna (także @ref BINARY_INVALID) lub
+ * wartość @p 3 jeśli ramka nie zawiera polecenia (@ref BINARY_SKIP).
+ */
+int readCommandBinaryInterface(BinaryInterface *interface, uint32_t size) {
+    BinaryFrameReader reader;
+    reader.data = interface->frame + 1;
+    reader.size = size - 1;
+    reader.position = 0;
+
+    Command *command = &interface->command;
+    uint32_t routeId = 0, length = 0, year = 0;
+    bool isCorrect;
+
+    command->sourcesCount = 0;
+    BinaryOpcode opcode = (BinaryOpcode)(unsigned char)interface->frame[0];
+    switch (opcode) {
+        case BINARY_SKIP:
+            return reader.size == 0 ? 3 : 1;
+        case BINARY_ADD_ROAD:
+            command->type = COMMAND_ADD_ROAD;
+            isCorrect = readCitiesBinaryInterface(interface, &reader, 2) &&
+                        readUint32BinaryInterface(&reader, &length) &&
+                        readUint32BinaryInterface(&reader, &year);
+            break;
+        case BINARY_REPAIR_ROAD:
+            command->type = COMMAND_REPAIR_ROAD;
+            isCorrect = readCitiesBinaryInterface(interface, &reader, 2) &&
+                        readUint32BinaryInterface(&reader, &year);
+            break;
+        case BINARY_GET_ROUTE_DESCRIPTION:
+            command->type = COMMAND_GET_ROUTE_DESCRIPTION;
+            isCorrect = readUint32BinaryInterface(&reader, &routeId) &&
+                        readCitiesBinaryInterface(interface, &reader, 0);
+            break;
+        case BINARY_NEW_ROUTE:
+            command->type = COMMAND_NEW_ROUTE;
+            isCorrect = readUint32BinaryInterface(&reader, &routeId) &&
+                        readCitiesBinaryInterface(interface, &reader, 2);
+            break;
+        case BINARY_EXTEND_ROUTE:
+            command->type = COMMAND_EXTEND_ROUTE;
+            isCorrect = readUint32BinaryInterface(&reader, &routeId) &&
+                        readCitiesBinaryInterface(interface, &reader, 1);
+            break;
+        case BINARY_REMOVE_ROAD:
+            command->type = COMMAND_REMOVE_ROAD;
+            isCorrect = readCitiesBinaryInterface(interface, &reader, 2);
+            break;
+        case BINARY_REMOVE_ROUTE:
+            command->type = COMMAND_REMOVE_ROUTE;
+            isCorrect = readUint32BinaryInterface(&reader, &routeId) &&
+                        readCitiesBinaryInterface(interface, &reader, 0);
+            break;
+        case BINARY_QUERY_ROUTE:
+            command->type = COMMAND_QUERY_ROUTE;
+            isCorrect = readCitiesBinaryInterface(interface, &reader, 2);
+            break;
+        case BINARY_CHECK_REMOVE_ROAD:
+            command->type = COMMAND_CHECK_REMOVE_ROAD;
+            isCorrect = readCitiesBinaryInterface(interface, &reader, 2);
+            break;
+        case BINARY_ADD_ROUTE:
+            command->type = COMMAND_ADD_ROUTE;
+            return readRouteBinaryInterface(interface, &reader) ? 0 : 1;
+        case BINARY_DISTANCE_MATRIX:
+            command->type = COMMAND_DISTANCE_MATRIX;
+            return readMatrixBinaryInterface(interface, &reader) ? 0 : 1;
+        case BINARY_NEW_ROUTES:
+            command->type = COMMAND_NEW_ROUTES;
+            return readRoutesBinaryInterface(interface, &reader) ? 0 : 1;
+        case BINARY_REMOVE_ROADS:
+            command->type = COMMAND_REMOVE_ROADS;
+            return readRoadsBinaryInterface(interface, &reader) ? 0 : 1;
+        default:
+            return 1;
+    }
+
+    command->routeId = routeId;
+    command->lengths[0] = length;
+    command->years[0] = (int32_t)year;
+
+    return isCorrect && reader.position == reader.size ? 0 : 1;
+}
+
+/** @brief Obsługuje pojedyncze polecenie strumienia binarnego.
+ * Wczytuje ramki nadające numery miastom i jedną ramkę polecenia, po czym
+ * wywołuje odpowiednią funkcję mapy, tak jak @ref nextCommandTextInterface
+ * dla odpowiadającego ramce wiersza. Jeśli polecenie jest niepoprawne (także
+ * jeśli ramka jest uszkodzona lub odwołuje się do nieznanego miasta) lub jego
+ * wykonanie zakończyło się błędem, to wypisuje na standardowe wyjście
+ * diagnostyczne jednoliniowy komunikat: ERROR @p lineNumber.
+ * @param[in,out] map       - wskaźnik na mapę;
+ * @param[in,out] interface - wskaźnik na strukturę odczytu;
+ * @param[in] lineNumber    - numer wiersza odpowiadającego ramce.
+ * @return Wartość @p 0 jeśli operacja zakończyła się sukcesem,
+ * wartość @p 2 jeśli nie udało się zaalokować pamięci lub
+ * wartość @p EOF jeśli strumień się skończył (także w środku ramki).
+ */
+int nextCommandBinaryInterface(Map *map, BinaryInterface *interface,
+                               uint32_t lineNumber) {
+    assert(map);
+    assert(interface);
+
+    uint32_t size;
+    int x;
+    while ((x = readFrameBinaryInterface(interface, &size)) == 0 &&
+           interface->frame[0] == BINARY_CITY) {
+        if (!addCityBinaryInterface(interface, interface->frame + 1,
+                                    size - 1)) {
+            return 2;
+        }
+    }
+
+    /* Niedokończona ramka odpowiada wierszowi niezakończonemu znakiem
+     * '\n'. */
+    if (x == 1) {
+        fprintf(stderr, "ERROR %" PRIu32 "\n", lineNumber);
+        return EOF;
+    }
+    if (x != 0) {
+        return x;
+    }
+
+    x = readCommandBinaryInterface(interface, size);
+    if (x == 1) {
+        fprintf(stderr, "ERROR %" PRIu32 "\n", lineNumber);
+    } else if (x == 0) {
+        executeCommandTextInterface(map, &interface->command, lineNumber);
+    }
+
+    return 0;
+}
+
+/** @brief Zapisuje liczbę do strumienia binarnego.
+ * @param[in,out] output    - wskaźnik na plik na strumień binarny;
+ * @param[in] value         - zapisywana liczba.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać liczby.
+ */
+bool writeUint32BinaryInterface(FILE *output, uint32_t value) {
+    return fwrite(&value, sizeof(uint32_t), 1, output) == 1;
+}
+
+/** @brief Zapisuje rozmiar i kod polecenia ramki.
+ * @param[in,out] output    - wskaźnik na plik na strumień binarny;
+ * @param[in] opcode        - kod polecenia;
+ * @param[in] fieldsSize    - rozmiar pól ramki (bez kodu polecenia).
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać ramki.
+ */
+bool writeFrameStartBinaryInterface(FILE *output, BinaryOpcode opcode,
+                                    uint32_t fieldsSize) {
+    unsigned char code = opcode;
+    return writeUint32BinaryInterface(output, fieldsSize + 1) &&
+           fwrite(&code, 1, 1, output) == 1;
+}
+
+/** @brief Wyznacza numer miasta, w razie potrzeby go nadając.
+ * Jeśli miastu nie nadano jeszcze numeru, to zapisuje ramkę
+ * @ref BINARY_CITY.
+ * @param[in,out] encoder   - wskaźnik na stan zapisu;
+ * @param[in] cityName      - wskaźnik na opis poprawnej nazwy miasta;
+ * @param[out] id           - wskaźnik na numer miasta.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać ramki lub
+ * zaalokować pamięci.
+ */
+bool cityIdBinaryInterface(BinaryEncoder *encoder, const CityName *cityName,
+                           uint32_t *id) {
+    City *city = findCityByNameOnHashMap(encoder->citiesMap, cityName);
+    if (city == NULL) {
+        city = findCityByNameOnHashMapInsertIfNecessary(encoder->citiesMap,
+                                                        encoder->cities,
+                                                        cityName);
+        if (city == NULL) {
+            return false;
+        }
+
+        size_t length = strlen(cityName->name);
+        if (!writeFrameStartBinaryInterface(encoder->output, BINARY_CITY,
+                                            length) ||
+                fwrite(cityName->name, 1, length, encoder->output) != length) {
+            return false;
+        }
+    }
+
+    *id = city->id;
+    return true;
+}
+
+/** @brief Zapisuje drogę krajową podaną przez kolejne miasta.
+ * Numery miastom muszą być już nadane.
+ * @param[in,out] encoder   - wskaźnik na stan zapisu;
+ * @param[in] command       - wskaźnik na polecenie @ref COMMAND_ADD_ROUTE.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać ramki lub
+ * zaalokować pamięci.
+ */
+bool encodeRouteBinaryInterface(BinaryEncoder *encoder,
+                                const Command *command) {
+    uint32_t citiesCount = command->citiesCount;
+    uint32_t fieldsSize = (3 * citiesCount) * sizeof(uint32_t);
+    if (!writeFrameStartBinaryInterface(encoder->output, BINARY_ADD_ROUTE,
+                                        fieldsSize) ||
+            !writeUint32BinaryInterface(encoder->output, command->routeId) ||
+            !writeUint32BinaryInterface(encoder->output, citiesCount)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < citiesCount; i++) {
+        uint32_t id;
+        if (i > 0 &&
+                (!writeUint32BinaryInterface(encoder->output,
+                                             command->lengths[i - 1]) ||
+                 !writeUint32BinaryInterface(encoder->output,
+                                             (uint32_t)command->years[i - 1]))) {
+            return false;
+        }
+
+        /* Numery miast zostały już nadane. */
+        if (!cityIdBinaryInterface(encoder, &command->cities[i], &id) ||
+                !writeUint32BinaryInterface(encoder->output, id)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** @brief Zapisuje polecenie liczenia macierzy odległości.
+ * Numery miastom muszą być już nadane.
+ * @param[in,out] encoder   - wskaźnik na stan zapisu;
+ * @param[in] command       - wskaźnik na polecenie
+ *                            @ref COMMAND_DISTANCE_MATRIX.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać ramki lub
+ * zaalokować pamięci.
+ */
+bool encodeMatrixBinaryInterface(BinaryEncoder *encoder,
+                                 const Command *command) {
+    uint32_t citiesCount = command->citiesCount;
+    uint32_t fieldsSize = (2 + citiesCount) * sizeof(uint32_t);
+    if (!writeFrameStartBinaryInterface(encoder->output,
+                                        BINARY_DISTANCE_MATRIX, fieldsSize) ||
+            !writeUint32BinaryInterface(encoder->output,
+                                        command->sourcesCount) ||
+            !writeUint32BinaryInterface(encoder->output, citiesCount)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < citiesCount; i++) {
+        uint32_t id;
+        if (!cityIdBinaryInterface(encoder, &command->cities[i], &id) ||
+                !writeUint32BinaryInterface(encoder->output, id)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** @brief Zapisuje polecenie tworzenia dróg krajowych z jednego miasta.
+ * Numery miastom muszą być już nadane.
+ * @param[in,out] encoder   - wskaźnik na stan zapisu;
+ * @param[in] command       - wskaźnik na polecenie @ref COMMAND_NEW_ROUTES.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać ramki lub
+ * zaalokować pamięci.
+ */
+bool encodeRoutesBinaryInterface(BinaryEncoder *encoder,
+                                 const Command *command) {
+    uint32_t citiesCount = command->citiesCount;
+    uint32_t fieldsSize = (2 * citiesCount) * sizeof(uint32_t);
+    if (!writeFrameStartBinaryInterface(encoder->output, BINARY_NEW_ROUTES,
+                                        fieldsSize) ||
+            !writeUint32BinaryInterface(encoder->output, citiesCount)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < citiesCount; i++) {
+        uint32_t id;
+        if (i > 0 && !writeUint32BinaryInterface(encoder->output,
+                                                 command->routeIds[i - 1])) {
+            return false;
+        }
+
+        if (!cityIdBinaryInterface(encoder, &command->cities[i], &id) ||
+                !writeUint32BinaryInterface(encoder->output, id)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** @brief Zapisuje polecenie usunięcia wielu odcinków dróg.
+ * Numery miastom muszą być już nadane.
+ * @param[in,out] encoder   - wskaźnik na stan zapisu;
+ * @param[in] command       - wskaźnik na polecenie @ref COMMAND_REMOVE_ROADS.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać ramki lub
+ * zaalokować pamięci.
+ */
+bool encodeRoadsBinaryInterface(BinaryEncoder *encoder,
+                                const Command *command) {
+    uint32_t citiesCount = command->citiesCount;
+    uint32_t fieldsSize = (1 + citiesCount) * sizeof(uint32_t);
+    if (!writeFrameStartBinaryInterface(encoder->output, BINARY_REMOVE_ROADS,
+                                        fieldsSize) ||
+            !writeUint32BinaryInterface(encoder->output, citiesCount)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < citiesCount; i++) {
+        uint32_t id;
+        if (!cityIdBinaryInterface(encoder, &command->cities[i], &id) ||
+                !writeUint32BinaryInterface(encoder->output, id)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** @brief Zapisuje ramkę odpowiadającą poleceniu.
+ * Polecenie z niepoprawną nazwą miasta zapisywane jest jako
+ * @ref BINARY_INVALID.
+ * @param[in,out] encoder   - wskaźnik na stan zapisu;
+ * @param[in] command       - wskaźnik na polecenie.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać ramki lub
+ * zaalokować pamięci.
+ */
+bool encodeCommandBinaryInterface(BinaryEncoder *encoder,
+                                  const Command *command) {
+    for (uint32_t i = 0; i < command->citiesCount; i++) {
+        if (!command->cities[i].isValid) {
+            return writeFrameStartBinaryInterface(encoder->output,
+                                                  BINARY_INVALID, 0);
+        }
+    }
+
+    /* Ramki nadające numery miastom muszą poprzedzać polecenie. */
+    uint32_t ids[2];
+    for (uint32_t i = 0; i < command->citiesCount; i++) {
+        uint32_t id;
+        if (!cityIdBinaryInterface(encoder, &command->cities[i], &id)) {
+            return false;
+        }
+        if (i < 2) {
+            ids[i] = id;
+        }
+    }
+
+    uint32_t values[MAX_COMMAND_FIELDS];
+    uint32_t fieldsCount = 0;
+    BinaryOpcode opcode;
+    switch (command->type) {
+        case COMMAND_ADD_ROAD:
+            opcode = BINARY_ADD_ROAD;
+            values[fieldsCount++] = ids[0];
+            values[fieldsCount++] = ids[1];
+            values[fieldsCount++] = command->lengths[0];
+            values[fieldsCount++] = (uint32_t)command->years[0];
+            break;
+        case COMMAND_REPAIR_ROAD:
+            opcode = BINARY_REPAIR_ROAD;
+            values[fieldsCount++] = ids[0];
+            values[fieldsCount++] = ids[1];
+            values[fieldsCount++] = (uint32_t)command->years[0];
+            break;
+        case COMMAND_GET_ROUTE_DESCRIPTION:
+            opcode = BINARY_GET_ROUTE_DESCRIPTION;
+            values[fieldsCount++] = command->routeId;
+            break;
+        case COMMAND_NEW_ROUTE:
+            opcode = BINARY_NEW_ROUTE;
+            values[fieldsCount++] = command->routeId;
+            values[fieldsCount++] = ids[0];
+            values[fieldsCount++] = ids[1];
+            break;
+        case COMMAND_EXTEND_ROUTE:
+            opcode = BINARY_EXTEND_ROUTE;
+            values[fieldsCount++] = command->routeId;
+            values[fieldsCount++] = ids[0];
+            break;
+        case COMMAND_REMOVE_ROAD:
+            opcode = BINARY_REMOVE_ROAD;
+            values[fieldsCount++] = ids[0];
+            values[fieldsCount++] = ids[1];
+            break;
+        case COMMAND_REMOVE_ROUTE:
+            opcode = BINARY_REMOVE_ROUTE;
+            values[fieldsCount++] = command->routeId;
+            break;
+        case COMMAND_QUERY_ROUTE:
+            opcode = BINARY_QUERY_ROUTE;
+            values[fieldsCount++] = ids[0];
+            values[fieldsCount++] = ids[1];
+            break;
+        case COMMAND_CHECK_REMOVE_ROAD:
+            opcode = BINARY_CHECK_REMOVE_ROAD;
+            values[fieldsCount++] = ids[0];
+            values[fieldsCount++] = ids[1];
+            break;
+        case COMMAND_DISTANCE_MATRIX:
+            return encodeMatrixBinaryInterface(encoder, command);
+        case COMMAND_NEW_ROUTES:
+            return encodeRoutesBinaryInterface(encoder, command);
+        case COMMAND_REMOVE_ROADS:
+            return encodeRoadsBinaryInterface(encoder, command);
+        default:
+            return encodeRouteBinaryInterface(encoder, command);
+    }
+
+    if (!writeFrameStartBinaryInterface(encoder->output, opcode,
+                                        fieldsCount * sizeof(uint32_t))) {
+        return false;
+    }
+    for (uint32_t i = 0; i < fieldsCount; i++) {
+        if (!writeUint32BinaryInterface(encoder->output, values[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** @brief Zamienia polecenia tekstowe na strumień binarny.
+ * Wczytuje wiersze ze standardowego wejścia tak jak
+ * @ref nextCommandTextInterface i zapisuje odpowiadające im ramki. Wiersze
+ * niepoprawne składniowo, także z niepoprawną nazwą miasta, zapisywane są
+ * jako @ref BINARY_INVALID, a niepoprawne liczby (odrzucane przez funkcje
+ * mapy) jako @p 0.
+ * @param[in,out] output    - wskaźnik na plik na strumień binarny.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać pliku
+ * lub zaalokować pamięci.
+ */
+bool encodeBinaryInterface(FILE *output) {
+    assert(output);
+
+    BinaryEncoder encoder;
+    encoder.output = output;
+    encoder.citiesMap = newHashMap();
+    encoder.cities = newList();
+
+    BinaryHeader header;
+    header.magic = BINARY_MAGIC;
+    header.version = BINARY_VERSION;
+
+    CommandParser *parser = newCommandParser(stdin);
+    bool isCorrect = encoder.citiesMap != NULL && encoder.cities != NULL &&
+                     parser != NULL &&
+                     fwrite(&header, sizeof(BinaryHeader), 1, output) == 1;
+    int x = 0;
+    while (isCorrect && x != EOF) {
+        Command command;
+        x = nextCommandParser(parser, &command);
+
+        if (x == 0) {
+            isCorrect = encodeCommandBinaryInterface(&encoder, &command);
+        } else if (x == 1) {
+            isCorrect = writeFrameStartBinaryInterface(output, BINARY_INVALID,
+                                                       0);
+        } else if (x == 3) {
+            isCorrect = writeFrameStartBinaryInterface(output, BINARY_SKIP, 0);
+        } else if (x != EOF) {
+            isCorrect = false;
+        }
+    }
+
+    deleteCommandParser(parser);
+    if (encoder.cities != NULL) {
+        ListIterator *iterator = encoder.cities->begin;
+        while (iterator != encoder.cities->end) {
+            deleteCity(iterator->data);
+            iterator = iterator->next;
+        }
+        deleteList(encoder.cities, false);
+    }
+    if (encoder.citiesMap != NULL) {
+        deleteHashMap(encoder.citiesMap);
+    }
+
+    return fflush(output) == 0 && isCorrect;
+}
@@ -0,0 +1,142 @@
+/** @file
+ * Interfejs udostępniający binarny protokół poleceń mapy dróg.
+ *
+ * Strumień zaczyna się nagłówkiem @ref BinaryHeader, po którym następują
+ * ramki: rozmiar danych ramki (4 bajty), kod polecenia (1 bajt) i pola
+ * polecenia. Liczby zapisywane są jako liczby 32-bitowe w kolejności bajtów
+ * komputera. Nazwa miasta przesyłana jest raz, w ramce @ref BINARY_CITY,
+ * która nadaje jej kolejny numer (od @p 0); dalsze ramki odwołują się do
+ * miasta przez ten numer. Każda ramka poza @ref BINARY_CITY odpowiada jednemu
+ * wierszowi wejścia tekstowego, więc komunikaty ERROR mają te same numery
+ * wierszy co przy wykonaniu poleceń tekstowych.
+ *
+ * Pola ramek (po kodzie polecenia):
+ *  - @ref BINARY_CITY - znaki nazwy miasta (bez zera na końcu);
+ *  - @ref BINARY_SKIP, @ref BINARY_INVALID - brak pól;
+ *  - @ref BINARY_ADD_ROAD - miasto, miasto, długość, rok budowy;
+ *  - @ref BINARY_REPAIR_ROAD - miasto, miasto, rok remontu;
+ *  - @ref BINARY_GET_ROUTE_DESCRIPTION - numer drogi krajowej;
+ *  - @ref BINARY_NEW_ROUTE - numer drogi krajowej, miasto, miasto;
+ *  - @ref BINARY_EXTEND_ROUTE - numer drogi krajowej, miasto;
+ *  - @ref BINARY_REMOVE_ROAD, @ref BINARY_QUERY_ROUTE,
+ *    @ref BINARY_CHECK_REMOVE_ROAD - miasto, miasto;
+ *  - @ref BINARY_REMOVE_ROUTE - numer drogi krajowej;
+ *  - @ref BINARY_ADD_ROUTE - numer drogi krajowej, liczba miast, miasto,
+ *    a dalej dla każdego kolejnego miasta: długość, rok budowy, miasto;
+ *  - @ref BINARY_DISTANCE_MATRIX - liczba miast źródłowych, liczba wszystkich
+ *    miast i kolejne miasta (najpierw źródłowe, potem docelowe);
+ *  - @ref BINARY_NEW_ROUTES - liczba miast, miasto startowe, a dalej dla
+ *    każdej drogi krajowej: numer drogi krajowej, miasto docelowe;
+ *  - @ref BINARY_REMOVE_ROADS - liczba miast (parzysta) i kolejne miasta,
+ *    po dwa dla każdego usuwanego odcinka.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef BINARY_INTERFACE_H
+#define BINARY_INTERFACE_H
+
+#include "map.h"
+#include "text_interface.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define BINARY_MAGIC 0x4250414du
+///< liczba rozpoznająca strumień binarny (i kolejność bajtów)
+
+#define BINARY_VERSION 1u
+///< wersja protokołu binarnego
+
+/**
+ * Kody poleceń protokołu binarnego.
+ */
+typedef enum BinaryOpcode {
+    BINARY_CITY = 0,                ///< nadanie numeru nazwie miasta
+    BINARY_SKIP,                    ///< wiersz bez polecenia (komentarz)
+    BINARY_INVALID,                 ///< wiersz niepoprawny składniowo
+    BINARY_ADD_ROAD,                ///< @ref addRoad
+    BINARY_REPAIR_ROAD,             ///< @ref repairRoad
+    BINARY_GET_ROUTE_DESCRIPTION,   ///< @ref getRouteDescription
+    BINARY_NEW_ROUTE,               ///< @ref newRoute
+    BINARY_EXTEND_ROUTE,            ///< @ref extendRoute
+    BINARY_REMOVE_ROAD,             ///< @ref removeRoad
+    BINARY_REMOVE_ROUTE,            ///< @ref removeRoute
+    BINARY_ADD_ROUTE,               ///< droga krajowa podana przez miasta
+    BINARY_QUERY_ROUTE,             ///< @ref queryRoute
+    BINARY_DISTANCE_MATRIX,         ///< @ref distanceMatrix
+    BINARY_NEW_ROUTES,              ///< @ref newRoutes
+    BINARY_REMOVE_ROADS,            ///< @ref removeRoads
+    BINARY_CHECK_REMOVE_ROAD        ///< @ref checkRemoveRoad
+} BinaryOpcode;
+
+/**
+ * Struktura przechowująca nagłówek strumienia binarnego.
+ */
+typedef struct BinaryHeader {
+    uint32_t magic;                 ///< @ref BINARY_MAGIC
+    uint32_t version;               ///< @ref BINARY_VERSION
+} BinaryHeader;
+
+/**
+ * Struktura przechowująca stan odczytu strumienia binarnego.
+ */
+typedef struct BinaryInterface {
+    FILE *input;                    ///< plik ze strumieniem binarnym
+    char *frame;                    ///< dane ostatnio wczytanej ramki
+    size_t frameMemorySize;         ///< rozmiar bufora na dane ramki
+    CityName *cities;               ///< nazwy miast według numerów (nazwa
+                                    ///< NULL, jeśli zawiera znak o kodzie 0)
+    uint32_t citiesCount;           ///< liczba miast, którym nadano numer
+    uint32_t citiesMemorySize;      ///< rozmiar tablicy nazw miast
+    Command command;                ///< ostatnio wczytane polecenie
+    uint32_t commandMemorySize;     ///< rozmiar tablic polecenia
+} BinaryInterface;
+
+/** @brief Tworzy strukturę odczytu strumienia binarnego.
+ * Wczytuje i sprawdza nagłówek strumienia.
+ * @param[in,out] input     - wskaźnik na plik ze strumieniem binarnym.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, jeśli strumień nie ma
+ * poprawnego nagłówka lub nie udało się zaalokować pamięci.
+ */
+BinaryInterface *newBinaryInterface(FILE *input);
+
+/** @brief Usuwa strukturę odczytu strumienia binarnego.
+ * Nie zamyka pliku. Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] interface     - wskaźnik na usuwaną strukturę.
+ */
+void deleteBinaryInterface(BinaryInterface *interface);
+
+/** @brief Obsługuje pojedyncze polecenie strumienia binarnego.
+ * Wczytuje ramki nadające numery miastom i jedną ramkę polecenia, po czym
+ * wywołuje odpowiednią funkcję mapy, tak jak @ref nextCommandTextInterface
+ * dla odpowiadającego ramce wiersza. Jeśli polecenie jest niepoprawne (także
+ * jeśli ramka jest uszkodzona lub odwołuje się do nieznanego miasta) lub jego
+ * wykonanie zakończyło się błędem, to wypisuje na standardowe wyjście
+ * diagnostyczne jednoliniowy komunikat: ERROR @p lineNumber.
+ * @param[in,out] map       - wskaźnik na mapę;
+ * @param[in,out] interface - wskaźnik na strukturę odczytu;
+ * @param[in] lineNumber    - numer wiersza odpowiadającego ramce.
+ * @return Wartość @p 0 jeśli operacja zakończyła się sukcesem,
+ * wartość @p 2 jeśli nie udało się zaalokować pamięci lub
+ * wartość @p EOF jeśli strumień się skończył (także w środku ramki).
+ */
+int nextCommandBinaryInterface(Map *map, BinaryInterface *interface,
+                               uint32_t lineNumber);
+
+/** @brief Zamienia polecenia tekstowe na strumień binarny.
+ * Wczytuje wiersze ze standardowego wejścia parserem
+ * @ref nextCommandParser i zapisuje odpowiadające im ramki. Wiersze
+ * niepoprawne składniowo, także z niepoprawną nazwą miasta, zapisywane są
+ * jako @ref BINARY_INVALID, a niepoprawne liczby (odrzucane przez funkcje
+ * mapy) jako @p 0.
+ * @param[in,out] output    - wskaźnik na plik na strumień binarny.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać pliku
+ * lub zaalokować pamięci.
+ */
+bool encodeBinaryInterface(FILE *output);
+
+#endif // BINARY_INTERFACE_H
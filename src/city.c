@@ -45,21 +45,53 @@ uint32_t hashString(const char *string) {
     uint64_t result = 0;
 
     while (*string) {
-        result = (result * 2333 + 1000 + *string) % 1000000007;
+        result = (result * CITY_HASH_BASE + CITY_HASH_OFFSET + *string)
+                 % CITY_HASH_MODULO;
         string++;
     }
 
     return result;
 }
 
+/** @brief Tworzy opis nazwy miasta.
+ * W jednym przejściu po słowie @p string liczy jego hasz i sprawdza, czy
+ * jest poprawną nazwą miasta (@ref isStringValidCityName).
+ * @param[in] string            - wskaźnik na słowo lub NULL.
+ * @return Opis nazwy; dla NULL niepoprawny opis z pustym haszem.
+ */
+CityName cityNameFromString(const char *string) {
+    CityName result = {string, 0, false};
+    if (string == NULL) {
+        return result;
+    }
+
+    uint64_t hash = 0;
+    bool isValid = *string != 0;
+
+    while (*string) {
+        if ((0 <= *string && *string <= 31) || *string == ';') {
+            isValid = false;
+        }
+        hash = (hash * CITY_HASH_BASE + CITY_HASH_OFFSET + *string)
+               % CITY_HASH_MODULO;
+        string++;
+    }
+
+    result.hash = hash;
+    result.isValid = isValid;
+
+    return result;
+}
+
 /** @brief Tworzy strukturę.
  * Tworzy strukturę z miastem o nazwie @p name oraz liczy hasz
  * słowa @p name.
- * @param[in] name              - wskaźnik na nazwę miasta.
+ * @param[in] name              - wskaźnik na nazwę miasta;
+ * @param[in] id                - numer miasta.
  * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
  * zaalokować pamięci.
  */
-City *newCity(const char *name) {
+City *newCity(const char *name, uint32_t id) {
     assert(isStringValidCityName(name));
 
     char *nameCopy = malloc(sizeof(char) * (strlen(name) + 1));
@@ -83,7 +115,7 @@ City *newCity(const char *name) {
 
     result->name = nameCopy;
     result->hashName = hashString(nameCopy);
-    result->distance = -1;
+    result->id = id;
 
     return result;
 }
@@ -100,35 +132,64 @@ void deleteCity(City *city) {
     free(city);
 }
 
+/** @brief Liczy miasta na liście miast.
+ * Nowe miasta dodawane są na początek listy i numerowane kolejnymi
+ * liczbami, więc liczba miast to numer pierwszego miasta powiększony o jeden.
+ * @param[in] listOfCities      - lista struktur @ref City.
+ * @return Liczba miast na liście.
+ */
+uint32_t countCitiesOnList(List *listOfCities) {
+    assert(listOfCities);
+
+    if (listOfCities->begin == listOfCities->end) {
+        return 0;
+    }
+
+    return ((City *)listOfCities->begin->data)->id + 1;
+}
+
 /** @brief Znajduje miasto na liście miast.
- * Znajduję strukturę @ref City o nazwie @p name na liście miast.
+ * Znajduję strukturę @ref City o nazwie @p name na liście miast, korzystając
+ * z wyznaczonego wcześniej haszu nazwy.
  * @param[in] listOfCities      - lista struktur @ref City;
- * @param[in] name              - wskaźnik na słowo będące nazwą szukanego miasta.
+ * @param[in] name              - wskaźnik na nazwę szukanego miasta.
  * @return Wskaźnik na szukaną strukturę lub NULL jeśli szukane miasto
  * nie znajduję się na liście.
  */
-City *findCityOnList(List *listOfCities, const char *name) {
+City *findCityByNameOnList(List *listOfCities, const CityName *name) {
     assert(listOfCities);
-    assert(name);
+    assert(name && name->name);
 
-    uint32_t hashName = hashString(name);
     ListIterator *iterator = listOfCities->begin;
     City *city;
 
     while (iterator != listOfCities->end) {
         city = iterator->data;
-        if (city->hashName == hashName && strcmp(city->name, name) == 0) {
-            break;
+        if (city->hashName == name->hash &&
+            strcmp(city->name, name->name) == 0) {
+            return city;
         }
 
         iterator = iterator->next;
     }
 
-    if (iterator == listOfCities->end) {
-        return NULL;
-    }
+    return NULL;
+}
+
+/** @brief Znajduje miasto na liście miast.
+ * Znajduję strukturę @ref City o nazwie @p name na liście miast.
+ * @param[in] listOfCities      - lista struktur @ref City;
+ * @param[in] name              - wskaźnik na słowo będące nazwą szukanego miasta.
+ * @return Wskaźnik na szukaną strukturę lub NULL jeśli szukane miasto
+ * nie znajduję się na liście.
+ */
+City *findCityOnList(List *listOfCities, const char *name) {
+    assert(listOfCities);
+    assert(name);
+
+    CityName cityName = {name, hashString(name), true};
 
-    return iterator->data;
+    return findCityByNameOnList(listOfCities, &cityName);
 }
 
 /** @brief Znajduje miasto na liście miast (tworzy nowe jeśli takiego nie ma).
@@ -145,18 +206,18 @@ City *findCityInsertIfNecessary(List *listOfCities, const char *name) {
 
     City *result = findCityOnList(listOfCities, name);
     if (result == NULL) {
-        City *city = newCity(name);
+        City *city = newCity(name, countCitiesOnList(listOfCities));
         if (city == NULL) {
             return NULL;
         }
 
-        ListIterator *iterator = insertList(listOfCities->end, city);
+        ListIterator *iterator = insertList(listOfCities->begin, city);
         if (iterator == NULL) {
             deleteCity(city);
             return NULL;
         }
 
-        return backList(listOfCities);
+        return city;
     }
 
     return result;
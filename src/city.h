@@ -13,36 +13,46 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#define CITY_HASH_BASE 2333
+///< podstawa haszu nazwy miasta (@ref hashString)
+
+#define CITY_HASH_OFFSET 1000
+///< wartość dodawana do kodu każdego znaku nazwy miasta
+
+#define CITY_HASH_MODULO 1000000007
+///< moduł haszu nazwy miasta
+
 /**
- * Struktura przechowująca miasto w mapie dróg krajowych. Dodatkowo
- * trzyma zmienne używane przez algorytm dijkstry do liczenia najkrótszej
- * drogi od pewnego ustalonego miasta.
+ * Struktura przechowująca miasto w mapie dróg krajowych. Zmienne używane
+ * przez algorytm dijkstry trzymane są osobno w strukturze
+ * @ref SearchState i indeksowane numerem miasta @ref City.id.
  */
 typedef struct City {
     char *name;                     ///< nazwa miasta
     uint32_t hashName;              ///< hasz nazwy miasta
+    uint32_t id;                    ///< numer miasta (kolejność dodania do mapy)
     List *roads;                    ///< list dróg wychodzących z miasta
-
-    /** @name Zmienne użwane przez algorytm dijkstry.
-     * Zmienne używane przez algorytm dijkstry do liczenia najkrótszej
-     * drogi od pewnego ustalonego miasta.
-     */
-    ///@{
-    int64_t distance;               ///< długość najkrótszej drogi
-    int64_t oldestRoadOnRoute;      ///< optymalny wiek najkrótszej drogi
-    bool isRouteUnequivocal;        ///< jednoznaczność najkrótszej drogi
-    struct City *previousOnRoute;   ///< poprzednie miasto na najkrótszej drodze
-    ///@}
 } City;
 
+/**
+ * Struktura przechowująca nazwę miasta razem z jej haszem i poprawnością,
+ * wyznaczonymi jednokrotnie, np. przez parser poleceń.
+ */
+typedef struct CityName {
+    const char *name;               ///< nazwa miasta
+    uint32_t hash;                  ///< hasz nazwy (@ref hashString)
+    bool isValid;                   ///< czy nazwa jest poprawną nazwą miasta
+} CityName;
+
 /** @brief Tworzy strukturę.
  * Tworzy strukturę z miastem o nazwie @p name oraz liczy hasz
  * słowa @p name.
- * @param[in] name              - wskaźnik na nazwę miasta.
+ * @param[in] name              - wskaźnik na nazwę miasta;
+ * @param[in] id                - numer miasta.
  * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
  * zaalokować pamięci.
  */
-City *newCity(const char *name);
+City *newCity(const char *name, uint32_t id);
 
 /** @brief Usuwa Strukutrę.
  * Usuwa strukturę wskazywaną przez @p city.
@@ -69,6 +79,24 @@ bool isStringValidCityName(const char *string);
  */
 City *findCityOnList(List *listOfCities, const char *name);
 
+/** @brief Znajduje miasto na liście miast.
+ * Znajduję strukturę @ref City o nazwie @p name na liście miast, korzystając
+ * z wyznaczonego wcześniej haszu nazwy.
+ * @param[in] listOfCities      - lista struktur @ref City;
+ * @param[in] name              - wskaźnik na nazwę szukanego miasta.
+ * @return Wskaźnik na szukaną strukturę lub NULL jeśli szukane miasto
+ * nie znajduję się na liście.
+ */
+City *findCityByNameOnList(List *listOfCities, const CityName *name);
+
+/** @brief Liczy miasta na liście miast.
+ * Nowe miasta dodawane są na początek listy i numerowane kolejnymi
+ * liczbami, więc liczba miast to numer pierwszego miasta powiększony o jeden.
+ * @param[in] listOfCities      - lista struktur @ref City.
+ * @return Liczba miast na liście.
+ */
+uint32_t countCitiesOnList(List *listOfCities);
+
 /** @brief Liczy hasz słowa.
  * Liczy hasz słowa @p string.
  * @param[in] string            - wskaźnik na słowo.
@@ -76,4 +104,12 @@ City *findCityOnList(List *listOfCities, const char *name);
  */
 uint32_t hashString(const char *string);
 
+/** @brief Tworzy opis nazwy miasta.
+ * W jednym przejściu po słowie @p string liczy jego hasz i sprawdza, czy
+ * jest poprawną nazwą miasta (@ref isStringValidCityName).
+ * @param[in] string            - wskaźnik na słowo lub NULL.
+ * @return Opis nazwy; dla NULL niepoprawny opis z pustym haszem.
+ */
+CityName cityNameFromString(const char *string);
+
 #endif // CITY_H
@@ -0,0 +1,75 @@
+/** @file
+ * Interfejs typowanego opisu polecenia mapy dróg.
+ *
+ * Polecenie opisuje jeden wiersz wejścia po sprawdzeniu i zamianie wszystkich
+ * pól: liczby są już przekonwertowane, a nazwy miast mają policzone hasze
+ * i poprawność (@ref CityName), więc funkcja @ref executeCommandMap nie
+ * przegląda napisów ponownie.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include "city.h"
+
+#include <stdint.h>
+
+/**
+ * Rodzaje poleceń.
+ */
+typedef enum CommandType {
+    COMMAND_ADD_ROAD,               ///< @ref addRoad
+    COMMAND_REPAIR_ROAD,            ///< @ref repairRoad
+    COMMAND_GET_ROUTE_DESCRIPTION,  ///< @ref getRouteDescription
+    COMMAND_NEW_ROUTE,              ///< @ref newRoute
+    COMMAND_EXTEND_ROUTE,           ///< @ref extendRoute
+    COMMAND_REMOVE_ROAD,            ///< @ref removeRoad
+    COMMAND_REMOVE_ROUTE,           ///< @ref removeRoute
+    COMMAND_ADD_ROUTE,              ///< droga krajowa podana przez miasta
+    COMMAND_QUERY_ROUTE,            ///< @ref queryRoute
+    COMMAND_DISTANCE_MATRIX,        ///< @ref distanceMatrix
+    COMMAND_NEW_ROUTES,             ///< @ref newRoutes
+    COMMAND_REMOVE_ROADS,           ///< @ref removeRoads
+    COMMAND_CHECK_REMOVE_ROAD       ///< @ref checkRemoveRoad
+} CommandType;
+
+/**
+ * Struktura przechowująca polecenie. Wykorzystywane pola:
+ *  - @ref COMMAND_ADD_ROAD - @p cities[0], @p cities[1], @p lengths[0],
+ *    @p years[0] (rok budowy);
+ *  - @ref COMMAND_REPAIR_ROAD - @p cities[0], @p cities[1], @p years[0]
+ *    (rok remontu);
+ *  - @ref COMMAND_GET_ROUTE_DESCRIPTION, @ref COMMAND_REMOVE_ROUTE -
+ *    @p routeId;
+ *  - @ref COMMAND_NEW_ROUTE - @p routeId, @p cities[0], @p cities[1];
+ *  - @ref COMMAND_EXTEND_ROUTE - @p routeId, @p cities[0];
+ *  - @ref COMMAND_REMOVE_ROAD, @ref COMMAND_QUERY_ROUTE,
+ *    @ref COMMAND_CHECK_REMOVE_ROAD - @p cities[0], @p cities[1];
+ *  - @ref COMMAND_ADD_ROUTE - @p routeId i @p citiesCount miast, a odcinek
+ *    między miastami @p cities[i - 1] i @p cities[i] ma długość
+ *    @p lengths[i - 1] i rok budowy @p years[i - 1];
+ *  - @ref COMMAND_DISTANCE_MATRIX - @p sourcesCount miast źródłowych, po
+ *    których do @p citiesCount miast są miasta docelowe;
+ *  - @ref COMMAND_NEW_ROUTES - @p citiesCount miast, a droga krajowa numer
+ *    @p routeIds[i - 1] ma prowadzić z miasta @p cities[0] do miasta
+ *    @p cities[i];
+ *  - @ref COMMAND_REMOVE_ROADS - @p citiesCount miast, a usuwany odcinek
+ *    numer @p i łączy miasta @p cities[2 * i] i @p cities[2 * i + 1].
+ *
+ * Niepoprawne liczby zapisywane są jako @p 0, które funkcje mapy odrzucają.
+ */
+typedef struct Command {
+    CommandType type;               ///< rodzaj polecenia
+    unsigned routeId;               ///< numer drogi krajowej
+    uint32_t citiesCount;           ///< liczba miast polecenia
+    uint32_t sourcesCount;          ///< liczba miast źródłowych
+    CityName *cities;               ///< kolejne miasta polecenia
+    unsigned *lengths;              ///< długości kolejnych odcinków dróg
+    unsigned *routeIds;             ///< numery kolejnych dróg krajowych
+    int *years;                     ///< lata budowy lub remontu odcinków dróg
+} Command;
+
+#endif // COMMAND_H
@@ -0,0 +1,455 @@
+/** @file
+ * Implementacja równoległego parsowania pliku z poleceniami tekstowymi.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "command_chunks.h"
+#include "command_parser.h"
+#include "text_interface.h"
+#include "thread_pool.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define COMMAND_CHUNK_SIZE (1 << 18)
+///< przybliżony rozmiar fragmentu pliku w bajtach
+
+#define COMMAND_CHUNKS_PER_THREAD 4
+///< liczba fragmentów partii na wątek (wyrównuje obciążenie wątków)
+
+#define INITIAL_CHUNK_MEMORY_SIZE 64
+///< początkowy rozmiar tablic poleceń i tablic miast fragmentu
+
+/**
+ * Struktura przechowująca wynik jednego wiersza fragmentu. Tablice miast,
+ * długości i lat polecenia zapisane są w tablicach fragmentu od pozycji
+ * @p offset, bo tablice fragmentu mogą być przenoszone przy powiększaniu.
+ */
+typedef struct ChunkRecord {
+    Command command;                ///< polecenie bez wskaźników na tablice
+    int result;                     ///< wynik @ref parseLineCommandParser
+    uint32_t lineNumber;            ///< numer wiersza we fragmencie
+    uint32_t offset;                ///< pozycja tablic polecenia
+} ChunkRecord;
+
+/**
+ * Struktura przechowująca fragment pliku i wyniki jego wierszy.
+ */
+typedef struct CommandChunk {
+    char *begin;                    ///< pierwszy znak fragmentu
+    char *end;                      ///< znak za ostatnim znakiem fragmentu
+    char *lastLine;                 ///< kopia ostatniego wiersza pliku,
+                                    ///< jeśli nie kończy się znakiem '\n'
+    uint32_t linesCount;            ///< liczba wierszy fragmentu
+    bool isOutOfMemory;             ///< czy parsowanie przerwał brak pamięci
+    ChunkRecord *records;           ///< wyniki wierszy z poleceniami
+    uint32_t recordsCount;          ///< liczba wyników
+    uint32_t recordsMemorySize;     ///< rozmiar tablicy wyników
+    CityName *cities;               ///< miasta kolejnych poleceń
+    unsigned *lengths;              ///< długości odcinków kolejnych poleceń
+    unsigned *routeIds;             ///< numery dróg krajowych kolejnych
+                                    ///< poleceń
+    int *years;                     ///< lata odcinków kolejnych poleceń
+    uint32_t citiesCount;           ///< zajęta część tablic miast
+    uint32_t citiesMemorySize;      ///< rozmiar tablic miast, długości,
+                                    ///< numerów dróg krajowych i lat
+} CommandChunk;
+
+/**
+ * Struktura przechowująca plik z poleceniami podzielony na fragmenty.
+ */
+typedef struct CommandChunks {
+    char *data;                     ///< odwzorowany plik
+    size_t size;                    ///< rozmiar odwzorowanego pliku
+    size_t position;                ///< pozycja pierwszego nieparsowanego
+                                    ///< znaku
+    size_t releasedSize;            ///< rozmiar zwolnionego początku pliku
+    ThreadPool *pool;               ///< pula wątków parsujących
+    uint32_t threadsCount;          ///< liczba wątków puli
+    CommandParser **parsers;        ///< parsery kolejnych wątków puli
+    CommandChunk *chunks;           ///< fragmenty bieżącej partii
+    uint32_t maxChunksCount;        ///< rozmiar tablicy fragmentów
+    uint32_t chunksCount;           ///< liczba fragmentów bieżącej partii
+    uint32_t chunkIndex;            ///< numer wykonywanego fragmentu
+    uint32_t recordIndex;           ///< numer wykonywanego wyniku
+    uint32_t lineBase;              ///< liczba wierszy przed wykonywanym
+                                    ///< fragmentem
+} CommandChunks;
+
+/** @brief Powiększa tablice fragmentu.
+ * @param[in,out] chunk         - wskaźnik na fragment;
+ * @param[in] recordsCount      - wymagany rozmiar tablicy wyników;
+ * @param[in] citiesCount       - wymagany rozmiar tablic miast.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool reserveChunkCommandChunks(CommandChunk *chunk, uint32_t recordsCount,
+                               uint32_t citiesCount) {
+    assert(chunk);
+
+    if (recordsCount > chunk->recordsMemorySize) {
+        uint32_t memorySize = chunk->recordsMemorySize * 2;
+        if (memorySize < recordsCount) {
+            memorySize = recordsCount;
+        }
+
+        ChunkRecord *records = realloc(chunk->records,
+                                       sizeof(ChunkRecord) * memorySize);
+        if (records == NULL) {
+            return false;
+        }
+        chunk->records = records;
+        chunk->recordsMemorySize = memorySize;
+    }
+
+    if (citiesCount <= chunk->citiesMemorySize) {
+        return true;
+    }
+
+    uint32_t memorySize = chunk->citiesMemorySize * 2;
+    if (memorySize < citiesCount) {
+        memorySize = citiesCount;
+    }
+
+    CityName *cities = realloc(chunk->cities, sizeof(CityName) * memorySize);
+    if (cities == NULL) {
+        return false;
+    }
+    chunk->cities = cities;
+
+    unsigned *lengths = realloc(chunk->lengths, sizeof(unsigned) * memorySize);
+    if (lengths == NULL) {
+        return false;
+    }
+    chunk->lengths = lengths;
+
+    unsigned *routeIds = realloc(chunk->routeIds,
+                                 sizeof(unsigned) * memorySize);
+    if (routeIds == NULL) {
+        return false;
+    }
+    chunk->routeIds = routeIds;
+
+    int *years = realloc(chunk->years, sizeof(int) * memorySize);
+    if (years == NULL) {
+        return false;
+    }
+    chunk->years = years;
+
+    chunk->citiesMemorySize = memorySize;
+    return true;
+}
+
+/** @brief Dodaje wynik wiersza do fragmentu.
+ * Kopiuje wykorzystywane pola tablic polecenia (zob. @ref Command) do tablic
+ * fragmentu.
+ * @param[in,out] chunk         - wskaźnik na fragment;
+ * @param[in] command           - wskaźnik na polecenie;
+ * @param[in] result            - wynik parsowania wiersza (@p 0 lub @p 1).
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool addRecordCommandChunks(CommandChunk *chunk, const Command *command,
+                            int result) {
+    assert(chunk);
+    assert(command);
+
+    uint32_t citiesCount = result == 0 ? command->citiesCount : 0;
+    if (!reserveChunkCommandChunks(chunk, chunk->recordsCount + 1,
+                                   chunk->citiesCount + citiesCount)) {
+        return false;
+    }
+
+    ChunkRecord *record = &chunk->records[chunk->recordsCount++];
+    record->command = *command;
+    record->result = result;
+    record->lineNumber = chunk->linesCount;
+    record->offset = chunk->citiesCount;
+    if (result != 0) {
+        return true;
+    }
+
+    uint32_t offset = chunk->citiesCount;
+    memcpy(chunk->cities + offset, command->cities,
+           sizeof(CityName) * citiesCount);
+
+    uint32_t segmentsCount = 0;
+    if (command->type == COMMAND_ADD_ROUTE) {
+        segmentsCount = citiesCount - 1;
+    } else if (command->type == COMMAND_NEW_ROUTES) {
+        memcpy(chunk->routeIds + offset, command->routeIds,
+               sizeof(unsigned) * (citiesCount - 1));
+    } else if (command->type == COMMAND_ADD_ROAD) {
+        segmentsCount = 1;
+    } else if (command->type == COMMAND_REPAIR_ROAD) {
+        chunk->years[offset] = command->years[0];
+    }
+    memcpy(chunk->lengths + offset, command->lengths,
+           sizeof(unsigned) * segmentsCount);
+    memcpy(chunk->years + offset, command->years, sizeof(int) * segmentsCount);
+
+    chunk->citiesCount += citiesCount;
+    return true;
+}
+
+/** @brief Parsuje fragment pliku.
+ * Zadanie puli wątków. Wiersze bez polecenia są tylko liczone.
+ * @param[in,out] argument      - wskaźnik na @ref CommandChunks;
+ * @param[in] taskIndex         - numer fragmentu;
+ * @param[in] threadIndex       - numer wątku.
+ */
+void parseChunkCommandChunks(void *argument, uint32_t taskIndex,
+                             uint32_t threadIndex) {
+    CommandChunks *chunks = argument;
+    CommandChunk *chunk = &chunks->chunks[taskIndex];
+    CommandParser *parser = chunks->parsers[threadIndex];
+
+    char *position = chunk->begin;
+    while (position < chunk->end) {
+        char *line = position;
+        size_t size = chunk->end - position;
+        char *newline = memchr(position, '\n', size);
+        bool isTerminated = newline != NULL;
+
+        /* Ostatni wiersz pliku bez znaku '\n' jest kopiowany, bo parser
+         * wymaga znaku '\n' za wierszem. */
+        if (isTerminated) {
+            position = newline + 1;
+        } else {
+            chunk->lastLine = malloc(size + 1);
+            if (chunk->lastLine == NULL) {
+                chunk->isOutOfMemory = true;
+                return;
+            }
+            memcpy(chunk->lastLine, line, size);
+            chunk->lastLine[size] = '\n';
+            line = chunk->lastLine;
+            position = chunk->end;
+        }
+        chunk->linesCount++;
+
+        Command command;
+        int result = parseLineCommandParser(parser, &command, line,
+                                            isTerminated);
+        if (result == 3) {
+            continue;
+        }
+
+        if (result == 2 || !addRecordCommandChunks(chunk, &command, result)) {
+            chunk->isOutOfMemory = true;
+            return;
+        }
+    }
+}
+
+/** @brief Parsuje następną partię fragmentów.
+ * Dzieli plik od pierwszego nieparsowanego znaku na fragmenty kończące się
+ * znakiem '\n' (lub końcem pliku) i parsuje je równolegle. Zwalnia strony
+ * pliku wykonanych już partii.
+ * @param[in,out] chunks        - wskaźnik na strukturę.
+ */
+void parseNextChunksCommandChunks(CommandChunks *chunks) {
+    assert(chunks);
+
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    size_t releasedSize = chunks->position / pageSize * pageSize;
+    if (releasedSize > chunks->releasedSize) {
+        madvise(chunks->data + chunks->releasedSize,
+                releasedSize - chunks->releasedSize, MADV_DONTNEED);
+        chunks->releasedSize = releasedSize;
+    }
+
+    chunks->chunksCount = 0;
+    while (chunks->chunksCount < chunks->maxChunksCount &&
+           chunks->position < chunks->size) {
+        CommandChunk *chunk = &chunks->chunks[chunks->chunksCount++];
+        size_t end = chunks->size;
+        if (end - chunks->position > COMMAND_CHUNK_SIZE) {
+            end = chunks->position + COMMAND_CHUNK_SIZE;
+            char *newline = memchr(chunks->data + end - 1, '\n',
+                                   chunks->size - end + 1);
+            end = newline == NULL ? chunks->size :
+                  (size_t)(newline + 1 - chunks->data);
+        }
+
+        chunk->begin = chunks->data + chunks->position;
+        chunk->end = chunks->data + end;
+        free(chunk->lastLine);
+        chunk->lastLine = NULL;
+        chunk->linesCount = 0;
+        chunk->isOutOfMemory = false;
+        chunk->recordsCount = 0;
+        chunk->citiesCount = 0;
+        chunks->position = end;
+    }
+
+    runThreadPool(chunks->pool, chunks->chunksCount, parseChunkCommandChunks,
+                  chunks);
+    chunks->chunkIndex = 0;
+    chunks->recordIndex = 0;
+}
+
+/** @brief Tworzy strukturę i odwzorowuje plik w pamięci.
+ * Odwzorowuje plik od bieżącej pozycji do końca. Odwzorowanie jest prywatne,
+ * więc zmiany wprowadzane przez parser nie trafiają do pliku.
+ * @param[in] input         - wskaźnik na plik z poleceniami tekstowymi;
+ * @param[in] threadsCount  - liczba wątków parsujących fragmenty.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy plik nie jest
+ * zwykłym plikiem, nie udało się go odwzorować, zaalokować pamięci lub
+ * utworzyć wątków.
+ */
+CommandChunks *newCommandChunks(FILE *input, uint32_t threadsCount) {
+    assert(input);
+    assert(threadsCount > 0);
+
+    int fd = fileno(input);
+    struct stat status;
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+    if (fd == -1 || fstat(fd, &status) == -1 || !S_ISREG(status.st_mode) ||
+            offset == -1 || offset > status.st_size) {
+        return NULL;
+    }
+
+    CommandChunks *result = calloc(1, sizeof(CommandChunks));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    /* Odwzorowanie musi zaczynać się na granicy strony, więc początek
+     * strony przed bieżącą pozycją jest od razu traktowany jako wykonany. */
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    off_t mappedOffset = offset / pageSize * pageSize;
+    result->size = status.st_size - mappedOffset;
+    result->position = offset - mappedOffset;
+    if (result->size > 0) {
+        result->data = mmap(NULL, result->size, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE, fd, mappedOffset);
+        if (result->data == MAP_FAILED) {
+            free(result);
+            return NULL;
+        }
+    }
+
+    result->threadsCount = threadsCount;
+    result->maxChunksCount = threadsCount * COMMAND_CHUNKS_PER_THREAD;
+    result->pool = newThreadPool(threadsCount);
+    result->parsers = calloc(threadsCount, sizeof(CommandParser *));
+    result->chunks = calloc(result->maxChunksCount, sizeof(CommandChunk));
+    if (result->pool == NULL || result->parsers == NULL ||
+            result->chunks == NULL) {
+        deleteCommandChunks(result);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < threadsCount; i++) {
+        result->parsers[i] = newCommandParser(NULL);
+        if (result->parsers[i] == NULL) {
+            deleteCommandChunks(result);
+            return NULL;
+        }
+    }
+
+    for (uint32_t i = 0; i < result->maxChunksCount; i++) {
+        if (!reserveChunkCommandChunks(&result->chunks[i],
+                                       INITIAL_CHUNK_MEMORY_SIZE,
+                                       INITIAL_CHUNK_MEMORY_SIZE)) {
+            deleteCommandChunks(result);
+            return NULL;
+        }
+    }
+
+    return result;
+}
+
+/** @brief Usuwa strukturę.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] chunks        - wskaźnik na usuwaną strukturę.
+ */
+void deleteCommandChunks(CommandChunks *chunks) {
+    if (chunks == NULL) {
+        return;
+    }
+
+    if (chunks->parsers != NULL) {
+        for (uint32_t i = 0; i < chunks->threadsCount; i++) {
+            deleteCommandParser(chunks->parsers[i]);
+        }
+        free(chunks->parsers);
+    }
+
+    if (chunks->chunks != NULL) {
+        for (uint32_t i = 0; i < chunks->maxChunksCount; i++) {
+            CommandChunk *chunk = &chunks->chunks[i];
+            free(chunk->lastLine);
+            free(chunk->records);
+            free(chunk->cities);
+            free(chunk->lengths);
+            free(chunk->routeIds);
+            free(chunk->years);
+        }
+        free(chunks->chunks);
+    }
+
+    deleteThreadPool(chunks->pool);
+    if (chunks->data != NULL) {
+        munmap(chunks->data, chunks->size);
+    }
+    free(chunks);
+}
+
+/** @brief Wykonuje kolejne polecenie z pliku.
+ * Jeśli polecenia bieżącej partii fragmentów się skończyły, to najpierw
+ * równolegle parsuje następną partię. Polecenie wykonuje funkcją
+ * @ref executeCommandTextInterface, a dla wiersza niepoprawnego składniowo
+ * wypisuje ERROR z numerem wiersza. Wiersze bez polecenia są pomijane.
+ * @param[in,out] map       - wskaźnik na mapę;
+ * @param[in,out] chunks    - wskaźnik na strukturę.
+ * @return Wartość @p 0 jeśli obsłużono polecenie,
+ * wartość @p 2 jeśli nie udało się zaalokować pamięci lub
+ * wartość @p EOF jeśli plik się skończył.
+ */
+int nextCommandChunks(Map *map, CommandChunks *chunks) {
+    assert(map);
+    assert(chunks);
+
+    while (chunks->chunkIndex == chunks->chunksCount ||
+           chunks->recordIndex ==
+           chunks->chunks[chunks->chunkIndex].recordsCount) {
+        if (chunks->chunkIndex < chunks->chunksCount) {
+            CommandChunk *chunk = &chunks->chunks[chunks->chunkIndex];
+            if (chunk->isOutOfMemory) {
+                return 2;
+            }
+            chunks->lineBase += chunk->linesCount;
+            chunks->chunkIndex++;
+            chunks->recordIndex = 0;
+        } else if (chunks->position < chunks->size) {
+            parseNextChunksCommandChunks(chunks);
+        } else {
+            return EOF;
+        }
+    }
+
+    CommandChunk *chunk = &chunks->chunks[chunks->chunkIndex];
+    ChunkRecord *record = &chunk->records[chunks->recordIndex++];
+    uint32_t lineNumber = chunks->lineBase + record->lineNumber;
+    if (record->result != 0) {
+        fprintf(stderr, "ERROR %" PRIu32 "\n", lineNumber);
+        return 0;
+    }
+
+    Command command = record->command;
+    command.cities = chunk->cities + record->offset;
+    command.lengths = chunk->lengths + record->offset;
+    command.routeIds = chunk->routeIds + record->offset;
+    command.years = chunk->years + record->offset;
+    executeCommandTextInterface(map, &command, lineNumber);
+    return 0;
+}
@@ -0,0 +1,59 @@
+/** @file
+ * Interfejs równoległego parsowania pliku z poleceniami tekstowymi.
+ *
+ * Plik jest odwzorowywany w pamięci i dzielony na fragmenty na granicach
+ * wierszy. Fragmenty kolejnej partii są parsowane równolegle przez pulę
+ * wątków, każdy na listę poleceń (@ref Command) z numerami wierszy
+ * względem początku fragmentu. Polecenia wykonywane są potem po kolei przez
+ * jeden wątek, a numery wierszy uzupełniane są o liczbę wierszy wcześniejszych
+ * fragmentów, więc wyniki i komunikaty ERROR są takie same jak przy
+ * @ref nextCommandTextInterface.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef COMMAND_CHUNKS_H
+#define COMMAND_CHUNKS_H
+
+#include "map.h"
+
+#include <stdio.h>
+#include <stdint.h>
+
+/**
+ * Struktura przechowująca plik z poleceniami podzielony na fragmenty.
+ */
+typedef struct CommandChunks CommandChunks;
+
+/** @brief Tworzy strukturę i odwzorowuje plik w pamięci.
+ * Odwzorowuje plik od bieżącej pozycji do końca. Odwzorowanie jest prywatne,
+ * więc zmiany wprowadzane przez parser nie trafiają do pliku.
+ * @param[in] input         - wskaźnik na plik z poleceniami tekstowymi;
+ * @param[in] threadsCount  - liczba wątków parsujących fragmenty.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy plik nie jest
+ * zwykłym plikiem, nie udało się go odwzorować, zaalokować pamięci lub
+ * utworzyć wątków.
+ */
+CommandChunks *newCommandChunks(FILE *input, uint32_t threadsCount);
+
+/** @brief Usuwa strukturę.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] chunks        - wskaźnik na usuwaną strukturę.
+ */
+void deleteCommandChunks(CommandChunks *chunks);
+
+/** @brief Wykonuje kolejne polecenie z pliku.
+ * Jeśli polecenia bieżącej partii fragmentów się skończyły, to najpierw
+ * równolegle parsuje następną partię. Polecenie wykonuje funkcją
+ * @ref executeCommandTextInterface, a dla wiersza niepoprawnego składniowo
+ * wypisuje ERROR z numerem wiersza. Wiersze bez polecenia są pomijane.
+ * @param[in,out] map       - wskaźnik na mapę;
+ * @param[in,out] chunks    - wskaźnik na strukturę.
+ * @return Wartość @p 0 jeśli obsłużono polecenie,
+ * wartość @p 2 jeśli nie udało się zaalokować pamięci lub
+ * wartość @p EOF jeśli plik się skończył.
+ */
+int nextCommandChunks(Map *map, CommandChunks *chunks);
+
+#endif // COMMAND_CHUNKS_H
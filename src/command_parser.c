@@ -0,0 +1,518 @@
+/** @file
+ * Implementacja parsera zamieniającego wiersze tekstowe na polecenia
+ * (@ref Command).
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "command_parser.h"
+#include "city.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <assert.h>
+#include <sys/types.h>
+
+#define INITIAL_COMMAND_MEMORY_SIZE 4
+///< początkowy rozmiar tablic miast, długości i lat polecenia
+
+/**
+ * Struktura opisująca polecenie o ustalonych rodzajach pól. Kolejne znaki
+ * @p fields opisują rodzaje kolejnych pól (zob. @ref parseFieldCommandParser),
+ * a pola w nawiasach kwadratowych powtarzają się do końca wiersza (co
+ * najmniej raz).
+ */
+typedef struct CommandPattern {
+    const char *name;               ///< pierwsze słowo wiersza
+    CommandType type;               ///< rodzaj polecenia
+    const char *fields;             ///< rodzaje pól po pierwszym słowie
+} CommandPattern;
+
+/**
+ * Polecenia o ustalonych rodzajach pól.
+ */
+const CommandPattern COMMAND_PATTERNS[] = {
+    {"addRoad", COMMAND_ADD_ROAD, "ccly"},
+    {"repairRoad", COMMAND_REPAIR_ROAD, "ccy"},
+    {"getRouteDescription", COMMAND_GET_ROUTE_DESCRIPTION, "R"},
+    {"newRoute", COMMAND_NEW_ROUTE, "rcc"},
+    {"extendRoute", COMMAND_EXTEND_ROUTE, "rc"},
+    {"removeRoad", COMMAND_REMOVE_ROAD, "cc"},
+    {"removeRoute", COMMAND_REMOVE_ROUTE, "r"},
+    {"queryRoute", COMMAND_QUERY_ROUTE, "cc"},
+    {"distanceMatrix", COMMAND_DISTANCE_MATRIX, "n[c]"},
+    {"newRoutes", COMMAND_NEW_ROUTES, "c[ic]"},
+    {"removeRoads", COMMAND_REMOVE_ROADS, "[cc]"},
+    {"checkRemoveRoad", COMMAND_CHECK_REMOVE_ROAD, "cc"}
+};
+
+#define COMMAND_PATTERNS_COUNT \
+    (sizeof(COMMAND_PATTERNS) / sizeof(COMMAND_PATTERNS[0]))
+///< liczba poleceń o ustalonych rodzajach pól
+
+/**
+ * Struktura przechowująca pole liczbowe przed zamianą na konkretny typ.
+ */
+typedef struct NumberField {
+    uint64_t magnitude;             ///< wartość bezwzględna liczby
+    bool isNegative;                ///< czy pole zaczyna się znakiem '-'
+    bool isValid;                   ///< czy pole jest liczbą dziesiętną
+                                    ///< mieszczącą się w 64 bitach
+} NumberField;
+
+/** @brief Tworzy parser poleceń.
+ * @param[in,out] input     - wskaźnik na plik z poleceniami tekstowymi lub
+ *                            NULL, jeśli wiersze będą podawane funkcji
+ *                            @ref parseLineCommandParser.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci.
+ */
+CommandParser *newCommandParser(FILE *input) {
+    CommandParser *result = calloc(1, sizeof(CommandParser));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    result->input = input;
+    result->cities = malloc(sizeof(CityName) * INITIAL_COMMAND_MEMORY_SIZE);
+    result->lengths = malloc(sizeof(unsigned) * INITIAL_COMMAND_MEMORY_SIZE);
+    result->routeIds = malloc(sizeof(unsigned) * INITIAL_COMMAND_MEMORY_SIZE);
+    result->years = malloc(sizeof(int) * INITIAL_COMMAND_MEMORY_SIZE);
+    result->memorySize = INITIAL_COMMAND_MEMORY_SIZE;
+
+    if (result->cities == NULL || result->lengths == NULL ||
+            result->routeIds == NULL || result->years == NULL) {
+        deleteCommandParser(result);
+        return NULL;
+    }
+
+    return result;
+}
+
+/** @brief Usuwa parser poleceń.
+ * Nie zamyka pliku. Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] parser        - wskaźnik na usuwaną strukturę.
+ */
+void deleteCommandParser(CommandParser *parser) {
+    if (parser == NULL) {
+        return;
+    }
+
+    free(parser->line);
+    free(parser->cities);
+    free(parser->lengths);
+    free(parser->routeIds);
+    free(parser->years);
+    free(parser);
+}
+
+/** @brief Powiększa tablice miast, długości, numerów dróg krajowych i lat
+ * parsera.
+ * @param[in,out] parser    - wskaźnik na parser;
+ * @param[in] size          - wymagany rozmiar tablic.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool reserveCommandParser(CommandParser *parser, uint32_t size) {
+    if (size <= parser->memorySize) {
+        return true;
+    }
+
+    uint32_t memorySize = parser->memorySize * 2;
+    if (memorySize < size) {
+        memorySize = size;
+    }
+
+    CityName *cities = realloc(parser->cities, sizeof(CityName) * memorySize);
+    if (cities == NULL) {
+        return false;
+    }
+    parser->cities = cities;
+
+    unsigned *lengths = realloc(parser->lengths, sizeof(unsigned) * memorySize);
+    if (lengths == NULL) {
+        return false;
+    }
+    parser->lengths = lengths;
+
+    unsigned *routeIds = realloc(parser->routeIds,
+                                 sizeof(unsigned) * memorySize);
+    if (routeIds == NULL) {
+        return false;
+    }
+    parser->routeIds = routeIds;
+
+    int *years = realloc(parser->years, sizeof(int) * memorySize);
+    if (years == NULL) {
+        return false;
+    }
+    parser->years = years;
+
+    parser->memorySize = memorySize;
+    return true;
+}
+
+/** @brief Czyta pole liczbowe.
+ * Przechodzi po znakach pola do znaku ';', '\n' lub znaku o kodzie 0
+ * i jednocześnie sprawdza, czy pole jest liczbą dziesiętną (z opcjonalnym
+ * znakiem '-' na początku), oraz liczy jej wartość bezwzględną.
+ * @param[in] position      - wskaźnik na pierwszy znak pola;
+ * @param[out] number       - wskaźnik na wczytaną liczbę.
+ * @return Wskaźnik na znak kończący pole.
+ */
+char *scanNumberCommandParser(char *position, NumberField *number) {
+    number->magnitude = 0;
+    number->isNegative = *position == '-';
+    if (number->isNegative) {
+        position++;
+    }
+
+    bool hasDigits = false;
+    bool isValid = true;
+    for (;; position++) {
+        char c = *position;
+        if (c == ';' || c == '\n' || c == 0) {
+            break;
+        }
+
+        unsigned digit = (unsigned char)c - (unsigned)'0';
+        if (digit > 9) {
+            isValid = false;
+            continue;
+        }
+
+        hasDigits = true;
+        if (number->magnitude > (UINT64_MAX - digit) / 10) {
+            isValid = false;
+        } else {
+            number->magnitude = number->magnitude * 10 + digit;
+        }
+    }
+
+    number->isValid = isValid && hasDigits;
+    return position;
+}
+
+/** @brief Zamienia pole liczbowe na liczbę typu unsigned.
+ * Liczba jest poprawna, jeśli przyjęłaby ją funkcja @ref stringToUnsigned
+ * (czyli strtoul, także z wartością ujemną, o ile wynik mieści się w typie
+ * unsigned).
+ * @param[in] number        - wskaźnik na pole liczbowe;
+ * @param[out] result       - wskaźnik na liczbę lub @p 0, jeśli pole jest
+ *                            niepoprawne.
+ * @return Wartość @p true jeśli liczba jest poprawna lub @p false
+ * w przeciwnym przypadku.
+ */
+bool unsignedFromNumberCommandParser(const NumberField *number,
+                                     unsigned *result) {
+    uint64_t value = number->isNegative ? (uint64_t)0 - number->magnitude
+                                        : number->magnitude;
+
+    if (!number->isValid || value > UINT_MAX) {
+        *result = 0;
+        return false;
+    }
+
+    *result = value;
+    return true;
+}
+
+/** @brief Zamienia pole liczbowe na liczbę typu int.
+ * Liczba jest poprawna, jeśli przyjęłaby ją funkcja @ref stringToInt.
+ * @param[in] number        - wskaźnik na pole liczbowe;
+ * @param[out] result       - wskaźnik na liczbę lub @p 0, jeśli pole jest
+ *                            niepoprawne.
+ * @return Wartość @p true jeśli liczba jest poprawna lub @p false
+ * w przeciwnym przypadku.
+ */
+bool intFromNumberCommandParser(const NumberField *number, int *result) {
+    uint64_t limit = number->isNegative ? (uint64_t)INT_MAX + 1 : INT_MAX;
+
+    if (!number->isValid || number->magnitude > limit) {
+        *result = 0;
+        return false;
+    }
+
+    *result = number->isNegative ? (int)(-(int64_t)number->magnitude)
+                                 : (int)number->magnitude;
+    return true;
+}
+
+/** @brief Czyta pole z nazwą miasta.
+ * Przechodzi po znakach pola do znaku ';', '\n' lub znaku o kodzie 0
+ * i jednocześnie liczy hasz nazwy (tak jak @ref hashString) oraz sprawdza
+ * jej poprawność (tak jak @ref isStringValidCityName).
+ * @param[in] position      - wskaźnik na pierwszy znak pola;
+ * @param[out] cityName     - wskaźnik na opis nazwy.
+ * @return Wskaźnik na znak kończący pole.
+ */
+char *scanCityNameCommandParser(char *position, CityName *cityName) {
+    char *begin = position;
+    uint64_t hash = 0;
+    bool isValid = true;
+
+    for (;; position++) {
+        char c = *position;
+        if (c == ';' || c == '\n' || c == 0) {
+            break;
+        }
+
+        if (0 <= c && c <= 31) {
+            isValid = false;
+        }
+        hash = (hash * CITY_HASH_BASE + CITY_HASH_OFFSET + c)
+               % CITY_HASH_MODULO;
+    }
+
+    cityName->name = begin;
+    cityName->hash = hash;
+    cityName->isValid = isValid && position != begin;
+
+    return position;
+}
+
+/** @brief Czyta jedno pole wiersza.
+ * Rodzaje pól:
+ *  - 'c' - nazwa miasta numer @p index;
+ *  - 'r' - numer drogi krajowej (niepoprawny zapisywany jako @p 0);
+ *  - 'R' - numer drogi krajowej (niepoprawny jest błędem składniowym);
+ *  - 'n' - liczba miast źródłowych (niepoprawna zapisywana jako @p 0);
+ *  - 'i' - numer drogi krajowej numer @p index (niepoprawny jako @p 0);
+ *  - 'l' - długość odcinka numer @p index (niepoprawna jako @p 0);
+ *  - 'y' - rok budowy lub remontu odcinka numer @p index (niepoprawny jako
+ *    @p 0).
+ *
+ * Znak kończący nazwę miasta zamieniany jest na zero.
+ * @param[in,out] parser    - wskaźnik na parser;
+ * @param[in,out] command   - wskaźnik na wczytywane polecenie;
+ * @param[in] kind          - rodzaj pola;
+ * @param[in] index         - numer miasta lub odcinka;
+ * @param[in,out] position  - wskaźnik na wskaźnik na pierwszy znak pola,
+ *                            przesuwany za znak kończący pole;
+ * @param[out] terminator   - wskaźnik na znak kończący pole.
+ * @return Wartość @p 0 jeśli pole jest poprawne,
+ * wartość @p 1 jeśli pole jest niepoprawne składniowo lub
+ * wartość @p 2 jeśli nie udało się zaalokować pamięci.
+ */
+int parseFieldCommandParser(CommandParser *parser, Command *command,
+                            char kind, uint32_t index, char **position,
+                            char *terminator) {
+    char *begin = *position;
+    char *end;
+
+    if (!reserveCommandParser(parser, index + 1)) {
+        return 2;
+    }
+
+    if (kind == 'c') {
+        end = scanCityNameCommandParser(begin, &parser->cities[index]);
+    } else {
+        NumberField number;
+        end = scanNumberCommandParser(begin, &number);
+
+        if (kind == 'r') {
+            unsignedFromNumberCommandParser(&number, &command->routeId);
+        } else if (kind == 'R') {
+            if (!unsignedFromNumberCommandParser(&number, &command->routeId)) {
+                return 1;
+            }
+        } else if (kind == 'n') {
+            unsigned count;
+            unsignedFromNumberCommandParser(&number, &count);
+            command->sourcesCount = count;
+        } else if (kind == 'l') {
+            unsignedFromNumberCommandParser(&number, &parser->lengths[index]);
+        } else if (kind == 'i') {
+            unsignedFromNumberCommandParser(&number, &parser->routeIds[index]);
+        } else {
+            intFromNumberCommandParser(&number, &parser->years[index]);
+        }
+    }
+
+    /* Puste może być tylko ostatnie słowo wiersza. */
+    *terminator = *end;
+    if (*end == 0 || (*end == ';' && end == begin)) {
+        return 1;
+    }
+
+    if (kind == 'c') {
+        *end = 0;
+    }
+    *position = end + 1;
+
+    return 0;
+}
+
+/** @brief Zamienia wiersz na polecenie.
+ * Wiersz musi kończyć się znakiem '\n', także jeśli na wejściu nie był nim
+ * zakończony. Znaki kończące nazwy miast zamieniane są na zera, więc nazwy
+ * miast polecenia wskazują na wiersz, a tablice polecenia na tablice parsera
+ * (ważne do następnego wywołania).
+ * @param[in,out] parser    - wskaźnik na parser;
+ * @param[out] command      - wskaźnik na wczytane polecenie;
+ * @param[in,out] line      - wskaźnik na pierwszy znak wiersza;
+ * @param[in] isTerminated  - czy wiersz na wejściu był zakończony znakiem
+ *                            '\n'.
+ * @return Wynik jak w @ref nextCommandParser (poza wartością @p EOF).
+ */
+int parseLineCommandParser(CommandParser *parser, Command *command,
+                           char *line, bool isTerminated) {
+    assert(parser);
+    assert(command);
+    assert(line);
+
+
+    /* Pierwsze słowo jest nazwą polecenia albo numerem drogi krajowej. */
+    NumberField number;
+    char *end = scanNumberCommandParser(line, &number);
+    char terminator = *end;
+    if (terminator == 0 || (terminator == ';' && end == line)) {
+        return 1;
+    }
+
+    /* Komentarz lub pusty wiersz. Komentarz niezakończony znakiem '\n' jest
+     * pomijany, jeśli jego pierwsze słowo kończy się znakiem ';'. */
+    if (end == line || *line == '#') {
+        return isTerminated || terminator == ';' ? 3 : 1;
+    }
+
+    /* Niepuste wiersze niezakończone znakiem '\n' są błędne. */
+    if (!isTerminated) {
+        return 1;
+    }
+
+    command->routeId = 0;
+    command->citiesCount = 0;
+    command->sourcesCount = 0;
+    char *position = end + 1;
+    size_t nameLength = end - line;
+
+    for (size_t i = 0; i < COMMAND_PATTERNS_COUNT; i++) {
+        const CommandPattern *pattern = &COMMAND_PATTERNS[i];
+        if (strncmp(pattern->name, line, nameLength) != 0 ||
+                pattern->name[nameLength] != 0) {
+            continue;
+        }
+
+        command->type = pattern->type;
+        for (const char *kind = pattern->fields; *kind; kind++) {
+            bool isRepeated = *kind == '[';
+            const char *groupEnd = kind + 1;
+            if (isRepeated) {
+                kind++;
+                groupEnd = strchr(kind, ']');
+            }
+
+            /* Pola inne niż miasta mają w powtórzeniu numer powtórzenia. */
+            uint32_t repetition = 0;
+            do {
+                for (const char *field = kind; field != groupEnd; field++) {
+                    if (terminator != ';') {
+                        return 1;
+                    }
+
+                    uint32_t index = *field == 'c' ? command->citiesCount
+                                                   : repetition;
+                    int result = parseFieldCommandParser(parser, command,
+                                                         *field, index,
+                                                         &position,
+                                                         &terminator);
+                    if (result != 0) {
+                        return result;
+                    }
+
+                    if (*field == 'c') {
+                        command->citiesCount++;
+                    }
+                }
+                repetition++;
+            } while (isRepeated && terminator == ';');
+
+            kind = isRepeated ? groupEnd : groupEnd - 1;
+        }
+
+        if (terminator != '\n') {
+            return 1;
+        }
+
+        command->cities = parser->cities;
+        command->lengths = parser->lengths;
+        command->routeIds = parser->routeIds;
+        command->years = parser->years;
+        return 0;
+    }
+
+    /* Wiersz: numer drogi krajowej;miasto;długość;rok;miasto;…;miasto. */
+    command->type = COMMAND_ADD_ROUTE;
+    unsignedFromNumberCommandParser(&number, &command->routeId);
+
+    uint32_t fieldsCount = 1;
+    while (terminator == ';') {
+        char kind = "lyc"[(fieldsCount + 1) % 3];
+        int result = parseFieldCommandParser(parser, command, kind,
+                                             (fieldsCount - 1) / 3, &position,
+                                             &terminator);
+        if (result != 0) {
+            return result;
+        }
+
+        fieldsCount++;
+    }
+
+    if (fieldsCount % 3 != 2 || fieldsCount < 5) {
+        return 1;
+    }
+
+    command->citiesCount = (fieldsCount + 1) / 3;
+    command->cities = parser->cities;
+    command->lengths = parser->lengths;
+    command->routeIds = parser->routeIds;
+    command->years = parser->years;
+    return 0;
+}
+
+/** @brief Wczytuje i zamienia na polecenie jeden wiersz.
+ * Wiersz jest poprawny składniowo wtedy, gdy jest zakończony znakiem '\n',
+ * nie zawiera znaku o kodzie 0, żadne jego słowo oddzielone znakiem ';' nie
+ * jest puste (poza ostatnim) oraz liczba słów zgadza się z poleceniem.
+ * Niepoprawne liczby i nazwy miast nie są błędem składniowym: liczby
+ * zapisywane są jako @p 0, a nazwy jako niepoprawne, co odrzucają funkcje
+ * mapy. Wyjątkiem jest numer drogi krajowej polecenia getRouteDescription.
+ * Nazwy miast polecenia wskazują na bufor parsera, a tablice polecenia na
+ * tablice parsera, więc są ważne do następnego wywołania.
+ * @param[in,out] parser    - wskaźnik na parser;
+ * @param[out] command      - wskaźnik na wczytane polecenie.
+ * @return Wartość @p 0 jeśli wczytano polecenie,
+ * wartość @p 1 jeśli wiersz jest niepoprawny składniowo (także niepusty
+ * wiersz niezakończony znakiem '\n'),
+ * wartość @p 2 jeśli nie udało się zaalokować pamięci,
+ * wartość @p 3 jeśli wiersz nie zawiera polecenia (komentarz lub pusty
+ * wiersz) lub
+ * wartość @p EOF jeśli wejście się skończyło.
+ */
+int nextCommandParser(CommandParser *parser, Command *command) {
+    assert(parser);
+    assert(command);
+    assert(parser->input);
+
+    errno = 0;
+    ssize_t size = getline(&parser->line, &parser->lineMemorySize,
+                           parser->input);
+    if (size <= 0) {
+        return errno == ENOMEM ? 2 : EOF;
+    }
+
+    /* Znak '\n' na końcu wiersza zatrzymuje pętle czytające pola. Ostatni
+     * wiersz wejścia może go nie mieć, wtedy zastępuje on zero kończące
+     * napis wczytany przez getline. */
+    bool isTerminated = parser->line[size - 1] == '\n';
+    if (!isTerminated) {
+        parser->line[size] = '\n';
+    }
+
+    return parseLineCommandParser(parser, command, parser->line,
+                                  isTerminated);
+}
@@ -0,0 +1,90 @@
+/** @file
+ * Interfejs parsera zamieniającego wiersze tekstowe na polecenia
+ * (@ref Command).
+ *
+ * Parser przechodzi po znakach wiersza raz: dzieli go na pola, sprawdza
+ * i konwertuje liczby oraz liczy hasze i poprawność nazw miast. Rodzaj
+ * każdego pola wynika z pierwszego słowa wiersza, więc pole jest tylko
+ * jednokrotnie interpretowane w odpowiedni sposób.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef COMMAND_PARSER_H
+#define COMMAND_PARSER_H
+
+#include "command.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Struktura przechowująca stan parsera poleceń.
+ */
+typedef struct CommandParser {
+    FILE *input;                    ///< plik z poleceniami tekstowymi
+    char *line;                     ///< ostatnio wczytany wiersz
+    size_t lineMemorySize;          ///< rozmiar bufora na wiersz
+    CityName *cities;               ///< miasta ostatniego polecenia
+    unsigned *lengths;              ///< długości odcinków ostatniego polecenia
+    unsigned *routeIds;             ///< numery dróg krajowych ostatniego
+                                    ///< polecenia
+    int *years;                     ///< lata odcinków ostatniego polecenia
+    uint32_t memorySize;            ///< rozmiar tablic polecenia
+} CommandParser;
+
+/** @brief Tworzy parser poleceń.
+ * @param[in,out] input     - wskaźnik na plik z poleceniami tekstowymi lub
+ *                            NULL, jeśli wiersze będą podawane funkcji
+ *                            @ref parseLineCommandParser.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci.
+ */
+CommandParser *newCommandParser(FILE *input);
+
+/** @brief Usuwa parser poleceń.
+ * Nie zamyka pliku. Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] parser        - wskaźnik na usuwaną strukturę.
+ */
+void deleteCommandParser(CommandParser *parser);
+
+/** @brief Wczytuje i zamienia na polecenie jeden wiersz.
+ * Wiersz jest poprawny składniowo wtedy, gdy jest zakończony znakiem '\n',
+ * nie zawiera znaku o kodzie 0, żadne jego słowo oddzielone znakiem ';' nie
+ * jest puste (poza ostatnim) oraz liczba słów zgadza się z poleceniem.
+ * Niepoprawne liczby i nazwy miast nie są błędem składniowym: liczby
+ * zapisywane są jako @p 0, a nazwy jako niepoprawne, co odrzucają funkcje
+ * mapy. Wyjątkiem jest numer drogi krajowej polecenia getRouteDescription.
+ * Nazwy miast polecenia wskazują na bufor parsera, a tablice polecenia na
+ * tablice parsera, więc są ważne do następnego wywołania.
+ * @param[in,out] parser    - wskaźnik na parser z plikiem;
+ * @param[out] command      - wskaźnik na wczytane polecenie.
+ * @return Wartość @p 0 jeśli wczytano polecenie,
+ * wartość @p 1 jeśli wiersz jest niepoprawny składniowo (także niepusty
+ * wiersz niezakończony znakiem '\n'),
+ * wartość @p 2 jeśli nie udało się zaalokować pamięci,
+ * wartość @p 3 jeśli wiersz nie zawiera polecenia (komentarz lub pusty
+ * wiersz) lub
+ * wartość @p EOF jeśli wejście się skończyło.
+ */
+int nextCommandParser(CommandParser *parser, Command *command);
+
+/** @brief Zamienia wiersz na polecenie.
+ * Wiersz musi kończyć się znakiem '\n', także jeśli na wejściu nie był nim
+ * zakończony. Znaki kończące nazwy miast zamieniane są na zera, więc nazwy
+ * miast polecenia wskazują na wiersz, a tablice polecenia na tablice parsera
+ * (ważne do następnego wywołania).
+ * @param[in,out] parser    - wskaźnik na parser;
+ * @param[out] command      - wskaźnik na wczytane polecenie;
+ * @param[in,out] line      - wskaźnik na pierwszy znak wiersza;
+ * @param[in] isTerminated  - czy wiersz na wejściu był zakończony znakiem
+ *                            '\n'.
+ * @return Wynik jak w @ref nextCommandParser (poza wartością @p EOF).
+ */
+int parseLineCommandParser(CommandParser *parser, Command *command,
+                           char *line, bool isTerminated);
+
+#endif // COMMAND_PARSER_H
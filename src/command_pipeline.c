@@ -0,0 +1,436 @@
+/** @file
+ * Implementacja potoku wykonującego polecenia tekstowe w trzech wątkach.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "command_pipeline.h"
+#include "command_parser.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define COMMAND_PIPELINE_SIZE 1024
+///< liczba miejsc tablicy cyklicznej potoku
+
+#define COMMAND_PIPELINE_SPIN_COUNT 256
+///< liczba sprawdzeń licznika przed uśpieniem wątku
+
+#define COMMAND_PIPELINE_BATCH_SIZE (COMMAND_PIPELINE_SIZE / 4)
+///< liczba miejsc, na które czeka uśpiony wątek parsera lub wyjścia
+
+/**
+ * Struktura przechowująca licznik miejsc przekazanych przez etap potoku
+ * następnemu etapowi. Licznik zwiększa jeden wątek i czeka na niego jeden
+ * wątek. Blokada i zmienna warunkowa są używane tylko wtedy, gdy czekający
+ * wątek zasypia.
+ */
+typedef struct PipelineCounter {
+    atomic_uint_fast64_t value;     ///< liczba przekazanych miejsc
+    atomic_uint_fast64_t wakeValue; ///< wartość, która budzi czekający wątek,
+                                    ///< lub @p 0, jeśli wątek nie śpi
+    pthread_mutex_t mutex;          ///< blokada usypiania
+    pthread_cond_t condition;       ///< sygnał o zwiększeniu licznika
+    uint64_t waitsCount;            ///< liczba uśpień czekającego wątku
+} PipelineCounter;
+
+/**
+ * Struktura przechowująca miejsce potoku: jeden wiersz wejścia i jego wynik.
+ * Miejsce ma własny parser, więc polecenie wskazuje na jego bufory aż do
+ * ponownego użycia miejsca.
+ */
+typedef struct PipelineSlot {
+    CommandParser *parser;          ///< parser wczytujący wiersz do miejsca
+    Command command;                ///< wczytane polecenie
+    int result;                     ///< wynik @ref nextCommandParser
+    uint32_t lineNumber;            ///< numer wiersza
+    bool isCorrect;                 ///< czy wykonanie się powiodło
+    char *description;              ///< opis drogi krajowej do wypisania
+    size_t descriptionMemorySize;   ///< rozmiar bufora na opis
+} PipelineSlot;
+
+/**
+ * Struktura przechowująca potok poleceń.
+ */
+typedef struct CommandPipeline {
+    PipelineSlot *slots;            ///< tablica cykliczna miejsc
+    PipelineCounter parsed;         ///< miejsca wczytane przez parser
+    PipelineCounter executed;       ///< miejsca obsłużone przez wykonawcę
+    PipelineCounter printed;        ///< miejsca zwolnione przez wątek wyjścia
+    pthread_t parserThread;         ///< wątek parsera
+    pthread_t outputThread;         ///< wątek wyjścia
+    bool isFinished;                ///< czy wątki się zakończyły
+} CommandPipeline;
+
+/** @brief Inicjuje licznik.
+ * @param[out] counter      - wskaźnik na licznik.
+ */
+void initCounterCommandPipeline(PipelineCounter *counter) {
+    assert(counter);
+
+    atomic_init(&counter->value, 0);
+    atomic_init(&counter->wakeValue, 0);
+    pthread_mutex_init(&counter->mutex, NULL);
+    pthread_cond_init(&counter->condition, NULL);
+    counter->waitsCount = 0;
+}
+
+/** @brief Usuwa blokadę i zmienną warunkową licznika.
+ * @param[in,out] counter   - wskaźnik na licznik.
+ */
+void destroyCounterCommandPipeline(PipelineCounter *counter) {
+    assert(counter);
+
+    pthread_mutex_destroy(&counter->mutex);
+    pthread_cond_destroy(&counter->condition);
+}
+
+/** @brief Zwiększa licznik o jeden.
+ * Budzi czekający wątek tylko wtedy, gdy śpi, a licznik osiągnął wartość,
+ * na którą czeka. Zapis licznika i odczyt tej wartości są sekwencyjnie
+ * spójne, tak jak ich zapis i odczyt w @ref waitCounterCommandPipeline, więc
+ * sygnał nie może zostać zgubiony.
+ * @param[in,out] counter   - wskaźnik na licznik.
+ */
+void advanceCounterCommandPipeline(PipelineCounter *counter) {
+    assert(counter);
+
+    uint64_t value = atomic_fetch_add(&counter->value, 1) + 1;
+    uint64_t wakeValue = atomic_load(&counter->wakeValue);
+    if (wakeValue != 0 && value >= wakeValue) {
+        pthread_mutex_lock(&counter->mutex);
+        pthread_cond_signal(&counter->condition);
+        pthread_mutex_unlock(&counter->mutex);
+    }
+}
+
+/** @brief Czeka, aż licznik osiągnie podaną wartość.
+ * Najpierw sprawdza licznik @ref COMMAND_PIPELINE_SPIN_COUNT razy, a potem
+ * zasypia na zmiennej warunkowej aż do osiągnięcia wartości @p wakeValue.
+ * Uśpiony wątek nie jest więc budzony po każdym miejscu, tylko po całej
+ * partii, co ogranicza przełączenia wątków, gdy etapy dzielą rdzeń.
+ * @param[in,out] counter   - wskaźnik na licznik;
+ * @param[in] target        - oczekiwana wartość licznika;
+ * @param[in] wakeValue     - wartość licznika, która budzi uśpiony wątek;
+ *                            licznik musi ją osiągnąć bez udziału
+ *                            czekającego wątku.
+ */
+void waitCounterCommandPipeline(PipelineCounter *counter, uint64_t target,
+                                uint64_t wakeValue) {
+    assert(counter);
+    assert(target > 0 && wakeValue >= target);
+
+    for (uint32_t i = 0; i < COMMAND_PIPELINE_SPIN_COUNT; i++) {
+        if (atomic_load_explicit(&counter->value, memory_order_acquire) >=
+                target) {
+            return;
+        }
+    }
+
+    pthread_mutex_lock(&counter->mutex);
+    atomic_store(&counter->wakeValue, wakeValue);
+    if (atomic_load(&counter->value) < target) {
+        counter->waitsCount++;
+        do {
+            pthread_cond_wait(&counter->condition, &counter->mutex);
+        } while (atomic_load(&counter->value) < wakeValue);
+    }
+    atomic_store(&counter->wakeValue, 0);
+    pthread_mutex_unlock(&counter->mutex);
+}
+
+/** @brief Sprawdza, czy wynik parsera kończy potok.
+ * @param[in] result        - wynik @ref nextCommandParser.
+ * @return Wartość @p true jeśli wejście się skończyło lub nie udało się
+ * zaalokować pamięci.
+ */
+bool isLastCommandPipeline(int result) {
+    return result == EOF || result == 2;
+}
+
+/** @brief Funkcja wykonywana przez wątek parsera.
+ * Wczytuje kolejne wiersze do wolnych miejsc potoku aż do końca wejścia.
+ * Gdy wszystkie miejsca są zajęte, czeka na zwolnienie całej partii miejsc.
+ * @param[in] data          - wskaźnik na @ref CommandPipeline.
+ * @return Wartość NULL.
+ */
+void *parserThreadCommandPipeline(void *data) {
+    CommandPipeline *pipeline = data;
+
+    uint32_t lineNumber = 0;
+    for (uint64_t index = 0; ; index++) {
+        if (index >= COMMAND_PIPELINE_SIZE) {
+            uint64_t target = index - COMMAND_PIPELINE_SIZE + 1;
+            waitCounterCommandPipeline(&pipeline->printed, target,
+                                       target + COMMAND_PIPELINE_BATCH_SIZE);
+        }
+
+        PipelineSlot *slot = &pipeline->slots[index % COMMAND_PIPELINE_SIZE];
+        slot->result = nextCommandParser(slot->parser, &slot->command);
+        slot->lineNumber = ++lineNumber;
+        bool isLast = isLastCommandPipeline(slot->result);
+        advanceCounterCommandPipeline(&pipeline->parsed);
+
+        if (isLast) {
+            return NULL;
+        }
+    }
+}
+
+/** @brief Funkcja wykonywana przez wątek wyjścia.
+ * Wypisuje wyniki kolejnych obsłużonych miejsc i zwalnia je dla parsera.
+ * Gdy brak wyników, czeka na partię wyników, ale nie dłuższą niż liczba
+ * wczytanych już wierszy, bo wykonawca może czekać na wejście.
+ * @param[in] data          - wskaźnik na @ref CommandPipeline.
+ * @return Wartość NULL.
+ */
+void *outputThreadCommandPipeline(void *data) {
+    CommandPipeline *pipeline = data;
+
+    for (uint64_t index = 0; ; index++) {
+        uint64_t wakeValue = atomic_load(&pipeline->parsed.value);
+        if (wakeValue > index + COMMAND_PIPELINE_BATCH_SIZE) {
+            wakeValue = index + COMMAND_PIPELINE_BATCH_SIZE;
+        } else if (wakeValue < index + 1) {
+            wakeValue = index + 1;
+        }
+        waitCounterCommandPipeline(&pipeline->executed, index + 1, wakeValue);
+
+        PipelineSlot *slot = &pipeline->slots[index % COMMAND_PIPELINE_SIZE];
+        if (slot->result == 1 || (slot->result == 0 && !slot->isCorrect)) {
+            fprintf(stderr, "ERROR %" PRIu32 "\n", slot->lineNumber);
+        } else if (slot->result == 0 &&
+                   (slot->command.type == COMMAND_GET_ROUTE_DESCRIPTION ||
+                    isQueryCommandMap(&slot->command))) {
+            printf("%s\n", slot->description);
+        }
+        bool isLast = isLastCommandPipeline(slot->result);
+        advanceCounterCommandPipeline(&pipeline->printed);
+
+        if (isLast) {
+            return NULL;
+        }
+    }
+}
+
+/** @brief Zapisuje opis drogi krajowej w buforze miejsca.
+ * Powiększa bufor miejsca, jeśli opis się nie mieści.
+ * @param[in,out] map       - wskaźnik na mapę;
+ * @param[in,out] slot      - wskaźnik na miejsce potoku.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool describeRouteCommandPipeline(Map *map, PipelineSlot *slot) {
+    assert(map);
+    assert(slot);
+
+    unsigned routeId = slot->command.routeId;
+    size_t size = writeRouteDescription(map, routeId, slot->description,
+                                        slot->descriptionMemorySize);
+    if (size < slot->descriptionMemorySize) {
+        return true;
+    }
+
+    size_t memorySize = 2 * slot->descriptionMemorySize;
+    if (memorySize < size + 1) {
+        memorySize = size + 1;
+    }
+
+    char *description = realloc(slot->description, memorySize);
+    if (description == NULL) {
+        return false;
+    }
+    slot->description = description;
+    slot->descriptionMemorySize = memorySize;
+
+    writeRouteDescription(map, routeId, description, memorySize);
+    return true;
+}
+
+/** @brief Zapisuje wynik zapytania w buforze miejsca.
+ * Powiększa bufor miejsca, jeśli wynik funkcji @ref queryCommandMap się nie
+ * mieści.
+ * @param[in,out] map       - wskaźnik na mapę;
+ * @param[in,out] slot      - wskaźnik na miejsce potoku.
+ * @return Wartość @p true lub @p false, jeśli zapytanie zakończyło się
+ * błędem.
+ */
+bool queryCommandPipeline(Map *map, PipelineSlot *slot) {
+    assert(map);
+    assert(slot);
+
+    char *result = (char *) queryCommandMap(map, &slot->command);
+    if (result == NULL) {
+        return false;
+    }
+
+    size_t size = strlen(result);
+    if (size >= slot->descriptionMemorySize) {
+        char *description = realloc(slot->description, size + 1);
+        if (description == NULL) {
+            free(result);
+            return false;
+        }
+        slot->description = description;
+        slot->descriptionMemorySize = size + 1;
+    }
+
+    memcpy(slot->description, result, size + 1);
+    free(result);
+    return true;
+}
+
+/** @brief Usuwa miejsca potoku.
+ * @param[in] slots         - wskaźnik na tablicę miejsc lub NULL.
+ */
+void deleteSlotsCommandPipeline(PipelineSlot *slots) {
+    if (slots == NULL) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < COMMAND_PIPELINE_SIZE; i++) {
+        deleteCommandParser(slots[i].parser);
+        free(slots[i].description);
+    }
+    free(slots);
+}
+
+/** @brief Tworzy potok i uruchamia wątki parsera i wyjścia.
+ * @param[in,out] input     - wskaźnik na plik z poleceniami tekstowymi;
+ *                            od tej chwili czyta go wyłącznie wątek parsera.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci lub utworzyć wątków.
+ */
+CommandPipeline *newCommandPipeline(FILE *input) {
+    assert(input);
+
+    CommandPipeline *result = malloc(sizeof(CommandPipeline));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    result->slots = calloc(COMMAND_PIPELINE_SIZE, sizeof(PipelineSlot));
+    if (result->slots == NULL) {
+        free(result);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < COMMAND_PIPELINE_SIZE; i++) {
+        result->slots[i].parser = newCommandParser(input);
+        if (result->slots[i].parser == NULL) {
+            deleteSlotsCommandPipeline(result->slots);
+            free(result);
+            return NULL;
+        }
+    }
+
+    initCounterCommandPipeline(&result->parsed);
+    initCounterCommandPipeline(&result->executed);
+    initCounterCommandPipeline(&result->printed);
+    result->isFinished = false;
+
+    if (pthread_create(&result->outputThread, NULL,
+                       outputThreadCommandPipeline, result) != 0) {
+        result->isFinished = true;
+        deleteCommandPipeline(result);
+        return NULL;
+    }
+
+    if (pthread_create(&result->parserThread, NULL,
+                       parserThreadCommandPipeline, result) != 0) {
+        /* Wątek wyjścia kończy się na pierwszym miejscu, jeśli oznacza ono
+         * koniec wejścia. */
+        result->slots[0].result = EOF;
+        advanceCounterCommandPipeline(&result->executed);
+        pthread_join(result->outputThread, NULL);
+        result->isFinished = true;
+        deleteCommandPipeline(result);
+        return NULL;
+    }
+
+    return result;
+}
+
+/** @brief Usuwa potok.
+ * Wolno ją wywołać dopiero wtedy, gdy @ref nextCommandPipeline zwróciła
+ * wartość różną od @p 0, czyli po zakończeniu wątków potoku. Nic nie robi,
+ * jeśli wskaźnik ma wartość NULL.
+ * @param[in] pipeline      - wskaźnik na usuwaną strukturę.
+ */
+void deleteCommandPipeline(CommandPipeline *pipeline) {
+    if (pipeline == NULL) {
+        return;
+    }
+
+    assert(pipeline->isFinished);
+
+    destroyCounterCommandPipeline(&pipeline->parsed);
+    destroyCounterCommandPipeline(&pipeline->executed);
+    destroyCounterCommandPipeline(&pipeline->printed);
+    deleteSlotsCommandPipeline(pipeline->slots);
+    free(pipeline);
+}
+
+/** @brief Wykonuje kolejne polecenie z potoku.
+ * Czeka na polecenie wczytane przez wątek parsera i wykonuje je tak jak
+ * @ref executeCommandTextInterface, ale wynik (opis drogi krajowej lub
+ * komunikat ERROR z numerem wiersza) przekazuje do wypisania wątkowi wyjścia.
+ * Po ostatnim wierszu czeka na zakończenie wątków, więc wszystkie wyniki są
+ * już wypisane.
+ * @param[in,out] map       - wskaźnik na mapę;
+ * @param[in,out] pipeline  - wskaźnik na potok.
+ * @return Wartość @p 0 jeśli obsłużono wiersz,
+ * wartość @p 2 jeśli nie udało się zaalokować pamięci lub
+ * wartość @p EOF jeśli wejście się skończyło.
+ */
+int nextCommandPipeline(Map *map, CommandPipeline *pipeline) {
+    assert(map);
+    assert(pipeline);
+    assert(!pipeline->isFinished);
+
+    uint64_t index = atomic_load_explicit(&pipeline->executed.value,
+                                          memory_order_relaxed);
+    waitCounterCommandPipeline(&pipeline->parsed, index + 1, index + 1);
+
+    PipelineSlot *slot = &pipeline->slots[index % COMMAND_PIPELINE_SIZE];
+    int result = slot->result;
+    if (result == 0) {
+        if (slot->command.type == COMMAND_GET_ROUTE_DESCRIPTION) {
+            slot->isCorrect = describeRouteCommandPipeline(map, slot);
+        } else if (isQueryCommandMap(&slot->command)) {
+            slot->isCorrect = queryCommandPipeline(map, slot);
+        } else {
+            slot->isCorrect = executeCommandMap(map, &slot->command);
+        }
+    }
+    advanceCounterCommandPipeline(&pipeline->executed);
+
+    if (!isLastCommandPipeline(result)) {
+        return 0;
+    }
+
+    pthread_join(pipeline->parserThread, NULL);
+    pthread_join(pipeline->outputThread, NULL);
+    pipeline->isFinished = true;
+    return result;
+}
+
+/** @brief Liczniki uśpień etapów potoku.
+ * Dokładne po @ref nextCommandPipeline zwracającej wartość różną od @p 0.
+ * @param[in] pipeline      - wskaźnik na potok.
+ * @return Liczby uśpień etapów potoku.
+ */
+PipelineStatistics getStatisticsCommandPipeline(CommandPipeline *pipeline) {
+    assert(pipeline);
+
+    PipelineStatistics result;
+    result.parserWaits = pipeline->printed.waitsCount;
+    result.executorWaits = pipeline->parsed.waitsCount;
+    result.outputWaits = pipeline->executed.waitsCount;
+    return result;
+}
@@ -0,0 +1,75 @@
+/** @file
+ * Interfejs potoku wykonującego polecenia tekstowe w trzech wątkach.
+ *
+ * Wątek parsera wczytuje wiersze i zamienia je na polecenia, wątek
+ * wywołujący @ref nextCommandPipeline wykonuje je na mapie w kolejności
+ * wejścia, a wątek wyjścia wypisuje opisy dróg krajowych i komunikaty
+ * ERROR. Etapy przekazują sobie miejsca ze stałej tablicy cyklicznej przez
+ * trzy liczniki atomowe, więc wyniki i numery wierszy są takie same jak przy
+ * wykonaniu sekwencyjnym (@ref nextCommandTextInterface).
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef COMMAND_PIPELINE_H
+#define COMMAND_PIPELINE_H
+
+#include "map.h"
+
+#include <stdio.h>
+#include <stdint.h>
+
+/**
+ * Struktura przechowująca potok poleceń.
+ */
+typedef struct CommandPipeline CommandPipeline;
+
+/**
+ * Struktura przechowująca liczby uśpień kolejnych etapów potoku na pustej lub
+ * pełnej kolejce (etap, który czeka najrzadziej, ogranicza przepustowość).
+ */
+typedef struct PipelineStatistics {
+    uint64_t parserWaits;           ///< uśpienia parsera na pełnej kolejce
+    uint64_t executorWaits;         ///< uśpienia wykonawcy na pustej kolejce
+    uint64_t outputWaits;           ///< uśpienia wątku wyjścia
+} PipelineStatistics;
+
+/** @brief Tworzy potok i uruchamia wątki parsera i wyjścia.
+ * @param[in,out] input     - wskaźnik na plik z poleceniami tekstowymi;
+ *                            od tej chwili czyta go wyłącznie wątek parsera.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci lub utworzyć wątków.
+ */
+CommandPipeline *newCommandPipeline(FILE *input);
+
+/** @brief Usuwa potok.
+ * Wolno ją wywołać dopiero wtedy, gdy @ref nextCommandPipeline zwróciła
+ * wartość różną od @p 0, czyli po zakończeniu wątków potoku. Nic nie robi,
+ * jeśli wskaźnik ma wartość NULL.
+ * @param[in] pipeline      - wskaźnik na usuwaną strukturę.
+ */
+void deleteCommandPipeline(CommandPipeline *pipeline);
+
+/** @brief Wykonuje kolejne polecenie z potoku.
+ * Czeka na polecenie wczytane przez wątek parsera i wykonuje je tak jak
+ * @ref executeCommandTextInterface, ale wynik (opis drogi krajowej lub
+ * komunikat ERROR z numerem wiersza) przekazuje do wypisania wątkowi wyjścia.
+ * Po ostatnim wierszu czeka na zakończenie wątków, więc wszystkie wyniki są
+ * już wypisane.
+ * @param[in,out] map       - wskaźnik na mapę;
+ * @param[in,out] pipeline  - wskaźnik na potok.
+ * @return Wartość @p 0 jeśli obsłużono wiersz,
+ * wartość @p 2 jeśli nie udało się zaalokować pamięci lub
+ * wartość @p EOF jeśli wejście się skończyło.
+ */
+int nextCommandPipeline(Map *map, CommandPipeline *pipeline);
+
+/** @brief Liczniki uśpień etapów potoku.
+ * Dokładne po @ref nextCommandPipeline zwracającej wartość różną od @p 0.
+ * @param[in] pipeline      - wskaźnik na potok.
+ * @return Liczby uśpień etapów potoku.
+ */
+PipelineStatistics getStatisticsCommandPipeline(CommandPipeline *pipeline);
+
+#endif // COMMAND_PIPELINE_H
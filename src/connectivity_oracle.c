@@ -0,0 +1,402 @@
+/** @file
+ * Implementacja interfejsu klasy przechowującej wyrocznię spójności mapy dróg.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "connectivity_oracle.h"
+#include "road.h"
+
+#include <stdlib.h>
+#include <assert.h>
+
+#define NO_PARENT UINT32_MAX
+///< ojciec korzenia drzewa przeszukiwania
+
+/** @brief Tworzy strukturę.
+ * Tworzy pustą (niezbudowaną) wyrocznię spójności.
+ * @param[in] listOfCities      - wskaźnik na wszystkie miasta na mapie.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci.
+ */
+ConnectivityOracle *newConnectivityOracle(List *listOfCities) {
+    assert(listOfCities);
+
+    ConnectivityOracle *result = calloc(1, sizeof(ConnectivityOracle));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    result->listOfCities = listOfCities;
+    result->isValid = false;
+    result->areBridgesValid = false;
+
+    return result;
+}
+
+/** @brief Zwalnia tablice struktury.
+ * @param[in,out] oracle        - wskaźnik na wyrocznię.
+ */
+void clearConnectivityOracle(ConnectivityOracle *oracle) {
+    free(oracle->parent);
+    free(oracle->size);
+    free(oracle->dfsParent);
+    free(oracle->discovery);
+    free(oracle->low);
+    oracle->parent = NULL;
+    oracle->size = NULL;
+    oracle->dfsParent = NULL;
+    oracle->discovery = NULL;
+    oracle->low = NULL;
+    oracle->citiesCount = 0;
+    oracle->memorySize = 0;
+    oracle->isValid = false;
+    oracle->areBridgesValid = false;
+}
+
+/** @brief Usuwa strukturę.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] oracle            - wskaźnik na usuwaną strukturę.
+ */
+void deleteConnectivityOracle(ConnectivityOracle *oracle) {
+    if (oracle == NULL) {
+        return;
+    }
+
+    clearConnectivityOracle(oracle);
+    free(oracle);
+}
+
+/** @brief Znajduje reprezentanta zbioru miasta.
+ * Skraca po drodze ścieżki (każde miasto wskazuje na dziadka).
+ * @param[in,out] oracle        - wskaźnik na wyrocznię;
+ * @param[in] city              - numer miasta.
+ * @return Numer reprezentanta zbioru.
+ */
+uint32_t findConnectivityOracle(ConnectivityOracle *oracle, uint32_t city) {
+    while (oracle->parent[city] != city) {
+        oracle->parent[city] = oracle->parent[oracle->parent[city]];
+        city = oracle->parent[city];
+    }
+
+    return city;
+}
+
+/** @brief Łączy zbiory dwóch miast.
+ * Mniejszy zbiór podłączany jest do większego.
+ * @param[in,out] oracle        - wskaźnik na wyrocznię;
+ * @param[in] city1             - numer pierwszego miasta;
+ * @param[in] city2             - numer drugiego miasta.
+ */
+void unionConnectivityOracle(ConnectivityOracle *oracle, uint32_t city1,
+                             uint32_t city2) {
+    city1 = findConnectivityOracle(oracle, city1);
+    city2 = findConnectivityOracle(oracle, city2);
+    if (city1 == city2) {
+        return;
+    }
+
+    if (oracle->size[city1] < oracle->size[city2]) {
+        uint32_t tmp = city1;
+        city1 = city2;
+        city2 = tmp;
+    }
+
+    oracle->parent[city2] = city1;
+    oracle->size[city1] += oracle->size[city2];
+}
+
+/** @brief Dopisuje nowe miasta do struktury.
+ * Miasta o numerach od @p citiesCount struktury do @p citiesCount - 1 stają
+ * się jednoelementowymi zbiorami. Tablice powiększane są geometrycznie,
+ * a tablice mostów, które i tak są już nieaktualne, zwalniane.
+ * @param[in,out] oracle        - wskaźnik na zbudowaną wyrocznię;
+ * @param[in] citiesCount       - liczba miast na mapie.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci (struktura pozostaje wtedy bez zmian).
+ */
+bool growConnectivityOracle(ConnectivityOracle *oracle,
+                            uint32_t citiesCount) {
+    if (citiesCount <= oracle->citiesCount) {
+        return true;
+    }
+
+    if (citiesCount > oracle->memorySize) {
+        uint32_t memorySize = oracle->memorySize * 2;
+        if (memorySize < citiesCount) {
+            memorySize = citiesCount;
+        }
+
+        uint32_t *parent = realloc(oracle->parent,
+                                   sizeof(uint32_t) * memorySize);
+        if (parent == NULL) {
+            return false;
+        }
+        oracle->parent = parent;
+
+        uint32_t *size = realloc(oracle->size, sizeof(uint32_t) * memorySize);
+        if (size == NULL) {
+            return false;
+        }
+        oracle->size = size;
+        oracle->memorySize = memorySize;
+
+        free(oracle->dfsParent);
+        free(oracle->discovery);
+        free(oracle->low);
+        oracle->dfsParent = NULL;
+        oracle->discovery = NULL;
+        oracle->low = NULL;
+    }
+
+    for (uint32_t id = oracle->citiesCount; id < citiesCount; id++) {
+        oracle->parent[id] = id;
+        oracle->size[id] = 1;
+    }
+    oracle->citiesCount = citiesCount;
+
+    return true;
+}
+
+/** @brief Odnotowuje dodanie odcinka drogi.
+ * Łączy składowe końców odcinka. Miasta dodane po zbudowaniu struktury są
+ * najpierw do niej dopisywane, bez przebudowy.
+ * @param[in,out] oracle        - wskaźnik na wyrocznię;
+ * @param[in] city1             - wskaźnik na pierwsze miasto odcinka;
+ * @param[in] city2             - wskaźnik na drugie miasto odcinka.
+ */
+void addedRoadConnectivityOracle(ConnectivityOracle *oracle, City *city1,
+                                 City *city2) {
+    assert(oracle);
+    assert(city1);
+    assert(city2);
+
+    /* Nowy odcinek może sprawić, że mosty przestaną nimi być. */
+    oracle->areBridgesValid = false;
+    if (!oracle->isValid) {
+        return;
+    }
+
+    if (!growConnectivityOracle(oracle,
+                                countCitiesOnList(oracle->listOfCities))) {
+        oracle->isValid = false;
+        return;
+    }
+
+    unionConnectivityOracle(oracle, city1->id, city2->id);
+}
+
+/** @brief Odnotowuje usunięcie odcinka drogi.
+ * Struktura zostanie przebudowana przy najbliższym zapytaniu.
+ * @param[in,out] oracle        - wskaźnik na wyrocznię.
+ */
+void removedRoadConnectivityOracle(ConnectivityOracle *oracle) {
+    assert(oracle);
+
+    oracle->isValid = false;
+    oracle->areBridgesValid = false;
+}
+
+/** @brief Przeszukuje w głąb składową miasta.
+ * Wyznacza czasy odwiedzenia, najmniejsze czasy osiągalne z poddrzew
+ * i ojców w drzewie przeszukiwania. Wszystkie miasta składowej podłącza
+ * w strukturze zbiorów rozłącznych do miasta @p root.
+ * @param[in,out] oracle        - wskaźnik na wyrocznię;
+ * @param[in] root              - wskaźnik na nieodwiedzone miasto;
+ * @param[in,out] time          - wskaźnik na licznik czasu;
+ * @param[in,out] stack         - wskaźnik na tablicę na stos miast;
+ * @param[in,out] nextRoad      - wskaźnik na tablicę kolejnych odcinków do
+ *                                przejrzenia dla każdego miasta.
+ */
+void depthFirstSearchConnectivityOracle(ConnectivityOracle *oracle,
+                                        City *root, uint32_t *time,
+                                        City **stack,
+                                        ListIterator **nextRoad) {
+    uint32_t stackSize = 0;
+
+    oracle->discovery[root->id] = oracle->low[root->id] = ++*time;
+    oracle->dfsParent[root->id] = NO_PARENT;
+    nextRoad[root->id] = root->roads->begin;
+    stack[stackSize++] = root;
+
+    while (stackSize != 0) {
+        City *city = stack[stackSize - 1];
+        uint32_t id = city->id;
+
+        if (nextRoad[id] == city->roads->end) {
+            /* Wszystkie odcinki miasta zostały przejrzane. */
+            stackSize--;
+            uint32_t parent = oracle->dfsParent[id];
+            if (parent != NO_PARENT && oracle->low[id] < oracle->low[parent]) {
+                oracle->low[parent] = oracle->low[id];
+            }
+            continue;
+        }
+
+        City *destination = ((Road *)nextRoad[id]->data)->destination;
+        nextRoad[id] = nextRoad[id]->next;
+
+        /* Między dwoma miastami jest co najwyżej jeden odcinek, więc odcinek
+         * do ojca jest krawędzią drzewa. */
+        if (destination->id == oracle->dfsParent[id]) {
+            continue;
+        }
+
+        if (oracle->discovery[destination->id] == 0) {
+            oracle->discovery[destination->id] = ++*time;
+            oracle->low[destination->id] = *time;
+            oracle->dfsParent[destination->id] = id;
+            oracle->parent[destination->id] = root->id;
+            oracle->size[root->id]++;
+            nextRoad[destination->id] = destination->roads->begin;
+            stack[stackSize++] = destination;
+        } else if (oracle->discovery[destination->id] < oracle->low[id]) {
+            oracle->low[id] = oracle->discovery[destination->id];
+        }
+    }
+}
+
+/** @brief Buduje strukturę.
+ * Wyznacza składowe i mosty całej mapy.
+ * @param[in,out] oracle        - wskaźnik na wyrocznię.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci (struktura jest wtedy nieaktualna).
+ */
+bool buildConnectivityOracle(ConnectivityOracle *oracle) {
+    clearConnectivityOracle(oracle);
+
+    uint32_t citiesCount = countCitiesOnList(oracle->listOfCities);
+    oracle->parent = malloc(sizeof(uint32_t) * (citiesCount + 1));
+    oracle->size = malloc(sizeof(uint32_t) * (citiesCount + 1));
+    oracle->dfsParent = malloc(sizeof(uint32_t) * (citiesCount + 1));
+    oracle->discovery = calloc(citiesCount + 1, sizeof(uint32_t));
+    oracle->low = malloc(sizeof(uint32_t) * (citiesCount + 1));
+    City **stack = malloc(sizeof(City *) * (citiesCount + 1));
+    ListIterator **nextRoad = malloc(sizeof(ListIterator *) *
+                                     (citiesCount + 1));
+
+    if (oracle->parent == NULL || oracle->size == NULL ||
+            oracle->dfsParent == NULL || oracle->discovery == NULL ||
+            oracle->low == NULL || stack == NULL || nextRoad == NULL) {
+        clearConnectivityOracle(oracle);
+        free(stack);
+        free(nextRoad);
+        return false;
+    }
+
+    uint32_t time = 0;
+    ListIterator *iterator = oracle->listOfCities->begin;
+    while (iterator != oracle->listOfCities->end) {
+        City *city = iterator->data;
+        if (oracle->discovery[city->id] == 0) {
+            oracle->parent[city->id] = city->id;
+            oracle->size[city->id] = 1;
+            depthFirstSearchConnectivityOracle(oracle, city, &time, stack,
+                                               nextRoad);
+        }
+        iterator = iterator->next;
+    }
+
+    free(stack);
+    free(nextRoad);
+
+    oracle->citiesCount = citiesCount;
+    oracle->memorySize = citiesCount + 1;
+    oracle->isValid = true;
+    oracle->areBridgesValid = true;
+    oracle->buildsCount++;
+
+    return true;
+}
+
+/** @brief Sprawdza czy miasta mogą być połączone.
+ * W razie potrzeby przebudowuje strukturę.
+ * @param[in,out] oracle        - wskaźnik na wyrocznię;
+ * @param[in] city1             - wskaźnik na pierwsze miasto;
+ * @param[in] city2             - wskaźnik na drugie miasto.
+ * @return Wartość @p false, jeśli miasta leżą w różnych składowych mapy.
+ * Wartość @p true, jeśli leżą w tej samej składowej lub nie udało się
+ * zaalokować pamięci na przebudowę.
+ */
+bool areConnectedConnectivityOracle(ConnectivityOracle *oracle, City *city1,
+                                    City *city2) {
+    assert(oracle);
+    assert(city1);
+    assert(city2);
+
+    if (!oracle->isValid && !buildConnectivityOracle(oracle)) {
+        return true;
+    }
+
+    /* Miasto mogło zostać dodane bez odcinka drogi. */
+    if (!growConnectivityOracle(oracle,
+                                countCitiesOnList(oracle->listOfCities))) {
+        oracle->isValid = false;
+        return true;
+    }
+
+    oracle->queriesCount++;
+    if (findConnectivityOracle(oracle, city1->id) !=
+            findConnectivityOracle(oracle, city2->id)) {
+        oracle->hitsCount++;
+        return false;
+    }
+
+    return true;
+}
+
+/** @brief Sprawdza czy odcinek drogi jest mostem.
+ * W razie potrzeby przebudowuje strukturę. Odcinek drogi między miastami
+ * musi istnieć.
+ * @param[in,out] oracle        - wskaźnik na wyrocznię;
+ * @param[in] city1             - wskaźnik na pierwsze miasto odcinka;
+ * @param[in] city2             - wskaźnik na drugie miasto odcinka.
+ * @return Wartość @p true, jeśli po usunięciu odcinka miasta nie byłyby
+ * połączone. Wartość @p false w przeciwnym przypadku lub jeśli nie udało się
+ * zaalokować pamięci na przebudowę.
+ */
+bool isBridgeConnectivityOracle(ConnectivityOracle *oracle, City *city1,
+                                City *city2) {
+    assert(oracle);
+    assert(city1);
+    assert(city2);
+
+    if ((!oracle->isValid || !oracle->areBridgesValid) &&
+            !buildConnectivityOracle(oracle)) {
+        return false;
+    }
+
+    /* Mostem może być tylko krawędź drzewa przeszukiwania. Jest nim, jeśli
+     * z poddrzewa syna nie da się wrócić nad ojca. */
+    if (oracle->dfsParent[city1->id] == city2->id) {
+        City *tmp = city1;
+        city1 = city2;
+        city2 = tmp;
+    }
+
+    oracle->queriesCount++;
+    if (oracle->dfsParent[city2->id] == city1->id &&
+            oracle->low[city2->id] > oracle->discovery[city1->id]) {
+        oracle->hitsCount++;
+        return true;
+    }
+
+    return false;
+}
+
+/** @brief Pamięć zajmowana przez strukturę.
+ * @param[in] oracle            - wskaźnik na strukturę.
+ * @return Liczba bajtów struktury i jej tablic.
+ */
+size_t memoryUsageConnectivityOracle(const ConnectivityOracle *oracle) {
+    assert(oracle);
+
+    size_t result = sizeof(ConnectivityOracle) +
+                    2 * sizeof(uint32_t) * (size_t)oracle->memorySize;
+    if (oracle->dfsParent != NULL) {
+        result += 3 * sizeof(uint32_t) * (size_t)oracle->memorySize;
+    }
+
+    return result;
+}
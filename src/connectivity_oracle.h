@@ -0,0 +1,103 @@
+/** @file
+ * Interfejs klasy przechowującej wyrocznię spójności mapy dróg.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef CONNECTIVITY_ORACLE_H
+#define CONNECTIVITY_ORACLE_H
+
+#include "city.h"
+#include "list.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Struktura przechowująca spójne składowe mapy dróg (struktura zbiorów
+ * rozłącznych) oraz mosty, czyli odcinki dróg, których usunięcie rozspójnia
+ * ich końce. Dodanie odcinka drogi łączy składowe bez przebudowy (nowe
+ * miasta dopisywane są jako jednoelementowe zbiory), ale unieważnia mosty.
+ * Usunięcie odcinka unieważnia całą strukturę, która jest wtedy
+ * przebudowywana przy najbliższym zapytaniu.
+ */
+typedef struct ConnectivityOracle {
+    List *listOfCities;             ///< wskaźnik na wszystkie miasta na mapie
+    uint32_t citiesCount;           ///< liczba miast w zbudowanej strukturze
+    uint32_t memorySize;            ///< rozmiar tablic struktury
+    uint32_t *parent;               ///< ojcowie w strukturze zbiorów rozłącznych
+    uint32_t *size;                 ///< rozmiary zbiorów (dla korzeni)
+    uint32_t *dfsParent;            ///< ojcowie w drzewie przeszukiwania
+                                    ///< (NULL po dopisaniu nowych miast)
+    uint32_t *discovery;            ///< czasy odwiedzenia miast
+    uint32_t *low;                  ///< najmniejsze czasy osiągalne z poddrzew
+    bool isValid;                   ///< czy składowe są aktualne
+    bool areBridgesValid;           ///< czy mosty są aktualne
+    uint64_t buildsCount;           ///< liczba przebudowań struktury
+    uint64_t queriesCount;          ///< liczba zapytań
+    uint64_t hitsCount;             ///< liczba zapytań z odpowiedzią negatywną
+} ConnectivityOracle;
+
+/** @brief Tworzy strukturę.
+ * Tworzy pustą (niezbudowaną) wyrocznię spójności.
+ * @param[in] listOfCities      - wskaźnik na wszystkie miasta na mapie.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci.
+ */
+ConnectivityOracle *newConnectivityOracle(List *listOfCities);
+
+/** @brief Usuwa strukturę.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] oracle            - wskaźnik na usuwaną strukturę.
+ */
+void deleteConnectivityOracle(ConnectivityOracle *oracle);
+
+/** @brief Odnotowuje dodanie odcinka drogi.
+ * Łączy składowe końców odcinka. Miasta dodane po zbudowaniu struktury są
+ * najpierw do niej dopisywane, bez przebudowy.
+ * @param[in,out] oracle        - wskaźnik na wyrocznię;
+ * @param[in] city1             - wskaźnik na pierwsze miasto odcinka;
+ * @param[in] city2             - wskaźnik na drugie miasto odcinka.
+ */
+void addedRoadConnectivityOracle(ConnectivityOracle *oracle, City *city1,
+                                 City *city2);
+
+/** @brief Odnotowuje usunięcie odcinka drogi.
+ * Struktura zostanie przebudowana przy najbliższym zapytaniu.
+ * @param[in,out] oracle        - wskaźnik na wyrocznię.
+ */
+void removedRoadConnectivityOracle(ConnectivityOracle *oracle);
+
+/** @brief Sprawdza czy miasta mogą być połączone.
+ * W razie potrzeby przebudowuje strukturę.
+ * @param[in,out] oracle        - wskaźnik na wyrocznię;
+ * @param[in] city1             - wskaźnik na pierwsze miasto;
+ * @param[in] city2             - wskaźnik na drugie miasto.
+ * @return Wartość @p false, jeśli miasta leżą w różnych składowych mapy.
+ * Wartość @p true, jeśli leżą w tej samej składowej lub nie udało się
+ * zaalokować pamięci na przebudowę.
+ */
+bool areConnectedConnectivityOracle(ConnectivityOracle *oracle, City *city1,
+                                    City *city2);
+
+/** @brief Sprawdza czy odcinek drogi jest mostem.
+ * W razie potrzeby przebudowuje strukturę. Odcinek drogi między miastami
+ * musi istnieć.
+ * @param[in,out] oracle        - wskaźnik na wyrocznię;
+ * @param[in] city1             - wskaźnik na pierwsze miasto odcinka;
+ * @param[in] city2             - wskaźnik na drugie miasto odcinka.
+ * @return Wartość @p true, jeśli po usunięciu odcinka miasta nie byłyby
+ * połączone. Wartość @p false w przeciwnym przypadku lub jeśli nie udało się
+ * zaalokować pamięci na przebudowę.
+ */
+bool isBridgeConnectivityOracle(ConnectivityOracle *oracle, City *city1,
+                                City *city2);
+
+/** @brief Pamięć zajmowana przez strukturę.
+ * @param[in] oracle            - wskaźnik na strukturę.
+ * @return Liczba bajtów struktury i jej tablic.
+ */
+size_t memoryUsageConnectivityOracle(const ConnectivityOracle *oracle);
+
+#endif // CONNECTIVITY_ORACLE_H
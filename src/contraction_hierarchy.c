@@ -0,0 +1,1023 @@
+/** @file
+ * Implementacja interfejsu klasy przechowującej hierarchię kontrakcji.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "contraction_hierarchy.h"
+#include "heap.h"
+#include "road.h"
+#include "route.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define MAX_PATHS_COUNT 2
+///< liczby najkrótszych dróg większe od tej stałej nie są rozróżniane
+
+#define WITNESS_SETTLED_LIMIT 100
+///< maksymalna liczba miast obsłużonych w jednym szukaniu drogi świadka
+
+#define PRIORITY_SETTLED_LIMIT 25
+///< maksymalna liczba miast obsłużonych w szukaniu drogi świadka przy
+///  wyznaczaniu priorytetu kontrakcji
+
+#define LOW_WITNESS 0
+///< indeks szukania dróg świadków dla najmniejszego progu skrótów
+
+#define HIGH_WITNESS 1
+///< indeks szukania dróg świadków dla największego progu skrótów
+
+#define WITNESS_SEARCHES_COUNT 2
+///< liczba szukań dróg świadków z jednego sąsiada kontraktowanego miasta
+
+/**
+ * Struktura przechowująca tablice używane przez szukanie dróg świadków.
+ */
+typedef struct WitnessSearch {
+    int64_t *distance;              ///< odległości od miasta startowego
+    uint32_t *touched;              ///< miasta o skończonej odległości
+    uint32_t touchedCount;          ///< liczba miast w @ref touched
+    bool *isTarget;                 ///< czy miasto jest celem szukania
+    Heap *heap;                     ///< sterta algorytmu dijkstry
+    int64_t year;                   ///< próg roku ostatniego szukania
+} WitnessSearch;
+
+/** @brief Ogranicza liczbę najkrótszych dróg.
+ * @param[in] pathsCount        - liczba najkrótszych dróg.
+ * @return Minimum z @p pathsCount oraz @ref MAX_PATHS_COUNT.
+ */
+uint32_t capPathsCount(uint64_t pathsCount) {
+    if (pathsCount > MAX_PATHS_COUNT) {
+        return MAX_PATHS_COUNT;
+    }
+
+    return pathsCount;
+}
+
+/** @brief Tworzy strukturę.
+ * Tworzy pustą (niezbudowaną) hierarchię.
+ * @param[in] listOfCities      - wskaźnik na wszystkie miasta na mapie.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci.
+ */
+ContractionHierarchy *newContractionHierarchy(List *listOfCities) {
+    assert(listOfCities);
+
+    ContractionHierarchy *result = calloc(1, sizeof(ContractionHierarchy));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    result->listOfCities = listOfCities;
+    result->isValid = false;
+
+    return result;
+}
+
+/** @brief Usuwa zbudowaną hierarchię.
+ * Zwalnia wszystkie tablice hierarchii, ale nie samą strukturę.
+ * @param[in,out] hierarchy     - wskaźnik na hierarchię.
+ */
+void clearContractionHierarchy(ContractionHierarchy *hierarchy) {
+    for (uint32_t i = 0; i < hierarchy->functionsCount; i++) {
+        free(hierarchy->functions[i].steps);
+    }
+    free(hierarchy->functions);
+
+    if (hierarchy->upwardArcs != NULL) {
+        for (uint32_t i = 0; i < hierarchy->citiesCount; i++) {
+            free(hierarchy->upwardArcs[i].arcs);
+        }
+    }
+    free(hierarchy->upwardArcs);
+    free(hierarchy->cities);
+    free(hierarchy->rank);
+
+    hierarchy->functions = NULL;
+    hierarchy->functionsCount = 0;
+    hierarchy->reservedFunctions = 0;
+    hierarchy->upwardArcs = NULL;
+    hierarchy->cities = NULL;
+    hierarchy->rank = NULL;
+    hierarchy->citiesCount = 0;
+    hierarchy->shortcutsCount = 0;
+    hierarchy->isValid = false;
+}
+
+/** @brief Usuwa strukturę.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] hierarchy         - wskaźnik na usuwaną strukturę.
+ */
+void deleteContractionHierarchy(ContractionHierarchy *hierarchy) {
+    if (hierarchy == NULL) {
+        return;
+    }
+
+    clearContractionHierarchy(hierarchy);
+    free(hierarchy);
+}
+
+/** @brief Oznacza hierarchię jako nieaktualną.
+ * Należy wywołać po każdej zmianie odcinków dróg.
+ * @param[in,out] hierarchy     - wskaźnik na hierarchię.
+ */
+void invalidateContractionHierarchy(ContractionHierarchy *hierarchy) {
+    assert(hierarchy);
+
+    hierarchy->isValid = false;
+}
+
+/** @brief Uzupełnia najlepszą drogę funkcji krawędzi.
+ * Łączy sąsiednie stopnie o takich samych wartościach i wyznacza
+ * @ref HierarchyFunction.bestDistance oraz @ref HierarchyFunction.bestYear.
+ * @param[in,out] function      - wskaźnik na niepustą funkcję krawędzi.
+ */
+void normalizeFunctionHierarchy(HierarchyFunction *function) {
+    assert(function->stepsCount > 0);
+
+    HierarchyStep *steps = function->steps;
+    uint32_t size = 1;
+    for (uint32_t i = 1; i < function->stepsCount; i++) {
+        HierarchyStep *last = &steps[size - 1];
+        if (last->distance == steps[i].distance &&
+                last->pathsCount == steps[i].pathsCount &&
+                last->middle == steps[i].middle) {
+            last->year = steps[i].year;
+        } else {
+            steps[size++] = steps[i];
+        }
+    }
+    function->stepsCount = size;
+
+    function->bestDistance = steps[0].distance;
+    function->bestYear = steps[0].year;
+    for (uint32_t i = 1; i < size && steps[i].distance == steps[0].distance;
+            i++) {
+        function->bestYear = steps[i].year;
+    }
+}
+
+/** @brief Składa funkcje dwóch krawędzi przechodzących przez miasto.
+ * @param[in] first             - wskaźnik na funkcję pierwszej krawędzi;
+ * @param[in] second            - wskaźnik na funkcję drugiej krawędzi;
+ * @param[in] middle            - numer wspólnego miasta krawędzi;
+ * @param[out] result           - wskaźnik na wynikową funkcję.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool composeFunctionsHierarchy(const HierarchyFunction *first,
+                               const HierarchyFunction *second,
+                               uint32_t middle, HierarchyFunction *result) {
+    result->steps = malloc(sizeof(HierarchyStep) *
+                           (first->stepsCount + second->stepsCount));
+    if (result->steps == NULL) {
+        return false;
+    }
+
+    uint32_t i = 0, j = 0, size = 0;
+    while (i < first->stepsCount && j < second->stepsCount) {
+        const HierarchyStep *a = &first->steps[i];
+        const HierarchyStep *b = &second->steps[j];
+        int64_t year = a->year < b->year ? a->year : b->year;
+
+        result->steps[size].year = year;
+        result->steps[size].distance = a->distance + b->distance;
+        result->steps[size].pathsCount =
+                capPathsCount((uint64_t)a->pathsCount * b->pathsCount);
+        result->steps[size].middle = middle;
+        size++;
+
+        if (a->year == year) {
+            i++;
+        }
+        if (b->year == year) {
+            j++;
+        }
+    }
+
+    result->stepsCount = size;
+    normalizeFunctionHierarchy(result);
+
+    return true;
+}
+
+/** @brief Zastępuje funkcję krawędzi minimum z nią i inną funkcją.
+ * Dla każdego progu wybiera krótsze drogi, a przy równych długościach
+ * sumuje liczby najkrótszych dróg.
+ * @param[in,out] function      - wskaźnik na funkcję krawędzi;
+ * @param[in] other             - wskaźnik na drugą funkcję.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci (funkcja pozostaje wtedy bez zmian).
+ */
+bool mergeFunctionsHierarchy(HierarchyFunction *function,
+                             const HierarchyFunction *other) {
+    HierarchyStep *steps = malloc(sizeof(HierarchyStep) *
+                                  (function->stepsCount + other->stepsCount));
+    if (steps == NULL) {
+        return false;
+    }
+
+    uint32_t i = 0, j = 0, size = 0;
+    while (i < function->stepsCount || j < other->stepsCount) {
+        const HierarchyStep *a = NULL, *b = NULL;
+        if (i < function->stepsCount) {
+            a = &function->steps[i];
+        }
+        if (j < other->stepsCount) {
+            b = &other->steps[j];
+        }
+
+        HierarchyStep step;
+        if (b == NULL || (a != NULL && a->year < b->year)) {
+            step = *a;
+        } else if (a == NULL || b->year < a->year) {
+            step = *b;
+        } else {
+            step = *a;
+        }
+
+        if (a != NULL && b != NULL) {
+            if (b->distance < a->distance) {
+                step = *b;
+            } else if (a->distance < b->distance) {
+                step = *a;
+            } else {
+                step = *a;
+                step.pathsCount = capPathsCount((uint64_t)a->pathsCount +
+                                                b->pathsCount);
+            }
+            step.year = a->year < b->year ? a->year : b->year;
+        }
+        steps[size++] = step;
+
+        if (a != NULL && a->year == step.year) {
+            i++;
+        }
+        if (b != NULL && b->year == step.year) {
+            j++;
+        }
+    }
+
+    free(function->steps);
+    function->steps = steps;
+    function->stepsCount = size;
+    normalizeFunctionHierarchy(function);
+
+    return true;
+}
+
+/** @brief Szuka miejsca krawędzi na liście krawędzi miasta.
+ * Krawędzie miasta są posortowane rosnąco po numerze drugiego końca.
+ * @param[in] arcs              - wskaźnik na krawędzie miasta;
+ * @param[in] target            - numer drugiego końca krawędzi.
+ * @return Indeks pierwszej krawędzi, której drugi koniec ma numer nie
+ * mniejszy niż @p target, lub @p arcs->size, jeśli takiej nie ma.
+ */
+uint32_t lowerBoundArcHierarchy(const HierarchyArcs *arcs, uint32_t target) {
+    uint32_t begin = 0, end = arcs->size;
+    while (begin < end) {
+        uint32_t middle = (begin + end) / 2;
+        if (arcs->arcs[middle].target < target) {
+            begin = middle + 1;
+        } else {
+            end = middle;
+        }
+    }
+
+    return begin;
+}
+
+/** @brief Znajduje krawędź na liście krawędzi miasta.
+ * @param[in] arcs              - wskaźnik na krawędzie miasta;
+ * @param[in] target            - numer drugiego końca krawędzi.
+ * @return Indeks krawędzi na liście lub @p arcs->size, jeśli jej nie ma.
+ */
+uint32_t findArcHierarchy(const HierarchyArcs *arcs, uint32_t target) {
+    uint32_t index = lowerBoundArcHierarchy(arcs, target);
+    if (index != arcs->size && arcs->arcs[index].target != target) {
+        return arcs->size;
+    }
+
+    return index;
+}
+
+/** @brief Dodaje krawędź do listy krawędzi miasta.
+ * Zachowuje posortowanie listy po numerze drugiego końca krawędzi.
+ * @param[in,out] arcs          - wskaźnik na krawędzie miasta;
+ * @param[in] target            - numer drugiego końca krawędzi;
+ * @param[in] function          - numer funkcji krawędzi.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool pushArcHierarchy(HierarchyArcs *arcs, uint32_t target,
+                      uint32_t function) {
+    if (arcs->size == arcs->reservedMemory) {
+        uint32_t newMemory = arcs->reservedMemory * 2 + 4;
+        HierarchyArc *ptr = realloc(arcs->arcs,
+                                    sizeof(HierarchyArc) * newMemory);
+        if (ptr == NULL) {
+            return false;
+        }
+
+        arcs->arcs = ptr;
+        arcs->reservedMemory = newMemory;
+    }
+
+    uint32_t index = lowerBoundArcHierarchy(arcs, target);
+    memmove(&arcs->arcs[index + 1], &arcs->arcs[index],
+            sizeof(HierarchyArc) * (arcs->size - index));
+    arcs->arcs[index].target = target;
+    arcs->arcs[index].function = function;
+    arcs->size++;
+
+    return true;
+}
+
+/** @brief Usuwa krawędź z listy krawędzi miasta.
+ * @param[in,out] arcs          - wskaźnik na krawędzie miasta;
+ * @param[in] target            - numer drugiego końca usuwanej krawędzi.
+ */
+void removeArcHierarchy(HierarchyArcs *arcs, uint32_t target) {
+    uint32_t index = findArcHierarchy(arcs, target);
+    assert(index != arcs->size);
+
+    arcs->size--;
+    memmove(&arcs->arcs[index], &arcs->arcs[index + 1],
+            sizeof(HierarchyArc) * (arcs->size - index));
+}
+
+/** @brief Dodaje funkcję krawędzi do hierarchii.
+ * Łączy miasta @p city1 i @p city2 nową krawędzią lub, jeśli już są
+ * połączone, bierze minimum z funkcją istniejącej krawędzi.
+ * @param[in,out] hierarchy     - wskaźnik na hierarchię;
+ * @param[in] city1             - numer pierwszego miasta;
+ * @param[in] city2             - numer drugiego miasta;
+ * @param[in,out] function      - wskaźnik na dodawaną funkcję; jej tablica
+ *                                stopni przechodzi na własność hierarchii lub
+ *                                jest zwalniana.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool addFunctionHierarchy(ContractionHierarchy *hierarchy, uint32_t city1,
+                          uint32_t city2, HierarchyFunction *function) {
+    HierarchyArcs *arcs = &hierarchy->upwardArcs[city1];
+    uint32_t index = findArcHierarchy(arcs, city2);
+    if (index != arcs->size) {
+        bool result = mergeFunctionsHierarchy(
+                &hierarchy->functions[arcs->arcs[index].function], function);
+        free(function->steps);
+        return result;
+    }
+
+    if (hierarchy->functionsCount == hierarchy->reservedFunctions) {
+        uint32_t newMemory = hierarchy->reservedFunctions * 2 + 16;
+        HierarchyFunction *ptr = realloc(hierarchy->functions,
+                                         sizeof(HierarchyFunction) * newMemory);
+        if (ptr == NULL) {
+            free(function->steps);
+            return false;
+        }
+
+        hierarchy->functions = ptr;
+        hierarchy->reservedFunctions = newMemory;
+    }
+
+    uint32_t functionIndex = hierarchy->functionsCount++;
+    hierarchy->functions[functionIndex] = *function;
+
+    return pushArcHierarchy(&hierarchy->upwardArcs[city1], city2,
+                            functionIndex) &&
+           pushArcHierarchy(&hierarchy->upwardArcs[city2], city1,
+                            functionIndex);
+}
+
+/** @brief Przygotowuje tablice szukania dróg świadków.
+ * Po błędzie tablice należy zwolnić funkcją @ref clearWitnessSearchHierarchy.
+ * @param[out] witness          - wskaźnik na tablice szukania;
+ * @param[in] citiesCount       - liczba miast w hierarchii.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool prepareWitnessSearchHierarchy(WitnessSearch *witness,
+                                   uint32_t citiesCount) {
+    witness->distance = malloc(sizeof(int64_t) * (citiesCount + 1));
+    witness->touched = malloc(sizeof(uint32_t) * (citiesCount + 1));
+    witness->touchedCount = 0;
+    witness->isTarget = calloc(citiesCount + 1, sizeof(bool));
+    witness->heap = newHeap();
+    witness->year = INT64_MIN;
+
+    if (witness->distance == NULL || witness->touched == NULL ||
+            witness->isTarget == NULL || witness->heap == NULL) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i <= citiesCount; i++) {
+        witness->distance[i] = INFINITY;
+    }
+
+    return true;
+}
+
+/** @brief Zwalnia tablice szukania dróg świadków.
+ * @param[in,out] witness       - wskaźnik na tablice szukania.
+ */
+void clearWitnessSearchHierarchy(WitnessSearch *witness) {
+    if (witness->heap != NULL) {
+        deleteHeap(witness->heap);
+    }
+    free(witness->distance);
+    free(witness->touched);
+    free(witness->isTarget);
+}
+
+/** @brief Szuka dróg świadków omijających kontraktowane miasto.
+ * Ograniczonym algorytmem dijkstry liczy odległości od miasta @p from do
+ * pozostałych miast, biorąc pod uwagę tylko krawędzie z drogami złożonymi
+ * z odcinków nie starszych niż @p year i omijając miasto @p avoided.
+ * Szukanie kończy się po obsłużeniu wszystkich miast docelowych.
+ * Znalezione odległości są długościami prawdziwych dróg, ale mogą być
+ * większe od najkrótszych.
+ * @param[in] hierarchy         - wskaźnik na budowaną hierarchię;
+ * @param[in,out] witness       - wskaźnik na tablice szukania;
+ * @param[in] from              - numer miasta startowego;
+ * @param[in] avoided           - numer omijanego miasta;
+ * @param[in] targets           - krawędzie do miast docelowych;
+ * @param[in] targetsCount      - liczba miast docelowych;
+ * @param[in] year              - próg roku;
+ * @param[in] bound             - odległość, powyżej której nie szukamy;
+ * @param[in] settledLimit      - maksymalna liczba obsłużonych miast.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool witnessSearchHierarchy(ContractionHierarchy *hierarchy,
+                            WitnessSearch *witness, uint32_t from,
+                            uint32_t avoided, const HierarchyArc *targets,
+                            uint32_t targetsCount, int64_t year,
+                            int64_t bound, uint32_t settledLimit) {
+    int64_t *distance = witness->distance;
+    witness->year = year;
+
+    /* Czyścimy odległości z poprzedniego szukania. */
+    for (uint32_t i = 0; i < witness->touchedCount; i++) {
+        distance[witness->touched[i]] = INFINITY;
+    }
+    witness->touchedCount = 0;
+    while (witness->heap->size != 0) {
+        popHeap(witness->heap);
+    }
+
+    for (uint32_t i = 0; i < targetsCount; i++) {
+        witness->isTarget[targets[i].target] = true;
+    }
+
+    distance[from] = 0;
+    witness->touched[witness->touchedCount++] = from;
+    bool result = pushHeap(witness->heap, 0, 0, hierarchy->cities[from]);
+
+    uint32_t settledCount = 0, remainingCount = targetsCount;
+    while (result && witness->heap->size != 0 && remainingCount != 0 &&
+            settledCount < settledLimit) {
+        City *ptr = witness->heap->data[1];
+        int64_t key = witness->heap->keys[1]->distance;
+        popHeap(witness->heap);
+
+        if (key != distance[ptr->id]) {
+            continue;
+        }
+        if (key >= bound) {
+            break;
+        }
+        settledCount++;
+        hierarchy->witnessSettledCount++;
+        if (witness->isTarget[ptr->id]) {
+            witness->isTarget[ptr->id] = false;
+            remainingCount--;
+        }
+
+        const HierarchyArcs *arcs = &hierarchy->upwardArcs[ptr->id];
+        for (uint32_t i = 0; result && i < arcs->size; i++) {
+            uint32_t destination = arcs->arcs[i].target;
+            if (destination == avoided) {
+                continue;
+            }
+
+            const HierarchyStep *step = stepAtContractionHierarchy(
+                    &hierarchy->functions[arcs->arcs[i].function], year);
+            if (step == NULL) {
+                continue;
+            }
+
+            int64_t newDistance = key + step->distance;
+            if (newDistance < distance[destination]) {
+                if (distance[destination] == INFINITY) {
+                    witness->touched[witness->touchedCount++] = destination;
+                }
+                distance[destination] = newDistance;
+
+                result = pushHeap(witness->heap, newDistance, 0,
+                                  hierarchy->cities[destination]);
+            }
+        }
+    }
+
+    /* Miasta docelowe mogły pozostać nieobsłużone. */
+    for (uint32_t i = 0; i < targetsCount; i++) {
+        witness->isTarget[targets[i].target] = false;
+    }
+
+    return result;
+}
+
+/** @brief Szuka dróg świadków z sąsiada kontraktowanego miasta.
+ * Szuka naraz świadków dla wszystkich skrótów z sąsiada o indeksie @p index
+ * na liście krawędzi miasta do sąsiadów o większych indeksach: świadek dla
+ * większego progu jest też świadkiem dla mniejszego. Pierwsze szukanie
+ * używa najmniejszego progu, dla którego świadek może zastąpić pierwszy
+ * stopień każdego z tych skrótów, a drugie największego progu tych skrótów.
+ * Jeśli oba progi są równe, pierwsze szukanie jest pomijane (jego próg
+ * ustawiany jest na @p INT64_MIN). Szukania są ograniczone długością
+ * najdłuższego stopnia skrótów, który mogą zastąpić.
+ * @param[in] hierarchy         - wskaźnik na budowaną hierarchię;
+ * @param[in,out] witness       - wskaźnik na tablice obu szukań;
+ * @param[in] city              - numer kontraktowanego miasta;
+ * @param[in] index             - indeks sąsiada na liście krawędzi miasta;
+ * @param[in] settledLimit      - maksymalna liczba miast obsłużonych
+ *                                w jednym szukaniu.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool neighbourWitnessSearchHierarchy(ContractionHierarchy *hierarchy,
+                                     WitnessSearch *witness, uint32_t city,
+                                     uint32_t index, uint32_t settledLimit) {
+    const HierarchyArcs *arcs = &hierarchy->upwardArcs[city];
+    const HierarchyFunction *first =
+            &hierarchy->functions[arcs->arcs[index].function];
+    const HierarchyStep *firstLast = &first->steps[first->stepsCount - 1];
+
+    int64_t lowYear = INT64_MIN;
+    int64_t highYear = INT64_MIN;
+    int64_t highBound = 0;
+    for (uint32_t j = index + 1; j < arcs->size; j++) {
+        const HierarchyFunction *second =
+                &hierarchy->functions[arcs->arcs[j].function];
+        const HierarchyStep *secondLast =
+                &second->steps[second->stepsCount - 1];
+
+        lowYear = maxInt64_t(lowYear, minInt64_t(first->steps[0].year,
+                                                 second->steps[0].year));
+        highYear = maxInt64_t(highYear, minInt64_t(firstLast->year,
+                                                   secondLast->year));
+        highBound = maxInt64_t(highBound, firstLast->distance +
+                                          secondLast->distance);
+    }
+
+    /* Stopnie skrótów z progami nie większymi od lowYear są nie dłuższe niż
+     * skróty dla progu lowYear (lub dla ostatniego progu skrótu). */
+    int64_t lowBound = 0;
+    for (uint32_t j = index + 1; j < arcs->size; j++) {
+        const HierarchyFunction *second =
+                &hierarchy->functions[arcs->arcs[j].function];
+        int64_t year = minInt64_t(lowYear, minInt64_t(
+                firstLast->year, second->steps[second->stepsCount - 1].year));
+
+        lowBound = maxInt64_t(lowBound,
+                stepAtContractionHierarchy(first, year)->distance +
+                stepAtContractionHierarchy(second, year)->distance);
+    }
+
+    uint32_t from = arcs->arcs[index].target;
+    const HierarchyArc *targets = &arcs->arcs[index + 1];
+    uint32_t targetsCount = arcs->size - index - 1;
+    if (lowYear == highYear) {
+        witness[LOW_WITNESS].year = INT64_MIN;
+    } else if (!witnessSearchHierarchy(hierarchy, &witness[LOW_WITNESS],
+                                       from, city, targets, targetsCount,
+                                       lowYear, lowBound, settledLimit)) {
+        return false;
+    }
+
+    return witnessSearchHierarchy(hierarchy, &witness[HIGH_WITNESS], from,
+                                  city, targets, targetsCount, highYear,
+                                  highBound, settledLimit);
+}
+
+/** @brief Sprawdza, czy droga świadek jest krótsza od drogi przez miasto.
+ * @param[in] witness           - wskaźnik na tablice szukań dróg świadków;
+ * @param[in] target            - numer drugiego końca skrótu;
+ * @param[in] year              - największy próg drogi przez miasto;
+ * @param[in] distance          - długość drogi przez miasto.
+ * @return Wartość @p true, jeśli jedno z szukań znalazło drogę świadka
+ * dobrą dla wszystkich progów nie większych od @p year i krótszą niż
+ * @p distance, a @p false w przeciwnym przypadku.
+ */
+bool isDominatedHierarchy(const WitnessSearch *witness, uint32_t target,
+                          int64_t year, int64_t distance) {
+    for (uint32_t i = 0; i < WITNESS_SEARCHES_COUNT; i++) {
+        if (year <= witness[i].year &&
+                witness[i].distance[target] < distance) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/** @brief Liczy skróty potrzebne do kontrakcji miasta.
+ * Nie zmienia krawędzi hierarchii. Skrót uznawany jest za zbędny, jeśli
+ * jedna droga świadek jest krótsza od każdego jego stopnia. Wynik jest
+ * tylko oszacowaniem: drogi świadków są szukane z mniejszym limitem
+ * obsłużonych miast niż przy kontrakcji.
+ * @param[in] hierarchy         - wskaźnik na hierarchię;
+ * @param[in,out] witness       - wskaźnik na tablice szukań dróg świadków;
+ * @param[in] city              - numer miasta;
+ * @param[out] shortcutsCount   - wskaźnik na liczbę skrótów.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool countShortcutsHierarchy(ContractionHierarchy *hierarchy,
+                             WitnessSearch *witness, uint32_t city,
+                             int64_t *shortcutsCount) {
+    const HierarchyArcs *arcs = &hierarchy->upwardArcs[city];
+
+    *shortcutsCount = 0;
+    for (uint32_t i = 0; i + 1 < arcs->size; i++) {
+        if (!neighbourWitnessSearchHierarchy(hierarchy, witness, city, i,
+                                             PRIORITY_SETTLED_LIMIT)) {
+            return false;
+        }
+
+        /* Skrót jest najkrótszy dla najmniejszego progu, a jego największy
+         * próg jest mniejszym z największych progów obu krawędzi. */
+        const HierarchyFunction *first =
+                &hierarchy->functions[arcs->arcs[i].function];
+        for (uint32_t j = i + 1; j < arcs->size; j++) {
+            const HierarchyFunction *second =
+                    &hierarchy->functions[arcs->arcs[j].function];
+            int64_t year = minInt64_t(
+                    first->steps[first->stepsCount - 1].year,
+                    second->steps[second->stepsCount - 1].year);
+            int64_t distance = first->steps[0].distance +
+                               second->steps[0].distance;
+
+            if (!isDominatedHierarchy(witness, arcs->arcs[j].target, year,
+                                      distance)) {
+                (*shortcutsCount)++;
+            }
+        }
+    }
+
+    return true;
+}
+
+/** @brief Usuwa stopnie skrótu zdominowane przez drogi świadków.
+ * Stopień jest zdominowany, jeśli droga świadek dobra dla wszystkich progów
+ * stopnia jest od niego krótsza; dla tych progów żadna najkrótsza droga nie
+ * przechodzi przez skrót. Po usunięciu stopnia jego progi obsługuje
+ * następny stopień, który opisuje prawdziwe, ale dłuższe drogi.
+ * @param[in,out] shortcut      - wskaźnik na funkcję skrótu;
+ * @param[in] witness           - wskaźnik na tablice szukań dróg świadków;
+ * @param[in] target            - numer drugiego końca skrótu.
+ * @return Wartość @p true lub @p false, jeśli zdominowane są wszystkie
+ * stopnie (tablica stopni jest wtedy zwalniana).
+ */
+bool pruneFunctionHierarchy(HierarchyFunction *shortcut,
+                            const WitnessSearch *witness, uint32_t target) {
+    uint32_t size = 0;
+    for (uint32_t i = 0; i < shortcut->stepsCount; i++) {
+        const HierarchyStep *step = &shortcut->steps[i];
+        if (!isDominatedHierarchy(witness, target, step->year,
+                                  step->distance)) {
+            shortcut->steps[size++] = *step;
+        }
+    }
+    shortcut->stepsCount = size;
+
+    if (size == 0) {
+        free(shortcut->steps);
+        return false;
+    }
+
+    normalizeFunctionHierarchy(shortcut);
+
+    return true;
+}
+
+/** @brief Kontraktuje miasto.
+ * Dla każdej pary sąsiadów miasta dodaje skrót przez to miasto i usuwa
+ * krawędzie do miasta z list sąsiadów. Krawędzie miasta stają się jego
+ * krawędziami do ważniejszych miast. Ze skrótu usuwane są stopnie, dla
+ * których droga świadek omijająca miasto jest krótsza, a skrót bez stopni
+ * jest pomijany; żadna najkrótsza droga nie przechodzi przez usunięte
+ * stopnie, więc wyniki wyszukiwań (również liczby najkrótszych dróg)
+ * pozostają dokładne.
+ * @param[in,out] hierarchy     - wskaźnik na hierarchię;
+ * @param[in,out] witness       - wskaźnik na tablice szukań dróg świadków;
+ * @param[in] city              - numer kontraktowanego miasta.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool contractCityHierarchy(ContractionHierarchy *hierarchy,
+                           WitnessSearch *witness, uint32_t city) {
+    HierarchyArcs *arcs = &hierarchy->upwardArcs[city];
+
+    for (uint32_t i = 0; i + 1 < arcs->size; i++) {
+        if (!neighbourWitnessSearchHierarchy(hierarchy, witness, city, i,
+                                             WITNESS_SETTLED_LIMIT)) {
+            return false;
+        }
+
+        for (uint32_t j = i + 1; j < arcs->size; j++) {
+            HierarchyFunction shortcut;
+            if (!composeFunctionsHierarchy(
+                    &hierarchy->functions[arcs->arcs[i].function],
+                    &hierarchy->functions[arcs->arcs[j].function],
+                    city, &shortcut)) {
+                return false;
+            }
+
+            if (!pruneFunctionHierarchy(&shortcut, witness,
+                                        arcs->arcs[j].target)) {
+                continue;
+            }
+
+            uint32_t functionsCount = hierarchy->functionsCount;
+            if (!addFunctionHierarchy(hierarchy, arcs->arcs[i].target,
+                                      arcs->arcs[j].target, &shortcut)) {
+                return false;
+            }
+            if (functionsCount != hierarchy->functionsCount) {
+                hierarchy->shortcutsCount++;
+            }
+        }
+    }
+
+    /* Usuwamy krawędzie do kontraktowanego miasta. */
+    for (uint32_t i = 0; i < arcs->size; i++) {
+        removeArcHierarchy(&hierarchy->upwardArcs[arcs->arcs[i].target],
+                           city);
+    }
+
+    return true;
+}
+
+/** @brief Tworzy krawędzie hierarchii odpowiadające odcinkom dróg.
+ * @param[in,out] hierarchy     - wskaźnik na hierarchię.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool addRoadsHierarchy(ContractionHierarchy *hierarchy) {
+    ListIterator *iterator = hierarchy->listOfCities->begin;
+    while (iterator != hierarchy->listOfCities->end) {
+        City *city = iterator->data;
+        iterator = iterator->next;
+        hierarchy->cities[city->id] = city;
+
+        ListIterator *roadIterator = city->roads->begin;
+        while (roadIterator != city->roads->end) {
+            Road *road = roadIterator->data;
+            roadIterator = roadIterator->next;
+
+            /* Każdy odcinek dodajemy tylko raz. */
+            if (road->isDeleted || road->destination->id < city->id) {
+                continue;
+            }
+
+            HierarchyFunction function;
+            function.steps = malloc(sizeof(HierarchyStep));
+            if (function.steps == NULL) {
+                return false;
+            }
+
+            function.steps[0].year = road->buildYearOrLastRepairYear;
+            function.steps[0].distance = road->length;
+            function.steps[0].pathsCount = 1;
+            function.steps[0].middle = NO_MIDDLE_CITY;
+            function.stepsCount = 1;
+            normalizeFunctionHierarchy(&function);
+
+            if (!addFunctionHierarchy(hierarchy, city->id,
+                                      road->destination->id, &function)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/** @brief Wyznacza priorytet kontrakcji miasta.
+ * Priorytetem jest różnica między liczbą skrótów potrzebnych do kontrakcji
+ * miasta a liczbą jego krawędzi, powiększona o liczbę już skontraktowanych
+ * sąsiadów miasta. Miasta o mniejszym priorytecie kontraktujemy wcześniej.
+ * @param[in] hierarchy         - wskaźnik na hierarchię;
+ * @param[in,out] witness       - wskaźnik na tablice szukań dróg świadków;
+ * @param[in] contractedNeighbours - liczby skontraktowanych sąsiadów miast;
+ * @param[in] city              - numer miasta;
+ * @param[out] priority         - wskaźnik na priorytet.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool priorityHierarchy(ContractionHierarchy *hierarchy,
+                       WitnessSearch *witness,
+                       const uint32_t *contractedNeighbours, uint32_t city,
+                       int64_t *priority) {
+    int64_t shortcutsCount;
+    if (!countShortcutsHierarchy(hierarchy, witness, city, &shortcutsCount)) {
+        return false;
+    }
+
+    *priority = shortcutsCount - hierarchy->upwardArcs[city].size +
+                contractedNeighbours[city];
+
+    return true;
+}
+
+/** @brief Buduje hierarchię.
+ * Kontraktuje miasta w kolejności rosnącego priorytetu, wyznaczanego
+ * funkcją @ref priorityHierarchy. Priorytety są uaktualniane leniwie: miasto
+ * zdjęte ze sterty jest kontraktowane, jeśli po przeliczeniu priorytet nadal
+ * jest nie większy od najmniejszego priorytetu na stercie, a w przeciwnym
+ * przypadku wraca na stertę. Skróty, od których drogi świadkowie są
+ * krótsze, są przycinane lub pomijane (@ref contractCityHierarchy).
+ * @param[in,out] hierarchy     - wskaźnik na hierarchię.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool buildContractionHierarchy(ContractionHierarchy *hierarchy) {
+    clearContractionHierarchy(hierarchy);
+    hierarchy->witnessSettledCount = 0;
+
+    uint32_t citiesCount = countCitiesOnList(hierarchy->listOfCities);
+    hierarchy->citiesCount = citiesCount;
+    hierarchy->cities = calloc(citiesCount + 1, sizeof(City *));
+    hierarchy->rank = calloc(citiesCount + 1, sizeof(uint32_t));
+    hierarchy->upwardArcs = calloc(citiesCount + 1, sizeof(HierarchyArcs));
+    uint32_t *contractedNeighbours = calloc(citiesCount + 1, sizeof(uint32_t));
+    Heap *heap = newHeap();
+    WitnessSearch witness[WITNESS_SEARCHES_COUNT];
+
+    bool result = hierarchy->cities != NULL && hierarchy->rank != NULL &&
+                  hierarchy->upwardArcs != NULL &&
+                  contractedNeighbours != NULL && heap != NULL;
+    for (uint32_t i = 0; i < WITNESS_SEARCHES_COUNT; i++) {
+        result = prepareWitnessSearchHierarchy(&witness[i], citiesCount) &&
+                 result;
+    }
+    result = result && addRoadsHierarchy(hierarchy);
+
+    for (uint32_t i = 0; result && i < citiesCount; i++) {
+        int64_t priority;
+        result = priorityHierarchy(hierarchy, witness, contractedNeighbours,
+                                   i, &priority) &&
+                 pushHeap(heap, priority, 0, hierarchy->cities[i]);
+    }
+
+    uint32_t contractedCount = 0;
+    while (result && heap->size != 0) {
+        City *city = heap->data[1];
+        popHeap(heap);
+
+        /* Priorytet mógł wzrosnąć od wstawienia na stertę. */
+        int64_t priority;
+        result = priorityHierarchy(hierarchy, witness, contractedNeighbours,
+                                   city->id, &priority);
+        if (result && heap->size != 0 &&
+                priority > heap->keys[1]->distance) {
+            result = pushHeap(heap, priority, 0, city);
+            continue;
+        }
+
+        const HierarchyArcs *arcs = &hierarchy->upwardArcs[city->id];
+        for (uint32_t i = 0; result && i < arcs->size; i++) {
+            contractedNeighbours[arcs->arcs[i].target]++;
+        }
+
+        result = result &&
+                 contractCityHierarchy(hierarchy, witness, city->id);
+        hierarchy->rank[city->id] = contractedCount++;
+    }
+
+    if (heap != NULL) {
+        deleteHeap(heap);
+    }
+    for (uint32_t i = 0; i < WITNESS_SEARCHES_COUNT; i++) {
+        clearWitnessSearchHierarchy(&witness[i]);
+    }
+    free(contractedNeighbours);
+
+    if (!result) {
+        clearContractionHierarchy(hierarchy);
+        return false;
+    }
+
+    hierarchy->isValid = true;
+    hierarchy->buildsCount++;
+
+    return true;
+}
+
+/** @brief Odświeża hierarchię.
+ * Buduje hierarchię od nowa, jeśli jest nieaktualna.
+ * @param[in,out] hierarchy     - wskaźnik na hierarchię.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci (hierarchia jest wtedy nieaktualna).
+ */
+bool refreshContractionHierarchy(ContractionHierarchy *hierarchy) {
+    assert(hierarchy);
+
+    if (hierarchy->isValid) {
+        return true;
+    }
+
+    return buildContractionHierarchy(hierarchy);
+}
+
+/** @brief Znajduje funkcję krawędzi między miastami.
+ * @param[in] hierarchy         - wskaźnik na hierarchię;
+ * @param[in] city1             - numer pierwszego miasta;
+ * @param[in] city2             - numer drugiego miasta.
+ * @return Wskaźnik na funkcję krawędzi lub NULL, jeśli miasta nie są
+ * połączone krawędzią hierarchii.
+ */
+const HierarchyFunction *findFunctionContractionHierarchy(
+        const ContractionHierarchy *hierarchy, uint32_t city1, uint32_t city2) {
+    assert(hierarchy);
+
+    /* Krawędź jest zapisana przy mniej ważnym mieście. */
+    if (hierarchy->rank[city2] < hierarchy->rank[city1]) {
+        uint32_t swap = city1;
+        city1 = city2;
+        city2 = swap;
+    }
+
+    const HierarchyArcs *arcs = &hierarchy->upwardArcs[city1];
+    uint32_t index = findArcHierarchy(arcs, city2);
+    if (index == arcs->size) {
+        return NULL;
+    }
+
+    return &hierarchy->functions[arcs->arcs[index].function];
+}
+
+/** @brief Wartość funkcji krawędzi dla danego progu.
+ * @param[in] function          - wskaźnik na funkcję krawędzi;
+ * @param[in] year              - próg roku.
+ * @return Wskaźnik na stopień funkcji lub NULL, jeśli nie ma drogi złożonej
+ * z odcinków nie starszych niż @p year.
+ */
+const HierarchyStep *stepAtContractionHierarchy(
+        const HierarchyFunction *function, int64_t year) {
+    assert(function);
+
+    if (year <= function->steps[0].year) {
+        return &function->steps[0];
+    }
+
+    /* Szukamy binarnie pierwszego stopnia z rokiem nie mniejszym niż próg. */
+    uint32_t begin = 1, end = function->stepsCount;
+    while (begin < end) {
+        uint32_t middle = (begin + end) / 2;
+        if (function->steps[middle].year < year) {
+            begin = middle + 1;
+        } else {
+            end = middle;
+        }
+    }
+
+    if (begin == function->stepsCount) {
+        return NULL;
+    }
+
+    return &function->steps[begin];
+}
+
+/** @brief Pamięć zajmowana przez hierarchię.
+ * @param[in] hierarchy         - wskaźnik na hierarchię.
+ * @return Liczba bajtów hierarchii, jej krawędzi i funkcji krawędzi.
+ */
+size_t memoryUsageContractionHierarchy(
+        const ContractionHierarchy *hierarchy) {
+    assert(hierarchy);
+
+    size_t result = sizeof(ContractionHierarchy) +
+                    sizeof(HierarchyFunction) * hierarchy->reservedFunctions;
+    for (uint32_t i = 0; i < hierarchy->functionsCount; i++) {
+        result += sizeof(HierarchyStep) * hierarchy->functions[i].stepsCount;
+    }
+
+    if (hierarchy->upwardArcs != NULL) {
+        size_t citiesCount = (size_t)hierarchy->citiesCount + 1;
+        result += (sizeof(City *) + sizeof(uint32_t) +
+                   sizeof(HierarchyArcs)) * citiesCount;
+        for (uint32_t i = 0; i < hierarchy->citiesCount; i++) {
+            result += sizeof(HierarchyArc) *
+                      hierarchy->upwardArcs[i].reservedMemory;
+        }
+    }
+
+    return result;
+}
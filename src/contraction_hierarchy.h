@@ -0,0 +1,140 @@
+/** @file
+ * Interfejs klasy przechowującej hierarchię kontrakcji mapy dróg.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include "city.h"
+#include "list.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define NO_MIDDLE_CITY UINT32_MAX   ///< krawędź odpowiada odcinkowi drogi
+
+/**
+ * Struktura przechowująca jeden stopień funkcji krawędzi hierarchii.
+ * Stopień opisuje najkrótsze drogi złożone z odcinków nie starszych niż próg,
+ * dla progów większych od roku poprzedniego stopnia i nie większych od
+ * @ref year.
+ */
+typedef struct HierarchyStep {
+    int64_t year;                   ///< największy próg stopnia
+    int64_t distance;               ///< długość najkrótszych dróg
+    uint32_t pathsCount;            ///< liczba najkrótszych dróg (najwyżej 2)
+    uint32_t middle;                ///< najważniejsze miasto pośrednie
+                                    ///  lub @ref NO_MIDDLE_CITY
+} HierarchyStep;
+
+/**
+ * Struktura przechowująca funkcję krawędzi hierarchii. Dla progu roku K
+ * funkcja opisuje najkrótsze drogi między końcami krawędzi złożone
+ * z odcinków nie starszych niż K i przechodzące tylko przez miasta mniej
+ * ważne niż oba końce.
+ */
+typedef struct HierarchyFunction {
+    HierarchyStep *steps;           ///< stopnie posortowane rosnąco po roku
+    uint32_t stepsCount;            ///< liczba stopni
+    int64_t bestDistance;           ///< długość najlepszej drogi
+    int64_t bestYear;               ///< najstarszy odcinek najlepszej drogi
+} HierarchyFunction;
+
+/**
+ * Struktura przechowująca krawędź hierarchii wychodzącą z miasta.
+ */
+typedef struct HierarchyArc {
+    uint32_t target;                ///< numer drugiego końca krawędzi
+    uint32_t function;              ///< numer funkcji krawędzi
+} HierarchyArc;
+
+/**
+ * Struktura przechowująca krawędzie hierarchii wychodzące z miasta.
+ */
+typedef struct HierarchyArcs {
+    HierarchyArc *arcs;             ///< krawędzie posortowane po drugim końcu
+    uint32_t size;                  ///< liczba krawędzi
+    uint32_t reservedMemory;        ///< długość zaalokowanej tablicy
+} HierarchyArcs;
+
+/**
+ * Struktura przechowująca hierarchię kontrakcji. Miasta są usuwane
+ * (kontraktowane) od najmniej ważnych, a drogi przez usuwane miasto
+ * zastępowane są skrótami. Po budowie każde miasto ma krawędzie tylko do
+ * miast ważniejszych. Każda zmiana odcinków dróg unieważnia hierarchię.
+ */
+typedef struct ContractionHierarchy {
+    List *listOfCities;             ///< wskaźnik na wszystkie miasta na mapie
+    uint32_t citiesCount;           ///< liczba miast w hierarchii
+    City **cities;                  ///< miasta indeksowane numerami
+    uint32_t *rank;                 ///< ważność miast (kolejność kontrakcji)
+    HierarchyArcs *upwardArcs;      ///< krawędzie do ważniejszych miast
+    HierarchyFunction *functions;   ///< funkcje krawędzi
+    uint32_t functionsCount;        ///< liczba funkcji krawędzi
+    uint32_t reservedFunctions;     ///< długość tablicy @ref functions
+    bool isValid;                   ///< czy hierarchia jest aktualna
+    uint64_t buildsCount;           ///< liczba budowań hierarchii
+    uint64_t shortcutsCount;        ///< liczba skrótów w hierarchii
+    uint64_t witnessSettledCount;   ///< liczba miast obsłużonych przez
+                                    ///  szukania dróg świadków podczas
+                                    ///  ostatniej budowy
+} ContractionHierarchy;
+
+/** @brief Tworzy strukturę.
+ * Tworzy pustą (niezbudowaną) hierarchię.
+ * @param[in] listOfCities      - wskaźnik na wszystkie miasta na mapie.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci.
+ */
+ContractionHierarchy *newContractionHierarchy(List *listOfCities);
+
+/** @brief Usuwa strukturę.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] hierarchy         - wskaźnik na usuwaną strukturę.
+ */
+void deleteContractionHierarchy(ContractionHierarchy *hierarchy);
+
+/** @brief Oznacza hierarchię jako nieaktualną.
+ * Należy wywołać po każdej zmianie odcinków dróg.
+ * @param[in,out] hierarchy     - wskaźnik na hierarchię.
+ */
+void invalidateContractionHierarchy(ContractionHierarchy *hierarchy);
+
+/** @brief Odświeża hierarchię.
+ * Buduje hierarchię od nowa, jeśli jest nieaktualna.
+ * @param[in,out] hierarchy     - wskaźnik na hierarchię.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci (hierarchia jest wtedy nieaktualna).
+ */
+bool refreshContractionHierarchy(ContractionHierarchy *hierarchy);
+
+/** @brief Znajduje funkcję krawędzi między miastami.
+ * @param[in] hierarchy         - wskaźnik na hierarchię;
+ * @param[in] city1             - numer pierwszego miasta;
+ * @param[in] city2             - numer drugiego miasta.
+ * @return Wskaźnik na funkcję krawędzi lub NULL, jeśli miasta nie są
+ * połączone krawędzią hierarchii.
+ */
+const HierarchyFunction *findFunctionContractionHierarchy(
+        const ContractionHierarchy *hierarchy, uint32_t city1, uint32_t city2);
+
+/** @brief Wartość funkcji krawędzi dla danego progu.
+ * @param[in] function          - wskaźnik na funkcję krawędzi;
+ * @param[in] year              - próg roku.
+ * @return Wskaźnik na stopień funkcji lub NULL, jeśli nie ma drogi złożonej
+ * z odcinków nie starszych niż @p year.
+ */
+const HierarchyStep *stepAtContractionHierarchy(
+        const HierarchyFunction *function, int64_t year);
+
+/** @brief Pamięć zajmowana przez hierarchię.
+ * @param[in] hierarchy         - wskaźnik na hierarchię.
+ * @return Liczba bajtów hierarchii, jej krawędzi i funkcji krawędzi.
+ */
+size_t memoryUsageContractionHierarchy(
+        const ContractionHierarchy *hierarchy);
+
+#endif // CONTRACTION_HIERARCHY_H
@@ -0,0 +1,517 @@
+/** @file
+ * Implementacja liczenia macierzy odległości między zbiorami miast.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "distance_matrix.h"
+#include "hierarchy_search.h"
+#include "route.h"
+#include "road.h"
+#include "heap.h"
+
+#include <stdlib.h>
+#include <assert.h>
+#include <stdatomic.h>
+
+/**
+ * Struktura przechowująca wynik wyszukiwania w górę dla jednego miasta.
+ */
+typedef struct BucketEntry {
+    uint32_t index;                 ///< numer obsłużonego miasta (w wynikach
+                                    ///  wyszukiwania) lub numer miasta
+                                    ///  docelowego w macierzy (w kubełku)
+    int64_t distance;               ///< długość najlepszej drogi
+    int64_t oldestRoad;             ///< najstarszy odcinek najlepszej drogi
+} BucketEntry;
+
+/**
+ * Struktura przechowująca dane zadań liczenia macierzy w puli wątków.
+ */
+typedef struct DistanceMatrixTasks {
+    City **rows;                    ///< miasta, z których szukamy
+    uint32_t rowsCount;             ///< liczba miast @ref rows
+    City **columns;                 ///< miasta, do których szukamy
+    uint32_t columnsCount;          ///< liczba miast @ref columns
+    bool isTransposed;              ///< czy wiersze są miastami docelowymi
+    SearchState **states;           ///< stany algorytmu wątków
+    RouteDistance *matrix;          ///< wyniki
+    uint8_t *isColumn;              ///< czy miasto o danym numerze należy
+                                    ///  do @ref columns
+    uint32_t distinctColumnsCount;  ///< liczba różnych miast @ref columns
+    BucketEntry **searches;         ///< wyniki wyszukiwań z miast
+                                    ///  @ref columns
+    uint32_t *searchesSizes;        ///< długości tablic @ref searches
+    size_t *bucketsBegin;           ///< początki kubełków miast
+    BucketEntry *buckets;           ///< kubełki kolejnych miast
+    atomic_bool isOutOfMemory;      ///< czy któremuś zadaniu zabrakło pamięci
+} DistanceMatrixTasks;
+
+/** @brief Wykonuje zadania w puli wątków lub w wątku wywołującym.
+ * @param[in,out] pool          - wskaźnik na pulę wątków lub NULL;
+ * @param[in] tasksCount        - liczba zadań;
+ * @param[in] task              - wykonywane zadanie;
+ * @param[in,out] argument      - wskaźnik przekazywany do zadania.
+ */
+void runTasksDistanceMatrix(ThreadPool *pool, uint32_t tasksCount,
+                            ThreadPoolTask task, void *argument) {
+    if (pool == NULL) {
+        for (uint32_t i = 0; i < tasksCount; i++) {
+            task(argument, i, 0);
+        }
+        return;
+    }
+
+    runThreadPool(pool, tasksCount, task, argument);
+}
+
+/** @brief Zapisuje wynik dla pary miast.
+ * @param[in,out] tasks         - wskaźnik na dane zadań;
+ * @param[in] row               - numer miasta w @ref DistanceMatrixTasks.rows;
+ * @param[in] column            - numer miasta
+ *                                w @ref DistanceMatrixTasks.columns;
+ * @param[in] distance          - długość najlepszej drogi lub @ref INFINITY;
+ * @param[in] oldestRoad        - najstarszy odcinek najlepszej drogi lub
+ *                                @ref INFINITY.
+ */
+void setResultDistanceMatrix(DistanceMatrixTasks *tasks, uint32_t row,
+                             uint32_t column, int64_t distance,
+                             int64_t oldestRoad) {
+    size_t index;
+    if (tasks->isTransposed) {
+        index = (size_t)column * tasks->rowsCount + row;
+    } else {
+        index = (size_t)row * tasks->columnsCount + column;
+    }
+
+    RouteDistance *result = &tasks->matrix[index];
+    if (distance >= INFINITY) {
+        result->length = -1;
+        result->oldestRoad = 0;
+    } else {
+        result->length = distance;
+        result->oldestRoad = oldestRoad == INFINITY ? 0 : oldestRoad;
+    }
+}
+
+/** @brief Symuluje algorytm dijkstry do obsłużenia wszystkich kolumn.
+ * Liczy najlepsze drogi z miasta @p from jak @ref dijkstraRouteModule dla
+ * drogi krajowej bez miast i kończy się po obsłużeniu wszystkich miast
+ * z @ref DistanceMatrixTasks.columns.
+ * @param[in] tasks             - wskaźnik na dane zadań;
+ * @param[in] from              - wskaźnik na miasto startowe;
+ * @param[in,out] state         - wskaźnik na stan algorytmu.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool dijkstraDistanceMatrix(const DistanceMatrixTasks *tasks, City *from,
+                            SearchState *state) {
+    if (!prepareSearchState(state)) {
+        return false;
+    }
+
+    Heap *heap = newHeap();
+    if (heap == NULL) {
+        return false;
+    }
+
+    int64_t *distance = state->distance;
+    int64_t *oldestRoadOnRoute = state->oldestRoadOnRoute;
+
+    uint32_t citiesCount = countCitiesOnList(state->listOfCities);
+    for (uint32_t i = 0; i < citiesCount; i++) {
+        distance[i] = INFINITY;
+        oldestRoadOnRoute[i] = INFINITY;
+    }
+
+    distance[from->id] = 0;
+    bool result = pushHeap(heap, 0, INFINITY, from);
+    uint32_t columnsLeft = tasks->distinctColumnsCount;
+
+    while (result && heap->size != 0) {
+        City *ptr = heap->data[1];
+        if (heap->keys[1]->distance != distance[ptr->id] ||
+                heap->keys[1]->oldestRoad != oldestRoadOnRoute[ptr->id]) {
+            popHeap(heap);
+            continue;
+        }
+
+        popHeap(heap);
+        state->statistics.settledCitiesCount++;
+
+        /* Wyniki obsłużonych miast już się nie zmienią. */
+        if (tasks->isColumn[ptr->id] && --columnsLeft == 0) {
+            break;
+        }
+
+        ListIterator *iterator = ptr->roads->begin;
+        while (result && iterator != ptr->roads->end) {
+            Road *road = iterator->data;
+            iterator = iterator->next;
+            if (road->isDeleted) {
+                continue;
+            }
+
+            uint32_t destination = road->destination->id;
+            int64_t newDistance = distance[ptr->id] + road->length;
+            int64_t oldestRoute = minInt64_t(oldestRoadOnRoute[ptr->id],
+                                             road->buildYearOrLastRepairYear);
+            if (compareRoutes(newDistance, oldestRoute, distance[destination],
+                              oldestRoadOnRoute[destination]) < 0) {
+                distance[destination] = newDistance;
+                oldestRoadOnRoute[destination] = oldestRoute;
+                result = pushHeap(heap, newDistance, oldestRoute,
+                                  road->destination);
+            }
+        }
+    }
+
+    deleteHeap(heap);
+    return result;
+}
+
+/** @brief Liczy wiersz macierzy algorytmem dijkstry w wątku puli.
+ * @param[in,out] argument      - wskaźnik na @ref DistanceMatrixTasks;
+ * @param[in] taskIndex         - numer wiersza;
+ * @param[in] threadIndex       - numer wątku.
+ */
+void oneToManyTaskDistanceMatrix(void *argument, uint32_t taskIndex,
+                                 uint32_t threadIndex) {
+    DistanceMatrixTasks *tasks = argument;
+    SearchState *state = tasks->states[threadIndex];
+
+    if (!dijkstraDistanceMatrix(tasks, tasks->rows[taskIndex], state)) {
+        atomic_store(&tasks->isOutOfMemory, true);
+        return;
+    }
+    state->statistics.searchesCount++;
+
+    for (uint32_t i = 0; i < tasks->columnsCount; i++) {
+        uint32_t id = tasks->columns[i]->id;
+        setResultDistanceMatrix(tasks, taskIndex, i, state->distance[id],
+                                state->oldestRoadOnRoute[id]);
+    }
+}
+
+/** @brief Liczy macierz, szukając z każdego miasta mniejszego zbioru.
+ * Odcinki dróg są dwukierunkowe, więc wynik dla pary nie zależy od
+ * kierunku wyszukiwania.
+ * @param[in,out] tasks         - wskaźnik na dane zadań z ustawionymi
+ *                                miastami i stanami algorytmu;
+ * @param[in,out] pool          - wskaźnik na pulę wątków lub NULL;
+ * @param[in] citiesCount       - liczba miast na mapie.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool oneToManyDistanceMatrix(DistanceMatrixTasks *tasks, ThreadPool *pool,
+                             uint32_t citiesCount) {
+    if (tasks->rowsCount > tasks->columnsCount) {
+        City **cities = tasks->rows;
+        tasks->rows = tasks->columns;
+        tasks->columns = cities;
+
+        uint32_t count = tasks->rowsCount;
+        tasks->rowsCount = tasks->columnsCount;
+        tasks->columnsCount = count;
+        tasks->isTransposed = true;
+    }
+
+    tasks->isColumn = calloc(citiesCount, sizeof(uint8_t));
+    if (tasks->isColumn == NULL) {
+        return false;
+    }
+
+    tasks->distinctColumnsCount = 0;
+    for (uint32_t i = 0; i < tasks->columnsCount; i++) {
+        uint32_t id = tasks->columns[i]->id;
+        if (!tasks->isColumn[id]) {
+            tasks->isColumn[id] = 1;
+            tasks->distinctColumnsCount++;
+        }
+    }
+
+    runTasksDistanceMatrix(pool, tasks->rowsCount,
+                           oneToManyTaskDistanceMatrix, tasks);
+
+    free(tasks->isColumn);
+    return !atomic_load(&tasks->isOutOfMemory);
+}
+
+/** @brief Przeszukuje hierarchię w górę od miasta.
+ * Wyniki zapisuje w tablicach @ref SearchState.distance
+ * i @ref SearchState.oldestRoadOnRoute, a obsłużone miasta
+ * w @ref SearchState.settledCities.
+ * @param[in,out] state         - wskaźnik na przygotowany stan algorytmu;
+ * @param[in] city              - wskaźnik na miasto startowe;
+ * @param[in,out] heap          - wskaźnik na pustą stertę.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool upwardSearchDistanceMatrix(SearchState *state, City *city, Heap *heap) {
+    HierarchyDirection forward = {state->distance, state->oldestRoadOnRoute,
+                                  state->pathsCount, state->previousOnRoute,
+                                  1};
+
+    nextStampSearchState(state);
+    state->statistics.searchesCount++;
+    if (city->id < state->hierarchy->citiesCount) {
+        return upwardSearchHierarchy(state, &forward, city, 0, INFINITY, heap);
+    }
+
+    /* Miasta dodane po zbudowaniu hierarchii nie mają odcinków dróg. */
+    touchCitySearchState(state, city->id);
+    state->distance[city->id] = 0;
+    state->settledCities[state->settledCitiesSize++] = city;
+    return true;
+}
+
+/** @brief Przeszukuje hierarchię w górę od miasta.
+ * Działa jak @ref upwardSearchDistanceMatrix, ale sam przygotowuje stan
+ * algorytmu i stertę.
+ * @param[in,out] state         - wskaźnik na stan algorytmu;
+ * @param[in] city              - wskaźnik na miasto startowe.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool searchUpwardDistanceMatrix(SearchState *state, City *city) {
+    assert(state->hierarchy && state->hierarchy->isValid);
+
+    if (!prepareSearchState(state)) {
+        return false;
+    }
+
+    Heap *heap = newHeap();
+    if (heap == NULL) {
+        return false;
+    }
+
+    bool result = upwardSearchDistanceMatrix(state, city, heap);
+    deleteHeap(heap);
+    return result;
+}
+
+/** @brief Zapisuje wyniki wyszukiwania w górę z kolumny w wątku puli.
+ * @param[in,out] argument      - wskaźnik na @ref DistanceMatrixTasks;
+ * @param[in] taskIndex         - numer kolumny;
+ * @param[in] threadIndex       - numer wątku.
+ */
+void columnTaskDistanceMatrix(void *argument, uint32_t taskIndex,
+                              uint32_t threadIndex) {
+    DistanceMatrixTasks *tasks = argument;
+    SearchState *state = tasks->states[threadIndex];
+
+    if (!searchUpwardDistanceMatrix(state, tasks->columns[taskIndex])) {
+        atomic_store(&tasks->isOutOfMemory, true);
+        return;
+    }
+
+    uint32_t size = state->settledCitiesSize;
+    BucketEntry *entries = malloc(sizeof(BucketEntry) * size);
+    if (entries == NULL) {
+        atomic_store(&tasks->isOutOfMemory, true);
+        return;
+    }
+
+    for (uint32_t i = 0; i < size; i++) {
+        uint32_t id = state->settledCities[i]->id;
+        entries[i].index = id;
+        entries[i].distance = state->distance[id];
+        entries[i].oldestRoad = state->oldestRoadOnRoute[id];
+    }
+
+    tasks->searches[taskIndex] = entries;
+    tasks->searchesSizes[taskIndex] = size;
+}
+
+/** @brief Rozkłada wyniki wyszukiwań z kolumn do kubełków miast.
+ * Kubełek miasta o numerze @p id zajmuje pozycje od
+ * @p bucketsBegin[id] do @p bucketsBegin[id + 1] - 1 tablicy
+ * @ref DistanceMatrixTasks.buckets.
+ * @param[in,out] tasks         - wskaźnik na dane zadań;
+ * @param[in] citiesCount       - liczba miast na mapie.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool fillBucketsDistanceMatrix(DistanceMatrixTasks *tasks,
+                               uint32_t citiesCount) {
+    tasks->bucketsBegin = calloc((size_t)citiesCount + 1, sizeof(size_t));
+    if (tasks->bucketsBegin == NULL) {
+        return false;
+    }
+
+    size_t *begin = tasks->bucketsBegin;
+    for (uint32_t i = 0; i < tasks->columnsCount; i++) {
+        for (uint32_t j = 0; j < tasks->searchesSizes[i]; j++) {
+            begin[tasks->searches[i][j].index + 1]++;
+        }
+    }
+    for (uint32_t id = 0; id < citiesCount; id++) {
+        begin[id + 1] += begin[id];
+    }
+
+    tasks->buckets = malloc(sizeof(BucketEntry) * (begin[citiesCount] + 1));
+    if (tasks->buckets == NULL) {
+        return false;
+    }
+
+    /* Po wypełnieniu begin[id] wskazuje koniec kubełka, czyli początek
+     * następnego, więc przesuwamy tablicę o jedną pozycję. */
+    for (uint32_t i = 0; i < tasks->columnsCount; i++) {
+        for (uint32_t j = 0; j < tasks->searchesSizes[i]; j++) {
+            BucketEntry entry = tasks->searches[i][j];
+            uint32_t id = entry.index;
+            entry.index = i;
+            tasks->buckets[begin[id]++] = entry;
+        }
+    }
+    for (uint32_t id = citiesCount; id > 0; id--) {
+        begin[id] = begin[id - 1];
+    }
+    begin[0] = 0;
+
+    return true;
+}
+
+/** @brief Liczy wiersz macierzy z kubełków w wątku puli.
+ * @param[in,out] argument      - wskaźnik na @ref DistanceMatrixTasks;
+ * @param[in] taskIndex         - numer wiersza;
+ * @param[in] threadIndex       - numer wątku.
+ */
+void rowTaskDistanceMatrix(void *argument, uint32_t taskIndex,
+                           uint32_t threadIndex) {
+    DistanceMatrixTasks *tasks = argument;
+    SearchState *state = tasks->states[threadIndex];
+
+    if (!searchUpwardDistanceMatrix(state, tasks->rows[taskIndex])) {
+        atomic_store(&tasks->isOutOfMemory, true);
+        return;
+    }
+
+    /* Najlepsze drogi zbieramy w wierszu wyników, a na końcu zamieniamy
+     * je na wyniki. */
+    RouteDistance *row = tasks->matrix + (size_t)taskIndex *
+                                         tasks->columnsCount;
+    for (uint32_t i = 0; i < tasks->columnsCount; i++) {
+        row[i].length = INFINITY;
+        row[i].oldestRoad = INFINITY;
+    }
+
+    for (uint32_t i = 0; i < state->settledCitiesSize; i++) {
+        uint32_t id = state->settledCities[i]->id;
+        int64_t distance = state->distance[id];
+        int64_t oldestRoad = state->oldestRoadOnRoute[id];
+
+        for (size_t j = tasks->bucketsBegin[id];
+             j < tasks->bucketsBegin[id + 1]; j++) {
+            const BucketEntry *entry = &tasks->buckets[j];
+            RouteDistance *best = &row[entry->index];
+            int64_t newDistance = distance + entry->distance;
+            int64_t newOldestRoad = minInt64_t(oldestRoad, entry->oldestRoad);
+            if (compareRoutes(newDistance, newOldestRoad,
+                              best->length, best->oldestRoad) < 0) {
+                best->length = newDistance;
+                best->oldestRoad = newOldestRoad;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < tasks->columnsCount; i++) {
+        setResultDistanceMatrix(tasks, taskIndex, i, row[i].length,
+                                row[i].oldestRoad);
+    }
+}
+
+/** @brief Liczy macierz w hierarchii kontrakcji.
+ * Najpierw równolegle przeszukuje hierarchię w górę z kolumn i rozkłada
+ * wyniki do kubełków miast, a potem równolegle przeszukuje ją w górę
+ * z wierszy. Najlepsza droga pary przechodzi przez najważniejsze miasto,
+ * które obsłużą oba wyszukiwania.
+ * @param[in,out] tasks         - wskaźnik na dane zadań z ustawionymi
+ *                                miastami i stanami algorytmu;
+ * @param[in,out] pool          - wskaźnik na pulę wątków lub NULL;
+ * @param[in] citiesCount       - liczba miast na mapie.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool bucketsDistanceMatrix(DistanceMatrixTasks *tasks, ThreadPool *pool,
+                           uint32_t citiesCount) {
+    tasks->searches = calloc(tasks->columnsCount, sizeof(BucketEntry *));
+    tasks->searchesSizes = calloc(tasks->columnsCount, sizeof(uint32_t));
+    tasks->bucketsBegin = NULL;
+    tasks->buckets = NULL;
+
+    bool result = tasks->searches != NULL && tasks->searchesSizes != NULL;
+    if (result) {
+        runTasksDistanceMatrix(pool, tasks->columnsCount,
+                               columnTaskDistanceMatrix, tasks);
+        result = !atomic_load(&tasks->isOutOfMemory) &&
+                 fillBucketsDistanceMatrix(tasks, citiesCount);
+    }
+
+    if (tasks->searches != NULL) {
+        for (uint32_t i = 0; i < tasks->columnsCount; i++) {
+            free(tasks->searches[i]);
+        }
+    }
+    free(tasks->searches);
+    free(tasks->searchesSizes);
+
+    if (result) {
+        runTasksDistanceMatrix(pool, tasks->rowsCount, rowTaskDistanceMatrix,
+                               tasks);
+        result = !atomic_load(&tasks->isOutOfMemory);
+    }
+
+    free(tasks->bucketsBegin);
+    free(tasks->buckets);
+    return result;
+}
+
+/** @brief Liczy macierz odległości.
+ * Wynik dla miasta @p sources[i] i miasta @p targets[j] zapisuje
+ * w @p matrix[i * targetsCount + j]. Jeśli stan algorytmu wybiera hierarchię
+ * kontrakcji, to hierarchia musi być aktualna.
+ * @param[in] sources           - wskaźnik na tablicę miast źródłowych;
+ * @param[in] sourcesCount      - liczba miast źródłowych;
+ * @param[in] targets           - wskaźnik na tablicę miast docelowych;
+ * @param[in] targetsCount      - liczba miast docelowych;
+ * @param[in,out] states        - wskaźnik na tablicę stanów algorytmu, po
+ *                                jednym na wątek puli;
+ * @param[in,out] pool          - wskaźnik na pulę wątków lub NULL, jeśli
+ *                                wyszukiwania mają być wykonane w wątku
+ *                                wywołującym ze stanem @p states[0];
+ * @param[out] matrix           - wskaźnik na tablicę
+ *                                @p sourcesCount * @p targetsCount wyników.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool computeDistanceMatrix(City **sources, uint32_t sourcesCount,
+                           City **targets, uint32_t targetsCount,
+                           SearchState **states, ThreadPool *pool,
+                           RouteDistance *matrix) {
+    assert(sources && targets && states && states[0] && matrix);
+
+    if (sourcesCount == 0 || targetsCount == 0) {
+        return true;
+    }
+
+    DistanceMatrixTasks tasks;
+    tasks.rows = sources;
+    tasks.rowsCount = sourcesCount;
+    tasks.columns = targets;
+    tasks.columnsCount = targetsCount;
+    tasks.isTransposed = false;
+    tasks.states = states;
+    tasks.matrix = matrix;
+    atomic_init(&tasks.isOutOfMemory, false);
+
+    uint32_t citiesCount = countCitiesOnList(states[0]->listOfCities);
+    const ContractionHierarchy *hierarchy = states[0]->hierarchy;
+    if (states[0]->engine == HIERARCHY_SEARCH_ENGINE && hierarchy != NULL &&
+            hierarchy->isValid) {
+        return bucketsDistanceMatrix(&tasks, pool, citiesCount);
+    }
+
+    return oneToManyDistanceMatrix(&tasks, pool, citiesCount);
+}
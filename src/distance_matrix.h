@@ -0,0 +1,63 @@
+/** @file
+ * Interfejs liczenia macierzy odległości między zbiorami miast.
+ *
+ * Dla każdej pary miasta źródłowego i docelowego wyznaczana jest najlepsza
+ * droga w sensie funkcji @ref compareRoutes: najkrótsza, a wśród
+ * najkrótszych ta, której najdawniej wybudowany odcinek jest najmłodszy.
+ * W hierarchii kontrakcji wyszukiwania są wspólne dla wszystkich par: każde
+ * miasto docelowe zostawia wyniki swojego wyszukiwania w górę w kubełkach
+ * odwiedzonych miast, a wyszukiwanie w górę z miasta źródłowego przegląda
+ * kubełki obsłużonych miast. Bez hierarchii jeden algorytm dijkstry liczy
+ * cały wiersz macierzy dla miasta z mniejszego zbioru i kończy się po
+ * obsłużeniu wszystkich miast z drugiego zbioru. Wyszukiwania wykonywane są
+ * równolegle w puli wątków.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef DISTANCE_MATRIX_H
+#define DISTANCE_MATRIX_H
+
+#include "city.h"
+#include "search_state.h"
+#include "thread_pool.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Struktura opisująca najlepszą drogę między parą miast.
+ */
+typedef struct RouteDistance {
+    int64_t length;                 ///< długość drogi lub @p -1, jeśli
+                                    ///  drogi nie ma
+    int64_t oldestRoad;             ///< rok budowy lub ostatniego remontu
+                                    ///  najdawniej wybudowanego odcinka lub
+                                    ///  @p 0, jeśli droga nie ma odcinków
+} RouteDistance;
+
+/** @brief Liczy macierz odległości.
+ * Wynik dla miasta @p sources[i] i miasta @p targets[j] zapisuje
+ * w @p matrix[i * targetsCount + j]. Jeśli stan algorytmu wybiera hierarchię
+ * kontrakcji, to hierarchia musi być aktualna.
+ * @param[in] sources           - wskaźnik na tablicę miast źródłowych;
+ * @param[in] sourcesCount      - liczba miast źródłowych;
+ * @param[in] targets           - wskaźnik na tablicę miast docelowych;
+ * @param[in] targetsCount      - liczba miast docelowych;
+ * @param[in,out] states        - wskaźnik na tablicę stanów algorytmu, po
+ *                                jednym na wątek puli;
+ * @param[in,out] pool          - wskaźnik na pulę wątków lub NULL, jeśli
+ *                                wyszukiwania mają być wykonane w wątku
+ *                                wywołującym ze stanem @p states[0];
+ * @param[out] matrix           - wskaźnik na tablicę
+ *                                @p sourcesCount * @p targetsCount wyników.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool computeDistanceMatrix(City **sources, uint32_t sourcesCount,
+                           City **targets, uint32_t targetsCount,
+                           SearchState **states, ThreadPool *pool,
+                           RouteDistance *matrix);
+
+#endif // DISTANCE_MATRIX_H
@@ -117,6 +117,42 @@ bool insertHashMap(HashMap *hashMap, City *city) {
     return true;
 }
 
+/** @brief Znajduje istniejący wierzchołek odpowiadający danemu haszowi.
+ * Działa jak @ref findNodeHashMap, ale nie dodaje wierzchołków, więc nie
+ * zmienia haszmapy i może być wywoływana przez wiele wątków naraz.
+ * @param[in] hashMap       - wskażnik na haszmapę;
+ * @param[in] hash          - szukany hasz.
+ * @return Wskaźnik na szukany wierzchołek lub NULL jeśli go nie ma.
+ */
+HashMap *findExistingNodeHashMap(HashMap *hashMap, uint32_t hash) {
+    while (hashMap != NULL && hash) {
+        hashMap = hash % 2 ? hashMap->right : hashMap->left;
+        hash /= 2;
+    }
+
+    return hashMap;
+}
+
+/** @brief Znajduję miasto na haszmapie.
+ * Znajduję miasto (@ref City) na haszmapie, korzystając z wyznaczonego
+ * wcześniej haszu nazwy.
+ * @param[in] hashMap       - wskaźnik na haszmapę;
+ * @param[in] cityName      - wskaźnik na opis nazwy szukanego miasta.
+ * @return Wskażnik na szukane miasto lub NULL jeśli dane miasto nie znajduje
+ * się na haszmapie.
+ */
+City *findCityByNameOnHashMap(HashMap *hashMap, const CityName *cityName) {
+    assert(hashMap);
+    assert(cityName && cityName->name);
+
+    hashMap = findExistingNodeHashMap(hashMap, cityName->hash);
+    if (hashMap == NULL) {
+        return NULL;
+    }
+
+    return findCityByNameOnList(hashMap->data, cityName);
+}
+
 /** @brief Znajduję miasto na haszmapie.
  * Znajduję miasto (@ref City) na haszmapie.
  * @param[in] hashMap       - wskaźnik na haszmapę;
@@ -128,35 +164,37 @@ City *findCityOnHashMap(HashMap *hashMap, const char *cityName) {
     assert(hashMap);
     assert(cityName);
 
-    hashMap = findNodeHashMap(hashMap, hashString(cityName));
-    if (hashMap == NULL) {
-        return NULL;
-    }
+    CityName name = {cityName, hashString(cityName), true};
 
-    return findCityOnList(hashMap->data, cityName);
+    return findCityByNameOnHashMap(hashMap, &name);
 }
 
 /** @brief Znajduję miasto na haszmapie, jeśli go nie ma to je dodaje.
- * Znajduję miasto (@ref City) na haszmapie, jeśli go nie ma to dodaje to
- * miasto na haszmapę @p hashMap oraz na listę @p listOfCities.
+ * Działa jak @ref findCityOnHashMapInsertIfNecessary, ale korzysta
+ * z wyznaczonego wcześniej haszu nazwy.
  * @param[in,out] hashMap   - wskaźnik na haszmapę;
  * @param[in,out] listOfCities - wskaźnik na listę miast;
- * @param[in] cityName      - wskaźnik na nazwę szukanego miasta.
+ * @param[in] cityName      - wskaźnik na opis poprawnej nazwy miasta.
  * @return Wskażnik na szukane miasto lub NULL jeśli nie udało się zaalkować
  * pamięci.
  */
-City *findCityOnHashMapInsertIfNecessary(HashMap *hashMap, List *listOfCities,
-                                         const char *cityName) {
+City *findCityByNameOnHashMapInsertIfNecessary(HashMap *hashMap,
+                                               List *listOfCities,
+                                               const CityName *cityName) {
     assert(hashMap);
     assert(listOfCities);
-    assert(cityName);
+    assert(cityName && cityName->isValid);
 
-    City *result = findCityOnHashMap(hashMap, cityName);
+    City *result = findCityByNameOnHashMap(hashMap, cityName);
     if (result != NULL) {
         return result;
     }
 
-    result = newCity(cityName);
+    result = newCity(cityName->name, countCitiesOnList(listOfCities));
+    if (result == NULL) {
+        return NULL;
+    }
+
     if (insertList(listOfCities->begin, result) == NULL) {
         deleteCity(result);
         return NULL;
@@ -170,3 +208,39 @@ City *findCityOnHashMapInsertIfNecessary(HashMap *hashMap, List *listOfCities,
 
     return result;
 }
+
+/** @brief Znajduję miasto na haszmapie, jeśli go nie ma to je dodaje.
+ * Znajduję miasto (@ref City) na haszmapie, jeśli go nie ma to dodaje to
+ * miasto na haszmapę @p hashMap oraz na listę @p listOfCities.
+ * @param[in,out] hashMap   - wskaźnik na haszmapę;
+ * @param[in,out] listOfCities - wskaźnik na listę miast;
+ * @param[in] cityName      - wskaźnik na nazwę szukanego miasta.
+ * @return Wskażnik na szukane miasto lub NULL jeśli nie udało się zaalkować
+ * pamięci.
+ */
+City *findCityOnHashMapInsertIfNecessary(HashMap *hashMap, List *listOfCities,
+                                         const char *cityName) {
+    assert(hashMap);
+    assert(listOfCities);
+    assert(cityName);
+
+    CityName name = {cityName, hashString(cityName), true};
+
+    return findCityByNameOnHashMapInsertIfNecessary(hashMap, listOfCities,
+                                                    &name);
+}
+
+/** @brief Pamięć zajmowana przez haszmapę.
+ * Liczy wierzchołki drzewa haszmapy i ich listy, bez miast.
+ * @param[in] hashMap       - wskaźnik na haszmapę lub NULL.
+ * @return Liczba bajtów.
+ */
+size_t memoryUsageHashMap(HashMap *hashMap) {
+    if (hashMap == NULL) {
+        return 0;
+    }
+
+    return sizeof(HashMap) + memoryUsageList(hashMap->data) +
+           memoryUsageHashMap(hashMap->left) +
+           memoryUsageHashMap(hashMap->right);
+}
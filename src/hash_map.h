@@ -39,6 +39,16 @@ void deleteHashMap(HashMap *hashMap);
  */
 City *findCityOnHashMap(HashMap *hashMap, const char *cityName);
 
+/** @brief Znajduję miasto na haszmapie.
+ * Znajduję miasto (@ref City) na haszmapie, korzystając z wyznaczonego
+ * wcześniej haszu nazwy.
+ * @param[in] hashMap       - wskaźnik na haszmapę;
+ * @param[in] cityName      - wskaźnik na opis nazwy szukanego miasta.
+ * @return Wskażnik na szukane miasto lub NULL jeśli dane miasto nie znajduje
+ * się na haszmapie.
+ */
+City *findCityByNameOnHashMap(HashMap *hashMap, const CityName *cityName);
+
 /** @brief Znajduję miasto na haszmapie, jeśli go nie ma to je dodaje.
  * Znajduję miasto (@ref City) na haszmapie, jeśli go nie ma to dodaje to
  * miasto na haszmapę @p hashMap oraz na listę @p listOfCities.
@@ -51,4 +61,24 @@ City *findCityOnHashMap(HashMap *hashMap, const char *cityName);
 City *findCityOnHashMapInsertIfNecessary(HashMap *hashMap, List *listOfCities,
                                          const char *cityName);
 
+/** @brief Znajduję miasto na haszmapie, jeśli go nie ma to je dodaje.
+ * Działa jak @ref findCityOnHashMapInsertIfNecessary, ale korzysta
+ * z wyznaczonego wcześniej haszu nazwy.
+ * @param[in,out] hashMap   - wskaźnik na haszmapę;
+ * @param[in,out] listOfCities - wskaźnik na listę miast;
+ * @param[in] cityName      - wskaźnik na opis poprawnej nazwy miasta.
+ * @return Wskażnik na szukane miasto lub NULL jeśli nie udało się zaalkować
+ * pamięci.
+ */
+City *findCityByNameOnHashMapInsertIfNecessary(HashMap *hashMap,
+                                               List *listOfCities,
+                                               const CityName *cityName);
+
+/** @brief Pamięć zajmowana przez haszmapę.
+ * Liczy wierzchołki drzewa haszmapy i ich listy, bez miast.
+ * @param[in] hashMap       - wskaźnik na haszmapę lub NULL.
+ * @return Liczba bajtów.
+ */
+size_t memoryUsageHashMap(HashMap *hashMap);
+
 #endif // HASH_MAP_H
@@ -0,0 +1,362 @@
+/** @file
+ * Implementacja wyszukiwania dróg krajowych w hierarchii kontrakcji.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "hierarchy_search.h"
+#include "contraction_hierarchy.h"
+#include "heap.h"
+
+#include <stdlib.h>
+#include <assert.h>
+
+/** @brief Przeszukuje hierarchię w górę od miasta.
+ * Liczy najlepsze drogi do miast ważniejszych od miasta @p root. Jeśli
+ * @p knownOldestRoad == 0, to drogi porównywane są jak w funkcji
+ * @ref compareRoutes. W przeciwnym przypadku liczone są najkrótsze drogi
+ * złożone z odcinków nie starszych niż @p knownOldestRoad i ich liczby,
+ * pomijając drogi dłuższe niż @p knownDistance. Obsłużone miasta kierunku
+ * od startu dopisywane są do @ref SearchState.settledCities.
+ * @param[in,out] state         - wskaźnik na stan algorytmu;
+ * @param[in] direction         - wskaźnik na kierunek;
+ * @param[in] root              - wskaźnik na miasto startowe kierunku;
+ * @param[in] knownOldestRoad   - rok, od którego uwzględniamy odcinki lub
+ *                                @p 0;
+ * @param[in] knownDistance     - długość szukanej drogi lub @ref INFINITY;
+ * @param[in,out] heap          - wskaźnik na pustą stertę.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool upwardSearchHierarchy(SearchState *state, HierarchyDirection *direction,
+                           City *root, int64_t knownOldestRoad,
+                           int64_t knownDistance, Heap *heap) {
+    const ContractionHierarchy *hierarchy = state->hierarchy;
+
+    touchCitySearchState(state, root->id);
+    direction->distance[root->id] = 0;
+    direction->oldestRoadOnRoute[root->id] = INFINITY;
+    direction->pathsCount[root->id] = 1;
+    if (!pushHeap(heap, 0, INFINITY, root)) {
+        return false;
+    }
+
+    while (heap->size != 0) {
+        City *ptr = heap->data[1];
+        uint32_t id = ptr->id;
+
+        if (heap->keys[1]->distance != direction->distance[id] ||
+                (knownOldestRoad == 0 && heap->keys[1]->oldestRoad !=
+                                         direction->oldestRoadOnRoute[id]) ||
+                (state->settled[id] & direction->settledFlag)) {
+            popHeap(heap);
+            continue;
+        }
+
+        popHeap(heap);
+        state->settled[id] |= direction->settledFlag;
+        state->statistics.settledCitiesCount++;
+        if (direction->distance == state->distance) {
+            state->settledCities[state->settledCitiesSize++] = ptr;
+        }
+
+        const HierarchyArcs *arcs = &hierarchy->upwardArcs[id];
+        for (uint32_t i = 0; i < arcs->size; i++) {
+            const HierarchyFunction *function =
+                    &hierarchy->functions[arcs->arcs[i].function];
+            uint32_t destination = arcs->arcs[i].target;
+
+            int64_t length = function->bestDistance;
+            int64_t year = function->bestYear;
+            uint32_t pathsCount = 1;
+            if (knownOldestRoad != 0) {
+                const HierarchyStep *step =
+                        stepAtContractionHierarchy(function, knownOldestRoad);
+                if (step == NULL) {
+                    continue;
+                }
+
+                length = step->distance;
+                pathsCount = step->pathsCount;
+            }
+
+            int64_t distance = direction->distance[id] + length;
+            if (distance > knownDistance) {
+                continue;
+            }
+
+            touchCitySearchState(state, destination);
+            int64_t oldestRoute = minInt64_t(direction->oldestRoadOnRoute[id],
+                                             year);
+            pathsCount *= direction->pathsCount[id];
+
+            int64_t compare;
+            if (knownOldestRoad == 0) {
+                compare = compareRoutes(distance, oldestRoute,
+                                        direction->distance[destination],
+                                        direction->oldestRoadOnRoute[destination]);
+            } else {
+                compare = distance - direction->distance[destination];
+            }
+
+            if (compare < 0) {
+                direction->distance[destination] = distance;
+                direction->oldestRoadOnRoute[destination] = oldestRoute;
+                direction->pathsCount[destination] =
+                        pathsCount < 2 ? pathsCount : 2;
+                direction->parent[destination] = ptr;
+
+                if (!pushHeap(heap, distance, oldestRoute,
+                              hierarchy->cities[destination])) {
+                    return false;
+                }
+            } else if (compare == 0 && knownOldestRoad != 0) {
+                pathsCount += direction->pathsCount[destination];
+                direction->pathsCount[destination] =
+                        pathsCount < 2 ? pathsCount : 2;
+            }
+        }
+    }
+
+    return true;
+}
+
+/** @brief Rozwija krawędź hierarchii na odcinki dróg.
+ * Dopisuje na koniec listy @p result miasta drogi odpowiadającej krawędzi
+ * hierarchii z miasta @p from do miasta @p to (bez miasta @p from) dla progu
+ * roku @p knownOldestRoad. Najkrótsza droga musi być jednoznaczna.
+ * @param[in] hierarchy         - wskaźnik na hierarchię;
+ * @param[in] from              - numer pierwszego miasta krawędzi;
+ * @param[in] to                - numer drugiego miasta krawędzi;
+ * @param[in] knownOldestRoad   - próg roku;
+ * @param[in,out] result        - wskaźnik na listę miast drogi.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool unpackArcHierarchy(const ContractionHierarchy *hierarchy, uint32_t from,
+                        uint32_t to, int64_t knownOldestRoad, List *result) {
+    /* Stos par miast, które pozostało rozwinąć. */
+    uint32_t stackSize = 0, reservedMemory = 16;
+    uint32_t *stack = malloc(sizeof(uint32_t) * 2 * reservedMemory);
+    if (stack == NULL) {
+        return false;
+    }
+
+    stack[stackSize++] = from;
+    stack[stackSize++] = to;
+    while (stackSize != 0) {
+        uint32_t second = stack[--stackSize];
+        uint32_t first = stack[--stackSize];
+
+        const HierarchyFunction *function =
+                findFunctionContractionHierarchy(hierarchy, first, second);
+        assert(function);
+        const HierarchyStep *step =
+                stepAtContractionHierarchy(function, knownOldestRoad);
+        assert(step && step->pathsCount == 1);
+
+        if (step->middle == NO_MIDDLE_CITY) {
+            if (insertList(result->end, hierarchy->cities[second]) == NULL) {
+                free(stack);
+                return false;
+            }
+            continue;
+        }
+
+        if (stackSize + 4 > 2 * reservedMemory) {
+            reservedMemory *= 2;
+            uint32_t *ptr = realloc(stack, sizeof(uint32_t) * 2 * reservedMemory);
+            if (ptr == NULL) {
+                free(stack);
+                return false;
+            }
+            stack = ptr;
+        }
+
+        /* Najpierw rozwijamy pierwszą połowę krawędzi. */
+        stack[stackSize++] = step->middle;
+        stack[stackSize++] = second;
+        stack[stackSize++] = first;
+        stack[stackSize++] = step->middle;
+    }
+
+    free(stack);
+
+    return true;
+}
+
+/** @brief Odtwarza drogę znalezioną w hierarchii.
+ * @param[in] state             - wskaźnik na stan algorytmu;
+ * @param[in] from              - wskaźnik na miasto startowe;
+ * @param[in] to                - wskaźnik na miasto docelowe;
+ * @param[in] middle            - najważniejsze miasto drogi;
+ * @param[in] knownOldestRoad   - próg roku.
+ * @return Wskaźnik na listę miast drogi lub NULL, jeśli nie udało się
+ * zaalokować pamięci.
+ */
+List *recoverRouteHierarchy(SearchState *state, City *from, City *to,
+                            City *middle, int64_t knownOldestRoad) {
+    List *hierarchyPath = newList();
+    List *result = newList();
+    if (hierarchyPath == NULL || result == NULL) {
+        if (hierarchyPath != NULL) {
+            deleteList(hierarchyPath, false);
+        }
+        if (result != NULL) {
+            deleteList(result, false);
+        }
+        return NULL;
+    }
+
+    /* Miasta drogi w hierarchii: w górę od startu i w dół do celu. */
+    bool isCorrect = true;
+    City *ptr = middle;
+    while (isCorrect) {
+        isCorrect = insertList(hierarchyPath->begin, ptr) != NULL;
+        if (ptr == from) {
+            break;
+        }
+        ptr = state->previousOnRoute[ptr->id];
+    }
+
+    ptr = middle;
+    while (isCorrect && ptr != to) {
+        ptr = state->nextOnRoute[ptr->id];
+        isCorrect = insertList(hierarchyPath->end, ptr) != NULL;
+    }
+
+    isCorrect = isCorrect && insertList(result->end, from) != NULL;
+
+    ListIterator *iterator = hierarchyPath->begin;
+    while (isCorrect && iterator->next != hierarchyPath->end) {
+        isCorrect = unpackArcHierarchy(state->hierarchy,
+                                       ((City *)iterator->data)->id,
+                                       ((City *)iterator->next->data)->id,
+                                       knownOldestRoad, result);
+        iterator = iterator->next;
+    }
+
+    deleteList(hierarchyPath, false);
+    if (!isCorrect) {
+        deleteList(result, false);
+        return NULL;
+    }
+
+    return result;
+}
+
+/** @brief Wykonuje oba przejścia wyszukiwania w hierarchii.
+ * @param[in] from              - wskaźnik na miasto startowe algorytmu;
+ * @param[in] to                - wskaźnik na docelowe miasto;
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry;
+ * @param[in,out] heap          - wskaźnik na pustą stertę.
+ * @return Wskaźnik na listę zawierającą szukaną drogę lub NULL jeśli droga nie
+ * jest jednoznaczna lub nie udało się zaalokować pamięci.
+ */
+List *searchHierarchy(City *from, City *to, SearchState *state, Heap *heap) {
+    HierarchyDirection forward = {state->distance, state->oldestRoadOnRoute,
+                                  state->pathsCount, state->previousOnRoute,
+                                  1};
+    HierarchyDirection backward = {state->backwardDistance,
+                                   state->backwardOldestRoadOnRoute,
+                                   state->backwardPathsCount,
+                                   state->nextOnRoute, 2};
+
+    /* Znajdujemy długość i optymalny najstarszy odcinek szukanej drogi. */
+    nextStampSearchState(state);
+    if (!upwardSearchHierarchy(state, &forward, from, 0, INFINITY, heap) ||
+            !upwardSearchHierarchy(state, &backward, to, 0, INFINITY, heap)) {
+        return NULL;
+    }
+
+    int64_t bestDistance = INFINITY;
+    int64_t bestOldestRoad = INFINITY;
+    for (uint32_t i = 0; i < state->settledCitiesSize; i++) {
+        uint32_t id = state->settledCities[i]->id;
+        if (state->backwardDistance[id] == INFINITY) {
+            continue;
+        }
+
+        int64_t distance = state->distance[id] + state->backwardDistance[id];
+        int64_t oldestRoad = minInt64_t(state->oldestRoadOnRoute[id],
+                                        state->backwardOldestRoadOnRoute[id]);
+        if (compareRoutes(distance, oldestRoad,
+                          bestDistance, bestOldestRoad) < 0) {
+            bestDistance = distance;
+            bestOldestRoad = oldestRoad;
+        }
+    }
+
+    /* Sprawdzamy czy istnieje jakakolwiek szukana droga krajowa. */
+    if (bestDistance == INFINITY) {
+        return NULL;
+    }
+
+    /* Liczymy najkrótsze drogi złożone z odcinków nie starszych niż
+     * wyznaczony. Każda z nich ma dokładnie jedno najważniejsze miasto. */
+    nextStampSearchState(state);
+    if (!upwardSearchHierarchy(state, &forward, from, bestOldestRoad,
+                               bestDistance, heap) ||
+            !upwardSearchHierarchy(state, &backward, to, bestOldestRoad,
+                                   bestDistance, heap)) {
+        return NULL;
+    }
+
+    uint32_t pathsCount = 0;
+    City *middle = NULL;
+    for (uint32_t i = 0; i < state->settledCitiesSize; i++) {
+        City *city = state->settledCities[i];
+        if (state->distance[city->id] + state->backwardDistance[city->id] ==
+                bestDistance) {
+            pathsCount += state->pathsCount[city->id] *
+                          state->backwardPathsCount[city->id];
+            middle = city;
+        }
+    }
+
+    if (pathsCount != 1) {
+        return NULL;
+    }
+
+    return recoverRouteHierarchy(state, from, to, middle, bestOldestRoad);
+}
+
+/** @brief Znajduje drogę między miastami w hierarchii kontrakcji.
+ * Działa tak jak @ref findRouteModule dla jednego miasta docelowego i drogi
+ * krajowej bez miast (bez wykluczonych miast). Hierarchia w stanie algorytmu
+ * musi być aktualna. Najpierw wyznacza optymalną długość i najstarszy
+ * odcinek szukanej drogi, a następnie liczy najkrótsze drogi złożone
+ * z odcinków nie starszych niż wyznaczony.
+ * @param[in] from              - wskaźnik na miasto startowe algorytmu;
+ * @param[in] to                - wskaźnik na docelowe miasto;
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry.
+ * @return Wskaźnik na listę zawierającą szukaną drogę lub NULL jeśli droga nie
+ * jest jednoznaczna lub nie udało się zaalokować pamięci.
+ */
+List *findRouteHierarchy(City *from, City *to, SearchState *state) {
+    assert(from);
+    assert(to);
+    assert(state);
+    assert(state->hierarchy && state->hierarchy->isValid);
+
+    /* Miasta dodane po zbudowaniu hierarchii nie mają odcinków dróg. */
+    if (from->id >= state->hierarchy->citiesCount ||
+            to->id >= state->hierarchy->citiesCount) {
+        return NULL;
+    }
+
+    if (!prepareSearchState(state)) {
+        return NULL;
+    }
+
+    Heap *heap = newHeap();
+    if (heap == NULL) {
+        return NULL;
+    }
+
+    List *result = searchHierarchy(from, to, state, heap);
+    deleteHeap(heap);
+
+    return result;
+}
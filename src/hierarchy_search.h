@@ -0,0 +1,61 @@
+/** @file
+ * Interfejs wyszukiwania dróg krajowych w hierarchii kontrakcji.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef HIERARCHY_SEARCH_H
+#define HIERARCHY_SEARCH_H
+
+#include "route.h"
+#include "search_state.h"
+#include "heap.h"
+
+/**
+ * Struktura przechowująca tablice jednego kierunku wyszukiwania w hierarchii.
+ */
+typedef struct HierarchyDirection {
+    int64_t *distance;              ///< odległości od miasta startowego
+    int64_t *oldestRoadOnRoute;     ///< najstarsze odcinki najlepszych dróg
+    uint8_t *pathsCount;            ///< liczby najkrótszych dróg
+    City **parent;                  ///< poprzednik na najlepszej drodze
+    uint8_t settledFlag;            ///< flaga obsłużenia w danym kierunku
+} HierarchyDirection;
+
+/** @brief Przeszukuje hierarchię w górę od miasta.
+ * Liczy najlepsze drogi do miast ważniejszych od miasta @p root. Jeśli
+ * @p knownOldestRoad == 0, to drogi porównywane są jak w funkcji
+ * @ref compareRoutes. W przeciwnym przypadku liczone są najkrótsze drogi
+ * złożone z odcinków nie starszych niż @p knownOldestRoad i ich liczby,
+ * pomijając drogi dłuższe niż @p knownDistance. Obsłużone miasta kierunku
+ * od startu dopisywane są do @ref SearchState.settledCities.
+ * @param[in,out] state         - wskaźnik na stan algorytmu;
+ * @param[in] direction         - wskaźnik na kierunek;
+ * @param[in] root              - wskaźnik na miasto startowe kierunku;
+ * @param[in] knownOldestRoad   - rok, od którego uwzględniamy odcinki lub
+ *                                @p 0;
+ * @param[in] knownDistance     - długość szukanej drogi lub @ref INFINITY;
+ * @param[in,out] heap          - wskaźnik na pustą stertę.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool upwardSearchHierarchy(SearchState *state, HierarchyDirection *direction,
+                           City *root, int64_t knownOldestRoad,
+                           int64_t knownDistance, Heap *heap);
+
+/** @brief Znajduje drogę między miastami w hierarchii kontrakcji.
+ * Działa tak jak @ref findRouteModule dla jednego miasta docelowego i drogi
+ * krajowej bez miast (bez wykluczonych miast). Hierarchia w stanie algorytmu
+ * musi być aktualna. Najpierw wyznacza optymalną długość i najstarszy
+ * odcinek szukanej drogi, a następnie liczy najkrótsze drogi złożone
+ * z odcinków nie starszych niż wyznaczony.
+ * @param[in] from              - wskaźnik na miasto startowe algorytmu;
+ * @param[in] to                - wskaźnik na docelowe miasto;
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry.
+ * @return Wskaźnik na listę zawierającą szukaną drogę lub NULL jeśli droga nie
+ * jest jednoznaczna lub nie udało się zaalokować pamięci.
+ */
+List *findRouteHierarchy(City *from, City *to, SearchState *state);
+
+#endif // HIERARCHY_SEARCH_H
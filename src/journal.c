@@ -0,0 +1,858 @@
+/** @file
+ * Implementacja klasy przechowującej dziennik poleceń modyfikujących mapę.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "journal.h"
+#include "map.h"
+#include "snapshot.h"
+#include "hash_map.h"
+#include "city.h"
+#include "road.h"
+#include "route.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+
+#define RECORD_HEADER_SIZE (2 * sizeof(uint32_t))
+///< rozmiar pól rozmiaru i sumy kontrolnej rekordu
+
+#define INITIAL_BUFFER_SIZE 4096
+///< początkowy rozmiar bufora rekordów
+
+/**
+ * Struktura przechowująca stan odczytu danych rekordu.
+ */
+typedef struct JournalReader {
+    const char *data;               ///< dane rekordu
+    size_t size;                    ///< rozmiar danych
+    size_t position;                ///< pozycja odczytu
+} JournalReader;
+
+/** @brief Wyznacza sumę kontrolną danych rekordu.
+ * @param[in] data              - wskaźnik na typ i dane rekordu;
+ * @param[in] size              - rozmiar typu i danych rekordu.
+ * @return Suma kontrolna rekordu.
+ */
+uint32_t checksumJournal(const void *data, size_t size) {
+    uint64_t checksum = checksumSnapshot(SNAPSHOT_CHECKSUM_SEED, data, size);
+
+    return (uint32_t)(checksum ^ (checksum >> 32));
+}
+
+/** @brief Zapisuje dane do pliku.
+ * Powtarza zapis, jeśli został przerwany lub zapisał część danych.
+ * @param[in] fd                - deskryptor pliku;
+ * @param[in] data              - wskaźnik na dane;
+ * @param[in] size              - rozmiar danych.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać danych.
+ */
+bool writeAllJournal(int fd, const char *data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        data += written;
+        size -= (size_t)written;
+    }
+
+    return true;
+}
+
+/** @brief Kopiuje rekordy do nowego pliku dziennika.
+ * @param[in] fd                - deskryptor nowego pliku;
+ * @param[in] sourceFd          - deskryptor dotychczasowego pliku;
+ * @param[in] offset            - pozycja pierwszego kopiowanego bajtu;
+ * @param[in] size              - liczba kopiowanych bajtów.
+ * @return Wartość @p true lub @p false, jeśli nie udało się skopiować
+ * rekordów.
+ */
+bool copyRecordsJournal(int fd, int sourceFd, uint64_t offset, uint64_t size) {
+    char buffer[INITIAL_BUFFER_SIZE];
+    while (size > 0) {
+        size_t chunk = size < sizeof(buffer) ? (size_t)size : sizeof(buffer);
+        ssize_t readCount = pread(sourceFd, buffer, chunk, (off_t)offset);
+        if (readCount < 0 && errno == EINTR) {
+            continue;
+        }
+        if (readCount <= 0 || !writeAllJournal(fd, buffer, (size_t)readCount)) {
+            return false;
+        }
+
+        offset += (uint64_t)readCount;
+        size -= (uint64_t)readCount;
+    }
+
+    return true;
+}
+
+/** @brief Tworzy plik dziennika.
+ * Zapisuje nagłówek i @p size bajtów rekordów z pliku @p sourceFd do pliku
+ * tymczasowego, synchronizuje go i zastępuje nim plik @p path, więc
+ * w każdej chwili plik dziennika ma poprawny nagłówek.
+ * @param[in] path              - wskaźnik na ścieżkę do pliku dziennika;
+ * @param[in] firstSequence     - numer pierwszego rekordu pliku;
+ * @param[in] sourceFd          - deskryptor pliku z rekordami lub @p -1;
+ * @param[in] offset            - pozycja pierwszego rekordu w @p sourceFd;
+ * @param[in] size              - rozmiar kopiowanych rekordów.
+ * @return Deskryptor pliku ustawiony na jego koniec lub @p -1, jeśli nie
+ * udało się utworzyć pliku.
+ */
+int createFileJournal(const char *path, uint64_t firstSequence, int sourceFd,
+                      uint64_t offset, uint64_t size) {
+    size_t pathLength = strlen(path);
+    char *temporaryPath = malloc(pathLength + 5);
+    if (temporaryPath == NULL) {
+        return -1;
+    }
+    memcpy(temporaryPath, path, pathLength);
+    memcpy(temporaryPath + pathLength, ".tmp", 5);
+
+    int fd = open(temporaryPath, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        free(temporaryPath);
+        return -1;
+    }
+
+    JournalHeader header;
+    memset(&header, 0, sizeof(JournalHeader));
+    header.magic = JOURNAL_MAGIC;
+    header.version = JOURNAL_VERSION;
+    header.firstSequence = firstSequence;
+
+    if (!writeAllJournal(fd, (const char *)&header, sizeof(JournalHeader)) ||
+            (size > 0 && !copyRecordsJournal(fd, sourceFd, offset, size)) ||
+            fdatasync(fd) != 0 || rename(temporaryPath, path) != 0) {
+        close(fd);
+        remove(temporaryPath);
+        free(temporaryPath);
+        return -1;
+    }
+
+    free(temporaryPath);
+
+    return fd;
+}
+
+/** @brief Otwiera dziennik do dopisywania.
+ * Jeśli @p validSize jest równe @p 0, to tworzy nowy, pusty plik dziennika,
+ * którego pierwszy rekord będzie miał numer @p sequence. W przeciwnym
+ * przypadku obcina plik do @p validSize bajtów (usuwając niedokończony
+ * rekord) i dopisuje na jego końcu rekordy od numeru @p sequence.
+ * @param[in] path              - wskaźnik na ścieżkę do pliku dziennika;
+ * @param[in] checkpointPath    - wskaźnik na ścieżkę do punktu kontrolnego;
+ * @param[in] sequence          - numer następnego rekordu;
+ * @param[in] validSize         - rozmiar poprawnej części pliku lub @p 0.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, jeśli nie udało się
+ * otworzyć pliku lub zaalokować pamięci.
+ */
+Journal *openJournal(const char *path, const char *checkpointPath,
+                     uint64_t sequence, uint64_t validSize) {
+    assert(path);
+    assert(checkpointPath);
+
+    Journal *result = calloc(1, sizeof(Journal));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    result->path = strdup(path);
+    result->checkpointPath = strdup(checkpointPath);
+    result->buffer = malloc(INITIAL_BUFFER_SIZE);
+    if (result->path == NULL || result->checkpointPath == NULL ||
+            result->buffer == NULL) {
+        free(result->path);
+        free(result->checkpointPath);
+        free(result->buffer);
+        free(result);
+        return NULL;
+    }
+    result->reservedMemory = INITIAL_BUFFER_SIZE;
+    result->groupSize = 1;
+    result->sequence = sequence;
+    result->checkpointPid = 0;
+    result->checkpointPipe = -1;
+
+    if (validSize == 0) {
+        result->fd = createFileJournal(path, sequence, -1, 0, 0);
+        result->fileSize = sizeof(JournalHeader);
+    } else {
+        result->fd = open(path, O_RDWR);
+        result->fileSize = validSize;
+        if (result->fd >= 0 && (ftruncate(result->fd, (off_t)validSize) != 0 ||
+                lseek(result->fd, (off_t)validSize, SEEK_SET) < 0)) {
+            close(result->fd);
+            result->fd = -1;
+        }
+    }
+
+    if (result->fd < 0) {
+        free(result->path);
+        free(result->checkpointPath);
+        free(result->buffer);
+        free(result);
+        return NULL;
+    }
+
+    return result;
+}
+
+/** @brief Zamyka dziennik.
+ * Zapisuje niezapisane rekordy. Nic nie robi, jeśli wskaźnik ma wartość
+ * NULL.
+ * @param[in] journal           - wskaźnik na usuwaną strukturę.
+ */
+void closeJournal(Journal *journal) {
+    if (journal == NULL) {
+        return;
+    }
+
+    syncJournal(journal);
+    close(journal->fd);
+
+    free(journal->path);
+    free(journal->checkpointPath);
+    free(journal->buffer);
+    free(journal);
+}
+
+/** @brief Zapisuje niezapisane rekordy i synchronizuje plik.
+ * Jeśli zapis się nie powiedzie, to plik jest obcinany do poprzedniego
+ * rozmiaru, a rekordy pozostają w buforze.
+ * @param[in,out] journal       - wskaźnik na dziennik.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać pliku.
+ */
+bool syncJournal(Journal *journal) {
+    assert(journal);
+
+    if (journal->bufferSize == 0) {
+        return true;
+    }
+
+    if (!writeAllJournal(journal->fd, journal->buffer, journal->bufferSize) ||
+            fdatasync(journal->fd) != 0) {
+        if (ftruncate(journal->fd, (off_t)journal->fileSize) == 0) {
+            lseek(journal->fd, (off_t)journal->fileSize, SEEK_SET);
+        }
+        journal->errorsCount++;
+        return false;
+    }
+
+    journal->fileSize += journal->bufferSize;
+    journal->bufferSize = 0;
+    journal->pendingRecords = 0;
+    journal->syncsCount++;
+
+    return true;
+}
+
+/** @brief Usuwa z dziennika rekordy uwzględnione w punkcie kontrolnym.
+ * Tworzy nowy plik dziennika zaczynający się od rekordu numer @p sequence,
+ * zapisanego w dotychczasowym pliku od pozycji @p offset, kopiuje do niego
+ * dalsze rekordy i zastępuje nim dotychczasowy plik. Niezapisane rekordy
+ * muszą być wcześniej zapisane funkcją @ref syncJournal.
+ * @param[in,out] journal       - wskaźnik na dziennik;
+ * @param[in] offset            - pozycja rekordu numer @p sequence w pliku;
+ * @param[in] sequence          - numer pierwszego rekordu nowego pliku.
+ * @return Wartość @p true lub @p false, jeśli nie udało się utworzyć pliku
+ * (dziennik pozostaje wtedy bez zmian).
+ */
+bool compactJournal(Journal *journal, uint64_t offset, uint64_t sequence) {
+    assert(journal);
+    assert(journal->bufferSize == 0);
+    assert(offset <= journal->fileSize);
+
+    uint64_t size = journal->fileSize - offset;
+    int fd = createFileJournal(journal->path, sequence, journal->fd, offset,
+                               size);
+    if (fd < 0) {
+        journal->errorsCount++;
+        return false;
+    }
+
+    close(journal->fd);
+    journal->fd = fd;
+    journal->fileSize = sizeof(JournalHeader) + size;
+
+    return true;
+}
+
+/** @brief Wyznacza liczbę stron procesu, które przestały być współdzielone.
+ * Odczytuje rozmiar prywatnych, zmodyfikowanych stron procesu
+ * (Private_Dirty z /proc/self/smaps_rollup). W procesie potomnym po
+ * zapisaniu punktu kontrolnego są to strony skopiowane przy zapisie (przez
+ * proces potomny lub rodzica) oraz pamięć zaalokowana przez proces potomny.
+ * @return Liczba stron lub @p 0, jeśli nie udało się jej odczytać.
+ */
+uint64_t privatePagesJournal(void) {
+    FILE *file = fopen("/proc/self/smaps_rollup", "r");
+    if (file == NULL) {
+        return 0;
+    }
+
+    uint64_t kilobytes = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        unsigned long long value;
+        if (sscanf(line, "Private_Dirty: %llu kB", &value) == 1) {
+            kilobytes = value;
+            break;
+        }
+    }
+    fclose(file);
+
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pageSize <= 0) {
+        return 0;
+    }
+
+    return kilobytes * 1024 / (uint64_t)pageSize;
+}
+
+/** @brief Odczytuje czas monotoniczny.
+ * @return Czas w nanosekundach od nieokreślonej chwili.
+ */
+uint64_t nanosecondsJournal(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (uint64_t)time.tv_sec * 1000000000u + (uint64_t)time.tv_nsec;
+}
+
+/** @brief Zapewnia miejsce w buforze rekordów.
+ * @param[in,out] journal       - wskaźnik na dziennik;
+ * @param[in] size              - liczba potrzebnych bajtów.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool reserveJournal(Journal *journal, size_t size) {
+    if (journal->bufferSize + size <= journal->reservedMemory) {
+        return true;
+    }
+
+    size_t reservedMemory = journal->reservedMemory;
+    while (reservedMemory < journal->bufferSize + size) {
+        reservedMemory *= 2;
+    }
+
+    char *buffer = realloc(journal->buffer, reservedMemory);
+    if (buffer == NULL) {
+        return false;
+    }
+
+    journal->buffer = buffer;
+    journal->reservedMemory = reservedMemory;
+
+    return true;
+}
+
+/** @brief Dopisuje dane do budowanego rekordu.
+ * @param[in,out] journal       - wskaźnik na dziennik;
+ * @param[in] data              - wskaźnik na dane;
+ * @param[in] size              - rozmiar danych.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool putDataJournal(Journal *journal, const void *data, size_t size) {
+    if (!reserveJournal(journal, size)) {
+        return false;
+    }
+
+    memcpy(journal->buffer + journal->bufferSize, data, size);
+    journal->bufferSize += size;
+
+    return true;
+}
+
+/** @brief Dopisuje liczbę do budowanego rekordu.
+ * @param[in,out] journal       - wskaźnik na dziennik;
+ * @param[in] value             - liczba.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool putUint32Journal(Journal *journal, uint32_t value) {
+    return putDataJournal(journal, &value, sizeof(uint32_t));
+}
+
+/** @brief Dopisuje napis do budowanego rekordu.
+ * Zapisuje długość napisu (z zerem na końcu) i jego znaki.
+ * @param[in,out] journal       - wskaźnik na dziennik;
+ * @param[in] string            - wskaźnik na napis.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool putStringJournal(Journal *journal, const char *string) {
+    size_t size = strlen(string) + 1;
+
+    return putUint32Journal(journal, (uint32_t)size) &&
+           putDataJournal(journal, string, size);
+}
+
+/** @brief Zaczyna budowanie rekordu w buforze.
+ * @param[in,out] journal       - wskaźnik na dziennik;
+ * @param[in] type              - typ polecenia.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool beginRecordJournal(Journal *journal, JournalRecordType type) {
+    if (!reserveJournal(journal, RECORD_HEADER_SIZE + 1)) {
+        return false;
+    }
+
+    journal->recordStart = journal->bufferSize;
+    journal->bufferSize += RECORD_HEADER_SIZE;
+    journal->buffer[journal->bufferSize++] = (char)type;
+
+    return true;
+}
+
+/** @brief Kończy budowanie rekordu.
+ * Jeśli @p isComplete ma wartość @p false, to usuwa rekord z bufora.
+ * W przeciwnym przypadku uzupełnia rozmiar i sumę kontrolną rekordu,
+ * a jeśli w buforze jest pełna grupa rekordów, to zapisuje je do pliku.
+ * @param[in,out] journal       - wskaźnik na dziennik;
+ * @param[in] isComplete        - czy udało się zbudować cały rekord.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zbudować rekordu
+ * lub zapisać grupy rekordów.
+ */
+bool endRecordJournal(Journal *journal, bool isComplete) {
+    if (!isComplete) {
+        journal->bufferSize = journal->recordStart;
+        journal->errorsCount++;
+        return false;
+    }
+
+    char *record = journal->buffer + journal->recordStart;
+    size_t payloadStart = journal->recordStart + RECORD_HEADER_SIZE;
+    uint32_t header[2];
+    header[0] = (uint32_t)(journal->bufferSize - payloadStart);
+    header[1] = checksumJournal(journal->buffer + payloadStart, header[0]);
+    memcpy(record, header, RECORD_HEADER_SIZE);
+
+    journal->pendingRecords++;
+    journal->recordsCount++;
+    journal->sequence++;
+    journal->recordsSinceCheckpoint++;
+
+    if (journal->pendingRecords >= journal->groupSize) {
+        return syncJournal(journal);
+    }
+
+    return true;
+}
+
+/** @brief Dopisuje polecenie dotyczące odcinka drogi.
+ * Rekord zapisywany jest do pliku razem z grupą rekordów.
+ * @param[in,out] journal       - wskaźnik na dziennik;
+ * @param[in] type              - typ polecenia;
+ * @param[in] cityName1         - wskaźnik na nazwę pierwszego miasta;
+ * @param[in] cityName2         - wskaźnik na nazwę drugiego miasta;
+ * @param[in] length            - długość odcinka lub @p 0;
+ * @param[in] year              - rok budowy lub remontu lub @p 0.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać rekordu.
+ */
+bool appendRoadJournal(Journal *journal, JournalRecordType type,
+                       const char *cityName1, const char *cityName2,
+                       uint32_t length, int32_t year) {
+    assert(journal);
+    assert(cityName1);
+    assert(cityName2);
+
+    if (!beginRecordJournal(journal, type)) {
+        journal->errorsCount++;
+        return false;
+    }
+
+    return endRecordJournal(journal, putStringJournal(journal, cityName1) &&
+                                     putStringJournal(journal, cityName2) &&
+                                     putUint32Journal(journal, length) &&
+                                     putUint32Journal(journal, (uint32_t)year));
+}
+
+/** @brief Dopisuje polecenie dotyczące drogi krajowej.
+ * Rekord zapisywany jest do pliku razem z grupą rekordów.
+ * @param[in,out] journal       - wskaźnik na dziennik;
+ * @param[in] type              - typ polecenia;
+ * @param[in] routeId           - numer drogi krajowej;
+ * @param[in] cityName1         - wskaźnik na nazwę pierwszego miasta lub NULL;
+ * @param[in] cityName2         - wskaźnik na nazwę drugiego miasta lub NULL.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać rekordu.
+ */
+bool appendRouteJournal(Journal *journal, JournalRecordType type,
+                        uint32_t routeId, const char *cityName1,
+                        const char *cityName2) {
+    assert(journal);
+
+    if (!beginRecordJournal(journal, type)) {
+        journal->errorsCount++;
+        return false;
+    }
+
+    bool result = putUint32Journal(journal, routeId);
+    if (result && cityName1 != NULL) {
+        result = putStringJournal(journal, cityName1);
+    }
+    if (result && cityName2 != NULL) {
+        result = putStringJournal(journal, cityName2);
+    }
+
+    return endRecordJournal(journal, result);
+}
+
+/** @brief Dopisuje drogę krajową podaną przez kolejne miasta.
+ * @param[in,out] journal       - wskaźnik na dziennik;
+ * @param[in] routeId           - numer drogi krajowej;
+ * @param[in] cities            - wskaźnik na listę miast drogi krajowej.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać rekordu.
+ */
+bool appendRouteDefinitionJournal(Journal *journal, uint32_t routeId,
+                                  List *cities) {
+    assert(journal);
+    assert(cities);
+
+    if (!beginRecordJournal(journal, JOURNAL_ROUTE_DEFINITION)) {
+        journal->errorsCount++;
+        return false;
+    }
+
+    bool result = putUint32Journal(journal, routeId) &&
+                  putUint32Journal(journal, sizeList(cities));
+
+    ListIterator *iterator = cities->begin;
+    while (result && iterator != cities->end) {
+        City *city = iterator->data;
+        result = putStringJournal(journal, city->name);
+        iterator = iterator->next;
+    }
+
+    return endRecordJournal(journal, result);
+}
+
+/** @brief Dopisuje usunięcie wielu odcinków dróg.
+ * Partia zapisywana jest jednym rekordem, bo jej objazdy różnią się od
+ * objazdów kolejnych wywołań @ref removeRoad.
+ * @param[in,out] journal       - wskaźnik na dziennik;
+ * @param[in] cityNames         - wskaźnik na tablicę @p 2 * @p count opisów
+ *                                nazw końców odcinków;
+ * @param[in] count             - liczba odcinków.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać rekordu.
+ */
+bool appendRoadsJournal(Journal *journal, const CityName *cityNames,
+                        uint32_t count) {
+    assert(journal);
+    assert(cityNames);
+
+    if (!beginRecordJournal(journal, JOURNAL_REMOVE_ROADS)) {
+        journal->errorsCount++;
+        return false;
+    }
+
+    bool result = putUint32Journal(journal, count);
+    for (uint32_t i = 0; result && i < 2 * count; i++) {
+        result = putStringJournal(journal, cityNames[i].name);
+    }
+
+    return endRecordJournal(journal, result);
+}
+
+/** @brief Odczytuje liczbę z danych rekordu.
+ * @param[in,out] reader        - wskaźnik na stan odczytu;
+ * @param[out] value            - wskaźnik na odczytaną liczbę.
+ * @return Wartość @p true lub @p false, jeśli dane się skończyły.
+ */
+bool readUint32Journal(JournalReader *reader, uint32_t *value) {
+    if (reader->size - reader->position < sizeof(uint32_t)) {
+        return false;
+    }
+
+    memcpy(value, reader->data + reader->position, sizeof(uint32_t));
+    reader->position += sizeof(uint32_t);
+
+    return true;
+}
+
+/** @brief Odczytuje napis z danych rekordu.
+ * Napis nie jest kopiowany.
+ * @param[in,out] reader        - wskaźnik na stan odczytu;
+ * @param[out] string           - wskaźnik na odczytany napis.
+ * @return Wartość @p true lub @p false, jeśli dane się skończyły lub napis
+ * nie kończy się zerem.
+ */
+bool readStringJournal(JournalReader *reader, const char **string) {
+    uint32_t size;
+    if (!readUint32Journal(reader, &size) || size == 0 ||
+            reader->size - reader->position < size ||
+            reader->data[reader->position + size - 1] != 0) {
+        return false;
+    }
+
+    *string = reader->data + reader->position;
+    reader->position += size;
+
+    return true;
+}
+
+/** @brief Odtwarza drogę krajową podaną przez kolejne miasta.
+ * Odcinki drogi krajowej zostały dodane wcześniejszymi rekordami.
+ * @param[in,out] map           - wskaźnik na mapę;
+ * @param[in,out] reader        - wskaźnik na stan odczytu danych rekordu.
+ * @return Wartość @p true lub @p false, jeśli rekord jest niepoprawny.
+ */
+bool replayRouteDefinitionJournal(Map *map, JournalReader *reader) {
+    uint32_t routeId, citiesCount;
+    const char *cityName;
+    if (!readUint32Journal(reader, &routeId) ||
+            !readUint32Journal(reader, &citiesCount) || citiesCount == 0 ||
+            !readStringJournal(reader, &cityName)) {
+        return false;
+    }
+
+    City *previousCity = findCityOnHashMap(map->citiesMap, cityName);
+    if (previousCity == NULL ||
+            findRouteOnList(map->routes, routeId) != NULL) {
+        return false;
+    }
+
+    Route *route = newRouteModule(routeId, previousCity, previousCity,
+                                  map->searchState);
+    if (route == NULL) {
+        return true;
+    }
+
+    for (uint32_t i = 1; i < citiesCount; i++) {
+        if (!readStringJournal(reader, &cityName)) {
+            deleteRouteModule(route);
+            return false;
+        }
+
+        City *city = findCityOnHashMap(map->citiesMap, cityName);
+        if (city == NULL || findRoadModule(previousCity, city) == NULL) {
+            deleteRouteModule(route);
+            return false;
+        }
+
+        if (insertList(route->cities->end, city) == NULL) {
+            deleteRouteModule(route);
+            return true;
+        }
+
+        previousCity = city;
+    }
+
+    if (insertList(map->routes->end, route) == NULL) {
+        deleteRouteModule(route);
+    }
+
+    return true;
+}
+
+/** @brief Odtwarza usunięcie wielu odcinków dróg.
+ * @param[in,out] map           - wskaźnik na mapę;
+ * @param[in,out] reader        - wskaźnik na stan odczytu danych rekordu.
+ * @return Wartość @p true lub @p false, jeśli rekord jest niepoprawny.
+ */
+bool replayRoadsJournal(Map *map, JournalReader *reader) {
+    uint32_t count;
+    if (!readUint32Journal(reader, &count) || count == 0 ||
+            count > (reader->size - reader->position) / 2) {
+        return false;
+    }
+
+    const char **cityNames = malloc(sizeof(const char *) * 2 * count);
+    if (cityNames == NULL) {
+        return true;
+    }
+
+    for (uint32_t i = 0; i < 2 * count; i++) {
+        if (!readStringJournal(reader, &cityNames[i])) {
+            free(cityNames);
+            return false;
+        }
+    }
+
+    removeRoads(map, cityNames, count);
+    free(cityNames);
+
+    return true;
+}
+
+/** @brief Odtwarza jeden rekord dziennika.
+ * Wywołuje funkcję mapy odpowiadającą poleceniu. Polecenie zakończyło się
+ * sukcesem przy zapisie, więc wynik funkcji nie jest sprawdzany (może być
+ * błędny tylko z braku pamięci).
+ * @param[in,out] map           - wskaźnik na mapę;
+ * @param[in] data              - wskaźnik na typ i dane rekordu;
+ * @param[in] size              - rozmiar typu i danych rekordu.
+ * @return Wartość @p true lub @p false, jeśli rekord jest niepoprawny.
+ */
+bool replayRecordJournal(Map *map, const char *data, size_t size) {
+    JournalReader reader;
+    reader.data = data + 1;
+    reader.size = size - 1;
+    reader.position = 0;
+
+    const char *cityName1, *cityName2;
+    uint32_t length, year, routeId;
+    JournalRecordType type = (JournalRecordType)(unsigned char)data[0];
+    switch (type) {
+        case JOURNAL_ADD_ROAD:
+        case JOURNAL_REPAIR_ROAD:
+        case JOURNAL_UPDATE_ROAD:
+        case JOURNAL_REMOVE_ROAD:
+            if (!readStringJournal(&reader, &cityName1) ||
+                    !readStringJournal(&reader, &cityName2) ||
+                    !readUint32Journal(&reader, &length) ||
+                    !readUint32Journal(&reader, &year)) {
+                return false;
+            }
+
+            if (type == JOURNAL_ADD_ROAD) {
+                addRoad(map, cityName1, cityName2, length, (int)year);
+            } else if (type == JOURNAL_REPAIR_ROAD) {
+                repairRoad(map, cityName1, cityName2, (int)year);
+            } else if (type == JOURNAL_UPDATE_ROAD) {
+                updateRoad(map, cityName1, cityName2, length, (int)year);
+            } else {
+                removeRoad(map, cityName1, cityName2);
+            }
+            break;
+        case JOURNAL_NEW_ROUTE:
+            if (!readUint32Journal(&reader, &routeId) ||
+                    !readStringJournal(&reader, &cityName1) ||
+                    !readStringJournal(&reader, &cityName2)) {
+                return false;
+            }
+
+            newRoute(map, routeId, cityName1, cityName2);
+            break;
+        case JOURNAL_EXTEND_ROUTE:
+            if (!readUint32Journal(&reader, &routeId) ||
+                    !readStringJournal(&reader, &cityName1)) {
+                return false;
+            }
+
+            extendRoute(map, routeId, cityName1);
+            break;
+        case JOURNAL_REMOVE_ROUTE:
+            if (!readUint32Journal(&reader, &routeId)) {
+                return false;
+            }
+
+            removeRoute(map, routeId);
+            break;
+        case JOURNAL_ROUTE_DEFINITION:
+            if (!replayRouteDefinitionJournal(map, &reader)) {
+                return false;
+            }
+            break;
+        case JOURNAL_REMOVE_ROADS:
+            if (!replayRoadsJournal(map, &reader)) {
+                return false;
+            }
+            break;
+        default:
+            return false;
+    }
+
+    return reader.position == reader.size;
+}
+
+/** @brief Odtwarza polecenia z dziennika.
+ * Pomija rekordy o numerach mniejszych niż @p sequence (uwzględnione
+ * w punkcie kontrolnym) i wykonuje pozostałe. Odtwarzanie kończy się na
+ * końcu pliku lub na pierwszym niedokończonym lub uszkodzonym rekordzie.
+ * Jeśli plik nie ma poprawnego nagłówka lub kończy się przed rekordem
+ * numer @p sequence, to dziennik jest pomijany. Mapa nie może mieć
+ * dołączonego dziennika.
+ * @param[in,out] map           - wskaźnik na mapę z punktu kontrolnego;
+ * @param[in,out] file          - wskaźnik na plik dziennika;
+ * @param[in,out] sequence      - wskaźnik na numer pierwszego rekordu
+ *                                nieuwzględnionego w punkcie kontrolnym;
+ *                                po odtworzeniu numer następnego rekordu;
+ * @param[out] validSize        - rozmiar poprawnej części pliku lub @p 0,
+ *                                jeśli dziennik pominięto;
+ * @param[out] replayedCount    - liczba odtworzonych rekordów.
+ * @return Wartość @p true lub @p false, jeśli dziennik zaczyna się po
+ * rekordzie numer @p sequence (brakuje rekordów między punktem kontrolnym
+ * a dziennikiem).
+ */
+bool replayJournal(Map *map, FILE *file, uint64_t *sequence,
+                   uint64_t *validSize, uint64_t *replayedCount) {
+    assert(map);
+    assert(map->journal == NULL);
+    assert(file);
+    assert(sequence);
+    assert(validSize);
+    assert(replayedCount);
+
+    *validSize = 0;
+    *replayedCount = 0;
+
+    JournalHeader header;
+    if (fread(&header, sizeof(JournalHeader), 1, file) != 1 ||
+            header.magic != JOURNAL_MAGIC ||
+            header.version != JOURNAL_VERSION) {
+        return true;
+    }
+    if (header.firstSequence > *sequence) {
+        return false;
+    }
+
+    uint64_t size = sizeof(JournalHeader);
+    uint64_t recordSequence = header.firstSequence;
+    char *data = NULL;
+    size_t reservedMemory = 0;
+    uint32_t recordHeader[2];
+    while (fread(recordHeader, RECORD_HEADER_SIZE, 1, file) == 1) {
+        uint32_t recordSize = recordHeader[0];
+        if (recordSize == 0) {
+            break;
+        }
+
+        if (recordSize > reservedMemory) {
+            char *newData = realloc(data, recordSize);
+            if (newData == NULL) {
+                break;
+            }
+            data = newData;
+            reservedMemory = recordSize;
+        }
+
+        if (fread(data, recordSize, 1, file) != 1 ||
+                checksumJournal(data, recordSize) != recordHeader[1]) {
+            break;
+        }
+
+        /* Rekordy sprzed punktu kontrolnego są już na mapie. */
+        if (recordSequence >= *sequence) {
+            if (!replayRecordJournal(map, data, recordSize)) {
+                break;
+            }
+            (*replayedCount)++;
+        }
+
+        size += RECORD_HEADER_SIZE + recordSize;
+        recordSequence++;
+    }
+
+    free(data);
+
+    if (recordSequence >= *sequence) {
+        *validSize = size;
+        *sequence = recordSequence;
+    }
+
+    return true;
+}
@@ -0,0 +1,233 @@
+/** @file
+ * Interfejs klasy przechowującej dziennik poleceń modyfikujących mapę.
+ *
+ * Plik dziennika zaczyna się nagłówkiem @ref JournalHeader, po którym
+ * następują rekordy: rozmiar typu i danych (4 bajty), ich suma kontrolna
+ * (4 bajty), typ polecenia (1 bajt) i dane. Liczby zapisywane są jako liczby
+ * 32-bitowe w kolejności bajtów komputera, a napisy jako długość i znaki
+ * zakończone zerem. Rekordy mają kolejne numery, począwszy od numeru
+ * zapisanego w nagłówku. Punkt kontrolny (obraz mapy zapisany funkcją
+ * @ref saveMap) zawiera numer pierwszego rekordu, którego nie uwzględnia,
+ * więc przy odtwarzaniu wcześniejsze rekordy są pomijane.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "list.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#define JOURNAL_MAGIC 0x4c4e524au
+///< liczba rozpoznająca dziennik (i kolejność bajtów)
+
+#define JOURNAL_VERSION 2u
+///< wersja formatu dziennika
+
+typedef struct Map Map;
+typedef struct CityName CityName;
+
+/**
+ * Typy poleceń zapisywanych w dzienniku.
+ */
+typedef enum JournalRecordType {
+    JOURNAL_ADD_ROAD = 1,           ///< @ref addRoad
+    JOURNAL_REPAIR_ROAD,            ///< @ref repairRoad
+    JOURNAL_UPDATE_ROAD,            ///< @ref updateRoad
+    JOURNAL_REMOVE_ROAD,            ///< @ref removeRoad
+    JOURNAL_NEW_ROUTE,              ///< @ref newRoute
+    JOURNAL_EXTEND_ROUTE,           ///< @ref extendRoute
+    JOURNAL_REMOVE_ROUTE,           ///< @ref removeRoute
+    JOURNAL_ROUTE_DEFINITION,       ///< droga krajowa podana przez miasta
+    JOURNAL_REMOVE_ROADS            ///< @ref removeRoads
+} JournalRecordType;
+
+/**
+ * Struktura przechowująca nagłówek pliku dziennika.
+ */
+typedef struct JournalHeader {
+    uint32_t magic;                 ///< @ref JOURNAL_MAGIC
+    uint32_t version;               ///< @ref JOURNAL_VERSION
+    uint64_t firstSequence;         ///< numer pierwszego rekordu
+} JournalHeader;
+
+/**
+ * Struktura przechowująca otwarty dziennik. Rekordy gromadzone są
+ * w buforze i zapisywane grupami (wraz z synchronizacją pliku), co
+ * rozkłada koszt synchronizacji na wiele poleceń.
+ */
+typedef struct Journal {
+    int fd;                         ///< deskryptor pliku dziennika
+    char *path;                     ///< ścieżka do pliku dziennika
+    char *checkpointPath;           ///< ścieżka do punktu kontrolnego
+    char *buffer;                   ///< niezapisane rekordy
+    size_t bufferSize;              ///< rozmiar niezapisanych rekordów
+    size_t reservedMemory;          ///< rozmiar bufora
+    size_t recordStart;             ///< początek budowanego rekordu w buforze
+    uint64_t fileSize;              ///< rozmiar zapisanej części pliku
+    uint64_t sequence;              ///< numer następnego rekordu
+    uint32_t pendingRecords;        ///< liczba niezapisanych rekordów
+    uint32_t groupSize;             ///< liczba rekordów zapisywanych naraz
+    uint32_t checkpointInterval;    ///< liczba rekordów między punktami
+    uint32_t recordsSinceCheckpoint;    ///< rekordy od punktu kontrolnego
+    uint64_t recordsCount;          ///< liczba dopisanych rekordów
+    uint64_t syncsCount;            ///< liczba synchronizacji pliku
+    uint64_t checkpointsCount;      ///< liczba punktów kontrolnych
+    uint64_t replayedCount;         ///< liczba odtworzonych rekordów
+    uint64_t errorsCount;           ///< liczba nieudanych zapisów
+    bool isBackground;              ///< czy punkty kontrolne zapisuje proces
+                                    ///< potomny
+    pid_t checkpointPid;            ///< proces zapisujący punkt kontrolny
+                                    ///< lub @p 0
+    int checkpointPipe;             ///< odczyt wyników procesu potomnego
+    uint64_t checkpointOffset;      ///< rozmiar pliku w chwili rozwidlenia
+    uint64_t checkpointSequence;    ///< numer rekordu w chwili rozwidlenia
+    uint64_t backgroundCount;       ///< liczba punktów zapisanych w tle
+    uint64_t forkNanoseconds;       ///< łączny czas wywołań fork
+    uint64_t maxForkNanoseconds;    ///< najdłuższy czas wywołania fork
+    uint64_t snapshotNanoseconds;   ///< łączny czas zapisu w tle
+    uint64_t copiedPages;           ///< strony skopiowane przy zapisie w tle
+} Journal;
+
+/**
+ * Struktura przechowująca wyniki procesu zapisującego punkt kontrolny.
+ */
+typedef struct JournalCheckpointReport {
+    uint64_t nanoseconds;           ///< czas zapisu punktu kontrolnego
+    uint64_t copiedPages;           ///< strony procesu potomnego, które
+                                    ///< przestały być współdzielone
+} JournalCheckpointReport;
+
+/** @brief Otwiera dziennik do dopisywania.
+ * Jeśli @p validSize jest równe @p 0, to tworzy nowy, pusty plik dziennika,
+ * którego pierwszy rekord będzie miał numer @p sequence. W przeciwnym
+ * przypadku obcina plik do @p validSize bajtów (usuwając niedokończony
+ * rekord) i dopisuje na jego końcu rekordy od numeru @p sequence.
+ * @param[in] path              - wskaźnik na ścieżkę do pliku dziennika;
+ * @param[in] checkpointPath    - wskaźnik na ścieżkę do punktu kontrolnego;
+ * @param[in] sequence          - numer następnego rekordu;
+ * @param[in] validSize         - rozmiar poprawnej części pliku lub @p 0.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, jeśli nie udało się
+ * otworzyć pliku lub zaalokować pamięci.
+ */
+Journal *openJournal(const char *path, const char *checkpointPath,
+                     uint64_t sequence, uint64_t validSize);
+
+/** @brief Zamyka dziennik.
+ * Zapisuje niezapisane rekordy. Nic nie robi, jeśli wskaźnik ma wartość
+ * NULL.
+ * @param[in] journal           - wskaźnik na usuwaną strukturę.
+ */
+void closeJournal(Journal *journal);
+
+/** @brief Zapisuje niezapisane rekordy i synchronizuje plik.
+ * @param[in,out] journal       - wskaźnik na dziennik.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać pliku.
+ */
+bool syncJournal(Journal *journal);
+
+/** @brief Usuwa z dziennika rekordy uwzględnione w punkcie kontrolnym.
+ * Tworzy nowy plik dziennika zaczynający się od rekordu numer @p sequence,
+ * zapisanego w dotychczasowym pliku od pozycji @p offset, kopiuje do niego
+ * dalsze rekordy i zastępuje nim dotychczasowy plik. Niezapisane rekordy
+ * muszą być wcześniej zapisane funkcją @ref syncJournal.
+ * @param[in,out] journal       - wskaźnik na dziennik;
+ * @param[in] offset            - pozycja rekordu numer @p sequence w pliku;
+ * @param[in] sequence          - numer pierwszego rekordu nowego pliku.
+ * @return Wartość @p true lub @p false, jeśli nie udało się utworzyć pliku
+ * (dziennik pozostaje wtedy bez zmian).
+ */
+bool compactJournal(Journal *journal, uint64_t offset, uint64_t sequence);
+
+/** @brief Wyznacza liczbę stron procesu, które przestały być współdzielone.
+ * Odczytuje rozmiar prywatnych, zmodyfikowanych stron procesu
+ * (Private_Dirty z /proc/self/smaps_rollup). W procesie potomnym po
+ * zapisaniu punktu kontrolnego są to strony skopiowane przy zapisie (przez
+ * proces potomny lub rodzica) oraz pamięć zaalokowana przez proces potomny.
+ * @return Liczba stron lub @p 0, jeśli nie udało się jej odczytać.
+ */
+uint64_t privatePagesJournal(void);
+
+/** @brief Odczytuje czas monotoniczny.
+ * @return Czas w nanosekundach od nieokreślonej chwili.
+ */
+uint64_t nanosecondsJournal(void);
+
+/** @brief Dopisuje polecenie dotyczące odcinka drogi.
+ * Rekord zapisywany jest do pliku razem z grupą rekordów.
+ * @param[in,out] journal       - wskaźnik na dziennik;
+ * @param[in] type              - typ polecenia;
+ * @param[in] cityName1         - wskaźnik na nazwę pierwszego miasta;
+ * @param[in] cityName2         - wskaźnik na nazwę drugiego miasta;
+ * @param[in] length            - długość odcinka lub @p 0;
+ * @param[in] year              - rok budowy lub remontu lub @p 0.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać rekordu.
+ */
+bool appendRoadJournal(Journal *journal, JournalRecordType type,
+                       const char *cityName1, const char *cityName2,
+                       uint32_t length, int32_t year);
+
+/** @brief Dopisuje polecenie dotyczące drogi krajowej.
+ * Rekord zapisywany jest do pliku razem z grupą rekordów.
+ * @param[in,out] journal       - wskaźnik na dziennik;
+ * @param[in] type              - typ polecenia;
+ * @param[in] routeId           - numer drogi krajowej;
+ * @param[in] cityName1         - wskaźnik na nazwę pierwszego miasta lub NULL;
+ * @param[in] cityName2         - wskaźnik na nazwę drugiego miasta lub NULL.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać rekordu.
+ */
+bool appendRouteJournal(Journal *journal, JournalRecordType type,
+                        uint32_t routeId, const char *cityName1,
+                        const char *cityName2);
+
+/** @brief Dopisuje drogę krajową podaną przez kolejne miasta.
+ * @param[in,out] journal       - wskaźnik na dziennik;
+ * @param[in] routeId           - numer drogi krajowej;
+ * @param[in] cities            - wskaźnik na listę miast drogi krajowej.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać rekordu.
+ */
+bool appendRouteDefinitionJournal(Journal *journal, uint32_t routeId,
+                                  List *cities);
+
+/** @brief Dopisuje usunięcie wielu odcinków dróg.
+ * Partia zapisywana jest jednym rekordem, bo jej objazdy różnią się od
+ * objazdów kolejnych wywołań @ref removeRoad.
+ * @param[in,out] journal       - wskaźnik na dziennik;
+ * @param[in] cityNames         - wskaźnik na tablicę @p 2 * @p count opisów
+ *                                nazw końców odcinków;
+ * @param[in] count             - liczba odcinków.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać rekordu.
+ */
+bool appendRoadsJournal(Journal *journal, const CityName *cityNames,
+                        uint32_t count);
+
+/** @brief Odtwarza polecenia z dziennika.
+ * Pomija rekordy o numerach mniejszych niż @p sequence (uwzględnione
+ * w punkcie kontrolnym) i wykonuje pozostałe. Odtwarzanie kończy się na
+ * końcu pliku lub na pierwszym niedokończonym lub uszkodzonym rekordzie.
+ * Jeśli plik nie ma poprawnego nagłówka lub kończy się przed rekordem
+ * numer @p sequence, to dziennik jest pomijany. Mapa nie może mieć
+ * dołączonego dziennika.
+ * @param[in,out] map           - wskaźnik na mapę z punktu kontrolnego;
+ * @param[in,out] file          - wskaźnik na plik dziennika;
+ * @param[in,out] sequence      - wskaźnik na numer pierwszego rekordu
+ *                                nieuwzględnionego w punkcie kontrolnym;
+ *                                po odtworzeniu numer następnego rekordu;
+ * @param[out] validSize        - rozmiar poprawnej części pliku lub @p 0,
+ *                                jeśli dziennik pominięto;
+ * @param[out] replayedCount    - liczba odtworzonych rekordów.
+ * @return Wartość @p true lub @p false, jeśli dziennik zaczyna się po
+ * rekordzie numer @p sequence (brakuje rekordów między punktem kontrolnym
+ * a dziennikiem).
+ */
+bool replayJournal(Map *map, FILE *file, uint64_t *sequence,
+                   uint64_t *validSize, uint64_t *replayedCount);
+
+#endif // JOURNAL_H
@@ -0,0 +1,418 @@
+/** @file
+ * Implementacja interfejsu klasy przechowującej indeks punktów orientacyjnych.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "landmark_index.h"
+#include "route.h"
+#include "heap.h"
+#include "road.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define REBUILD_REMOVED_ROADS_RATIO 8
+///< indeks jest przebudowywany po usunięciu tej części (1/n) odcinków dróg
+
+/** @brief Tworzy strukturę.
+ * Tworzy pusty (niezbudowany) indeks punktów orientacyjnych.
+ * @param[in] listOfCities      - wskaźnik na wszystkie miasta na mapie;
+ * @param[in] citiesMap         - wskaźnik na haszmapę miast na mapie;
+ * @param[in] landmarksCount    - liczba punktów orientacyjnych.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci.
+ */
+LandmarkIndex *newLandmarkIndex(List *listOfCities, HashMap *citiesMap,
+                                uint32_t landmarksCount) {
+    assert(listOfCities);
+    assert(citiesMap);
+
+    LandmarkIndex *result = calloc(1, sizeof(LandmarkIndex));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    result->landmarksNames = newList();
+    if (result->landmarksNames == NULL) {
+        free(result);
+        return NULL;
+    }
+
+    result->listOfCities = listOfCities;
+    result->citiesMap = citiesMap;
+    result->landmarksCount = landmarksCount;
+    result->isValid = false;
+
+    return result;
+}
+
+/** @brief Usuwa strukturę.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] index             - wskaźnik na usuwaną strukturę.
+ */
+void deleteLandmarkIndex(LandmarkIndex *index) {
+    if (index == NULL) {
+        return;
+    }
+
+    deleteList(index->landmarksNames, true);
+    free(index->landmarks);
+    free(index->distances);
+    free(index);
+}
+
+/** @brief Ustawia liczbę punktów orientacyjnych.
+ * Punkty wybrane przez użytkownika są zawsze używane, a brakujące punkty
+ * wybierane są automatycznie (kolejno miasta najbardziej odległe od już
+ * wybranych). Indeks zostanie przebudowany przy najbliższym odświeżeniu.
+ * @param[in,out] index         - wskaźnik na indeks;
+ * @param[in] landmarksCount    - liczba punktów orientacyjnych.
+ */
+void setLandmarksCountLandmarkIndex(LandmarkIndex *index,
+                                    uint32_t landmarksCount) {
+    assert(index);
+
+    index->landmarksCount = landmarksCount;
+    index->isValid = false;
+}
+
+/** @brief Dodaje miasto do punktów orientacyjnych.
+ * Miasto nie musi jeszcze istnieć, jest wyszukiwane przy budowie indeksu.
+ * Indeks zostanie przebudowany przy najbliższym odświeżeniu.
+ * @param[in,out] index         - wskaźnik na indeks;
+ * @param[in] cityName          - wskaźnik na nazwę miasta.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool addLandmarkLandmarkIndex(LandmarkIndex *index, const char *cityName) {
+    assert(index);
+    assert(cityName);
+
+    char *nameCopy = malloc(sizeof(char) * (strlen(cityName) + 1));
+    if (nameCopy == NULL) {
+        return false;
+    }
+    strcpy(nameCopy, cityName);
+
+    if (insertList(index->landmarksNames->end, nameCopy) == NULL) {
+        free(nameCopy);
+        return false;
+    }
+
+    index->isValid = false;
+
+    return true;
+}
+
+/** @brief Oznacza indeks jako nieaktualny.
+ * Należy wywołać po dodaniu odcinka drogi do mapy.
+ * @param[in,out] index         - wskaźnik na indeks.
+ */
+void invalidateLandmarkIndex(LandmarkIndex *index) {
+    assert(index);
+
+    index->isValid = false;
+}
+
+/** @brief Odnotowuje usunięcie odcinka drogi.
+ * Indeks pozostaje poprawny, ale po usunięciu wielu odcinków zostanie
+ * przebudowany przy najbliższym odświeżeniu, aby ograniczenia nie były zbyt
+ * słabe.
+ * @param[in,out] index         - wskaźnik na indeks.
+ */
+void removedRoadLandmarkIndex(LandmarkIndex *index) {
+    assert(index);
+
+    index->removedRoadsCount++;
+}
+
+/** @brief Liczy odległości od punktu orientacyjnego.
+ * Algorytmem dijkstry liczy odległości od miasta @p landmark do wszystkich
+ * miast na mapie.
+ * @param[in] landmark          - wskaźnik na punkt orientacyjny;
+ * @param[out] distances        - tablica odległości indeksowana numerami
+ *                                miast;
+ * @param[in] citiesCount       - liczba miast na mapie.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool distancesFromLandmarkIndex(City *landmark, int64_t *distances,
+                                uint32_t citiesCount) {
+    for (uint32_t i = 0; i < citiesCount; i++) {
+        distances[i] = INFINITY;
+    }
+
+    Heap *heap = newHeap();
+    if (heap == NULL) {
+        return false;
+    }
+
+    distances[landmark->id] = 0;
+    if (!pushHeap(heap, 0, 0, landmark)) {
+        deleteHeap(heap);
+        return false;
+    }
+
+    while (heap->size != 0) {
+        City *ptr = heap->data[1];
+        if (heap->keys[1]->distance != distances[ptr->id]) {
+            popHeap(heap);
+            continue;
+        }
+        popHeap(heap);
+
+        ListIterator *iterator = ptr->roads->begin;
+        while (iterator != ptr->roads->end) {
+            Road *road = iterator->data;
+            iterator = iterator->next;
+
+            if (road->isDeleted) {
+                continue;
+            }
+
+            int64_t distance = distances[ptr->id] + road->length;
+            if (distance < distances[road->destination->id]) {
+                distances[road->destination->id] = distance;
+                if (!pushHeap(heap, distance, 0, road->destination)) {
+                    deleteHeap(heap);
+                    return false;
+                }
+            }
+        }
+    }
+
+    deleteHeap(heap);
+
+    return true;
+}
+
+/** @brief Wybiera miasto najbardziej odległe od punktów orientacyjnych.
+ * Miasta nieosiągalne z żadnego punktu są najbardziej odległe, dzięki czemu
+ * każda spójna składowa mapy dostaje własny punkt orientacyjny.
+ * @param[in] index             - wskaźnik na indeks;
+ * @param[in] minDistance       - odległości miast od najbliższego punktu.
+ * @return Wskaźnik na wybrane miasto lub NULL, jeśli wszystkie miasta są już
+ * punktami orientacyjnymi.
+ */
+City *farthestCityLandmarkIndex(LandmarkIndex *index, int64_t *minDistance) {
+    City *result = NULL;
+    int64_t resultDistance = 0;
+
+    ListIterator *iterator = index->listOfCities->begin;
+    while (iterator != index->listOfCities->end) {
+        City *city = iterator->data;
+        if (minDistance[city->id] > resultDistance) {
+            result = city;
+            resultDistance = minDistance[city->id];
+        }
+        iterator = iterator->next;
+    }
+
+    return result;
+}
+
+/** @brief Dodaje punkt orientacyjny do budowanego indeksu.
+ * Liczy odległości od punktu i uaktualnia odległości miast od najbliższego
+ * punktu.
+ * @param[in,out] index         - wskaźnik na indeks;
+ * @param[in] landmark          - wskaźnik na punkt orientacyjny;
+ * @param[in,out] minDistance   - odległości miast od najbliższego punktu.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool addBuiltLandmarkLandmarkIndex(LandmarkIndex *index, City *landmark,
+                                   int64_t *minDistance) {
+    int64_t *distances = index->distances +
+                         (size_t)index->builtLandmarksCount * index->citiesCount;
+    if (!distancesFromLandmarkIndex(landmark, distances, index->citiesCount)) {
+        return false;
+    }
+
+    index->landmarks[index->builtLandmarksCount++] = landmark;
+    for (uint32_t i = 0; i < index->citiesCount; i++) {
+        minDistance[i] = minInt64_t(minDistance[i], distances[i]);
+    }
+
+    return true;
+}
+
+/** @brief Buduje indeks.
+ * Najpierw dodaje punkty wybrane przez użytkownika, a następnie kolejno
+ * miasta najbardziej odległe od już wybranych punktów.
+ * @param[in,out] index         - wskaźnik na indeks.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool buildLandmarkIndex(LandmarkIndex *index) {
+    index->isValid = false;
+    index->builtLandmarksCount = 0;
+    index->citiesCount = countCitiesOnList(index->listOfCities);
+    index->removedRoadsCount = 0;
+    index->roadsCount = 0;
+
+    uint32_t landmarksCount = sizeList(index->landmarksNames);
+    if (landmarksCount < index->landmarksCount) {
+        landmarksCount = index->landmarksCount;
+    }
+    if (landmarksCount > index->citiesCount) {
+        landmarksCount = index->citiesCount;
+    }
+
+    free(index->landmarks);
+    free(index->distances);
+    index->landmarks = malloc(sizeof(City *) * (landmarksCount + 1));
+    index->distances = malloc(sizeof(int64_t) * (landmarksCount + 1) *
+                              ((size_t)index->citiesCount + 1));
+    int64_t *minDistance = malloc(sizeof(int64_t) *
+                                  ((size_t)index->citiesCount + 1));
+    if (index->landmarks == NULL || index->distances == NULL ||
+            minDistance == NULL) {
+        free(minDistance);
+        return false;
+    }
+
+    for (uint32_t i = 0; i < index->citiesCount; i++) {
+        minDistance[i] = INFINITY;
+    }
+
+    ListIterator *iterator = index->listOfCities->begin;
+    while (iterator != index->listOfCities->end) {
+        index->roadsCount += sizeList(((City *)iterator->data)->roads);
+        iterator = iterator->next;
+    }
+    index->roadsCount /= 2;
+
+    /* Punkty wybrane przez użytkownika. */
+    iterator = index->landmarksNames->begin;
+    while (iterator != index->landmarksNames->end &&
+           index->builtLandmarksCount < landmarksCount) {
+        City *city = findCityOnHashMap(index->citiesMap, iterator->data);
+        iterator = iterator->next;
+        if (city == NULL || minDistance[city->id] == 0) {
+            continue;
+        }
+
+        if (!addBuiltLandmarkLandmarkIndex(index, city, minDistance)) {
+            free(minDistance);
+            return false;
+        }
+    }
+
+    /* Jeśli użytkownik nie wybrał żadnego punktu, to pierwszym punktem jest
+     * miasto najbardziej odległe od dowolnego miasta. */
+    if (index->builtLandmarksCount == 0 && landmarksCount > 0) {
+        if (!distancesFromLandmarkIndex(index->listOfCities->begin->data,
+                                        minDistance, index->citiesCount)) {
+            free(minDistance);
+            return false;
+        }
+    }
+
+    while (index->builtLandmarksCount < landmarksCount) {
+        City *city = farthestCityLandmarkIndex(index, minDistance);
+        if (city == NULL) {
+            break;
+        }
+
+        if (!addBuiltLandmarkLandmarkIndex(index, city, minDistance)) {
+            free(minDistance);
+            return false;
+        }
+    }
+
+    free(minDistance);
+    index->isValid = true;
+    index->buildsCount++;
+
+    return true;
+}
+
+/** @brief Odświeża indeks.
+ * Przebudowuje indeks, jeśli jest nieaktualny lub od ostatniej budowy
+ * usunięto dużą część odcinków dróg.
+ * @param[in,out] index         - wskaźnik na indeks.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci (indeks jest wtedy nieaktualny).
+ */
+bool refreshLandmarkIndex(LandmarkIndex *index) {
+    assert(index);
+
+    if (index->isValid && index->removedRoadsCount *
+            REBUILD_REMOVED_ROADS_RATIO <= index->roadsCount) {
+        return true;
+    }
+
+    return buildLandmarkIndex(index);
+}
+
+/** @brief Dolne ograniczenie na odległość między miastami.
+ * Indeks musi być aktualny. Ograniczenie jest spójne: dla każdego odcinka
+ * drogi (u, v) ograniczenie dla u nie przekracza sumy długości odcinka
+ * i ograniczenia dla v.
+ * @param[in] index             - wskaźnik na indeks;
+ * @param[in] from              - wskaźnik na pierwsze miasto;
+ * @param[in] to                - wskaźnik na drugie miasto.
+ * @return Dolne ograniczenie na długość drogi między miastami lub
+ * @ref INFINITY, jeśli miasta nie są połączone.
+ */
+int64_t lowerBoundLandmarkIndex(const LandmarkIndex *index, City *from,
+                                City *to) {
+    assert(index);
+    assert(index->isValid);
+
+    /* Miasta dodane po zbudowaniu indeksu nie mają jeszcze odcinków dróg. */
+    if (from->id >= index->citiesCount || to->id >= index->citiesCount) {
+        return 0;
+    }
+
+    int64_t result = 0;
+    const int64_t *distances = index->distances;
+    for (uint32_t i = 0; i < index->builtLandmarksCount; i++) {
+        int64_t distanceFrom = distances[from->id];
+        int64_t distanceTo = distances[to->id];
+        distances += index->citiesCount;
+
+        if (distanceFrom == INFINITY && distanceTo == INFINITY) {
+            continue;
+        }
+        if (distanceFrom == INFINITY || distanceTo == INFINITY) {
+            return INFINITY;
+        }
+
+        int64_t bound = distanceFrom - distanceTo;
+        if (bound < 0) {
+            bound = -bound;
+        }
+        if (bound > result) {
+            result = bound;
+        }
+    }
+
+    return result;
+}
+
+/** @brief Pamięć zajmowana przez indeks.
+ * @param[in] index             - wskaźnik na indeks.
+ * @return Liczba bajtów indeksu, nazw wybranych miast i tablic odległości.
+ */
+size_t memoryUsageLandmarkIndex(const LandmarkIndex *index) {
+    assert(index);
+
+    size_t result = sizeof(LandmarkIndex) +
+                    memoryUsageList(index->landmarksNames);
+    for (ListIterator *iterator = index->landmarksNames->begin;
+         iterator != index->landmarksNames->end; iterator = iterator->next) {
+        result += strlen(iterator->data) + 1;
+    }
+
+    if (index->landmarks != NULL) {
+        size_t landmarksCount = (size_t)index->builtLandmarksCount + 1;
+        result += sizeof(City *) * landmarksCount + sizeof(int64_t) *
+                  landmarksCount * ((size_t)index->citiesCount + 1);
+    }
+
+    return result;
+}
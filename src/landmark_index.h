@@ -0,0 +1,120 @@
+/** @file
+ * Interfejs klasy przechowującej indeks punktów orientacyjnych (ALT).
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef LANDMARK_INDEX_H
+#define LANDMARK_INDEX_H
+
+#include "city.h"
+#include "list.h"
+#include "hash_map.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Struktura przechowująca odległości od wybranych miast (punktów
+ * orientacyjnych) do wszystkich miast na mapie. Z nierówności trójkąta
+ * wynika dolne ograniczenie na odległość między dowolnymi dwoma miastami,
+ * używane przez algorytm A*. Usuwanie odcinków dróg nie psuje ograniczeń
+ * (mogą jedynie stać się słabsze), a dodanie odcinka wymaga przebudowania
+ * indeksu.
+ */
+typedef struct LandmarkIndex {
+    List *listOfCities;             ///< wskaźnik na wszystkie miasta na mapie
+    HashMap *citiesMap;             ///< wskaźnik na haszmapę miast na mapie
+    List *landmarksNames;           ///< nazwy miast wybranych przez użytkownika
+    uint32_t landmarksCount;        ///< liczba punktów orientacyjnych
+    uint32_t builtLandmarksCount;   ///< liczba punktów w zbudowanym indeksie
+    City **landmarks;               ///< punkty orientacyjne zbudowanego indeksu
+    int64_t *distances;             ///< odległości od punktów orientacyjnych
+    uint32_t citiesCount;           ///< liczba miast w zbudowanym indeksie
+    uint32_t roadsCount;            ///< liczba odcinków w zbudowanym indeksie
+    uint32_t removedRoadsCount;     ///< liczba odcinków usuniętych od budowy
+    bool isValid;                   ///< czy indeks jest zbudowany i aktualny
+    uint64_t buildsCount;           ///< liczba przebudowań indeksu
+} LandmarkIndex;
+
+/** @brief Tworzy strukturę.
+ * Tworzy pusty (niezbudowany) indeks punktów orientacyjnych.
+ * @param[in] listOfCities      - wskaźnik na wszystkie miasta na mapie;
+ * @param[in] citiesMap         - wskaźnik na haszmapę miast na mapie;
+ * @param[in] landmarksCount    - liczba punktów orientacyjnych.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci.
+ */
+LandmarkIndex *newLandmarkIndex(List *listOfCities, HashMap *citiesMap,
+                                uint32_t landmarksCount);
+
+/** @brief Usuwa strukturę.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] index             - wskaźnik na usuwaną strukturę.
+ */
+void deleteLandmarkIndex(LandmarkIndex *index);
+
+/** @brief Ustawia liczbę punktów orientacyjnych.
+ * Punkty wybrane przez użytkownika są zawsze używane, a brakujące punkty
+ * wybierane są automatycznie (kolejno miasta najbardziej odległe od już
+ * wybranych). Indeks zostanie przebudowany przy najbliższym odświeżeniu.
+ * @param[in,out] index         - wskaźnik na indeks;
+ * @param[in] landmarksCount    - liczba punktów orientacyjnych.
+ */
+void setLandmarksCountLandmarkIndex(LandmarkIndex *index,
+                                    uint32_t landmarksCount);
+
+/** @brief Dodaje miasto do punktów orientacyjnych.
+ * Miasto nie musi jeszcze istnieć, jest wyszukiwane przy budowie indeksu.
+ * Indeks zostanie przebudowany przy najbliższym odświeżeniu.
+ * @param[in,out] index         - wskaźnik na indeks;
+ * @param[in] cityName          - wskaźnik na nazwę miasta.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool addLandmarkLandmarkIndex(LandmarkIndex *index, const char *cityName);
+
+/** @brief Oznacza indeks jako nieaktualny.
+ * Należy wywołać po dodaniu odcinka drogi do mapy.
+ * @param[in,out] index         - wskaźnik na indeks.
+ */
+void invalidateLandmarkIndex(LandmarkIndex *index);
+
+/** @brief Odnotowuje usunięcie odcinka drogi.
+ * Indeks pozostaje poprawny, ale po usunięciu wielu odcinków zostanie
+ * przebudowany przy najbliższym odświeżeniu, aby ograniczenia nie były zbyt
+ * słabe.
+ * @param[in,out] index         - wskaźnik na indeks.
+ */
+void removedRoadLandmarkIndex(LandmarkIndex *index);
+
+/** @brief Odświeża indeks.
+ * Przebudowuje indeks, jeśli jest nieaktualny lub od ostatniej budowy
+ * usunięto dużą część odcinków dróg.
+ * @param[in,out] index         - wskaźnik na indeks.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci (indeks jest wtedy nieaktualny).
+ */
+bool refreshLandmarkIndex(LandmarkIndex *index);
+
+/** @brief Dolne ograniczenie na odległość między miastami.
+ * Indeks musi być aktualny. Ograniczenie jest spójne: dla każdego odcinka
+ * drogi (u, v) ograniczenie dla u nie przekracza sumy długości odcinka
+ * i ograniczenia dla v.
+ * @param[in] index             - wskaźnik na indeks;
+ * @param[in] from              - wskaźnik na pierwsze miasto;
+ * @param[in] to                - wskaźnik na drugie miasto.
+ * @return Dolne ograniczenie na długość drogi między miastami lub
+ * @ref INFINITY, jeśli miasta nie są połączone.
+ */
+int64_t lowerBoundLandmarkIndex(const LandmarkIndex *index, City *from,
+                                City *to);
+
+/** @brief Pamięć zajmowana przez indeks.
+ * @param[in] index             - wskaźnik na indeks.
+ * @return Liczba bajtów indeksu, nazw wybranych miast i tablic odległości.
+ */
+size_t memoryUsageLandmarkIndex(const LandmarkIndex *index);
+
+#endif // LANDMARK_INDEX_H
@@ -246,3 +246,14 @@ uint32_t sizeList(List *list) {
 
     return result;
 }
+
+/** @brief Pamięć zajmowana przez listę.
+ * Liczy strukturę listy i jej węzły (ze strażnikiem), bez danych.
+ * @param[in] list                  - wskaźnik na listę.
+ * @return Liczba bajtów.
+ */
+size_t memoryUsageList(List *list) {
+    assert(list);
+
+    return sizeof(List) + ((size_t)sizeList(list) + 1) * sizeof(ListIterator);
+}
@@ -10,6 +10,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stddef.h>
 
 typedef struct List List;
 
@@ -112,4 +113,11 @@ void *backList(List *list);
  */
 uint32_t sizeList(List *list);
 
+/** @brief Pamięć zajmowana przez listę.
+ * Liczy strukturę listy i jej węzły (ze strażnikiem), bez danych.
+ * @param[in] list                  - wskaźnik na listę.
+ * @return Liczba bajtów.
+ */
+size_t memoryUsageList(List *list);
+
 #endif // LIST_H
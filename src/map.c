@@ -13,10 +13,29 @@
 #include "list.h"
 #include "road.h"
 #include "route.h"
+#include "snapshot.h"
+#include "map_image.h"
+#include "string_builder.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define DEFAULT_LANDMARKS_COUNT 8
+///< domyślna liczba punktów orientacyjnych algorytmu A*
+
+#define HIERARCHY_WITNESS_COST 2
+///< koszt obsłużenia miasta przez szukanie drogi świadka w miastach
+///< obsłużonych przez algorytm dijkstry
+
+#define HIERARCHY_CITY_COST 1024
+///< szacowany koszt budowy hierarchii kontrakcji na miasto mapy w miastach
+///< obsłużonych przez algorytm dijkstry, zanim hierarchia zostanie zbudowana
 
 /** @brief Tworzy nową strukturę.
  * Tworzy nową, pustą strukturę niezawierającą żadnych miast, odcinków dróg ani
@@ -51,365 +70,2611 @@ Map *newMap() {
         return NULL;
     }
 
+    result->searchState = newSearchState(result->cities);
+    if (result->searchState == NULL) {
+        deleteHashMap(result->citiesMap);
+        deleteList(result->cities, false);
+        deleteList(result->routes, false);
+        free(result);
+        return NULL;
+    }
+
+    result->connectivity = newConnectivityOracle(result->cities);
+    if (result->connectivity == NULL) {
+        deleteSearchState(result->searchState);
+        deleteHashMap(result->citiesMap);
+        deleteList(result->cities, false);
+        deleteList(result->routes, false);
+        free(result);
+        return NULL;
+    }
+
+    result->threadPool = NULL;
+    result->threadsSearchStates = NULL;
+    result->landmarks = NULL;
+    result->hierarchy = NULL;
+    result->hierarchySettledMark = 0;
+    result->image = NULL;
+    result->promotionsCount = 0;
+    result->journal = NULL;
+    result->snapshots = NULL;
+    result->graphVersion = 0;
+    result->searchCache = NULL;
+    result->indexedRouteIds = NULL;
+    result->indexedRoutesCount = 0;
+
     return result;
 }
 
-/** @brief Usuwa strukturę.
- * Usuwa strukturę wskazywaną przez @p map.
- * Nic nie robi, jeśli wskaźnik ten ma wartość NULL.
- * @param[in] map        – wskaźnik na usuwaną strukturę.
+/** @brief Usuwa pulę wątków mapy.
+ * Usuwa pulę wątków oraz stany algorytmu dijkstry wątków. Mapa przechodzi
+ * w tryb sekwencyjny.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg.
  */
-void deleteMap(Map *map) {
-    if (map == NULL) {
+void deleteThreadPoolMap(Map *map) {
+    if (map->threadPool == NULL) {
         return;
     }
 
-    ListIterator *iterator = map->cities->begin;
-    while (iterator != map->cities->end) {
-        deleteCity(iterator->data);
-        iterator = iterator->next;
-    }
-    deleteList(map->cities, false);
-
-    iterator = map->routes->begin;
-    while (iterator != map->routes->end) {
-        deleteRouteModule(iterator->data);
-        iterator = iterator->next;
+    uint32_t threadsCount = threadsCountThreadPool(map->threadPool);
+    for (uint32_t i = 0; i < threadsCount; i++) {
+        deleteSearchState(map->threadsSearchStates[i]);
     }
-    deleteList(map->routes, false);
-
-    deleteHashMap(map->citiesMap);
+    free(map->threadsSearchStates);
+    deleteThreadPool(map->threadPool);
 
-    free(map);
+    map->threadPool = NULL;
+    map->threadsSearchStates = NULL;
 }
 
-/** @brief Sprawdza zgodność danych ze specyfikacją zadania.
- * Poprawne dane to takie, w których wskaźnik na mapę nie jest równy NULL,
- * wskaźniki na napisy, które nie są równe NULL, wskazują na poprawny napis
- * oraz jeśli oba wskaźniki na napisy nie są równe NULL, to napisy muszą
- * być różne.
- * @param[in] map       - wskaźnik na mapę;
- * @param[in] cityName1 - wskaźnik na pierwszy napis;
- * @param[in] cityName2 - wskaźnik na drugi napis.
- * @return Wartość @p true jeśli dane są poprawne lub @p false w przeciwnym
- * przypadku.
+/** @brief Ustawia liczbę wątków używanych przez mapę.
+ * Dla @p threadsCount większego od @p 1 tworzy pulę wątków, w której
+ * równolegle szukane są objazdy dla dróg krajowych w funkcji
+ * @ref removeRoad. Każdy wątek ma własny stan algorytmu dijkstry. Wyniki są
+ * takie same jak przy wykonaniu sekwencyjnym.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] threadsCount – liczba wątków.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci lub utworzyć wątków (mapa pozostaje wtedy w trybie sekwencyjnym).
  */
-bool isValidInput(Map *map, const char *cityName1, const char *cityName2) {
+bool setThreadsCountMap(Map *map, uint32_t threadsCount) {
     if (map == NULL) {
         return false;
     }
 
-    if (cityName1 != NULL && !isStringValidCityName(cityName1)) {
-        return false;
+    deleteThreadPoolMap(map);
+    if (threadsCount <= 1) {
+        return true;
     }
 
-    if (cityName2 != NULL && !isStringValidCityName(cityName2)) {
+    map->threadsSearchStates = calloc(threadsCount, sizeof(SearchState *));
+    if (map->threadsSearchStates == NULL) {
         return false;
     }
 
-    if (cityName1 != NULL && cityName2 != NULL &&
-            strcmp(cityName1, cityName2) == 0) {
+    for (uint32_t i = 0; i < threadsCount; i++) {
+        map->threadsSearchStates[i] = newSearchState(map->cities);
+        if (map->threadsSearchStates[i] == NULL) {
+            for (uint32_t j = 0; j < i; j++) {
+                deleteSearchState(map->threadsSearchStates[j]);
+            }
+            free(map->threadsSearchStates);
+            map->threadsSearchStates = NULL;
+            return false;
+        }
+        map->threadsSearchStates[i]->engine = map->searchState->engine;
+        map->threadsSearchStates[i]->cache = map->searchCache;
+    }
+
+    map->threadPool = newThreadPool(threadsCount);
+    if (map->threadPool == NULL) {
+        for (uint32_t i = 0; i < threadsCount; i++) {
+            deleteSearchState(map->threadsSearchStates[i]);
+        }
+        free(map->threadsSearchStates);
+        map->threadsSearchStates = NULL;
         return false;
     }
 
     return true;
 }
 
-/** @brief Dodaje do mapy odcinek drogi między dwoma różnymi miastami.
- * Jeśli któreś z podanych miast nie istnieje, to dodaje go do mapy, a następnie
- * dodaje do mapy odcinek drogi między tymi miastami.
+/** @brief Wybiera algorytm wyszukiwania dróg krajowych.
+ * Ustawia algorytm używany przy tworzeniu dróg krajowych i szukaniu objazdów
+ * we wszystkich stanach algorytmu mapy (także w stanach wątków puli).
  * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
- * @param[in] cityName1  – wskaźnik na napis reprezentujący nazwę miasta;
- * @param[in] cityName2  – wskaźnik na napis reprezentujący nazwę miasta;
- * @param[in] length     – długość w km odcinka drogi;
- * @param[in] builtYear  – rok budowy odcinka drogi.
- * @return Wartość @p true, jeśli odcinek drogi został dodany.
- * Wartość @p false, jeśli wystąpił błąd: któryś z parametrów ma niepoprawną
- * wartość, obie podane nazwy miast są identyczne, odcinek drogi między tymi
- * miastami już istnieje lub nie udało się zaalokować pamięci.
+ * @param[in] engine     – algorytm wyszukiwania.
+ * @return Wartość @p true lub @p false, jeśli mapa ma wartość NULL.
  */
-bool addRoad(Map *map, const char *cityName1, const char *cityName2,
-             unsigned length, int builtYear) {
-    if (!isValidInput(map, cityName1, cityName2) || length == 0 || builtYear == 0) {
+bool setSearchEngineMap(Map *map, SearchEngine engine) {
+    if (map == NULL) {
         return false;
     }
 
-    City *city1 = findCityOnHashMapInsertIfNecessary(map->citiesMap,
-                                                     map->cities, cityName1);
-    City *city2 = findCityOnHashMapInsertIfNecessary(map->citiesMap,
-                                                     map->cities, cityName2);
-    if (city1 == NULL || city2 == NULL) {
-        return false;
+    map->searchState->engine = engine;
+    if (map->threadPool != NULL) {
+        uint32_t threadsCount = threadsCountThreadPool(map->threadPool);
+        for (uint32_t i = 0; i < threadsCount; i++) {
+            map->threadsSearchStates[i]->engine = engine;
+        }
     }
 
-    if (findRoadModule(city1, city2) != NULL) {
-        return false;
+    return true;
+}
+
+/** @brief Zwraca indeks punktów orientacyjnych mapy.
+ * Tworzy indeks z domyślną liczbą punktów, jeśli mapa go jeszcze nie ma.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Wskaźnik na indeks lub NULL, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+LandmarkIndex *landmarkIndexMap(Map *map) {
+    if (map->landmarks == NULL) {
+        map->landmarks = newLandmarkIndex(map->cities, map->citiesMap,
+                                          DEFAULT_LANDMARKS_COUNT);
     }
 
-    return addRoadModule(city1, city2, length, builtYear);
+    return map->landmarks;
 }
 
-/** @brief Modyfikuje rok ostatniego remontu odcinka drogi.
- * Dla odcinka drogi między dwoma miastami zmienia rok jego ostatniego remontu
- * lub ustawia ten rok, jeśli odcinek nie był jeszcze remontowany.
+/** @brief Ustawia liczbę punktów orientacyjnych algorytmu A*.
+ * Punkty orientacyjne używane są przez algorytm @ref ALT_SEARCH_ENGINE.
+ * Brakujące punkty (ponad wybrane funkcją @ref addLandmarkMap) wybierane są
+ * automatycznie. Indeks punktów budowany jest leniwie przy pierwszym
+ * wyszukiwaniu i przebudowywany po zmianach odcinków dróg.
  * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
- * @param[in] cityName1  – wskaźnik na napis reprezentujący nazwę miasta;
- * @param[in] cityName2  – wskaźnik na napis reprezentujący nazwę miasta;
- * @param[in] repairYear – rok ostatniego remontu odcinka drogi.
- * @return Wartość @p true, jeśli modyfikacja się powiodła.
- * Wartość @p false, jeśli wystąpił błąd: któryś z parametrów ma niepoprawną
- * wartość, któreś z podanych miast nie istnieje, nie ma odcinka drogi między
- * podanymi miastami, podany rok jest wcześniejszy niż zapisany dla tego odcinka
- * drogi rok budowy lub ostatniego remontu.
+ * @param[in] landmarksCount – liczba punktów orientacyjnych.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
  */
-bool repairRoad(Map *map, const char *cityName1, const char *cityName2, int repairYear) {
-    if (!isValidInput(map, cityName1, cityName2) || repairYear == 0) {
+bool setLandmarksCountMap(Map *map, uint32_t landmarksCount) {
+    if (map == NULL || landmarkIndexMap(map) == NULL) {
         return false;
     }
 
-    City *city1 = findCityOnHashMap(map->citiesMap, cityName1);
-    City *city2 = findCityOnHashMap(map->citiesMap, cityName2);
-    if (city1 == NULL || city2 == NULL) {
-        return false;
-    }
+    setLandmarksCountLandmarkIndex(map->landmarks, landmarksCount);
 
-    return repairRoadModule(city1, city2, repairYear);
+    return true;
 }
 
-/** @brief Łączy dwa różne miasta drogą krajową.
- * Tworzy drogę krajową pomiędzy dwoma miastami i nadaje jej podany numer.
- * Wśród istniejących odcinków dróg wyszukuje najkrótszą drogę. Jeśli jest
- * więcej niż jeden sposób takiego wyboru, to dla każdego wariantu wyznacza
- * wśród wybranych w nim odcinków dróg ten, który był najdawniej wybudowany lub
- * remontowany i wybiera wariant z odcinkiem, który jest najmłodszy.
+/** @brief Wybiera miasto jako punkt orientacyjny algorytmu A*.
+ * Miasto nie musi jeszcze istnieć na mapie.
  * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
- * @param[in] routeId    – numer drogi krajowej;
- * @param[in] cityName1  – wskaźnik na napis reprezentujący nazwę miasta;
- * @param[in] cityName2  – wskaźnik na napis reprezentujący nazwę miasta.
- * @return Wartość @p true, jeśli droga krajowa została utworzona.
- * Wartość @p false, jeśli wystąpił błąd: któryś z parametrów ma niepoprawną
- * wartość, istnieje już droga krajowa o podanym numerze, któreś z podanych
- * miast nie istnieje, obie podane nazwy miast są identyczne, nie można
- * jednoznacznie wyznaczyć drogi krajowej między podanymi miastami lub nie udało
- * się zaalokować pamięci.
+ * @param[in] cityName   – wskaźnik na napis reprezentujący nazwę miasta.
+ * @return Wartość @p true lub @p false, jeśli nazwa miasta jest niepoprawna
+ * lub nie udało się zaalokować pamięci.
  */
-bool newRoute(Map *map, unsigned routeId,
-              const char *cityName1, const char *cityName2) {
-    if (!isValidInput(map, cityName1, cityName2)) {
-        return false;
-    }
-
-    if (routeId < 1 || 999 < routeId) {
+bool addLandmarkMap(Map *map, const char *cityName) {
+    if (map == NULL || cityName == NULL || !isStringValidCityName(cityName) ||
+            landmarkIndexMap(map) == NULL) {
         return false;
     }
 
-    City *city1 = findCityOnHashMap(map->citiesMap, cityName1);
-    City *city2 = findCityOnHashMap(map->citiesMap, cityName2);
-    if (city1 == NULL || city2 == NULL) {
-        return false;
-    }
+    return addLandmarkLandmarkIndex(map->landmarks, cityName);
+}
 
-    if (findRouteOnList(map->routes, routeId) != NULL) {
-        return false;
+/** @brief Przygotowuje indeks punktów orientacyjnych do wyszukiwania.
+ * Jeśli wybrano algorytm A* z punktami orientacyjnymi, to odświeża indeks
+ * i przekazuje go stanom algorytmu (także stanom wątków puli). Musi być
+ * wywołana przed wyszukiwaniem dróg, bo indeks nie może być przebudowywany
+ * w trakcie równoległego szukania objazdów.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool refreshLandmarksMap(Map *map) {
+    if (map->searchState->engine != ALT_SEARCH_ENGINE) {
+        return true;
     }
 
-    Route *route = newRouteModule(routeId, city1, city2, map->cities);
-    if (route == NULL) {
+    if (landmarkIndexMap(map) == NULL ||
+            !refreshLandmarkIndex(map->landmarks)) {
         return false;
     }
 
-    if (insertList(map->routes->end, route) == NULL) {
-       deleteRouteModule(route);
-       return false;
+    map->searchState->landmarks = map->landmarks;
+    if (map->threadPool != NULL) {
+        uint32_t threadsCount = threadsCountThreadPool(map->threadPool);
+        for (uint32_t i = 0; i < threadsCount; i++) {
+            map->threadsSearchStates[i]->landmarks = map->landmarks;
+        }
     }
 
     return true;
 }
 
-/** @brief Wydłuża drogę krajową do podanego miasta.
- * Dodaje do drogi krajowej nowe odcinki dróg do podanego miasta w taki sposób,
- * aby nowy fragment drogi krajowej był najkrótszy. Jeśli jest więcej niż jeden
- * sposób takiego wydłużenia, to dla każdego wariantu wyznacza wśród dodawanych
- * odcinków dróg ten, który był najdawniej wybudowany lub remontowany i wybiera
- * wariant z odcinkiem, który jest najmłodszy.
- * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
- * @param[in] routeId    – numer drogi krajowej;
- * @param[in] cityName   – wskaźnik na napis reprezentujący nazwę miasta.
- * @return Wartość @p true, jeśli droga krajowa została wydłużona.
- * Wartość @p false, jeśli wystąpił błąd: któryś z parametrów ma niepoprawną
- * nazwę, nie istnieje droga krajowa o podanym numerze, nie ma miasta o podanej
- * nazwie, przez podane miasto już przechodzi droga krajowa o podanym numerze,
- * podana droga krajowa kończy się w podanym mieście, nie można jednoznacznie
- * wyznaczyć nowego fragmentu drogi krajowej lub nie udało się zaalokować
- * pamięci.
+/** @brief Zwraca liczniki wyszukiwań dróg krajowych.
+ * Sumuje liczniki ze wszystkich stanów algorytmu mapy.
+ * @param[in] map        – wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Sumaryczne liczniki wyszukiwań.
  */
-bool extendRoute(Map *map, unsigned routeId, const char *cityName) {
-    if (!isValidInput(map, cityName, NULL)) {
-        return false;
-    }
+SearchStatistics getSearchStatisticsMap(Map *map) {
+    assert(map);
 
-    City *city = findCityOnHashMap(map->citiesMap, cityName);
-    if (city == NULL) {
-        return false;
+    SearchStatistics result = map->searchState->statistics;
+    if (map->threadPool != NULL) {
+        uint32_t threadsCount = threadsCountThreadPool(map->threadPool);
+        for (uint32_t i = 0; i < threadsCount; i++) {
+            SearchState *state = map->threadsSearchStates[i];
+            result.searchesCount += state->statistics.searchesCount;
+            result.settledCitiesCount += state->statistics.settledCitiesCount;
+            result.sharedDetoursCount += state->statistics.sharedDetoursCount;
+        }
     }
 
-    ListIterator *iterator = findRouteOnList(map->routes, routeId);
-    if (iterator == NULL) {
-        return false;
-    }
+    return result;
+}
 
-    Route *route = iterator->data;
-    if (findCityOnList(route->cities, city->name) != NULL) {
-        return false;
+/** @brief Sprawdza, czy opłaca się zbudować hierarchię kontrakcji.
+ * Budowa hierarchii kosztuje tyle, co setki wyszukiwań algorytmem dijkstry,
+ * a każda zmiana odcinków dróg ją unieważnia. Dlatego po zmianie drogi
+ * wyszukiwane są bez hierarchii, dopóki wyszukiwania od tej zmiany, łącznie
+ * z zapowiedzianymi, nie obsłużą tylu miast, ile kosztowałaby budowa. Koszt
+ * budowy szacowany jest liczbą miast obsłużonych przez szukania dróg
+ * świadków podczas poprzedniej budowy, a przed pierwszą budową liczbą miast
+ * mapy. Zapowiedziane wyszukiwanie liczone jest jak przejście algorytmu
+ * dijkstry przez wszystkie miasta mapy.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] searchesCount – liczba zapowiedzianych wyszukiwań.
+ * @return Wartość @p true, jeśli hierarchię należy zbudować.
+ */
+bool isHierarchyWorthBuildingMap(Map *map, uint64_t searchesCount) {
+    const ContractionHierarchy *hierarchy = map->hierarchy;
+    uint64_t citiesCount = countCitiesOnList(map->cities);
+    uint64_t cost = hierarchy->buildsCount == 0 ?
+                    HIERARCHY_CITY_COST * citiesCount :
+                    HIERARCHY_WITNESS_COST * hierarchy->witnessSettledCount;
+
+    /* Liczniki stanów wątków zerują się przy zmianie liczby wątków. */
+    uint64_t settled = getSearchStatisticsMap(map).settledCitiesCount;
+    if (settled < map->hierarchySettledMark) {
+        map->hierarchySettledMark = settled;
     }
 
-    return findNewRouteAfterExtend(route, city, map->cities);
+    return settled - map->hierarchySettledMark +
+           searchesCount * citiesCount >= cost;
 }
 
-/** @brief Usuwa odcinek drogi między dwoma różnymi miastami.
- * Usuwa odcinek drogi między dwoma miastami. Jeśli usunięcie tego odcinka drogi
- * powoduje przerwanie ciągu jakiejś drogi krajowej, to uzupełnia ją
- * istniejącymi odcinkami dróg w taki sposób, aby była najkrótsza. Jeśli jest
- * więcej niż jeden sposób takiego uzupełnienia, to dla każdego wariantu
- * wyznacza wśród dodawanych odcinków drogi ten, który był najdawniej wybudowany
- * lub remontowany i wybiera wariant z odcinkiem, który jest najmłodszy.
+/** @brief Przygotowuje hierarchię kontrakcji do wyszukiwania.
+ * Jeśli wybrano wyszukiwanie w hierarchii kontrakcji, to tworzy lub odświeża
+ * hierarchię i przekazuje ją stanom algorytmu mapy i wątków. Nieaktualnej
+ * hierarchii nie buduje, jeśli budowa się nie opłaca
+ * (@ref isHierarchyWorthBuildingMap) – wtedy stany algorytmu nie dostają
+ * hierarchii i wyszukiwania korzystają z algorytmu dijkstry.
  * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
- * @param[in] cityName1  – wskaźnik na napis reprezentujący nazwę miasta;
- * @param[in] cityName2  – wskaźnik na napis reprezentujący nazwę miasta.
- * @return Wartość @p true, jeśli odcinek drogi został usunięty.
- * Wartość @p false, jeśli z powodu błędu nie można usunąć tego odcinka drogi:
- * któryś z parametrów ma niepoprawną wartość, nie ma któregoś z podanych miast,
- * nie istnieje droga między podanymi miastami, nie da się jednoznacznie
- * uzupełnić przerwanego ciągu drogi krajowej lub nie udało się zaalokować
+ * @param[in] searchesCount – liczba wyszukiwań, które zostaną wykonane.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
  * pamięci.
  */
-bool removeRoad(Map *map, const char *cityName1, const char *cityName2) {
-    if (!isValidInput(map, cityName1, cityName2)) {
-        return false;
+bool refreshHierarchyMap(Map *map, uint64_t searchesCount) {
+    if (map->searchState->engine != HIERARCHY_SEARCH_ENGINE) {
+        return true;
     }
 
-    City *city1 = findCityOnHashMap(map->citiesMap, cityName1);
-    City *city2 = findCityOnHashMap(map->citiesMap, cityName2);
-    if (city1 == NULL || city2 == NULL) {
-        return false;
+    if (map->hierarchy == NULL) {
+        map->hierarchy = newContractionHierarchy(map->cities);
+        if (map->hierarchy == NULL) {
+            return false;
+        }
     }
 
-    /* Sprawdzamy czy droga istnieje. Jeśli istnieje to ustawiamy,
-     * że dana droga jest w trakcie usuwania. */
-    if (!setRoadIsDeletedTo(city1, city2, true)) {
+    ContractionHierarchy *hierarchy = map->hierarchy;
+    if (!hierarchy->isValid &&
+            !isHierarchyWorthBuildingMap(map, searchesCount)) {
+        hierarchy = NULL;
+    } else if (!refreshContractionHierarchy(hierarchy)) {
         return false;
     }
 
-    ListIterator *iterator = map->routes->begin;
-    while (iterator != map->routes->end) {
-        if (!findNewRouteAfterRemovingRoad(iterator->data, city1, city2,
-                                           map->cities)) {
-            /* Okazuje się, że nie można usunąć danej drogi, więc cofamy
-             * wszystkie zmiany. */
-            while (iterator != map->routes->begin) {
-                iterator = iterator->previous;
-                undoFindNewRouteAfterRemovingRoad(iterator->data, city1, city2);
-            }
-            setRoadIsDeletedTo(city1, city2, false);
-            return false;
+    map->searchState->hierarchy = hierarchy;
+    if (map->threadPool != NULL) {
+        uint32_t threadsCount = threadsCountThreadPool(map->threadPool);
+        for (uint32_t i = 0; i < threadsCount; i++) {
+            map->threadsSearchStates[i]->hierarchy = hierarchy;
         }
-        iterator = iterator->next;
     }
 
-    removeRoadModule(city1, city2);
-
     return true;
 }
 
-/** @brief Udostępnia informacje o drodze krajowej.
- * Zwraca wskaźnik na napis, który zawiera informacje o drodze krajowej. Alokuje
- * pamięć na ten napis. Zwraca pusty napis, jeśli nie istnieje droga krajowa
- * o podanym numerze. Zaalokowaną pamięć trzeba zwolnić za pomocą funkcji free.
- * Informacje wypisywane są w formacie:
- * numer drogi krajowej;nazwa miasta;długość odcinka drogi;rok budowy lub
- * ostatniego remontu;nazwa miasta;długość odcinka drogi;rok budowy lub
- * ostatniego remontu;nazwa miasta;…;nazwa miasta.
- * Kolejność miast na liście jest taka, aby miasta @p city1 i @p city2, podane
- * w wywołaniu funkcji @ref newRoute, które utworzyło tę drogę krajową, zostały
- * wypisane w tej kolejności.
- * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
- * @param[in] routeId    – numer drogi krajowej.
- * @return Wskaźnik na napis lub NULL, gdy nie udało się zaalokować pamięci.
+/** @brief Unieważnia hierarchię kontrakcji.
+ * Należy wywołać po każdej zmianie odcinków dróg.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg.
  */
-char const* getRouteDescription(Map *map, unsigned routeId) {
-    char *emptyString = malloc(sizeof(char));
-    if (emptyString == NULL) {
-        return NULL;
+void invalidateHierarchyMap(Map *map) {
+    if (map->hierarchy != NULL) {
+        invalidateContractionHierarchy(map->hierarchy);
     }
-    *emptyString = 0;
+}
 
-    if (map == NULL) {
-        return emptyString;
-    }
+/** @brief Odnotowuje zmianę odcinków dróg.
+ * Zwiększa wersję mapy, co unieważnia drzewa w pamięci podręcznej, oraz
+ * unieważnia hierarchię kontrakcji i zapamiętuje, ile miast obsłużyły
+ * dotąd wyszukiwania (zob. @ref isHierarchyWorthBuildingMap). Należy
+ * wywołać po każdej zmianie odcinków dróg, także po oznaczeniu odcinka jako
+ * usuwanego.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg.
+ */
+void changedRoadsMap(Map *map) {
+    map->graphVersion++;
+    invalidateHierarchyMap(map);
 
-    ListIterator *iterator = findRouteOnList(map->routes, routeId);
-    if (iterator == NULL) {
-        return emptyString;
+    if (map->searchState->engine == HIERARCHY_SEARCH_ENGINE) {
+        map->hierarchySettledMark =
+                getSearchStatisticsMap(map).settledCitiesCount;
     }
-
-    free(emptyString);
-
-    return descriptionRouteModule(iterator->data);
 }
 
-/** @brief Uaktualnia odcinek drogowy w mapie.
- * Jeśli dana droga nie istnieje, to dodaję ją do mapy funkcją @ref addRoad.
- * Jeśli dana droga istnieje to wywołuję funkcję @ref repairRoad.
- * @brief updateRoad
+/** @brief Ustawia pamięć podręczną drzew najkrótszych dróg.
+ * Tworzy pamięć podręczną o podanym limicie, wspólną dla stanów algorytmu
+ * mapy i wątków puli, i usuwa poprzednią. Drzewa pełnych przejść algorytmu
+ * dijkstry (zob. @ref SearchCache) zapamiętywane są dla wersji mapy
+ * @ref Map.graphVersion, którą zwiększają funkcje zmieniające odcinki dróg,
+ * więc kolejne wyszukiwania z tego samego miasta na niezmienionej mapie nie
+ * uruchamiają algorytmu. Wyszukiwania dwukierunkowe, w hierarchii kontrakcji
+ * i algorytmem A* nie liczą pełnych drzew i nie korzystają z pamięci
+ * podręcznej.
  * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
- * @param[in] cityName1  – wskaźnik na napis reprezentujący nazwę miasta;
- * @param[in] cityName2  – wskaźnik na napis reprezentujący nazwę miasta;
- * @param[in] length     – długość w km odcinka drogi;
- * @param[in] builtYear  – rok budowy odcinka drogi.
- * @return Wartość @p true jeśli funkjca @ref addRoad / @ref repairRoad
- * zakończyła się sukcesem. Wartość @p false jeśli wystąpił błąd:
- * dana funkcja nie zakończyła się sukcesem, któryś z parametrów ma niepoprawną
- * wartość, obie podane nazwy miast są identyczne, odcinek drogi między tymi
- * miastami już istnieje i ma inną długość lub nie udało się zaalokować pamięci.
+ * @param[in] budget     – limit pamięci drzew w bajtach lub @p 0, aby
+ *                         wyłączyć pamięć podręczną.
+ * @return Wartość @p true lub @p false, jeśli mapa ma wartość NULL lub nie
+ * udało się zaalokować pamięci (pamięć podręczna jest wtedy wyłączona).
  */
-bool updateRoad(Map *map, const char *cityName1, const char *cityName2,
-                unsigned length, int builtYear) {
-    if (!isValidInput(map, cityName1, cityName2) || length == 0 || builtYear == 0) {
+bool setSearchCacheMap(Map *map, size_t budget) {
+    if (map == NULL) {
         return false;
     }
 
-    City *city1 = findCityOnHashMapInsertIfNecessary(map->citiesMap,
-                                                     map->cities, cityName1);
-    City *city2 = findCityOnHashMapInsertIfNecessary(map->citiesMap,
-                                                     map->cities, cityName2);
-    if (city1 == NULL || city2 == NULL) {
-        return false;
+    SearchCache *cache = NULL;
+    if (budget != 0) {
+        cache = newSearchCache(budget, &map->graphVersion);
     }
 
-    ListIterator *iterator = findRoadModule(city1, city2);
-    if (iterator == NULL) {
-        return addRoadModule(city1, city2, length, builtYear);
-    } else {
-        Road *road = iterator->data;
-        if (road->length != length) {
-            return false;
-        } else {
-            return repairRoadModule(city1, city2, builtYear);
+    deleteSearchCache(map->searchCache);
+    map->searchCache = cache;
+    map->searchState->cache = cache;
+    if (map->threadPool != NULL) {
+        uint32_t threadsCount = threadsCountThreadPool(map->threadPool);
+        for (uint32_t i = 0; i < threadsCount; i++) {
+            map->threadsSearchStates[i]->cache = cache;
         }
     }
+
+    return budget == 0 || cache != NULL;
 }
 
-/** @brief Usuwa z mapy dróg drogę krajową.
- * Usuwa z mapy dróg drogę krajową o podanym numerze, jeśli taka istnieje.
- * Nie usuwa odcinków dróg ani miast.
- * @param[in,out] map   – wskaźnik na strukturę przechowującą mapę dróg;
- * @param[in] routeId   - numer drogi krajowej.
- * @return Wartość @p false, gdy podana droga krajowa nie istnieje lub
- * podany numer jest niepoprawny. Wartość @p true w przeciwnym wypadku.
+/** @brief Zwraca liczniki pamięci podręcznej drzew najkrótszych dróg.
+ * @param[in] map        – wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Liczniki pamięci podręcznej lub same zera, jeśli jest wyłączona.
  */
-bool removeRoute(Map *map, unsigned routeId) {
-    if (map == NULL) {
-        return false;
+SearchCacheStatistics getSearchCacheStatisticsMap(Map *map) {
+    assert(map);
+
+    SearchCacheStatistics result;
+    if (map->searchCache == NULL) {
+        memset(&result, 0, sizeof(SearchCacheStatistics));
+        return result;
+    }
+
+    return getStatisticsSearchCache(map->searchCache);
+}
+
+/** @brief Szacuje pamięć zajmowaną przez mapę.
+ * Liczy bajty struktur mapy: miast z nazwami, odcinków dróg, dróg krajowych,
+ * haszmapy miast, stanów algorytmu wyszukiwania, indeksów (punktów
+ * orientacyjnych, hierarchii kontrakcji, wyrocznii spójności, objazdów dróg
+ * krajowych) i odwzorowanego obrazu. Nie liczy narzutu alokatora, dziennika
+ * ani opisów dla współbieżnych odczytów.
+ * @param[in] map        – wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Liczba bajtów.
+ */
+size_t memoryUsageMap(Map *map) {
+    assert(map);
+
+    size_t result = sizeof(Map) + memoryUsageList(map->cities) +
+                    memoryUsageList(map->routes) +
+                    memoryUsageHashMap(map->citiesMap) +
+                    memoryUsageSearchState(map->searchState) +
+                    memoryUsageConnectivityOracle(map->connectivity);
+
+    for (ListIterator *iterator = map->cities->begin;
+         iterator != map->cities->end; iterator = iterator->next) {
+        City *city = iterator->data;
+        result += sizeof(City) + strlen(city->name) + 1 +
+                  memoryUsageList(city->roads) +
+                  sizeof(Road) * sizeList(city->roads);
+    }
+
+    for (ListIterator *iterator = map->routes->begin;
+         iterator != map->routes->end; iterator = iterator->next) {
+        Route *route = iterator->data;
+        result += sizeof(Route) + memoryUsageList(route->cities);
+        if (route->replacementPaths != NULL) {
+            result += memoryUsageReplacementPaths(route->replacementPaths);
+        }
+    }
+    result += sizeof(unsigned) * map->indexedRoutesCount;
+
+    if (map->threadPool != NULL) {
+        uint32_t threadsCount = threadsCountThreadPool(map->threadPool);
+        result += sizeof(SearchState *) * threadsCount;
+        for (uint32_t i = 0; i < threadsCount; i++) {
+            result += memoryUsageSearchState(map->threadsSearchStates[i]);
+        }
+    }
+
+    if (map->landmarks != NULL) {
+        result += memoryUsageLandmarkIndex(map->landmarks);
+    }
+    if (map->hierarchy != NULL) {
+        result += memoryUsageContractionHierarchy(map->hierarchy);
+    }
+    if (map->image != NULL) {
+        result += sizeof(MapImage) + map->image->size;
+    }
+    if (map->searchCache != NULL) {
+        result += memoryUsageSearchCache(map->searchCache);
+    }
+
+    return result;
+}
+
+/** @brief Usuwa strukturę.
+ * Usuwa strukturę wskazywaną przez @p map.
+ * Nic nie robi, jeśli wskaźnik ten ma wartość NULL.
+ * @param[in] map        – wskaźnik na usuwaną strukturę.
+ */
+void deleteMap(Map *map) {
+    if (map == NULL) {
+        return;
+    }
+
+    ListIterator *iterator = map->cities->begin;
+    while (iterator != map->cities->end) {
+        deleteCity(iterator->data);
+        iterator = iterator->next;
+    }
+    deleteList(map->cities, false);
+
+    iterator = map->routes->begin;
+    while (iterator != map->routes->end) {
+        deleteRouteModule(iterator->data);
+        iterator = iterator->next;
+    }
+    deleteList(map->routes, false);
+
+    deleteHashMap(map->citiesMap);
+    deleteSearchState(map->searchState);
+    deleteThreadPoolMap(map);
+    deleteLandmarkIndex(map->landmarks);
+    deleteContractionHierarchy(map->hierarchy);
+    deleteConnectivityOracle(map->connectivity);
+    deleteSearchCache(map->searchCache);
+    free(map->indexedRouteIds);
+    closeMapImage(map->image);
+    waitForCheckpointMap(map);
+    closeJournal(map->journal);
+    deleteRouteSnapshots(map->snapshots);
+
+    free(map);
+}
+
+/** @brief Zapisuje plik przez plik tymczasowy.
+ * Zapisuje dane funkcją @p write do pliku tymczasowego, który na końcu
+ * zastępuje plik @p path, więc przerwany zapis nie psuje poprzedniego pliku.
+ * @param[in] map        – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] path       – wskaźnik na ścieżkę do pliku;
+ * @param[in] write      – funkcja zapisująca dane mapy do pliku.
+ * @return Wartość @p true, jeśli plik został zapisany. Wartość @p false,
+ * jeśli nie udało się zapisać pliku lub zaalokować pamięci.
+ */
+bool writeFileMap(Map *map, const char *path, bool (*write)(Map *, FILE *)) {
+    size_t pathLength = strlen(path);
+    char *temporaryPath = malloc(pathLength + 5);
+    if (temporaryPath == NULL) {
+        return false;
+    }
+    memcpy(temporaryPath, path, pathLength);
+    memcpy(temporaryPath + pathLength, ".tmp", 5);
+
+    FILE *file = fopen(temporaryPath, "wb");
+    if (file == NULL) {
+        free(temporaryPath);
+        return false;
+    }
+
+    bool result = write(map, file);
+    result = fclose(file) == 0 && result;
+    if (result) {
+        result = rename(temporaryPath, path) == 0;
+    }
+    if (!result) {
+        remove(temporaryPath);
+    }
+
+    free(temporaryPath);
+
+    return result;
+}
+
+/** @brief Zapisuje mapę do pliku.
+ * Zapisuje miasta, odcinki dróg i drogi krajowe w zwartym, binarnym formacie
+ * z numerem wersji i sumą kontrolną (zob. @ref snapshot.h). Obraz zapisywany
+ * jest do pliku tymczasowego, który na końcu zastępuje plik @p path, więc
+ * przerwany zapis nie psuje poprzedniego obrazu.
+ * @param[in] map        – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] path       – wskaźnik na ścieżkę do pliku.
+ * @return Wartość @p true, jeśli mapa została zapisana. Wartość @p false,
+ * jeśli któryś z parametrów ma wartość NULL, nie udało się zapisać pliku lub
+ * zaalokować pamięci.
+ */
+bool saveMap(Map *map, const char *path) {
+    if (map == NULL || path == NULL || !promoteMap(map)) {
+        return false;
+    }
+
+    return writeFileMap(map, path, writeSnapshot);
+}
+
+/** @brief Wczytuje mapę z pliku.
+ * Tworzy nową strukturę z miastami, odcinkami dróg i drogami krajowymi
+ * zapisanymi funkcją @ref saveMap, bez interpretowania poleceń tekstowych.
+ * @param[in] path       – wskaźnik na ścieżkę do pliku.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy plik nie istnieje,
+ * nie jest poprawnym obrazem mapy (np. ma inną wersję lub niezgodną sumę
+ * kontrolną) lub nie udało się zaalokować pamięci.
+ */
+Map *loadMap(const char *path) {
+    if (path == NULL) {
+        return NULL;
+    }
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+
+    Map *result = newMap();
+    if (result != NULL && !readSnapshot(result, file)) {
+        deleteMap(result);
+        result = NULL;
+    }
+
+    fclose(file);
+
+    return result;
+}
+
+/** @brief Zapisuje obraz mapy do odwzorowania w pamięci.
+ * Zapisuje miasta, listy sąsiedztwa, drogi krajowe i nazwy miast w formacie
+ * bez wskaźników (zob. @ref map_image.h), który funkcja @ref openMap
+ * odwzorowuje w pamięci bez wczytywania. Plik zapisywany jest przez plik
+ * tymczasowy.
+ * @param[in] map        – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] path       – wskaźnik na ścieżkę do pliku.
+ * @return Wartość @p true, jeśli obraz został zapisany. Wartość @p false,
+ * jeśli któryś z parametrów ma wartość NULL, nie udało się zapisać pliku lub
+ * zaalokować pamięci.
+ */
+bool saveMapImage(Map *map, const char *path) {
+    if (map == NULL || path == NULL || !promoteMap(map)) {
+        return false;
+    }
+
+    return writeFileMap(map, path, writeMapImage);
+}
+
+/** @brief Odwzorowuje obraz mapy w pamięci.
+ * Tworzy mapę tylko do zapytań opartą na obrazie zapisanym funkcją
+ * @ref saveMapImage. Obraz nie jest wczytywany, a jego strony są
+ * współdzielone przez procesy korzystające z tego samego pliku. Pierwsze
+ * polecenie modyfikujące mapę zamienia ją na zwykłą mapę
+ * (zob. @ref promoteMap).
+ * @param[in] path       – wskaźnik na ścieżkę do pliku.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy plik nie jest
+ * poprawnym obrazem mapy lub nie udało się zaalokować pamięci.
+ */
+Map *openMap(const char *path) {
+    if (path == NULL) {
+        return NULL;
+    }
+
+    Map *result = newMap();
+    if (result == NULL) {
+        return NULL;
+    }
+
+    result->image = openMapImage(path);
+    if (result->image == NULL) {
+        deleteMap(result);
+        return NULL;
+    }
+
+    return result;
+}
+
+/** @brief Zamienia mapę tylko do zapytań na zwykłą mapę.
+ * Kopiuje obraz mapy odwzorowany funkcją @ref openMap do struktur mapy
+ * i zwalnia odwzorowanie. Nic nie robi dla zwykłej mapy.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Wartość @p true, jeśli mapa jest zwykłą mapą. Wartość @p false,
+ * jeśli obraz jest uszkodzony (mapa pozostaje wtedy mapą tylko do zapytań)
+ * lub nie udało się zaalokować pamięci.
+ */
+bool promoteMap(Map *map) {
+    if (map == NULL) {
+        return false;
+    }
+
+    if (map->image == NULL) {
+        return true;
+    }
+
+    bool result = copyMapImage(map->image, map);
+    if (!result && map->cities->begin == map->cities->end) {
+        return false;
+    }
+    changedRoadsMap(map);
+
+    closeMapImage(map->image);
+    map->image = NULL;
+    map->promotionsCount++;
+
+    return result;
+}
+
+/** @brief Odtwarza mapę z punktu kontrolnego i dziennika.
+ * Wczytuje punkt kontrolny zapisany funkcją @ref saveMap (lub tworzy pustą
+ * mapę, jeśli plik @p checkpointPath nie istnieje), a następnie wykonuje
+ * polecenia zapisane w dzienniku po tym punkcie kontrolnym, bez
+ * interpretowania poleceń tekstowych. Niedokończony rekord na końcu
+ * dziennika jest usuwany. Od tej chwili każde udane polecenie modyfikujące
+ * mapę jest dopisywane do dziennika (zob. @ref journal.h).
+ * @param[in] checkpointPath – wskaźnik na ścieżkę do punktu kontrolnego;
+ * @param[in] journalPath – wskaźnik na ścieżkę do pliku dziennika.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy punkt kontrolny nie
+ * jest poprawnym obrazem mapy, w dzienniku brakuje rekordów następujących po
+ * punkcie kontrolnym, nie udało się otworzyć dziennika lub zaalokować
+ * pamięci.
+ */
+Map *recoverMap(const char *checkpointPath, const char *journalPath) {
+    if (checkpointPath == NULL || journalPath == NULL) {
+        return NULL;
+    }
+
+    Map *result = newMap();
+    if (result == NULL) {
+        return NULL;
+    }
+
+    uint64_t sequence = 0;
+    FILE *file = fopen(checkpointPath, "rb");
+    if (file == NULL && errno != ENOENT) {
+        deleteMap(result);
+        return NULL;
+    }
+    if (file != NULL) {
+        bool isLoaded = readSequenceSnapshot(file, &sequence) &&
+                        fseek(file, 0, SEEK_SET) == 0 &&
+                        readSnapshot(result, file);
+        fclose(file);
+        if (!isLoaded) {
+            deleteMap(result);
+            return NULL;
+        }
+    }
+
+    /* Rekordy dziennika uwzględnione w punkcie kontrolnym są pomijane. */
+    uint64_t validSize = 0;
+    uint64_t replayedCount = 0;
+    file = fopen(journalPath, "rb");
+    if (file == NULL && errno != ENOENT) {
+        deleteMap(result);
+        return NULL;
+    }
+    if (file != NULL) {
+        bool isReplayed = replayJournal(result, file, &sequence, &validSize,
+                                        &replayedCount);
+        fclose(file);
+        if (!isReplayed) {
+            deleteMap(result);
+            return NULL;
+        }
+    }
+
+    result->journal = openJournal(journalPath, checkpointPath, sequence,
+                                  validSize);
+    if (result->journal == NULL) {
+        deleteMap(result);
+        return NULL;
+    }
+    result->journal->replayedCount = replayedCount;
+
+    return result;
+}
+
+/** @brief Ustawia sposób zapisu dziennika mapy.
+ * Rekordy dziennika zapisywane są do pliku (i synchronizowane) grupami po
+ * @p groupSize poleceń, więc po awarii można stracić mniej niż
+ * @p groupSize ostatnich poleceń. Co @p checkpointInterval poleceń zapisywany
+ * jest punkt kontrolny (zob. @ref checkpointMap).
+ * @param[in,out] map    – wskaźnik na mapę utworzoną funkcją @ref recoverMap;
+ * @param[in] groupSize  – liczba rekordów zapisywanych naraz, dodatnia;
+ * @param[in] checkpointInterval – liczba poleceń między punktami kontrolnymi
+ *                         lub @p 0, jeśli punkty nie są zapisywane
+ *                         automatycznie.
+ * @return Wartość @p true lub @p false, jeśli mapa nie ma dziennika lub
+ * @p groupSize jest równe @p 0.
+ */
+bool setJournalPolicyMap(Map *map, uint32_t groupSize,
+                         uint32_t checkpointInterval) {
+    if (map == NULL || map->journal == NULL || groupSize == 0) {
+        return false;
+    }
+
+    map->journal->groupSize = groupSize;
+    map->journal->checkpointInterval = checkpointInterval;
+    if (map->journal->pendingRecords >= groupSize) {
+        syncJournal(map->journal);
+    }
+
+    return true;
+}
+
+/** @brief Włącza zapisywanie punktów kontrolnych w tle.
+ * Automatyczne punkty kontrolne (zob. @ref setJournalPolicyMap) zapisuje
+ * wtedy proces potomny utworzony funkcją fork z kopii mapy współdzielonej
+ * z rodzicem do chwili zapisu (copy-on-write), a rodzic w tym czasie
+ * wykonuje dalsze polecenia.
+ * @param[in,out] map    – wskaźnik na mapę utworzoną funkcją @ref recoverMap;
+ * @param[in] isBackground – czy zapisywać punkty kontrolne w tle.
+ * @return Wartość @p true lub @p false, jeśli mapa nie ma dziennika.
+ */
+bool setBackgroundCheckpointsMap(Map *map, bool isBackground) {
+    if (map == NULL || map->journal == NULL) {
+        return false;
+    }
+
+    map->journal->isBackground = isBackground;
+
+    return true;
+}
+
+/** @brief Kończy zapisywanie punktu kontrolnego w tle.
+ * Jeśli proces potomny zapisał punkt kontrolny, to odczytuje jego wyniki
+ * i usuwa z dziennika rekordy sprzed rozwidlenia.
+ * @param[in,out] map    – wskaźnik na mapę z dziennikiem;
+ * @param[in] wait       – czy czekać na zakończenie procesu potomnego.
+ * @return Wartość @p true, jeśli nie ma już procesu potomnego. Wartość
+ * @p false, jeśli proces potomny wciąż zapisuje punkt kontrolny.
+ */
+bool finishCheckpointMap(Map *map, bool wait) {
+    Journal *journal = map->journal;
+    if (journal->checkpointPid == 0) {
+        return true;
+    }
+
+    int status;
+    pid_t pid;
+    do {
+        pid = waitpid(journal->checkpointPid, &status, wait ? 0 : WNOHANG);
+    } while (pid < 0 && errno == EINTR);
+    if (pid == 0) {
+        return false;
+    }
+
+    JournalCheckpointReport report;
+    bool result = pid == journal->checkpointPid && WIFEXITED(status) &&
+                  WEXITSTATUS(status) == 0 &&
+                  read(journal->checkpointPipe, &report,
+                       sizeof(JournalCheckpointReport)) ==
+                  sizeof(JournalCheckpointReport);
+    close(journal->checkpointPipe);
+    journal->checkpointPipe = -1;
+    journal->checkpointPid = 0;
+
+    if (!result) {
+        journal->errorsCount++;
+        return true;
+    }
+
+    journal->backgroundCount++;
+    journal->checkpointsCount++;
+    journal->snapshotNanoseconds += report.nanoseconds;
+    journal->copiedPages += report.copiedPages;
+
+    /* Rekordy od chwili rozwidlenia przenosimy do nowego pliku. */
+    if (syncJournal(journal)) {
+        compactJournal(journal, journal->checkpointOffset,
+                       journal->checkpointSequence);
+    }
+
+    return true;
+}
+
+/** @brief Czeka na zakończenie zapisywania punktu kontrolnego w tle.
+ * Nic nie robi, jeśli mapa nie ma dziennika lub żaden punkt kontrolny nie
+ * jest zapisywany.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg.
+ */
+void waitForCheckpointMap(Map *map) {
+    if (map != NULL && map->journal != NULL) {
+        finishCheckpointMap(map, true);
+    }
+}
+
+/** @brief Zaczyna zapisywanie punktu kontrolnego w tle.
+ * Zapisuje niezapisane rekordy dziennika i tworzy proces potomny, który
+ * zapisuje mapę funkcją @ref saveMap, przekazuje rodzicowi czas zapisu
+ * i liczbę skopiowanych stron, a następnie kończy działanie.
+ * @param[in,out] map    – wskaźnik na mapę z dziennikiem.
+ * @return Wartość @p true, jeśli proces potomny został utworzony. Wartość
+ * @p false, jeśli nie udało się zapisać dziennika lub utworzyć procesu.
+ */
+bool startCheckpointMap(Map *map) {
+    Journal *journal = map->journal;
+    assert(journal->checkpointPid == 0);
+
+    int descriptors[2];
+    if (!syncJournal(journal) || pipe(descriptors) != 0) {
+        journal->errorsCount++;
+        return false;
+    }
+
+    uint64_t start = nanosecondsJournal();
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(descriptors[0]);
+        close(descriptors[1]);
+        journal->errorsCount++;
+        return false;
+    }
+
+    if (pid == 0) {
+        /* Proces potomny nie może zapisać buforów stdio rodzica, więc
+         * kończy działanie funkcją _exit. */
+        close(descriptors[0]);
+        bool result = saveMap(map, journal->checkpointPath);
+
+        JournalCheckpointReport report;
+        report.nanoseconds = nanosecondsJournal() - start;
+        report.copiedPages = privatePagesJournal();
+        result = write(descriptors[1], &report,
+                       sizeof(JournalCheckpointReport)) ==
+                 sizeof(JournalCheckpointReport) && result;
+        _exit(result ? 0 : 1);
+    }
+
+    uint64_t forkNanoseconds = nanosecondsJournal() - start;
+    close(descriptors[1]);
+    journal->checkpointPid = pid;
+    journal->checkpointPipe = descriptors[0];
+    journal->checkpointOffset = journal->fileSize;
+    journal->checkpointSequence = journal->sequence;
+    journal->recordsSinceCheckpoint = 0;
+    journal->forkNanoseconds += forkNanoseconds;
+    if (forkNanoseconds > journal->maxForkNanoseconds) {
+        journal->maxForkNanoseconds = forkNanoseconds;
+    }
+
+    return true;
+}
+
+/** @brief Zapisuje punkt kontrolny mapy.
+ * Czeka na zakończenie zapisywania punktu kontrolnego w tle, zapisuje
+ * niezapisane rekordy dziennika, zapisuje mapę funkcją @ref saveMap do
+ * pliku punktu kontrolnego i zaczyna nowy, pusty dziennik. Punkt kontrolny
+ * zawiera numer następnego rekordu dziennika, więc jeśli zapis zostanie
+ * przerwany przed zastąpieniem dziennika, to przy odtwarzaniu uwzględnione
+ * rekordy są pomijane.
+ * @param[in,out] map    – wskaźnik na mapę utworzoną funkcją @ref recoverMap.
+ * @return Wartość @p true lub @p false, jeśli mapa nie ma dziennika, nie
+ * udało się zapisać pliku lub zaalokować pamięci.
+ */
+bool checkpointMap(Map *map) {
+    if (map == NULL || map->journal == NULL) {
+        return false;
+    }
+
+    Journal *journal = map->journal;
+    finishCheckpointMap(map, true);
+    if (!syncJournal(journal) || !saveMap(map, journal->checkpointPath)) {
+        journal->errorsCount++;
+        return false;
+    }
+
+    journal->recordsSinceCheckpoint = 0;
+    journal->checkpointsCount++;
+
+    return compactJournal(journal, journal->fileSize, journal->sequence);
+}
+
+/** @brief Kończy dopisywanie polecenia do dziennika.
+ * Odbiera wyniki zakończonego zapisu punktu kontrolnego w tle i zapisuje
+ * punkt kontrolny (w tle lub od razu), jeśli od poprzedniego dopisano
+ * ustaloną liczbę poleceń.
+ * @param[in,out] map    – wskaźnik na mapę z dziennikiem.
+ */
+void commitJournalMap(Map *map) {
+    Journal *journal = map->journal;
+    if (!finishCheckpointMap(map, false) || journal->checkpointInterval == 0 ||
+            journal->recordsSinceCheckpoint < journal->checkpointInterval) {
+        return;
+    }
+
+    if (journal->isBackground) {
+        startCheckpointMap(map);
+    } else {
+        checkpointMap(map);
+    }
+}
+
+/** @brief Dopisuje do dziennika polecenie dotyczące odcinka drogi.
+ * Nic nie robi, jeśli mapa nie ma dziennika.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] type       – typ polecenia;
+ * @param[in] cityName1  – wskaźnik na napis reprezentujący nazwę miasta;
+ * @param[in] cityName2  – wskaźnik na napis reprezentujący nazwę miasta;
+ * @param[in] length     – długość odcinka drogi lub @p 0;
+ * @param[in] year       – rok budowy lub remontu odcinka drogi lub @p 0.
+ */
+void journalRoadMap(Map *map, JournalRecordType type, const char *cityName1,
+                    const char *cityName2, unsigned length, int year) {
+    if (map->journal == NULL) {
+        return;
+    }
+
+    appendRoadJournal(map->journal, type, cityName1, cityName2, length, year);
+    commitJournalMap(map);
+}
+
+/** @brief Dopisuje do dziennika polecenie dotyczące drogi krajowej.
+ * Nic nie robi, jeśli mapa nie ma dziennika.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] type       – typ polecenia;
+ * @param[in] routeId    – numer drogi krajowej;
+ * @param[in] cityName1  – wskaźnik na napis reprezentujący nazwę miasta lub
+ *                         NULL;
+ * @param[in] cityName2  – wskaźnik na napis reprezentujący nazwę miasta lub
+ *                         NULL.
+ */
+void journalRouteCommandMap(Map *map, JournalRecordType type, unsigned routeId,
+                            const char *cityName1, const char *cityName2) {
+    if (map->journal == NULL) {
+        return;
+    }
+
+    appendRouteJournal(map->journal, type, routeId, cityName1, cityName2);
+    commitJournalMap(map);
+}
+
+/** @brief Dopisuje do dziennika drogę krajową podaną przez miasta.
+ * Wywoływana po dodaniu do mapy drogi krajowej zbudowanej z kolejnych miast
+ * (a nie wyznaczonej funkcją @ref newRoute). Nic nie robi, jeśli mapa nie ma
+ * dziennika.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] routeId    – numer dodanej drogi krajowej.
+ */
+void journalRouteMap(Map *map, unsigned routeId) {
+    if (map == NULL || map->journal == NULL) {
+        return;
+    }
+
+    ListIterator *iterator = findRouteOnList(map->routes, routeId);
+    if (iterator == NULL) {
+        return;
+    }
+
+    Route *route = iterator->data;
+    appendRouteDefinitionJournal(map->journal, routeId, route->cities);
+    commitJournalMap(map);
+}
+
+/** @brief Zapisuje opis drogi krajowej dla @ref publishRouteSnapshots.
+ * @param[in,out] argument  - wskaźnik na mapę;
+ * @param[in] routeId       - numer drogi krajowej;
+ * @param[out] buffer       - wskaźnik na bufor lub NULL;
+ * @param[in] bufferSize    - rozmiar bufora.
+ * @return Wynik @ref writeRouteDescription.
+ */
+size_t writeSnapshotMap(void *argument, unsigned routeId, char *buffer,
+                        size_t bufferSize) {
+    return writeRouteDescription(argument, routeId, buffer, bufferSize);
+}
+
+/** @brief Oznacza drogę krajową do publikacji opisu.
+ * Nic nie robi, jeśli współbieżne odczyty są wyłączone.
+ * @param[in,out] map       - wskaźnik na mapę;
+ * @param[in] routeId       - numer drogi krajowej.
+ */
+void markRouteMap(Map *map, unsigned routeId) {
+    if (map->snapshots != NULL) {
+        markRouteSnapshots(map->snapshots, routeId);
+    }
+}
+
+/** @brief Oznacza do publikacji drogi krajowe przechodzące przez odcinek.
+ * Nic nie robi, jeśli współbieżne odczyty są wyłączone.
+ * @param[in,out] map       - wskaźnik na mapę;
+ * @param[in] city1         - wskaźnik na pierwsze miasto odcinka;
+ * @param[in] city2         - wskaźnik na drugie miasto odcinka.
+ */
+void markRoadRoutesMap(Map *map, City *city1, City *city2) {
+    if (map->snapshots == NULL) {
+        return;
+    }
+
+    ListIterator *iterator = map->routes->begin;
+    while (iterator != map->routes->end) {
+        Route *route = iterator->data;
+        if (findRemovedRoadOnRoute(route, city1, city2) != NULL) {
+            markRouteSnapshots(map->snapshots, route->routeId);
+        }
+        iterator = iterator->next;
+    }
+}
+
+/** @brief Publikuje opisy oznaczonych dróg krajowych.
+ * Modyfikacja mapy już się powiodła, więc brak pamięci nie jest zgłaszany:
+ * drogi krajowe pozostają oznaczone i są publikowane przy następnej
+ * modyfikacji.
+ * @param[in,out] map       - wskaźnik na mapę.
+ */
+void publishRoutesMap(Map *map) {
+    if (map->snapshots != NULL) {
+        publishRouteSnapshots(map->snapshots, writeSnapshotMap, map);
+    }
+}
+
+/** @brief Sprawdza czy droga krajowa ma mieć indeks objazdów.
+ * @param[in] map           - wskaźnik na mapę;
+ * @param[in] routeId       - numer drogi krajowej.
+ * @return Wartość @p true, jeśli numer włączono funkcją
+ * @ref setReplacementPathsMap, lub @p false w przeciwnym przypadku.
+ */
+bool isIndexedRouteMap(Map *map, unsigned routeId) {
+    for (uint32_t i = 0; i < map->indexedRoutesCount; i++) {
+        if (map->indexedRouteIds[i] == routeId) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/** @brief Unieważnia wszystkie objazdy w indeksach dróg krajowych.
+ * Należy wywołać po zmianie, która może poprawić dowolny objazd: dodaniu
+ * lub remoncie odcinka drogi.
+ * @param[in,out] map       - wskaźnik na mapę.
+ */
+void invalidateReplacementPathsMap(Map *map) {
+    if (map->indexedRoutesCount == 0) {
+        return;
+    }
+
+    ListIterator *iterator = map->routes->begin;
+    while (iterator != map->routes->end) {
+        Route *route = iterator->data;
+        if (route->replacementPaths != NULL) {
+            invalidateReplacementPaths(route->replacementPaths);
+        }
+        iterator = iterator->next;
+    }
+}
+
+/** @brief Sprawdza czy któraś droga krajowa ma indeks objazdów.
+ * @param[in] map           - wskaźnik na mapę.
+ * @return Wartość @p true, jeśli istnieje droga krajowa z indeksem objazdów,
+ * lub @p false w przeciwnym przypadku.
+ */
+bool hasReplacementPathsMap(Map *map) {
+    if (map->indexedRoutesCount == 0) {
+        return false;
+    }
+
+    ListIterator *iterator = map->routes->begin;
+    while (iterator != map->routes->end) {
+        if (((Route *)iterator->data)->replacementPaths != NULL) {
+            return true;
+        }
+        iterator = iterator->next;
+    }
+
+    return false;
+}
+
+/** @brief Sprawdza czy dodanie odcinka drogi może zmienić objazdy.
+ * Odcinek łączący dwie składowe mapy nie leży na żadnej drodze bez
+ * powtarzających się miast między miastami jednej składowej, więc nie
+ * zmienia objazdów w indeksach. Wyrocznia spójności pytana jest tylko wtedy,
+ * gdy istnieje droga krajowa z indeksem. Należy wywołać przed dodaniem
+ * odcinka.
+ * @param[in,out] map       - wskaźnik na mapę;
+ * @param[in] city1         - wskaźnik na pierwsze miasto odcinka;
+ * @param[in] city2         - wskaźnik na drugie miasto odcinka.
+ * @return Wartość @p true, jeśli odcinek może zmienić objazdy, lub @p false
+ * w przeciwnym przypadku.
+ */
+bool isAddedRoadOnDetoursMap(Map *map, City *city1, City *city2) {
+    if (!hasReplacementPathsMap(map)) {
+        return false;
+    }
+
+    /* Miasto bez odcinków może nie być jeszcze znane wyroczni. */
+    if (city1->roads->begin == city1->roads->end ||
+            city2->roads->begin == city2->roads->end) {
+        return false;
+    }
+
+    return areConnectedConnectivityOracle(map->connectivity, city1, city2);
+}
+
+/** @brief Odnotowuje usunięcie odcinka drogi w indeksach dróg krajowych.
+ * @param[in,out] map       - wskaźnik na mapę;
+ * @param[in] city1         - wskaźnik na pierwsze miasto odcinka;
+ * @param[in] city2         - wskaźnik na drugie miasto odcinka.
+ */
+void removedRoadReplacementPathsMap(Map *map, City *city1, City *city2) {
+    if (map->indexedRoutesCount == 0) {
+        return;
+    }
+
+    ListIterator *iterator = map->routes->begin;
+    while (iterator != map->routes->end) {
+        Route *route = iterator->data;
+        if (route->replacementPaths != NULL) {
+            removedRoadReplacementPaths(route->replacementPaths, city1, city2);
+        }
+        iterator = iterator->next;
+    }
+}
+
+/** @brief Uaktualnia indeksy objazdów dróg krajowych.
+ * Tworzy brakujące indeksy dróg krajowych o numerach włączonych funkcją
+ * @ref setReplacementPathsMap i uzgadnia je z miastami dróg krajowych.
+ * Nieaktualne objazdy nie są wyznaczane: robią to dopiero @ref removeRoad
+ * i @ref checkRemoveRoad, gdy objazd jest potrzebny. Należy wywołać na końcu
+ * udanej modyfikacji mapy. Modyfikacja już się powiodła, więc brak pamięci
+ * nie jest zgłaszany: droga krajowa pozostaje wtedy bez indeksu lub z pustym
+ * indeksem do następnej modyfikacji.
+ * @param[in,out] map       - wskaźnik na mapę.
+ */
+void refreshReplacementPathsMap(Map *map) {
+    if (map->indexedRoutesCount == 0) {
+        return;
+    }
+
+    ListIterator *iterator = map->routes->begin;
+    while (iterator != map->routes->end) {
+        Route *route = iterator->data;
+        iterator = iterator->next;
+        if (route->replacementPaths == NULL) {
+            if (!isIndexedRouteMap(map, route->routeId)) {
+                continue;
+            }
+            route->replacementPaths = newReplacementPaths();
+            if (route->replacementPaths == NULL) {
+                continue;
+            }
+        }
+
+        syncReplacementPaths(route->replacementPaths, route->cities);
+    }
+}
+
+/** @brief Włącza lub wyłącza indeks objazdów drogi krajowej.
+ * Droga krajowa o podanym numerze (także utworzona później) dostaje indeks
+ * objazdów każdego swojego odcinka (zob. @ref ReplacementPaths), z którego
+ * @ref removeRoad i @ref checkRemoveRoad odczytują objazd zamiast go
+ * wyszukiwać. Funkcje modyfikujące mapę tylko oznaczają jako nieaktualne
+ * objazdy, na które zmiana mogła wpłynąć. Nieaktualny objazd wyznaczany jest
+ * ponownie dopiero przy pierwszym odczycie i zapamiętywany, więc kolejne
+ * odczyty do następnej zmiany, która mogła na niego wpłynąć, nie wyszukują.
+ * @param[in,out] map       – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] routeId       – numer drogi krajowej;
+ * @param[in] isEnabled     – czy włączyć indeks.
+ * @return Wartość @p true lub @p false, jeśli mapa ma wartość NULL, numer
+ * jest niepoprawny lub nie udało się zaalokować pamięci.
+ */
+bool setReplacementPathsMap(Map *map, unsigned routeId, bool isEnabled) {
+    if (map == NULL || routeId < 1 || 999 < routeId) {
+        return false;
+    }
+
+    if (isEnabled == isIndexedRouteMap(map, routeId)) {
+        return true;
+    }
+
+    if (!isEnabled) {
+        for (uint32_t i = 0; i < map->indexedRoutesCount; i++) {
+            if (map->indexedRouteIds[i] == routeId) {
+                map->indexedRouteIds[i] =
+                        map->indexedRouteIds[--map->indexedRoutesCount];
+                break;
+            }
+        }
+
+        ListIterator *iterator = findRouteOnList(map->routes, routeId);
+        if (iterator != NULL) {
+            Route *route = iterator->data;
+            deleteReplacementPaths(route->replacementPaths);
+            route->replacementPaths = NULL;
+        }
+
+        return true;
+    }
+
+    unsigned *routeIds = realloc(map->indexedRouteIds, sizeof(unsigned) *
+                                 (map->indexedRoutesCount + 1));
+    if (routeIds == NULL) {
+        return false;
+    }
+    routeIds[map->indexedRoutesCount++] = routeId;
+    map->indexedRouteIds = routeIds;
+
+    refreshReplacementPathsMap(map);
+
+    return true;
+}
+
+/** @brief Zwraca liczniki indeksów objazdów dróg krajowych.
+ * @param[in] map        – wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Suma liczników indeksów istniejących dróg krajowych.
+ */
+ReplacementPathsStatistics getReplacementPathsStatisticsMap(Map *map) {
+    assert(map);
+
+    ReplacementPathsStatistics result;
+    memset(&result, 0, sizeof(ReplacementPathsStatistics));
+
+    ListIterator *iterator = map->routes->begin;
+    while (iterator != map->routes->end) {
+        Route *route = iterator->data;
+        if (route->replacementPaths != NULL) {
+            addStatisticsReplacementPaths(route->replacementPaths, &result);
+        }
+        iterator = iterator->next;
+    }
+
+    return result;
+}
+
+/** @brief Sprawdza zgodność danych ze specyfikacją zadania.
+ * Poprawne dane to takie, w których wskaźnik na mapę nie jest równy NULL,
+ * podane opisy nazw, które nie są równe NULL, opisują poprawne nazwy miast
+ * oraz jeśli podano oba opisy, to nazwy muszą być różne.
+ * @param[in] map       - wskaźnik na mapę;
+ * @param[in] cityName1 - wskaźnik na opis pierwszej nazwy lub NULL;
+ * @param[in] cityName2 - wskaźnik na opis drugiej nazwy lub NULL.
+ * @return Wartość @p true jeśli dane są poprawne lub @p false w przeciwnym
+ * przypadku.
+ */
+bool isValidNamesMap(Map *map, const CityName *cityName1,
+                     const CityName *cityName2) {
+    if (map == NULL) {
+        return false;
+    }
+
+    if (cityName1 != NULL && !cityName1->isValid) {
+        return false;
+    }
+
+    if (cityName2 != NULL && !cityName2->isValid) {
+        return false;
+    }
+
+    if (cityName1 != NULL && cityName2 != NULL &&
+            cityName1->hash == cityName2->hash &&
+            strcmp(cityName1->name, cityName2->name) == 0) {
+        return false;
+    }
+
+    return true;
+}
+
+/** @brief Dodaje do mapy odcinek drogi między dwoma różnymi miastami.
+ * Działa jak @ref addRoad dla nazw z policzonymi haszami.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName1  – wskaźnik na opis nazwy pierwszego miasta;
+ * @param[in] cityName2  – wskaźnik na opis nazwy drugiego miasta;
+ * @param[in] length     – długość w km odcinka drogi;
+ * @param[in] builtYear  – rok budowy odcinka drogi.
+ * @return Wartość @p true, jeśli odcinek drogi został dodany lub @p false
+ * w przeciwnym przypadku.
+ */
+bool addRoadByNamesMap(Map *map, const CityName *cityName1,
+                       const CityName *cityName2, unsigned length,
+                       int builtYear) {
+    if (!isValidNamesMap(map, cityName1, cityName2) || length == 0 ||
+            builtYear == 0) {
+        return false;
+    }
+
+    if (!promoteMap(map)) {
+        return false;
+    }
+
+    City *city1 = findCityByNameOnHashMapInsertIfNecessary(map->citiesMap,
+                                                           map->cities,
+                                                           cityName1);
+    City *city2 = findCityByNameOnHashMapInsertIfNecessary(map->citiesMap,
+                                                           map->cities,
+                                                           cityName2);
+    if (city1 == NULL || city2 == NULL) {
+        return false;
+    }
+
+    if (findRoadModule(city1, city2) != NULL) {
+        return false;
+    }
+
+    bool isOnDetours = isAddedRoadOnDetoursMap(map, city1, city2);
+    if (!addRoadModule(city1, city2, length, builtYear)) {
+        return false;
+    }
+
+    if (map->landmarks != NULL) {
+        invalidateLandmarkIndex(map->landmarks);
+    }
+    changedRoadsMap(map);
+    addedRoadConnectivityOracle(map->connectivity, city1, city2);
+    if (isOnDetours) {
+        invalidateReplacementPathsMap(map);
+    }
+    refreshReplacementPathsMap(map);
+    journalRoadMap(map, JOURNAL_ADD_ROAD, cityName1->name, cityName2->name,
+                   length, builtYear);
+
+    return true;
+}
+
+/** @brief Dodaje do mapy odcinek drogi między dwoma różnymi miastami.
+ * Jeśli któreś z podanych miast nie istnieje, to dodaje go do mapy, a następnie
+ * dodaje do mapy odcinek drogi między tymi miastami.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName1  – wskaźnik na napis reprezentujący nazwę miasta;
+ * @param[in] cityName2  – wskaźnik na napis reprezentujący nazwę miasta;
+ * @param[in] length     – długość w km odcinka drogi;
+ * @param[in] builtYear  – rok budowy odcinka drogi.
+ * @return Wartość @p true, jeśli odcinek drogi został dodany.
+ * Wartość @p false, jeśli wystąpił błąd: któryś z parametrów ma niepoprawną
+ * wartość, obie podane nazwy miast są identyczne, odcinek drogi między tymi
+ * miastami już istnieje lub nie udało się zaalokować pamięci.
+ */
+bool addRoad(Map *map, const char *cityName1, const char *cityName2,
+             unsigned length, int builtYear) {
+    CityName name1 = cityNameFromString(cityName1);
+    CityName name2 = cityNameFromString(cityName2);
+
+    return addRoadByNamesMap(map, &name1, &name2, length, builtYear);
+}
+
+/** @brief Modyfikuje rok ostatniego remontu odcinka drogi.
+ * Działa jak @ref repairRoad dla nazw z policzonymi haszami.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName1  – wskaźnik na opis nazwy pierwszego miasta;
+ * @param[in] cityName2  – wskaźnik na opis nazwy drugiego miasta;
+ * @param[in] repairYear – rok ostatniego remontu odcinka drogi.
+ * @return Wartość @p true, jeśli modyfikacja się powiodła lub @p false
+ * w przeciwnym przypadku.
+ */
+bool repairRoadByNamesMap(Map *map, const CityName *cityName1,
+                          const CityName *cityName2, int repairYear) {
+    if (!isValidNamesMap(map, cityName1, cityName2) || repairYear == 0) {
+        return false;
+    }
+
+    if (!promoteMap(map)) {
+        return false;
+    }
+
+    City *city1 = findCityByNameOnHashMap(map->citiesMap, cityName1);
+    City *city2 = findCityByNameOnHashMap(map->citiesMap, cityName2);
+    if (city1 == NULL || city2 == NULL) {
+        return false;
+    }
+
+    if (!repairRoadModule(city1, city2, repairYear)) {
+        return false;
+    }
+
+    changedRoadsMap(map);
+    invalidateReplacementPathsMap(map);
+    refreshReplacementPathsMap(map);
+    markRoadRoutesMap(map, city1, city2);
+    publishRoutesMap(map);
+    journalRoadMap(map, JOURNAL_REPAIR_ROAD, cityName1->name, cityName2->name,
+                   0, repairYear);
+
+    return true;
+}
+
+/** @brief Modyfikuje rok ostatniego remontu odcinka drogi.
+ * Dla odcinka drogi między dwoma miastami zmienia rok jego ostatniego remontu
+ * lub ustawia ten rok, jeśli odcinek nie był jeszcze remontowany.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName1  – wskaźnik na napis reprezentujący nazwę miasta;
+ * @param[in] cityName2  – wskaźnik na napis reprezentujący nazwę miasta;
+ * @param[in] repairYear – rok ostatniego remontu odcinka drogi.
+ * @return Wartość @p true, jeśli modyfikacja się powiodła.
+ * Wartość @p false, jeśli wystąpił błąd: któryś z parametrów ma niepoprawną
+ * wartość, któreś z podanych miast nie istnieje, nie ma odcinka drogi między
+ * podanymi miastami, podany rok jest wcześniejszy niż zapisany dla tego odcinka
+ * drogi rok budowy lub ostatniego remontu.
+ */
+bool repairRoad(Map *map, const char *cityName1, const char *cityName2, int repairYear) {
+    CityName name1 = cityNameFromString(cityName1);
+    CityName name2 = cityNameFromString(cityName2);
+
+    return repairRoadByNamesMap(map, &name1, &name2, repairYear);
+}
+
+/** @brief Łączy dwa różne miasta drogą krajową.
+ * Działa jak @ref newRoute dla nazw z policzonymi haszami.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] routeId    – numer drogi krajowej;
+ * @param[in] cityName1  – wskaźnik na opis nazwy pierwszego miasta;
+ * @param[in] cityName2  – wskaźnik na opis nazwy drugiego miasta.
+ * @return Wartość @p true, jeśli droga krajowa została utworzona lub
+ * @p false w przeciwnym przypadku.
+ */
+bool newRouteByNamesMap(Map *map, unsigned routeId, const CityName *cityName1,
+                        const CityName *cityName2) {
+    if (!isValidNamesMap(map, cityName1, cityName2)) {
+        return false;
+    }
+
+    if (routeId < 1 || 999 < routeId || !promoteMap(map)) {
+        return false;
+    }
+
+    City *city1 = findCityByNameOnHashMap(map->citiesMap, cityName1);
+    City *city2 = findCityByNameOnHashMap(map->citiesMap, cityName2);
+    if (city1 == NULL || city2 == NULL) {
+        return false;
+    }
+
+    if (findRouteOnList(map->routes, routeId) != NULL) {
+        return false;
+    }
+
+    /* Miast z różnych składowych nie trzeba szukać. */
+    if (!areConnectedConnectivityOracle(map->connectivity, city1, city2)) {
+        return false;
+    }
+
+    if (!refreshLandmarksMap(map) || !refreshHierarchyMap(map, 1)) {
+        return false;
+    }
+
+    Route *route = newRouteModule(routeId, city1, city2, map->searchState);
+    if (route == NULL) {
+        return false;
+    }
+
+    if (insertList(map->routes->end, route) == NULL) {
+       deleteRouteModule(route);
+       return false;
+    }
+
+    refreshReplacementPathsMap(map);
+    markRouteMap(map, routeId);
+    publishRoutesMap(map);
+    journalRouteCommandMap(map, JOURNAL_NEW_ROUTE, routeId, cityName1->name,
+                           cityName2->name);
+
+    return true;
+}
+
+/** @brief Łączy dwa różne miasta drogą krajową.
+ * Tworzy drogę krajową pomiędzy dwoma miastami i nadaje jej podany numer.
+ * Wśród istniejących odcinków dróg wyszukuje najkrótszą drogę. Jeśli jest
+ * więcej niż jeden sposób takiego wyboru, to dla każdego wariantu wyznacza
+ * wśród wybranych w nim odcinków dróg ten, który był najdawniej wybudowany lub
+ * remontowany i wybiera wariant z odcinkiem, który jest najmłodszy.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] routeId    – numer drogi krajowej;
+ * @param[in] cityName1  – wskaźnik na napis reprezentujący nazwę miasta;
+ * @param[in] cityName2  – wskaźnik na napis reprezentujący nazwę miasta.
+ * @return Wartość @p true, jeśli droga krajowa została utworzona.
+ * Wartość @p false, jeśli wystąpił błąd: któryś z parametrów ma niepoprawną
+ * wartość, istnieje już droga krajowa o podanym numerze, któreś z podanych
+ * miast nie istnieje, obie podane nazwy miast są identyczne, nie można
+ * jednoznacznie wyznaczyć drogi krajowej między podanymi miastami lub nie udało
+ * się zaalokować pamięci.
+ */
+bool newRoute(Map *map, unsigned routeId,
+              const char *cityName1, const char *cityName2) {
+    CityName name1 = cityNameFromString(cityName1);
+    CityName name2 = cityNameFromString(cityName2);
+
+    return newRouteByNamesMap(map, routeId, &name1, &name2);
+}
+
+/** @brief Łączy miasto drogami krajowymi z wieloma miastami.
+ * Działa jak @ref newRoutes dla nazw z policzonymi haszami.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName   – wskaźnik na opis nazwy miasta startowego;
+ * @param[in] routeIds   – wskaźnik na tablicę numerów dróg krajowych;
+ * @param[in] cityNames  – wskaźnik na tablicę opisów nazw miast docelowych;
+ * @param[in] count      – liczba tworzonych dróg krajowych;
+ * @param[out] results   – wskaźnik na tablicę wyników lub NULL.
+ * @return Liczba utworzonych dróg krajowych.
+ */
+size_t newRoutesByNamesMap(Map *map, const CityName *cityName,
+                           const unsigned *routeIds, const CityName *cityNames,
+                           size_t count, bool *results) {
+    for (size_t i = 0; results != NULL && i < count; i++) {
+        results[i] = false;
+    }
+
+    if (map == NULL || count == 0 || count > UINT32_MAX ||
+            !cityName->isValid || !promoteMap(map)) {
+        return 0;
+    }
+
+    City *city = findCityByNameOnHashMap(map->citiesMap, cityName);
+    if (city == NULL) {
+        return 0;
+    }
+
+    City **cities = malloc(sizeof(City *) * count);
+    Route **routes = malloc(sizeof(Route *) * count);
+    if (cities == NULL || routes == NULL) {
+        free(cities);
+        free(routes);
+        return 0;
+    }
+
+    /* Sprawdzamy drogi tak jak newRoute, poza numerami dróg krajowych
+     * tworzonych wcześniej w tym samym wywołaniu. */
+    for (size_t i = 0; i < count; i++) {
+        cities[i] = NULL;
+        if (!isValidNamesMap(map, cityName, &cityNames[i]) ||
+                routeIds[i] < 1 || 999 < routeIds[i] ||
+                findRouteOnList(map->routes, routeIds[i]) != NULL) {
+            continue;
+        }
+
+        City *destination = findCityByNameOnHashMap(map->citiesMap,
+                                                    &cityNames[i]);
+        if (destination != NULL &&
+                areConnectedConnectivityOracle(map->connectivity, city,
+                                               destination)) {
+            cities[i] = destination;
+        }
+    }
+
+    size_t result = 0;
+    if (refreshLandmarksMap(map) && refreshHierarchyMap(map, 1) &&
+            newRoutesModule(routeIds, city, cities, count, map->searchState,
+                            routes)) {
+        for (size_t i = 0; i < count; i++) {
+            if (routes[i] == NULL) {
+                continue;
+            }
+
+            if (findRouteOnList(map->routes, routeIds[i]) != NULL ||
+                    insertList(map->routes->end, routes[i]) == NULL) {
+                deleteRouteModule(routes[i]);
+                continue;
+            }
+
+            markRouteMap(map, routeIds[i]);
+            journalRouteCommandMap(map, JOURNAL_NEW_ROUTE, routeIds[i],
+                                   cityName->name, cityNames[i].name);
+            if (results != NULL) {
+                results[i] = true;
+            }
+            result++;
+        }
+
+        refreshReplacementPathsMap(map);
+        publishRoutesMap(map);
+    }
+
+    free(cities);
+    free(routes);
+    return result;
+}
+
+/** @brief Łączy miasto drogami krajowymi z wieloma miastami.
+ * Tworzy drogi krajowe numer @p routeIds[i] z miasta @p cityName do miast
+ * @p cityNames[i] w kolejności tablicy, tak jak kolejne wywołania funkcji
+ * @ref newRoute, z tymi samymi wynikami. Najlepsze drogi ze wspólnego miasta
+ * wyznacza jedno wyszukiwanie, a ich jednoznaczność jedno przejście dla
+ * każdego różnego najstarszego odcinka wyznaczonych dróg.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName   – wskaźnik na napis reprezentujący nazwę miasta
+ *                         startowego;
+ * @param[in] routeIds   – wskaźnik na tablicę numerów dróg krajowych;
+ * @param[in] cityNames  – wskaźnik na tablicę napisów reprezentujących nazwy
+ *                         miast docelowych;
+ * @param[in] count      – liczba tworzonych dróg krajowych;
+ * @param[out] results   – wskaźnik na tablicę, w której @p results[i] ma
+ *                         wartość @p true, jeśli utworzono drogę krajową
+ *                         numer @p routeIds[i], lub NULL.
+ * @return Liczba utworzonych dróg krajowych.
+ */
+size_t newRoutes(Map *map, const char *cityName, const unsigned *routeIds,
+                 const char *const *cityNames, size_t count, bool *results) {
+    if (routeIds == NULL || cityNames == NULL ||
+            count > SIZE_MAX / sizeof(CityName)) {
+        return 0;
+    }
+
+    CityName *names = malloc(sizeof(CityName) * count + 1);
+    if (names == NULL) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        names[i] = cityNameFromString(cityNames[i]);
+    }
+
+    CityName name = cityNameFromString(cityName);
+    size_t result = newRoutesByNamesMap(map, &name, routeIds, names, count,
+                                        results);
+    free(names);
+
+    return result;
+}
+
+/** @brief Wydłuża drogę krajową do podanego miasta.
+ * Działa jak @ref extendRoute dla nazwy z policzonym haszem.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] routeId    – numer drogi krajowej;
+ * @param[in] cityName   – wskaźnik na opis nazwy miasta.
+ * @return Wartość @p true, jeśli droga krajowa została wydłużona lub
+ * @p false w przeciwnym przypadku.
+ */
+bool extendRouteByNameMap(Map *map, unsigned routeId,
+                          const CityName *cityName) {
+    if (!isValidNamesMap(map, cityName, NULL) || !promoteMap(map)) {
+        return false;
+    }
+
+    City *city = findCityByNameOnHashMap(map->citiesMap, cityName);
+    if (city == NULL) {
+        return false;
+    }
+
+    ListIterator *iterator = findRouteOnList(map->routes, routeId);
+    if (iterator == NULL) {
+        return false;
+    }
+
+    Route *route = iterator->data;
+    if (findCityByNameOnList(route->cities, cityName) != NULL) {
+        return false;
+    }
+
+    /* Wszystkie miasta drogi krajowej leżą w jednej składowej. */
+    if (!areConnectedConnectivityOracle(map->connectivity,
+                                        route->cities->begin->data, city)) {
+        return false;
+    }
+
+    if (!refreshLandmarksMap(map)) {
+        return false;
+    }
+
+    if (!findNewRouteAfterExtend(route, city, map->searchState)) {
+        return false;
+    }
+
+    refreshReplacementPathsMap(map);
+    markRouteMap(map, routeId);
+    publishRoutesMap(map);
+    journalRouteCommandMap(map, JOURNAL_EXTEND_ROUTE, routeId, cityName->name,
+                           NULL);
+
+    return true;
+}
+
+/** @brief Wydłuża drogę krajową do podanego miasta.
+ * Dodaje do drogi krajowej nowe odcinki dróg do podanego miasta w taki sposób,
+ * aby nowy fragment drogi krajowej był najkrótszy. Jeśli jest więcej niż jeden
+ * sposób takiego wydłużenia, to dla każdego wariantu wyznacza wśród dodawanych
+ * odcinków dróg ten, który był najdawniej wybudowany lub remontowany i wybiera
+ * wariant z odcinkiem, który jest najmłodszy.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] routeId    – numer drogi krajowej;
+ * @param[in] cityName   – wskaźnik na napis reprezentujący nazwę miasta.
+ * @return Wartość @p true, jeśli droga krajowa została wydłużona.
+ * Wartość @p false, jeśli wystąpił błąd: któryś z parametrów ma niepoprawną
+ * nazwę, nie istnieje droga krajowa o podanym numerze, nie ma miasta o podanej
+ * nazwie, przez podane miasto już przechodzi droga krajowa o podanym numerze,
+ * podana droga krajowa kończy się w podanym mieście, nie można jednoznacznie
+ * wyznaczyć nowego fragmentu drogi krajowej lub nie udało się zaalokować
+ * pamięci.
+ */
+bool extendRoute(Map *map, unsigned routeId, const char *cityName) {
+    CityName name = cityNameFromString(cityName);
+
+    return extendRouteByNameMap(map, routeId, &name);
+}
+
+/** @brief Poprawia drogi krajowe po usunięciu odcinka drogi.
+ * Po kolei dla każdej drogi krajowej wyznacza objazd usuwanego odcinka drogi
+ * (oznaczonego jako usuwany). Jeśli dla którejś z dróg krajowych nie da się
+ * wyznaczyć objazdu, to cofa wszystkie zmiany.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] city1      – wskaźnik na pierwsze miasto;
+ * @param[in] city2      – wskaźnik na drugie miasto;
+ * @param[in] shared     – wskaźnik na objazd wspólny dla dróg krajowych lub
+ *                         NULL.
+ * @return Wartość @p true, jeśli udało się poprawić wszystkie drogi krajowe.
+ * Wartość @p false w przeciwnym przypadku.
+ */
+bool findNewRoutesAfterRemovingRoad(Map *map, City *city1, City *city2,
+                                    const List *shared) {
+    ListIterator *iterator = map->routes->begin;
+    while (iterator != map->routes->end) {
+        if (!findNewRouteAfterRemovingRoad(iterator->data, city1, city2,
+                                           shared, map->searchState)) {
+            /* Okazuje się, że nie można usunąć danej drogi, więc cofamy
+             * wszystkie zmiany. */
+            while (iterator != map->routes->begin) {
+                iterator = iterator->previous;
+                undoFindNewRouteAfterRemovingRoad(iterator->data, city1, city2);
+            }
+            return false;
+        }
+        iterator = iterator->next;
+    }
+
+    return true;
+}
+
+/**
+ * Struktura przechowująca dane zadań szukania objazdów w puli wątków.
+ */
+typedef struct DetoursTasks {
+    Map *map;               ///< wskaźnik na mapę
+    City *city1;            ///< pierwsze miasto usuwanego odcinka
+    City *city2;            ///< drugie miasto usuwanego odcinka
+    const List *shared;     ///< objazd wspólny dla dróg krajowych lub NULL
+    Route **routes;         ///< drogi krajowe w kolejności z mapy
+    List **detours;         ///< znalezione objazdy
+    bool *results;          ///< wyniki szukania objazdów
+} DetoursTasks;
+
+/** @brief Szuka objazdu dla jednej drogi krajowej w wątku puli.
+ * @param[in,out] argument  - wskaźnik na @ref DetoursTasks;
+ * @param[in] taskIndex     - numer drogi krajowej;
+ * @param[in] threadIndex   - numer wątku.
+ */
+void findDetourTask(void *argument, uint32_t taskIndex, uint32_t threadIndex) {
+    DetoursTasks *tasks = argument;
+
+    tasks->results[taskIndex] = findDetourAfterRemovingRoad(
+            tasks->routes[taskIndex], tasks->city1, tasks->city2,
+            tasks->shared, tasks->map->threadsSearchStates[threadIndex],
+            &tasks->detours[taskIndex]);
+}
+
+/** @brief Poprawia drogi krajowe po usunięciu odcinka drogi równolegle.
+ * Działa jak @ref findNewRoutesAfterRemovingRoad, ale objazdy dla wszystkich
+ * dróg krajowych szukane są równolegle w puli wątków mapy. Objazdy wstawiane
+ * (i ewentualnie cofane) są w kolejności dróg krajowych na mapie, więc wynik
+ * jest identyczny jak przy wykonaniu sekwencyjnym.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] city1      – wskaźnik na pierwsze miasto;
+ * @param[in] city2      – wskaźnik na drugie miasto;
+ * @param[in] shared     – wskaźnik na objazd wspólny dla dróg krajowych lub
+ *                         NULL.
+ * @return Wartość @p true, jeśli udało się poprawić wszystkie drogi krajowe.
+ * Wartość @p false w przeciwnym przypadku.
+ */
+bool findNewRoutesAfterRemovingRoadInParallel(Map *map, City *city1,
+                                              City *city2,
+                                              const List *shared) {
+    uint32_t routesCount = sizeList(map->routes);
+    if (routesCount == 0) {
+        return true;
+    }
+
+    DetoursTasks tasks;
+    tasks.map = map;
+    tasks.city1 = city1;
+    tasks.city2 = city2;
+    tasks.shared = shared;
+    tasks.routes = malloc(sizeof(Route *) * routesCount);
+    tasks.detours = malloc(sizeof(List *) * routesCount);
+    tasks.results = malloc(sizeof(bool) * routesCount);
+    if (tasks.routes == NULL || tasks.detours == NULL ||
+            tasks.results == NULL) {
+        free(tasks.routes);
+        free(tasks.detours);
+        free(tasks.results);
+        return false;
+    }
+
+    ListIterator *iterator = map->routes->begin;
+    for (uint32_t i = 0; i < routesCount; i++) {
+        tasks.routes[i] = iterator->data;
+        iterator = iterator->next;
+    }
+
+    runThreadPool(map->threadPool, routesCount, findDetourTask, &tasks);
+
+    /* Wstawiamy objazdy w kolejności dróg krajowych. Jeśli któregoś objazdu
+     * nie udało się wyznaczyć, to cofamy wcześniejsze zmiany w odwrotnej
+     * kolejności i usuwamy pozostałe objazdy. */
+    bool result = true;
+    for (uint32_t i = 0; i < routesCount; i++) {
+        if (!tasks.results[i]) {
+            for (uint32_t j = i; j > 0; j--) {
+                undoFindNewRouteAfterRemovingRoad(tasks.routes[j - 1],
+                                                  city1, city2);
+            }
+            for (uint32_t j = i + 1; j < routesCount; j++) {
+                if (tasks.detours[j] != NULL) {
+                    deleteList(tasks.detours[j], false);
+                }
+            }
+            result = false;
+            break;
+        }
+
+        applyDetourAfterRemovingRoad(tasks.routes[i], city1, city2,
+                                     tasks.detours[i]);
+    }
+
+    free(tasks.routes);
+    free(tasks.detours);
+    free(tasks.results);
+
+    return result;
+}
+
+/** @brief Sprawdza czy odcinek drogi należy do jakiejś drogi krajowej.
+ * @param[in] map        – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] city1      – wskaźnik na pierwsze miasto;
+ * @param[in] city2      – wskaźnik na drugie miasto.
+ * @return Wartość @p true, jeśli odcinek należy do jakiejś drogi krajowej.
+ * Wartość @p false w przeciwnym przypadku.
+ */
+bool isRoadOnRoutesMap(Map *map, City *city1, City *city2) {
+    ListIterator *iterator = map->routes->begin;
+    while (iterator != map->routes->end) {
+        if (findRemovedRoadOnRoute(iterator->data, city1, city2) != NULL) {
+            return true;
+        }
+        iterator = iterator->next;
+    }
+
+    return false;
+}
+
+/** @brief Wyznacza objazd odcinka wspólny dla dróg krajowych.
+ * Wyszukuje go tylko wtedy, gdy przez odcinek przechodzą co najmniej dwie
+ * drogi krajowe; pojedynczej drodze krajowej wspólne wyszukiwanie niczego
+ * nie oszczędza.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] city1      – wskaźnik na pierwsze miasto;
+ * @param[in] city2      – wskaźnik na drugie miasto.
+ * @return Wskaźnik na listę miast objazdu (zob.
+ * @ref findSharedDetourAfterRemovingRoad) lub NULL.
+ */
+List *findSharedDetourMap(Map *map, City *city1, City *city2) {
+    uint32_t routesCount = 0;
+    ListIterator *iterator = map->routes->begin;
+    while (iterator != map->routes->end && routesCount < 2) {
+        if (findRemovedRoadOnRoute(iterator->data, city1, city2) != NULL) {
+            routesCount++;
+        }
+        iterator = iterator->next;
+    }
+
+    if (routesCount < 2) {
+        return NULL;
+    }
+
+    return findSharedDetourAfterRemovingRoad(city1, city2, map->searchState);
+}
+
+/** @brief Usuwa odcinek drogi między dwoma różnymi miastami.
+ * Działa jak @ref removeRoad dla nazw z policzonymi haszami.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName1  – wskaźnik na opis nazwy pierwszego miasta;
+ * @param[in] cityName2  – wskaźnik na opis nazwy drugiego miasta.
+ * @return Wartość @p true, jeśli odcinek drogi został usunięty lub @p false
+ * w przeciwnym przypadku.
+ */
+bool removeRoadByNamesMap(Map *map, const CityName *cityName1,
+                          const CityName *cityName2) {
+    if (!isValidNamesMap(map, cityName1, cityName2) || !promoteMap(map)) {
+        return false;
+    }
+
+    City *city1 = findCityByNameOnHashMap(map->citiesMap, cityName1);
+    City *city2 = findCityByNameOnHashMap(map->citiesMap, cityName2);
+    if (city1 == NULL || city2 == NULL) {
+        return false;
+    }
+
+    if (findRoadModule(city1, city2) == NULL) {
+        return false;
+    }
+
+    /* Jeśli odcinek jest mostem, to żadna przechodząca przez niego droga
+     * krajowa nie ma objazdu. */
+    if (isRoadOnRoutesMap(map, city1, city2) &&
+            isBridgeConnectivityOracle(map->connectivity, city1, city2)) {
+        return false;
+    }
+
+    if (!refreshLandmarksMap(map)) {
+        return false;
+    }
+
+    /* Opisy zmienią drogi krajowe przechodzące teraz przez odcinek. Jeśli
+     * usuwanie się nie powiedzie, zostaną tylko ponownie opublikowane. */
+    markRoadRoutesMap(map, city1, city2);
+
+    /* Sprawdzamy czy droga istnieje. Jeśli istnieje to ustawiamy,
+     * że dana droga jest w trakcie usuwania. */
+    if (!setRoadIsDeletedTo(city1, city2, true)) {
+        return false;
+    }
+    changedRoadsMap(map);
+
+    /* Drogi krajowe, których miasta omija wspólny objazd, kopiują go zamiast
+     * wyszukiwać własny. */
+    List *shared = findSharedDetourMap(map, city1, city2);
+
+    bool result;
+    if (map->threadPool != NULL) {
+        result = findNewRoutesAfterRemovingRoadInParallel(map, city1, city2,
+                                                          shared);
+    } else {
+        result = findNewRoutesAfterRemovingRoad(map, city1, city2, shared);
+    }
+    if (shared != NULL) {
+        deleteList(shared, false);
+    }
+
+    if (!result) {
+        setRoadIsDeletedTo(city1, city2, false);
+        changedRoadsMap(map);
+        return false;
+    }
+
+    removeRoadModule(city1, city2);
+    if (map->landmarks != NULL) {
+        removedRoadLandmarkIndex(map->landmarks);
+    }
+    changedRoadsMap(map);
+    removedRoadConnectivityOracle(map->connectivity);
+    removedRoadReplacementPathsMap(map, city1, city2);
+    refreshReplacementPathsMap(map);
+    publishRoutesMap(map);
+    journalRoadMap(map, JOURNAL_REMOVE_ROAD, cityName1->name, cityName2->name,
+                   0, 0);
+
+    return true;
+}
+
+/** @brief Usuwa odcinek drogi między dwoma różnymi miastami.
+ * Usuwa odcinek drogi między dwoma miastami. Jeśli usunięcie tego odcinka drogi
+ * powoduje przerwanie ciągu jakiejś drogi krajowej, to uzupełnia ją
+ * istniejącymi odcinkami dróg w taki sposób, aby była najkrótsza. Jeśli jest
+ * więcej niż jeden sposób takiego uzupełnienia, to dla każdego wariantu
+ * wyznacza wśród dodawanych odcinków drogi ten, który był najdawniej wybudowany
+ * lub remontowany i wybiera wariant z odcinkiem, który jest najmłodszy.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName1  – wskaźnik na napis reprezentujący nazwę miasta;
+ * @param[in] cityName2  – wskaźnik na napis reprezentujący nazwę miasta.
+ * @return Wartość @p true, jeśli odcinek drogi został usunięty.
+ * Wartość @p false, jeśli z powodu błędu nie można usunąć tego odcinka drogi:
+ * któryś z parametrów ma niepoprawną wartość, nie ma któregoś z podanych miast,
+ * nie istnieje droga między podanymi miastami, nie da się jednoznacznie
+ * uzupełnić przerwanego ciągu drogi krajowej lub nie udało się zaalokować
+ * pamięci.
+ */
+bool removeRoad(Map *map, const char *cityName1, const char *cityName2) {
+    CityName name1 = cityNameFromString(cityName1);
+    CityName name2 = cityNameFromString(cityName2);
+
+    return removeRoadByNamesMap(map, &name1, &name2);
+}
+
+/** @brief Dopisuje do dziennika usunięcie wielu odcinków dróg.
+ * Nic nie robi, jeśli mapa nie ma dziennika.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityNames  – wskaźnik na tablicę opisów nazw końców odcinków;
+ * @param[in] count      – liczba odcinków.
+ */
+void journalRoadsMap(Map *map, const CityName *cityNames, size_t count) {
+    if (map->journal == NULL) {
+        return;
+    }
+
+    appendRoadsJournal(map->journal, cityNames, count);
+    commitJournalMap(map);
+}
+
+/**
+ * Struktura przechowująca dane zadań poprawiania dróg krajowych po usunięciu
+ * wielu odcinków dróg.
+ */
+typedef struct RoadsDetoursTasks {
+    Map *map;               ///< wskaźnik na mapę
+    City **removed;         ///< pary końców usuwanych odcinków
+    List **shared;          ///< wspólne objazdy usuwanych odcinków lub NULL
+    size_t count;           ///< liczba usuwanych odcinków
+    Route **routes;         ///< drogi krajowe w kolejności z mapy
+    List **cities;          ///< nowe listy miast dróg krajowych lub NULL
+    bool *results;          ///< wyniki szukania objazdów
+} RoadsDetoursTasks;
+
+/** @brief Poprawia jedną drogę krajową w wątku puli.
+ * @param[in,out] argument  - wskaźnik na @ref RoadsDetoursTasks;
+ * @param[in] taskIndex     - numer drogi krajowej;
+ * @param[in] threadIndex   - numer wątku.
+ */
+void findRoadsDetoursTask(void *argument, uint32_t taskIndex,
+                          uint32_t threadIndex) {
+    RoadsDetoursTasks *tasks = argument;
+
+    tasks->results[taskIndex] = findDetoursAfterRemovingRoads(
+            tasks->routes[taskIndex], tasks->removed, tasks->shared,
+            tasks->count, tasks->map->threadsSearchStates[threadIndex],
+            &tasks->cities[taskIndex]);
+}
+
+/** @brief Poprawia drogi krajowe po usunięciu wielu odcinków dróg.
+ * Usuwane odcinki są oznaczone jako usuwane, więc każdy objazd wyznaczany
+ * jest na mapie bez nich wszystkich. Nowe listy miast wyznaczane są
+ * (równolegle, jeśli mapa ma pulę wątków) bez modyfikowania dróg krajowych
+ * i wstawiane dopiero, gdy wszystkie się udało wyznaczyć. Dla każdego
+ * usuwanego odcinka, przez który przechodzą co najmniej dwie drogi krajowe,
+ * najpierw wyznaczany jest jeden wspólny objazd (@ref findSharedDetourMap),
+ * który drogi krajowe kopiują, jeśli omija ich miasta.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cities     – wskaźnik na tablicę par końców usuwanych odcinków;
+ * @param[in] count      – liczba usuwanych odcinków.
+ * @return Wartość @p true, jeśli udało się poprawić wszystkie drogi krajowe.
+ * Wartość @p false w przeciwnym przypadku; wtedy drogi krajowe pozostają
+ * niezmienione.
+ */
+bool findNewRoutesAfterRemovingRoads(Map *map, City **cities, size_t count) {
+    uint32_t routesCount = sizeList(map->routes);
+    if (routesCount == 0) {
+        return true;
+    }
+
+    RoadsDetoursTasks tasks;
+    tasks.map = map;
+    tasks.removed = cities;
+    tasks.count = count;
+    tasks.shared = calloc(count, sizeof(List *));
+    tasks.routes = malloc(sizeof(Route *) * routesCount);
+    tasks.cities = malloc(sizeof(List *) * routesCount);
+    tasks.results = malloc(sizeof(bool) * routesCount);
+    if (tasks.shared == NULL || tasks.routes == NULL ||
+            tasks.cities == NULL || tasks.results == NULL) {
+        free(tasks.shared);
+        free(tasks.routes);
+        free(tasks.cities);
+        free(tasks.results);
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        tasks.shared[i] = findSharedDetourMap(map, cities[2 * i],
+                                              cities[2 * i + 1]);
+    }
+
+    ListIterator *iterator = map->routes->begin;
+    for (uint32_t i = 0; i < routesCount; i++) {
+        tasks.routes[i] = iterator->data;
+        iterator = iterator->next;
+    }
+
+    if (map->threadPool != NULL) {
+        runThreadPool(map->threadPool, routesCount, findRoadsDetoursTask,
+                      &tasks);
+    } else {
+        for (uint32_t i = 0; i < routesCount; i++) {
+            tasks.results[i] = findDetoursAfterRemovingRoads(
+                    tasks.routes[i], cities, tasks.shared, count,
+                    map->searchState, &tasks.cities[i]);
+        }
+    }
+
+    bool result = true;
+    for (uint32_t i = 0; i < routesCount; i++) {
+        if (!tasks.results[i]) {
+            result = false;
+        }
+    }
+
+    for (uint32_t i = 0; i < routesCount; i++) {
+        if (!tasks.results[i] || tasks.cities[i] == NULL) {
+            continue;
+        }
+
+        if (result) {
+            Route *route = tasks.routes[i];
+            deleteList(route->cities, false);
+            route->cities = tasks.cities[i];
+            markRouteMap(map, route->routeId);
+        } else {
+            deleteList(tasks.cities[i], false);
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (tasks.shared[i] != NULL) {
+            deleteList(tasks.shared[i], false);
+        }
+    }
+    free(tasks.shared);
+    free(tasks.routes);
+    free(tasks.cities);
+    free(tasks.results);
+
+    return result;
+}
+
+/** @brief Oznacza odcinki dróg jako usuwane lub cofa oznaczenie.
+ * @param[in,out] cities    - wskaźnik na tablicę par końców odcinków;
+ * @param[in] count         - liczba odcinków;
+ * @param[in] isDeleted     - nowa wartość oznaczenia.
+ */
+void setRoadsIsDeletedMap(City **cities, size_t count, bool isDeleted) {
+    for (size_t i = 0; i < count; i++) {
+        setRoadIsDeletedTo(cities[2 * i], cities[2 * i + 1], isDeleted);
+    }
+}
+
+/** @brief Usuwa wiele odcinków dróg naraz.
+ * Działa jak @ref removeRoads dla nazw z policzonymi haszami.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityNames  – wskaźnik na tablicę @p 2 * @p count opisów nazw;
+ *                         odcinek numer @p i łączy miasta o nazwach
+ *                         @p cityNames[2 * i] i @p cityNames[2 * i + 1];
+ * @param[in] count      – liczba odcinków.
+ * @return Wartość @p true, jeśli odcinki dróg zostały usunięte lub @p false
+ * w przeciwnym przypadku.
+ */
+bool removeRoadsByNamesMap(Map *map, const CityName *cityNames,
+                           size_t count) {
+    if (map == NULL || cityNames == NULL || count == 0) {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (!isValidNamesMap(map, &cityNames[2 * i], &cityNames[2 * i + 1])) {
+            return false;
+        }
+    }
+
+    if (!promoteMap(map)) {
+        return false;
+    }
+
+    City **cities = malloc(sizeof(City *) * 2 * count);
+    if (cities == NULL) {
+        return false;
+    }
+
+    for (size_t i = 0; i < 2 * count; i++) {
+        cities[i] = findCityByNameOnHashMap(map->citiesMap, &cityNames[i]);
+        if (cities[i] == NULL) {
+            free(cities);
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        City *city1 = cities[2 * i];
+        City *city2 = cities[2 * i + 1];
+        if (findRoadModule(city1, city2) == NULL) {
+            free(cities);
+            return false;
+        }
+
+        /* Usunięcie pozostałych odcinków nie sprawi, że most będzie miał
+         * objazd. */
+        if (isRoadOnRoutesMap(map, city1, city2) &&
+                isBridgeConnectivityOracle(map->connectivity, city1, city2)) {
+            free(cities);
+            return false;
+        }
+    }
+
+    if (!refreshLandmarksMap(map)) {
+        free(cities);
+        return false;
+    }
+
+    /* Odcinek oznaczony już jako usuwany występuje w partii drugi raz. */
+    for (size_t i = 0; i < count; i++) {
+        Road *road = findRoadModule(cities[2 * i], cities[2 * i + 1])->data;
+        if (road->isDeleted) {
+            setRoadsIsDeletedMap(cities, i, false);
+            free(cities);
+            return false;
+        }
+        setRoadIsDeletedTo(cities[2 * i], cities[2 * i + 1], true);
+    }
+    changedRoadsMap(map);
+
+    if (!findNewRoutesAfterRemovingRoads(map, cities, count)) {
+        setRoadsIsDeletedMap(cities, count, false);
+        changedRoadsMap(map);
+        free(cities);
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        removeRoadModule(cities[2 * i], cities[2 * i + 1]);
+        if (map->landmarks != NULL) {
+            removedRoadLandmarkIndex(map->landmarks);
+        }
+        removedRoadReplacementPathsMap(map, cities[2 * i], cities[2 * i + 1]);
+    }
+    changedRoadsMap(map);
+    removedRoadConnectivityOracle(map->connectivity);
+    refreshReplacementPathsMap(map);
+    publishRoutesMap(map);
+    journalRoadsMap(map, cityNames, count);
+    free(cities);
+
+    return true;
+}
+
+/** @brief Usuwa wiele odcinków dróg naraz.
+ * Oznacza wszystkie odcinki jako usuwane i dopiero wtedy wyznacza objazdy
+ * (jak w @ref removeRoad) dla każdej drogi krajowej przechodzącej przez
+ * któryś z nich, więc objazdy nie prowadzą przez inne usuwane odcinki.
+ * Objazdy różnych dróg krajowych szukane są równolegle w puli wątków mapy
+ * i korzystają ze wspólnej pamięci podręcznej drzew najkrótszych dróg.
+ * Jeśli którejś drogi krajowej nie da się jednoznacznie poprawić, to żaden
+ * odcinek nie jest usuwany.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityNames  – wskaźnik na tablicę @p 2 * @p count napisów
+ *                         reprezentujących nazwy miast; odcinek numer @p i
+ *                         łączy miasta @p cityNames[2 * i]
+ *                         i @p cityNames[2 * i + 1];
+ * @param[in] count      – liczba odcinków.
+ * @return Wartość @p true, jeśli wszystkie odcinki dróg zostały usunięte.
+ * Wartość @p false, jeśli nie usunięto żadnego odcinka: @p count jest równe
+ * @p 0, któryś z parametrów ma niepoprawną wartość, nie ma któregoś
+ * z podanych miast lub odcinków dróg, odcinek występuje więcej niż raz, nie da
+ * się jednoznacznie uzupełnić przerwanego ciągu drogi krajowej lub nie udało
+ * się zaalokować pamięci.
+ */
+bool removeRoads(Map *map, const char *const *cityNames, size_t count) {
+    if (cityNames == NULL || count == 0) {
+        return false;
+    }
+
+    CityName *names = malloc(sizeof(CityName) * 2 * count);
+    if (names == NULL) {
+        return false;
+    }
+
+    for (size_t i = 0; i < 2 * count; i++) {
+        names[i] = cityNameFromString(cityNames[i]);
+    }
+
+    bool result = removeRoadsByNamesMap(map, names, count);
+    free(names);
+
+    return result;
+}
+
+/**
+ * Struktura przechowująca dane zadań sprawdzania objazdów w puli wątków.
+ */
+typedef struct CheckDetoursTasks {
+    Map *map;               ///< wskaźnik na mapę
+    City *city1;            ///< pierwsze miasto sprawdzanego odcinka
+    City *city2;            ///< drugie miasto sprawdzanego odcinka
+    const List *shared;     ///< objazd wspólny dla dróg krajowych lub NULL
+    Route **routes;         ///< drogi krajowe przechodzące przez odcinek
+    int64_t *lengths;       ///< długości objazdów lub @p -1
+} CheckDetoursTasks;
+
+/** @brief Wyznacza długość objazdu jednej drogi krajowej w wątku puli.
+ * @param[in,out] argument  - wskaźnik na @ref CheckDetoursTasks;
+ * @param[in] taskIndex     - numer drogi krajowej;
+ * @param[in] threadIndex   - numer wątku.
+ */
+void checkDetourTask(void *argument, uint32_t taskIndex,
+                     uint32_t threadIndex) {
+    CheckDetoursTasks *tasks = argument;
+
+    findDetourLengthAfterRemovingRoad(
+            tasks->routes[taskIndex], tasks->city1, tasks->city2,
+            tasks->shared, tasks->map->threadsSearchStates[threadIndex],
+            &tasks->lengths[taskIndex]);
+}
+
+/** @brief Sprawdza, czy można usunąć odcinek drogi, bez jego usuwania.
+ * Działa jak @ref checkRemoveRoad dla nazw z policzonymi haszami.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName1  – wskaźnik na opis nazwy pierwszego miasta;
+ * @param[in] cityName2  – wskaźnik na opis nazwy drugiego miasta;
+ * @param[out] isFeasible – wskaźnik na wynik sprawdzenia;
+ * @param[out] detours   – wskaźnik na tablicę objazdów lub NULL;
+ * @param[in] detoursSize – rozmiar tablicy @p detours;
+ * @param[out] detoursCount – wskaźnik na liczbę dróg krajowych przechodzących
+ *                         przez odcinek lub NULL.
+ * @return Wartość @p true, jeśli sprawdzono odcinek lub @p false
+ * w przeciwnym przypadku.
+ */
+bool checkRemoveRoadByNamesMap(Map *map, const CityName *cityName1,
+                               const CityName *cityName2, bool *isFeasible,
+                               RouteDetour *detours, size_t detoursSize,
+                               size_t *detoursCount) {
+    if (detoursCount != NULL) {
+        *detoursCount = 0;
+    }
+
+    if (isFeasible == NULL || (detours == NULL && detoursSize != 0) ||
+            !isValidNamesMap(map, cityName1, cityName2) || !promoteMap(map)) {
+        return false;
+    }
+
+    City *city1 = findCityByNameOnHashMap(map->citiesMap, cityName1);
+    City *city2 = findCityByNameOnHashMap(map->citiesMap, cityName2);
+    if (city1 == NULL || city2 == NULL ||
+            findRoadModule(city1, city2) == NULL) {
+        return false;
+    }
+
+    /* Miejsce rezerwujemy dla wszystkich dróg krajowych (co najmniej
+     * jednej), żeby przejrzeć je tylko raz. */
+    size_t size = sizeList(map->routes) + 1;
+    CheckDetoursTasks tasks;
+    tasks.map = map;
+    tasks.city1 = city1;
+    tasks.city2 = city2;
+    tasks.shared = NULL;
+    tasks.routes = malloc(sizeof(Route *) * size);
+    tasks.lengths = malloc(sizeof(int64_t) * size);
+    if (tasks.routes == NULL || tasks.lengths == NULL ||
+            !refreshLandmarksMap(map)) {
+        free(tasks.routes);
+        free(tasks.lengths);
+        return false;
+    }
+
+    uint32_t routesCount = 0;
+    ListIterator *iterator = map->routes->begin;
+    while (iterator != map->routes->end) {
+        if (findRemovedRoadOnRoute(iterator->data, city1, city2) != NULL) {
+            tasks.routes[routesCount] = iterator->data;
+            tasks.lengths[routesCount] = -1;
+            routesCount++;
+        }
+        iterator = iterator->next;
+    }
+
+    /* Jeśli odcinek jest mostem, to żadna przechodząca przez niego droga
+     * krajowa nie ma objazdu. */
+    if (routesCount > 0 &&
+            !isBridgeConnectivityOracle(map->connectivity, city1, city2)) {
+        List *shared = NULL;
+        if (routesCount >= 2) {
+            shared = findSharedDetourAfterRemovingRoad(city1, city2,
+                                                       map->searchState);
+        }
+        tasks.shared = shared;
+
+        if (map->threadPool != NULL) {
+            runThreadPool(map->threadPool, routesCount, checkDetourTask,
+                          &tasks);
+        } else {
+            for (uint32_t i = 0; i < routesCount; i++) {
+                findDetourLengthAfterRemovingRoad(tasks.routes[i], city1,
+                                                  city2, tasks.shared,
+                                                  map->searchState,
+                                                  &tasks.lengths[i]);
+            }
+        }
+
+        if (shared != NULL) {
+            deleteList(shared, false);
+        }
+    }
+
+    *isFeasible = true;
+    for (uint32_t i = 0; i < routesCount; i++) {
+        if (tasks.lengths[i] < 0) {
+            *isFeasible = false;
+        }
+        if (i < detoursSize) {
+            detours[i].routeId = tasks.routes[i]->routeId;
+            detours[i].length = tasks.lengths[i];
+        }
+    }
+
+    if (detoursCount != NULL) {
+        *detoursCount = routesCount;
+    }
+    free(tasks.routes);
+    free(tasks.lengths);
+
+    return true;
+}
+
+/** @brief Sprawdza, czy można usunąć odcinek drogi, bez jego usuwania.
+ * Dla każdej drogi krajowej przechodzącej przez odcinek między podanymi
+ * miastami wyznacza objazd, który wstawiłaby funkcja @ref removeRoad, i jego
+ * długość. Nie oznacza odcinka jako usuwanego i nie zmienia dróg krajowych
+ * ani wersji mapy, więc opisy dróg krajowych czytane współbieżnie
+ * (@ref readRouteDescriptionMap) i pamięć podręczna drzew pozostają
+ * aktualne. Objazdy różnych dróg krajowych szukane są równolegle w puli
+ * wątków mapy. Objazd @p i-tej (w kolejności dróg na mapie) drogi krajowej
+ * przechodzącej przez odcinek zapisywany jest w @p detours[i], jeśli
+ * @p i < @p detoursSize.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName1  – wskaźnik na napis reprezentujący nazwę miasta;
+ * @param[in] cityName2  – wskaźnik na napis reprezentujący nazwę miasta;
+ * @param[out] isFeasible – wskaźnik na wynik: czy funkcja @ref removeRoad
+ *                         usunęłaby odcinek;
+ * @param[out] detours   – wskaźnik na tablicę objazdów lub NULL;
+ * @param[in] detoursSize – rozmiar tablicy @p detours;
+ * @param[out] detoursCount – wskaźnik na liczbę dróg krajowych przechodzących
+ *                         przez odcinek lub NULL.
+ * @return Wartość @p true, jeśli sprawdzono odcinek. Wartość @p false, jeśli
+ * wystąpił błąd: któryś z parametrów ma niepoprawną wartość, nie ma któregoś
+ * z podanych miast, nie istnieje droga między podanymi miastami lub nie udało
+ * się zaalokować pamięci.
+ */
+bool checkRemoveRoad(Map *map, const char *cityName1, const char *cityName2,
+                     bool *isFeasible, RouteDetour *detours,
+                     size_t detoursSize, size_t *detoursCount) {
+    CityName name1 = cityNameFromString(cityName1);
+    CityName name2 = cityNameFromString(cityName2);
+
+    return checkRemoveRoadByNamesMap(map, &name1, &name2, isFeasible, detours,
+                                     detoursSize, detoursCount);
+}
+
+/** @brief Udostępnia informacje o drodze krajowej.
+ * Zwraca wskaźnik na napis, który zawiera informacje o drodze krajowej. Alokuje
+ * pamięć na ten napis. Zwraca pusty napis, jeśli nie istnieje droga krajowa
+ * o podanym numerze. Zaalokowaną pamięć trzeba zwolnić za pomocą funkcji free.
+ * Informacje wypisywane są w formacie:
+ * numer drogi krajowej;nazwa miasta;długość odcinka drogi;rok budowy lub
+ * ostatniego remontu;nazwa miasta;długość odcinka drogi;rok budowy lub
+ * ostatniego remontu;nazwa miasta;…;nazwa miasta.
+ * Kolejność miast na liście jest taka, aby miasta @p city1 i @p city2, podane
+ * w wywołaniu funkcji @ref newRoute, które utworzyło tę drogę krajową, zostały
+ * wypisane w tej kolejności.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] routeId    – numer drogi krajowej.
+ * @return Wskaźnik na napis lub NULL, gdy nie udało się zaalokować pamięci.
+ */
+char const* getRouteDescription(Map *map, unsigned routeId) {
+    /* Pierwsze przejście mierzy napis, drugie go zapisuje. */
+    size_t size = writeRouteDescription(map, routeId, NULL, 0);
+    char *result = malloc((size + 1) * sizeof(char));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    writeRouteDescription(map, routeId, result, size + 1);
+
+    return result;
+}
+
+/** @brief Uaktualnia odcinek drogowy w mapie.
+ * Działa jak @ref updateRoad dla nazw z policzonymi haszami.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName1  – wskaźnik na opis nazwy pierwszego miasta;
+ * @param[in] cityName2  – wskaźnik na opis nazwy drugiego miasta;
+ * @param[in] length     – długość w km odcinka drogi;
+ * @param[in] builtYear  – rok budowy odcinka drogi.
+ * @return Wartość @p true jeśli odcinek został dodany lub wyremontowany lub
+ * @p false w przeciwnym przypadku.
+ */
+bool updateRoadByNamesMap(Map *map, const CityName *cityName1,
+                          const CityName *cityName2, unsigned length,
+                          int builtYear) {
+    if (!isValidNamesMap(map, cityName1, cityName2) || length == 0 ||
+            builtYear == 0) {
+        return false;
+    }
+
+    if (!promoteMap(map)) {
+        return false;
+    }
+
+    City *city1 = findCityByNameOnHashMapInsertIfNecessary(map->citiesMap,
+                                                           map->cities,
+                                                           cityName1);
+    City *city2 = findCityByNameOnHashMapInsertIfNecessary(map->citiesMap,
+                                                           map->cities,
+                                                           cityName2);
+    if (city1 == NULL || city2 == NULL) {
+        return false;
+    }
+
+    ListIterator *iterator = findRoadModule(city1, city2);
+    if (iterator == NULL) {
+        bool isOnDetours = isAddedRoadOnDetoursMap(map, city1, city2);
+        if (!addRoadModule(city1, city2, length, builtYear)) {
+            return false;
+        }
+
+        if (map->landmarks != NULL) {
+            invalidateLandmarkIndex(map->landmarks);
+        }
+        changedRoadsMap(map);
+        addedRoadConnectivityOracle(map->connectivity, city1, city2);
+        if (isOnDetours) {
+            invalidateReplacementPathsMap(map);
+        }
+        refreshReplacementPathsMap(map);
+        journalRoadMap(map, JOURNAL_UPDATE_ROAD, cityName1->name,
+                       cityName2->name, length, builtYear);
+
+        return true;
+    } else {
+        Road *road = iterator->data;
+        if (road->length != length) {
+            return false;
+        } else {
+            if (!repairRoadModule(city1, city2, builtYear)) {
+                return false;
+            }
+
+            changedRoadsMap(map);
+            invalidateReplacementPathsMap(map);
+            refreshReplacementPathsMap(map);
+            markRoadRoutesMap(map, city1, city2);
+            publishRoutesMap(map);
+            journalRoadMap(map, JOURNAL_UPDATE_ROAD, cityName1->name,
+                           cityName2->name, length, builtYear);
+
+            return true;
+        }
+    }
+}
+
+/** @brief Uaktualnia odcinek drogowy w mapie.
+ * Jeśli dana droga nie istnieje, to dodaję ją do mapy funkcją @ref addRoad.
+ * Jeśli dana droga istnieje to wywołuję funkcję @ref repairRoad.
+ * @brief updateRoad
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName1  – wskaźnik na napis reprezentujący nazwę miasta;
+ * @param[in] cityName2  – wskaźnik na napis reprezentujący nazwę miasta;
+ * @param[in] length     – długość w km odcinka drogi;
+ * @param[in] builtYear  – rok budowy odcinka drogi.
+ * @return Wartość @p true jeśli funkjca @ref addRoad / @ref repairRoad
+ * zakończyła się sukcesem. Wartość @p false jeśli wystąpił błąd:
+ * dana funkcja nie zakończyła się sukcesem, któryś z parametrów ma niepoprawną
+ * wartość, obie podane nazwy miast są identyczne, odcinek drogi między tymi
+ * miastami już istnieje i ma inną długość lub nie udało się zaalokować pamięci.
+ */
+bool updateRoad(Map *map, const char *cityName1, const char *cityName2,
+                unsigned length, int builtYear) {
+    CityName name1 = cityNameFromString(cityName1);
+    CityName name2 = cityNameFromString(cityName2);
+
+    return updateRoadByNamesMap(map, &name1, &name2, length, builtYear);
+}
+
+/** @brief Usuwa z mapy dróg drogę krajową.
+ * Usuwa z mapy dróg drogę krajową o podanym numerze, jeśli taka istnieje.
+ * Nie usuwa odcinków dróg ani miast.
+ * @param[in,out] map   – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] routeId   - numer drogi krajowej.
+ * @return Wartość @p false, gdy podana droga krajowa nie istnieje lub
+ * podany numer jest niepoprawny. Wartość @p true w przeciwnym wypadku.
+ */
+bool removeRoute(Map *map, unsigned routeId) {
+    if (!promoteMap(map)) {
+        return false;
     }
 
     ListIterator *iterator = findRouteOnList(map->routes, routeId);
@@ -417,8 +2682,940 @@ bool removeRoute(Map *map, unsigned routeId) {
         return false;
     }
 
-    deleteRouteModule(iterator->data);
-    eraseList(iterator, false);
+    deleteRouteModule(iterator->data);
+    eraseList(iterator, false);
+    markRouteMap(map, routeId);
+    publishRoutesMap(map);
+    journalRouteCommandMap(map, JOURNAL_REMOVE_ROUTE, routeId, NULL, NULL);
+
+    return true;
+}
+
+/** @brief Dodaje do mapy wiele odcinków dróg.
+ * Dla kolejnych elementów tablicy wywołuje funkcję @ref addRoad. Niepowodzenie
+ * dodania jednego odcinka nie przerywa dodawania kolejnych.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] roads      – wskaźnik na tablicę dodawanych odcinków dróg;
+ * @param[in] count      – liczba elementów tablicy @p roads;
+ * @param[out] results   – wskaźnik na tablicę @p count wyników funkcji
+ *                         @ref addRoad lub NULL.
+ * @return Liczba dodanych odcinków dróg.
+ */
+size_t addRoads(Map *map, const RoadTuple *roads, size_t count, bool *results) {
+    assert(roads != NULL || count == 0);
+
+    size_t addedCount = 0;
+    for (size_t i = 0; i < count; i++) {
+        bool isAdded = addRoad(map, roads[i].cityName1, roads[i].cityName2,
+                               roads[i].length, roads[i].builtYear);
+        if (results != NULL) {
+            results[i] = isAdded;
+        }
+        addedCount += isAdded;
+    }
+
+    return addedCount;
+}
+
+/** @brief Zapisuje informacje o drodze krajowej w buforze.
+ * Zapisuje w buforze napis w formacie @ref getRouteDescription (pusty, jeśli
+ * nie istnieje droga krajowa o podanym numerze), obcięty do rozmiaru bufora
+ * i zakończony zerem. Nie alokuje pamięci. Jeśli wynik nie jest mniejszy niż
+ * @p bufferSize, to napis nie zmieścił się w buforze.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] routeId    – numer drogi krajowej;
+ * @param[out] buffer    – wskaźnik na bufor lub NULL;
+ * @param[in] bufferSize – rozmiar bufora (@p 0 dla NULL).
+ * @return Długość całego napisu (bez zera na końcu), także jeśli nie
+ * zmieścił się w buforze.
+ */
+size_t writeRouteDescription(Map *map, unsigned routeId,
+                             char *buffer, size_t bufferSize) {
+    assert(buffer != NULL || bufferSize == 0);
+
+    if (map != NULL && map->image != NULL) {
+        return writeDescriptionMapImage(map->image, routeId,
+                                        buffer, bufferSize);
+    }
+
+    ListIterator *iterator = NULL;
+    if (map != NULL) {
+        iterator = findRouteOnList(map->routes, routeId);
+    }
+
+    if (iterator == NULL) {
+        if (bufferSize > 0) {
+            *buffer = 0;
+        }
+        return 0;
+    }
+
+    return writeDescriptionRouteModule(iterator->data, buffer, bufferSize);
+}
+
+/** @brief Zapisuje informacje o wielu drogach krajowych w buforze.
+ * Zapisuje w buforze kolejno napisy funkcji @ref writeRouteDescription, każdy
+ * zakończony zerem. Napis numer @p i zaczyna się na pozycji @p offsets[i].
+ * Napisy, które nie zmieściły się w buforze, są obcinane lub pomijane.
+ * Wszystkie napisy zmieściły się w buforze wtedy i tylko wtedy, gdy wynik nie
+ * jest większy niż @p bufferSize.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] routeIds   – wskaźnik na tablicę numerów dróg krajowych;
+ * @param[in] count      – liczba elementów tablicy @p routeIds;
+ * @param[out] buffer    – wskaźnik na bufor lub NULL;
+ * @param[in] bufferSize – rozmiar bufora (@p 0 dla NULL);
+ * @param[out] offsets   – wskaźnik na tablicę @p count pozycji napisów lub
+ *                         NULL.
+ * @return Rozmiar bufora potrzebny na wszystkie napisy (z zerami na końcu).
+ */
+size_t writeRouteDescriptions(Map *map, const unsigned *routeIds, size_t count,
+                              char *buffer, size_t bufferSize,
+                              size_t *offsets) {
+    assert(routeIds != NULL || count == 0);
+    assert(buffer != NULL || bufferSize == 0);
+
+    size_t position = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (offsets != NULL) {
+            offsets[i] = position;
+        }
+
+        /* Napisy poza buforem są tylko mierzone. */
+        if (position < bufferSize) {
+            position += writeRouteDescription(map, routeIds[i],
+                                              buffer + position,
+                                              bufferSize - position) + 1;
+        } else {
+            position += writeRouteDescription(map, routeIds[i], NULL, 0) + 1;
+        }
+    }
+
+    return position;
+}
+
+/** @brief Znajduje miasta drogi wyznaczanej bez jej tworzenia.
+ * Sprawdza nazwy miast tak jak @ref newRouteByNamesMap. Nie zmienia mapy.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName1  – wskaźnik na opis nazwy pierwszego miasta;
+ * @param[in] cityName2  – wskaźnik na opis nazwy drugiego miasta;
+ * @param[out] city1     – wskaźnik na pierwsze miasto;
+ * @param[out] city2     – wskaźnik na drugie miasto.
+ * @return Wartość @p true, jeśli nazwy są poprawne, oba miasta istnieją
+ * i leżą w jednej składowej lub @p false w przeciwnym przypadku.
+ */
+bool findQueryCitiesMap(Map *map, const CityName *cityName1,
+                        const CityName *cityName2, City **city1,
+                        City **city2) {
+    if (!isValidNamesMap(map, cityName1, cityName2)) {
+        return false;
+    }
+
+    *city1 = findCityByNameOnHashMap(map->citiesMap, cityName1);
+    *city2 = findCityByNameOnHashMap(map->citiesMap, cityName2);
+    if (*city1 == NULL || *city2 == NULL) {
+        return false;
+    }
+
+    return areConnectedConnectivityOracle(map->connectivity, *city1, *city2);
+}
+
+/** @brief Przygotowuje mapę do wyznaczania dróg bez ich tworzenia.
+ * Przenosi mapę z obrazu do pamięci i odświeża indeksy wybranego algorytmu
+ * wyszukiwania, tak aby samo wyszukiwanie tylko czytało mapę. Musi być
+ * wywołana przed szukaniem miast po nazwach, bo tablica nazw mapy otwartej
+ * funkcją @ref openMap jest pusta do czasu przeniesienia.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] searchesCount – liczba wyszukiwań, które zostaną wykonane.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool prepareQueriesMap(Map *map, uint64_t searchesCount) {
+    return promoteMap(map) && refreshLandmarksMap(map) &&
+           refreshHierarchyMap(map, searchesCount);
+}
+
+/** @brief Wyznacza drogę krajową między miastami bez jej tworzenia.
+ * Czyta tylko miasta i odcinki dróg mapy, więc może być wywoływana przez
+ * wiele wątków naraz z różnymi stanami algorytmu.
+ * @param[in] city1      – wskaźnik na pierwsze miasto;
+ * @param[in] city2      – wskaźnik na drugie miasto;
+ * @param[in,out] state  – wskaźnik na stan algorytmu dijkstry;
+ * @param[out] length    – wskaźnik na długość wyznaczonej drogi.
+ * @return Wskaźnik na napis w formacie @ref queryRoute lub NULL, jeśli nie
+ * można jednoznacznie wyznaczyć drogi lub nie udało się zaalokować pamięci.
+ */
+char *queryCitiesMap(City *city1, City *city2, SearchState *state,
+                     uint64_t *length) {
+    Route *route = newRouteModule(0, city1, city2, state);
+    if (route == NULL) {
+        return NULL;
+    }
+
+    char *result = queryDescriptionRouteModule(route, length);
+    deleteRouteModule(route);
+
+    return result;
+}
+
+/** @brief Wyznacza drogę krajową bez jej tworzenia.
+ * Działa jak @ref queryRoute dla nazw z policzonymi haszami.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName1  – wskaźnik na opis nazwy pierwszego miasta;
+ * @param[in] cityName2  – wskaźnik na opis nazwy drugiego miasta;
+ * @param[out] length    – wskaźnik na długość wyznaczonej drogi lub NULL.
+ * @return Wskaźnik na napis lub NULL w przypadku błędu.
+ */
+char *queryRouteByNamesMap(Map *map, const CityName *cityName1,
+                           const CityName *cityName2, uint64_t *length) {
+    City *city1, *city2;
+    if (!prepareQueriesMap(map, 1) ||
+            !findQueryCitiesMap(map, cityName1, cityName2, &city1, &city2)) {
+        return NULL;
+    }
+
+    uint64_t routeLength;
+    char *result = queryCitiesMap(city1, city2, map->searchState,
+                                  &routeLength);
+    if (result != NULL && length != NULL) {
+        *length = routeLength;
+    }
+
+    return result;
+}
+
+/** @brief Wyznacza drogę krajową bez jej tworzenia.
+ * Wyznacza drogę krajową, którą między podanymi miastami utworzyłaby
+ * funkcja @ref newRoute, ale nie tworzy jej i nie zmienia dróg krajowych
+ * mapy. Alokuje pamięć na napis, który trzeba zwolnić za pomocą funkcji
+ * free. Napis ma format @ref getRouteDescription, w którym zamiast numeru
+ * drogi krajowej jest jej długość:
+ * długość drogi;nazwa miasta;długość odcinka drogi;rok budowy lub
+ * ostatniego remontu;nazwa miasta;…;nazwa miasta.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName1  – wskaźnik na napis reprezentujący nazwę miasta;
+ * @param[in] cityName2  – wskaźnik na napis reprezentujący nazwę miasta;
+ * @param[out] length    – wskaźnik na długość wyznaczonej drogi lub NULL.
+ * @return Wskaźnik na napis lub NULL, jeśli wystąpił błąd: któryś
+ * z parametrów ma niepoprawną wartość, któreś z podanych miast nie istnieje,
+ * obie podane nazwy miast są identyczne, nie można jednoznacznie wyznaczyć
+ * drogi krajowej między podanymi miastami lub nie udało się zaalokować
+ * pamięci.
+ */
+char const *queryRoute(Map *map, const char *cityName1, const char *cityName2,
+                       uint64_t *length) {
+    CityName name1 = cityNameFromString(cityName1);
+    CityName name2 = cityNameFromString(cityName2);
+
+    return queryRouteByNamesMap(map, &name1, &name2, length);
+}
+
+/**
+ * Struktura przechowująca dane zadań wyznaczania dróg w puli wątków.
+ */
+typedef struct QueriesTasks {
+    Map *map;               ///< wskaźnik na mapę
+    RouteQuery *queries;    ///< zapytania
+    City **cities;          ///< pary miast zapytań (NULL dla błędnych)
+} QueriesTasks;
+
+/** @brief Wyznacza drogę jednego zapytania w wątku puli.
+ * @param[in,out] argument  - wskaźnik na @ref QueriesTasks;
+ * @param[in] taskIndex     - numer zapytania;
+ * @param[in] threadIndex   - numer wątku.
+ */
+void queryRouteTask(void *argument, uint32_t taskIndex, uint32_t threadIndex) {
+    QueriesTasks *tasks = argument;
+    City **cities = tasks->cities + 2 * (size_t) taskIndex;
+    RouteQuery *query = &tasks->queries[taskIndex];
+
+    if (cities[0] != NULL) {
+        SearchState *state = tasks->map->threadsSearchStates[threadIndex];
+        query->description = queryCitiesMap(cities[0], cities[1], state,
+                                            &query->length);
+    }
+}
+
+/** @brief Wyznacza wiele dróg krajowych bez ich tworzenia.
+ * Dla kolejnych zapytań wywołuje funkcję @ref queryRoute. Jeśli mapa ma pulę
+ * wątków (@ref setThreadsCountMap), to drogi wyznaczane są równolegle, każda
+ * w stanie algorytmu swojego wątku. Wyniki nie zależą od liczby wątków.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in,out] queries – wskaźnik na tablicę zapytań;
+ * @param[in] count      – liczba elementów tablicy @p queries.
+ * @return Liczba zapytań, dla których wyznaczono drogę.
+ */
+size_t queryRoutes(Map *map, RouteQuery *queries, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        queries[i].description = NULL;
+        queries[i].length = 0;
+    }
+
+    if (map == NULL || count == 0 || !prepareQueriesMap(map, count)) {
+        return 0;
+    }
+
+    City **cities = malloc(2 * count * sizeof(City *));
+    if (cities == NULL) {
+        return 0;
+    }
+
+    /* Miasta szukamy w wątku wywołującym, bo wyrocznia spójności może się
+     * przy tym przebudować. */
+    for (size_t i = 0; i < count; i++) {
+        CityName name1 = cityNameFromString(queries[i].cityName1);
+        CityName name2 = cityNameFromString(queries[i].cityName2);
+        if (!findQueryCitiesMap(map, &name1, &name2, &cities[2 * i],
+                                &cities[2 * i + 1])) {
+            cities[2 * i] = NULL;
+        }
+    }
+
+    if (map->threadPool != NULL) {
+        QueriesTasks tasks;
+        tasks.map = map;
+        for (size_t start = 0; start < count; start += UINT32_MAX) {
+            size_t tasksCount = count - start;
+            if (tasksCount > UINT32_MAX) {
+                tasksCount = UINT32_MAX;
+            }
+            tasks.queries = queries + start;
+            tasks.cities = cities + 2 * start;
+            runThreadPool(map->threadPool, tasksCount, queryRouteTask, &tasks);
+        }
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            if (cities[2 * i] != NULL) {
+                queries[i].description = queryCitiesMap(
+                        cities[2 * i], cities[2 * i + 1], map->searchState,
+                        &queries[i].length);
+            }
+        }
+    }
+
+    free(cities);
+
+    size_t result = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (queries[i].description != NULL) {
+            result++;
+        } else {
+            queries[i].length = 0;
+        }
+    }
+
+    return result;
+}
+
+/** @brief Liczy macierz odległości między miastami o podanych nazwach.
+ * Działa jak @ref distanceMatrix dla nazw z policzonymi haszami.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] sources    – wskaźnik na tablicę opisów nazw miast źródłowych;
+ * @param[in] sourcesCount – liczba miast źródłowych;
+ * @param[in] targets    – wskaźnik na tablicę opisów nazw miast docelowych;
+ * @param[in] targetsCount – liczba miast docelowych;
+ * @param[out] matrix    – wskaźnik na tablicę wyników.
+ * @return Wartość @p true lub @p false w przypadku błędu.
+ */
+bool distanceMatrixByNamesMap(Map *map, const CityName *sources,
+                              size_t sourcesCount, const CityName *targets,
+                              size_t targetsCount, RouteDistance *matrix) {
+    if (map == NULL || sourcesCount == 0 || targetsCount == 0 ||
+            sourcesCount > UINT32_MAX || targetsCount > UINT32_MAX ||
+            !prepareQueriesMap(map, sourcesCount < targetsCount ?
+                                    sourcesCount : targetsCount)) {
+        return false;
+    }
+
+    City **cities = malloc((sourcesCount + targetsCount) * sizeof(City *));
+    if (cities == NULL) {
+        return false;
+    }
+
+    bool result = true;
+    for (size_t i = 0; result && i < sourcesCount + targetsCount; i++) {
+        const CityName *name = i < sourcesCount ? &sources[i]
+                                                : &targets[i - sourcesCount];
+        result = isValidNamesMap(map, name, NULL);
+        if (result) {
+            cities[i] = findCityByNameOnHashMap(map->citiesMap, name);
+            result = cities[i] != NULL;
+        }
+    }
+
+    if (result) {
+        SearchState **states = &map->searchState;
+        ThreadPool *pool = map->threadPool;
+        if (pool != NULL) {
+            states = map->threadsSearchStates;
+        }
+
+        result = computeDistanceMatrix(cities, sourcesCount,
+                                       cities + sourcesCount, targetsCount,
+                                       states, pool, matrix);
+    }
+
+    free(cities);
+    return result;
+}
+
+/** @brief Liczy macierz odległości między dwoma zbiorami miast.
+ * Dla każdego miasta źródłowego i każdego miasta docelowego wyznacza długość
+ * drogi, którą wybrałaby funkcja @ref newRoute, i rok budowy lub ostatniego
+ * remontu jej najdawniej wybudowanego odcinka, nie zmieniając mapy. Wynik
+ * dla miasta @p sources[i] i miasta @p targets[j] zapisuje
+ * w @p matrix[i * targetsCount + j]. W przeciwieństwie do funkcji
+ * @ref newRoute nie wymaga jednoznaczności drogi, a miasta mogą się
+ * powtarzać. Jeśli miasta nie łączy żadna droga, to długość wyniku wynosi
+ * @p -1. Droga z miasta do niego samego ma długość @p 0 i rok @p 0.
+ * Wyszukiwania są wspólne dla wielu par i wykonywane w puli wątków mapy
+ * (@ref setThreadsCountMap), jeśli mapa ją ma.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] sources    – wskaźnik na tablicę nazw miast źródłowych;
+ * @param[in] sourcesCount – liczba miast źródłowych;
+ * @param[in] targets    – wskaźnik na tablicę nazw miast docelowych;
+ * @param[in] targetsCount – liczba miast docelowych;
+ * @param[out] matrix    – wskaźnik na tablicę
+ *                         @p sourcesCount * @p targetsCount wyników.
+ * @return Wartość @p true lub @p false, jeśli wystąpił błąd: któryś
+ * z parametrów ma niepoprawną wartość, któreś z podanych miast nie istnieje,
+ * któryś ze zbiorów jest pusty lub nie udało się zaalokować pamięci.
+ */
+bool distanceMatrix(Map *map, const char *const *sources, size_t sourcesCount,
+                    const char *const *targets, size_t targetsCount,
+                    RouteDistance *matrix) {
+    if (sources == NULL || targets == NULL || matrix == NULL ||
+            sourcesCount > SIZE_MAX / 2 / sizeof(CityName) ||
+            targetsCount > SIZE_MAX / 2 / sizeof(CityName)) {
+        return false;
+    }
+
+    CityName *names = malloc((sourcesCount + targetsCount) * sizeof(CityName));
+    if (names == NULL) {
+        return false;
+    }
+
+    for (size_t i = 0; i < sourcesCount; i++) {
+        names[i] = cityNameFromString(sources[i]);
+    }
+    for (size_t i = 0; i < targetsCount; i++) {
+        names[sourcesCount + i] = cityNameFromString(targets[i]);
+    }
+
+    bool result = distanceMatrixByNamesMap(map, names, sourcesCount,
+                                           names + sourcesCount, targetsCount,
+                                           matrix);
+    free(names);
+
+    return result;
+}
+
+/** @brief Zapisuje macierz odległości w buforze.
+ * Każdy wiersz macierzy zajmuje jeden wiersz napisu, w którym dla kolejnych
+ * miast docelowych występuje długość drogi i rok jej najdawniej wybudowanego
+ * odcinka, rozdzielone średnikami. Brak drogi lub odcinka oznaczany jest
+ * znakiem '-'.
+ * @param[in] matrix     – wskaźnik na macierz;
+ * @param[in] rowsCount  – liczba wierszy macierzy;
+ * @param[in] columnsCount – liczba kolumn macierzy;
+ * @param[out] buffer    – wskaźnik na bufor lub NULL;
+ * @param[in] bufferSize – rozmiar bufora (@p 0 dla NULL).
+ * @return Długość całego napisu (bez zera na końcu).
+ */
+size_t writeDistanceMatrixMap(const RouteDistance *matrix, size_t rowsCount,
+                              size_t columnsCount, char *buffer,
+                              size_t bufferSize) {
+    size_t position = 0;
+    for (size_t i = 0; i < rowsCount; i++) {
+        if (i != 0) {
+            if (position < bufferSize) {
+                buffer[position] = '\n';
+            }
+            position++;
+        }
+
+        StringWriter writer;
+        if (position < bufferSize) {
+            initStringWriter(&writer, buffer + position,
+                             bufferSize - position);
+        } else {
+            initStringWriter(&writer, NULL, 0);
+        }
+
+        for (size_t j = 0; j < columnsCount; j++) {
+            const RouteDistance *result = &matrix[i * columnsCount + j];
+            if (result->length < 0) {
+                appendStringWriterString(&writer, "-");
+            } else {
+                appendStringWriterInteger(&writer, result->length);
+            }
+            if (result->oldestRoad == 0) {
+                appendStringWriterString(&writer, "-");
+            } else {
+                appendStringWriterInteger(&writer, result->oldestRoad);
+            }
+        }
+
+        position += finishStringWriter(&writer);
+    }
+
+    return position;
+}
+
+/** @brief Wykonuje polecenie liczenia macierzy odległości.
+ * Pierwsze @p command->sourcesCount miast polecenia to miasta źródłowe,
+ * a pozostałe to miasta docelowe.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] command    – wskaźnik na polecenie.
+ * @return Wskaźnik na napis w formacie @ref writeDistanceMatrixMap lub NULL
+ * w przypadku błędu.
+ */
+char *distanceMatrixCommandMap(Map *map, const Command *command) {
+    size_t sourcesCount = command->sourcesCount;
+    if (sourcesCount == 0 || sourcesCount >= command->citiesCount) {
+        return NULL;
+    }
+
+    size_t targetsCount = command->citiesCount - sourcesCount;
+    if (targetsCount > SIZE_MAX / sizeof(RouteDistance) / sourcesCount) {
+        return NULL;
+    }
+
+    RouteDistance *matrix = malloc(sourcesCount * targetsCount *
+                                   sizeof(RouteDistance));
+    if (matrix == NULL) {
+        return NULL;
+    }
+
+    char *result = NULL;
+    if (distanceMatrixByNamesMap(map, command->cities, sourcesCount,
+                                 command->cities + sourcesCount, targetsCount,
+                                 matrix)) {
+        size_t size = writeDistanceMatrixMap(matrix, sourcesCount,
+                                             targetsCount, NULL, 0) + 1;
+        result = malloc(size);
+        if (result != NULL) {
+            writeDistanceMatrixMap(matrix, sourcesCount, targetsCount, result,
+                                   size);
+        }
+    }
+
+    free(matrix);
+    return result;
+}
+
+/** @brief Zapisuje wynik sprawdzenia usunięcia odcinka drogi w buforze.
+ * Napis zaczyna się od @p 1 lub @p 0 (czy można usunąć odcinek), po którym
+ * dla kolejnych dróg krajowych występuje numer drogi i długość objazdu lub
+ * znak '-', rozdzielone średnikami.
+ * @param[in] isFeasible – czy można usunąć odcinek;
+ * @param[in] detours    – wskaźnik na tablicę objazdów;
+ * @param[in] count      – liczba objazdów;
+ * @param[out] buffer    – wskaźnik na bufor lub NULL;
+ * @param[in] bufferSize – rozmiar bufora (@p 0 dla NULL).
+ * @return Długość całego napisu (bez zera na końcu).
+ */
+size_t writeRouteDetoursMap(bool isFeasible, const RouteDetour *detours,
+                            size_t count, char *buffer, size_t bufferSize) {
+    StringWriter writer;
+    initStringWriter(&writer, buffer, bufferSize);
+
+    appendStringWriterInteger(&writer, isFeasible ? 1 : 0);
+    for (size_t i = 0; i < count; i++) {
+        appendStringWriterInteger(&writer, detours[i].routeId);
+        if (detours[i].length < 0) {
+            appendStringWriterString(&writer, "-");
+        } else {
+            appendStringWriterInteger(&writer, detours[i].length);
+        }
+    }
+
+    return finishStringWriter(&writer);
+}
+
+/** @brief Wykonuje polecenie sprawdzenia usunięcia odcinka drogi.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] command    – wskaźnik na polecenie.
+ * @return Wskaźnik na napis w formacie @ref writeRouteDetoursMap lub NULL
+ * w przypadku błędu.
+ */
+char *checkRemoveRoadCommandMap(Map *map, const Command *command) {
+    /* Przez odcinek przechodzi co najwyżej każda droga krajowa mapy. */
+    if (!promoteMap(map)) {
+        return NULL;
+    }
+
+    size_t routesCount = sizeList(map->routes);
+    RouteDetour *detours = malloc(sizeof(RouteDetour) * (routesCount + 1));
+    if (detours == NULL) {
+        return NULL;
+    }
+
+    bool isFeasible;
+    size_t count;
+    char *result = NULL;
+    if (checkRemoveRoadByNamesMap(map, &command->cities[0],
+                                  &command->cities[1], &isFeasible, detours,
+                                  routesCount, &count)) {
+        size_t size = writeRouteDetoursMap(isFeasible, detours, count, NULL,
+                                           0) + 1;
+        result = malloc(size);
+        if (result != NULL) {
+            writeRouteDetoursMap(isFeasible, detours, count, result, size);
+        }
+    }
+
+    free(detours);
+    return result;
+}
+
+/** @brief Porównuje opisy nazw miast.
+ * Funkcja porównująca dla qsort: porządkuje wskaźniki na opisy nazw według
+ * haszu, a nazwy o równych haszach leksykograficznie.
+ * @param[in] a          – wskaźnik na wskaźnik na pierwszy opis;
+ * @param[in] b          – wskaźnik na wskaźnik na drugi opis.
+ * @return Liczba ujemna, zero lub dodatnia, jeśli pierwsza nazwa jest
+ * odpowiednio mniejsza, równa lub większa od drugiej.
+ */
+int compareCityNamesMap(const void *a, const void *b) {
+    const CityName *name1 = *(const CityName * const *) a;
+    const CityName *name2 = *(const CityName * const *) b;
+
+    if (name1->hash != name2->hash) {
+        return name1->hash < name2->hash ? -1 : 1;
+    }
+
+    return strcmp(name1->name, name2->name);
+}
+
+/** @brief Sprawdza czy droga krajowa nie zawiera cyklu.
+ * Sprawdza czy żadne miasto nie powtarza się w poleceniu
+ * @ref COMMAND_ADD_ROUTE.
+ * @param[in] command    – wskaźnik na polecenie.
+ * @return Wartość @p true jeśli droga krajowa nie zawiera cykli lub @p false
+ * w przeciwnym przypadku albo jeśli nie udało się zaalokować pamięci.
+ */
+bool isRouteWithoutCycleMap(const Command *command) {
+    assert(command);
+
+    const CityName **names = malloc(sizeof(CityName *) * command->citiesCount);
+    if (names == NULL) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < command->citiesCount; i++) {
+        names[i] = &command->cities[i];
+    }
+
+    qsort(names, command->citiesCount, sizeof(CityName *),
+          compareCityNamesMap);
+
+    bool result = true;
+    for (uint32_t i = 1; i < command->citiesCount && result; i++) {
+        if (compareCityNamesMap(&names[i - 1], &names[i]) == 0) {
+            result = false;
+        }
+    }
+
+    free(names);
+    return result;
+}
+
+/** @brief Sprawdza czy drogę krajową można dodać do mapy.
+ * Sprawdza poprawność wszystkich argumentów polecenia
+ * @ref COMMAND_ADD_ROUTE (w tym czy można dodać odpowiednie odcinki na mapę
+ * dróg).
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] command    – wskaźnik na polecenie.
+ * @return Wartość @p true jeśli polecenie jest poprawne lub @p false
+ * w przeciwnym wypadku.
+ */
+bool canAddRouteMap(Map *map, const Command *command) {
+    assert(map);
+    assert(command);
+
+    unsigned routeId = command->routeId;
+    if (command->citiesCount < 2 || routeId < 1 || 999 < routeId ||
+            findRouteOnList(map->routes, routeId) != NULL) {
+        return false;
+    }
+
+    if (!isRouteWithoutCycleMap(command)) {
+        return false;
+    }
+
+    /* Przeglądamy po kolei wszystkie wymagane odcinki drogowe i sprawdzamy
+     * czy są poprawne. */
+    if (!command->cities[0].isValid) {
+        return false;
+    }
+    City *previousCity = findCityByNameOnHashMap(map->citiesMap,
+                                                 &command->cities[0]);
+
+    for (uint32_t i = 1; i < command->citiesCount; i++) {
+        unsigned length = command->lengths[i - 1];
+        int builtYear = command->years[i - 1];
+        if (length == 0 || builtYear == 0 || !command->cities[i].isValid) {
+            return false;
+        }
+
+        City *city = findCityByNameOnHashMap(map->citiesMap,
+                                             &command->cities[i]);
+
+        /* Jeśli istniały miasta previousCity i city oraz odcinek drogowy
+         * między nimi, to musimy sprawdzić czy nie kłóci się on z tym,
+         * który chcemy dodać. */
+        if (previousCity != NULL && city != NULL) {
+            ListIterator *roadIterator = findRoadModule(previousCity, city);
+            if (roadIterator != NULL) {
+                Road *road = roadIterator->data;
+                if (road->length != length ||
+                        road->buildYearOrLastRepairYear > builtYear) {
+                    return false;
+                }
+            }
+        }
+
+        previousCity = city;
+    }
+
+    return true;
+}
+
+/** @brief Dodaje do mapy drogę krajową podaną przez kolejne miasta.
+ * Sprawdza poprawność polecenia @ref COMMAND_ADD_ROUTE. Jeśli jest poprawne
+ * to uaktualnia po kolei odcinki drogi (@ref updateRoad). Jeśli zabraknie
+ * pamięci to zmiany pozostają na mapie. Na koniec dodawana jest nowa droga
+ * krajowa.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] command    – wskaźnik na polecenie.
+ * @return Wartość @p true jeśli droga krajowa została dodana lub @p false
+ * w przeciwnym przypadku.
+ */
+bool addRouteByNamesMap(Map *map, const Command *command) {
+    assert(command);
+
+    /* Polecenie czyta bezpośrednio miasta i drogi krajowe mapy. */
+    if (map == NULL || !promoteMap(map) || !canAddRouteMap(map, command)) {
+        return false;
+    }
+
+    City *city = findCityByNameOnHashMapInsertIfNecessary(map->citiesMap,
+                                                          map->cities,
+                                                          &command->cities[0]);
+    if (city == NULL) {
+        return false;
+    }
+    Route *route = newRouteModule(command->routeId, city, city,
+                                  map->searchState);
+    if (route == NULL) {
+        return false;
+    }
+
+    for (uint32_t i = 1; i < command->citiesCount; i++) {
+        /* Dodajemy odpowiedni odcinek drogowy jeśli trzeba. */
+        if (!updateRoadByNamesMap(map, &command->cities[i - 1],
+                                  &command->cities[i], command->lengths[i - 1],
+                                  command->years[i - 1])) {
+            deleteRouteModule(route);
+            return false;
+        }
+
+        /* Dodajemy miasto do drogi krajowej. */
+        city = findCityByNameOnHashMap(map->citiesMap, &command->cities[i]);
+        if (city == NULL || insertList(route->cities->end, city) == NULL) {
+            deleteRouteModule(route);
+            return false;
+        }
+    }
+
+    if (insertList(map->routes->end, route) == NULL) {
+        deleteRouteModule(route);
+        return false;
+    }
+
+    refreshReplacementPathsMap(map);
+    markRouteMap(map, command->routeId);
+    publishRoutesMap(map);
+    journalRouteMap(map, command->routeId);
+    return true;
+}
+
+/** @brief Włącza lub wyłącza współbieżne odczyty opisów dróg krajowych.
+ * Po włączeniu każda funkcja modyfikująca mapę publikuje nowe opisy
+ * zmienionych dróg krajowych, które wątki zarejestrowane funkcją
+ * @ref newReaderMap czytają funkcją @ref readRouteDescriptionMap równolegle
+ * z modyfikacjami (zob. @ref RouteSnapshots). Modyfikacje nadal wykonuje
+ * jeden wątek. Przy wyłączaniu żaden wątek czytający nie może być
+ * zarejestrowany.
+ * @param[in,out] map       – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] isEnabled     – czy włączyć współbieżne odczyty.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool setConcurrentReadsMap(Map *map, bool isEnabled) {
+    assert(map);
+
+    if (!isEnabled || map->snapshots != NULL) {
+        if (!isEnabled) {
+            deleteRouteSnapshots(map->snapshots);
+            map->snapshots = NULL;
+        }
+        return true;
+    }
+
+    map->snapshots = newRouteSnapshots();
+    if (map->snapshots == NULL) {
+        return false;
+    }
+
+    for (unsigned routeId = 1; routeId < ROUTE_SNAPSHOTS_SIZE; routeId++) {
+        markRouteSnapshots(map->snapshots, routeId);
+    }
+    if (!publishRouteSnapshots(map->snapshots, writeSnapshotMap, map)) {
+        deleteRouteSnapshots(map->snapshots);
+        map->snapshots = NULL;
+        return false;
+    }
 
     return true;
 }
+
+/** @brief Rejestruje wątek czytający opisy dróg krajowych.
+ * Wymaga włączonych współbieżnych odczytów (@ref setConcurrentReadsMap).
+ * @param[in,out] map       – wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Numer wątku czytającego lub @p -1, jeśli zarejestrowano już
+ * @ref ROUTE_SNAPSHOTS_MAX_READERS wątków.
+ */
+int32_t newReaderMap(Map *map) {
+    assert(map && map->snapshots);
+
+    return newReaderRouteSnapshots(map->snapshots);
+}
+
+/** @brief Wyrejestrowuje wątek czytający opisy dróg krajowych.
+ * @param[in,out] map       – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] reader        – numer wątku czytającego.
+ */
+void deleteReaderMap(Map *map, int32_t reader) {
+    assert(map && map->snapshots);
+
+    deleteReaderRouteSnapshots(map->snapshots, reader);
+}
+
+/** @brief Zapisuje opis drogi krajowej w buforze bez blokowania mapy.
+ * Działa jak @ref writeRouteDescription, ale czyta ostatni opublikowany opis,
+ * więc może być wywoływana przez wiele wątków równolegle z funkcjami
+ * modyfikującymi mapę. Wynik uwzględnia wszystkie modyfikacje zakończone przed
+ * wywołaniem.
+ * @param[in,out] map       – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] reader        – numer wątku czytającego;
+ * @param[in] routeId       – numer drogi krajowej;
+ * @param[out] buffer       – wskaźnik na bufor lub NULL;
+ * @param[in] bufferSize    – rozmiar bufora (@p 0 dla NULL).
+ * @return Długość całego napisu (bez zera na końcu), także jeśli nie
+ * zmieścił się w buforze.
+ */
+size_t readRouteDescriptionMap(Map *map, int32_t reader, unsigned routeId,
+                               char *buffer, size_t bufferSize) {
+    assert(map && map->snapshots);
+
+    return readRouteSnapshots(map->snapshots, reader, routeId, buffer,
+                              bufferSize);
+}
+
+/** @brief Wykonuje polecenie na mapie.
+ * Wywołuje funkcję mapy odpowiadającą rodzajowi polecenia, korzystając
+ * z policzonych wcześniej haszy nazw miast. Polecenie
+ * @ref COMMAND_GET_ROUTE_DESCRIPTION i zapytania (@ref isQueryCommandMap) nie
+ * zmieniają mapy, więc ich wyniki (funkcje @ref getRouteDescription,
+ * @ref writeRouteDescription i @ref queryCommandMap) wypisuje wywołujący.
+ * Polecenie @ref COMMAND_NEW_ROUTES kończy się sukcesem, jeśli utworzono
+ * wszystkie jego drogi krajowe.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] command    – wskaźnik na polecenie.
+ * @return Wynik odpowiedniej funkcji mapy lub @p false dla polecenia
+ * @ref COMMAND_GET_ROUTE_DESCRIPTION i zapytań.
+ */
+bool executeCommandMap(Map *map, const Command *command) {
+    assert(command);
+
+    switch (command->type) {
+        case COMMAND_ADD_ROAD:
+            return addRoadByNamesMap(map, &command->cities[0],
+                                     &command->cities[1], command->lengths[0],
+                                     command->years[0]);
+        case COMMAND_REPAIR_ROAD:
+            return repairRoadByNamesMap(map, &command->cities[0],
+                                        &command->cities[1],
+                                        command->years[0]);
+        case COMMAND_NEW_ROUTE:
+            return newRouteByNamesMap(map, command->routeId,
+                                      &command->cities[0],
+                                      &command->cities[1]);
+        case COMMAND_EXTEND_ROUTE:
+            return extendRouteByNameMap(map, command->routeId,
+                                        &command->cities[0]);
+        case COMMAND_REMOVE_ROAD:
+            return removeRoadByNamesMap(map, &command->cities[0],
+                                        &command->cities[1]);
+        case COMMAND_REMOVE_ROUTE:
+            return removeRoute(map, command->routeId);
+        case COMMAND_ADD_ROUTE:
+            return addRouteByNamesMap(map, command);
+        case COMMAND_NEW_ROUTES:
+            return newRoutesByNamesMap(map, &command->cities[0],
+                                       command->routeIds, &command->cities[1],
+                                       command->citiesCount - 1, NULL) ==
+                   command->citiesCount - 1;
+        case COMMAND_REMOVE_ROADS:
+            return removeRoadsByNamesMap(map, command->cities,
+                                         command->citiesCount / 2);
+        default:
+            return false;
+    }
+}
+
+/** @brief Sprawdza, czy polecenie jest zapytaniem.
+ * Zapytania (@ref COMMAND_QUERY_ROUTE, @ref COMMAND_DISTANCE_MATRIX
+ * i @ref COMMAND_CHECK_REMOVE_ROAD) nie zmieniają mapy, a ich wyniki zwraca
+ * funkcja @ref queryCommandMap.
+ * @param[in] command    – wskaźnik na polecenie.
+ * @return Wartość @p true, jeśli polecenie jest zapytaniem lub @p false
+ * w przeciwnym przypadku.
+ */
+bool isQueryCommandMap(const Command *command) {
+    assert(command);
+
+    return command->type == COMMAND_QUERY_ROUTE ||
+           command->type == COMMAND_DISTANCE_MATRIX ||
+           command->type == COMMAND_CHECK_REMOVE_ROAD;
+}
+
+/** @brief Wykonuje zapytanie.
+ * Dla polecenia @ref COMMAND_QUERY_ROUTE wywołuje funkcję @ref queryRoute,
+ * dla polecenia @ref COMMAND_DISTANCE_MATRIX funkcję @ref distanceMatrix,
+ * a dla polecenia @ref COMMAND_CHECK_REMOVE_ROAD funkcję
+ * @ref checkRemoveRoad, korzystając z policzonych wcześniej haszy nazw
+ * miast. Alokuje pamięć na napis, który trzeba zwolnić za pomocą funkcji
+ * free. Wynikiem macierzy odległości jest po jednym wierszu na miasto
+ * źródłowe, w którym dla kolejnych miast docelowych występuje długość drogi
+ * i rok jej najdawniej wybudowanego odcinka lub znak '-', jeśli drogi lub
+ * odcinka nie ma. Wynikiem sprawdzenia usunięcia odcinka jest @p 1 lub
+ * @p 0 (czy można go usunąć), a po nim numery dróg krajowych przechodzących
+ * przez odcinek i długości ich objazdów lub znak '-'.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] command    – wskaźnik na zapytanie.
+ * @return Wskaźnik na napis lub NULL, jeśli wystąpił błąd.
+ */
+char const *queryCommandMap(Map *map, const Command *command) {
+    assert(command && isQueryCommandMap(command));
+
+    if (command->type == COMMAND_DISTANCE_MATRIX) {
+        return distanceMatrixCommandMap(map, command);
+    } else if (command->type == COMMAND_CHECK_REMOVE_ROAD) {
+        return checkRemoveRoadCommandMap(map, command);
+    }
+
+    return queryRouteByNamesMap(map, &command->cities[0],
+                                &command->cities[1], NULL);
+}
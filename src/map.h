@@ -12,8 +12,22 @@
 
 #include "list.h"
 #include "hash_map.h"
+#include "search_state.h"
+#include "thread_pool.h"
+#include "landmark_index.h"
+#include "contraction_hierarchy.h"
+#include "connectivity_oracle.h"
+#include "distance_matrix.h"
+#include "search_cache.h"
+#include "replacement_paths.h"
+#include "map_image.h"
+#include "journal.h"
+#include "route_snapshots.h"
+#include "command.h"
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
 
 /**
  * Struktura przechowująca mapę dróg krajowych.
@@ -22,8 +36,56 @@ typedef struct Map {
     List *cities;        ///< Lista miast na mapie
     List *routes;        ///< Lista dróg krajowych na mapie
     HashMap *citiesMap;  ///< Haszmapa miast na mapie
+    SearchState *searchState;   ///< Stan algorytmu dijkstry
+    ThreadPool *threadPool;     ///< Pula wątków lub NULL (tryb sekwencyjny)
+    SearchState **threadsSearchStates;  ///< Stany algorytmu dla wątków puli
+    LandmarkIndex *landmarks;   ///< Indeks punktów orientacyjnych lub NULL
+    ContractionHierarchy *hierarchy;    ///< Hierarchia kontrakcji lub NULL
+    uint64_t hierarchySettledMark;  ///< Liczba miast obsłużonych przez
+                                    ///< wyszukiwania do ostatniej zmiany
+                                    ///< odcinków dróg
+    ConnectivityOracle *connectivity;   ///< Wyrocznia spójności mapy
+    MapImage *image;     ///< Obraz mapy tylko do zapytań lub NULL
+    uint64_t promotionsCount;   ///< Liczba zamian obrazu na zwykłą mapę
+    Journal *journal;    ///< Dziennik poleceń modyfikujących lub NULL
+    RouteSnapshots *snapshots;  ///< Opisy dla współbieżnych odczytów lub NULL
+    uint64_t graphVersion;      ///< Wersja odcinków dróg, zwiększana po
+                                ///< każdej ich zmianie
+    SearchCache *searchCache;   ///< Pamięć podręczna drzew najkrótszych dróg
+                                ///< lub NULL
+    unsigned *indexedRouteIds;  ///< Numery dróg krajowych z indeksem objazdów
+    uint32_t indexedRoutesCount;    ///< Liczba numerów w @ref indexedRouteIds
 } Map;
 
+/**
+ * Struktura opisująca odcinek drogi dodawany funkcją @ref addRoads.
+ */
+typedef struct RoadTuple {
+    const char *cityName1;  ///< nazwa pierwszego miasta
+    const char *cityName2;  ///< nazwa drugiego miasta
+    unsigned length;        ///< długość w km odcinka drogi
+    int builtYear;          ///< rok budowy odcinka drogi
+} RoadTuple;
+
+/**
+ * Struktura opisująca drogę wyznaczaną funkcją @ref queryRoutes.
+ */
+typedef struct RouteQuery {
+    const char *cityName1;  ///< nazwa pierwszego miasta
+    const char *cityName2;  ///< nazwa drugiego miasta
+    char *description;      ///< wynik @ref queryRoute (NULL przy błędzie)
+    uint64_t length;        ///< długość wyznaczonej drogi
+} RouteQuery;
+
+/**
+ * Struktura opisująca objazd wyznaczany funkcją @ref checkRemoveRoad.
+ */
+typedef struct RouteDetour {
+    unsigned routeId;       ///< numer drogi krajowej przez odcinek
+    int64_t length;         ///< długość objazdu lub @p -1, jeśli nie da się go
+                            ///  jednoznacznie wyznaczyć
+} RouteDetour;
+
 /** @brief Tworzy nową strukturę.
  * Tworzy nową, pustą strukturę niezawierającą żadnych miast, odcinków dróg ani
  * dróg krajowych.
@@ -39,6 +101,251 @@ Map* newMap(void);
  */
 void deleteMap(Map *map);
 
+/** @brief Zapisuje mapę do pliku.
+ * Zapisuje miasta, odcinki dróg i drogi krajowe w zwartym, binarnym formacie
+ * z numerem wersji i sumą kontrolną (zob. @ref snapshot.h). Obraz zapisywany
+ * jest do pliku tymczasowego, który na końcu zastępuje plik @p path, więc
+ * przerwany zapis nie psuje poprzedniego obrazu.
+ * @param[in] map        – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] path       – wskaźnik na ścieżkę do pliku.
+ * @return Wartość @p true, jeśli mapa została zapisana. Wartość @p false,
+ * jeśli któryś z parametrów ma wartość NULL, nie udało się zapisać pliku lub
+ * zaalokować pamięci.
+ */
+bool saveMap(Map *map, const char *path);
+
+/** @brief Wczytuje mapę z pliku.
+ * Tworzy nową strukturę z miastami, odcinkami dróg i drogami krajowymi
+ * zapisanymi funkcją @ref saveMap, bez interpretowania poleceń tekstowych.
+ * @param[in] path       – wskaźnik na ścieżkę do pliku.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy plik nie istnieje,
+ * nie jest poprawnym obrazem mapy (np. ma inną wersję lub niezgodną sumę
+ * kontrolną) lub nie udało się zaalokować pamięci.
+ */
+Map *loadMap(const char *path);
+
+/** @brief Zapisuje obraz mapy do odwzorowania w pamięci.
+ * Zapisuje miasta, listy sąsiedztwa, drogi krajowe i nazwy miast w formacie
+ * bez wskaźników (zob. @ref map_image.h), który funkcja @ref openMap
+ * odwzorowuje w pamięci bez wczytywania. Plik zapisywany jest przez plik
+ * tymczasowy.
+ * @param[in] map        – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] path       – wskaźnik na ścieżkę do pliku.
+ * @return Wartość @p true, jeśli obraz został zapisany. Wartość @p false,
+ * jeśli któryś z parametrów ma wartość NULL, nie udało się zapisać pliku lub
+ * zaalokować pamięci.
+ */
+bool saveMapImage(Map *map, const char *path);
+
+/** @brief Odwzorowuje obraz mapy w pamięci.
+ * Tworzy mapę tylko do zapytań opartą na obrazie zapisanym funkcją
+ * @ref saveMapImage. Obraz nie jest wczytywany, a jego strony są
+ * współdzielone przez procesy korzystające z tego samego pliku. Pierwsze
+ * polecenie modyfikujące mapę zamienia ją na zwykłą mapę
+ * (zob. @ref promoteMap).
+ * @param[in] path       – wskaźnik na ścieżkę do pliku.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy plik nie jest
+ * poprawnym obrazem mapy lub nie udało się zaalokować pamięci.
+ */
+Map *openMap(const char *path);
+
+/** @brief Zamienia mapę tylko do zapytań na zwykłą mapę.
+ * Kopiuje obraz mapy odwzorowany funkcją @ref openMap do struktur mapy
+ * i zwalnia odwzorowanie. Nic nie robi dla zwykłej mapy. Wywoływana przez
+ * wszystkie funkcje modyfikujące mapę oraz przez @ref queryRoute,
+ * @ref queryRoutes i @ref distanceMatrix, więc po nich mapa nie korzysta
+ * już ze stron obrazu współdzielonych z innymi procesami.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Wartość @p true, jeśli mapa jest zwykłą mapą. Wartość @p false,
+ * jeśli obraz jest uszkodzony (mapa pozostaje wtedy mapą tylko do zapytań)
+ * lub nie udało się zaalokować pamięci.
+ */
+bool promoteMap(Map *map);
+
+/** @brief Odtwarza mapę z punktu kontrolnego i dziennika.
+ * Wczytuje punkt kontrolny zapisany funkcją @ref saveMap (lub tworzy pustą
+ * mapę, jeśli plik @p checkpointPath nie istnieje), a następnie wykonuje
+ * polecenia zapisane w dzienniku po tym punkcie kontrolnym, bez
+ * interpretowania poleceń tekstowych. Niedokończony rekord na końcu
+ * dziennika jest usuwany. Od tej chwili każde udane polecenie modyfikujące
+ * mapę jest dopisywane do dziennika (zob. @ref journal.h).
+ * @param[in] checkpointPath – wskaźnik na ścieżkę do punktu kontrolnego;
+ * @param[in] journalPath – wskaźnik na ścieżkę do pliku dziennika.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy punkt kontrolny nie
+ * jest poprawnym obrazem mapy, w dzienniku brakuje rekordów następujących po
+ * punkcie kontrolnym, nie udało się otworzyć dziennika lub zaalokować
+ * pamięci.
+ */
+Map *recoverMap(const char *checkpointPath, const char *journalPath);
+
+/** @brief Ustawia sposób zapisu dziennika mapy.
+ * Rekordy dziennika zapisywane są do pliku (i synchronizowane) grupami po
+ * @p groupSize poleceń, więc po awarii można stracić mniej niż
+ * @p groupSize ostatnich poleceń. Co @p checkpointInterval poleceń zapisywany
+ * jest punkt kontrolny (zob. @ref checkpointMap).
+ * @param[in,out] map    – wskaźnik na mapę utworzoną funkcją @ref recoverMap;
+ * @param[in] groupSize  – liczba rekordów zapisywanych naraz, dodatnia;
+ * @param[in] checkpointInterval – liczba poleceń między punktami kontrolnymi
+ *                         lub @p 0, jeśli punkty nie są zapisywane
+ *                         automatycznie.
+ * @return Wartość @p true lub @p false, jeśli mapa nie ma dziennika lub
+ * @p groupSize jest równe @p 0.
+ */
+bool setJournalPolicyMap(Map *map, uint32_t groupSize,
+                         uint32_t checkpointInterval);
+
+/** @brief Włącza zapisywanie punktów kontrolnych w tle.
+ * Automatyczne punkty kontrolne (zob. @ref setJournalPolicyMap) zapisuje
+ * wtedy proces potomny utworzony funkcją fork z kopii mapy współdzielonej
+ * z rodzicem do chwili zapisu (copy-on-write), a rodzic w tym czasie
+ * wykonuje dalsze polecenia.
+ * @param[in,out] map    – wskaźnik na mapę utworzoną funkcją @ref recoverMap;
+ * @param[in] isBackground – czy zapisywać punkty kontrolne w tle.
+ * @return Wartość @p true lub @p false, jeśli mapa nie ma dziennika.
+ */
+bool setBackgroundCheckpointsMap(Map *map, bool isBackground);
+
+/** @brief Czeka na zakończenie zapisywania punktu kontrolnego w tle.
+ * Nic nie robi, jeśli mapa nie ma dziennika lub żaden punkt kontrolny nie
+ * jest zapisywany.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg.
+ */
+void waitForCheckpointMap(Map *map);
+
+/** @brief Zapisuje punkt kontrolny mapy.
+ * Czeka na zakończenie zapisywania punktu kontrolnego w tle, zapisuje
+ * niezapisane rekordy dziennika, zapisuje mapę funkcją @ref saveMap do
+ * pliku punktu kontrolnego i zaczyna nowy, pusty dziennik. Punkt kontrolny
+ * zawiera numer następnego rekordu dziennika, więc jeśli zapis zostanie
+ * przerwany przed zastąpieniem dziennika, to przy odtwarzaniu uwzględnione
+ * rekordy są pomijane.
+ * @param[in,out] map    – wskaźnik na mapę utworzoną funkcją @ref recoverMap.
+ * @return Wartość @p true lub @p false, jeśli mapa nie ma dziennika, nie
+ * udało się zapisać pliku lub zaalokować pamięci.
+ */
+bool checkpointMap(Map *map);
+
+/** @brief Dopisuje do dziennika drogę krajową podaną przez miasta.
+ * Wywoływana po dodaniu do mapy drogi krajowej zbudowanej z kolejnych miast
+ * (a nie wyznaczonej funkcją @ref newRoute). Nic nie robi, jeśli mapa nie ma
+ * dziennika.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] routeId    – numer dodanej drogi krajowej.
+ */
+void journalRouteMap(Map *map, unsigned routeId);
+
+/** @brief Ustawia liczbę wątków używanych przez mapę.
+ * Dla @p threadsCount większego od @p 1 tworzy pulę wątków, w której
+ * równolegle szukane są objazdy dla dróg krajowych w funkcji
+ * @ref removeRoad. Każdy wątek ma własny stan algorytmu dijkstry. Wyniki są
+ * takie same jak przy wykonaniu sekwencyjnym.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] threadsCount – liczba wątków.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci lub utworzyć wątków (mapa pozostaje wtedy w trybie sekwencyjnym).
+ */
+bool setThreadsCountMap(Map *map, uint32_t threadsCount);
+
+/** @brief Wybiera algorytm wyszukiwania dróg krajowych.
+ * Ustawia algorytm używany przy tworzeniu dróg krajowych i szukaniu objazdów.
+ * Dwukierunkowy algorytm dijkstry daje takie same wyniki jak zwykły, ale
+ * zwykle obsługuje znacznie mniej miast. Przedłużanie drogi krajowej
+ * dwukierunkowym algorytmem używa zwykłego algorytmu dijkstry. Algorytm A*
+ * z punktami orientacyjnymi (zob. @ref setLandmarksCountMap) używany jest we
+ * wszystkich wyszukiwaniach. Hierarchia kontrakcji używana jest przy
+ * tworzeniu nowych dróg krajowych; jest budowana leniwie i unieważniana przez
+ * każdą zmianę odcinków dróg, a objazdy i przedłużenia dróg krajowych
+ * wyznaczane są wtedy algorytmem dijkstry.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] engine     – algorytm wyszukiwania.
+ * @return Wartość @p true lub @p false, jeśli mapa ma wartość NULL.
+ */
+bool setSearchEngineMap(Map *map, SearchEngine engine);
+
+/** @brief Ustawia liczbę punktów orientacyjnych algorytmu A*.
+ * Punkty orientacyjne używane są przez algorytm @ref ALT_SEARCH_ENGINE.
+ * Brakujące punkty (ponad wybrane funkcją @ref addLandmarkMap) wybierane są
+ * automatycznie. Indeks punktów budowany jest leniwie przy pierwszym
+ * wyszukiwaniu i przebudowywany po zmianach odcinków dróg.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] landmarksCount – liczba punktów orientacyjnych.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool setLandmarksCountMap(Map *map, uint32_t landmarksCount);
+
+/** @brief Wybiera miasto jako punkt orientacyjny algorytmu A*.
+ * Miasto nie musi jeszcze istnieć na mapie.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName   – wskaźnik na napis reprezentujący nazwę miasta.
+ * @return Wartość @p true lub @p false, jeśli nazwa miasta jest niepoprawna
+ * lub nie udało się zaalokować pamięci.
+ */
+bool addLandmarkMap(Map *map, const char *cityName);
+
+/** @brief Zwraca liczniki wyszukiwań dróg krajowych.
+ * Sumuje liczniki ze wszystkich stanów algorytmu mapy.
+ * @param[in] map        – wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Sumaryczne liczniki wyszukiwań.
+ */
+SearchStatistics getSearchStatisticsMap(Map *map);
+
+/** @brief Ustawia pamięć podręczną drzew najkrótszych dróg.
+ * Tworzy pamięć podręczną o podanym limicie, wspólną dla stanów algorytmu
+ * mapy i wątków puli, i usuwa poprzednią. Drzewa pełnych przejść algorytmu
+ * dijkstry (zob. @ref SearchCache) zapamiętywane są dla wersji mapy
+ * @ref Map.graphVersion, którą zwiększają funkcje zmieniające odcinki dróg,
+ * więc kolejne wyszukiwania z tego samego miasta na niezmienionej mapie nie
+ * uruchamiają algorytmu. Wyszukiwania dwukierunkowe, w hierarchii kontrakcji
+ * i algorytmem A* nie liczą pełnych drzew i nie korzystają z pamięci
+ * podręcznej.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] budget     – limit pamięci drzew w bajtach lub @p 0, aby
+ *                         wyłączyć pamięć podręczną.
+ * @return Wartość @p true lub @p false, jeśli mapa ma wartość NULL lub nie
+ * udało się zaalokować pamięci (pamięć podręczna jest wtedy wyłączona).
+ */
+bool setSearchCacheMap(Map *map, size_t budget);
+
+/** @brief Zwraca liczniki pamięci podręcznej drzew najkrótszych dróg.
+ * @param[in] map        – wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Liczniki pamięci podręcznej lub same zera, jeśli jest wyłączona.
+ */
+SearchCacheStatistics getSearchCacheStatisticsMap(Map *map);
+
+/** @brief Włącza lub wyłącza indeks objazdów drogi krajowej.
+ * Droga krajowa o podanym numerze (także utworzona później) dostaje indeks
+ * objazdów każdego swojego odcinka (zob. @ref ReplacementPaths), z którego
+ * @ref removeRoad i @ref checkRemoveRoad odczytują objazd zamiast go
+ * wyszukiwać. Funkcje modyfikujące mapę tylko oznaczają jako nieaktualne
+ * objazdy, na które zmiana mogła wpłynąć. Nieaktualny objazd wyznaczany jest
+ * ponownie dopiero przy pierwszym odczycie i zapamiętywany, więc kolejne
+ * odczyty do następnej zmiany, która mogła na niego wpłynąć, nie wyszukują.
+ * @param[in,out] map       – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] routeId       – numer drogi krajowej;
+ * @param[in] isEnabled     – czy włączyć indeks.
+ * @return Wartość @p true lub @p false, jeśli mapa ma wartość NULL, numer
+ * jest niepoprawny lub nie udało się zaalokować pamięci.
+ */
+bool setReplacementPathsMap(Map *map, unsigned routeId, bool isEnabled);
+
+/** @brief Zwraca liczniki indeksów objazdów dróg krajowych.
+ * @param[in] map        – wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Suma liczników indeksów istniejących dróg krajowych.
+ */
+ReplacementPathsStatistics getReplacementPathsStatisticsMap(Map *map);
+
+/** @brief Szacuje pamięć zajmowaną przez mapę.
+ * Liczy bajty struktur mapy: miast z nazwami, odcinków dróg, dróg krajowych,
+ * haszmapy miast, stanów algorytmu wyszukiwania, indeksów (punktów
+ * orientacyjnych, hierarchii kontrakcji, wyrocznii spójności, objazdów dróg
+ * krajowych) i odwzorowanego obrazu. Nie liczy narzutu alokatora, dziennika
+ * ani opisów dla współbieżnych odczytów.
+ * @param[in] map        – wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Liczba bajtów.
+ */
+size_t memoryUsageMap(Map *map);
+
 /** @brief Dodaje do mapy odcinek drogi między dwoma różnymi miastami.
  * Jeśli któreś z podanych miast nie istnieje, to dodaje go do mapy, a następnie
  * dodaje do mapy odcinek drogi między tymi miastami.
@@ -91,6 +398,27 @@ bool repairRoad(Map *map, const char *cityName1, const char *cityName2,
 bool newRoute(Map *map, unsigned routeId,
               const char *cityName1, const char *cityName2);
 
+/** @brief Łączy miasto drogami krajowymi z wieloma miastami.
+ * Tworzy drogi krajowe numer @p routeIds[i] z miasta @p cityName do miast
+ * @p cityNames[i] w kolejności tablicy, tak jak kolejne wywołania funkcji
+ * @ref newRoute, z tymi samymi wynikami. Najlepsze drogi ze wspólnego miasta
+ * wyznacza jedno wyszukiwanie, a ich jednoznaczność jedno przejście dla
+ * każdego różnego najstarszego odcinka wyznaczonych dróg.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName   – wskaźnik na napis reprezentujący nazwę miasta
+ *                         startowego;
+ * @param[in] routeIds   – wskaźnik na tablicę numerów dróg krajowych;
+ * @param[in] cityNames  – wskaźnik na tablicę napisów reprezentujących nazwy
+ *                         miast docelowych;
+ * @param[in] count      – liczba tworzonych dróg krajowych;
+ * @param[out] results   – wskaźnik na tablicę, w której @p results[i] ma
+ *                         wartość @p true, jeśli utworzono drogę krajową
+ *                         numer @p routeIds[i], lub NULL.
+ * @return Liczba utworzonych dróg krajowych.
+ */
+size_t newRoutes(Map *map, const char *cityName, const unsigned *routeIds,
+                 const char *const *cityNames, size_t count, bool *results);
+
 /** @brief Wydłuża drogę krajową do podanego miasta.
  * Dodaje do drogi krajowej nowe odcinki dróg do podanego miasta w taki sposób,
  * aby nowy fragment drogi krajowej był najkrótszy. Jeśli jest więcej niż jeden
@@ -129,6 +457,57 @@ bool extendRoute(Map *map, unsigned routeId, const char *cityName);
  */
 bool removeRoad(Map *map, const char *cityName1, const char *cityName2);
 
+/** @brief Usuwa wiele odcinków dróg naraz.
+ * Oznacza wszystkie odcinki jako usuwane i dopiero wtedy wyznacza objazdy
+ * (jak w @ref removeRoad) dla każdej drogi krajowej przechodzącej przez
+ * któryś z nich, więc objazdy nie prowadzą przez inne usuwane odcinki.
+ * Objazdy różnych dróg krajowych szukane są równolegle w puli wątków mapy
+ * i korzystają ze wspólnej pamięci podręcznej drzew najkrótszych dróg.
+ * Jeśli którejś drogi krajowej nie da się jednoznacznie poprawić, to żaden
+ * odcinek nie jest usuwany.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityNames  – wskaźnik na tablicę @p 2 * @p count napisów
+ *                         reprezentujących nazwy miast; odcinek numer @p i
+ *                         łączy miasta @p cityNames[2 * i]
+ *                         i @p cityNames[2 * i + 1];
+ * @param[in] count      – liczba odcinków.
+ * @return Wartość @p true, jeśli wszystkie odcinki dróg zostały usunięte.
+ * Wartość @p false, jeśli nie usunięto żadnego odcinka: @p count jest równe
+ * @p 0, któryś z parametrów ma niepoprawną wartość, nie ma któregoś
+ * z podanych miast lub odcinków dróg, odcinek występuje więcej niż raz, nie da
+ * się jednoznacznie uzupełnić przerwanego ciągu drogi krajowej lub nie udało
+ * się zaalokować pamięci.
+ */
+bool removeRoads(Map *map, const char *const *cityNames, size_t count);
+
+/** @brief Sprawdza, czy można usunąć odcinek drogi, bez jego usuwania.
+ * Dla każdej drogi krajowej przechodzącej przez odcinek między podanymi
+ * miastami wyznacza objazd, który wstawiłaby funkcja @ref removeRoad, i jego
+ * długość. Nie oznacza odcinka jako usuwanego i nie zmienia dróg krajowych
+ * ani wersji mapy, więc opisy dróg krajowych czytane współbieżnie
+ * (@ref readRouteDescriptionMap) i pamięć podręczna drzew pozostają
+ * aktualne. Objazdy różnych dróg krajowych szukane są równolegle w puli
+ * wątków mapy. Objazd @p i-tej (w kolejności dróg na mapie) drogi krajowej
+ * przechodzącej przez odcinek zapisywany jest w @p detours[i], jeśli
+ * @p i < @p detoursSize.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName1  – wskaźnik na napis reprezentujący nazwę miasta;
+ * @param[in] cityName2  – wskaźnik na napis reprezentujący nazwę miasta;
+ * @param[out] isFeasible – wskaźnik na wynik: czy funkcja @ref removeRoad
+ *                         usunęłaby odcinek;
+ * @param[out] detours   – wskaźnik na tablicę objazdów lub NULL;
+ * @param[in] detoursSize – rozmiar tablicy @p detours;
+ * @param[out] detoursCount – wskaźnik na liczbę dróg krajowych przechodzących
+ *                         przez odcinek lub NULL.
+ * @return Wartość @p true, jeśli sprawdzono odcinek. Wartość @p false, jeśli
+ * wystąpił błąd: któryś z parametrów ma niepoprawną wartość, nie ma któregoś
+ * z podanych miast, nie istnieje droga między podanymi miastami lub nie udało
+ * się zaalokować pamięci.
+ */
+bool checkRemoveRoad(Map *map, const char *cityName1, const char *cityName2,
+                     bool *isFeasible, RouteDetour *detours,
+                     size_t detoursSize, size_t *detoursCount);
+
 /** @brief Udostępnia informacje o drodze krajowej.
  * Zwraca wskaźnik na napis, który zawiera informacje o drodze krajowej. Alokuje
  * pamięć na ten napis. Zwraca pusty napis, jeśli nie istnieje droga krajowa
@@ -174,4 +553,195 @@ bool updateRoad(Map *map, const char *cityName1, const char *cityName2,
  */
 bool removeRoute(Map *map, unsigned routeId);
 
+/** @brief Dodaje do mapy wiele odcinków dróg.
+ * Dla kolejnych elementów tablicy wywołuje funkcję @ref addRoad. Niepowodzenie
+ * dodania jednego odcinka nie przerywa dodawania kolejnych.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] roads      – wskaźnik na tablicę dodawanych odcinków dróg;
+ * @param[in] count      – liczba elementów tablicy @p roads;
+ * @param[out] results   – wskaźnik na tablicę @p count wyników funkcji
+ *                         @ref addRoad lub NULL.
+ * @return Liczba dodanych odcinków dróg.
+ */
+size_t addRoads(Map *map, const RoadTuple *roads, size_t count, bool *results);
+
+/** @brief Zapisuje informacje o drodze krajowej w buforze.
+ * Zapisuje w buforze napis w formacie @ref getRouteDescription (pusty, jeśli
+ * nie istnieje droga krajowa o podanym numerze), obcięty do rozmiaru bufora
+ * i zakończony zerem. Nie alokuje pamięci. Jeśli wynik nie jest mniejszy niż
+ * @p bufferSize, to napis nie zmieścił się w buforze.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] routeId    – numer drogi krajowej;
+ * @param[out] buffer    – wskaźnik na bufor lub NULL;
+ * @param[in] bufferSize – rozmiar bufora (@p 0 dla NULL).
+ * @return Długość całego napisu (bez zera na końcu), także jeśli nie
+ * zmieścił się w buforze.
+ */
+size_t writeRouteDescription(Map *map, unsigned routeId,
+                             char *buffer, size_t bufferSize);
+
+/** @brief Zapisuje informacje o wielu drogach krajowych w buforze.
+ * Zapisuje w buforze kolejno napisy funkcji @ref writeRouteDescription, każdy
+ * zakończony zerem. Napis numer @p i zaczyna się na pozycji @p offsets[i].
+ * Napisy, które nie zmieściły się w buforze, są obcinane lub pomijane.
+ * Wszystkie napisy zmieściły się w buforze wtedy i tylko wtedy, gdy wynik nie
+ * jest większy niż @p bufferSize.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] routeIds   – wskaźnik na tablicę numerów dróg krajowych;
+ * @param[in] count      – liczba elementów tablicy @p routeIds;
+ * @param[out] buffer    – wskaźnik na bufor lub NULL;
+ * @param[in] bufferSize – rozmiar bufora (@p 0 dla NULL);
+ * @param[out] offsets   – wskaźnik na tablicę @p count pozycji napisów lub
+ *                         NULL.
+ * @return Rozmiar bufora potrzebny na wszystkie napisy (z zerami na końcu).
+ */
+size_t writeRouteDescriptions(Map *map, const unsigned *routeIds, size_t count,
+                              char *buffer, size_t bufferSize,
+                              size_t *offsets);
+
+/** @brief Wyznacza drogę krajową bez jej tworzenia.
+ * Wyznacza drogę krajową, którą między podanymi miastami utworzyłaby
+ * funkcja @ref newRoute, ale nie tworzy jej i nie zmienia dróg krajowych
+ * mapy. Alokuje pamięć na napis, który trzeba zwolnić za pomocą funkcji
+ * free. Napis ma format @ref getRouteDescription, w którym zamiast numeru
+ * drogi krajowej jest jej długość:
+ * długość drogi;nazwa miasta;długość odcinka drogi;rok budowy lub
+ * ostatniego remontu;nazwa miasta;…;nazwa miasta.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName1  – wskaźnik na napis reprezentujący nazwę miasta;
+ * @param[in] cityName2  – wskaźnik na napis reprezentujący nazwę miasta;
+ * @param[out] length    – wskaźnik na długość wyznaczonej drogi lub NULL.
+ * @return Wskaźnik na napis lub NULL, jeśli wystąpił błąd: któryś
+ * z parametrów ma niepoprawną wartość, któreś z podanych miast nie istnieje,
+ * obie podane nazwy miast są identyczne, nie można jednoznacznie wyznaczyć
+ * drogi krajowej między podanymi miastami lub nie udało się zaalokować
+ * pamięci.
+ */
+char const *queryRoute(Map *map, const char *cityName1, const char *cityName2,
+                       uint64_t *length);
+
+/** @brief Wyznacza wiele dróg krajowych bez ich tworzenia.
+ * Dla kolejnych zapytań wywołuje funkcję @ref queryRoute. Jeśli mapa ma pulę
+ * wątków (@ref setThreadsCountMap), to drogi wyznaczane są równolegle, każda
+ * w stanie algorytmu swojego wątku. Wyniki nie zależą od liczby wątków.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in,out] queries – wskaźnik na tablicę zapytań;
+ * @param[in] count      – liczba elementów tablicy @p queries.
+ * @return Liczba zapytań, dla których wyznaczono drogę.
+ */
+size_t queryRoutes(Map *map, RouteQuery *queries, size_t count);
+
+/** @brief Liczy macierz odległości między dwoma zbiorami miast.
+ * Dla każdego miasta źródłowego i każdego miasta docelowego wyznacza długość
+ * drogi, którą wybrałaby funkcja @ref newRoute, i rok budowy lub ostatniego
+ * remontu jej najdawniej wybudowanego odcinka, nie zmieniając mapy. Wynik
+ * dla miasta @p sources[i] i miasta @p targets[j] zapisuje
+ * w @p matrix[i * targetsCount + j]. W przeciwieństwie do funkcji
+ * @ref newRoute nie wymaga jednoznaczności drogi, a miasta mogą się
+ * powtarzać. Jeśli miasta nie łączy żadna droga, to długość wyniku wynosi
+ * @p -1. Droga z miasta do niego samego ma długość @p 0 i rok @p 0.
+ * Wyszukiwania są wspólne dla wielu par i wykonywane w puli wątków mapy
+ * (@ref setThreadsCountMap), jeśli mapa ją ma.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] sources    – wskaźnik na tablicę nazw miast źródłowych;
+ * @param[in] sourcesCount – liczba miast źródłowych;
+ * @param[in] targets    – wskaźnik na tablicę nazw miast docelowych;
+ * @param[in] targetsCount – liczba miast docelowych;
+ * @param[out] matrix    – wskaźnik na tablicę
+ *                         @p sourcesCount * @p targetsCount wyników.
+ * @return Wartość @p true lub @p false, jeśli wystąpił błąd: któryś
+ * z parametrów ma niepoprawną wartość, któreś z podanych miast nie istnieje,
+ * któryś ze zbiorów jest pusty lub nie udało się zaalokować pamięci.
+ */
+bool distanceMatrix(Map *map, const char *const *sources, size_t sourcesCount,
+                    const char *const *targets, size_t targetsCount,
+                    RouteDistance *matrix);
+
+/** @brief Włącza lub wyłącza współbieżne odczyty opisów dróg krajowych.
+ * Po włączeniu każda funkcja modyfikująca mapę publikuje nowe opisy
+ * zmienionych dróg krajowych, które wątki zarejestrowane funkcją
+ * @ref newReaderMap czytają funkcją @ref readRouteDescriptionMap równolegle
+ * z modyfikacjami (zob. @ref RouteSnapshots). Modyfikacje nadal wykonuje
+ * jeden wątek. Przy wyłączaniu żaden wątek czytający nie może być
+ * zarejestrowany.
+ * @param[in,out] map       – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] isEnabled     – czy włączyć współbieżne odczyty.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool setConcurrentReadsMap(Map *map, bool isEnabled);
+
+/** @brief Rejestruje wątek czytający opisy dróg krajowych.
+ * Wymaga włączonych współbieżnych odczytów (@ref setConcurrentReadsMap).
+ * @param[in,out] map       – wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Numer wątku czytającego lub @p -1, jeśli zarejestrowano już
+ * @ref ROUTE_SNAPSHOTS_MAX_READERS wątków.
+ */
+int32_t newReaderMap(Map *map);
+
+/** @brief Wyrejestrowuje wątek czytający opisy dróg krajowych.
+ * @param[in,out] map       – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] reader        – numer wątku czytającego.
+ */
+void deleteReaderMap(Map *map, int32_t reader);
+
+/** @brief Zapisuje opis drogi krajowej w buforze bez blokowania mapy.
+ * Działa jak @ref writeRouteDescription, ale czyta ostatni opublikowany opis,
+ * więc może być wywoływana przez wiele wątków równolegle z funkcjami
+ * modyfikującymi mapę. Wynik uwzględnia wszystkie modyfikacje zakończone przed
+ * wywołaniem.
+ * @param[in,out] map       – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] reader        – numer wątku czytającego;
+ * @param[in] routeId       – numer drogi krajowej;
+ * @param[out] buffer       – wskaźnik na bufor lub NULL;
+ * @param[in] bufferSize    – rozmiar bufora (@p 0 dla NULL).
+ * @return Długość całego napisu (bez zera na końcu), także jeśli nie
+ * zmieścił się w buforze.
+ */
+size_t readRouteDescriptionMap(Map *map, int32_t reader, unsigned routeId,
+                               char *buffer, size_t bufferSize);
+
+/** @brief Wykonuje polecenie na mapie.
+ * Wywołuje funkcję mapy odpowiadającą rodzajowi polecenia, korzystając
+ * z policzonych wcześniej haszy nazw miast. Polecenie
+ * @ref COMMAND_GET_ROUTE_DESCRIPTION i zapytania (@ref isQueryCommandMap) nie
+ * zmieniają mapy, więc ich wyniki (funkcje @ref getRouteDescription,
+ * @ref writeRouteDescription i @ref queryCommandMap) wypisuje wywołujący.
+ * Polecenie @ref COMMAND_NEW_ROUTES kończy się sukcesem, jeśli utworzono
+ * wszystkie jego drogi krajowe.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] command    – wskaźnik na polecenie.
+ * @return Wynik odpowiedniej funkcji mapy lub @p false dla polecenia
+ * @ref COMMAND_GET_ROUTE_DESCRIPTION i zapytań.
+ */
+bool executeCommandMap(Map *map, const Command *command);
+
+/** @brief Sprawdza, czy polecenie jest zapytaniem.
+ * Zapytania (@ref COMMAND_QUERY_ROUTE, @ref COMMAND_DISTANCE_MATRIX
+ * i @ref COMMAND_CHECK_REMOVE_ROAD) nie zmieniają mapy, a ich wyniki zwraca
+ * funkcja @ref queryCommandMap.
+ * @param[in] command    – wskaźnik na polecenie.
+ * @return Wartość @p true, jeśli polecenie jest zapytaniem lub @p false
+ * w przeciwnym przypadku.
+ */
+bool isQueryCommandMap(const Command *command);
+
+/** @brief Wykonuje zapytanie.
+ * Dla polecenia @ref COMMAND_QUERY_ROUTE wywołuje funkcję @ref queryRoute,
+ * dla polecenia @ref COMMAND_DISTANCE_MATRIX funkcję @ref distanceMatrix,
+ * a dla polecenia @ref COMMAND_CHECK_REMOVE_ROAD funkcję
+ * @ref checkRemoveRoad, korzystając z policzonych wcześniej haszy nazw
+ * miast. Alokuje pamięć na napis, który trzeba zwolnić za pomocą funkcji
+ * free. Wynikiem macierzy odległości jest po jednym wierszu na miasto
+ * źródłowe, w którym dla kolejnych miast docelowych występuje długość drogi
+ * i rok jej najdawniej wybudowanego odcinka lub znak '-', jeśli drogi lub
+ * odcinka nie ma. Wynikiem sprawdzenia usunięcia odcinka jest @p 1 lub
+ * @p 0 (czy można go usunąć), a po nim numery dróg krajowych przechodzących
+ * przez odcinek i długości ich objazdów lub znak '-'.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] command    – wskaźnik na zapytanie.
+ * @return Wskaźnik na napis lub NULL, jeśli wystąpił błąd.
+ */
+char const *queryCommandMap(Map *map, const Command *command);
+
 #endif /* __MAP_H__ */
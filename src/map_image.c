@@ -0,0 +1,537 @@
+/** @file
+ * Implementacja interfejsu klasy przechowującej obraz mapy dróg krajowych
+ * odwzorowany w pamięci.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "map_image.h"
+#include "map.h"
+#include "snapshot.h"
+#include "city.h"
+#include "road.h"
+#include "route.h"
+#include "string_builder.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/** @brief Wyrównuje przesunięcie do 8 bajtów.
+ * @param[in] offset            - przesunięcie.
+ * @return Najmniejsza wielokrotność liczby 8 nie mniejsza niż @p offset.
+ */
+uint64_t alignMapImage(uint64_t offset) {
+    return (offset + 7) & ~(uint64_t)7;
+}
+
+/** @brief Wyznacza rozmiary i przesunięcia sekcji obrazu.
+ * Pola z liczbami rekordów i rozmiarem sekcji nazw muszą być ustawione.
+ * @param[in,out] header        - wskaźnik na nagłówek obrazu.
+ */
+void layoutMapImage(MapImageHeader *header) {
+    header->citiesOffset = sizeof(MapImageHeader);
+    header->edgesOffset = alignMapImage(
+            header->citiesOffset +
+            ((uint64_t)header->citiesCount + 1) * sizeof(MapImageCity));
+    header->routesOffset = alignMapImage(
+            header->edgesOffset +
+            (uint64_t)header->edgesCount * sizeof(MapImageEdge));
+    header->routesIndexOffset = alignMapImage(
+            header->routesOffset +
+            (uint64_t)header->routesCount * sizeof(MapImageRoute));
+    header->routeStepsOffset = alignMapImage(
+            header->routesIndexOffset +
+            MAP_IMAGE_ROUTES_INDEX_SIZE * sizeof(uint32_t));
+    header->namesOffset = alignMapImage(
+            header->routeStepsOffset +
+            (uint64_t)header->routeStepsCount * sizeof(MapImageRouteStep));
+    header->fileSize = header->namesOffset + header->namesSize;
+}
+
+/** @brief Zapisuje obraz mapy do pliku.
+ * @param[in] map               - wskaźnik na mapę (bez obrazu);
+ * @param[in,out] file          - wskaźnik na plik otwarty do zapisu.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać pliku lub
+ * zaalokować pamięci.
+ */
+bool writeMapImage(Map *map, FILE *file) {
+    assert(map);
+    assert(map->image == NULL);
+    assert(file);
+
+    MapImageHeader header;
+    memset(&header, 0, sizeof(MapImageHeader));
+    header.magic = MAP_IMAGE_MAGIC;
+    header.version = MAP_IMAGE_VERSION;
+    header.citiesCount = countCitiesOnList(map->cities);
+
+    City **cities = malloc(sizeof(City *) * (header.citiesCount + 1));
+    if (cities == NULL) {
+        return false;
+    }
+
+    ListIterator *iterator = map->cities->begin;
+    while (iterator != map->cities->end) {
+        City *city = iterator->data;
+        cities[city->id] = city;
+        header.edgesCount += sizeList(city->roads);
+        header.namesSize += strlen(city->name) + 1;
+        iterator = iterator->next;
+    }
+
+    iterator = map->routes->begin;
+    while (iterator != map->routes->end) {
+        header.routesCount++;
+        header.routeStepsCount += sizeList(((Route *)iterator->data)->cities);
+        iterator = iterator->next;
+    }
+
+    layoutMapImage(&header);
+    char *data = NULL;
+    if (header.namesSize < UINT32_MAX) {
+        data = calloc(header.fileSize, 1);
+    }
+    if (data == NULL) {
+        free(cities);
+        return false;
+    }
+
+    MapImageCity *imageCities = (MapImageCity *)(data + header.citiesOffset);
+    MapImageEdge *edges = (MapImageEdge *)(data + header.edgesOffset);
+    uint32_t nameOffset = 0, edge = 0;
+    for (uint32_t i = 0; i < header.citiesCount; i++) {
+        size_t size = strlen(cities[i]->name) + 1;
+        memcpy(data + header.namesOffset + nameOffset, cities[i]->name, size);
+        imageCities[i].nameOffset = nameOffset;
+        imageCities[i].firstEdge = edge;
+        nameOffset += size;
+
+        iterator = cities[i]->roads->begin;
+        while (iterator != cities[i]->roads->end) {
+            Road *road = iterator->data;
+            edges[edge].destination = road->destination->id;
+            edges[edge].length = road->length;
+            edges[edge].year = road->buildYearOrLastRepairYear;
+            edge++;
+            iterator = iterator->next;
+        }
+    }
+    imageCities[header.citiesCount].nameOffset = nameOffset;
+    imageCities[header.citiesCount].firstEdge = edge;
+
+    MapImageRoute *routes = (MapImageRoute *)(data + header.routesOffset);
+    uint32_t *routesIndex = (uint32_t *)(data + header.routesIndexOffset);
+    MapImageRouteStep *steps =
+            (MapImageRouteStep *)(data + header.routeStepsOffset);
+    for (uint32_t i = 0; i < MAP_IMAGE_ROUTES_INDEX_SIZE; i++) {
+        routesIndex[i] = MAP_IMAGE_NO_ROUTE;
+    }
+
+    uint32_t routeIndex = 0, step = 0;
+    iterator = map->routes->begin;
+    while (iterator != map->routes->end) {
+        Route *route = iterator->data;
+        routes[routeIndex].routeId = route->routeId;
+        routes[routeIndex].firstStep = step;
+        routes[routeIndex].stepsCount = sizeList(route->cities);
+        routesIndex[route->routeId] = routeIndex++;
+
+        ListIterator *cityIterator = route->cities->begin;
+        while (cityIterator != route->cities->end) {
+            steps[step].city = ((City *)cityIterator->data)->id;
+            if (cityIterator != route->cities->begin) {
+                Road *road = findRoadModule(cityIterator->previous->data,
+                                            cityIterator->data)->data;
+                steps[step].length = road->length;
+                steps[step].year = road->buildYearOrLastRepairYear;
+            }
+            step++;
+            cityIterator = cityIterator->next;
+        }
+
+        iterator = iterator->next;
+    }
+
+    header.checksum = checksumSnapshot(SNAPSHOT_CHECKSUM_SEED,
+                                       data + sizeof(MapImageHeader),
+                                       header.fileSize -
+                                       sizeof(MapImageHeader));
+    memcpy(data, &header, sizeof(MapImageHeader));
+
+    bool result = fwrite(data, 1, header.fileSize, file) == header.fileSize &&
+                  fflush(file) == 0;
+
+    free(data);
+    free(cities);
+
+    return result;
+}
+
+/** @brief Sprawdza nagłówek obrazu mapy.
+ * @param[in] header            - wskaźnik na nagłówek;
+ * @param[in] size              - rozmiar pliku.
+ * @return Wartość @p true, jeśli nagłówek jest poprawny i wszystkie sekcje
+ * mieszczą się w pliku. Wartość @p false w przeciwnym przypadku.
+ */
+bool checkHeaderMapImage(const MapImageHeader *header, size_t size) {
+    if (header->magic != MAP_IMAGE_MAGIC ||
+            header->version != MAP_IMAGE_VERSION ||
+            header->fileSize != size || header->citiesCount == UINT32_MAX ||
+            header->namesSize >= UINT32_MAX) {
+        return false;
+    }
+
+    /* Układ sekcji jest wyznaczony przez liczby rekordów. */
+    MapImageHeader layout = *header;
+    layoutMapImage(&layout);
+
+    return layout.citiesOffset == header->citiesOffset &&
+           layout.edgesOffset == header->edgesOffset &&
+           layout.routesOffset == header->routesOffset &&
+           layout.routesIndexOffset == header->routesIndexOffset &&
+           layout.routeStepsOffset == header->routeStepsOffset &&
+           layout.namesOffset == header->namesOffset &&
+           layout.fileSize == header->fileSize;
+}
+
+/** @brief Odwzorowuje obraz mapy w pamięci.
+ * Sprawdza tylko nagłówek i granice sekcji, więc nie odczytuje całego
+ * pliku. Strony obrazu są współdzielone przez procesy odwzorowujące ten sam
+ * plik.
+ * @param[in] path              - wskaźnik na ścieżkę do pliku.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, jeśli plik nie jest
+ * poprawnym obrazem mapy lub nie udało się go odwzorować.
+ */
+MapImage *openMapImage(const char *path) {
+    assert(path);
+
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        return NULL;
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) == -1 ||
+            (size_t)status.st_size < sizeof(MapImageHeader)) {
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = status.st_size;
+    void *data = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return NULL;
+    }
+
+    const MapImageHeader *header = data;
+    const char *bytes = data;
+    if (!checkHeaderMapImage(header, size) ||
+            (header->namesSize != 0 &&
+             bytes[header->namesOffset + header->namesSize - 1] != 0)) {
+        munmap(data, size);
+        return NULL;
+    }
+
+    MapImage *result = malloc(sizeof(MapImage));
+    if (result == NULL) {
+        munmap(data, size);
+        return NULL;
+    }
+
+    result->data = data;
+    result->size = size;
+    result->header = header;
+    result->cities = (const MapImageCity *)(bytes + header->citiesOffset);
+    result->edges = (const MapImageEdge *)(bytes + header->edgesOffset);
+    result->routes = (const MapImageRoute *)(bytes + header->routesOffset);
+    result->routesIndex =
+            (const uint32_t *)(bytes + header->routesIndexOffset);
+    result->routeSteps =
+            (const MapImageRouteStep *)(bytes + header->routeStepsOffset);
+    result->names = bytes + header->namesOffset;
+
+    return result;
+}
+
+/** @brief Usuwa strukturę i odwzorowanie.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] image             - wskaźnik na usuwaną strukturę.
+ */
+void closeMapImage(MapImage *image) {
+    if (image == NULL) {
+        return;
+    }
+
+    munmap(image->data, image->size);
+    free(image);
+}
+
+/** @brief Znajduje nazwę miasta w obrazie.
+ * @param[in] image             - wskaźnik na obraz;
+ * @param[in] city              - numer miasta.
+ * @return Wskaźnik na nazwę miasta lub NULL, jeśli numer miasta lub
+ * przesunięcie nazwy jest niepoprawne.
+ */
+const char *cityNameMapImage(const MapImage *image, uint32_t city) {
+    if (city >= image->header->citiesCount ||
+            image->cities[city].nameOffset >= image->header->namesSize) {
+        return NULL;
+    }
+
+    return image->names + image->cities[city].nameOffset;
+}
+
+/** @brief Znajduje drogę krajową w obrazie.
+ * @param[in] image             - wskaźnik na obraz;
+ * @param[in] routeId           - numer drogi krajowej.
+ * @return Wskaźnik na rekord drogi krajowej lub NULL, jeśli nie ma drogi
+ * o podanym numerze lub rekord jest niepoprawny.
+ */
+const MapImageRoute *findRouteMapImage(const MapImage *image,
+                                       unsigned routeId) {
+    if (routeId >= MAP_IMAGE_ROUTES_INDEX_SIZE) {
+        return NULL;
+    }
+
+    uint32_t index = image->routesIndex[routeId];
+    if (index >= image->header->routesCount) {
+        return NULL;
+    }
+
+    const MapImageRoute *route = &image->routes[index];
+    if (route->routeId != routeId || route->stepsCount == 0 ||
+            (uint64_t)route->firstStep + route->stepsCount >
+            image->header->routeStepsCount) {
+        return NULL;
+    }
+
+    return route;
+}
+
+/** @brief Zapisuje informacje o drodze krajowej z obrazu w buforze.
+ * Działa jak @ref writeRouteDescription.
+ * @param[in] image             - wskaźnik na obraz;
+ * @param[in] routeId           - numer drogi krajowej;
+ * @param[out] buffer           - wskaźnik na bufor lub NULL;
+ * @param[in] bufferSize        - rozmiar bufora (@p 0 dla NULL).
+ * @return Długość całego napisu (bez zera na końcu), także jeśli nie
+ * zmieścił się w buforze.
+ */
+size_t writeDescriptionMapImage(const MapImage *image, unsigned routeId,
+                                char *buffer, size_t bufferSize) {
+    assert(image);
+
+    StringWriter writer;
+    initStringWriter(&writer, buffer, bufferSize);
+
+    const MapImageRoute *route = findRouteMapImage(image, routeId);
+    if (route == NULL) {
+        /* Nie ma drogi krajowej o podanym numerze. */
+        return finishStringWriter(&writer);
+    }
+
+    for (uint32_t i = 0; i < route->stepsCount; i++) {
+        if (cityNameMapImage(image,
+                             image->routeSteps[route->firstStep + i].city)
+                == NULL) {
+            return finishStringWriter(&writer);
+        }
+    }
+
+    appendStringWriterInteger(&writer, routeId);
+    for (uint32_t i = 0; i < route->stepsCount; i++) {
+        const MapImageRouteStep *step =
+                &image->routeSteps[route->firstStep + i];
+
+        if (i != 0) {
+            appendStringWriterInteger(&writer, step->length);
+            appendStringWriterInteger(&writer, step->year);
+        }
+        appendStringWriterString(&writer, cityNameMapImage(image, step->city));
+    }
+
+    return finishStringWriter(&writer);
+}
+
+/** @brief Udostępnia informacje o drodze krajowej z obrazu.
+ * Działa jak @ref getRouteDescription.
+ * @param[in] image             - wskaźnik na obraz;
+ * @param[in] routeId           - numer drogi krajowej.
+ * @return Wskaźnik na napis lub NULL, gdy nie udało się zaalokować pamięci.
+ */
+char *descriptionMapImage(const MapImage *image, unsigned routeId) {
+    assert(image);
+
+    size_t size = writeDescriptionMapImage(image, routeId, NULL, 0);
+    char *result = malloc((size + 1) * sizeof(char));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    writeDescriptionMapImage(image, routeId, result, size + 1);
+
+    return result;
+}
+
+/** @brief Tworzy miasta i odcinki dróg mapy z obrazu.
+ * @param[in] image             - wskaźnik na obraz;
+ * @param[in,out] map           - wskaźnik na pustą mapę;
+ * @param[out] cities           - tablica na miasta indeksowana numerami.
+ * @return Wartość @p true lub @p false, jeśli obraz jest niepoprawny lub nie
+ * udało się zaalokować pamięci.
+ */
+bool addCitiesAndRoadsMapImage(const MapImage *image, Map *map,
+                               City **cities) {
+    const MapImageHeader *header = image->header;
+
+    for (uint32_t i = 0; i < header->citiesCount; i++) {
+        const char *name = cityNameMapImage(image, i);
+        if (name == NULL || !isStringValidCityName(name)) {
+            return false;
+        }
+
+        /* Powtórzona nazwa dałaby miasto o innym numerze. */
+        cities[i] = findCityOnHashMapInsertIfNecessary(map->citiesMap,
+                                                       map->cities, name);
+        if (cities[i] == NULL || cities[i]->id != i) {
+            return false;
+        }
+    }
+
+    if (image->cities[header->citiesCount].firstEdge != header->edgesCount) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < header->citiesCount; i++) {
+        uint32_t first = image->cities[i].firstEdge;
+        uint32_t last = image->cities[i + 1].firstEdge;
+        if (first > last || last > header->edgesCount) {
+            return false;
+        }
+
+        /* Każdy odcinek zapisany jest w obu kierunkach. */
+        for (uint32_t j = first; j < last; j++) {
+            const MapImageEdge *edge = &image->edges[j];
+            if (edge->destination >= header->citiesCount ||
+                    edge->destination == i || edge->length == 0 ||
+                    edge->year == 0) {
+                return false;
+            }
+
+            if (i < edge->destination) {
+                City *destination = cities[edge->destination];
+                if (findRoadModule(cities[i], destination) != NULL ||
+                        !addRoadModule(cities[i], destination, edge->length,
+                                       edge->year)) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+/** @brief Tworzy drogi krajowe mapy z obrazu.
+ * @param[in] image             - wskaźnik na obraz;
+ * @param[in,out] map           - wskaźnik na mapę z miastami i odcinkami;
+ * @param[in] cities            - tablica miast indeksowana numerami.
+ * @return Wartość @p true lub @p false, jeśli obraz jest niepoprawny lub nie
+ * udało się zaalokować pamięci.
+ */
+bool addRoutesMapImage(const MapImage *image, Map *map, City **cities) {
+    const MapImageHeader *header = image->header;
+
+    /* Numer ostatniej drogi krajowej przechodzącej przez miasto. */
+    uint32_t *lastRoute = calloc(header->citiesCount + 1, sizeof(uint32_t));
+    if (lastRoute == NULL) {
+        return false;
+    }
+
+    bool result = true;
+    for (uint32_t i = 0; result && i < header->routesCount; i++) {
+        const MapImageRoute *record = &image->routes[i];
+        if (record->routeId < 1 || 999 < record->routeId ||
+                findRouteMapImage(image, record->routeId) != record ||
+                findRouteOnList(map->routes, record->routeId) != NULL) {
+            result = false;
+            break;
+        }
+
+        Route *route = NULL;
+        City *previous = NULL;
+        for (uint32_t j = 0; result && j < record->stepsCount; j++) {
+            uint32_t id = image->routeSteps[record->firstStep + j].city;
+            if (id >= header->citiesCount || lastRoute[id] == i + 1) {
+                result = false;
+                break;
+            }
+            lastRoute[id] = i + 1;
+
+            City *city = cities[id];
+            if (previous == NULL) {
+                route = newRouteModule(record->routeId, city, city,
+                                       map->searchState);
+                result = route != NULL;
+            } else {
+                result = findRoadModule(previous, city) != NULL &&
+                         insertList(route->cities->end, city) != NULL;
+            }
+            previous = city;
+        }
+
+        if (result) {
+            result = insertList(map->routes->end, route) != NULL;
+        }
+        if (!result && route != NULL) {
+            deleteRouteModule(route);
+        }
+    }
+
+    free(lastRoute);
+
+    return result;
+}
+
+/** @brief Kopiuje obraz do zwykłej mapy.
+ * Sprawdza sumę kontrolną obrazu, a następnie tworzy miasta, odcinki dróg
+ * i drogi krajowe z obrazu. Mapa musi być pusta.
+ * @param[in] image             - wskaźnik na obraz;
+ * @param[in,out] map           - wskaźnik na pustą mapę.
+ * @return Wartość @p true lub @p false, jeśli obraz jest niepoprawny (mapa
+ * pozostaje wtedy pusta) lub nie udało się zaalokować pamięci (mapa może
+ * wtedy zawierać część danych).
+ */
+bool copyMapImage(const MapImage *image, Map *map) {
+    assert(image);
+    assert(map);
+    assert(map->cities->begin == map->cities->end);
+    assert(map->routes->begin == map->routes->end);
+
+    const MapImageHeader *header = image->header;
+    if (checksumSnapshot(SNAPSHOT_CHECKSUM_SEED,
+                         (const char *)image->data + sizeof(MapImageHeader),
+                         header->fileSize - sizeof(MapImageHeader)) !=
+            header->checksum) {
+        return false;
+    }
+
+    City **cities = malloc(sizeof(City *) * (header->citiesCount + 1));
+    if (cities == NULL) {
+        return false;
+    }
+
+    bool result = addCitiesAndRoadsMapImage(image, map, cities) &&
+                  addRoutesMapImage(image, map, cities);
+
+    free(cities);
+
+    return result;
+}
@@ -0,0 +1,171 @@
+/** @file
+ * Interfejs klasy przechowującej obraz mapy dróg krajowych odwzorowany
+ * w pamięci.
+ *
+ * Obraz nie zawiera wskaźników, tylko numery i przesunięcia względem
+ * początku pliku, więc może być odwzorowany (mmap) pod dowolnym adresem
+ * i współdzielony przez wiele procesów. Składa się z nagłówka
+ * @ref MapImageHeader i sekcji wyrównanych do 8 bajtów:
+ *  - miast (rekordy @ref MapImageCity, o jeden więcej niż miast);
+ *  - odcinków dróg w postaci list sąsiedztwa CSR (rekordy
+ *    @ref MapImageEdge, każdy odcinek w obu kierunkach);
+ *  - dróg krajowych (rekordy @ref MapImageRoute w kolejności dróg na mapie);
+ *  - tablicy numerów dróg krajowych (@ref MAP_IMAGE_ROUTES_INDEX_SIZE pozycji
+ *    z numerami rekordów lub @ref MAP_IMAGE_NO_ROUTE);
+ *  - kolejnych miast dróg krajowych (rekordy @ref MapImageRouteStep);
+ *  - nazw miast (napisy zakończone zerem).
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef MAP_IMAGE_H
+#define MAP_IMAGE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define MAP_IMAGE_MAGIC 0x47414d49u
+///< liczba rozpoznająca obraz mapy (i kolejność bajtów)
+
+#define MAP_IMAGE_VERSION 1u
+///< wersja formatu obrazu mapy
+
+#define MAP_IMAGE_ROUTES_INDEX_SIZE 1000
+///< liczba pozycji tablicy numerów dróg krajowych
+
+#define MAP_IMAGE_NO_ROUTE UINT32_MAX
+///< pozycja tablicy numerów dróg krajowych bez drogi
+
+typedef struct Map Map;
+
+/**
+ * Struktura przechowująca nagłówek obrazu mapy.
+ */
+typedef struct MapImageHeader {
+    uint32_t magic;                 ///< @ref MAP_IMAGE_MAGIC
+    uint32_t version;               ///< @ref MAP_IMAGE_VERSION
+    uint32_t citiesCount;           ///< liczba miast
+    uint32_t edgesCount;            ///< liczba rekordów odcinków dróg
+    uint32_t routesCount;           ///< liczba dróg krajowych
+    uint32_t routeStepsCount;       ///< łączna liczba miast dróg krajowych
+    uint64_t namesSize;             ///< rozmiar sekcji nazw miast w bajtach
+    uint64_t citiesOffset;          ///< przesunięcie sekcji miast
+    uint64_t edgesOffset;           ///< przesunięcie sekcji odcinków
+    uint64_t routesOffset;          ///< przesunięcie sekcji dróg krajowych
+    uint64_t routesIndexOffset;     ///< przesunięcie tablicy numerów dróg
+    uint64_t routeStepsOffset;      ///< przesunięcie sekcji miast dróg
+    uint64_t namesOffset;           ///< przesunięcie sekcji nazw miast
+    uint64_t fileSize;              ///< rozmiar całego obrazu
+    uint64_t checksum;              ///< suma kontrolna obrazu bez nagłówka
+} MapImageHeader;
+
+/**
+ * Struktura przechowująca miasto w obrazie mapy.
+ */
+typedef struct MapImageCity {
+    uint32_t nameOffset;            ///< przesunięcie nazwy w sekcji nazw
+    uint32_t firstEdge;             ///< numer pierwszego odcinka miasta
+} MapImageCity;
+
+/**
+ * Struktura przechowująca odcinek drogi wychodzący z miasta w obrazie mapy.
+ */
+typedef struct MapImageEdge {
+    uint32_t destination;           ///< numer miasta, do którego prowadzi
+    uint32_t length;                ///< długość odcinka
+    int32_t year;                   ///< rok budowy lub ostatniego remontu
+} MapImageEdge;
+
+/**
+ * Struktura przechowująca drogę krajową w obrazie mapy.
+ */
+typedef struct MapImageRoute {
+    uint32_t routeId;               ///< numer drogi krajowej
+    uint32_t firstStep;             ///< numer pierwszego miasta drogi
+    uint32_t stepsCount;            ///< liczba miast drogi
+} MapImageRoute;
+
+/**
+ * Struktura przechowująca miasto drogi krajowej w obrazie mapy wraz
+ * z odcinkiem, którym droga do niego dochodzi.
+ */
+typedef struct MapImageRouteStep {
+    uint32_t city;                  ///< numer miasta
+    uint32_t length;                ///< długość odcinka (@p 0 dla pierwszego)
+    int32_t year;                   ///< rok odcinka (@p 0 dla pierwszego)
+} MapImageRouteStep;
+
+/**
+ * Struktura przechowująca obraz mapy odwzorowany w pamięci.
+ */
+typedef struct MapImage {
+    void *data;                     ///< początek odwzorowania
+    size_t size;                    ///< rozmiar odwzorowania
+    const MapImageHeader *header;   ///< nagłówek obrazu
+    const MapImageCity *cities;     ///< sekcja miast
+    const MapImageEdge *edges;      ///< sekcja odcinków dróg
+    const MapImageRoute *routes;    ///< sekcja dróg krajowych
+    const uint32_t *routesIndex;    ///< tablica numerów dróg krajowych
+    const MapImageRouteStep *routeSteps;    ///< sekcja miast dróg krajowych
+    const char *names;              ///< sekcja nazw miast
+} MapImage;
+
+/** @brief Zapisuje obraz mapy do pliku.
+ * @param[in] map               - wskaźnik na mapę (bez obrazu);
+ * @param[in,out] file          - wskaźnik na plik otwarty do zapisu.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać pliku lub
+ * zaalokować pamięci.
+ */
+bool writeMapImage(Map *map, FILE *file);
+
+/** @brief Odwzorowuje obraz mapy w pamięci.
+ * Sprawdza tylko nagłówek i granice sekcji, więc nie odczytuje całego
+ * pliku. Strony obrazu są współdzielone przez procesy odwzorowujące ten sam
+ * plik.
+ * @param[in] path              - wskaźnik na ścieżkę do pliku.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, jeśli plik nie jest
+ * poprawnym obrazem mapy lub nie udało się go odwzorować.
+ */
+MapImage *openMapImage(const char *path);
+
+/** @brief Usuwa strukturę i odwzorowanie.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] image             - wskaźnik na usuwaną strukturę.
+ */
+void closeMapImage(MapImage *image);
+
+/** @brief Zapisuje informacje o drodze krajowej z obrazu w buforze.
+ * Działa jak @ref writeRouteDescription.
+ * @param[in] image             - wskaźnik na obraz;
+ * @param[in] routeId           - numer drogi krajowej;
+ * @param[out] buffer           - wskaźnik na bufor lub NULL;
+ * @param[in] bufferSize        - rozmiar bufora (@p 0 dla NULL).
+ * @return Długość całego napisu (bez zera na końcu), także jeśli nie
+ * zmieścił się w buforze.
+ */
+size_t writeDescriptionMapImage(const MapImage *image, unsigned routeId,
+                                char *buffer, size_t bufferSize);
+
+/** @brief Udostępnia informacje o drodze krajowej z obrazu.
+ * Działa jak @ref getRouteDescription.
+ * @param[in] image             - wskaźnik na obraz;
+ * @param[in] routeId           - numer drogi krajowej.
+ * @return Wskaźnik na napis lub NULL, gdy nie udało się zaalokować pamięci.
+ */
+char *descriptionMapImage(const MapImage *image, unsigned routeId);
+
+/** @brief Kopiuje obraz do zwykłej mapy.
+ * Sprawdza sumę kontrolną obrazu, a następnie tworzy miasta, odcinki dróg
+ * i drogi krajowe z obrazu. Mapa musi być pusta.
+ * @param[in] image             - wskaźnik na obraz;
+ * @param[in,out] map           - wskaźnik na pustą mapę.
+ * @return Wartość @p true lub @p false, jeśli obraz jest niepoprawny (mapa
+ * pozostaje wtedy pusta) lub nie udało się zaalokować pamięci (mapa może
+ * wtedy zawierać część danych).
+ */
+bool copyMapImage(const MapImage *image, Map *map);
+
+#endif // MAP_IMAGE_H
@@ -7,24 +7,701 @@
 
 #include "map.h"
 #include "text_interface.h"
+#include "binary_interface.h"
+#include "command_pipeline.h"
+#include "command_chunks.h"
+#include "route_readers.h"
+#include "socket_server.h"
+#include "map_tenants.h"
+#include "string_utilities.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+
+#define DEFAULT_JOURNAL_GROUP_SIZE 32
+///< domyślna liczba rekordów dziennika zapisywanych naraz
+
+#define DEFAULT_CHECKPOINT_INTERVAL 100000
+///< domyślna liczba poleceń między punktami kontrolnymi
+
+#define MAX_ROUTE_ID 999
+///< największy numer drogi krajowej
+
+/**
+ * Struktura przechowująca opcje programu.
+ */
+typedef struct MainOptions {
+    uint32_t threadsCount;          ///< liczba wątków lub @p 0 (domyślna)
+    bool isEngineSet;               ///< czy wybrano algorytm wyszukiwania
+    SearchEngine engine;            ///< algorytm wyszukiwania
+    bool isLandmarksCountSet;       ///< czy podano liczbę punktów
+    uint32_t landmarksCount;        ///< liczba punktów orientacyjnych
+    char **landmarks;               ///< nazwy miast punktów orientacyjnych
+    uint32_t landmarksSize;         ///< liczba nazw w @ref landmarks
+    bool printStatistics;           ///< czy wypisać liczniki wyszukiwań
+    const char *loadPath;           ///< plik z obrazem mapy do wczytania
+    const char *savePath;           ///< plik na obraz mapy po zakończeniu
+    const char *imagePath;          ///< obraz mapy do odwzorowania w pamięci
+    const char *saveImagePath;      ///< plik na obraz do odwzorowania
+    const char *journalPath;        ///< plik dziennika poleceń
+    const char *checkpointPath;     ///< plik punktu kontrolnego dziennika
+    bool isJournalPolicySet;        ///< czy podano sposób zapisu dziennika
+    uint32_t groupSize;             ///< liczba rekordów zapisywanych naraz
+    uint32_t checkpointInterval;    ///< liczba poleceń między punktami
+    bool backgroundCheckpoints;     ///< czy zapisywać punkty kontrolne w tle
+    bool isBinaryInput;             ///< czy polecenia są w protokole binarnym
+    bool encodeBinary;              ///< czy tylko zamienić polecenia tekstowe
+                                    ///< na protokół binarny
+    bool isPipelined;               ///< czy wykonywać polecenia w potoku
+    uint32_t parserThreadsCount;    ///< liczba wątków parsujących fragmenty
+                                    ///< pliku lub @p 0 (parser sekwencyjny)
+    uint32_t readersCount;          ///< liczba wątków czytających opisy
+                                    ///< równolegle z poleceniami lub @p 0
+    const char *socketPath;         ///< gniazdo serwera obsługującego
+                                    ///< klientów zamiast wejścia lub NULL
+    uint32_t tenantThreadsCount;    ///< liczba wątków wykonujących polecenia
+                                    ///< map przestrzeni nazw lub @p 0
+    uint32_t cacheMegabytes;        ///< limit pamięci podręcznej drzew
+                                    ///< najkrótszych dróg w MiB lub @p 0
+    bool indexedRoutes[MAX_ROUTE_ID + 1];   ///< czy drogi krajowe o danych
+                                    ///< numerach mają indeks objazdów
+} MainOptions;
+
+/**
+ * Struktura przechowująca czasy wykonania poleceń, osobno dla poleceń
+ * wykonanych bez zapisywania punktu kontrolnego w tle (indeks @p 0) i w jego
+ * trakcie (indeks @p 1).
+ */
+typedef struct MainLatency {
+    uint64_t commandsCount[2];      ///< liczba poleceń
+    uint64_t nanoseconds[2];        ///< łączny czas poleceń
+    uint64_t maxNanoseconds[2];     ///< najdłuższy czas polecenia
+} MainLatency;
+
+/** @brief Wczytuje opcje podane w argumentach programu.
+ * Obsługiwane opcje:
+ *  - -t liczba wątków - równoległe szukanie objazdów w @ref removeRoad;
+ *  - -e dijkstra|bidirectional|alt|ch - algorytm wyszukiwania dróg krajowych;
+ *  - -l liczba punktów - liczba punktów orientacyjnych algorytmu A*;
+ *  - -L nazwa miasta - wybór miasta jako punktu orientacyjnego;
+ *  - -s - wypisanie liczników wyszukiwań na standardowe wyjście diagnostyczne;
+ *  - -r plik - wczytanie mapy z obrazu zapisanego przez @ref saveMap przed
+ *    wykonaniem poleceń;
+ *  - -w plik - zapisanie obrazu mapy po wykonaniu wszystkich poleceń;
+ *  - -m plik - odwzorowanie w pamięci obrazu zapisanego przez
+ *    @ref saveMapImage (mapa tylko do zapytań do pierwszej modyfikacji);
+ *  - -M plik - zapisanie obrazu do odwzorowania w pamięci po wykonaniu
+ *    wszystkich poleceń;
+ *  - -j plik - dziennik poleceń modyfikujących mapę (wymaga -c); mapa jest
+ *    odtwarzana z punktu kontrolnego i dziennika (zob. @ref recoverMap);
+ *  - -c plik - punkt kontrolny dziennika;
+ *  - -g liczba rekordów - liczba rekordów dziennika zapisywanych naraz;
+ *  - -k liczba poleceń - liczba poleceń między punktami kontrolnymi
+ *    (@p 0 wyłącza automatyczne punkty kontrolne);
+ *  - -b - zapisywanie punktów kontrolnych w tle przez proces potomny
+ *    (zob. @ref setBackgroundCheckpointsMap);
+ *  - -p text|binary - protokół poleceń na standardowym wejściu
+ *    (zob. @ref nextCommandBinaryInterface);
+ *  - -P - zamiana poleceń tekstowych ze standardowego wejścia na protokół
+ *    binarny na standardowym wyjściu, bez wykonywania poleceń;
+ *  - -q - wczytywanie i wypisywanie wyników poleceń tekstowych w osobnych
+ *    wątkach (zob. @ref nextCommandPipeline);
+ *  - -i liczba wątków - równoległe parsowanie fragmentów pliku podanego na
+ *    standardowe wejście (zob. @ref nextCommandChunks); jeśli wejście nie
+ *    jest zwykłym plikiem, wiersze czytane są po kolei;
+ *  - -R liczba wątków - współbieżne odczyty opisów dróg krajowych
+ *    (@ref setConcurrentReadsMap) i wątki czytające losowe opisy podczas
+ *    wykonywania poleceń (zob. @ref newRouteReaders);
+ *  - -S gniazdo - obsługa poleceń tekstowych klientów łączących się przez
+ *    gniazdo domeny uniksowej zamiast standardowego wejścia, do otrzymania
+ *    sygnału SIGINT lub SIGTERM (zob. @ref runSocketServer);
+ *  - -n liczba wątków - wiele map w jednym procesie, wybieranych
+ *    przedrostkiem przestrzeni nazw wiersza i wykonywanych równolegle przez
+ *    wspólną pulę wątków (zob. @ref nextMapTenants);
+ *  - -C liczba MiB - pamięć podręczna drzew najkrótszych dróg o podanym
+ *    limicie (zob. @ref setSearchCacheMap);
+ *  - -x numer drogi krajowej - indeks objazdów odcinków drogi krajowej
+ *    (zob. @ref setReplacementPathsMap).
+ * @param[in] argc          - liczba argumentów programu;
+ * @param[in] argv          - argumenty programu;
+ * @param[out] options      - wskaźnik na opcje programu; tablica
+ *                            @ref MainOptions.landmarks musi mieć miejsce na
+ *                            @p argc nazw.
+ * @return Wartość @p true jeśli opcje są poprawne lub @p false w przeciwnym
+ * przypadku.
+ */
+bool parseOptionsMain(int argc, char *argv[], MainOptions *options) {
+    int option;
+    unsigned routeId;
+    const char *optionsString = "t:e:l:L:sr:w:m:M:j:c:g:k:bp:Pqi:R:S:n:C:x:";
+    while ((option = getopt(argc, argv, optionsString)) != -1) {
+        switch (option) {
+            case 't':
+                options->threadsCount = stringToUnsigned(optarg);
+                if (errno == EILSEQ) {
+                    return false;
+                }
+                break;
+            case 'e':
+                options->isEngineSet = true;
+                if (strcmp(optarg, "dijkstra") == 0) {
+                    options->engine = DIJKSTRA_SEARCH_ENGINE;
+                } else if (strcmp(optarg, "bidirectional") == 0) {
+                    options->engine = BIDIRECTIONAL_SEARCH_ENGINE;
+                } else if (strcmp(optarg, "alt") == 0) {
+                    options->engine = ALT_SEARCH_ENGINE;
+                } else if (strcmp(optarg, "ch") == 0) {
+                    options->engine = HIERARCHY_SEARCH_ENGINE;
+                } else {
+                    return false;
+                }
+                break;
+            case 'l':
+                options->isLandmarksCountSet = true;
+                options->landmarksCount = stringToUnsigned(optarg);
+                if (errno == EILSEQ) {
+                    return false;
+                }
+                break;
+            case 'L':
+                options->landmarks[options->landmarksSize++] = optarg;
+                break;
+            case 's':
+                options->printStatistics = true;
+                break;
+            case 'r':
+                options->loadPath = optarg;
+                break;
+            case 'w':
+                options->savePath = optarg;
+                break;
+            case 'm':
+                options->imagePath = optarg;
+                break;
+            case 'M':
+                options->saveImagePath = optarg;
+                break;
+            case 'j':
+                options->journalPath = optarg;
+                break;
+            case 'c':
+                options->checkpointPath = optarg;
+                break;
+            case 'g':
+                options->isJournalPolicySet = true;
+                options->groupSize = stringToUnsigned(optarg);
+                if (errno == EILSEQ || options->groupSize == 0) {
+                    return false;
+                }
+                break;
+            case 'k':
+                options->isJournalPolicySet = true;
+                options->checkpointInterval = stringToUnsigned(optarg);
+                if (errno == EILSEQ) {
+                    return false;
+                }
+                break;
+            case 'b':
+                options->isJournalPolicySet = true;
+                options->backgroundCheckpoints = true;
+                break;
+            case 'p':
+                if (strcmp(optarg, "text") == 0) {
+                    options->isBinaryInput = false;
+                } else if (strcmp(optarg, "binary") == 0) {
+                    options->isBinaryInput = true;
+                } else {
+                    return false;
+                }
+                break;
+            case 'P':
+                options->encodeBinary = true;
+                break;
+            case 'q':
+                options->isPipelined = true;
+                break;
+            case 'i':
+                options->parserThreadsCount = stringToUnsigned(optarg);
+                if (errno == EILSEQ || options->parserThreadsCount == 0) {
+                    return false;
+                }
+                break;
+            case 'R':
+                options->readersCount = stringToUnsigned(optarg);
+                if (errno == EILSEQ || options->readersCount == 0 ||
+                        options->readersCount > ROUTE_SNAPSHOTS_MAX_READERS) {
+                    return false;
+                }
+                break;
+            case 'S':
+                options->socketPath = optarg;
+                break;
+            case 'n':
+                options->tenantThreadsCount = stringToUnsigned(optarg);
+                if (errno == EILSEQ || options->tenantThreadsCount == 0) {
+                    return false;
+                }
+                break;
+            case 'C':
+                options->cacheMegabytes = stringToUnsigned(optarg);
+                if (errno == EILSEQ || options->cacheMegabytes == 0) {
+                    return false;
+                }
+                break;
+            case 'x':
+                routeId = stringToUnsigned(optarg);
+                if (errno == EILSEQ || routeId == 0 ||
+                        routeId > MAX_ROUTE_ID) {
+                    return false;
+                }
+                options->indexedRoutes[routeId] = true;
+                break;
+            default:
+                return false;
+        }
+    }
+
+    bool isJournalSet = options->journalPath != NULL;
+    if (isJournalSet != (options->checkpointPath != NULL) ||
+            (options->isJournalPolicySet && !isJournalSet)) {
+        return false;
+    }
+
+    uint32_t sourcesCount = (options->loadPath != NULL) +
+                            (options->imagePath != NULL) + isJournalSet;
+
+    return optind == argc && sourcesCount <= 1 &&
+           !(options->encodeBinary && options->isBinaryInput) &&
+           !((options->isPipelined || options->parserThreadsCount != 0) &&
+             (options->encodeBinary || options->isBinaryInput)) &&
+           !(options->isPipelined && options->parserThreadsCount != 0) &&
+           !(options->socketPath != NULL &&
+             (options->isPipelined || options->parserThreadsCount != 0 ||
+              options->encodeBinary || options->isBinaryInput)) &&
+           !(options->tenantThreadsCount != 0 &&
+             (options->isPipelined || options->parserThreadsCount != 0 ||
+              options->encodeBinary || options->isBinaryInput ||
+              options->socketPath != NULL || options->readersCount != 0 ||
+              isJournalSet || options->threadsCount != 0 ||
+              options->landmarksSize != 0));
+}
+
+/** @brief Ustawia opcje mapy.
+ * @param[in,out] map       - wskaźnik na mapę;
+ * @param[in] options       - wskaźnik na opcje programu.
+ * @return Wartość @p true jeśli udało się ustawić opcje lub @p false
+ * w przeciwnym przypadku.
+ */
+bool applyOptionsMain(Map *map, const MainOptions *options) {
+    if (options->threadsCount != 0 &&
+            !setThreadsCountMap(map, options->threadsCount)) {
+        return false;
+    }
+
+    if (options->isEngineSet) {
+        setSearchEngineMap(map, options->engine);
+    }
+
+    if (options->cacheMegabytes != 0 &&
+            !setSearchCacheMap(map, (size_t)options->cacheMegabytes << 20)) {
+        return false;
+    }
+
+    if (map->journal != NULL &&
+            (!setJournalPolicyMap(map, options->groupSize,
+                                  options->checkpointInterval) ||
+             !setBackgroundCheckpointsMap(map,
+                                          options->backgroundCheckpoints))) {
+        return false;
+    }
+
+    if (options->isLandmarksCountSet &&
+            !setLandmarksCountMap(map, options->landmarksCount)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < options->landmarksSize; i++) {
+        if (!addLandmarkMap(map, options->landmarks[i])) {
+            return false;
+        }
+    }
+
+    for (unsigned routeId = 1; routeId <= MAX_ROUTE_ID; routeId++) {
+        if (options->indexedRoutes[routeId] &&
+                !setReplacementPathsMap(map, routeId, true)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** @brief Ustawia opcje nowej mapy przestrzeni nazw.
+ * Funkcja typu @ref MapTenantSetup.
+ * @param[in,out] map       - wskaźnik na mapę;
+ * @param[in] options       - wskaźnik na opcje programu (@ref MainOptions).
+ * @return Wartość @p true jeśli udało się ustawić opcje lub @p false
+ * w przeciwnym przypadku.
+ */
+bool setupTenantMain(Map *map, void *options) {
+    return applyOptionsMain(map, options);
+}
+
+/** @brief Wypisuje sposób użycia programu.
+ * @param[in] program       - nazwa programu.
+ */
+void printUsageMain(const char *program) {
+    fprintf(stderr, "Usage: %s [-t threads] "
+            "[-e dijkstra|bidirectional|alt|ch] [-l landmarks] [-L city] "
+            "[-s] [-r snapshot] [-w snapshot] [-m image] [-M image] "
+            "[-j journal -c checkpoint [-g records] [-k commands] [-b]] "
+            "[-p text|binary] [-P] [-q | -i threads] [-R readers] "
+            "[-S socket] [-n threads] [-C megabytes] [-x route]\n",
+            program);
+}
+
+/** @brief Sprawdza, czy punkt kontrolny jest zapisywany w tle.
+ * @param[in] map           - wskaźnik na mapę.
+ * @return Wartość @p true, jeśli istnieje proces zapisujący punkt kontrolny.
+ */
+bool isCheckpointRunningMain(const Map *map) {
+    return map->journal != NULL && map->journal->checkpointPid != 0;
+}
+
+/** @brief Wypisuje liczniki dziennika i punktów kontrolnych.
+ * @param[in] journal       - wskaźnik na dziennik;
+ * @param[in] latency       - wskaźnik na czasy wykonania poleceń.
+ */
+void printJournalStatisticsMain(const Journal *journal,
+                                const MainLatency *latency) {
+    fprintf(stderr, "journal replayed: %" PRIu64 "\njournal records: %"
+            PRIu64 "\njournal syncs: %" PRIu64 "\ncheckpoints: %"
+            PRIu64 "\njournal errors: %" PRIu64 "\n",
+            journal->replayedCount, journal->recordsCount,
+            journal->syncsCount, journal->checkpointsCount,
+            journal->errorsCount);
+
+    if (!journal->isBackground) {
+        return;
+    }
+
+    uint64_t count = journal->backgroundCount;
+    fprintf(stderr, "background checkpoints: %" PRIu64 "\nbackground "
+            "snapshot ms: %" PRIu64 "\nfork average us: %" PRIu64 "\nfork "
+            "max us: %" PRIu64 "\ncopied pages: %" PRIu64 "\n", count,
+            journal->snapshotNanoseconds / 1000000,
+            count == 0 ? 0 : journal->forkNanoseconds / count / 1000,
+            journal->maxForkNanoseconds / 1000, journal->copiedPages);
+
+    const char *names[2] = {"idle", "during checkpoint"};
+    for (int i = 0; i < 2; i++) {
+        uint64_t commandsCount = latency->commandsCount[i];
+        fprintf(stderr, "commands %s: %" PRIu64 "\ncommand average ns %s: %"
+                PRIu64 "\ncommand max ns %s: %" PRIu64 "\n", names[i],
+                commandsCount, names[i], commandsCount == 0 ? 0 :
+                latency->nanoseconds[i] / commandsCount, names[i],
+                latency->maxNanoseconds[i]);
+    }
+}
+
+/** @brief Wypisuje liczniki map przestrzeni nazw.
+ * Mapa domyślna wypisywana jest z pustą nazwą.
+ * @param[in] tenants       - wskaźnik na mapy przestrzeni nazw.
+ */
+void printTenantsStatisticsMain(const MapTenants *tenants) {
+    uint32_t tenantsCount = countMapTenants(tenants);
+    fprintf(stderr, "tenants: %" PRIu32 "\n", tenantsCount);
+    for (uint32_t i = 0; i < tenantsCount; i++) {
+        MapTenantStatistics statistics = getStatisticsMapTenants(tenants, i);
+        uint64_t commandsCount = statistics.commandsCount;
+        fprintf(stderr, "tenant[%s] commands: %" PRIu64 "\ntenant[%s] "
+                "memory bytes: %zu\ntenant[%s] command average ns: %" PRIu64
+                "\ntenant[%s] command max ns: %" PRIu64 "\n",
+                statistics.name, commandsCount, statistics.name,
+                statistics.memoryUsage, statistics.name, commandsCount == 0 ?
+                0 : statistics.nanoseconds / commandsCount, statistics.name,
+                statistics.maxNanoseconds);
+    }
+}
 
 /** @brief Funkcja main.
- * @return Wartość @p 0.
+ * @param[in] argc          - liczba argumentów programu;
+ * @param[in] argv          - argumenty programu.
+ * @return Wartość @p 0 lub @p 1, jeśli podano niepoprawne opcje lub nie
+ * udało się uruchomić serwera.
  */
-int main() {
-    Map *map = newMap();
-    if (map == NULL) {
+int main(int argc, char *argv[]) {
+    MainOptions options;
+    memset(&options, 0, sizeof(MainOptions));
+    options.groupSize = DEFAULT_JOURNAL_GROUP_SIZE;
+    options.checkpointInterval = DEFAULT_CHECKPOINT_INTERVAL;
+    options.landmarks = malloc(sizeof(char *) * (argc + 1));
+    if (options.landmarks == NULL) {
+        return 0;
+    }
+
+    if (!parseOptionsMain(argc, argv, &options)) {
+        printUsageMain(argv[0]);
+        free(options.landmarks);
+        return 1;
+    }
+
+    if (options.encodeBinary) {
+        free(options.landmarks);
+        if (!encodeBinaryInterface(stdout)) {
+            fprintf(stderr, "Cannot encode commands\n");
+            return 1;
+        }
         return 0;
     }
 
+    /* Sygnały kończące serwer muszą być zablokowane przed utworzeniem
+     * wątków. */
+    if (options.socketPath != NULL && !blockSignalsSocketServer()) {
+        free(options.landmarks);
+        return 1;
+    }
+
+    Map *map;
+    if (options.loadPath != NULL) {
+        map = loadMap(options.loadPath);
+        if (map == NULL) {
+            fprintf(stderr, "Cannot load %s\n", options.loadPath);
+            free(options.landmarks);
+            return 1;
+        }
+    } else if (options.journalPath != NULL) {
+        map = recoverMap(options.checkpointPath, options.journalPath);
+        if (map == NULL) {
+            fprintf(stderr, "Cannot recover %s\n", options.journalPath);
+            free(options.landmarks);
+            return 1;
+        }
+    } else if (options.imagePath != NULL) {
+        map = openMap(options.imagePath);
+        if (map == NULL) {
+            fprintf(stderr, "Cannot open %s\n", options.imagePath);
+            free(options.landmarks);
+            return 1;
+        }
+    } else {
+        map = newMap();
+        if (map == NULL) {
+            free(options.landmarks);
+            return 0;
+        }
+    }
+
+    bool isCorrect = applyOptionsMain(map, &options);
+    free(options.landmarks);
+    options.landmarks = NULL;
+    if (!isCorrect) {
+        printUsageMain(argv[0]);
+        deleteMap(map);
+        return 1;
+    }
+
+    RouteReaders *readers = NULL;
+    if (options.readersCount != 0) {
+        if (setConcurrentReadsMap(map, true)) {
+            readers = newRouteReaders(map, options.readersCount);
+        }
+        if (readers == NULL) {
+            fprintf(stderr, "Cannot start readers\n");
+            deleteMap(map);
+            return 1;
+        }
+    }
+
+    BinaryInterface *binaryInterface = NULL;
+    CommandParser *parser = NULL;
+    CommandPipeline *pipeline = NULL;
+    CommandChunks *chunks = NULL;
+    MapTenants *tenants = NULL;
+    if (options.parserThreadsCount != 0) {
+        chunks = newCommandChunks(stdin, options.parserThreadsCount);
+    }
+
+    if (options.isBinaryInput) {
+        binaryInterface = newBinaryInterface(stdin);
+        if (binaryInterface == NULL) {
+            fprintf(stderr, "Cannot read binary commands\n");
+            deleteRouteReaders(readers, NULL);
+            deleteMap(map);
+            return 1;
+        }
+    } else if (options.isPipelined) {
+        pipeline = newCommandPipeline(stdin);
+        if (pipeline == NULL) {
+            fprintf(stderr, "Cannot start command pipeline\n");
+            deleteRouteReaders(readers, NULL);
+            deleteMap(map);
+            return 1;
+        }
+    } else if (options.tenantThreadsCount != 0) {
+        tenants = newMapTenants(stdin, map, options.tenantThreadsCount,
+                                setupTenantMain, &options);
+        if (tenants == NULL) {
+            fprintf(stderr, "Cannot start tenants\n");
+            deleteMap(map);
+            return 1;
+        }
+    } else if (chunks == NULL && options.socketPath == NULL) {
+        parser = newCommandParser(stdin);
+        if (parser == NULL) {
+            deleteRouteReaders(readers, NULL);
+            deleteMap(map);
+            return 0;
+        }
+    }
+
+    /* Czas polecenia, które utworzyło proces zapisujący punkt kontrolny,
+     * zawiera czas wywołania fork. */
+    MainLatency latency;
+    memset(&latency, 0, sizeof(MainLatency));
     uint32_t lineNumber = 0;
-    int x;
-    do {
-        x = nextCommandTextInterface(map, ++lineNumber);
-    } while (x == 0);
+    int exitCode = 0;
+    SocketServerStatistics serverStatistics;
+    if (options.socketPath != NULL &&
+            !runSocketServer(map, options.socketPath, &serverStatistics)) {
+        fprintf(stderr, "Cannot serve %s\n", options.socketPath);
+        exitCode = 1;
+    }
+
+    /* Serwer sam wykonuje polecenia klientów. */
+    int x = options.socketPath != NULL ? EOF : 0;
+    while (x == 0) {
+        bool isRunning = isCheckpointRunningMain(map);
+        uint64_t start = nanosecondsJournal();
+        if (binaryInterface != NULL) {
+            x = nextCommandBinaryInterface(map, binaryInterface, ++lineNumber);
+        } else if (pipeline != NULL) {
+            x = nextCommandPipeline(map, pipeline);
+        } else if (chunks != NULL) {
+            x = nextCommandChunks(map, chunks);
+        } else if (tenants != NULL) {
+            x = nextMapTenants(tenants);
+        } else {
+            x = nextCommandTextInterface(map, parser, ++lineNumber);
+        }
+        uint64_t duration = nanosecondsJournal() - start;
+        int i = isRunning || isCheckpointRunningMain(map);
+        latency.commandsCount[i]++;
+        latency.nanoseconds[i] += duration;
+        if (duration > latency.maxNanoseconds[i]) {
+            latency.maxNanoseconds[i] = duration;
+        }
+    }
+    deleteBinaryInterface(binaryInterface);
+    deleteCommandParser(parser);
+    deleteCommandChunks(chunks);
+    RouteReadersStatistics readersStatistics;
+    deleteRouteReaders(readers, &readersStatistics);
+    PipelineStatistics pipelineStatistics;
+    if (pipeline != NULL) {
+        pipelineStatistics = getStatisticsCommandPipeline(pipeline);
+        deleteCommandPipeline(pipeline);
+    }
+    waitForCheckpointMap(map);
+
+    /* Koniec wejścia zamyka ostatnią, niepełną grupę rekordów dziennika. */
+    if (map->journal != NULL && !syncJournal(map->journal)) {
+        fprintf(stderr, "Cannot write %s\n", options.journalPath);
+    }
+
+    if (options.savePath != NULL && !saveMap(map, options.savePath)) {
+        fprintf(stderr, "Cannot save %s\n", options.savePath);
+    }
+    if (options.saveImagePath != NULL &&
+            !saveMapImage(map, options.saveImagePath)) {
+        fprintf(stderr, "Cannot save %s\n", options.saveImagePath);
+    }
+
+    if (options.printStatistics) {
+        SearchStatistics statistics = getSearchStatisticsMap(map);
+        fprintf(stderr, "searches: %" PRIu64 "\nsettled cities: %" PRIu64
+                "\nshared detours: %" PRIu64 "\n", statistics.searchesCount,
+                statistics.settledCitiesCount, statistics.sharedDetoursCount);
+        if (map->landmarks != NULL) {
+            fprintf(stderr, "landmark index builds: %" PRIu64 "\n",
+                    map->landmarks->buildsCount);
+        }
+        if (map->hierarchy != NULL) {
+            fprintf(stderr, "hierarchy builds: %" PRIu64 "\nshortcuts: %"
+                    PRIu64 "\n", map->hierarchy->buildsCount,
+                    map->hierarchy->shortcutsCount);
+        }
+        fprintf(stderr, "connectivity queries: %" PRIu64 "\nconnectivity "
+                "hits: %" PRIu64 "\nconnectivity builds: %" PRIu64 "\n",
+                map->connectivity->queriesCount,
+                map->connectivity->hitsCount,
+                map->connectivity->buildsCount);
+        fprintf(stderr, "map promotions: %" PRIu64 "\n",
+                map->promotionsCount);
+        if (map->searchCache != NULL) {
+            SearchCacheStatistics cache = getSearchCacheStatisticsMap(map);
+            uint64_t lookups = cache.hitsCount + cache.missesCount;
+            fprintf(stderr, "search cache hits: %" PRIu64 "\nsearch cache "
+                    "misses: %" PRIu64 "\nsearch cache hit rate %%: %" PRIu64
+                    "\nsearch cache trees: %" PRIu64 "\nsearch cache memory "
+                    "bytes: %zu\nsearch cache evictions: %" PRIu64 "\nsearch "
+                    "cache invalidations: %" PRIu64 "\n", cache.hitsCount,
+                    cache.missesCount, lookups == 0 ? 0 :
+                    cache.hitsCount * 100 / lookups, cache.entriesCount,
+                    cache.memoryUsage, cache.evictionsCount,
+                    cache.invalidationsCount);
+        }
+        if (map->indexedRoutesCount != 0) {
+            ReplacementPathsStatistics paths =
+                    getReplacementPathsStatisticsMap(map);
+            fprintf(stderr, "replacement path routes: %" PRIu64
+                    "\nreplacement paths: %" PRIu64 "\nstale replacement "
+                    "paths: %" PRIu64 "\nreplacement path hits: %" PRIu64
+                    "\nreplacement path builds: %" PRIu64 "\nreplacement "
+                    "path invalidations: %" PRIu64 "\nreplacement path "
+                    "memory bytes: %zu\n", paths.routesCount,
+                    paths.pathsCount, paths.stalePathsCount, paths.hitsCount,
+                    paths.buildsCount, paths.invalidationsCount,
+                    paths.memoryUsage);
+        }
+        if (readers != NULL) {
+            uint64_t milliseconds = readersStatistics.nanoseconds / 1000000;
+            fprintf(stderr, "concurrent readers: %" PRIu32 "\nconcurrent "
+                    "reads: %" PRIu64 "\nconcurrent reads per second: %"
+                    PRIu64 "\npublished descriptions: %" PRIu64 "\nreclaimed "
+                    "descriptions: %" PRIu64 "\n", options.readersCount,
+                    readersStatistics.readsCount, milliseconds == 0 ? 0 :
+                    readersStatistics.readsCount * 1000 / milliseconds,
+                    publishedCountRouteSnapshots(map->snapshots),
+                    reclaimedCountRouteSnapshots(map->snapshots));
+        }
+        if (options.socketPath != NULL && exitCode == 0) {
+            fprintf(stderr, "server clients: %" PRIu64 "\nserver max "
+                    "clients: %" PRIu64 "\nserver lines: %" PRIu64 "\nserver "
+                    "batches: %" PRIu64 "\n", serverStatistics.clientsCount,
+                    serverStatistics.maxClientsCount,
+                    serverStatistics.linesCount,
+                    serverStatistics.batchesCount);
+        }
+        if (tenants != NULL) {
+            printTenantsStatisticsMain(tenants);
+        }
+        if (options.isPipelined) {
+            fprintf(stderr, "pipeline parser waits: %" PRIu64 "\npipeline "
+                    "executor waits: %" PRIu64 "\npipeline output waits: %"
+                    PRIu64 "\n", pipelineStatistics.parserWaits,
+                    pipelineStatistics.executorWaits,
+                    pipelineStatistics.outputWaits);
+        }
+        if (map->journal != NULL) {
+            printJournalStatisticsMain(map->journal, &latency);
+        }
+    }
 
+    deleteMapTenants(tenants);
     deleteMap(map);
-    return 0;
+    return exitCode;
 }
@@ -0,0 +1,661 @@
+/** @file
+ * Implementacja klasy obsługującej wiele niezależnych map w jednym procesie.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "map_tenants.h"
+#include "command_parser.h"
+#include "thread_pool.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <inttypes.h>
+
+#define MAP_TENANTS_BATCH_SIZE 4096
+///< liczba wierszy wczytywanych przed wykonaniem poleceń
+
+#define MAP_TENANTS_TABLE_SIZE 64
+///< początkowy rozmiar tablicy haszującej przestrzeni nazw (potęga dwójki)
+
+#define MAP_TENANTS_DESCRIPTION_SIZE 256
+///< wolne miejsce w buforze wyników przed zapisaniem opisu drogi krajowej
+
+#define NO_RECORD UINT32_MAX
+///< numer oznaczający brak kolejnego wiersza mapy
+
+/**
+ * Struktura przechowująca mapę przestrzeni nazw.
+ */
+typedef struct Tenant {
+    char *name;                     ///< przestrzeń nazw
+    size_t nameLength;              ///< długość przestrzeni nazw
+    uint32_t hash;                  ///< hasz przestrzeni nazw
+    Map *map;                       ///< wskaźnik na mapę
+    bool isOwned;                   ///< czy mapa jest usuwana ze strukturą
+    char *output;                   ///< opisy dróg krajowych porcji wierszy
+    size_t outputSize;              ///< długość opisów
+    size_t outputMemorySize;        ///< rozmiar bufora opisów
+    uint32_t firstRecord;           ///< pierwszy wiersz mapy w porcji
+    uint32_t lastRecord;            ///< ostatni wiersz mapy w porcji
+    uint64_t commandsCount;         ///< liczba wykonanych wierszy
+    uint64_t nanoseconds;           ///< łączny czas wierszy
+    uint64_t maxNanoseconds;        ///< najdłuższy czas wiersza
+} Tenant;
+
+/**
+ * Struktura przechowująca wiersz porcji.
+ */
+typedef struct TenantRecord {
+    size_t lineOffset;              ///< początek wiersza (bez przedrostka)
+    uint32_t lineNumber;            ///< numer wiersza wejścia
+    uint32_t next;                  ///< kolejny wiersz tej samej mapy
+    Tenant *tenant;                 ///< mapa wiersza lub NULL (błąd)
+    bool isTerminated;              ///< czy wiersz kończył się znakiem '\n'
+    bool hasDescription;            ///< czy wiersz wypisuje opis
+    int result;                     ///< wynik jak w @ref nextCommandParser
+    size_t outputOffset;            ///< początek opisu w wynikach mapy
+    size_t outputSize;              ///< długość opisu
+} TenantRecord;
+
+/**
+ * Struktura przechowująca mapy przestrzeni nazw.
+ */
+typedef struct MapTenants {
+    FILE *input;                    ///< plik z poleceniami tekstowymi
+    ThreadPool *pool;               ///< wspólna pula wątków
+    uint32_t threadsCount;          ///< liczba wątków puli
+    CommandParser **parsers;        ///< parsery wątków puli
+    MapTenantSetup setup;           ///< funkcja ustawiająca opcje map
+    void *argument;                 ///< argument funkcji @ref setup
+    Tenant **tenants;               ///< mapy w kolejności utworzenia
+    uint32_t tenantsCount;          ///< liczba map
+    uint32_t tenantsMemorySize;     ///< rozmiar tablic map
+    Tenant **scheduled;             ///< mapy z wierszami w porcji
+    uint32_t scheduledCount;        ///< liczba map z wierszami w porcji
+    Tenant **table;                 ///< tablica haszująca przestrzeni nazw
+    uint32_t tableSize;             ///< rozmiar tablicy haszującej
+    TenantRecord *records;          ///< wiersze porcji
+    uint32_t recordsCount;          ///< liczba wierszy porcji
+    char *text;                     ///< tekst wierszy porcji
+    size_t textSize;                ///< długość tekstu porcji
+    size_t textMemorySize;          ///< rozmiar bufora tekstu
+    char *line;                     ///< bufor funkcji getline
+    size_t lineMemorySize;          ///< rozmiar bufora funkcji getline
+    uint32_t lineNumber;            ///< numer ostatnio wczytanego wiersza
+    bool isEnd;                     ///< czy wejście się skończyło
+} MapTenants;
+
+/** @brief Zapewnia miejsce w buforze.
+ * @param[in,out] buffer        - wskaźnik na bufor;
+ * @param[in,out] memorySize    - wskaźnik na rozmiar bufora;
+ * @param[in] size              - potrzebny rozmiar bufora.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool reserveMapTenants(char **buffer, size_t *memorySize, size_t size) {
+    assert(buffer && memorySize);
+
+    if (size <= *memorySize) {
+        return true;
+    }
+
+    size_t newMemorySize = 2 * *memorySize;
+    if (newMemorySize < size) {
+        newMemorySize = size;
+    }
+
+    char *newBuffer = realloc(*buffer, newMemorySize);
+    if (newBuffer == NULL) {
+        return false;
+    }
+
+    *buffer = newBuffer;
+    *memorySize = newMemorySize;
+    return true;
+}
+
+/** @brief Liczy hasz przestrzeni nazw (FNV-1a).
+ * @param[in] name              - wskaźnik na przestrzeń nazw;
+ * @param[in] length            - długość przestrzeni nazw.
+ * @return Hasz przestrzeni nazw.
+ */
+uint32_t hashNameMapTenants(const char *name, size_t length) {
+    uint32_t result = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        result = (result ^ (unsigned char) name[i]) * 16777619u;
+    }
+
+    return result;
+}
+
+/** @brief Usuwa mapę przestrzeni nazw.
+ * Mapa domyślna (bez nazwy) nie jest usuwana.
+ * @param[in] tenant            - wskaźnik na usuwaną strukturę lub NULL.
+ */
+void deleteTenantMapTenants(Tenant *tenant) {
+    if (tenant == NULL) {
+        return;
+    }
+
+    if (tenant->isOwned) {
+        deleteMap(tenant->map);
+    }
+    free(tenant->name);
+    free(tenant->output);
+    free(tenant);
+}
+
+/** @brief Tworzy mapę przestrzeni nazw i dodaje ją do listy map.
+ * @param[in,out] tenants       - wskaźnik na strukturę;
+ * @param[in] name              - wskaźnik na przestrzeń nazw lub NULL dla
+ *                                mapy domyślnej;
+ * @param[in] length            - długość przestrzeni nazw;
+ * @param[in] map               - wskaźnik na mapę domyślną lub NULL.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci lub ustawić opcji mapy.
+ */
+Tenant *newTenantMapTenants(MapTenants *tenants, const char *name,
+                            size_t length, Map *map) {
+    assert(tenants);
+
+    if (tenants->tenantsCount == tenants->tenantsMemorySize) {
+        uint32_t memorySize = 2 * tenants->tenantsMemorySize;
+        Tenant **array = realloc(tenants->tenants,
+                                 sizeof(Tenant *) * memorySize);
+        if (array == NULL) {
+            return NULL;
+        }
+        tenants->tenants = array;
+
+        array = realloc(tenants->scheduled, sizeof(Tenant *) * memorySize);
+        if (array == NULL) {
+            return NULL;
+        }
+        tenants->scheduled = array;
+        tenants->tenantsMemorySize = memorySize;
+    }
+
+    Tenant *result = calloc(1, sizeof(Tenant));
+    if (result == NULL) {
+        return NULL;
+    }
+    result->firstRecord = NO_RECORD;
+    result->lastRecord = NO_RECORD;
+    result->map = map;
+
+    if (name != NULL) {
+        result->isOwned = true;
+        result->name = malloc(length + 1);
+        result->map = newMap();
+        if (result->name == NULL || result->map == NULL ||
+                !tenants->setup(result->map, tenants->argument)) {
+            deleteTenantMapTenants(result);
+            return NULL;
+        }
+        memcpy(result->name, name, length);
+        result->name[length] = 0;
+        result->nameLength = length;
+        result->hash = hashNameMapTenants(name, length);
+    }
+
+    tenants->tenants[tenants->tenantsCount++] = result;
+    return result;
+}
+
+/** @brief Wstawia mapę do tablicy haszującej.
+ * Tablica musi mieć wolne miejsce.
+ * @param[in,out] table         - tablica haszująca;
+ * @param[in] tableSize         - rozmiar tablicy (potęga dwójki);
+ * @param[in] tenant            - wskaźnik na mapę.
+ */
+void insertTableMapTenants(Tenant **table, uint32_t tableSize,
+                           Tenant *tenant) {
+    uint32_t i = tenant->hash & (tableSize - 1);
+    while (table[i] != NULL) {
+        i = (i + 1) & (tableSize - 1);
+    }
+    table[i] = tenant;
+}
+
+/** @brief Znajduje mapę przestrzeni nazw, jeśli jej nie ma to ją tworzy.
+ * @param[in,out] tenants       - wskaźnik na strukturę;
+ * @param[in] name              - wskaźnik na przestrzeń nazw;
+ * @param[in] length            - długość przestrzeni nazw.
+ * @return Wskaźnik na mapę lub NULL, gdy nie udało się zaalokować pamięci.
+ */
+Tenant *findTenantMapTenants(MapTenants *tenants, const char *name,
+                             size_t length) {
+    assert(tenants && name);
+
+    uint32_t hash = hashNameMapTenants(name, length);
+    uint32_t mask = tenants->tableSize - 1;
+    uint32_t i = hash & mask;
+    while (tenants->table[i] != NULL) {
+        Tenant *tenant = tenants->table[i];
+        if (tenant->hash == hash && tenant->nameLength == length &&
+                memcmp(tenant->name, name, length) == 0) {
+            return tenant;
+        }
+        i = (i + 1) & mask;
+    }
+
+    /* Tablica jest wypełniona co najwyżej w połowie. */
+    if (2 * tenants->tenantsCount >= tenants->tableSize) {
+        uint32_t tableSize = 2 * tenants->tableSize;
+        Tenant **table = calloc(tableSize, sizeof(Tenant *));
+        if (table == NULL) {
+            return NULL;
+        }
+        for (uint32_t j = 0; j < tenants->tableSize; j++) {
+            if (tenants->table[j] != NULL) {
+                insertTableMapTenants(table, tableSize, tenants->table[j]);
+            }
+        }
+        free(tenants->table);
+        tenants->table = table;
+        tenants->tableSize = tableSize;
+    }
+
+    Tenant *result = newTenantMapTenants(tenants, name, length, NULL);
+    if (result != NULL) {
+        insertTableMapTenants(tenants->table, tenants->tableSize, result);
+    }
+    return result;
+}
+
+/** @brief Tworzy strukturę.
+ * @param[in,out] input         - wskaźnik na plik z poleceniami tekstowymi;
+ * @param[in,out] defaultMap    - wskaźnik na mapę wierszy bez przedrostka
+ *                                (nie jest usuwana z resztą struktury);
+ * @param[in] threadsCount      - liczba wątków wykonujących polecenia;
+ * @param[in] setup             - funkcja ustawiająca opcje nowych map;
+ * @param[in] argument          - wskaźnik przekazywany do @p setup.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci lub utworzyć wątków.
+ */
+MapTenants *newMapTenants(FILE *input, Map *defaultMap, uint32_t threadsCount,
+                          MapTenantSetup setup, void *argument) {
+    assert(input && defaultMap && setup);
+    assert(threadsCount > 0);
+
+    MapTenants *result = calloc(1, sizeof(MapTenants));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    result->input = input;
+    result->setup = setup;
+    result->argument = argument;
+    result->threadsCount = threadsCount;
+    result->tenantsMemorySize = MAP_TENANTS_TABLE_SIZE;
+    result->tableSize = MAP_TENANTS_TABLE_SIZE;
+    result->pool = newThreadPool(threadsCount);
+    result->parsers = calloc(threadsCount, sizeof(CommandParser *));
+    result->tenants = malloc(sizeof(Tenant *) * result->tenantsMemorySize);
+    result->scheduled = malloc(sizeof(Tenant *) * result->tenantsMemorySize);
+    result->table = calloc(result->tableSize, sizeof(Tenant *));
+    result->records = malloc(sizeof(TenantRecord) * MAP_TENANTS_BATCH_SIZE);
+    if (result->pool == NULL || result->parsers == NULL ||
+            result->tenants == NULL || result->scheduled == NULL ||
+            result->table == NULL || result->records == NULL ||
+            newTenantMapTenants(result, NULL, 0, defaultMap) == NULL) {
+        deleteMapTenants(result);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < threadsCount; i++) {
+        result->parsers[i] = newCommandParser(NULL);
+        if (result->parsers[i] == NULL) {
+            deleteMapTenants(result);
+            return NULL;
+        }
+    }
+
+    return result;
+}
+
+/** @brief Usuwa strukturę razem z utworzonymi mapami.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] tenants           - wskaźnik na usuwaną strukturę.
+ */
+void deleteMapTenants(MapTenants *tenants) {
+    if (tenants == NULL) {
+        return;
+    }
+
+    deleteThreadPool(tenants->pool);
+    if (tenants->parsers != NULL) {
+        for (uint32_t i = 0; i < tenants->threadsCount; i++) {
+            deleteCommandParser(tenants->parsers[i]);
+        }
+    }
+    for (uint32_t i = 0; i < tenants->tenantsCount; i++) {
+        deleteTenantMapTenants(tenants->tenants[i]);
+    }
+
+    free(tenants->parsers);
+    free(tenants->tenants);
+    free(tenants->scheduled);
+    free(tenants->table);
+    free(tenants->records);
+    free(tenants->text);
+    free(tenants->line);
+    free(tenants);
+}
+
+/** @brief Przypisuje wiersz porcji do mapy.
+ * Oddziela przedrostek przestrzeni nazw i dopisuje wiersz do wierszy mapy
+ * w porcji.
+ * @param[in,out] tenants       - wskaźnik na strukturę;
+ * @param[in,out] record        - wskaźnik na wiersz.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool assignRecordMapTenants(MapTenants *tenants, TenantRecord *record) {
+    assert(tenants && record);
+
+    const char *line = tenants->text + record->lineOffset;
+    const char *end = line;
+    while (*end != ':' && *end != ';' && *end != '\n' && *end != 0) {
+        end++;
+    }
+
+    Tenant *tenant = tenants->tenants[0];
+    if (*end == ':' && *line != '#') {
+        tenant = NULL;
+        bool isValid = end != line;
+        for (const char *i = line; i < end; i++) {
+            if (0 <= *i && *i <= 31) {
+                isValid = false;
+            }
+        }
+
+        if (isValid) {
+            tenant = findTenantMapTenants(tenants, line, end - line);
+            if (tenant == NULL) {
+                return false;
+            }
+        }
+        record->lineOffset += end + 1 - line;
+    }
+
+    record->tenant = tenant;
+    if (tenant == NULL) {
+        record->result = 1;
+        return true;
+    }
+
+    if (tenant->firstRecord == NO_RECORD) {
+        tenant->firstRecord = record - tenants->records;
+        tenants->scheduled[tenants->scheduledCount++] = tenant;
+    } else {
+        tenants->records[tenant->lastRecord].next = record - tenants->records;
+    }
+    tenant->lastRecord = record - tenants->records;
+    return true;
+}
+
+/** @brief Wczytuje porcję wierszy.
+ * Wiersze kopiowane są do wspólnego bufora porcji; wiersz niezakończony
+ * znakiem '\n' dostaje ten znak na końcu.
+ * @param[in,out] tenants       - wskaźnik na strukturę.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool readBatchMapTenants(MapTenants *tenants) {
+    assert(tenants);
+
+    tenants->recordsCount = 0;
+    tenants->textSize = 0;
+    tenants->scheduledCount = 0;
+
+    while (tenants->recordsCount < MAP_TENANTS_BATCH_SIZE) {
+        ssize_t length = getline(&tenants->line, &tenants->lineMemorySize,
+                                 tenants->input);
+        if (length <= 0) {
+            tenants->isEnd = true;
+            return true;
+        }
+
+        if (!reserveMapTenants(&tenants->text, &tenants->textMemorySize,
+                               tenants->textSize + length + 1)) {
+            return false;
+        }
+
+        TenantRecord *record = &tenants->records[tenants->recordsCount++];
+        record->lineOffset = tenants->textSize;
+        record->lineNumber = ++tenants->lineNumber;
+        record->next = NO_RECORD;
+        record->isTerminated = tenants->line[length - 1] == '\n';
+        record->hasDescription = false;
+        record->result = 2;
+
+        memcpy(tenants->text + tenants->textSize, tenants->line, length);
+        tenants->textSize += length;
+        if (!record->isTerminated) {
+            tenants->text[tenants->textSize++] = '\n';
+        }
+
+        if (!assignRecordMapTenants(tenants, record)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** @brief Zapisuje opis drogi krajowej w wynikach mapy.
+ * @param[in,out] tenant        - wskaźnik na mapę;
+ * @param[in,out] record        - wskaźnik na wiersz;
+ * @param[in] routeId           - numer drogi krajowej.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool describeRouteMapTenants(Tenant *tenant, TenantRecord *record,
+                             unsigned routeId) {
+    assert(tenant && record);
+
+    if (!reserveMapTenants(&tenant->output, &tenant->outputMemorySize,
+                           tenant->outputSize +
+                           MAP_TENANTS_DESCRIPTION_SIZE)) {
+        return false;
+    }
+
+    size_t freeSize = tenant->outputMemorySize - tenant->outputSize;
+    size_t size = writeRouteDescription(tenant->map, routeId,
+                                        tenant->output + tenant->outputSize,
+                                        freeSize);
+    if (size >= freeSize) {
+        if (!reserveMapTenants(&tenant->output, &tenant->outputMemorySize,
+                               tenant->outputSize + size + 1)) {
+            return false;
+        }
+        writeRouteDescription(tenant->map, routeId,
+                              tenant->output + tenant->outputSize, size + 1);
+    }
+
+    record->hasDescription = true;
+    record->outputOffset = tenant->outputSize;
+    record->outputSize = size;
+    tenant->outputSize += size;
+    return true;
+}
+
+/** @brief Zapisuje wynik zapytania w wynikach mapy.
+ * @param[in,out] tenant        - wskaźnik na mapę;
+ * @param[in,out] record        - wskaźnik na wiersz;
+ * @param[in] command           - wskaźnik na zapytanie
+ *                                (@ref isQueryCommandMap).
+ * @return Wartość @p 0 jeśli zapisano wynik, wartość @p 1 jeśli zapytanie
+ * zakończyło się błędem lub wartość @p 2 jeśli nie udało się zaalokować
+ * pamięci na wyniki.
+ */
+int queryMapTenants(Tenant *tenant, TenantRecord *record,
+                    const Command *command) {
+    assert(tenant && record && command);
+
+    char *result = (char *) queryCommandMap(tenant->map, command);
+    if (result == NULL) {
+        return 1;
+    }
+
+    size_t size = strlen(result);
+    if (!reserveMapTenants(&tenant->output, &tenant->outputMemorySize,
+                           tenant->outputSize + size)) {
+        free(result);
+        return 2;
+    }
+
+    memcpy(tenant->output + tenant->outputSize, result, size);
+    free(result);
+
+    record->hasDescription = true;
+    record->outputOffset = tenant->outputSize;
+    record->outputSize = size;
+    tenant->outputSize += size;
+    return 0;
+}
+
+/** @brief Wykonuje wiersz na mapie.
+ * @param[in,out] tenants       - wskaźnik na strukturę;
+ * @param[in,out] parser        - wskaźnik na parser wątku;
+ * @param[in,out] record        - wskaźnik na wiersz.
+ * @return Wynik jak w @ref nextCommandParser, przy czym wartość @p 1
+ * oznacza także błąd wykonania polecenia.
+ */
+int executeRecordMapTenants(MapTenants *tenants, CommandParser *parser,
+                            TenantRecord *record) {
+    assert(tenants && parser && record);
+
+    Command command;
+    int result = parseLineCommandParser(parser, &command,
+                                        tenants->text + record->lineOffset,
+                                        record->isTerminated);
+    if (result != 0) {
+        return result;
+    }
+
+    if (command.type == COMMAND_GET_ROUTE_DESCRIPTION) {
+        return describeRouteMapTenants(record->tenant, record,
+                                       command.routeId) ? 0 : 2;
+    }
+    if (isQueryCommandMap(&command)) {
+        return queryMapTenants(record->tenant, record, &command);
+    }
+
+    return executeCommandMap(record->tenant->map, &command) ? 0 : 1;
+}
+
+/** @brief Wykonuje wiersze jednej mapy w porcji.
+ * Zadanie puli wątków; mapy z wierszami w porcji są zadaniami.
+ * @param[in,out] argument      - wskaźnik na @ref MapTenants;
+ * @param[in] taskIndex         - numer mapy w @ref MapTenants.scheduled;
+ * @param[in] threadIndex       - numer wątku.
+ */
+void executeTenantMapTenants(void *argument, uint32_t taskIndex,
+                             uint32_t threadIndex) {
+    MapTenants *tenants = argument;
+    Tenant *tenant = tenants->scheduled[taskIndex];
+    CommandParser *parser = tenants->parsers[threadIndex];
+
+    tenant->outputSize = 0;
+    uint32_t index = tenant->firstRecord;
+    while (index != NO_RECORD) {
+        TenantRecord *record = &tenants->records[index];
+        uint64_t start = nanosecondsJournal();
+        record->result = executeRecordMapTenants(tenants, parser, record);
+        uint64_t duration = nanosecondsJournal() - start;
+
+        tenant->commandsCount++;
+        tenant->nanoseconds += duration;
+        if (duration > tenant->maxNanoseconds) {
+            tenant->maxNanoseconds = duration;
+        }
+
+        if (record->result == 2) {
+            break;
+        }
+        index = record->next;
+    }
+
+    tenant->firstRecord = NO_RECORD;
+    tenant->lastRecord = NO_RECORD;
+}
+
+/** @brief Obsługuje porcję wierszy wejścia.
+ * Wiersz bez przedrostka obsługiwany jest na mapie domyślnej jak
+ * w @ref nextCommandTextInterface, a wiersz z przedrostkiem na mapie jego
+ * przestrzeni nazw (bez przedrostka). Przedrostkiem jest niepusty napis
+ * przed pierwszym dwukropkiem, jeśli dwukropek występuje przed pierwszym
+ * średnikiem, a wiersz nie jest komentarzem. Wiersz z pustym przedrostkiem
+ * lub przedrostkiem zawierającym znaki o kodach od 0 do 31 jest błędny.
+ * Komunikaty ERROR zawierają numery wierszy wejścia.
+ * @param[in,out] tenants       - wskaźnik na strukturę.
+ * @return Wartość @p 0 jeśli wejście się nie skończyło,
+ * wartość @p 2 jeśli nie udało się zaalokować pamięci lub
+ * wartość @p EOF jeśli wejście się skończyło.
+ */
+int nextMapTenants(MapTenants *tenants) {
+    assert(tenants);
+
+    if (tenants->isEnd) {
+        return EOF;
+    }
+
+    bool isRead = readBatchMapTenants(tenants);
+    runThreadPool(tenants->pool, tenants->scheduledCount,
+                  executeTenantMapTenants, tenants);
+
+    for (uint32_t i = 0; i < tenants->recordsCount; i++) {
+        TenantRecord *record = &tenants->records[i];
+        if (record->result == 2) {
+            return 2;
+        }
+        if (record->result == 1) {
+            fprintf(stderr, "ERROR %" PRIu32 "\n", record->lineNumber);
+        } else if (record->hasDescription) {
+            fwrite(record->tenant->output + record->outputOffset, 1,
+                   record->outputSize, stdout);
+            putchar('\n');
+        }
+    }
+
+    if (!isRead) {
+        return 2;
+    }
+    return tenants->isEnd ? EOF : 0;
+}
+
+/** @brief Liczba map.
+ * @param[in] tenants           - wskaźnik na strukturę.
+ * @return Liczba map, wliczając mapę domyślną.
+ */
+uint32_t countMapTenants(const MapTenants *tenants) {
+    assert(tenants);
+
+    return tenants->tenantsCount;
+}
+
+/** @brief Liczniki mapy.
+ * Mapy numerowane są w kolejności utworzenia; mapa domyślna ma numer @p 0.
+ * @param[in] tenants           - wskaźnik na strukturę;
+ * @param[in] index             - numer mapy.
+ * @return Liczniki mapy.
+ */
+MapTenantStatistics getStatisticsMapTenants(const MapTenants *tenants,
+                                            uint32_t index) {
+    assert(tenants && index < tenants->tenantsCount);
+
+    const Tenant *tenant = tenants->tenants[index];
+    MapTenantStatistics result;
+    result.name = tenant->name == NULL ? "" : tenant->name;
+    result.commandsCount = tenant->commandsCount;
+    result.nanoseconds = tenant->nanoseconds;
+    result.maxNanoseconds = tenant->maxNanoseconds;
+    result.memoryUsage = memoryUsageMap(tenant->map) +
+                         tenant->outputMemorySize;
+    return result;
+}
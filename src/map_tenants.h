@@ -0,0 +1,98 @@
+/** @file
+ * Interfejs klasy obsługującej wiele niezależnych map w jednym procesie.
+ *
+ * Każdy wiersz wejścia może zaczynać się przedrostkiem przestrzeni nazw
+ * zakończonym dwukropkiem (np. mazowsze:addRoad;A;B;1;2020), który wybiera
+ * mapę; wiersze bez przedrostka trafiają do mapy domyślnej. Mapa jest
+ * tworzona przy pierwszym wierszu jej przestrzeni nazw. Wiersze czytane są
+ * porcjami; polecenia jednej mapy wykonywane są po kolei, a różnych map
+ * równolegle przez wspólną pulę wątków. Wyniki wypisywane są w kolejności
+ * wejścia, więc są takie same, jak przy wykonaniu wierszy po kolei.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef MAP_TENANTS_H
+#define MAP_TENANTS_H
+
+#include "map.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Struktura przechowująca mapy przestrzeni nazw.
+ */
+typedef struct MapTenants MapTenants;
+
+/** @brief Funkcja ustawiająca opcje nowej mapy.
+ * @param[in,out] map           - wskaźnik na nową mapę;
+ * @param[in] argument          - wskaźnik przekazany do @ref newMapTenants.
+ * @return Wartość @p true lub @p false, jeśli nie udało się ustawić opcji.
+ */
+typedef bool (*MapTenantSetup)(Map *map, void *argument);
+
+/**
+ * Struktura przechowująca liczniki mapy przestrzeni nazw.
+ */
+typedef struct MapTenantStatistics {
+    const char *name;               ///< przestrzeń nazw (pusta dla domyślnej)
+    uint64_t commandsCount;         ///< liczba wykonanych wierszy
+    uint64_t nanoseconds;           ///< łączny czas wierszy
+    uint64_t maxNanoseconds;        ///< najdłuższy czas wiersza
+    size_t memoryUsage;             ///< pamięć mapy (@ref memoryUsageMap)
+} MapTenantStatistics;
+
+/** @brief Tworzy strukturę.
+ * @param[in,out] input         - wskaźnik na plik z poleceniami tekstowymi;
+ * @param[in,out] defaultMap    - wskaźnik na mapę wierszy bez przedrostka
+ *                                (nie jest usuwana z resztą struktury);
+ * @param[in] threadsCount      - liczba wątków wykonujących polecenia;
+ * @param[in] setup             - funkcja ustawiająca opcje nowych map;
+ * @param[in] argument          - wskaźnik przekazywany do @p setup.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci lub utworzyć wątków.
+ */
+MapTenants *newMapTenants(FILE *input, Map *defaultMap, uint32_t threadsCount,
+                          MapTenantSetup setup, void *argument);
+
+/** @brief Usuwa strukturę razem z utworzonymi mapami.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] tenants           - wskaźnik na usuwaną strukturę.
+ */
+void deleteMapTenants(MapTenants *tenants);
+
+/** @brief Obsługuje porcję wierszy wejścia.
+ * Wiersz bez przedrostka obsługiwany jest na mapie domyślnej jak
+ * w @ref nextCommandTextInterface, a wiersz z przedrostkiem na mapie jego
+ * przestrzeni nazw (bez przedrostka). Przedrostkiem jest niepusty napis
+ * przed pierwszym dwukropkiem, jeśli dwukropek występuje przed pierwszym
+ * średnikiem, a wiersz nie jest komentarzem. Wiersz z pustym przedrostkiem
+ * lub przedrostkiem zawierającym znaki o kodach od 0 do 31 jest błędny.
+ * Komunikaty ERROR zawierają numery wierszy wejścia.
+ * @param[in,out] tenants       - wskaźnik na strukturę.
+ * @return Wartość @p 0 jeśli wejście się nie skończyło,
+ * wartość @p 2 jeśli nie udało się zaalokować pamięci lub
+ * wartość @p EOF jeśli wejście się skończyło.
+ */
+int nextMapTenants(MapTenants *tenants);
+
+/** @brief Liczba map.
+ * @param[in] tenants           - wskaźnik na strukturę.
+ * @return Liczba map, wliczając mapę domyślną.
+ */
+uint32_t countMapTenants(const MapTenants *tenants);
+
+/** @brief Liczniki mapy.
+ * Mapy numerowane są w kolejności utworzenia; mapa domyślna ma numer @p 0.
+ * @param[in] tenants           - wskaźnik na strukturę;
+ * @param[in] index             - numer mapy.
+ * @return Liczniki mapy.
+ */
+MapTenantStatistics getStatisticsMapTenants(const MapTenants *tenants,
+                                            uint32_t index);
+
+#endif // MAP_TENANTS_H
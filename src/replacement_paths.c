@@ -0,0 +1,286 @@
+/** @file
+ * Implementacja interfejsu klasy przechowującej indeks objazdów odcinków
+ * drogi krajowej.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "replacement_paths.h"
+
+#include <stdlib.h>
+#include <assert.h>
+
+/** @brief Tworzy strukturę.
+ * Tworzy pusty indeks; odcinki drogi krajowej dodaje
+ * @ref syncReplacementPaths.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci.
+ */
+ReplacementPaths *newReplacementPaths(void) {
+    return calloc(1, sizeof(ReplacementPaths));
+}
+
+/** @brief Usuwa objazdy z indeksu.
+ * Indeks jest potem pusty.
+ * @param[in,out] paths         - wskaźnik na indeks.
+ */
+void clearReplacementPaths(ReplacementPaths *paths) {
+    for (uint32_t i = 0; i < paths->pathsCount; i++) {
+        if (paths->paths[i].detour != NULL) {
+            deleteList(paths->paths[i].detour, false);
+        }
+    }
+    free(paths->paths);
+
+    paths->paths = NULL;
+    paths->pathsCount = 0;
+}
+
+/** @brief Usuwa strukturę.
+ * Usuwa też listy objazdów. Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] paths             - wskaźnik na usuwaną strukturę.
+ */
+void deleteReplacementPaths(ReplacementPaths *paths) {
+    if (paths == NULL) {
+        return;
+    }
+
+    clearReplacementPaths(paths);
+    free(paths);
+}
+
+/** @brief Porównuje numery miast.
+ * Funkcja porównująca dla qsort.
+ * @param[in] a                 - wskaźnik na pierwszy numer;
+ * @param[in] b                 - wskaźnik na drugi numer.
+ * @return Liczba ujemna, zero lub dodatnia, jeśli pierwszy numer jest
+ * odpowiednio mniejszy, równy lub większy od drugiego.
+ */
+int compareIdsReplacementPaths(const void *a, const void *b) {
+    uint32_t id1 = *(const uint32_t *)a;
+    uint32_t id2 = *(const uint32_t *)b;
+
+    return (id1 > id2) - (id1 < id2);
+}
+
+/** @brief Unieważnia objazd.
+ * @param[in,out] paths         - wskaźnik na indeks;
+ * @param[in,out] path          - wskaźnik na objazd z indeksu.
+ */
+void invalidatePathReplacementPaths(ReplacementPaths *paths,
+                                    ReplacementPath *path) {
+    if (!path->isStale) {
+        path->isStale = true;
+        paths->invalidationsCount++;
+    }
+}
+
+/** @brief Sprawdza czy objazd przechodzi przez miasto drogi krajowej.
+ * @param[in] path              - wskaźnik na objazd;
+ * @param[in] ids               - wskaźnik na rosnące numery miast drogi
+ *                                krajowej;
+ * @param[in] idsCount          - liczba miast drogi krajowej.
+ * @return Wartość @p true, jeśli któreś z miast objazdu poza jego końcami
+ * leży na drodze krajowej, lub @p false w przeciwnym przypadku.
+ */
+bool crossesRouteReplacementPaths(const ReplacementPath *path,
+                                  const uint32_t *ids, uint32_t idsCount) {
+    ListIterator *iterator = path->detour->begin->next;
+    while (iterator->next != path->detour->end) {
+        City *city = iterator->data;
+        if (bsearch(&city->id, ids, idsCount, sizeof(uint32_t),
+                    compareIdsReplacementPaths) != NULL) {
+            return true;
+        }
+        iterator = iterator->next;
+    }
+
+    return false;
+}
+
+/** @brief Uzgadnia indeks z miastami drogi krajowej.
+ * Odcinki, które pozostały na drodze krajowej, zachowują objazdy, chyba że
+ * przechodzą one przez jej nowe miasta. Nowe odcinki dostają nieaktualne
+ * objazdy. Nic nie robi, jeśli droga krajowa się nie zmieniła.
+ * @param[in,out] paths         - wskaźnik na indeks;
+ * @param[in] cities            - wskaźnik na listę miast drogi krajowej,
+ *                                która zawiera wszystkie miasta z chwili
+ *                                poprzedniego uzgodnienia w tej samej
+ *                                kolejności.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci; indeks jest wtedy pusty.
+ */
+bool syncReplacementPaths(ReplacementPaths *paths, List *cities) {
+    assert(paths);
+    assert(cities);
+
+    /* Miasta są tylko dodawane, więc droga krajowa zmieniła się wtedy
+     * i tylko wtedy, gdy zmieniła się liczba odcinków. */
+    uint32_t citiesCount = sizeList(cities);
+    uint32_t pathsCount = citiesCount == 0 ? 0 : citiesCount - 1;
+    if (pathsCount == paths->pathsCount) {
+        return true;
+    }
+
+    ReplacementPath *result = malloc(sizeof(ReplacementPath) *
+                                     (pathsCount + 1));
+    uint32_t *ids = malloc(sizeof(uint32_t) * (citiesCount + 1));
+    if (result == NULL || ids == NULL) {
+        free(result);
+        free(ids);
+        clearReplacementPaths(paths);
+        return false;
+    }
+
+    uint32_t idsCount = 0;
+    for (ListIterator *iterator = cities->begin; iterator != cities->end;
+         iterator = iterator->next) {
+        ids[idsCount++] = ((City *)iterator->data)->id;
+    }
+    qsort(ids, idsCount, sizeof(uint32_t), compareIdsReplacementPaths);
+
+    /* Odcinek zastąpiony objazdem jest jedynym starym odcinkiem, który
+     * zaczyna się w tym samym mieście co nowy, a się od niego różni. */
+    uint32_t old = 0;
+    ListIterator *iterator = cities->begin;
+    for (uint32_t i = 0; i < pathsCount; i++) {
+        ReplacementPath *path = &result[i];
+        path->city1 = iterator->data;
+        path->city2 = iterator->next->data;
+        path->detour = NULL;
+        path->isStale = true;
+
+        if (old < paths->pathsCount &&
+                paths->paths[old].city1 == path->city1 &&
+                paths->paths[old].city2 != path->city2) {
+            if (paths->paths[old].detour != NULL) {
+                deleteList(paths->paths[old].detour, false);
+            }
+            old++;
+        } else if (old < paths->pathsCount &&
+                   paths->paths[old].city1 == path->city1) {
+            *path = paths->paths[old++];
+            if (path->detour != NULL &&
+                    crossesRouteReplacementPaths(path, ids, idsCount)) {
+                invalidatePathReplacementPaths(paths, path);
+            }
+        }
+
+        iterator = iterator->next;
+    }
+
+    for (; old < paths->pathsCount; old++) {
+        if (paths->paths[old].detour != NULL) {
+            deleteList(paths->paths[old].detour, false);
+        }
+    }
+    free(paths->paths);
+    free(ids);
+
+    paths->paths = result;
+    paths->pathsCount = pathsCount;
+
+    return true;
+}
+
+/** @brief Unieważnia wszystkie objazdy.
+ * @param[in,out] paths         - wskaźnik na indeks.
+ */
+void invalidateReplacementPaths(ReplacementPaths *paths) {
+    assert(paths);
+
+    for (uint32_t i = 0; i < paths->pathsCount; i++) {
+        invalidatePathReplacementPaths(paths, &paths->paths[i]);
+    }
+}
+
+/** @brief Odnotowuje usunięcie odcinka drogi.
+ * Unieważnia objazdy przechodzące przez usunięty odcinek.
+ * @param[in,out] paths         - wskaźnik na indeks;
+ * @param[in] city1             - wskaźnik na pierwsze miasto odcinka;
+ * @param[in] city2             - wskaźnik na drugie miasto odcinka.
+ */
+void removedRoadReplacementPaths(ReplacementPaths *paths, City *city1,
+                                 City *city2) {
+    assert(paths);
+
+    for (uint32_t i = 0; i < paths->pathsCount; i++) {
+        ReplacementPath *path = &paths->paths[i];
+        if (path->isStale || path->detour == NULL) {
+            continue;
+        }
+
+        ListIterator *iterator = path->detour->begin;
+        while (iterator->next != path->detour->end) {
+            City *from = iterator->data;
+            City *to = iterator->next->data;
+            if ((from == city1 && to == city2) ||
+                    (from == city2 && to == city1)) {
+                invalidatePathReplacementPaths(paths, path);
+                break;
+            }
+            iterator = iterator->next;
+        }
+    }
+}
+
+/** @brief Znajduje objazd odcinka drogi krajowej.
+ * @param[in] paths             - wskaźnik na indeks;
+ * @param[in] city1             - wskaźnik na pierwsze miasto odcinka;
+ * @param[in] city2             - wskaźnik na drugie miasto odcinka.
+ * @return Wskaźnik na objazd odcinka (w dowolnej kolejności miast) lub NULL,
+ * jeśli indeks go nie zawiera.
+ */
+ReplacementPath *findReplacementPaths(const ReplacementPaths *paths,
+                                      City *city1, City *city2) {
+    assert(paths);
+
+    for (uint32_t i = 0; i < paths->pathsCount; i++) {
+        ReplacementPath *path = &paths->paths[i];
+        if ((path->city1 == city1 && path->city2 == city2) ||
+                (path->city1 == city2 && path->city2 == city1)) {
+            return path;
+        }
+    }
+
+    return NULL;
+}
+
+/** @brief Dodaje liczniki indeksu do sumy.
+ * @param[in] paths             - wskaźnik na indeks;
+ * @param[in,out] statistics    - wskaźnik na sumowane liczniki.
+ */
+void addStatisticsReplacementPaths(const ReplacementPaths *paths,
+                                   ReplacementPathsStatistics *statistics) {
+    assert(paths);
+    assert(statistics);
+
+    statistics->routesCount++;
+    statistics->pathsCount += paths->pathsCount;
+    for (uint32_t i = 0; i < paths->pathsCount; i++) {
+        statistics->stalePathsCount += paths->paths[i].isStale;
+    }
+    statistics->hitsCount += paths->hitsCount;
+    statistics->buildsCount += paths->buildsCount;
+    statistics->invalidationsCount += paths->invalidationsCount;
+    statistics->memoryUsage += memoryUsageReplacementPaths(paths);
+}
+
+/** @brief Pamięć zajmowana przez indeks.
+ * @param[in] paths             - wskaźnik na indeks.
+ * @return Liczba bajtów struktury, tablicy objazdów i ich list.
+ */
+size_t memoryUsageReplacementPaths(const ReplacementPaths *paths) {
+    assert(paths);
+
+    size_t result = sizeof(ReplacementPaths) +
+                    sizeof(ReplacementPath) * paths->pathsCount;
+    for (uint32_t i = 0; i < paths->pathsCount; i++) {
+        if (paths->paths[i].detour != NULL) {
+            result += memoryUsageList(paths->paths[i].detour);
+        }
+    }
+
+    return result;
+}
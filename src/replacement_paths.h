@@ -0,0 +1,128 @@
+/** @file
+ * Interfejs klasy przechowującej indeks objazdów odcinków drogi krajowej.
+ *
+ * Dla każdego odcinka drogi krajowej indeks przechowuje objazd, który
+ * wyznaczyłaby funkcja @ref findNewRouteAfterRemovingRoad po usunięciu tego
+ * odcinka. Objazd jest aktualny, dopóki zmiany mapy nie mogą zmienić wyniku
+ * wyszukiwania: usunięcie innego odcinka unieważnia tylko objazdy przez ten
+ * odcinek, a zmiana drogi krajowej tylko objazdy przez jej nowe miasta.
+ * Dodanie lub remont odcinka może poprawić dowolny objazd, więc unieważnia
+ * wszystkie. Unieważnione objazdy wyznaczane są ponownie dopiero wtedy, gdy
+ * są potrzebne. Miasta drogi krajowej mogą być tylko dodawane.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef REPLACEMENT_PATHS_H
+#define REPLACEMENT_PATHS_H
+
+#include "city.h"
+#include "list.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Struktura przechowująca objazd jednego odcinka drogi krajowej.
+ */
+typedef struct ReplacementPath {
+    City *city1;                    ///< wcześniejsze miasto odcinka
+    City *city2;                    ///< późniejsze miasto odcinka
+    List *detour;                   ///< miasta objazdu od @p city1 do
+                                    ///  @p city2 lub NULL, jeśli nie udało
+                                    ///  się go jednoznacznie wyznaczyć
+    bool isStale;                   ///< czy objazd trzeba wyznaczyć ponownie
+} ReplacementPath;
+
+/**
+ * Struktura przechowująca indeks objazdów odcinków drogi krajowej.
+ */
+typedef struct ReplacementPaths {
+    ReplacementPath *paths;         ///< objazdy kolejnych odcinków
+    uint32_t pathsCount;            ///< liczba odcinków
+    uint64_t hitsCount;             ///< liczba objazdów odczytanych z indeksu
+    uint64_t buildsCount;           ///< liczba wyznaczonych objazdów
+    uint64_t invalidationsCount;    ///< liczba unieważnionych objazdów
+} ReplacementPaths;
+
+/**
+ * Struktura przechowująca liczniki indeksów objazdów.
+ */
+typedef struct ReplacementPathsStatistics {
+    uint64_t routesCount;           ///< liczba dróg krajowych z indeksem
+    uint64_t pathsCount;            ///< liczba odcinków w indeksach
+    uint64_t stalePathsCount;       ///< liczba nieaktualnych objazdów
+    uint64_t hitsCount;             ///< liczba objazdów odczytanych z indeksu
+    uint64_t buildsCount;           ///< liczba wyznaczonych objazdów
+    uint64_t invalidationsCount;    ///< liczba unieważnionych objazdów
+    size_t memoryUsage;             ///< liczba bajtów indeksów
+} ReplacementPathsStatistics;
+
+/** @brief Tworzy strukturę.
+ * Tworzy pusty indeks; odcinki drogi krajowej dodaje
+ * @ref syncReplacementPaths.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci.
+ */
+ReplacementPaths *newReplacementPaths(void);
+
+/** @brief Usuwa strukturę.
+ * Usuwa też listy objazdów. Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] paths             - wskaźnik na usuwaną strukturę.
+ */
+void deleteReplacementPaths(ReplacementPaths *paths);
+
+/** @brief Uzgadnia indeks z miastami drogi krajowej.
+ * Odcinki, które pozostały na drodze krajowej, zachowują objazdy, chyba że
+ * przechodzą one przez jej nowe miasta. Nowe odcinki dostają nieaktualne
+ * objazdy. Nic nie robi, jeśli droga krajowa się nie zmieniła.
+ * @param[in,out] paths         - wskaźnik na indeks;
+ * @param[in] cities            - wskaźnik na listę miast drogi krajowej,
+ *                                która zawiera wszystkie miasta z chwili
+ *                                poprzedniego uzgodnienia w tej samej
+ *                                kolejności.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci; indeks jest wtedy pusty.
+ */
+bool syncReplacementPaths(ReplacementPaths *paths, List *cities);
+
+/** @brief Unieważnia wszystkie objazdy.
+ * @param[in,out] paths         - wskaźnik na indeks.
+ */
+void invalidateReplacementPaths(ReplacementPaths *paths);
+
+/** @brief Odnotowuje usunięcie odcinka drogi.
+ * Unieważnia objazdy przechodzące przez usunięty odcinek.
+ * @param[in,out] paths         - wskaźnik na indeks;
+ * @param[in] city1             - wskaźnik na pierwsze miasto odcinka;
+ * @param[in] city2             - wskaźnik na drugie miasto odcinka.
+ */
+void removedRoadReplacementPaths(ReplacementPaths *paths, City *city1,
+                                 City *city2);
+
+/** @brief Znajduje objazd odcinka drogi krajowej.
+ * @param[in] paths             - wskaźnik na indeks;
+ * @param[in] city1             - wskaźnik na pierwsze miasto odcinka;
+ * @param[in] city2             - wskaźnik na drugie miasto odcinka.
+ * @return Wskaźnik na objazd odcinka (w dowolnej kolejności miast) lub NULL,
+ * jeśli indeks go nie zawiera.
+ */
+ReplacementPath *findReplacementPaths(const ReplacementPaths *paths,
+                                      City *city1, City *city2);
+
+/** @brief Dodaje liczniki indeksu do sumy.
+ * @param[in] paths             - wskaźnik na indeks;
+ * @param[in,out] statistics    - wskaźnik na sumowane liczniki.
+ */
+void addStatisticsReplacementPaths(const ReplacementPaths *paths,
+                                   ReplacementPathsStatistics *statistics);
+
+/** @brief Pamięć zajmowana przez indeks.
+ * @param[in] paths             - wskaźnik na indeks.
+ * @return Liczba bajtów struktury, tablicy objazdów i ich list.
+ */
+size_t memoryUsageReplacementPaths(const ReplacementPaths *paths);
+
+#endif // REPLACEMENT_PATHS_H
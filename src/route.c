@@ -6,15 +6,16 @@
  */
 
 #include "route.h"
+#include "bidirectional_search.h"
+#include "hierarchy_search.h"
 #include "heap.h"
 #include "road.h"
 #include "string_builder.h"
+#include "search_cache.h"
 
 #include <stdlib.h>
 #include <assert.h>
 
-#define INFINITY 1000000000000000ll ///< stała oznaczająca nieskończoność
-
 /** @brief Usuwa strukturę.
  * @param[in,out] route         - wskaźnik na drogę krajową do usunięcia.
  */
@@ -22,6 +23,7 @@ void deleteRouteModule(Route *route) {
     assert(route);
 
     deleteList(route->cities, false);
+    deleteReplacementPaths(route->replacementPaths);
     free(route);
 }
 
@@ -59,6 +61,58 @@ int64_t minInt64_t(int64_t x, int64_t y) {
     }
 }
 
+/** @brief Maksimum dwóch liczb.
+ * @param x                     - pierwsza liczba;
+ * @param y                     - druga liczba.
+ * @return Maksimum dwóch liczb.
+ */
+int64_t maxInt64_t(int64_t x, int64_t y) {
+    if (x > y) {
+        return x;
+    } else {
+        return y;
+    }
+}
+
+/** @brief Dolne ograniczenie na odległość miasta od celu algorytmu A*.
+ * Ograniczenia są zapamiętywane w stanie algorytmu do końca wyszukiwania.
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry;
+ * @param[in] city              - wskaźnik na miasto;
+ * @param[in] to                - wskaźnik na docelowe miasto;
+ * @param[in] to2               - wskaźnik na docelowe miasto lub NULL.
+ * @return Dolne ograniczenie na odległość do bliższego z miast docelowych lub
+ * @ref INFINITY, jeśli żadne z nich nie jest osiągalne.
+ */
+int64_t heuristicRouteModule(SearchState *state, City *city, City *to,
+                             City *to2) {
+    if (state->heuristic[city->id] < 0) {
+        int64_t bound = lowerBoundLandmarkIndex(state->landmarks, city, to);
+        if (to2 != NULL) {
+            bound = minInt64_t(bound, lowerBoundLandmarkIndex(state->landmarks,
+                                                              city, to2));
+        }
+        state->heuristic[city->id] = bound;
+    }
+
+    return state->heuristic[city->id];
+}
+
+/** @brief Sprawdza czy algorytm dijkstry używa ograniczeń odległości do celu.
+ * Przy dwóch miastach docelowych drugie przejście musi obsłużyć miasta w tej
+ * samej kolejności co algorytm dijkstry.
+ * @param[in] state             - wskaźnik na stan algorytmu dijkstry;
+ * @param[in] to                - wskaźnik na docelowe miasto lub NULL;
+ * @param[in] to2               - wskaźnik na docelowe miasto lub NULL;
+ * @param[in] knownOldestRoad   - rok, od którego mamy zacząć uwzględniać odcinki.
+ * @return Wartość @p true, jeśli algorytm kończy się po obsłużeniu miast
+ * docelowych, lub @p false, jeśli liczy drogi do wszystkich miast.
+ */
+bool isGoalDirectedRouteModule(const SearchState *state, City *to, City *to2,
+                               int64_t knownOldestRoad) {
+    return state->engine == ALT_SEARCH_ENGINE && state->landmarks != NULL &&
+           to != NULL && (knownOldestRoad == 0 || to2 == NULL);
+}
+
 /** @brief Symuluje algorytm dijsktry.
  * Znajduję najkrótszą ścieżkę z miasta @p from do miasta @p to oraz do miasta
  * @p to2 (jeśli @p to2 != NULL). Ścieżka ta nie wchodzi do wierzchołków
@@ -68,58 +122,89 @@ int64_t minInt64_t(int64_t x, int64_t y) {
  * wypadku ścieżki porównywane są jedynie po odległość oraz pomijane są wtedy
  * odcinki drogowe, których rok budowy lub remontu jest starszy niż wartość
  * @p knownOldestRoad.
+ * Jeśli stan algorytmu wybiera algorytm A* z punktami orientacyjnymi, to
+ * przy @p knownOldestRoad == 0 miasta zdejmowane są ze sterty według sumy
+ * odległości i dolnego ograniczenia na odległość do celu, a algorytm kończy
+ * się po obsłużeniu miast docelowych. Przy @p knownOldestRoad != 0
+ * i @p to2 == NULL pomijane są miasta, które nie mogą leżeć na drodze długości
+ * @p knownDistance, a algorytm kończy się po obsłużeniu miasta @p to.
+ * Wartości dla miast docelowych są takie same jak w algorytmie dijkstry.
+ * Jeśli @p to == NULL, to liczy drogi do wszystkich miast algorytmem
+ * dijkstry.
  * @param[in] route             - wskaźnik na drogę krajową;
  * @param[in] from              - wskaźnik na miasto startowe algorytmu;
- * @param[in] to                - wskaźnik na docelowe miasto;
+ * @param[in] to                - wskaźnik na docelowe miasto lub NULL (wtedy
+ *                                @p to2 == NULL);
  * @param[in] to2               - wskaźnik na docelowe miasto lub NULL;
- * @param[in,out] listOfCities  - wskaźnik na wszystkie miasta na danej mapie.
- * @param[in] knownOldestRoad   - rok, od którego mamy zacząć uwzględniać odcinki.
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry;
+ * @param[in] knownOldestRoad   - rok, od którego mamy zacząć uwzględniać odcinki;
+ * @param[in] knownDistance     - długość szukanej drogi lub @ref INFINITY.
  * @return Wartość @p true lub @p false jeśli nie udało się zaalokować pamięci.
  */
 bool dijkstraRouteModule(Route *route, City *from, City *to, City *to2,
-                         List *listOfCities, int64_t knownOldestRoad) {
+                         SearchState *state, int64_t knownOldestRoad,
+                         int64_t knownDistance) {
     assert(route);
     assert(from);
-    assert(to);
-    assert(listOfCities);
+    assert(to || !to2);
+    assert(state);
+
+    if (!prepareSearchState(state)) {
+        return false;
+    }
 
     Heap *heap = newHeap();
     if (heap == NULL) {
         return false;
     }
 
+    int64_t *distance = state->distance;
+    int64_t *oldestRoadOnRoute = state->oldestRoadOnRoute;
+
+    bool isGoalDirected = isGoalDirectedRouteModule(state, to, to2,
+                                                    knownOldestRoad);
+    bool isAStar = isGoalDirected && knownOldestRoad == 0;
+    uint32_t targetsLeft = (to2 != NULL && to2 != to) ? 2 : 1;
+
     /* Ustawiamy odległości miast na nieskończoność. */
-    ListIterator *iterator = listOfCities->begin;
-    while (iterator != listOfCities->end) {
-        ((City *)iterator->data)->distance = INFINITY;
-        ((City *)iterator->data)->oldestRoadOnRoute = INFINITY;
-        iterator = iterator->next;
+    uint32_t citiesCount = countCitiesOnList(state->listOfCities);
+    for (uint32_t i = 0; i < citiesCount; i++) {
+        distance[i] = INFINITY;
+        oldestRoadOnRoute[i] = INFINITY;
+        state->heuristic[i] = -1;
     }
 
     /* Ustawiamy odległości miast na drodze krajowe na -1
      * przez co ich nie odwiedzimy. */
+    ListIterator *iterator;
     if (route->cities != NULL) {
         iterator = route->cities->begin;
         while (iterator != route->cities->end) {
-            ((City *)iterator->data)->distance = -1;
+            distance[((City *)iterator->data)->id] = -1;
             iterator = iterator->next;
         }
     }
 
     /* Ustwiamy odległość miasta startowego. */
-    from->distance = 0;
-    from->oldestRoadOnRoute = INFINITY;
-    from->isRouteUnequivocal = true;
-    if (!pushHeap(heap, 0, INFINITY, from)) {
+    distance[from->id] = 0;
+    oldestRoadOnRoute[from->id] = INFINITY;
+    state->isRouteUnequivocal[from->id] = true;
+    int64_t fromKey = 0;
+    if (isAStar) {
+        fromKey = heuristicRouteModule(state, from, to, to2);
+    }
+    if (!pushHeap(heap, fromKey, INFINITY, from)) {
         deleteHeap(heap);
         return false;
     }
 
     /* Ustawiamy odległości miast docelowych, aby móc je odwiedzić nawet
      * jeśli są na drodze krajowej. */
-    to->distance = INFINITY;
+    if (to != NULL) {
+        distance[to->id] = INFINITY;
+    }
     if (to2 != NULL) {
-        to2->distance = INFINITY;
+        distance[to2->id] = INFINITY;
     }
 
     /* Algorytm Dijkstry. */
@@ -130,19 +215,31 @@ bool dijkstraRouteModule(Route *route, City *from, City *to, City *to2,
         /* Sprawdzamy czy wierzchołek sterty posiada najoptymalniejszą
          * drogę do danego miasta. Jeśli tak nie jest oznacza to, że
          * dane miasto zostało już "obsłużone" przez algorytm. */
-        if (heap->keys[1]->distance != ptr->distance) {
+        int64_t key = distance[ptr->id];
+        if (isAStar) {
+            key += heuristicRouteModule(state, ptr, to, to2);
+        }
+        if (heap->keys[1]->distance != key) {
             popHeap(heap);
             continue;
         }
 
         /* Robimy to samo co wyżej. */
         if (knownOldestRoad == 0 &&
-                heap->keys[1]->oldestRoad != ptr->oldestRoadOnRoute) {
+                heap->keys[1]->oldestRoad != oldestRoadOnRoute[ptr->id]) {
             popHeap(heap);
             continue;
         }
 
         popHeap(heap);
+        state->statistics.settledCitiesCount++;
+
+        /* Wartości dla obsłużonych miast docelowych już się nie zmienią. */
+        if (isGoalDirected && (ptr == to || ptr == to2)) {
+            if (--targetsLeft == 0) {
+                break;
+            }
+        }
 
         /* Próbujemy "poprawić" sąsiadów miasta. */
         iterator = ptr->roads->begin;
@@ -150,7 +247,8 @@ bool dijkstraRouteModule(Route *route, City *from, City *to, City *to2,
         while (iterator != ptr->roads->end) {
             road = iterator->data;
 
-            if (road->isDeleted) {
+            if (road->isDeleted || road == state->skippedRoads[0] ||
+                    road == state->skippedRoads[1]) {
                 iterator = iterator->next;
                 continue;
             }
@@ -163,33 +261,53 @@ bool dijkstraRouteModule(Route *route, City *from, City *to, City *to2,
                 continue;
             }
 
-            int64_t distance = ptr->distance + road->length;
-            int64_t oldestRoute = minInt64_t(ptr->oldestRoadOnRoute,
+            uint32_t destination = road->destination->id;
+            int64_t newDistance = distance[ptr->id] + road->length;
+            int64_t oldestRoute = minInt64_t(oldestRoadOnRoute[ptr->id],
                                              road->buildYearOrLastRepairYear);
-            int64_t compare = compareRoutes(distance, oldestRoute,
-                                            road->destination->distance,
-                                            road->destination->oldestRoadOnRoute);
+            int64_t compare = compareRoutes(newDistance, oldestRoute,
+                                            distance[destination],
+                                            oldestRoadOnRoute[destination]);
 
             /* Jeśli znamy jaka jest najstarsza droga w optymalnej szukanej
              * drodze krajowej, to nie musimy porównywać dat budowy odcinków. */
             if (knownOldestRoad != 0) {
-                compare = distance - road->destination->distance;
+                compare = newDistance - distance[destination];
+            }
+
+            /* Pomijamy miasta, przez które nie przechodzi żadna szukana
+             * droga krajowa. */
+            int64_t newKey = newDistance;
+            if (compare < 0 && isGoalDirected) {
+                int64_t bound = heuristicRouteModule(state, road->destination,
+                                                     to, to2);
+                if (bound == INFINITY ||
+                        (!isAStar && newDistance + bound > knownDistance)) {
+                    iterator = iterator->next;
+                    continue;
+                }
+
+                if (isAStar) {
+                    newKey += bound;
+                }
             }
 
             /* Sprawdzamy czy możemy poprawić wynik dla danego "sąsiad" lub czy
              * możemy go "wyrównać" (stanie się niejednoznaczny). */
             if (compare < 0) {
-                road->destination->distance = distance;
-                road->destination->oldestRoadOnRoute = oldestRoute;
-                road->destination->isRouteUnequivocal = ptr->isRouteUnequivocal;
-                road->destination->previousOnRoute = ptr;
-
-                if (!pushHeap(heap, distance, oldestRoute, road->destination)) {
+                distance[destination] = newDistance;
+                oldestRoadOnRoute[destination] = oldestRoute;
+                state->isRouteUnequivocal[destination] =
+                        state->isRouteUnequivocal[ptr->id];
+                state->previousOnRoute[destination] = ptr;
+
+                if (!pushHeap(heap, newKey, oldestRoute,
+                              road->destination)) {
                     deleteHeap(heap);
                     return false;
                 }
             } else if (compare == 0) {
-                road->destination->isRouteUnequivocal = false;
+                state->isRouteUnequivocal[destination] = false;
             }
 
             iterator = iterator->next;
@@ -201,6 +319,139 @@ bool dijkstraRouteModule(Route *route, City *from, City *to, City *to2,
     return true;
 }
 
+/** @brief Odzyskuje trasę drogi znalezionej algorytmem dijkstry.
+ * Idzie od miasta @p to po poprzednikach zapisanych w
+ * @ref SearchState.previousOnRoute aż do miasta @p from.
+ * @param[in] from              - wskaźnik na miasto startowe algorytmu;
+ * @param[in] to                - wskaźnik na docelowe miasto;
+ * @param[in] state             - wskaźnik na stan algorytmu dijkstry.
+ * @return Wskaźnik na listę miast drogi lub NULL, jeśli nie udało się
+ * zaalokować pamięci.
+ */
+List *recoverPathRouteModule(City *from, City *to, SearchState *state) {
+    List *result = newList();
+    if (result == NULL) {
+        return NULL;
+    }
+
+    City *ptr = to;
+    while (true) {
+        if (insertList(result->begin, ptr) == NULL) {
+            deleteList(result, false);
+            return NULL;
+        }
+
+        if (ptr == from) {
+            break;
+        }
+
+        ptr = state->previousOnRoute[ptr->id];
+    }
+
+    return result;
+}
+
+/** @brief Porównuje numery miast.
+ * Funkcja porównująca dla qsort.
+ * @param[in] a                 - wskaźnik na pierwszy numer;
+ * @param[in] b                 - wskaźnik na drugi numer.
+ * @return Liczba ujemna, zero lub dodatnia, jeśli pierwszy numer jest
+ * odpowiednio mniejszy, równy lub większy od drugiego.
+ */
+int compareCityIds(const void *a, const void *b) {
+    uint32_t id1 = *(const uint32_t *)a;
+    uint32_t id2 = *(const uint32_t *)b;
+
+    return (id1 > id2) - (id1 < id2);
+}
+
+/** @brief Wyznacza miasta wykluczone z wyszukiwania.
+ * Są to miasta drogi krajowej @p route oprócz @p from, @p to oraz @p to2.
+ * @param[in] route             - wskaźnik na drogę krajową;
+ * @param[in] from              - wskaźnik na miasto startowe algorytmu;
+ * @param[in] to                - wskaźnik na docelowe miasto lub NULL;
+ * @param[in] to2               - wskaźnik na docelowe miasto lub NULL;
+ * @param[out] excluded         - wskaźnik na zaalokowaną tablicę rosnących
+ *                                numerów miast lub NULL, jeśli droga nie ma
+ *                                miast;
+ * @param[out] excludedCount    - wskaźnik na liczbę wykluczonych miast.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool excludedCitiesRouteModule(Route *route, City *from, City *to, City *to2,
+                               uint32_t **excluded, uint32_t *excludedCount) {
+    *excluded = NULL;
+    *excludedCount = 0;
+    if (route->cities == NULL) {
+        return true;
+    }
+
+    *excluded = malloc(sizeof(uint32_t) * (sizeList(route->cities) + 1));
+    if (*excluded == NULL) {
+        return false;
+    }
+
+    ListIterator *iterator = route->cities->begin;
+    while (iterator != route->cities->end) {
+        City *city = iterator->data;
+        if (city != from && city != to && city != to2) {
+            (*excluded)[(*excludedCount)++] = city->id;
+        }
+        iterator = iterator->next;
+    }
+    qsort(*excluded, *excludedCount, sizeof(uint32_t), compareCityIds);
+
+    return true;
+}
+
+/** @brief Symuluje algorytm dijkstry, korzystając z pamięci podręcznej.
+ * Działa jak @ref dijkstraRouteModule. Jeśli stan algorytmu ma pamięć
+ * podręczną, a algorytm liczy drogi do wszystkich miast, to drzewo
+ * najkrótszych dróg zależy tylko od miasta startowego, wykluczonych miast
+ * i @p knownOldestRoad. Jest wtedy odczytywane z pamięci podręcznej lub do
+ * niej zapisywane. Drzewa bez pomijanego odcinka
+ * (@ref SearchState.skippedRoads) nie są zapamiętywane.
+ * @param[in] route             - wskaźnik na drogę krajową;
+ * @param[in] from              - wskaźnik na miasto startowe algorytmu;
+ * @param[in] to                - wskaźnik na docelowe miasto lub NULL (wtedy
+ *                                @p to2 == NULL);
+ * @param[in] to2               - wskaźnik na docelowe miasto lub NULL;
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry;
+ * @param[in] knownOldestRoad   - rok, od którego mamy zacząć uwzględniać odcinki;
+ * @param[in] knownDistance     - długość szukanej drogi lub @ref INFINITY.
+ * @return Wartość @p true lub @p false jeśli nie udało się zaalokować pamięci.
+ */
+bool cachedDijkstraRouteModule(Route *route, City *from, City *to, City *to2,
+                               SearchState *state, int64_t knownOldestRoad,
+                               int64_t knownDistance) {
+    if (state->cache == NULL || state->skippedRoads[0] != NULL ||
+            isGoalDirectedRouteModule(state, to, to2, knownOldestRoad)) {
+        return dijkstraRouteModule(route, from, to, to2, state,
+                                   knownOldestRoad, knownDistance);
+    }
+
+    SearchTreeKey key = {from->id, knownOldestRoad, NULL, 0};
+    uint32_t *excluded;
+    if (!prepareSearchState(state) ||
+            !excludedCitiesRouteModule(route, from, to, to2, &excluded,
+                                       &key.excludedCount)) {
+        return false;
+    }
+    key.excluded = excluded;
+
+    bool result = true;
+    if (!findSearchCache(state->cache, &key, state)) {
+        result = dijkstraRouteModule(route, from, to, to2, state,
+                                     knownOldestRoad, knownDistance);
+        if (result) {
+            insertSearchCache(state->cache, &key, state);
+        }
+    }
+    free(excluded);
+
+    return result;
+}
+
 /** @brief Zanjduje drogę między miastami.
  * Znajduje drogę krajową z miasta @p from do miasta @p to lub do miasta
  * @p to2 (jeśli @p to2 != NULL). Droga ta nie wchodzi do wierzchołków
@@ -209,34 +460,56 @@ bool dijkstraRouteModule(Route *route, City *from, City *to, City *to2,
  * wyszukuje najkrótszą drogę. Jeśli jest więcej niż jeden sposób takiego wyboru,
  * to dla każdego wariantu wyznacza wśród wybranych w nim odcinków dróg ten,
  * który był najdawniej wybudowany lub remontowany i wybiera wariant
- * z odcinkiem, który jest najmłodszy.
+ * z odcinkiem, który jest najmłodszy. Jeśli @p to2 == NULL i stan algorytmu
+ * wybiera dwukierunkowy algorytm dijkstry, to używa
+ * @ref findRouteBidirectional. Jeśli dodatkowo droga krajowa nie ma miast,
+ * a stan algorytmu wybiera hierarchię kontrakcji, to używa
+ * @ref findRouteHierarchy. W pozostałych przypadkach przejścia algorytmu
+ * dijkstry mogą być odczytane z pamięci podręcznej stanu
+ * (zob. @ref cachedDijkstraRouteModule).
  * @param[in] route             - wskaźnik na drogę krajową;
  * @param[in] from              - wskaźnik na miasto startowe algorytmu;
  * @param[in] to                - wskaźnik na docelowe miasto;
  * @param[in] to2               - wskaźnik na docelowe miasto lub NULL;
- * @param[in] listOfCities      - wskaźnik na wszystkie miasta na danej mapie.
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry.
  * @return Wskaźnik na listę zawierającą szukaną drogę lub NULL jeśli droga nie
  * jest jednoznaczna lub nie udało się zaalokować pamięci.
  */
 List *findRouteModule(Route *route, City *from, City *to, City *to2,
-                      List *listOfCities) {
+                      SearchState *state) {
     assert(route);
     assert(from);
     assert(to);
-    assert(listOfCities);
+    assert(state);
+
+    state->statistics.searchesCount++;
+    if (state->engine == BIDIRECTIONAL_SEARCH_ENGINE && to2 == NULL) {
+        return findRouteBidirectional(route, from, to, state);
+    }
+
+    /* Hierarchia nie uwzględnia wykluczonych miast drogi krajowej, więc
+     * w pozostałych przypadkach używamy algorytmu dijkstry. */
+    if (state->engine == HIERARCHY_SEARCH_ENGINE && to2 == NULL &&
+            route->cities == NULL && state->hierarchy != NULL) {
+        return findRouteHierarchy(from, to, state);
+    }
 
     /* Znajdujemy optymalny najstarszy odcinek szukanej drogi krajowej. */
-    if (!dijkstraRouteModule(route, from, to, to2, listOfCities, 0)) {
+    if (!cachedDijkstraRouteModule(route, from, to, to2, state, 0,
+                                   INFINITY)) {
         return NULL;
     }
 
-    int64_t knownOldestRoad = to->oldestRoadOnRoute;
+    int64_t *distance = state->distance;
+    int64_t *oldestRoadOnRoute = state->oldestRoadOnRoute;
+
+    int64_t knownOldestRoad = oldestRoadOnRoute[to->id];
     if (to2 != NULL) {
-        if (to->distance == to2->distance) {
+        if (distance[to->id] == distance[to2->id]) {
             knownOldestRoad = -minInt64_t(-knownOldestRoad,
-                                          -to2->oldestRoadOnRoute); //max
-        } else if (to->distance > to2->distance) {
-            knownOldestRoad = to2->oldestRoadOnRoute;
+                                          -oldestRoadOnRoute[to2->id]); //max
+        } else if (distance[to->id] > distance[to2->id]) {
+            knownOldestRoad = oldestRoadOnRoute[to2->id];
         }
     }
 
@@ -248,16 +521,16 @@ List *findRouteModule(Route *route, City *from, City *to, City *to2,
     /* Uruchamiamy raz jeszcze algorytm dijkstry znając już optymalny najstarszy
      * odcinek szukanej drogi krajowej by dowiedzieć się czy szukana droga
      * krajowa jest wyznaczona jednoznacznie. */
-    if (!dijkstraRouteModule(route, from, to, to2, listOfCities,
-                             knownOldestRoad)) {
+    if (!cachedDijkstraRouteModule(route, from, to, to2, state,
+                                   knownOldestRoad, distance[to->id])) {
         return NULL;
     }
 
     /* Sprawdzamy do którego miasta prowadzi szukana drogą krajowa oraz
      * czy jest wyznaczona jednoznacznie. */
     if (to2 != NULL) {
-        int64_t c = compareRoutes(to->distance, to->oldestRoadOnRoute,
-                                  to2->distance, to2->oldestRoadOnRoute);
+        int64_t c = compareRoutes(distance[to->id], oldestRoadOnRoute[to->id],
+                                  distance[to2->id], oldestRoadOnRoute[to2->id]);
         if (c == 0) {
             return NULL;
         } else if (c > 0) {
@@ -267,31 +540,11 @@ List *findRouteModule(Route *route, City *from, City *to, City *to2,
 
     /* Sprawdzamy czy istnieje jakakolwiek szukana droga krajowa i czy
      * jest wyznaczona jednoznacznie. */
-    if (to->distance == INFINITY || !to->isRouteUnequivocal) {
-        return NULL;
-    }
-
-    /* Odzyskiwanie trasy szukanej drogi. */
-    List *result = newList();
-    if (result == NULL) {
+    if (distance[to->id] == INFINITY || !state->isRouteUnequivocal[to->id]) {
         return NULL;
     }
 
-    City *ptr = to;
-    while (true) {
-        if (insertList(result->begin, ptr) == NULL) {
-            deleteList(result, false);
-            return NULL;
-        }
-
-        if (ptr == from) {
-            break;
-        }
-
-        ptr = ptr->previousOnRoute;
-    }
-
-    return result;
+    return recoverPathRouteModule(from, to, state);
 }
 
 /** @brief Tworzy strukturę.
@@ -303,14 +556,14 @@ List *findRouteModule(Route *route, City *from, City *to, City *to2,
  * @param[in] routeId           - numer drogi krajowej;
  * @param[in] city1             - wskaźnik na pierwsze miasto;
  * @param[in] city2             - wskaźnik na drugie miasto;
- * @param[in] listOfCities      - wskaźnik na wszystkie miasta na danej mapie.
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry.
  * @return Wartość @p true, jeśli droga krajowa została utworzona.
  * Wartość @p false, jeśli wystąpił błąd: nie można
  * jednoznacznie wyznaczyć drogi krajowej między podanymi miastami lub nie udało
  * się zaalokować pamięci.
  */
 Route *newRouteModule(unsigned routeId, City *city1, City *city2,
-                      List *listOfCities) {
+                      SearchState *state) {
     Route *result = malloc(sizeof(Route));
     if (result == NULL) {
         return NULL;
@@ -318,6 +571,7 @@ Route *newRouteModule(unsigned routeId, City *city1, City *city2,
 
     result->routeId = routeId;
     result->cities = NULL;
+    result->replacementPaths = NULL;
 
     if (city1 == city2) {
         result->cities = newList();
@@ -332,8 +586,7 @@ Route *newRouteModule(unsigned routeId, City *city1, City *city2,
             return NULL;
         }
     } else {
-        result->cities = findRouteModule(result, city1, city2, NULL,
-                                         listOfCities);
+        result->cities = findRouteModule(result, city1, city2, NULL, state);
         if (result->cities == NULL) {
             free(result);
             return NULL;
@@ -343,29 +596,167 @@ Route *newRouteModule(unsigned routeId, City *city1, City *city2,
     return result;
 }
 
-/** @brief Poprawia drogę krajową.
- * Poprawia drogę krajową po usunięciu odcinka drogi między dwoma miastami.
- * Jeśli usunięcie tego odcinka drogi
- * spowodowało przerwanie ciągu rogi krajowej, to uzupełnia ją
- * istniejącymi odcinkami dróg w taki sposób, aby była najkrótsza. Jeśli jest
- * więcej niż jeden sposób takiego uzupełnienia, to dla każdego wariantu
- * wyznacza wśród dodawanych odcinków drogi ten, który był najdawniej wybudowany
- * lub remontowany i wybiera wariant z odcinkiem, który jest najmłodszy.
- * @param[in,out] route         - wskaźnik drogę krajową do poprawienie;
+/**
+ * Struktura opisująca miasto docelowe drogi krajowej tworzonej
+ * w @ref newRoutesModule.
+ */
+typedef struct RouteTarget {
+    int64_t oldestRoad;         ///< najstarszy odcinek najlepszej drogi
+    uint32_t index;             ///< numer miasta docelowego
+} RouteTarget;
+
+/** @brief Porównuje miasta docelowe według najstarszych odcinków.
+ * Funkcja porównująca dla qsort.
+ * @param[in] a                 - wskaźnik na pierwsze miasto docelowe;
+ * @param[in] b                 - wskaźnik na drugie miasto docelowe.
+ * @return Liczba ujemna, zero lub dodatnia, jeśli pierwszy odcinek jest
+ * odpowiednio starszy, tak samo stary lub młodszy od drugiego.
+ */
+int compareRouteTargets(const void *a, const void *b) {
+    const RouteTarget *target1 = a;
+    const RouteTarget *target2 = b;
+
+    if (target1->oldestRoad != target2->oldestRoad) {
+        return target1->oldestRoad < target2->oldestRoad ? -1 : 1;
+    }
+
+    return target1->index < target2->index ? -1 : 1;
+}
+
+/** @brief Usuwa drogi krajowe utworzone przez @ref newRoutesModule.
+ * @param[in,out] routes        - wskaźnik na tablicę dróg krajowych lub NULL;
+ * @param[in] count             - liczba elementów tablicy @p routes.
+ */
+void clearRoutesModule(Route **routes, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (routes[i] != NULL) {
+            deleteRouteModule(routes[i]);
+            routes[i] = NULL;
+        }
+    }
+}
+
+/** @brief Tworzy drogi krajowe z jednego miasta.
+ * Dla każdego miasta @p to[i] różnego od NULL tworzy drogę krajową numer
+ * @p routeIds[i] tak jak @ref newRouteModule i zapisuje ją w @p routes[i]
+ * (NULL, jeśli drogi nie można jednoznacznie wyznaczyć). Najlepsze drogi do
+ * wszystkich miast liczy jeden algorytm dijkstry z miasta @p from, a ich
+ * jednoznaczność jedno przejście dla każdego różnego najstarszego odcinka.
+ * Jeśli stan algorytmu wybiera hierarchię kontrakcji, to drogi wyznaczane są
+ * osobno, bo zapytania w hierarchii są tańsze od przejścia całej mapy.
+ * @param[in] routeIds          - wskaźnik na tablicę numerów dróg krajowych;
+ * @param[in] from              - wskaźnik na miasto startowe;
+ * @param[in] to                - wskaźnik na tablicę miast docelowych;
+ * @param[in] count             - liczba miast docelowych;
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry;
+ * @param[out] routes           - wskaźnik na tablicę tworzonych dróg.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci (wtedy wszystkie elementy @p routes mają wartość NULL).
+ */
+bool newRoutesModule(const unsigned *routeIds, City *from, City **to,
+                     uint32_t count, SearchState *state, Route **routes) {
+    assert(routeIds && from && to && state && routes);
+
+    for (uint32_t i = 0; i < count; i++) {
+        routes[i] = NULL;
+    }
+
+    if (state->engine == HIERARCHY_SEARCH_ENGINE && state->hierarchy != NULL) {
+        for (uint32_t i = 0; i < count; i++) {
+            if (to[i] != NULL) {
+                routes[i] = newRouteModule(routeIds[i], from, to[i], state);
+            }
+        }
+        return true;
+    }
+
+    /* Droga bez miast nie wyklucza żadnego miasta z wyszukiwania. */
+    Route route = {0, NULL, false, NULL};
+    state->statistics.searchesCount++;
+    if (!cachedDijkstraRouteModule(&route, from, NULL, NULL, state, 0,
+                                   INFINITY)) {
+        return false;
+    }
+
+    RouteTarget *targets = malloc(sizeof(RouteTarget) * (count + 1));
+    if (targets == NULL) {
+        return false;
+    }
+
+    uint32_t targetsCount = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (to[i] != NULL && to[i] != from &&
+                state->oldestRoadOnRoute[to[i]->id] != INFINITY) {
+            targets[targetsCount].oldestRoad =
+                    state->oldestRoadOnRoute[to[i]->id];
+            targets[targetsCount++].index = i;
+        }
+    }
+    qsort(targets, targetsCount, sizeof(RouteTarget), compareRouteTargets);
+
+    /* Drogi o tym samym najstarszym odcinku sprawdzamy jednym przejściem,
+     * które jest takie samo jak w @ref findRouteModule. */
+    bool result = true;
+    uint32_t begin = 0;
+    while (result && begin < targetsCount) {
+        int64_t oldestRoad = targets[begin].oldestRoad;
+        uint32_t end = begin;
+        while (end < targetsCount && targets[end].oldestRoad == oldestRoad) {
+            end++;
+        }
+
+        state->statistics.searchesCount++;
+        result = cachedDijkstraRouteModule(&route, from, NULL, NULL, state,
+                                           oldestRoad, INFINITY);
+        for (uint32_t i = begin; result && i < end; i++) {
+            uint32_t index = targets[i].index;
+            uint32_t id = to[index]->id;
+            if (state->distance[id] == INFINITY ||
+                    !state->isRouteUnequivocal[id]) {
+                continue;
+            }
+
+            routes[index] = malloc(sizeof(Route));
+            if (routes[index] == NULL) {
+                result = false;
+                break;
+            }
+
+            routes[index]->routeId = routeIds[index];
+            routes[index]->replacementPaths = NULL;
+            routes[index]->cities = recoverPathRouteModule(from, to[index],
+                                                           state);
+            if (routes[index]->cities == NULL) {
+                free(routes[index]);
+                routes[index] = NULL;
+                result = false;
+            }
+        }
+
+        begin = end;
+    }
+
+    free(targets);
+    if (!result) {
+        clearRoutesModule(routes, count);
+    }
+
+    return result;
+}
+
+/** @brief Znajduje usunięty odcinek na drodze krajowej.
+ * Szuka na drodze krajowej odcinka drogowego pomiędzy miastami @p city1
+ * oraz @p city2.
+ * @param[in] route             - wskaźnik na drogę krajową;
  * @param[in] city1             - wskaźnik na pierwsze miasto;
- * @param[in] city2             - wskaźnik na drugie miasto;
- * @param listOfCities          - wskaźnik na wszystkie miasta na danej mapie.
- * @return Wartość @p true jeśli udało się poprawić drogę krajową, lub @p false,
- * jeśli nie udało się zaalokować pamięci.
+ * @param[in] city2             - wskaźnik na drugie miasto.
+ * @return Wskaźnik na węzeł listy miast drogi krajowej zawierający pierwsze
+ * miasto odcinka lub NULL, jeśli odcinek nie należy do drogi krajowej.
  */
-bool findNewRouteAfterRemovingRoad(Route *route, City *city1, City *city2,
-                                   List *listOfCities) {
+ListIterator *findRemovedRoadOnRoute(Route *route, City *city1, City *city2) {
     assert(route);
     assert(city1);
     assert(city2);
-    assert(listOfCities);
-
-    route->wasChanged = false;
 
     /* Szukamy miasta city1 lub city2 na danej drodze krajowej. */
     ListIterator *iterator = route->cities->begin;
@@ -378,34 +769,381 @@ bool findNewRouteAfterRemovingRoad(Route *route, City *city1, City *city2,
      * naszą drogę krajową. */
     if (iterator == route->cities->end ||
             iterator->next == route->cities->end) {
-        return true;
+        return NULL;
     }
 
     /* Robimy to samo co wyżej. */
     if (iterator->next->data != city1 && iterator->next->data != city2) {
+        return NULL;
+    }
+
+    return iterator;
+}
+
+/** @brief Wyznacza objazd odcinka drogi krajowej do indeksu objazdów.
+ * Wyszukiwanie pomija odcinek (@ref SearchState.skippedRoads), więc mapa nie
+ * jest zmieniana i funkcja może być wywoływana równolegle dla różnych dróg
+ * krajowych z różnymi stanami algorytmu. Objazd, którego nie udało się
+ * jednoznacznie wyznaczyć, ma wartość NULL.
+ * @param[in] route             - wskaźnik na drogę krajową;
+ * @param[in,out] path          - wskaźnik na objazd z indeksu drogi krajowej;
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry.
+ */
+void buildReplacementPathRouteModule(Route *route, ReplacementPath *path,
+                                     SearchState *state) {
+    assert(route);
+    assert(path);
+    assert(state);
+
+    if (path->detour != NULL) {
+        deleteList(path->detour, false);
+    }
+
+    state->skippedRoads[0] = findRoadModule(path->city1, path->city2)->data;
+    state->skippedRoads[1] = findRoadModule(path->city2, path->city1)->data;
+    path->detour = findRouteModule(route, path->city1, path->city2, NULL,
+                                   state);
+    state->skippedRoads[0] = NULL;
+    state->skippedRoads[1] = NULL;
+
+    path->isStale = false;
+}
+
+/** @brief Odczytuje objazd z indeksu objazdów drogi krajowej.
+ * Nieaktualny objazd jest najpierw wyznaczany ponownie. Objazd, którego nie
+ * udało się jednoznacznie wyznaczyć, jest wyznaczany ponownie przy każdym
+ * odczycie, bo usunięcie odcinka drogi mogło sprawić, że objazd stał się
+ * jednoznaczny. Pomijane odcinki stanu algorytmu są potem wyzerowane.
+ * @param[in,out] route         - wskaźnik na drogę krajową;
+ * @param[in] city1             - wskaźnik na wcześniejsze miasto odcinka;
+ * @param[in] city2             - wskaźnik na późniejsze miasto odcinka;
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry;
+ * @param[out] detour           - wskaźnik na kopię objazdu lub NULL, jeśli
+ *                                nie da się go jednoznacznie wyznaczyć lub
+ *                                nie udało się zaalokować pamięci.
+ * @return Wartość @p true, jeśli indeks zawiera odcinek, lub @p false
+ * w przeciwnym przypadku.
+ */
+bool findReplacementPathRouteModule(Route *route, City *city1, City *city2,
+                                    SearchState *state, List **detour) {
+    if (route->replacementPaths == NULL) {
+        return false;
+    }
+
+    ReplacementPath *path = findReplacementPaths(route->replacementPaths,
+                                                 city1, city2);
+    if (path == NULL) {
+        return false;
+    }
+    assert(path->city1 == city1);
+
+    *detour = NULL;
+    if (path->isStale || path->detour == NULL) {
+        buildReplacementPathRouteModule(route, path, state);
+        route->replacementPaths->buildsCount++;
+    } else {
+        route->replacementPaths->hitsCount++;
+    }
+    if (path->detour == NULL) {
+        return true;
+    }
+
+    *detour = newList();
+    if (*detour == NULL) {
+        return true;
+    }
+
+    ListIterator *iterator = path->detour->begin;
+    while (iterator != path->detour->end) {
+        if (insertList((*detour)->end, iterator->data) == NULL) {
+            deleteList(*detour, false);
+            *detour = NULL;
+            return true;
+        }
+        iterator = iterator->next;
+    }
+
+    return true;
+}
+
+/** @brief Wyznacza objazd odcinka wspólny dla dróg krajowych.
+ * Wyszukuje jedną drogę z @p city1 do @p city2 bez wykluczonych miast,
+ * pomijając odcinek między nimi (@ref SearchState.skippedRoads). Najlepszy
+ * objazd drogi krajowej wyklucza jej miasta, więc jeśli wspólna droga ich
+ * omija, to jest też jednoznacznym objazdem tej drogi krajowej
+ * (zob. @ref copySharedDetourAfterRemovingRoad). Funkcja nie modyfikuje
+ * mapy.
+ * @param[in] city1             - wskaźnik na pierwsze miasto odcinka;
+ * @param[in] city2             - wskaźnik na drugie miasto odcinka;
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry.
+ * @return Wskaźnik na listę miast objazdu od @p city1 do @p city2 lub NULL,
+ * jeśli nie jest on jednoznaczny lub nie udało się zaalokować pamięci.
+ */
+List *findSharedDetourAfterRemovingRoad(City *city1, City *city2,
+                                        SearchState *state) {
+    assert(city1);
+    assert(city2);
+    assert(state);
+
+    /* Pusta lista miast wybiera algorytm dijkstry także wtedy, gdy stan
+     * algorytmu wybiera hierarchię kontrakcji. */
+    Route route = {0, newList(), false, NULL};
+    if (route.cities == NULL) {
+        return NULL;
+    }
+
+    state->skippedRoads[0] = findRoadModule(city1, city2)->data;
+    state->skippedRoads[1] = findRoadModule(city2, city1)->data;
+    List *result = findRouteModule(&route, city1, city2, NULL, state);
+    state->skippedRoads[0] = NULL;
+    state->skippedRoads[1] = NULL;
+    deleteList(route.cities, false);
+
+    return result;
+}
+
+/** @brief Kopiuje objazd wspólny dla dróg krajowych.
+ * Wspólny objazd jest najlepszą drogą między końcami odcinka bez
+ * wykluczonych miast. Jeśli omija miasta drogi krajowej, to jest najlepszy
+ * także wśród dróg, które je omijają, a jednoznaczny bez wykluczeń jest
+ * jednoznaczny również z nimi.
+ * @param[in] route             - wskaźnik na drogę krajową;
+ * @param[in] from              - wskaźnik na wcześniejsze miasto odcinka;
+ * @param[in] to                - wskaźnik na późniejsze miasto odcinka;
+ * @param[in] shared            - wskaźnik na wspólny objazd lub NULL;
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry;
+ * @param[out] detour           - wskaźnik na kopię objazdu od @p from do
+ *                                @p to.
+ * @return Wartość @p true, jeśli objazd omija miasta drogi krajowej i udało
+ * się go skopiować, lub @p false w przeciwnym przypadku.
+ */
+bool copySharedDetourAfterRemovingRoad(Route *route, City *from, City *to,
+                                       const List *shared, SearchState *state,
+                                       List **detour) {
+    if (shared == NULL) {
+        return false;
+    }
+
+    uint32_t *excluded;
+    uint32_t excludedCount;
+    if (!excludedCitiesRouteModule(route, from, to, NULL, &excluded,
+                                   &excludedCount)) {
+        return false;
+    }
+
+    ListIterator *iterator = shared->begin->next;
+    while (iterator->next != shared->end) {
+        City *city = iterator->data;
+        if (bsearch(&city->id, excluded, excludedCount, sizeof(uint32_t),
+                    compareCityIds) != NULL) {
+            free(excluded);
+            return false;
+        }
+        iterator = iterator->next;
+    }
+    free(excluded);
+
+    /* Wspólny objazd prowadzi od pierwszego miasta usuwanego odcinka, a droga
+     * krajowa może przechodzić przez odcinek w przeciwnym kierunku. */
+    bool isReversed = shared->begin->data != from;
+    *detour = newList();
+    if (*detour == NULL) {
+        return false;
+    }
+
+    for (iterator = shared->begin; iterator != shared->end;
+         iterator = iterator->next) {
+        ListIterator *position = isReversed ? (*detour)->begin :
+                                              (*detour)->end;
+        if (insertList(position, iterator->data) == NULL) {
+            deleteList(*detour, false);
+            *detour = NULL;
+            return false;
+        }
+    }
+    state->statistics.sharedDetoursCount++;
+
+    return true;
+}
+
+/** @brief Znajduje objazd dla drogi krajowej.
+ * Znajduje objazd dla drogi krajowej po usunięciu odcinka drogi między dwoma
+ * miastami tak jak @ref findNewRouteAfterRemovingRoad, ale nie modyfikuje
+ * drogi krajowej. Funkcja nie modyfikuje mapy, więc może być wywoływana
+ * równolegle dla różnych dróg krajowych z różnymi stanami algorytmu. Aktualny
+ * objazd z indeksu objazdów drogi krajowej (@ref ReplacementPaths) jest
+ * kopiowany bez wyszukiwania, a nieaktualny jest najpierw wyznaczany
+ * ponownie i zapamiętywany w indeksie.
+ * @param[in] route             - wskaźnik drogę krajową;
+ * @param[in] city1             - wskaźnik na pierwsze miasto;
+ * @param[in] city2             - wskaźnik na drugie miasto;
+ * @param[in] shared            - wskaźnik na objazd wspólny dla dróg
+ *                                krajowych lub NULL
+ *                                (zob. @ref findSharedDetourAfterRemovingRoad);
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry;
+ * @param[out] detour           - wskaźnik na znaleziony objazd lub NULL, jeśli
+ *                                droga krajowa nie wymaga objazdu.
+ * @return Wartość @p true jeśli droga krajowa nie wymaga objazdu lub udało się
+ * go jednoznacznie wyznaczyć. Wartość @p false w przeciwnym przypadku.
+ */
+bool findDetourAfterRemovingRoad(Route *route, City *city1, City *city2,
+                                 const List *shared, SearchState *state,
+                                 List **detour) {
+    assert(route);
+    assert(city1);
+    assert(city2);
+    assert(state);
+    assert(detour);
+
+    *detour = NULL;
+
+    ListIterator *iterator = findRemovedRoadOnRoute(route, city1, city2);
+    if (iterator == NULL) {
+        return true;
+    }
+
+    /* Objazd z indeksu jest wynikiem tego samego wyszukiwania. */
+    if (findReplacementPathRouteModule(route, iterator->data,
+                                       iterator->next->data, state, detour)) {
+        return *detour != NULL;
+    }
+
+    if (copySharedDetourAfterRemovingRoad(route, iterator->data,
+                                          iterator->next->data, shared, state,
+                                          detour)) {
         return true;
     }
 
     /* Usunięty odcinek drogowy wpływa na naszą drogę krajową. Znajdujemy
      * objazd. */
-    List *list;
     if (iterator->data == city1) {
-        list = findRouteModule(route, city1, city2, NULL, listOfCities);
+        *detour = findRouteModule(route, city1, city2, NULL, state);
     } else {
-        list = findRouteModule(route, city2, city1, NULL, listOfCities);
+        *detour = findRouteModule(route, city2, city1, NULL, state);
     }
 
-    if (list == NULL) {
-        return false;
+    return *detour != NULL;
+}
+
+/** @brief Wyznacza długość objazdu bez oznaczania odcinka jako usuwanego.
+ * Działa jak @ref findDetourAfterRemovingRoad, ale odcinek między miastami
+ * @p city1 i @p city2 jest tylko pomijany przez wyszukiwania w stanie
+ * algorytmu (@ref SearchState.skippedRoads), więc ani mapa, ani droga
+ * krajowa nie są zmieniane. Może być wywoływana równolegle dla różnych dróg
+ * krajowych z różnymi stanami algorytmu.
+ * @param[in] route             - wskaźnik drogę krajową;
+ * @param[in] city1             - wskaźnik na pierwsze miasto;
+ * @param[in] city2             - wskaźnik na drugie miasto;
+ * @param[in] shared            - wskaźnik na objazd wspólny dla dróg
+ *                                krajowych lub NULL
+ *                                (zob. @ref findSharedDetourAfterRemovingRoad);
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry;
+ * @param[out] length           - wskaźnik na długość objazdu, @p 0, jeśli
+ *                                droga krajowa nie wymaga objazdu, lub
+ *                                @p -1, jeśli nie udało się go wyznaczyć.
+ * @return Wartość @p true jeśli droga krajowa nie wymaga objazdu lub udało się
+ * go jednoznacznie wyznaczyć. Wartość @p false w przeciwnym przypadku.
+ */
+bool findDetourLengthAfterRemovingRoad(Route *route, City *city1, City *city2,
+                                       const List *shared, SearchState *state,
+                                       int64_t *length) {
+    assert(route);
+    assert(city1);
+    assert(city2);
+    assert(state);
+    assert(length);
+
+    ListIterator *road = findRoadModule(city1, city2);
+    assert(road);
+    state->skippedRoads[0] = road->data;
+    state->skippedRoads[1] = findRoadModule(city2, city1)->data;
+
+    List *detour;
+    bool result = findDetourAfterRemovingRoad(route, city1, city2, shared,
+                                              state, &detour);
+    state->skippedRoads[0] = NULL;
+    state->skippedRoads[1] = NULL;
+
+    *length = result ? 0 : -1;
+    if (detour == NULL) {
+        return result;
+    }
+
+    ListIterator *iterator = detour->begin;
+    while (iterator->next != detour->end) {
+        *length += ((Road *)findRoadModule(iterator->data,
+                                           iterator->next->data)->data)->length;
+        iterator = iterator->next;
+    }
+    deleteList(detour, false);
+
+    return true;
+}
+
+/** @brief Wstawia objazd do drogi krajowej.
+ * Wstawia objazd znaleziony przez @ref findDetourAfterRemovingRoad w miejsce
+ * usuwanego odcinka drogi. Usuwa strukturę @p detour.
+ * @param[in,out] route         - wskaźnik drogę krajową;
+ * @param[in] city1             - wskaźnik na pierwsze miasto;
+ * @param[in] city2             - wskaźnik na drugie miasto;
+ * @param[in,out] detour        - wskaźnik na objazd lub NULL.
+ */
+void applyDetourAfterRemovingRoad(Route *route, City *city1, City *city2,
+                                  List *detour) {
+    assert(route);
+
+    route->wasChanged = false;
+    if (detour == NULL) {
+        return;
     }
 
+    ListIterator *iterator = findRemovedRoadOnRoute(route, city1, city2);
+    assert(iterator);
+
     /* Uaktualniamy naszą drogę krajową o znaleziony objazd. */
-    eraseList(list->begin, false);
-    eraseList(list->end->previous, false);
-    spliceList(iterator->next, list);
-    deleteList(list, false);
+    eraseList(detour->begin, false);
+    eraseList(detour->end->previous, false);
+    spliceList(iterator->next, detour);
+    deleteList(detour, false);
 
     route->wasChanged = true;
+}
+
+/** @brief Poprawia drogę krajową.
+ * Poprawia drogę krajową po usunięciu odcinka drogi między dwoma miastami.
+ * Jeśli usunięcie tego odcinka drogi
+ * spowodowało przerwanie ciągu rogi krajowej, to uzupełnia ją
+ * istniejącymi odcinkami dróg w taki sposób, aby była najkrótsza. Jeśli jest
+ * więcej niż jeden sposób takiego uzupełnienia, to dla każdego wariantu
+ * wyznacza wśród dodawanych odcinków drogi ten, który był najdawniej wybudowany
+ * lub remontowany i wybiera wariant z odcinkiem, który jest najmłodszy.
+ * @param[in,out] route         - wskaźnik drogę krajową do poprawienie;
+ * @param[in] city1             - wskaźnik na pierwsze miasto;
+ * @param[in] city2             - wskaźnik na drugie miasto;
+ * @param[in] shared            - wskaźnik na objazd wspólny dla dróg
+ *                                krajowych lub NULL
+ *                                (zob. @ref findSharedDetourAfterRemovingRoad);
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry.
+ * @return Wartość @p true jeśli udało się poprawić drogę krajową, lub @p false,
+ * jeśli nie udało się zaalokować pamięci.
+ */
+bool findNewRouteAfterRemovingRoad(Route *route, City *city1, City *city2,
+                                   const List *shared, SearchState *state) {
+    assert(route);
+    assert(city1);
+    assert(city2);
+    assert(state);
+
+    route->wasChanged = false;
+
+    List *detour;
+    if (!findDetourAfterRemovingRoad(route, city1, city2, shared, state,
+                                     &detour)) {
+        return false;
+    }
+
+    applyDetourAfterRemovingRoad(route, city1, city2, detour);
+
     return true;
 }
 
@@ -443,6 +1181,137 @@ void undoFindNewRouteAfterRemovingRoad(Route *route, City *city1, City *city2) {
     }
 }
 
+/** @brief Sprawdza czy odcinek drogi jest oznaczony jako usuwany.
+ * @param[in] city1             - wskaźnik na pierwsze miasto;
+ * @param[in] city2             - wskaźnik na drugie miasto.
+ * @return Wartość @p true, jeśli odcinek istnieje i jest usuwany, lub
+ * @p false w przeciwnym przypadku.
+ */
+bool isRoadDeletedRouteModule(City *city1, City *city2) {
+    ListIterator *iterator = findRoadModule(city1, city2);
+
+    return iterator != NULL && ((Road *)iterator->data)->isDeleted;
+}
+
+/** @brief Znajduje wspólny objazd usuwanego odcinka.
+ * @param[in] removed           - wskaźnik na tablicę par końców usuwanych
+ *                                odcinków;
+ * @param[in] shared            - wskaźnik na tablicę wspólnych objazdów lub
+ *                                NULL;
+ * @param[in] count             - liczba usuwanych odcinków;
+ * @param[in] city1             - wskaźnik na pierwsze miasto odcinka;
+ * @param[in] city2             - wskaźnik na drugie miasto odcinka.
+ * @return Wskaźnik na wspólny objazd odcinka lub NULL, jeśli go nie ma.
+ */
+const List *findSharedDetourRouteModule(City *const *removed,
+                                        List *const *shared, size_t count,
+                                        City *city1, City *city2) {
+    if (shared == NULL) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if ((removed[2 * i] == city1 && removed[2 * i + 1] == city2) ||
+                (removed[2 * i] == city2 && removed[2 * i + 1] == city1)) {
+            return shared[i];
+        }
+    }
+
+    return NULL;
+}
+
+/** @brief Wyznacza drogę krajową po usunięciu wielu odcinków dróg.
+ * Usuwane odcinki muszą być oznaczone jako usuwane (@ref Road.isDeleted).
+ * Kopiuje miasta drogi krajowej i zastępuje w kopii kolejne (wzdłuż drogi)
+ * usuwane odcinki objazdami wyznaczonymi jak w
+ * @ref findDetourAfterRemovingRoad, które omijają wszystkie miasta kopii,
+ * także z wstawionych wcześniej objazdów. Objazd usuwanego odcinka, którego
+ * wspólny objazd omija miasta kopii, jest kopiowany zamiast wyszukiwany
+ * (zob. @ref copySharedDetourAfterRemovingRoad). Nie modyfikuje drogi
+ * krajowej ani mapy, więc może być wywoływana równolegle dla różnych dróg
+ * krajowych z różnymi stanami algorytmu.
+ * @param[in] route             - wskaźnik drogę krajową;
+ * @param[in] removed           - wskaźnik na tablicę par końców usuwanych
+ *                                odcinków;
+ * @param[in] shared            - wskaźnik na tablicę wspólnych objazdów
+ *                                usuwanych odcinków (NULL dla odcinka bez
+ *                                wspólnego objazdu) lub NULL;
+ * @param[in] count             - liczba usuwanych odcinków;
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry;
+ * @param[out] cities           - wskaźnik na nową listę miast drogi krajowej
+ *                                lub NULL, jeśli droga krajowa nie przechodzi
+ *                                przez żaden usuwany odcinek.
+ * @return Wartość @p true jeśli droga krajowa nie wymaga objazdów lub udało
+ * się je jednoznacznie wyznaczyć. Wartość @p false, jeśli któregoś objazdu
+ * nie da się jednoznacznie wyznaczyć lub nie udało się zaalokować pamięci.
+ */
+bool findDetoursAfterRemovingRoads(Route *route, City *const *removed,
+                                   List *const *shared, size_t count,
+                                   SearchState *state, List **cities) {
+    assert(route);
+    assert(state);
+    assert(cities);
+
+    *cities = NULL;
+
+    /* Sprawdzamy czy któryś usuwany odcinek należy do drogi krajowej. */
+    ListIterator *iterator = route->cities->begin;
+    while (iterator->next != route->cities->end &&
+           !isRoadDeletedRouteModule(iterator->data, iterator->next->data)) {
+        iterator = iterator->next;
+    }
+    if (iterator->next == route->cities->end) {
+        return true;
+    }
+
+    List *result = newList();
+    if (result == NULL) {
+        return false;
+    }
+    for (iterator = route->cities->begin; iterator != route->cities->end;
+         iterator = iterator->next) {
+        if (insertList(result->end, iterator->data) == NULL) {
+            deleteList(result, false);
+            return false;
+        }
+    }
+
+    /* Objazdy szukamy dla kopii, więc omijają one miasta wstawionych
+     * wcześniej objazdów. */
+    Route copy = {route->routeId, result, false, NULL};
+    iterator = result->begin;
+    while (iterator->next != result->end) {
+        City *city1 = iterator->data;
+        City *city2 = iterator->next->data;
+        if (!isRoadDeletedRouteModule(city1, city2)) {
+            iterator = iterator->next;
+            continue;
+        }
+
+        const List *roadShared = findSharedDetourRouteModule(
+                removed, shared, count, city1, city2);
+        List *detour;
+        if (!copySharedDetourAfterRemovingRoad(&copy, city1, city2,
+                                               roadShared, state, &detour)) {
+            detour = findRouteModule(&copy, city1, city2, NULL, state);
+        }
+        if (detour == NULL) {
+            deleteList(result, false);
+            return false;
+        }
+
+        iterator = iterator->next;
+        eraseList(detour->begin, false);
+        eraseList(detour->end->previous, false);
+        spliceList(iterator, detour);
+        deleteList(detour, false);
+    }
+
+    *cities = result;
+
+    return true;
+}
+
 /**
  * @brief Wydłuża drogę krajową do podanego miasta.
  * Dodaje do drogi krajowej nowe odcinki dróg do podanego miasta w taki sposób,
@@ -451,19 +1320,19 @@ void undoFindNewRouteAfterRemovingRoad(Route *route, City *city1, City *city2) {
  * odcinków dróg ten, który był najdawniej wybudowany.
  * @param[in,out] route         - wskaźnik drogę krajową;
  * @param[in] city              - wskaźnik na miasto;
- * @param[in] listOfCities      - wskaźnik na wszystkie miasta na danej mapie.
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry.
  * @return Wartość @p true, jeśli droga krajowa została wydłużona.
  * Wartość @p false, jeśli wystąpił błąd: nie można jednoznacznie
  * wyznaczyć nowego fragmentu drogi krajowej lub nie udało się zaalokować
  * pamięci.
  */
-bool findNewRouteAfterExtend(Route *route, City *city, List *listOfCities) {
+bool findNewRouteAfterExtend(Route *route, City *city, SearchState *state) {
     assert(route);
     assert(city);
-    assert(listOfCities);
+    assert(state);
 
     List *list = findRouteModule(route, city, route->cities->begin->data,
-                                 backList(route->cities), listOfCities);
+                                 backList(route->cities), state);
     if (list == NULL) {
         return false;
     }
@@ -503,6 +1372,58 @@ ListIterator *findRouteOnList(List *list, unsigned routeId) {
     return NULL;
 }
 
+/** @brief Zapisuje drogę krajową poprzedzoną liczbą w buforze.
+ * Zapisuje w buforze napis w formacie @ref getRouteDescription, w którym
+ * numer drogi krajowej zastąpiono podaną liczbą, obcięty do rozmiaru bufora
+ * i zakończony zerem. Nie alokuje pamięci.
+ * @param[in] route             - wskaźnik na drogę krajową;
+ * @param[in] number            - pierwsze pole napisu;
+ * @param[out] buffer           - wskaźnik na bufor lub NULL;
+ * @param[in] bufferSize        - rozmiar bufora (@p 0 dla NULL).
+ * @return Długość całego napisu (bez zera na końcu), także jeśli nie
+ * zmieścił się w buforze.
+ */
+size_t writeWithNumberRouteModule(Route *route, int64_t number, char *buffer,
+                                  size_t bufferSize) {
+    assert(route);
+
+    StringWriter writer;
+    initStringWriter(&writer, buffer, bufferSize);
+    appendStringWriterInteger(&writer, number);
+
+    ListIterator *iterator = route->cities->begin;
+    City *city = iterator->data;
+    appendStringWriterString(&writer, city->name);
+
+    while (iterator != route->cities->end->previous) {
+        Road *road = findRoadModule(iterator->data, iterator->next->data)->data;
+
+        appendStringWriterInteger(&writer, road->length);
+        appendStringWriterInteger(&writer, road->buildYearOrLastRepairYear);
+
+        iterator = iterator->next;
+        city = iterator->data;
+        appendStringWriterString(&writer, city->name);
+    }
+
+    return finishStringWriter(&writer);
+}
+
+/** @brief Zapisuje informacje o drodze krajowej w buforze.
+ * Zapisuje w buforze napis w formacie @ref getRouteDescription, obcięty do
+ * rozmiaru bufora i zakończony zerem. Nie alokuje pamięci.
+ * @param[in] route             - wskaźnik na drogę krajową;
+ * @param[out] buffer           - wskaźnik na bufor lub NULL;
+ * @param[in] bufferSize        - rozmiar bufora (@p 0 dla NULL).
+ * @return Długość całego napisu (bez zera na końcu), także jeśli nie
+ * zmieścił się w buforze.
+ */
+size_t writeDescriptionRouteModule(Route *route, char *buffer,
+                                   size_t bufferSize) {
+    return writeWithNumberRouteModule(route, route->routeId, buffer,
+                                      bufferSize);
+}
+
 /** @brief Udostępnia informacje o drodze krajowej.
  * Zwraca wskaźnik na napis, który zawiera informacje o drodze krajowej. Alokuje
  * pamięć na ten napis. Zaalokowaną pamięć trzeba zwolnić za pomocą funkcji free.
@@ -512,49 +1433,55 @@ ListIterator *findRouteOnList(List *list, unsigned routeId) {
 char *descriptionRouteModule(Route *route) {
     assert(route);
 
-    StringBuilder *result = newStringBuilder();
+    /* Pierwsze przejście mierzy napis, drugie go zapisuje. */
+    size_t size = writeDescriptionRouteModule(route, NULL, 0);
+    char *result = malloc((size + 1) * sizeof(char));
     if (result == NULL) {
         return NULL;
     }
 
-    if (!appendStringBuilderInteger(result, route->routeId)) {
-        deleteStringBuilder(result, true);
-        return NULL;
-    }
+    writeDescriptionRouteModule(route, result, size + 1);
 
-    ListIterator *iterator = route->cities->begin;
-    City *city = iterator->data;
-    if (!appendStringBuilderString(result, city->name)) {
-        deleteStringBuilder(result, true);
-        return NULL;
-    }
+    return result;
+}
+
+/** @brief Liczy długość drogi krajowej.
+ * @param[in] route             - wskaźnik na drogę krajową.
+ * @return Suma długości odcinków dróg drogi krajowej.
+ */
+uint64_t lengthRouteModule(Route *route) {
+    assert(route);
 
+    uint64_t result = 0;
+    ListIterator *iterator = route->cities->begin;
     while (iterator != route->cities->end->previous) {
         Road *road = findRoadModule(iterator->data, iterator->next->data)->data;
+        result += road->length;
+        iterator = iterator->next;
+    }
 
-        if (!appendStringBuilderInteger(result, road->length)) {
-            deleteStringBuilder(result, true);
-            return NULL;
-        }
+    return result;
+}
 
-        if (!appendStringBuilderInteger(result, road->buildYearOrLastRepairYear)) {
-            deleteStringBuilder(result, true);
-            return NULL;
-        }
+/** @brief Udostępnia informacje o wyznaczonej drodze.
+ * Działa jak @ref descriptionRouteModule, ale zamiast numeru drogi krajowej
+ * wypisuje jej długość.
+ * @param[in] route             - wskaźnik na drogę krajową;
+ * @param[out] length           - wskaźnik na długość drogi krajowej.
+ * @return Wskaźnik na napis lub NULL, gdy nie udało się zaalokować pamięci.
+ */
+char *queryDescriptionRouteModule(Route *route, uint64_t *length) {
+    assert(route && length);
 
-        iterator = iterator->next;
-        city = iterator->data;
+    *length = lengthRouteModule(route);
 
-        if (!appendStringBuilderString(result, city->name)) {
-            deleteStringBuilder(result, true);
-            return NULL;
-        }
+    size_t size = writeWithNumberRouteModule(route, *length, NULL, 0);
+    char *result = malloc((size + 1) * sizeof(char));
+    if (result == NULL) {
+        return NULL;
     }
 
-    /* Usuwamy niepotrzebny średnik z końca napisu. */
-    result->data[result->size - 1] = 0;
-    char *ptr = result->data;
-    deleteStringBuilder(result, false);
+    writeWithNumberRouteModule(route, *length, result, size + 1);
 
-    return ptr;
+    return result;
 }
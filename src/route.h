@@ -10,8 +10,12 @@
 
 #include "city.h"
 #include "list.h"
+#include "search_state.h"
+#include "replacement_paths.h"
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 /**
   * Struktura przechowująca drogę krajową.
@@ -20,8 +24,38 @@ typedef struct Route {
     unsigned routeId;           ///< numer drogi krajowej
     List *cities;               ///< lista miast na drodze krajowej
     bool wasChanged;            ///< czy droga jest w trakcie modyfikacji
+    ReplacementPaths *replacementPaths; ///< indeks objazdów odcinków lub NULL
 } Route;
 
+/** @brief Porównuje dwie drogi krajowe.
+ * Pierwsza droga jest lepsza jeśli ma mniejszą odległość. Jeśli dane dwie
+ * drogi mają taką samą odległość to lepsza jest ta, której
+ * najdawniej wybudowany odcinek jest najmłodszy.
+ * @param[in] distance1         - odległość pierwszej drogi;
+ * @param[in] oldestRoute1      - najdawniej wybudowany odcinek pierwszej drogi;
+ * @param[in] distance2         - odległość drugiej drogi;
+ * @param[in] oldestRoute2      - najdawniej wybudowany odcinek drugiej drogi.
+ * @return Zwraca 0 jeśli obie drogi są tak samo dobre. Zwraca ujemną wartość
+ * jeśli pierwsza droga jest lepsza niż druga. Zwraca dodatnią wartość
+ * w przeciwnym przypadku.
+ */
+int64_t compareRoutes(int64_t distance1, int64_t oldestRoute1,
+                      int64_t distance2, int64_t oldestRoute2);
+
+/** @brief Minimum dwóch liczb.
+ * @param x                     - pierwsza liczba;
+ * @param y                     - druga liczba.
+ * @return Minimum dwóch liczb.
+ */
+int64_t minInt64_t(int64_t x, int64_t y);
+
+/** @brief Maksimum dwóch liczb.
+ * @param x                     - pierwsza liczba;
+ * @param y                     - druga liczba.
+ * @return Maksimum dwóch liczb.
+ */
+int64_t maxInt64_t(int64_t x, int64_t y);
+
 /** @brief Tworzy strukturę.
  * Tworzy drogę krajową pomiędzy dwoma miastami i nadaje jej podany numer.
  * Wśród istniejących odcinków dróg wyszukuje najkrótszą drogę. Jeśli jest
@@ -31,14 +65,34 @@ typedef struct Route {
  * @param[in] routeId           - numer drogi krajowej;
  * @param[in] city1             - wskaźnik na pierwsze miasto;
  * @param[in] city2             - wskaźnik na drugie miasto;
- * @param[in] listOfCities      - wskaźnik na wszystkie miasta na danej mapie.
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry.
  * @return Wartość @p true, jeśli droga krajowa została utworzona.
  * Wartość @p false, jeśli wystąpił błąd: nie można
  * jednoznacznie wyznaczyć drogi krajowej między podanymi miastami lub nie udało
  * się zaalokować pamięci.
  */
 Route *newRouteModule(unsigned routeId, City *city1, City *city2,
-                      List *listOfCities);
+                      SearchState *state);
+
+/** @brief Tworzy drogi krajowe z jednego miasta.
+ * Dla każdego miasta @p to[i] różnego od NULL tworzy drogę krajową numer
+ * @p routeIds[i] tak jak @ref newRouteModule i zapisuje ją w @p routes[i]
+ * (NULL, jeśli drogi nie można jednoznacznie wyznaczyć). Najlepsze drogi do
+ * wszystkich miast liczy jeden algorytm dijkstry z miasta @p from, a ich
+ * jednoznaczność jedno przejście dla każdego różnego najstarszego odcinka.
+ * Jeśli stan algorytmu wybiera hierarchię kontrakcji, to drogi wyznaczane są
+ * osobno, bo zapytania w hierarchii są tańsze od przejścia całej mapy.
+ * @param[in] routeIds          - wskaźnik na tablicę numerów dróg krajowych;
+ * @param[in] from              - wskaźnik na miasto startowe;
+ * @param[in] to                - wskaźnik na tablicę miast docelowych;
+ * @param[in] count             - liczba miast docelowych;
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry;
+ * @param[out] routes           - wskaźnik na tablicę tworzonych dróg.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci (wtedy wszystkie elementy @p routes mają wartość NULL).
+ */
+bool newRoutesModule(const unsigned *routeIds, City *from, City **to,
+                     uint32_t count, SearchState *state, Route **routes);
 
 /** @brief Usuwa strukturę.
  * @param[in,out] route         - wskaźnik na drogę krajową do usunięcia.
@@ -56,12 +110,150 @@ void deleteRouteModule(Route *route);
  * @param[in,out] route         - wskaźnik drogę krajową do poprawienie;
  * @param[in] city1             - wskaźnik na pierwsze miasto;
  * @param[in] city2             - wskaźnik na drugie miasto;
- * @param listOfCities          - wskaźnik na wszystkie miasta na danej mapie.
+ * @param[in] shared            - wskaźnik na objazd wspólny dla dróg
+ *                                krajowych lub NULL
+ *                                (zob. @ref findSharedDetourAfterRemovingRoad);
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry.
  * @return Wartość @p true jeśli udało się poprawić drogę krajową, lub @p false,
  * jeśli nie udało się zaalokować pamięci.
  */
 bool findNewRouteAfterRemovingRoad(Route *route, City *city1, City *city2,
-                                   List *listOfCities);
+                                   const List *shared, SearchState *state);
+
+/** @brief Znajduje usunięty odcinek na drodze krajowej.
+ * Szuka na drodze krajowej odcinka drogowego pomiędzy miastami @p city1
+ * oraz @p city2.
+ * @param[in] route             - wskaźnik na drogę krajową;
+ * @param[in] city1             - wskaźnik na pierwsze miasto;
+ * @param[in] city2             - wskaźnik na drugie miasto.
+ * @return Wskaźnik na węzeł listy miast drogi krajowej zawierający pierwsze
+ * miasto odcinka lub NULL, jeśli odcinek nie należy do drogi krajowej.
+ */
+ListIterator *findRemovedRoadOnRoute(Route *route, City *city1, City *city2);
+
+/** @brief Wyznacza objazd odcinka drogi krajowej do indeksu objazdów.
+ * Wyszukiwanie pomija odcinek (@ref SearchState.skippedRoads), więc mapa nie
+ * jest zmieniana i funkcja może być wywoływana równolegle dla różnych dróg
+ * krajowych z różnymi stanami algorytmu. Objazd, którego nie udało się
+ * jednoznacznie wyznaczyć, ma wartość NULL.
+ * @param[in] route             - wskaźnik na drogę krajową;
+ * @param[in,out] path          - wskaźnik na objazd z indeksu drogi krajowej;
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry.
+ */
+void buildReplacementPathRouteModule(Route *route, ReplacementPath *path,
+                                     SearchState *state);
+
+/** @brief Odczytuje objazd z indeksu objazdów drogi krajowej.
+ * Nieaktualny objazd jest najpierw wyznaczany ponownie. Objazd, którego nie
+ * udało się jednoznacznie wyznaczyć, jest wyznaczany ponownie przy każdym
+ * odczycie, bo usunięcie odcinka drogi mogło sprawić, że objazd stał się
+ * jednoznaczny. Pomijane odcinki stanu algorytmu są potem wyzerowane.
+ * @param[in,out] route         - wskaźnik na drogę krajową;
+ * @param[in] city1             - wskaźnik na wcześniejsze miasto odcinka;
+ * @param[in] city2             - wskaźnik na późniejsze miasto odcinka;
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry;
+ * @param[out] detour           - wskaźnik na kopię objazdu lub NULL, jeśli
+ *                                nie da się go jednoznacznie wyznaczyć lub
+ *                                nie udało się zaalokować pamięci.
+ * @return Wartość @p true, jeśli indeks zawiera odcinek, lub @p false
+ * w przeciwnym przypadku.
+ */
+bool findReplacementPathRouteModule(Route *route, City *city1, City *city2,
+                                    SearchState *state, List **detour);
+
+/** @brief Wyznacza objazd odcinka wspólny dla dróg krajowych.
+ * Wyszukuje jedną drogę z @p city1 do @p city2 bez wykluczonych miast,
+ * pomijając odcinek między nimi (@ref SearchState.skippedRoads). Najlepszy
+ * objazd drogi krajowej wyklucza jej miasta, więc jeśli wspólna droga ich
+ * omija, to jest też jednoznacznym objazdem tej drogi krajowej
+ * (zob. @ref copySharedDetourAfterRemovingRoad). Funkcja nie modyfikuje
+ * mapy.
+ * @param[in] city1             - wskaźnik na pierwsze miasto odcinka;
+ * @param[in] city2             - wskaźnik na drugie miasto odcinka;
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry.
+ * @return Wskaźnik na listę miast objazdu od @p city1 do @p city2 lub NULL,
+ * jeśli nie jest on jednoznaczny lub nie udało się zaalokować pamięci.
+ */
+List *findSharedDetourAfterRemovingRoad(City *city1, City *city2,
+                                        SearchState *state);
+
+/** @brief Kopiuje objazd wspólny dla dróg krajowych.
+ * Wspólny objazd jest najlepszą drogą między końcami odcinka bez
+ * wykluczonych miast. Jeśli omija miasta drogi krajowej, to jest najlepszy
+ * także wśród dróg, które je omijają, a jednoznaczny bez wykluczeń jest
+ * jednoznaczny również z nimi.
+ * @param[in] route             - wskaźnik na drogę krajową;
+ * @param[in] from              - wskaźnik na wcześniejsze miasto odcinka;
+ * @param[in] to                - wskaźnik na późniejsze miasto odcinka;
+ * @param[in] shared            - wskaźnik na wspólny objazd lub NULL;
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry;
+ * @param[out] detour           - wskaźnik na kopię objazdu od @p from do
+ *                                @p to.
+ * @return Wartość @p true, jeśli objazd omija miasta drogi krajowej i udało
+ * się go skopiować, lub @p false w przeciwnym przypadku.
+ */
+bool copySharedDetourAfterRemovingRoad(Route *route, City *from, City *to,
+                                       const List *shared, SearchState *state,
+                                       List **detour);
+
+/** @brief Znajduje objazd dla drogi krajowej.
+ * Znajduje objazd dla drogi krajowej po usunięciu odcinka drogi między dwoma
+ * miastami tak jak @ref findNewRouteAfterRemovingRoad, ale nie modyfikuje
+ * drogi krajowej. Funkcja nie modyfikuje mapy, więc może być wywoływana
+ * równolegle dla różnych dróg krajowych z różnymi stanami algorytmu. Aktualny
+ * objazd z indeksu objazdów drogi krajowej (@ref ReplacementPaths) jest
+ * kopiowany bez wyszukiwania, a nieaktualny jest najpierw wyznaczany
+ * ponownie i zapamiętywany w indeksie.
+ * @param[in] route             - wskaźnik drogę krajową;
+ * @param[in] city1             - wskaźnik na pierwsze miasto;
+ * @param[in] city2             - wskaźnik na drugie miasto;
+ * @param[in] shared            - wskaźnik na objazd wspólny dla dróg
+ *                                krajowych lub NULL
+ *                                (zob. @ref findSharedDetourAfterRemovingRoad);
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry;
+ * @param[out] detour           - wskaźnik na znaleziony objazd lub NULL, jeśli
+ *                                droga krajowa nie wymaga objazdu.
+ * @return Wartość @p true jeśli droga krajowa nie wymaga objazdu lub udało się
+ * go jednoznacznie wyznaczyć. Wartość @p false w przeciwnym przypadku.
+ */
+bool findDetourAfterRemovingRoad(Route *route, City *city1, City *city2,
+                                 const List *shared, SearchState *state,
+                                 List **detour);
+
+/** @brief Wyznacza długość objazdu bez oznaczania odcinka jako usuwanego.
+ * Działa jak @ref findDetourAfterRemovingRoad, ale odcinek między miastami
+ * @p city1 i @p city2 jest tylko pomijany przez wyszukiwania w stanie
+ * algorytmu (@ref SearchState.skippedRoads), więc ani mapa, ani droga
+ * krajowa nie są zmieniane. Może być wywoływana równolegle dla różnych dróg
+ * krajowych z różnymi stanami algorytmu.
+ * @param[in] route             - wskaźnik drogę krajową;
+ * @param[in] city1             - wskaźnik na pierwsze miasto;
+ * @param[in] city2             - wskaźnik na drugie miasto;
+ * @param[in] shared            - wskaźnik na objazd wspólny dla dróg
+ *                                krajowych lub NULL
+ *                                (zob. @ref findSharedDetourAfterRemovingRoad);
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry;
+ * @param[out] length           - wskaźnik na długość objazdu, @p 0, jeśli
+ *                                droga krajowa nie wymaga objazdu, lub
+ *                                @p -1, jeśli nie udało się go wyznaczyć.
+ * @return Wartość @p true jeśli droga krajowa nie wymaga objazdu lub udało się
+ * go jednoznacznie wyznaczyć. Wartość @p false w przeciwnym przypadku.
+ */
+bool findDetourLengthAfterRemovingRoad(Route *route, City *city1, City *city2,
+                                       const List *shared, SearchState *state,
+                                       int64_t *length);
+
+/** @brief Wstawia objazd do drogi krajowej.
+ * Wstawia objazd znaleziony przez @ref findDetourAfterRemovingRoad w miejsce
+ * usuwanego odcinka drogi. Usuwa strukturę @p detour. Po wywołaniu zmiany
+ * można cofnąć funkcją @ref undoFindNewRouteAfterRemovingRoad.
+ * @param[in,out] route         - wskaźnik drogę krajową;
+ * @param[in] city1             - wskaźnik na pierwsze miasto;
+ * @param[in] city2             - wskaźnik na drugie miasto;
+ * @param[in,out] detour        - wskaźnik na objazd lub NULL.
+ */
+void applyDetourAfterRemovingRoad(Route *route, City *city1, City *city2,
+                                  List *detour);
 
 /** @brief Cofa zmiany wywołane przez @ref findNewRouteAfterRemovingRoad.
  * Cofa zmiany wywołane przez ostatnie użycie
@@ -74,6 +266,35 @@ bool findNewRouteAfterRemovingRoad(Route *route, City *city1, City *city2,
  */
 void undoFindNewRouteAfterRemovingRoad(Route *route, City *city1, City *city2);
 
+/** @brief Wyznacza drogę krajową po usunięciu wielu odcinków dróg.
+ * Usuwane odcinki muszą być oznaczone jako usuwane (@ref Road.isDeleted).
+ * Kopiuje miasta drogi krajowej i zastępuje w kopii kolejne (wzdłuż drogi)
+ * usuwane odcinki objazdami wyznaczonymi jak w
+ * @ref findDetourAfterRemovingRoad, które omijają wszystkie miasta kopii,
+ * także z wstawionych wcześniej objazdów. Objazd usuwanego odcinka, którego
+ * wspólny objazd omija miasta kopii, jest kopiowany zamiast wyszukiwany
+ * (zob. @ref copySharedDetourAfterRemovingRoad). Nie modyfikuje drogi
+ * krajowej ani mapy, więc może być wywoływana równolegle dla różnych dróg
+ * krajowych z różnymi stanami algorytmu.
+ * @param[in] route             - wskaźnik drogę krajową;
+ * @param[in] removed           - wskaźnik na tablicę par końców usuwanych
+ *                                odcinków;
+ * @param[in] shared            - wskaźnik na tablicę wspólnych objazdów
+ *                                usuwanych odcinków (NULL dla odcinka bez
+ *                                wspólnego objazdu) lub NULL;
+ * @param[in] count             - liczba usuwanych odcinków;
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry;
+ * @param[out] cities           - wskaźnik na nową listę miast drogi krajowej
+ *                                lub NULL, jeśli droga krajowa nie przechodzi
+ *                                przez żaden usuwany odcinek.
+ * @return Wartość @p true jeśli droga krajowa nie wymaga objazdów lub udało
+ * się je jednoznacznie wyznaczyć. Wartość @p false, jeśli któregoś objazdu
+ * nie da się jednoznacznie wyznaczyć lub nie udało się zaalokować pamięci.
+ */
+bool findDetoursAfterRemovingRoads(Route *route, City *const *removed,
+                                   List *const *shared, size_t count,
+                                   SearchState *state, List **cities);
+
 /**
  * @brief Wydłuża drogę krajową do podanego miasta.
  * Dodaje do drogi krajowej nowe odcinki dróg do podanego miasta w taki sposób,
@@ -82,13 +303,13 @@ void undoFindNewRouteAfterRemovingRoad(Route *route, City *city1, City *city2);
  * odcinków dróg ten, który był najdawniej wybudowany.
  * @param[in,out] route         - wskaźnik drogę krajową;
  * @param[in] city              - wskaźnik na miasto;
- * @param[in] listOfCities      - wskaźnik na wszystkie miasta na danej mapie.
+ * @param[in,out] state         - wskaźnik na stan algorytmu dijkstry.
  * @return Wartość @p true, jeśli droga krajowa została wydłużona.
  * Wartość @p false, jeśli wystąpił błąd: nie można jednoznacznie
  * wyznaczyć nowego fragmentu drogi krajowej lub nie udało się zaalokować
  * pamięci.
  */
-bool findNewRouteAfterExtend(Route *route, City *city, List *listOfCities);
+bool findNewRouteAfterExtend(Route *route, City *city, SearchState *state);
 
 /** @brief Znajduję drogę krajową na liście.
  * Znajduję drogę krajową o danym numerze na liście.
@@ -99,6 +320,18 @@ bool findNewRouteAfterExtend(Route *route, City *city, List *listOfCities);
  */
 ListIterator *findRouteOnList(List *list, unsigned routeId);
 
+/** @brief Zapisuje informacje o drodze krajowej w buforze.
+ * Zapisuje w buforze napis w formacie @ref getRouteDescription, obcięty do
+ * rozmiaru bufora i zakończony zerem. Nie alokuje pamięci.
+ * @param[in] route             - wskaźnik na drogę krajową;
+ * @param[out] buffer           - wskaźnik na bufor lub NULL;
+ * @param[in] bufferSize        - rozmiar bufora (@p 0 dla NULL).
+ * @return Długość całego napisu (bez zera na końcu), także jeśli nie
+ * zmieścił się w buforze.
+ */
+size_t writeDescriptionRouteModule(Route *route, char *buffer,
+                                   size_t bufferSize);
+
 /** @brief Udostępnia informacje o drodze krajowej.
  * Zwraca wskaźnik na napis, który zawiera informacje o drodze krajowej. Alokuje
  * pamięć na ten napis. Zaalokowaną pamięć trzeba zwolnić za pomocą funkcji free.
@@ -107,4 +340,19 @@ ListIterator *findRouteOnList(List *list, unsigned routeId);
  */
 char *descriptionRouteModule(Route *route);
 
+/** @brief Liczy długość drogi krajowej.
+ * @param[in] route             - wskaźnik na drogę krajową.
+ * @return Suma długości odcinków dróg drogi krajowej.
+ */
+uint64_t lengthRouteModule(Route *route);
+
+/** @brief Udostępnia informacje o wyznaczonej drodze.
+ * Działa jak @ref descriptionRouteModule, ale zamiast numeru drogi krajowej
+ * wypisuje jej długość.
+ * @param[in] route             - wskaźnik na drogę krajową;
+ * @param[out] length           - wskaźnik na długość drogi krajowej.
+ * @return Wskaźnik na napis lub NULL, gdy nie udało się zaalokować pamięci.
+ */
+char *queryDescriptionRouteModule(Route *route, uint64_t *length);
+
 #endif // ROUTE_H
@@ -0,0 +1,162 @@
+/** @file
+ * Implementacja wątków czytających opisy dróg krajowych równolegle
+ * z wykonywaniem poleceń.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "route_readers.h"
+
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define ROUTE_READERS_BUFFER_SIZE 4096
+///< rozmiar bufora wątku czytającego (dłuższe opisy są obcinane)
+
+#define ROUTE_READERS_BATCH_SIZE 64
+///< liczba odczytów między sprawdzeniami, czy zatrzymać wątek
+
+/**
+ * Struktura przechowująca stan jednego wątku czytającego.
+ */
+typedef struct RouteReader {
+    struct RouteReaders *readers;   ///< wskaźnik na wszystkie wątki
+    pthread_t thread;               ///< wątek
+    int32_t reader;                 ///< numer wątku czytającego mapy
+    uint64_t readsCount;            ///< liczba wykonanych odczytów
+} RouteReader;
+
+/**
+ * Struktura przechowująca wątki czytające.
+ */
+typedef struct RouteReaders {
+    Map *map;                       ///< wskaźnik na mapę
+    RouteReader *threads;           ///< stany wątków
+    uint32_t threadsCount;          ///< liczba uruchomionych wątków
+    atomic_bool isStopped;          ///< czy wątki mają się zakończyć
+    uint64_t start;                 ///< czas uruchomienia wątków
+} RouteReaders;
+
+/** @brief Funkcja wykonywana przez wątek czytający.
+ * Czyta opisy dróg krajowych o numerach z generatora liniowego, dopóki wątek
+ * nie zostanie zatrzymany.
+ * @param[in] data              - wskaźnik na @ref RouteReader.
+ * @return Wartość NULL.
+ */
+void *threadRouteReaders(void *data) {
+    RouteReader *reader = data;
+    Map *map = reader->readers->map;
+    char buffer[ROUTE_READERS_BUFFER_SIZE];
+
+    uint32_t state = (uint32_t) reader->reader * 2654435761u + 1;
+    uint64_t readsCount = 0;
+    while (!atomic_load_explicit(&reader->readers->isStopped,
+                                 memory_order_relaxed)) {
+        for (uint32_t i = 0; i < ROUTE_READERS_BATCH_SIZE; i++) {
+            state = state * 1103515245u + 12345u;
+            unsigned routeId = 1 + (state >> 8) % (ROUTE_SNAPSHOTS_SIZE - 1);
+            readRouteDescriptionMap(map, reader->reader, routeId, buffer,
+                                    sizeof(buffer));
+        }
+        readsCount += ROUTE_READERS_BATCH_SIZE;
+    }
+
+    reader->readsCount = readsCount;
+    return NULL;
+}
+
+/** @brief Zatrzymuje uruchomione wątki i wyrejestrowuje wątki czytające.
+ * @param[in,out] readers       - wskaźnik na strukturę;
+ * @param[in] startedCount      - liczba uruchomionych wątków;
+ * @param[in] registeredCount   - liczba zarejestrowanych wątków czytających.
+ */
+void stopRouteReaders(RouteReaders *readers, uint32_t startedCount,
+                      uint32_t registeredCount) {
+    assert(readers);
+
+    atomic_store(&readers->isStopped, true);
+    for (uint32_t i = 0; i < startedCount; i++) {
+        pthread_join(readers->threads[i].thread, NULL);
+    }
+    for (uint32_t i = 0; i < registeredCount; i++) {
+        deleteReaderMap(readers->map, readers->threads[i].reader);
+    }
+}
+
+/** @brief Uruchamia wątki czytające.
+ * Mapa musi mieć włączone współbieżne odczyty (@ref setConcurrentReadsMap).
+ * @param[in,out] map           - wskaźnik na mapę;
+ * @param[in] threadsCount      - liczba wątków czytających.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci, utworzyć wątków lub zarejestrować wątków czytających.
+ */
+RouteReaders *newRouteReaders(Map *map, uint32_t threadsCount) {
+    assert(map && map->snapshots);
+    assert(threadsCount > 0);
+
+    RouteReaders *result = malloc(sizeof(RouteReaders));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    result->threads = calloc(threadsCount, sizeof(RouteReader));
+    if (result->threads == NULL) {
+        free(result);
+        return NULL;
+    }
+
+    result->map = map;
+    result->threadsCount = threadsCount;
+    atomic_init(&result->isStopped, false);
+
+    for (uint32_t i = 0; i < threadsCount; i++) {
+        result->threads[i].readers = result;
+        result->threads[i].reader = newReaderMap(map);
+        if (result->threads[i].reader == -1) {
+            stopRouteReaders(result, 0, i);
+            free(result->threads);
+            free(result);
+            return NULL;
+        }
+    }
+
+    result->start = nanosecondsJournal();
+    for (uint32_t i = 0; i < threadsCount; i++) {
+        if (pthread_create(&result->threads[i].thread, NULL,
+                           threadRouteReaders, &result->threads[i]) != 0) {
+            stopRouteReaders(result, i, threadsCount);
+            free(result->threads);
+            free(result);
+            return NULL;
+        }
+    }
+
+    return result;
+}
+
+/** @brief Zatrzymuje wątki czytające i usuwa strukturę.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] readers           - wskaźnik na usuwaną strukturę;
+ * @param[out] statistics       - wskaźnik na wynik pomiaru lub NULL.
+ */
+void deleteRouteReaders(RouteReaders *readers,
+                        RouteReadersStatistics *statistics) {
+    if (readers == NULL) {
+        return;
+    }
+
+    stopRouteReaders(readers, readers->threadsCount, readers->threadsCount);
+    if (statistics != NULL) {
+        statistics->nanoseconds = nanosecondsJournal() - readers->start;
+        statistics->readsCount = 0;
+        for (uint32_t i = 0; i < readers->threadsCount; i++) {
+            statistics->readsCount += readers->threads[i].readsCount;
+        }
+    }
+
+    free(readers->threads);
+    free(readers);
+}
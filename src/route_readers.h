@@ -0,0 +1,51 @@
+/** @file
+ * Interfejs wątków czytających opisy dróg krajowych równolegle z wykonywaniem
+ * poleceń.
+ *
+ * Wątki w pętli czytają funkcją @ref readRouteDescriptionMap opisy losowych
+ * dróg krajowych, podczas gdy wątek główny wykonuje polecenia modyfikujące
+ * mapę. Służą do pomiaru przepustowości odczytów w zależności od liczby
+ * wątków.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef ROUTE_READERS_H
+#define ROUTE_READERS_H
+
+#include "map.h"
+
+#include <stdint.h>
+
+/**
+ * Struktura przechowująca wątki czytające.
+ */
+typedef struct RouteReaders RouteReaders;
+
+/**
+ * Struktura przechowująca wynik pomiaru odczytów.
+ */
+typedef struct RouteReadersStatistics {
+    uint64_t readsCount;            ///< liczba odczytów wszystkich wątków
+    uint64_t nanoseconds;           ///< czas od uruchomienia do zatrzymania
+} RouteReadersStatistics;
+
+/** @brief Uruchamia wątki czytające.
+ * Mapa musi mieć włączone współbieżne odczyty (@ref setConcurrentReadsMap).
+ * @param[in,out] map           - wskaźnik na mapę;
+ * @param[in] threadsCount      - liczba wątków czytających.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci, utworzyć wątków lub zarejestrować wątków czytających.
+ */
+RouteReaders *newRouteReaders(Map *map, uint32_t threadsCount);
+
+/** @brief Zatrzymuje wątki czytające i usuwa strukturę.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] readers           - wskaźnik na usuwaną strukturę;
+ * @param[out] statistics       - wskaźnik na wynik pomiaru lub NULL.
+ */
+void deleteRouteReaders(RouteReaders *readers,
+                        RouteReadersStatistics *statistics);
+
+#endif // ROUTE_READERS_H
@@ -0,0 +1,334 @@
+/** @file
+ * Implementacja klasy przechowującej opublikowane opisy dróg krajowych.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "route_snapshots.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdatomic.h>
+
+#define ROUTE_SNAPSHOTS_CACHE_LINE 64
+///< rozmiar linii pamięci podręcznej, na której leży miejsce czytającego
+
+/**
+ * Struktura przechowująca opis drogi krajowej.
+ */
+typedef struct RouteSnapshot {
+    size_t length;                  ///< długość opisu (bez zera na końcu)
+    char description[];             ///< opis zakończony zerem
+} RouteSnapshot;
+
+/**
+ * Struktura przechowująca zastąpiony opis czekający na zwolnienie.
+ */
+typedef struct RetiredSnapshot {
+    RouteSnapshot *snapshot;        ///< zastąpiony opis
+    uint64_t epoch;                 ///< epoka, w której go zastąpiono
+} RetiredSnapshot;
+
+/**
+ * Struktura przechowująca miejsce wątku czytającego. Każde miejsce leży na
+ * osobnej linii pamięci podręcznej, więc czytający nie unieważniają sobie
+ * nawzajem linii.
+ */
+typedef struct ReaderSlot {
+    _Alignas(ROUTE_SNAPSHOTS_CACHE_LINE)
+    atomic_uint_fast64_t epoch;     ///< epoka początku odczytu lub @p 0
+    atomic_bool isUsed;             ///< czy miejsce jest zajęte
+} ReaderSlot;
+
+/**
+ * Struktura przechowująca opublikowane opisy dróg krajowych.
+ */
+typedef struct RouteSnapshots {
+    ReaderSlot readers[ROUTE_SNAPSHOTS_MAX_READERS];    ///< miejsca czytających
+    _Atomic(RouteSnapshot *) routes[ROUTE_SNAPSHOTS_SIZE];
+                                    ///< opisy kolejnych dróg krajowych
+    atomic_uint_fast64_t epoch;     ///< bieżąca epoka (od @p 1)
+    bool isMarked[ROUTE_SNAPSHOTS_SIZE];    ///< czy droga jest oznaczona
+    unsigned markedRoutes[ROUTE_SNAPSHOTS_SIZE];    ///< oznaczone drogi
+    uint32_t markedCount;           ///< liczba oznaczonych dróg
+    RetiredSnapshot *retired;       ///< opisy czekające na zwolnienie
+    size_t retiredCount;            ///< liczba opisów czekających
+    size_t retiredMemorySize;       ///< rozmiar tablicy @ref retired
+    uint64_t publishedCount;        ///< liczba utworzonych opisów
+    uint64_t reclaimedCount;        ///< liczba zwolnionych opisów
+} RouteSnapshots;
+
+/** @brief Tworzy strukturę bez opisów dróg krajowych.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci.
+ */
+RouteSnapshots *newRouteSnapshots(void) {
+    RouteSnapshots *result = aligned_alloc(_Alignof(RouteSnapshots),
+                                           sizeof(RouteSnapshots));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    memset(result, 0, sizeof(RouteSnapshots));
+    for (uint32_t i = 0; i < ROUTE_SNAPSHOTS_MAX_READERS; i++) {
+        atomic_init(&result->readers[i].epoch, 0);
+        atomic_init(&result->readers[i].isUsed, false);
+    }
+    for (uint32_t i = 0; i < ROUTE_SNAPSHOTS_SIZE; i++) {
+        atomic_init(&result->routes[i], NULL);
+    }
+    atomic_init(&result->epoch, 1);
+
+    return result;
+}
+
+/** @brief Usuwa strukturę.
+ * Żaden wątek czytający nie może być wtedy zarejestrowany. Nic nie robi,
+ * jeśli wskaźnik ma wartość NULL.
+ * @param[in] snapshots         - wskaźnik na usuwaną strukturę.
+ */
+void deleteRouteSnapshots(RouteSnapshots *snapshots) {
+    if (snapshots == NULL) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < ROUTE_SNAPSHOTS_SIZE; i++) {
+        free(atomic_load(&snapshots->routes[i]));
+    }
+    for (size_t i = 0; i < snapshots->retiredCount; i++) {
+        free(snapshots->retired[i].snapshot);
+    }
+    free(snapshots->retired);
+    free(snapshots);
+}
+
+/** @brief Oznacza drogę krajową do ponownej publikacji.
+ * Funkcja wątku piszącego.
+ * @param[in,out] snapshots     - wskaźnik na strukturę;
+ * @param[in] routeId           - numer drogi krajowej.
+ */
+void markRouteSnapshots(RouteSnapshots *snapshots, unsigned routeId) {
+    assert(snapshots);
+
+    if (routeId >= ROUTE_SNAPSHOTS_SIZE || snapshots->isMarked[routeId]) {
+        return;
+    }
+
+    snapshots->isMarked[routeId] = true;
+    snapshots->markedRoutes[snapshots->markedCount++] = routeId;
+}
+
+/** @brief Zwalnia zastąpione opisy, których nie czyta żaden wątek.
+ * Opis zastąpiony w epoce @p e może czytać tylko wątek, który zaczął odczyt
+ * w epoce nie większej niż @p e.
+ * @param[in,out] snapshots     - wskaźnik na strukturę.
+ */
+void reclaimRouteSnapshots(RouteSnapshots *snapshots) {
+    assert(snapshots);
+
+    uint64_t minEpoch = UINT64_MAX;
+    for (uint32_t i = 0; i < ROUTE_SNAPSHOTS_MAX_READERS; i++) {
+        uint64_t epoch = atomic_load(&snapshots->readers[i].epoch);
+        if (epoch != 0 && epoch < minEpoch) {
+            minEpoch = epoch;
+        }
+    }
+
+    size_t keptCount = 0;
+    for (size_t i = 0; i < snapshots->retiredCount; i++) {
+        if (snapshots->retired[i].epoch < minEpoch) {
+            free(snapshots->retired[i].snapshot);
+            snapshots->reclaimedCount++;
+        } else {
+            snapshots->retired[keptCount++] = snapshots->retired[i];
+        }
+    }
+    snapshots->retiredCount = keptCount;
+}
+
+/** @brief Tworzy opis drogi krajowej.
+ * @param[in] routeId           - numer drogi krajowej;
+ * @param[in] writer            - funkcja zapisująca opis;
+ * @param[in,out] argument      - wskaźnik przekazywany do @p writer;
+ * @param[out] snapshot         - wskaźnik na utworzony opis lub NULL, jeśli
+ *                                droga krajowa nie istnieje.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool createRouteSnapshots(unsigned routeId, RouteDescriptionWriter writer,
+                          void *argument, RouteSnapshot **snapshot) {
+    size_t length = writer(argument, routeId, NULL, 0);
+    if (length == 0) {
+        *snapshot = NULL;
+        return true;
+    }
+
+    *snapshot = malloc(sizeof(RouteSnapshot) + length + 1);
+    if (*snapshot == NULL) {
+        return false;
+    }
+
+    (*snapshot)->length = length;
+    writer(argument, routeId, (*snapshot)->description, length + 1);
+    return true;
+}
+
+/** @brief Publikuje opisy oznaczonych dróg krajowych.
+ * Funkcja wątku piszącego. Tworzy nowe opisy funkcją @p writer, podmienia je
+ * i zwalnia stare opisy, których nie czyta już żaden wątek. Drogi krajowe,
+ * których opisu nie udało się utworzyć, pozostają oznaczone.
+ * @param[in,out] snapshots     - wskaźnik na strukturę;
+ * @param[in] writer            - funkcja zapisująca opis;
+ * @param[in,out] argument      - wskaźnik przekazywany do @p writer.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool publishRouteSnapshots(RouteSnapshots *snapshots,
+                           RouteDescriptionWriter writer, void *argument) {
+    assert(snapshots);
+    assert(writer);
+
+    if (snapshots->markedCount == 0) {
+        return true;
+    }
+
+    size_t memorySize = snapshots->retiredCount + snapshots->markedCount;
+    if (memorySize > snapshots->retiredMemorySize) {
+        memorySize = memorySize < 2 * snapshots->retiredMemorySize ?
+                     2 * snapshots->retiredMemorySize : memorySize;
+        RetiredSnapshot *retired = realloc(snapshots->retired,
+                                           sizeof(RetiredSnapshot) *
+                                           memorySize);
+        if (retired == NULL) {
+            return false;
+        }
+        snapshots->retired = retired;
+        snapshots->retiredMemorySize = memorySize;
+    }
+
+    bool result = true;
+    uint32_t keptCount = 0;
+    for (uint32_t i = 0; i < snapshots->markedCount; i++) {
+        unsigned routeId = snapshots->markedRoutes[i];
+        RouteSnapshot *snapshot;
+        if (!createRouteSnapshots(routeId, writer, argument, &snapshot)) {
+            snapshots->markedRoutes[keptCount++] = routeId;
+            result = false;
+            continue;
+        }
+
+        snapshots->isMarked[routeId] = false;
+        if (snapshot != NULL) {
+            snapshots->publishedCount++;
+        }
+
+        RouteSnapshot *old = atomic_exchange(&snapshots->routes[routeId],
+                                             snapshot);
+        if (old != NULL) {
+            RetiredSnapshot *retired =
+                    &snapshots->retired[snapshots->retiredCount++];
+            retired->snapshot = old;
+            retired->epoch = atomic_fetch_add(&snapshots->epoch, 1);
+        }
+    }
+    snapshots->markedCount = keptCount;
+
+    reclaimRouteSnapshots(snapshots);
+    return result;
+}
+
+/** @brief Rejestruje wątek czytający.
+ * @param[in,out] snapshots     - wskaźnik na strukturę.
+ * @return Numer miejsca wątku czytającego lub @p -1, jeśli wszystkie
+ * @ref ROUTE_SNAPSHOTS_MAX_READERS miejsc jest zajętych.
+ */
+int32_t newReaderRouteSnapshots(RouteSnapshots *snapshots) {
+    assert(snapshots);
+
+    for (int32_t i = 0; i < ROUTE_SNAPSHOTS_MAX_READERS; i++) {
+        bool isUsed = false;
+        if (atomic_compare_exchange_strong(&snapshots->readers[i].isUsed,
+                                           &isUsed, true)) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/** @brief Wyrejestrowuje wątek czytający.
+ * @param[in,out] snapshots     - wskaźnik na strukturę;
+ * @param[in] reader            - numer miejsca wątku czytającego.
+ */
+void deleteReaderRouteSnapshots(RouteSnapshots *snapshots, int32_t reader) {
+    assert(snapshots);
+    assert(0 <= reader && reader < ROUTE_SNAPSHOTS_MAX_READERS);
+
+    atomic_store(&snapshots->readers[reader].isUsed, false);
+}
+
+/** @brief Zapisuje opublikowany opis drogi krajowej w buforze.
+ * Może być wywoływana równolegle z innymi wątkami czytającymi i z wątkiem
+ * piszącym. Wynik jak w @ref writeRouteDescription.
+ * @param[in,out] snapshots     - wskaźnik na strukturę;
+ * @param[in] reader            - numer miejsca wątku czytającego;
+ * @param[in] routeId           - numer drogi krajowej;
+ * @param[out] buffer           - wskaźnik na bufor lub NULL;
+ * @param[in] bufferSize        - rozmiar bufora (@p 0 dla NULL).
+ * @return Długość całego opisu (bez zera na końcu), także jeśli nie
+ * zmieścił się w buforze.
+ */
+size_t readRouteSnapshots(RouteSnapshots *snapshots, int32_t reader,
+                          unsigned routeId, char *buffer, size_t bufferSize) {
+    assert(snapshots);
+    assert(0 <= reader && reader < ROUTE_SNAPSHOTS_MAX_READERS);
+    assert(buffer != NULL || bufferSize == 0);
+
+    if (routeId >= ROUTE_SNAPSHOTS_SIZE) {
+        if (bufferSize > 0) {
+            *buffer = 0;
+        }
+        return 0;
+    }
+
+    /* Zapis epoki musi poprzedzać odczyt wskaźnika, tak jak w wątku
+     * piszącym podmiana wskaźnika poprzedza zwiększenie epoki, więc obie
+     * operacje są sekwencyjnie spójne. */
+    ReaderSlot *slot = &snapshots->readers[reader];
+    atomic_store(&slot->epoch, atomic_load(&snapshots->epoch));
+    RouteSnapshot *snapshot = atomic_load(&snapshots->routes[routeId]);
+
+    size_t length = snapshot == NULL ? 0 : snapshot->length;
+    if (bufferSize > 0) {
+        size_t copied = length < bufferSize ? length : bufferSize - 1;
+        if (copied > 0) {
+            memcpy(buffer, snapshot->description, copied);
+        }
+        buffer[copied] = 0;
+    }
+
+    atomic_store_explicit(&slot->epoch, 0, memory_order_release);
+    return length;
+}
+
+/** @brief Liczba opublikowanych opisów.
+ * @param[in] snapshots         - wskaźnik na strukturę.
+ * @return Liczba opisów utworzonych przez @ref publishRouteSnapshots.
+ */
+uint64_t publishedCountRouteSnapshots(const RouteSnapshots *snapshots) {
+    assert(snapshots);
+
+    return snapshots->publishedCount;
+}
+
+/** @brief Liczba zwolnionych opisów.
+ * @param[in] snapshots         - wskaźnik na strukturę.
+ * @return Liczba zastąpionych opisów, które już zwolniono.
+ */
+uint64_t reclaimedCountRouteSnapshots(const RouteSnapshots *snapshots) {
+    assert(snapshots);
+
+    return snapshots->reclaimedCount;
+}
@@ -0,0 +1,118 @@
+/** @file
+ * Interfejs klasy przechowującej opublikowane opisy dróg krajowych.
+ *
+ * Opisy (w formacie @ref getRouteDescription) są niezmiennymi napisami
+ * wskazywanymi przez atomowe wskaźniki, po jednym na numer drogi krajowej.
+ * Jedyny wątek piszący po modyfikacji mapy tworzy nowe opisy zmienionych dróg
+ * krajowych i podmienia wskaźniki, więc wątki czytające nigdy nie czekają na
+ * wątek piszący. Stary opis jest zwalniany dopiero wtedy, gdy żaden wątek
+ * czytający nie może go już czytać: każdy czytający zapisuje w swoim miejscu
+ * epokę, w której zaczął odczyt, a podmiana opisu zwiększa epokę.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef ROUTE_SNAPSHOTS_H
+#define ROUTE_SNAPSHOTS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ROUTE_SNAPSHOTS_SIZE 1000
+///< liczba numerów dróg krajowych (poprawne numery to 1-999)
+
+#define ROUTE_SNAPSHOTS_MAX_READERS 64
+///< największa liczba jednocześnie zarejestrowanych wątków czytających
+
+/**
+ * Struktura przechowująca opublikowane opisy dróg krajowych.
+ */
+typedef struct RouteSnapshots RouteSnapshots;
+
+/** @brief Funkcja zapisująca opis drogi krajowej.
+ * Działa jak @ref writeRouteDescription.
+ * @param[in,out] argument      - wskaźnik przekazany do
+ *                                @ref publishRouteSnapshots;
+ * @param[in] routeId           - numer drogi krajowej;
+ * @param[out] buffer           - wskaźnik na bufor lub NULL;
+ * @param[in] bufferSize        - rozmiar bufora.
+ * @return Długość całego opisu lub @p 0, jeśli droga krajowa nie istnieje.
+ */
+typedef size_t (*RouteDescriptionWriter)(void *argument, unsigned routeId,
+                                         char *buffer, size_t bufferSize);
+
+/** @brief Tworzy strukturę bez opisów dróg krajowych.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci.
+ */
+RouteSnapshots *newRouteSnapshots(void);
+
+/** @brief Usuwa strukturę.
+ * Żaden wątek czytający nie może być wtedy zarejestrowany. Nic nie robi,
+ * jeśli wskaźnik ma wartość NULL.
+ * @param[in] snapshots         - wskaźnik na usuwaną strukturę.
+ */
+void deleteRouteSnapshots(RouteSnapshots *snapshots);
+
+/** @brief Oznacza drogę krajową do ponownej publikacji.
+ * Funkcja wątku piszącego.
+ * @param[in,out] snapshots     - wskaźnik na strukturę;
+ * @param[in] routeId           - numer drogi krajowej.
+ */
+void markRouteSnapshots(RouteSnapshots *snapshots, unsigned routeId);
+
+/** @brief Publikuje opisy oznaczonych dróg krajowych.
+ * Funkcja wątku piszącego. Tworzy nowe opisy funkcją @p writer, podmienia je
+ * i zwalnia stare opisy, których nie czyta już żaden wątek. Drogi krajowe,
+ * których opisu nie udało się utworzyć, pozostają oznaczone.
+ * @param[in,out] snapshots     - wskaźnik na strukturę;
+ * @param[in] writer            - funkcja zapisująca opis;
+ * @param[in,out] argument      - wskaźnik przekazywany do @p writer.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool publishRouteSnapshots(RouteSnapshots *snapshots,
+                           RouteDescriptionWriter writer, void *argument);
+
+/** @brief Rejestruje wątek czytający.
+ * @param[in,out] snapshots     - wskaźnik na strukturę.
+ * @return Numer miejsca wątku czytającego lub @p -1, jeśli wszystkie
+ * @ref ROUTE_SNAPSHOTS_MAX_READERS miejsc jest zajętych.
+ */
+int32_t newReaderRouteSnapshots(RouteSnapshots *snapshots);
+
+/** @brief Wyrejestrowuje wątek czytający.
+ * @param[in,out] snapshots     - wskaźnik na strukturę;
+ * @param[in] reader            - numer miejsca wątku czytającego.
+ */
+void deleteReaderRouteSnapshots(RouteSnapshots *snapshots, int32_t reader);
+
+/** @brief Zapisuje opublikowany opis drogi krajowej w buforze.
+ * Może być wywoływana równolegle z innymi wątkami czytającymi i z wątkiem
+ * piszącym. Wynik jak w @ref writeRouteDescription.
+ * @param[in,out] snapshots     - wskaźnik na strukturę;
+ * @param[in] reader            - numer miejsca wątku czytającego;
+ * @param[in] routeId           - numer drogi krajowej;
+ * @param[out] buffer           - wskaźnik na bufor lub NULL;
+ * @param[in] bufferSize        - rozmiar bufora (@p 0 dla NULL).
+ * @return Długość całego opisu (bez zera na końcu), także jeśli nie
+ * zmieścił się w buforze.
+ */
+size_t readRouteSnapshots(RouteSnapshots *snapshots, int32_t reader,
+                          unsigned routeId, char *buffer, size_t bufferSize);
+
+/** @brief Liczba opublikowanych opisów.
+ * @param[in] snapshots         - wskaźnik na strukturę.
+ * @return Liczba opisów utworzonych przez @ref publishRouteSnapshots.
+ */
+uint64_t publishedCountRouteSnapshots(const RouteSnapshots *snapshots);
+
+/** @brief Liczba zwolnionych opisów.
+ * @param[in] snapshots         - wskaźnik na strukturę.
+ * @return Liczba zastąpionych opisów, które już zwolniono.
+ */
+uint64_t reclaimedCountRouteSnapshots(const RouteSnapshots *snapshots);
+
+#endif // ROUTE_SNAPSHOTS_H
@@ -0,0 +1,425 @@
+/** @file
+ * Implementacja interfejsu klasy przechowującej pamięć podręczną drzew
+ * najkrótszych dróg.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "search_cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+
+#define DEFAULT_SEARCH_CACHE_BUCKETS_COUNT 64
+///< początkowa liczba kubełków pamięci podręcznej
+
+/**
+ * Struktura przechowująca drzewo najkrótszych dróg. Tablice leżą w tym samym
+ * bloku pamięci co struktura.
+ */
+typedef struct SearchTree {
+    struct SearchTree *nextInBucket;    ///< następne drzewo w kubełku
+    struct SearchTree *older;       ///< drzewo używane wcześniej lub NULL
+    struct SearchTree *newer;       ///< drzewo używane później lub NULL
+    uint64_t hash;                  ///< hasz klucza
+    uint32_t from;                  ///< numer miasta startowego
+    int64_t knownOldestRoad;        ///< rok najstarszego odcinka lub @p 0
+    uint32_t *excluded;             ///< rosnące numery wykluczonych miast
+    uint32_t excludedCount;         ///< liczba wykluczonych miast
+    uint32_t citiesCount;           ///< liczba miast na mapie
+    int64_t *distance;              ///< długości najkrótszych dróg
+    int64_t *oldestRoadOnRoute;     ///< optymalne wieki najkrótszych dróg
+    City **previousOnRoute;         ///< poprzednie miasta na najkrótszych drogach
+    bool *isRouteUnequivocal;       ///< jednoznaczności najkrótszych dróg
+    size_t size;                    ///< liczba bajtów bloku
+} SearchTree;
+
+/**
+ * Struktura przechowująca pamięć podręczną drzew najkrótszych dróg.
+ */
+struct SearchCache {
+    pthread_mutex_t mutex;          ///< blokada chroniąca pola struktury
+    const uint64_t *graphVersion;   ///< wskaźnik na aktualną wersję mapy
+    uint64_t version;               ///< wersja mapy zapamiętanych drzew
+    SearchTree **buckets;           ///< kubełki tablicy haszującej
+    uint32_t bucketsCount;          ///< liczba kubełków (potęga dwójki)
+    SearchTree *oldest;             ///< najdawniej używane drzewo lub NULL
+    SearchTree *newest;             ///< ostatnio używane drzewo lub NULL
+    SearchCacheStatistics statistics;   ///< liczniki pamięci podręcznej
+};
+
+/** @brief Tworzy strukturę.
+ * Tworzy pustą pamięć podręczną.
+ * @param[in] budget            - limit pamięci drzew w bajtach;
+ * @param[in] graphVersion      - wskaźnik na wersję mapy; wersja nie może
+ *                                się zmieniać w trakcie operacji na
+ *                                strukturze.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci.
+ */
+SearchCache *newSearchCache(size_t budget, const uint64_t *graphVersion) {
+    assert(graphVersion);
+
+    SearchCache *result = calloc(1, sizeof(SearchCache));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    result->buckets = calloc(DEFAULT_SEARCH_CACHE_BUCKETS_COUNT,
+                             sizeof(SearchTree *));
+    if (result->buckets == NULL) {
+        free(result);
+        return NULL;
+    }
+
+    if (pthread_mutex_init(&result->mutex, NULL) != 0) {
+        free(result->buckets);
+        free(result);
+        return NULL;
+    }
+
+    result->graphVersion = graphVersion;
+    result->version = *graphVersion;
+    result->bucketsCount = DEFAULT_SEARCH_CACHE_BUCKETS_COUNT;
+    result->statistics.budget = budget;
+
+    return result;
+}
+
+/** @brief Usuwa wszystkie drzewa.
+ * @param[in,out] cache         - wskaźnik na pamięć podręczną.
+ */
+void clearSearchCache(SearchCache *cache) {
+    SearchTree *tree = cache->oldest;
+    while (tree != NULL) {
+        SearchTree *newer = tree->newer;
+        free(tree);
+        tree = newer;
+    }
+
+    memset(cache->buckets, 0, sizeof(SearchTree *) * cache->bucketsCount);
+    cache->oldest = NULL;
+    cache->newest = NULL;
+    cache->statistics.entriesCount = 0;
+    cache->statistics.memoryUsage = 0;
+}
+
+/** @brief Usuwa strukturę.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] cache             - wskaźnik na usuwaną strukturę.
+ */
+void deleteSearchCache(SearchCache *cache) {
+    if (cache == NULL) {
+        return;
+    }
+
+    clearSearchCache(cache);
+    pthread_mutex_destroy(&cache->mutex);
+    free(cache->buckets);
+    free(cache);
+}
+
+/** @brief Unieważnia drzewa starszej wersji mapy.
+ * @param[in,out] cache         - wskaźnik na pamięć podręczną.
+ */
+void refreshVersionSearchCache(SearchCache *cache) {
+    if (cache->version == *cache->graphVersion) {
+        return;
+    }
+
+    if (cache->oldest != NULL) {
+        cache->statistics.invalidationsCount++;
+    }
+    clearSearchCache(cache);
+    cache->version = *cache->graphVersion;
+}
+
+/** @brief Liczy hasz klucza.
+ * @param[in] key               - wskaźnik na klucz drzewa.
+ * @return Hasz klucza.
+ */
+uint64_t hashSearchTreeKey(const SearchTreeKey *key) {
+    uint64_t result = 14695981039346656037ull;
+    result = (result ^ key->from) * 1099511628211ull;
+    result = (result ^ (uint64_t)key->knownOldestRoad) * 1099511628211ull;
+    for (uint32_t i = 0; i < key->excludedCount; i++) {
+        result = (result ^ key->excluded[i]) * 1099511628211ull;
+    }
+
+    return result ^ (result >> 29);
+}
+
+/** @brief Sprawdza czy drzewo ma podany klucz.
+ * @param[in] tree              - wskaźnik na drzewo;
+ * @param[in] key               - wskaźnik na klucz drzewa;
+ * @param[in] hash              - hasz klucza.
+ * @return Wartość @p true, jeśli klucze są równe, lub @p false w przeciwnym
+ * przypadku.
+ */
+bool hasKeySearchTree(const SearchTree *tree, const SearchTreeKey *key,
+                      uint64_t hash) {
+    return tree->hash == hash && tree->from == key->from &&
+           tree->knownOldestRoad == key->knownOldestRoad &&
+           tree->excludedCount == key->excludedCount &&
+           (key->excludedCount == 0 ||
+            memcmp(tree->excluded, key->excluded,
+                   sizeof(uint32_t) * key->excludedCount) == 0);
+}
+
+/** @brief Znajduje drzewo o podanym kluczu.
+ * @param[in] cache             - wskaźnik na pamięć podręczną;
+ * @param[in] key               - wskaźnik na klucz drzewa;
+ * @param[in] hash              - hasz klucza.
+ * @return Wskaźnik na drzewo lub NULL, jeśli go nie ma.
+ */
+SearchTree *findTreeSearchCache(const SearchCache *cache,
+                                const SearchTreeKey *key, uint64_t hash) {
+    SearchTree *tree = cache->buckets[hash & (cache->bucketsCount - 1)];
+    while (tree != NULL && !hasKeySearchTree(tree, key, hash)) {
+        tree = tree->nextInBucket;
+    }
+
+    return tree;
+}
+
+/** @brief Odłącza drzewo od listy drzew w kolejności użycia.
+ * @param[in,out] cache         - wskaźnik na pamięć podręczną;
+ * @param[in,out] tree          - wskaźnik na drzewo.
+ */
+void unlinkTreeSearchCache(SearchCache *cache, SearchTree *tree) {
+    if (tree->older != NULL) {
+        tree->older->newer = tree->newer;
+    } else {
+        cache->oldest = tree->newer;
+    }
+
+    if (tree->newer != NULL) {
+        tree->newer->older = tree->older;
+    } else {
+        cache->newest = tree->older;
+    }
+}
+
+/** @brief Dołącza drzewo jako ostatnio używane.
+ * @param[in,out] cache         - wskaźnik na pamięć podręczną;
+ * @param[in,out] tree          - wskaźnik na drzewo.
+ */
+void linkNewestTreeSearchCache(SearchCache *cache, SearchTree *tree) {
+    tree->older = cache->newest;
+    tree->newer = NULL;
+    if (cache->newest != NULL) {
+        cache->newest->newer = tree;
+    } else {
+        cache->oldest = tree;
+    }
+    cache->newest = tree;
+}
+
+/** @brief Usuwa najdawniej używane drzewo.
+ * @param[in,out] cache         - wskaźnik na niepustą pamięć podręczną.
+ */
+void evictOldestSearchCache(SearchCache *cache) {
+    SearchTree *tree = cache->oldest;
+    assert(tree);
+
+    SearchTree **bucket = &cache->buckets[tree->hash &
+                                          (cache->bucketsCount - 1)];
+    while (*bucket != tree) {
+        bucket = &(*bucket)->nextInBucket;
+    }
+    *bucket = tree->nextInBucket;
+
+    unlinkTreeSearchCache(cache, tree);
+    cache->statistics.entriesCount--;
+    cache->statistics.memoryUsage -= tree->size;
+    cache->statistics.evictionsCount++;
+    free(tree);
+}
+
+/** @brief Podwaja liczbę kubełków.
+ * Nic nie robi, jeśli nie udało się zaalokować pamięci.
+ * @param[in,out] cache         - wskaźnik na pamięć podręczną.
+ */
+void growSearchCache(SearchCache *cache) {
+    uint32_t bucketsCount = cache->bucketsCount * 2;
+    SearchTree **buckets = calloc(bucketsCount, sizeof(SearchTree *));
+    if (buckets == NULL) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < cache->bucketsCount; i++) {
+        SearchTree *tree = cache->buckets[i];
+        while (tree != NULL) {
+            SearchTree *next = tree->nextInBucket;
+            uint32_t index = tree->hash & (bucketsCount - 1);
+            tree->nextInBucket = buckets[index];
+            buckets[index] = tree;
+            tree = next;
+        }
+    }
+
+    free(cache->buckets);
+    cache->buckets = buckets;
+    cache->bucketsCount = bucketsCount;
+}
+
+/** @brief Odczytuje drzewo najkrótszych dróg.
+ * Jeśli drzewo o kluczu @p key jest zapamiętane dla aktualnej wersji mapy, to
+ * kopiuje jego odległości, lata najstarszych odcinków, jednoznaczności
+ * i poprzedników do tablic stanu algorytmu.
+ * @param[in,out] cache         - wskaźnik na pamięć podręczną;
+ * @param[in] key               - wskaźnik na klucz drzewa;
+ * @param[in,out] state         - wskaźnik na przygotowany stan algorytmu
+ *                                (zob. @ref prepareSearchState).
+ * @return Wartość @p true, jeśli drzewo zostało odczytane, lub @p false
+ * w przeciwnym przypadku.
+ */
+bool findSearchCache(SearchCache *cache, const SearchTreeKey *key,
+                     SearchState *state) {
+    assert(cache && key && state);
+
+    uint64_t hash = hashSearchTreeKey(key);
+    uint32_t citiesCount = countCitiesOnList(state->listOfCities);
+
+    pthread_mutex_lock(&cache->mutex);
+    refreshVersionSearchCache(cache);
+    SearchTree *tree = findTreeSearchCache(cache, key, hash);
+
+    /* Dodanie miasta zawsze zmienia wersję mapy, ale dla pewności nie
+     * używamy drzew o innej liczbie miast. */
+    if (tree == NULL || tree->citiesCount != citiesCount) {
+        cache->statistics.missesCount++;
+        pthread_mutex_unlock(&cache->mutex);
+        return false;
+    }
+
+    memcpy(state->distance, tree->distance, sizeof(int64_t) * citiesCount);
+    memcpy(state->oldestRoadOnRoute, tree->oldestRoadOnRoute,
+           sizeof(int64_t) * citiesCount);
+    memcpy(state->previousOnRoute, tree->previousOnRoute,
+           sizeof(City *) * citiesCount);
+    memcpy(state->isRouteUnequivocal, tree->isRouteUnequivocal,
+           sizeof(bool) * citiesCount);
+
+    unlinkTreeSearchCache(cache, tree);
+    linkNewestTreeSearchCache(cache, tree);
+    cache->statistics.hitsCount++;
+    pthread_mutex_unlock(&cache->mutex);
+
+    return true;
+}
+
+/** @brief Zapamiętuje drzewo najkrótszych dróg.
+ * Kopiuje tablice stanu algorytmu po algorytmie dijkstry dla klucza @p key.
+ * Usuwa najdawniej używane drzewa, dopóki nowe nie mieści się w limicie.
+ * Nic nie robi, jeśli drzewo jest większe niż limit lub nie udało się
+ * zaalokować pamięci.
+ * @param[in,out] cache         - wskaźnik na pamięć podręczną;
+ * @param[in] key               - wskaźnik na klucz drzewa;
+ * @param[in] state             - wskaźnik na stan algorytmu.
+ */
+void insertSearchCache(SearchCache *cache, const SearchTreeKey *key,
+                       const SearchState *state) {
+    assert(cache && key && state);
+
+    /* Tablice ośmiobajtowe leżą przed tablicą numerów i jednoznaczności,
+     * więc wszystkie są wyrównane. */
+    uint32_t citiesCount = countCitiesOnList(state->listOfCities);
+    size_t size = sizeof(SearchTree) +
+                  (2 * sizeof(int64_t) + sizeof(City *)) * citiesCount +
+                  sizeof(uint32_t) * key->excludedCount +
+                  sizeof(bool) * citiesCount;
+    if (size > cache->statistics.budget) {
+        return;
+    }
+
+    SearchTree *tree = malloc(size);
+    if (tree == NULL) {
+        return;
+    }
+
+    tree->hash = hashSearchTreeKey(key);
+    tree->from = key->from;
+    tree->knownOldestRoad = key->knownOldestRoad;
+    tree->excludedCount = key->excludedCount;
+    tree->citiesCount = citiesCount;
+    tree->size = size;
+    tree->distance = (int64_t *)(tree + 1);
+    tree->oldestRoadOnRoute = tree->distance + citiesCount;
+    tree->previousOnRoute = (City **)(tree->oldestRoadOnRoute + citiesCount);
+    tree->excluded = (uint32_t *)(tree->previousOnRoute + citiesCount);
+    tree->isRouteUnequivocal = (bool *)(tree->excluded + key->excludedCount);
+
+    /* Bez wykluczonych miast tablica klucza może mieć wartość NULL. */
+    if (key->excludedCount > 0) {
+        memcpy(tree->excluded, key->excluded,
+               sizeof(uint32_t) * key->excludedCount);
+    }
+    memcpy(tree->distance, state->distance, sizeof(int64_t) * citiesCount);
+    memcpy(tree->oldestRoadOnRoute, state->oldestRoadOnRoute,
+           sizeof(int64_t) * citiesCount);
+    memcpy(tree->previousOnRoute, state->previousOnRoute,
+           sizeof(City *) * citiesCount);
+    memcpy(tree->isRouteUnequivocal, state->isRouteUnequivocal,
+           sizeof(bool) * citiesCount);
+
+    pthread_mutex_lock(&cache->mutex);
+    refreshVersionSearchCache(cache);
+
+    /* Inny wątek mógł w międzyczasie zapamiętać to samo drzewo. */
+    SearchTree *old = findTreeSearchCache(cache, key, tree->hash);
+    if (old != NULL) {
+        pthread_mutex_unlock(&cache->mutex);
+        free(tree);
+        return;
+    }
+
+    while (cache->statistics.memoryUsage + size > cache->statistics.budget) {
+        evictOldestSearchCache(cache);
+    }
+
+    if (cache->statistics.entriesCount >= cache->bucketsCount) {
+        growSearchCache(cache);
+    }
+
+    uint32_t index = tree->hash & (cache->bucketsCount - 1);
+    tree->nextInBucket = cache->buckets[index];
+    cache->buckets[index] = tree;
+    linkNewestTreeSearchCache(cache, tree);
+    cache->statistics.entriesCount++;
+    cache->statistics.memoryUsage += size;
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+/** @brief Zwraca liczniki pamięci podręcznej.
+ * @param[in,out] cache         - wskaźnik na pamięć podręczną.
+ * @return Liczniki pamięci podręcznej.
+ */
+SearchCacheStatistics getStatisticsSearchCache(SearchCache *cache) {
+    assert(cache);
+
+    pthread_mutex_lock(&cache->mutex);
+    SearchCacheStatistics result = cache->statistics;
+    pthread_mutex_unlock(&cache->mutex);
+
+    return result;
+}
+
+/** @brief Pamięć zajmowana przez pamięć podręczną.
+ * @param[in,out] cache         - wskaźnik na pamięć podręczną.
+ * @return Liczba bajtów struktury, tablicy kubełków i drzew.
+ */
+size_t memoryUsageSearchCache(SearchCache *cache) {
+    assert(cache);
+
+    pthread_mutex_lock(&cache->mutex);
+    size_t result = sizeof(SearchCache) +
+                    sizeof(SearchTree *) * cache->bucketsCount +
+                    cache->statistics.memoryUsage;
+    pthread_mutex_unlock(&cache->mutex);
+
+    return result;
+}
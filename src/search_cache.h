@@ -0,0 +1,110 @@
+/** @file
+ * Interfejs klasy przechowującej pamięć podręczną drzew najkrótszych dróg.
+ *
+ * Drzewo to pełny wynik algorytmu dijkstry z jednego miasta startowego, bez
+ * wykluczonych miast drogi krajowej, w jednym z dwóch przejść wyszukiwania
+ * (zob. @ref findRouteModule). Drzewa zapamiętywane są dla klucza (miasto
+ * startowe, zbiór wykluczonych miast, rok najstarszego odcinka drugiego
+ * przejścia) i wersji mapy, zwiększanej po każdej zmianie odcinków dróg.
+ * Zmiana wersji unieważnia wszystkie drzewa. Po przekroczeniu limitu pamięci
+ * usuwane są najdawniej używane drzewa. Struktura jest wspólna dla stanów
+ * algorytmu wszystkich wątków mapy, więc jej operacje są chronione blokadą.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef SEARCH_CACHE_H
+#define SEARCH_CACHE_H
+
+#include "search_state.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Struktura przechowująca pamięć podręczną drzew najkrótszych dróg.
+ */
+typedef struct SearchCache SearchCache;
+
+/**
+ * Struktura opisująca klucz drzewa najkrótszych dróg.
+ */
+typedef struct SearchTreeKey {
+    uint32_t from;                  ///< numer miasta startowego
+    int64_t knownOldestRoad;        ///< rok najstarszego odcinka drugiego
+                                    ///  przejścia lub @p 0 (pierwsze)
+    const uint32_t *excluded;       ///< rosnące numery wykluczonych miast
+    uint32_t excludedCount;         ///< liczba wykluczonych miast
+} SearchTreeKey;
+
+/**
+ * Struktura przechowująca liczniki pamięci podręcznej.
+ */
+typedef struct SearchCacheStatistics {
+    uint64_t hitsCount;             ///< liczba drzew odczytanych z pamięci
+    uint64_t missesCount;           ///< liczba drzew, których nie było
+    uint64_t evictionsCount;        ///< liczba drzew usuniętych przez limit
+    uint64_t invalidationsCount;    ///< liczba unieważnień przez zmianę wersji
+    uint64_t entriesCount;          ///< liczba zapamiętanych drzew
+    size_t memoryUsage;             ///< liczba bajtów zapamiętanych drzew
+    size_t budget;                  ///< limit pamięci w bajtach
+} SearchCacheStatistics;
+
+/** @brief Tworzy strukturę.
+ * Tworzy pustą pamięć podręczną.
+ * @param[in] budget            - limit pamięci drzew w bajtach;
+ * @param[in] graphVersion      - wskaźnik na wersję mapy; wersja nie może
+ *                                się zmieniać w trakcie operacji na
+ *                                strukturze.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci.
+ */
+SearchCache *newSearchCache(size_t budget, const uint64_t *graphVersion);
+
+/** @brief Usuwa strukturę.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] cache             - wskaźnik na usuwaną strukturę.
+ */
+void deleteSearchCache(SearchCache *cache);
+
+/** @brief Odczytuje drzewo najkrótszych dróg.
+ * Jeśli drzewo o kluczu @p key jest zapamiętane dla aktualnej wersji mapy, to
+ * kopiuje jego odległości, lata najstarszych odcinków, jednoznaczności
+ * i poprzedników do tablic stanu algorytmu.
+ * @param[in,out] cache         - wskaźnik na pamięć podręczną;
+ * @param[in] key               - wskaźnik na klucz drzewa;
+ * @param[in,out] state         - wskaźnik na przygotowany stan algorytmu
+ *                                (zob. @ref prepareSearchState).
+ * @return Wartość @p true, jeśli drzewo zostało odczytane, lub @p false
+ * w przeciwnym przypadku.
+ */
+bool findSearchCache(SearchCache *cache, const SearchTreeKey *key,
+                     SearchState *state);
+
+/** @brief Zapamiętuje drzewo najkrótszych dróg.
+ * Kopiuje tablice stanu algorytmu po algorytmie dijkstry dla klucza @p key.
+ * Usuwa najdawniej używane drzewa, dopóki nowe nie mieści się w limicie.
+ * Nic nie robi, jeśli drzewo jest większe niż limit lub nie udało się
+ * zaalokować pamięci.
+ * @param[in,out] cache         - wskaźnik na pamięć podręczną;
+ * @param[in] key               - wskaźnik na klucz drzewa;
+ * @param[in] state             - wskaźnik na stan algorytmu.
+ */
+void insertSearchCache(SearchCache *cache, const SearchTreeKey *key,
+                       const SearchState *state);
+
+/** @brief Zwraca liczniki pamięci podręcznej.
+ * @param[in,out] cache         - wskaźnik na pamięć podręczną.
+ * @return Liczniki pamięci podręcznej.
+ */
+SearchCacheStatistics getStatisticsSearchCache(SearchCache *cache);
+
+/** @brief Pamięć zajmowana przez pamięć podręczną.
+ * @param[in,out] cache         - wskaźnik na pamięć podręczną.
+ * @return Liczba bajtów struktury, tablicy kubełków i drzew.
+ */
+size_t memoryUsageSearchCache(SearchCache *cache);
+
+#endif // SEARCH_CACHE_H
@@ -0,0 +1,189 @@
+/** @file
+ * Implementacja interfejsu klasy przechowującej stan algorytmu dijkstry.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "search_state.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define DEFAULT_SEARCH_STATE_MEMORY_SIZE 8
+///< domyślny rozmiar zaalokowanych tablic w @ref SearchState
+
+/** @brief Tworzy strukturę.
+ * Tworzy stan algorytmu dijkstry dla miast z listy @p listOfCities.
+ * @param[in] listOfCities      - wskaźnik na wszystkie miasta na mapie.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci.
+ */
+SearchState *newSearchState(List *listOfCities) {
+    assert(listOfCities);
+
+    SearchState *result = calloc(1, sizeof(SearchState));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    result->listOfCities = listOfCities;
+    result->currentStamp = 0;
+    result->engine = DIJKSTRA_SEARCH_ENGINE;
+
+    return result;
+}
+
+/** @brief Usuwa strukturę.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] state             - wskaźnik na usuwaną strukturę.
+ */
+void deleteSearchState(SearchState *state) {
+    if (state == NULL) {
+        return;
+    }
+
+    free(state->distance);
+    free(state->oldestRoadOnRoute);
+    free(state->isRouteUnequivocal);
+    free(state->previousOnRoute);
+    free(state->backwardDistance);
+    free(state->backwardOldestRoadOnRoute);
+    free(state->backwardIsRouteUnequivocal);
+    free(state->nextOnRoute);
+    free(state->settled);
+    free(state->stamp);
+    free(state->settledCities);
+    free(state->heuristic);
+    free(state->pathsCount);
+    free(state->backwardPathsCount);
+    free(state);
+}
+
+/** @brief Powiększa tablicę.
+ * @param[in,out] array         - wskaźnik na powiększaną tablicę;
+ * @param[in] elementSize       - rozmiar elementu tablicy;
+ * @param[in] newMemory         - nowa liczba elementów tablicy.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci (tablica pozostaje wtedy bez zmian).
+ */
+bool resizeArraySearchState(void **array, size_t elementSize,
+                            uint32_t newMemory) {
+    void *ptr = realloc(*array, elementSize * newMemory);
+    if (ptr == NULL) {
+        return false;
+    }
+
+    *array = ptr;
+    return true;
+}
+
+/** @brief Przygotowuje strukturę do wyszukiwania.
+ * Powiększa tablice tak, aby mieściły wszystkie miasta na mapie.
+ * @param[in,out] state         - wskaźnik na stan algorytmu.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool prepareSearchState(SearchState *state) {
+    assert(state);
+
+    uint32_t citiesCount = countCitiesOnList(state->listOfCities);
+    if (citiesCount <= state->reservedMemory) {
+        return true;
+    }
+
+    uint32_t newMemory = state->reservedMemory;
+    if (newMemory < DEFAULT_SEARCH_STATE_MEMORY_SIZE) {
+        newMemory = DEFAULT_SEARCH_STATE_MEMORY_SIZE;
+    }
+    while (newMemory < citiesCount) {
+        newMemory *= 2;
+    }
+
+    if (!resizeArraySearchState((void **)&state->distance,
+                                sizeof(int64_t), newMemory) ||
+            !resizeArraySearchState((void **)&state->oldestRoadOnRoute,
+                                    sizeof(int64_t), newMemory) ||
+            !resizeArraySearchState((void **)&state->isRouteUnequivocal,
+                                    sizeof(bool), newMemory) ||
+            !resizeArraySearchState((void **)&state->previousOnRoute,
+                                    sizeof(City *), newMemory) ||
+            !resizeArraySearchState((void **)&state->backwardDistance,
+                                    sizeof(int64_t), newMemory) ||
+            !resizeArraySearchState((void **)&state->backwardOldestRoadOnRoute,
+                                    sizeof(int64_t), newMemory) ||
+            !resizeArraySearchState((void **)&state->backwardIsRouteUnequivocal,
+                                    sizeof(bool), newMemory) ||
+            !resizeArraySearchState((void **)&state->nextOnRoute,
+                                    sizeof(City *), newMemory) ||
+            !resizeArraySearchState((void **)&state->settled,
+                                    sizeof(uint8_t), newMemory) ||
+            !resizeArraySearchState((void **)&state->settledCities,
+                                    sizeof(City *), newMemory) ||
+            !resizeArraySearchState((void **)&state->stamp,
+                                    sizeof(uint32_t), newMemory) ||
+            !resizeArraySearchState((void **)&state->heuristic,
+                                    sizeof(int64_t), newMemory) ||
+            !resizeArraySearchState((void **)&state->pathsCount,
+                                    sizeof(uint8_t), newMemory) ||
+            !resizeArraySearchState((void **)&state->backwardPathsCount,
+                                    sizeof(uint8_t), newMemory)) {
+        return false;
+    }
+
+    /* Nowe miasta nie były odwiedzone przez żadne wyszukiwanie. */
+    memset(state->stamp + state->reservedMemory, 0,
+           sizeof(uint32_t) * (newMemory - state->reservedMemory));
+    state->reservedMemory = newMemory;
+
+    return true;
+}
+
+/** @brief Rozpoczyna nowe wyszukiwanie ze znacznikami.
+ * Zwiększa numer wyszukiwania, przez co wszystkie miasta stają się
+ * nieodwiedzone (zob. @ref touchCitySearchState).
+ * @param[in,out] state         - wskaźnik na stan algorytmu.
+ */
+void nextStampSearchState(SearchState *state) {
+    assert(state);
+
+    state->currentStamp++;
+    if (state->currentStamp == 0) {
+        memset(state->stamp, 0, sizeof(uint32_t) * state->reservedMemory);
+        state->currentStamp = 1;
+    }
+    state->settledCitiesSize = 0;
+}
+
+/** @brief Oznacza miasto jako odwiedzone w aktualnym wyszukiwaniu.
+ * Jeśli miasto nie było jeszcze odwiedzone w aktualnym wyszukiwaniu, to
+ * ustawia jego odległości w obu kierunkach na nieskończoność.
+ * @param[in,out] state         - wskaźnik na stan algorytmu;
+ * @param[in] id                - numer miasta.
+ */
+void touchCitySearchState(SearchState *state, uint32_t id) {
+    if (state->stamp[id] == state->currentStamp) {
+        return;
+    }
+
+    state->stamp[id] = state->currentStamp;
+    state->distance[id] = INFINITY;
+    state->oldestRoadOnRoute[id] = INFINITY;
+    state->backwardDistance[id] = INFINITY;
+    state->backwardOldestRoadOnRoute[id] = INFINITY;
+    state->settled[id] = 0;
+}
+
+/** @brief Pamięć zajmowana przez stan algorytmu.
+ * @param[in] state         - wskaźnik na stan algorytmu.
+ * @return Liczba bajtów struktury i jej tablic.
+ */
+size_t memoryUsageSearchState(const SearchState *state) {
+    assert(state);
+
+    size_t citySize = 5 * sizeof(int64_t) + 3 * sizeof(City *) +
+                      2 * sizeof(bool) + 3 * sizeof(uint8_t) +
+                      sizeof(uint32_t);
+    return sizeof(SearchState) + citySize * state->reservedMemory;
+}
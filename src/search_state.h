@@ -0,0 +1,138 @@
+/** @file
+ * Interfejs klasy przechowującej stan algorytmu dijkstry.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef SEARCH_STATE_H
+#define SEARCH_STATE_H
+
+#include "city.h"
+#include "list.h"
+#include "landmark_index.h"
+#include "contraction_hierarchy.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define INFINITY 1000000000000000ll ///< stała oznaczająca nieskończoność
+
+/**
+ * Algorytm używany do wyszukiwania dróg krajowych.
+ */
+typedef enum SearchEngine {
+    DIJKSTRA_SEARCH_ENGINE,         ///< algorytm dijkstry z miasta startowego
+    BIDIRECTIONAL_SEARCH_ENGINE,    ///< dwukierunkowy algorytm dijkstry
+    ALT_SEARCH_ENGINE,              ///< algorytm A* z punktami orientacyjnymi
+    HIERARCHY_SEARCH_ENGINE         ///< hierarchia kontrakcji
+} SearchEngine;
+
+/**
+ * Struktura przechowująca liczniki wyszukiwań dróg.
+ */
+typedef struct SearchStatistics {
+    uint64_t searchesCount;         ///< liczba wyszukanych dróg
+    uint64_t settledCitiesCount;    ///< liczba miast zdjętych ze sterty
+    uint64_t sharedDetoursCount;    ///< liczba objazdów skopiowanych
+                                    ///  z objazdu wspólnego dla dróg
+                                    ///  krajowych
+} SearchStatistics;
+
+/**
+ * Struktura przechowująca zmienne używane przez algorytm dijkstry do liczenia
+ * najkrótszej drogi od pewnego ustalonego miasta. Tablice indeksowane są
+ * numerami miast (@ref City.id). Każdy wątek szukający dróg musi mieć własną
+ * strukturę.
+ */
+typedef struct SearchState {
+    List *listOfCities;             ///< wskaźnik na wszystkie miasta na mapie
+    int64_t *distance;              ///< długości najkrótszych dróg
+    int64_t *oldestRoadOnRoute;     ///< optymalne wieki najkrótszych dróg
+    bool *isRouteUnequivocal;       ///< jednoznaczności najkrótszych dróg
+    City **previousOnRoute;         ///< poprzednie miasta na najkrótszych drogach
+
+    /** @name Zmienne używane przez dwukierunkowy algorytm dijkstry.
+     * Wartości w tablicach są aktualne tylko dla miast, których znacznik
+     * @ref stamp jest równy @ref currentStamp.
+     */
+    ///@{
+    int64_t *backwardDistance;      ///< długości najkrótszych dróg do celu
+    int64_t *backwardOldestRoadOnRoute; ///< optymalne wieki dróg do celu
+    bool *backwardIsRouteUnequivocal;   ///< jednoznaczności dróg do celu
+    City **nextOnRoute;             ///< następne miasta na drogach do celu
+    uint8_t *settled;               ///< kierunki, w których miasto obsłużono
+    uint32_t *stamp;                ///< numery wyszukiwań, które dotknęły miasta
+    uint32_t currentStamp;          ///< numer aktualnego wyszukiwania
+    City **settledCities;           ///< miasta obsłużone w kierunku do przodu
+    uint32_t settledCitiesSize;     ///< liczba miast w @ref settledCities
+    ///@}
+
+    /** @name Zmienne używane przez algorytm A*.
+     */
+    ///@{
+    const LandmarkIndex *landmarks; ///< aktualny indeks punktów orientacyjnych
+    int64_t *heuristic;             ///< dolne ograniczenia odległości do celu
+    ///@}
+
+    /** @name Zmienne używane przez wyszukiwanie w hierarchii kontrakcji.
+     */
+    ///@{
+    const ContractionHierarchy *hierarchy;  ///< aktualna hierarchia kontrakcji
+    uint8_t *pathsCount;            ///< liczby najkrótszych dróg od startu
+    uint8_t *backwardPathsCount;    ///< liczby najkrótszych dróg do celu
+    ///@}
+
+    struct SearchCache *cache;      ///< pamięć podręczna drzew najkrótszych
+                                    ///  dróg lub NULL (zob. @ref SearchCache)
+    const struct Road *skippedRoads[2]; ///< oba kierunki odcinka pomijanego
+                                    ///  jak usuwany lub NULL
+    uint32_t reservedMemory;        ///< długość zaalokowanych tablic
+    SearchEngine engine;            ///< używany algorytm wyszukiwania
+    SearchStatistics statistics;    ///< liczniki wyszukiwań
+} SearchState;
+
+/** @brief Tworzy strukturę.
+ * Tworzy stan algorytmu dijkstry dla miast z listy @p listOfCities.
+ * @param[in] listOfCities      - wskaźnik na wszystkie miasta na mapie.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci.
+ */
+SearchState *newSearchState(List *listOfCities);
+
+/** @brief Usuwa strukturę.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] state             - wskaźnik na usuwaną strukturę.
+ */
+void deleteSearchState(SearchState *state);
+
+/** @brief Przygotowuje strukturę do wyszukiwania.
+ * Powiększa tablice tak, aby mieściły wszystkie miasta na mapie.
+ * @param[in,out] state         - wskaźnik na stan algorytmu.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool prepareSearchState(SearchState *state);
+
+/** @brief Rozpoczyna nowe wyszukiwanie ze znacznikami.
+ * Zwiększa numer wyszukiwania, przez co wszystkie miasta stają się
+ * nieodwiedzone (zob. @ref touchCitySearchState).
+ * @param[in,out] state         - wskaźnik na stan algorytmu.
+ */
+void nextStampSearchState(SearchState *state);
+
+/** @brief Oznacza miasto jako odwiedzone w aktualnym wyszukiwaniu.
+ * Jeśli miasto nie było jeszcze odwiedzone w aktualnym wyszukiwaniu, to
+ * ustawia jego odległości w obu kierunkach na nieskończoność.
+ * @param[in,out] state         - wskaźnik na stan algorytmu;
+ * @param[in] id                - numer miasta.
+ */
+void touchCitySearchState(SearchState *state, uint32_t id);
+
+/** @brief Pamięć zajmowana przez stan algorytmu.
+ * @param[in] state         - wskaźnik na stan algorytmu.
+ * @return Liczba bajtów struktury i jej tablic.
+ */
+size_t memoryUsageSearchState(const SearchState *state);
+
+#endif // SEARCH_STATE_H
@@ -0,0 +1,424 @@
+/** @file
+ * Implementacja zapisu i odczytu binarnego obrazu mapy dróg krajowych.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "snapshot.h"
+#include "city.h"
+#include "road.h"
+#include "route.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define CHECKSUM_PRIME 1099511628211ull
+///< mnożnik sumy kontrolnej FNV-1a
+
+/** @brief Aktualizuje sumę kontrolną.
+ * @param[in] checksum          - dotychczasowa suma kontrolna;
+ * @param[in] data              - wskaźnik na dane;
+ * @param[in] size              - rozmiar danych w bajtach.
+ * @return Suma kontrolna uwzględniająca dane.
+ */
+uint64_t checksumSnapshot(uint64_t checksum, const void *data, size_t size) {
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        checksum = (checksum ^ bytes[i]) * CHECKSUM_PRIME;
+    }
+
+    return checksum;
+}
+
+/** @brief Zapisuje dane do pliku i aktualizuje sumę kontrolną.
+ * @param[in,out] file          - wskaźnik na plik;
+ * @param[in] data              - wskaźnik na dane;
+ * @param[in] size              - rozmiar danych w bajtach;
+ * @param[in,out] checksum      - wskaźnik na sumę kontrolną.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać danych.
+ */
+bool writeDataSnapshot(FILE *file, const void *data, size_t size,
+                       uint64_t *checksum) {
+    *checksum = checksumSnapshot(*checksum, data, size);
+
+    return fwrite(data, 1, size, file) == size;
+}
+
+/** @brief Zapisuje obraz mapy do pliku.
+ * @param[in] map               - wskaźnik na mapę;
+ * @param[in,out] file          - wskaźnik na plik otwarty do zapisu.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać pliku lub
+ * zaalokować pamięci.
+ */
+bool writeSnapshot(Map *map, FILE *file) {
+    assert(map);
+    assert(file);
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(SnapshotHeader));
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.citiesCount = countCitiesOnList(map->cities);
+    header.checksum = SNAPSHOT_CHECKSUM_SEED;
+    if (map->journal != NULL) {
+        header.journalSequence = map->journal->sequence;
+    }
+
+    City **cities = malloc(sizeof(City *) * (header.citiesCount + 1));
+    if (cities == NULL) {
+        return false;
+    }
+
+    ListIterator *iterator = map->cities->begin;
+    while (iterator != map->cities->end) {
+        City *city = iterator->data;
+        cities[city->id] = city;
+        iterator = iterator->next;
+    }
+
+    /* Nagłówek zapisujemy ponownie, gdy znamy rozmiary sekcji. */
+    bool result = fwrite(&header, sizeof(SnapshotHeader), 1, file) == 1;
+
+    for (uint32_t i = 0; result && i < header.citiesCount; i++) {
+        size_t size = strlen(cities[i]->name) + 1;
+        result = writeDataSnapshot(file, cities[i]->name, size,
+                                   &header.checksum);
+        header.namesSize += size;
+    }
+
+    for (uint32_t i = 0; result && i < header.citiesCount; i++) {
+        iterator = cities[i]->roads->begin;
+        while (result && iterator != cities[i]->roads->end) {
+            Road *road = iterator->data;
+            if (i < road->destination->id) {
+                SnapshotRoad record = {i, road->destination->id, road->length,
+                                       road->buildYearOrLastRepairYear};
+                result = writeDataSnapshot(file, &record, sizeof(SnapshotRoad),
+                                           &header.checksum);
+                header.roadsCount++;
+            }
+            iterator = iterator->next;
+        }
+    }
+
+    iterator = map->routes->begin;
+    while (result && iterator != map->routes->end) {
+        Route *route = iterator->data;
+        SnapshotRoute record = {route->routeId, sizeList(route->cities)};
+        result = writeDataSnapshot(file, &record, sizeof(SnapshotRoute),
+                                   &header.checksum);
+        header.routesCount++;
+        header.routesCitiesCount += record.citiesCount;
+        iterator = iterator->next;
+    }
+
+    iterator = map->routes->begin;
+    while (result && iterator != map->routes->end) {
+        Route *route = iterator->data;
+        ListIterator *cityIterator = route->cities->begin;
+        while (result && cityIterator != route->cities->end) {
+            uint32_t id = ((City *)cityIterator->data)->id;
+            result = writeDataSnapshot(file, &id, sizeof(uint32_t),
+                                       &header.checksum);
+            cityIterator = cityIterator->next;
+        }
+        iterator = iterator->next;
+    }
+
+    free(cities);
+
+    return result && fseek(file, 0, SEEK_SET) == 0 &&
+           fwrite(&header, sizeof(SnapshotHeader), 1, file) == 1 &&
+           fflush(file) == 0;
+}
+
+/** @brief Wyznacza liczbę bajtów pliku za bieżącą pozycją.
+ * Pozycja w pliku się nie zmienia.
+ * @param[in,out] file          - wskaźnik na plik;
+ * @param[out] remaining        - wskaźnik na liczbę pozostałych bajtów.
+ * @return Wartość @p true lub @p false, jeśli nie udało się jej wyznaczyć.
+ */
+bool remainingSizeSnapshot(FILE *file, uint64_t *remaining) {
+    long position = ftell(file);
+    if (position < 0 || fseek(file, 0, SEEK_END) != 0) {
+        return false;
+    }
+
+    long end = ftell(file);
+    if (end < position || fseek(file, position, SEEK_SET) != 0) {
+        return false;
+    }
+    *remaining = (uint64_t)(end - position);
+
+    return true;
+}
+
+/** @brief Sprawdza rozmiary sekcji zapisane w nagłówku obrazu mapy.
+ * Sekcje muszą się mieścić w pozostałej części pliku, a każde miasto ma
+ * w sekcji nazw co najmniej znak końca napisu. Dzięki temu uszkodzony
+ * nagłówek nie prowadzi do alokowania pamięci ponad rozmiar pliku.
+ * @param[in] header            - wskaźnik na nagłówek;
+ * @param[in] remaining         - liczba bajtów pliku za nagłówkiem.
+ * @return Wartość @p true, jeśli rozmiary są poprawne, lub @p false
+ * w przeciwnym przypadku.
+ */
+bool checkSizesSnapshot(const SnapshotHeader *header, uint64_t remaining) {
+    uint64_t sizes[] = {
+        header->namesSize,
+        (uint64_t)header->roadsCount * sizeof(SnapshotRoad),
+        (uint64_t)header->routesCount * sizeof(SnapshotRoute),
+        (uint64_t)header->routesCitiesCount * sizeof(uint32_t)
+    };
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        if (sizes[i] > remaining) {
+            return false;
+        }
+        remaining -= sizes[i];
+    }
+
+    return header->citiesCount <= header->namesSize;
+}
+
+/** @brief Wczytuje sekcję obrazu mapy do nowej tablicy.
+ * @param[in,out] file          - wskaźnik na plik;
+ * @param[in] size              - rozmiar sekcji w bajtach;
+ * @param[in,out] checksum      - wskaźnik na sumę kontrolną.
+ * @return Wskaźnik na tablicę z sekcją lub NULL, jeśli nie udało się
+ * wczytać sekcji lub zaalokować pamięci.
+ */
+void *readSectionSnapshot(FILE *file, size_t size, uint64_t *checksum) {
+    void *result = malloc(size + 1);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    if (fread(result, 1, size, file) != size) {
+        free(result);
+        return NULL;
+    }
+    *checksum = checksumSnapshot(*checksum, result, size);
+
+    return result;
+}
+
+/** @brief Tworzy miasta mapy z sekcji nazw miast.
+ * @param[in,out] map           - wskaźnik na pustą mapę;
+ * @param[in] header            - wskaźnik na nagłówek obrazu;
+ * @param[in] names             - wskaźnik na sekcję nazw miast;
+ * @param[out] cities           - tablica na miasta indeksowana numerami.
+ * @return Wartość @p true lub @p false, jeśli sekcja jest niepoprawna lub nie
+ * udało się zaalokować pamięci.
+ */
+bool addCitiesSnapshot(Map *map, const SnapshotHeader *header,
+                       const char *names, City **cities) {
+    if (header->namesSize == 0 || names[header->namesSize - 1] != 0) {
+        return header->citiesCount == 0 && header->namesSize == 0;
+    }
+
+    const char *name = names;
+    for (uint32_t i = 0; i < header->citiesCount; i++) {
+        if (name >= names + header->namesSize ||
+                !isStringValidCityName(name)) {
+            return false;
+        }
+
+        /* Miasta tworzone są w kolejności numerów, więc powtórzona nazwa
+         * dałaby miasto o innym numerze. */
+        cities[i] = findCityOnHashMapInsertIfNecessary(map->citiesMap,
+                                                       map->cities, name);
+        if (cities[i] == NULL || cities[i]->id != i) {
+            return false;
+        }
+
+        name += strlen(name) + 1;
+    }
+
+    return name == names + header->namesSize;
+}
+
+/** @brief Tworzy odcinki dróg mapy z sekcji odcinków.
+ * @param[in] header            - wskaźnik na nagłówek obrazu;
+ * @param[in] roads             - wskaźnik na sekcję odcinków dróg;
+ * @param[in] cities            - tablica miast indeksowana numerami.
+ * @return Wartość @p true lub @p false, jeśli sekcja jest niepoprawna lub nie
+ * udało się zaalokować pamięci.
+ */
+bool addRoadsSnapshot(const SnapshotHeader *header, const SnapshotRoad *roads,
+                      City **cities) {
+    for (uint32_t i = 0; i < header->roadsCount; i++) {
+        const SnapshotRoad *road = &roads[i];
+        if (road->city1 >= header->citiesCount ||
+                road->city2 >= header->citiesCount ||
+                road->city1 == road->city2 || road->length == 0 ||
+                road->year == 0) {
+            return false;
+        }
+
+        City *city1 = cities[road->city1];
+        City *city2 = cities[road->city2];
+        if (findRoadModule(city1, city2) != NULL ||
+                !addRoadModule(city1, city2, road->length, road->year)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** @brief Tworzy drogi krajowe mapy z sekcji dróg krajowych.
+ * @param[in,out] map           - wskaźnik na mapę z miastami i odcinkami;
+ * @param[in] header            - wskaźnik na nagłówek obrazu;
+ * @param[in] routes            - wskaźnik na sekcję dróg krajowych;
+ * @param[in] routesCities      - wskaźnik na numery miast dróg krajowych;
+ * @param[in] cities            - tablica miast indeksowana numerami.
+ * @return Wartość @p true lub @p false, jeśli sekcja jest niepoprawna lub nie
+ * udało się zaalokować pamięci.
+ */
+bool addRoutesSnapshot(Map *map, const SnapshotHeader *header,
+                       const SnapshotRoute *routes,
+                       const uint32_t *routesCities, City **cities) {
+    /* Numer ostatniej drogi krajowej przechodzącej przez miasto. */
+    uint32_t *lastRoute = calloc(header->citiesCount + 1, sizeof(uint32_t));
+    if (lastRoute == NULL) {
+        return false;
+    }
+
+    bool result = true;
+    uint32_t position = 0;
+    for (uint32_t i = 0; result && i < header->routesCount; i++) {
+        const SnapshotRoute *record = &routes[i];
+        if (record->routeId < 1 || 999 < record->routeId ||
+                record->citiesCount == 0 ||
+                record->citiesCount > header->routesCitiesCount - position ||
+                findRouteOnList(map->routes, record->routeId) != NULL) {
+            result = false;
+            break;
+        }
+
+        Route *route = NULL;
+        City *previous = NULL;
+        for (uint32_t j = 0; result && j < record->citiesCount; j++) {
+            uint32_t id = routesCities[position++];
+            if (id >= header->citiesCount || lastRoute[id] == i + 1) {
+                result = false;
+                break;
+            }
+            lastRoute[id] = i + 1;
+
+            City *city = cities[id];
+            if (previous == NULL) {
+                route = newRouteModule(record->routeId, city, city,
+                                       map->searchState);
+                result = route != NULL;
+            } else {
+                result = findRoadModule(previous, city) != NULL &&
+                         insertList(route->cities->end, city) != NULL;
+            }
+            previous = city;
+        }
+
+        if (result) {
+            result = insertList(map->routes->end, route) != NULL;
+        }
+        if (!result && route != NULL) {
+            deleteRouteModule(route);
+        }
+    }
+
+    free(lastRoute);
+
+    return result && position == header->routesCitiesCount;
+}
+
+/** @brief Wczytuje obraz mapy z pliku.
+ * Mapa musi być nowo utworzona (bez miast i dróg krajowych). Sekcje
+ * wczytywane są w całości do tablic, a po sprawdzeniu sumy kontrolnej
+ * i poprawności danych na ich podstawie tworzone są miasta, odcinki dróg
+ * i drogi krajowe.
+ * @param[in,out] map           - wskaźnik na pustą mapę;
+ * @param[in,out] file          - wskaźnik na plik otwarty do odczytu.
+ * @return Wartość @p true lub @p false, jeśli plik nie jest poprawnym obrazem
+ * mapy lub nie udało się zaalokować pamięci (mapa może wtedy zawierać część
+ * danych).
+ */
+bool readSnapshot(Map *map, FILE *file) {
+    assert(map);
+    assert(file);
+    assert(map->cities->begin == map->cities->end);
+    assert(map->routes->begin == map->routes->end);
+
+    SnapshotHeader header;
+    uint64_t remaining;
+    if (fread(&header, sizeof(SnapshotHeader), 1, file) != 1 ||
+            header.magic != SNAPSHOT_MAGIC ||
+            header.version != SNAPSHOT_VERSION ||
+            header.citiesCount == UINT32_MAX ||
+            !remainingSizeSnapshot(file, &remaining) ||
+            !checkSizesSnapshot(&header, remaining)) {
+        return false;
+    }
+
+    uint64_t checksum = SNAPSHOT_CHECKSUM_SEED;
+    char *names = readSectionSnapshot(file, header.namesSize, &checksum);
+    SnapshotRoad *roads = NULL;
+    SnapshotRoute *routes = NULL;
+    uint32_t *routesCities = NULL;
+    if (names != NULL) {
+        roads = readSectionSnapshot(
+                file, (size_t)header.roadsCount * sizeof(SnapshotRoad),
+                &checksum);
+    }
+    if (roads != NULL) {
+        routes = readSectionSnapshot(
+                file, (size_t)header.routesCount * sizeof(SnapshotRoute),
+                &checksum);
+    }
+    if (routes != NULL) {
+        routesCities = readSectionSnapshot(
+                file, (size_t)header.routesCitiesCount * sizeof(uint32_t),
+                &checksum);
+    }
+    City **cities = malloc(sizeof(City *) * (header.citiesCount + 1));
+
+    bool result = routesCities != NULL && cities != NULL &&
+                  checksum == header.checksum &&
+                  addCitiesSnapshot(map, &header, names, cities) &&
+                  addRoadsSnapshot(&header, roads, cities) &&
+                  addRoutesSnapshot(map, &header, routes, routesCities,
+                                    cities);
+
+    free(names);
+    free(roads);
+    free(routes);
+    free(routesCities);
+    free(cities);
+
+    return result;
+}
+
+/** @brief Odczytuje numer rekordu dziennika zapisany w obrazie mapy.
+ * Czyta tylko nagłówek obrazu.
+ * @param[in,out] file          - wskaźnik na plik otwarty do odczytu;
+ * @param[out] sequence         - wskaźnik na numer pierwszego rekordu
+ *                                dziennika nieuwzględnionego w obrazie.
+ * @return Wartość @p true lub @p false, jeśli plik nie zaczyna się
+ * poprawnym nagłówkiem obrazu mapy.
+ */
+bool readSequenceSnapshot(FILE *file, uint64_t *sequence) {
+    assert(file);
+    assert(sequence);
+
+    SnapshotHeader header;
+    if (fread(&header, sizeof(SnapshotHeader), 1, file) != 1 ||
+            header.magic != SNAPSHOT_MAGIC ||
+            header.version != SNAPSHOT_VERSION) {
+        return false;
+    }
+
+    *sequence = header.journalSequence;
+
+    return true;
+}
@@ -0,0 +1,111 @@
+/** @file
+ * Interfejs zapisu i odczytu binarnego obrazu mapy dróg krajowych.
+ *
+ * Obraz składa się z nagłówka @ref SnapshotHeader i trzech sekcji:
+ *  - nazw miast (napisy zakończone zerem, w kolejności numerów miast);
+ *  - odcinków dróg (rekordy @ref SnapshotRoad, każdy odcinek raz);
+ *  - dróg krajowych (rekordy @ref SnapshotRoute w kolejności dróg na mapie,
+ *    a po nich numery kolejnych miast wszystkich dróg krajowych).
+ *
+ * Liczby zapisywane są w kolejności bajtów komputera, a suma kontrolna
+ * (FNV-1a) obejmuje wszystkie sekcje. Obraz zapisany jako punkt kontrolny
+ * dziennika (zob. @ref journal.h) zawiera numer pierwszego rekordu
+ * dziennika, którego nie uwzględnia.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "map.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SNAPSHOT_MAGIC 0x50414d52u
+///< liczba rozpoznająca obraz mapy (i kolejność bajtów)
+
+#define SNAPSHOT_VERSION 2u
+///< wersja formatu obrazu mapy
+
+#define SNAPSHOT_CHECKSUM_SEED 14695981039346656037ull
+///< początkowa wartość sumy kontrolnej
+
+/**
+ * Struktura przechowująca nagłówek obrazu mapy.
+ */
+typedef struct SnapshotHeader {
+    uint32_t magic;                 ///< @ref SNAPSHOT_MAGIC
+    uint32_t version;               ///< @ref SNAPSHOT_VERSION
+    uint32_t citiesCount;           ///< liczba miast
+    uint32_t roadsCount;            ///< liczba odcinków dróg
+    uint32_t routesCount;           ///< liczba dróg krajowych
+    uint32_t routesCitiesCount;     ///< łączna liczba miast dróg krajowych
+    uint64_t namesSize;             ///< rozmiar sekcji nazw miast w bajtach
+    uint64_t journalSequence;       ///< numer pierwszego rekordu dziennika
+                                    ///< nieuwzględnionego w obrazie
+    uint64_t checksum;              ///< suma kontrolna sekcji
+} SnapshotHeader;
+
+/**
+ * Struktura przechowująca odcinek drogi w obrazie mapy.
+ */
+typedef struct SnapshotRoad {
+    uint32_t city1;                 ///< numer pierwszego miasta
+    uint32_t city2;                 ///< numer drugiego miasta
+    uint32_t length;                ///< długość odcinka
+    int32_t year;                   ///< rok budowy lub ostatniego remontu
+} SnapshotRoad;
+
+/**
+ * Struktura przechowująca drogę krajową w obrazie mapy.
+ */
+typedef struct SnapshotRoute {
+    uint32_t routeId;               ///< numer drogi krajowej
+    uint32_t citiesCount;           ///< liczba miast drogi krajowej
+} SnapshotRoute;
+
+/** @brief Aktualizuje sumę kontrolną.
+ * @param[in] checksum          - dotychczasowa suma kontrolna;
+ * @param[in] data              - wskaźnik na dane;
+ * @param[in] size              - rozmiar danych w bajtach.
+ * @return Suma kontrolna uwzględniająca dane.
+ */
+uint64_t checksumSnapshot(uint64_t checksum, const void *data, size_t size);
+
+/** @brief Zapisuje obraz mapy do pliku.
+ * @param[in] map               - wskaźnik na mapę;
+ * @param[in,out] file          - wskaźnik na plik otwarty do zapisu.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zapisać pliku lub
+ * zaalokować pamięci.
+ */
+bool writeSnapshot(Map *map, FILE *file);
+
+/** @brief Wczytuje obraz mapy z pliku.
+ * Mapa musi być nowo utworzona (bez miast i dróg krajowych). Sekcje
+ * wczytywane są w całości do tablic, a po sprawdzeniu sumy kontrolnej
+ * i poprawności danych na ich podstawie tworzone są miasta, odcinki dróg
+ * i drogi krajowe.
+ * @param[in,out] map           - wskaźnik na pustą mapę;
+ * @param[in,out] file          - wskaźnik na plik otwarty do odczytu.
+ * @return Wartość @p true lub @p false, jeśli plik nie jest poprawnym obrazem
+ * mapy lub nie udało się zaalokować pamięci (mapa może wtedy zawierać część
+ * danych).
+ */
+bool readSnapshot(Map *map, FILE *file);
+
+/** @brief Odczytuje numer rekordu dziennika zapisany w obrazie mapy.
+ * Czyta tylko nagłówek obrazu.
+ * @param[in,out] file          - wskaźnik na plik otwarty do odczytu;
+ * @param[out] sequence         - wskaźnik na numer pierwszego rekordu
+ *                                dziennika nieuwzględnionego w obrazie.
+ * @return Wartość @p true lub @p false, jeśli plik nie zaczyna się
+ * poprawnym nagłówkiem obrazu mapy.
+ */
+bool readSequenceSnapshot(FILE *file, uint64_t *sequence);
+
+#endif // SNAPSHOT_H
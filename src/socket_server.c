@@ -0,0 +1,702 @@
+/** @file
+ * Implementacja serwera obsługującego polecenia tekstowe wielu klientów przez
+ * gniazdo domeny uniksowej.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "socket_server.h"
+#include "command_parser.h"
+#include "list.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#define SOCKET_SERVER_BACKLOG 64
+///< długość kolejki połączeń oczekujących na przyjęcie
+
+#define SOCKET_SERVER_EVENTS_COUNT 64
+///< największa liczba zdarzeń odbieranych jednym wywołaniem epoll_wait
+
+#define SOCKET_SERVER_READ_SIZE 65536
+///< liczba bajtów czytanych od klienta jednym wywołaniem recv
+
+#define SOCKET_SERVER_BATCH_SIZE 1024
+///< największa liczba wierszy klienta wykonywanych w jednym obrocie pętli
+
+#define SOCKET_SERVER_INPUT_LIMIT (1 << 20)
+///< liczba niewykonanych bajtów klienta, od której wstrzymuje się czytanie
+
+#define SOCKET_SERVER_OUTPUT_LIMIT (1 << 20)
+///< liczba niewysłanych bajtów klienta, od której wstrzymuje się wykonywanie
+
+#define SOCKET_SERVER_DESCRIPTION_SIZE 256
+///< wolne miejsce w buforze wyników przed zapisaniem opisu drogi krajowej
+
+#define SOCKET_SERVER_ERROR_SIZE 32
+///< rozmiar bufora na komunikat o błędzie
+
+/**
+ * Struktura przechowująca stan połączenia z klientem.
+ */
+typedef struct ServerClient {
+    int descriptor;                 ///< deskryptor połączenia
+    ListIterator *iterator;         ///< węzeł listy klientów serwera
+    char *input;                    ///< odebrane dane klienta
+    size_t inputStart;              ///< początek niewykonanych danych
+    size_t inputSize;               ///< koniec odebranych danych
+    size_t inputMemorySize;         ///< rozmiar bufora odebranych danych
+    char *output;                   ///< wyniki do wysłania klientowi
+    size_t outputSent;              ///< początek niewysłanych wyników
+    size_t outputSize;              ///< koniec wyników
+    size_t outputMemorySize;        ///< rozmiar bufora wyników
+    uint32_t lineNumber;            ///< numer ostatnio wykonanego wiersza
+    uint32_t events;                ///< zdarzenia zarejestrowane w epoll
+    bool isInputClosed;             ///< czy klient zakończył wysyłanie
+} ServerClient;
+
+/**
+ * Struktura przechowująca stan serwera.
+ */
+typedef struct SocketServer {
+    Map *map;                       ///< wskaźnik na mapę
+    CommandParser *parser;          ///< parser wierszy wszystkich klientów
+    List *clients;                  ///< lista połączonych klientów
+    int listener;                   ///< deskryptor gniazda nasłuchującego
+    int signals;                    ///< deskryptor sygnałów kończących
+    int epoll;                      ///< deskryptor pętli zdarzeń
+    uint64_t clientsCount;          ///< liczba połączonych klientów
+    SocketServerStatistics *statistics; ///< wskaźnik na liczniki serwera
+} SocketServer;
+
+/** @brief Wypełnia zbiór sygnałów kończących serwer.
+ * @param[out] signals      - wskaźnik na zbiór sygnałów.
+ */
+void fillSignalsSocketServer(sigset_t *signals) {
+    sigemptyset(signals);
+    sigaddset(signals, SIGINT);
+    sigaddset(signals, SIGTERM);
+}
+
+/** @brief Blokuje sygnały kończące serwer.
+ * Sygnały SIGINT i SIGTERM są odbierane przez pętlę zdarzeń serwera, więc
+ * muszą być zablokowane we wszystkich wątkach. Funkcję trzeba wywołać przed
+ * utworzeniem wątków (także wątków mapy).
+ * @return Wartość @p true lub @p false, jeśli nie udało się zablokować
+ * sygnałów.
+ */
+bool blockSignalsSocketServer(void) {
+    sigset_t signals;
+    fillSignalsSocketServer(&signals);
+    return pthread_sigmask(SIG_BLOCK, &signals, NULL) == 0;
+}
+
+/** @brief Zapewnia miejsce w buforze.
+ * @param[in,out] buffer        - wskaźnik na bufor;
+ * @param[in,out] memorySize    - wskaźnik na rozmiar bufora;
+ * @param[in] size              - potrzebny rozmiar bufora.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool reserveSocketServer(char **buffer, size_t *memorySize, size_t size) {
+    assert(buffer && memorySize);
+
+    if (size <= *memorySize) {
+        return true;
+    }
+
+    size_t newMemorySize = 2 * *memorySize;
+    if (newMemorySize < size) {
+        newMemorySize = size;
+    }
+
+    char *newBuffer = realloc(*buffer, newMemorySize);
+    if (newBuffer == NULL) {
+        return false;
+    }
+
+    *buffer = newBuffer;
+    *memorySize = newMemorySize;
+    return true;
+}
+
+/** @brief Zamyka połączenie z klientem i usuwa jego stan.
+ * @param[in,out] server        - wskaźnik na serwer;
+ * @param[in] client            - wskaźnik na usuwanego klienta.
+ */
+void deleteClientSocketServer(SocketServer *server, ServerClient *client) {
+    assert(server && client);
+
+    close(client->descriptor);
+    eraseList(client->iterator, false);
+    free(client->input);
+    free(client->output);
+    free(client);
+    server->clientsCount--;
+}
+
+/** @brief Przyjmuje oczekujące połączenia.
+ * Połączenia, dla których nie udało się zaalokować pamięci, są zamykane.
+ * @param[in,out] server        - wskaźnik na serwer.
+ */
+void acceptClientsSocketServer(SocketServer *server) {
+    assert(server);
+
+    while (true) {
+        int descriptor = accept4(server->listener, NULL, NULL,
+                                 SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (descriptor == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            return;
+        }
+
+        ServerClient *client = calloc(1, sizeof(ServerClient));
+        if (client == NULL) {
+            close(descriptor);
+            continue;
+        }
+
+        client->descriptor = descriptor;
+        client->events = EPOLLIN;
+        client->iterator = insertList(server->clients->end, client);
+        if (client->iterator == NULL) {
+            close(descriptor);
+            free(client);
+            continue;
+        }
+
+        server->clientsCount++;
+        struct epoll_event event = {.events = EPOLLIN, .data.ptr = client};
+        if (epoll_ctl(server->epoll, EPOLL_CTL_ADD, descriptor,
+                      &event) == -1) {
+            deleteClientSocketServer(server, client);
+            continue;
+        }
+
+        server->statistics->clientsCount++;
+        if (server->clientsCount > server->statistics->maxClientsCount) {
+            server->statistics->maxClientsCount = server->clientsCount;
+        }
+    }
+}
+
+/** @brief Odbiera dane klienta.
+ * Przesuwa niewykonane dane na początek bufora i dopisuje do nich jedną
+ * porcję odebranych danych.
+ * @param[in,out] client        - wskaźnik na klienta.
+ * @return Wartość @p true lub @p false, jeśli połączenie trzeba zamknąć
+ * (błąd połączenia lub brak pamięci).
+ */
+bool readClientSocketServer(ServerClient *client) {
+    assert(client);
+
+    if (client->inputStart > 0) {
+        client->inputSize -= client->inputStart;
+        memmove(client->input, client->input + client->inputStart,
+                client->inputSize);
+        client->inputStart = 0;
+    }
+
+    /* Jeden bajt więcej na znak '\n' kończący ostatni wiersz. */
+    if (!reserveSocketServer(&client->input, &client->inputMemorySize,
+                             client->inputSize + SOCKET_SERVER_READ_SIZE +
+                             1)) {
+        return false;
+    }
+
+    ssize_t size = recv(client->descriptor, client->input + client->inputSize,
+                        SOCKET_SERVER_READ_SIZE, 0);
+    if (size > 0) {
+        client->inputSize += size;
+    } else if (size == 0) {
+        client->isInputClosed = true;
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        return false;
+    }
+
+    return true;
+}
+
+/** @brief Dopisuje tekst do wyników klienta.
+ * @param[in,out] client        - wskaźnik na klienta;
+ * @param[in] text              - wskaźnik na tekst;
+ * @param[in] size              - długość tekstu.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool appendClientSocketServer(ServerClient *client, const char *text,
+                              size_t size) {
+    assert(client && text);
+
+    if (!reserveSocketServer(&client->output, &client->outputMemorySize,
+                             client->outputSize + size)) {
+        return false;
+    }
+
+    memcpy(client->output + client->outputSize, text, size);
+    client->outputSize += size;
+    return true;
+}
+
+/** @brief Dopisuje opis drogi krajowej do wyników klienta.
+ * Dopisuje jeden wiersz z wynikiem funkcji @ref getRouteDescription.
+ * @param[in] map               - wskaźnik na mapę;
+ * @param[in,out] client        - wskaźnik na klienta;
+ * @param[in] routeId           - numer drogi krajowej.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool describeRouteSocketServer(Map *map, ServerClient *client,
+                               unsigned routeId) {
+    assert(map && client);
+
+    if (!reserveSocketServer(&client->output, &client->outputMemorySize,
+                             client->outputSize +
+                             SOCKET_SERVER_DESCRIPTION_SIZE)) {
+        return false;
+    }
+
+    /* Zero kończące opis zamieniane jest na znak '\n'. */
+    size_t freeSize = client->outputMemorySize - client->outputSize;
+    size_t size = writeRouteDescription(map, routeId,
+                                        client->output + client->outputSize,
+                                        freeSize);
+    if (size >= freeSize) {
+        if (!reserveSocketServer(&client->output, &client->outputMemorySize,
+                                 client->outputSize + size + 1)) {
+            return false;
+        }
+        writeRouteDescription(map, routeId,
+                              client->output + client->outputSize, size + 1);
+    }
+
+    client->output[client->outputSize + size] = '\n';
+    client->outputSize += size + 1;
+    return true;
+}
+
+/** @brief Dopisuje wynik zapytania do wyników klienta.
+ * Dopisuje wynik funkcji @ref queryCommandMap zakończony znakiem '\n'.
+ * @param[in,out] map           - wskaźnik na mapę;
+ * @param[in,out] client        - wskaźnik na klienta;
+ * @param[in] command           - wskaźnik na zapytanie
+ *                                (@ref isQueryCommandMap);
+ * @param[out] isCorrect        - czy zapytanie zakończyło się sukcesem.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci na wyniki klienta.
+ */
+bool querySocketServer(Map *map, ServerClient *client,
+                       const Command *command, bool *isCorrect) {
+    assert(map && client && command && isCorrect);
+
+    char *result = (char *) queryCommandMap(map, command);
+    *isCorrect = result != NULL;
+    if (result == NULL) {
+        return true;
+    }
+
+    size_t size = strlen(result);
+    result[size] = '\n';
+    bool isAppended = appendClientSocketServer(client, result, size + 1);
+    free(result);
+    return isAppended;
+}
+
+/** @brief Wykonuje wiersz klienta.
+ * Wiersz jest obsługiwany jak w @ref nextCommandTextInterface, ale wyniki
+ * i komunikaty o błędach są dopisywane do wyników klienta.
+ * @param[in,out] server        - wskaźnik na serwer;
+ * @param[in,out] client        - wskaźnik na klienta;
+ * @param[in,out] line          - wskaźnik na wiersz zakończony znakiem '\n';
+ * @param[in] isTerminated      - czy klient zakończył wiersz znakiem '\n'.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool executeLineSocketServer(SocketServer *server, ServerClient *client,
+                             char *line, bool isTerminated) {
+    assert(server && client && line);
+
+    client->lineNumber++;
+    Command command;
+    int result = parseLineCommandParser(server->parser, &command, line,
+                                        isTerminated);
+    if (result == 2) {
+        return false;
+    }
+    if (result == 3) {
+        return true;
+    }
+
+    bool isCorrect = false;
+    if (result == 0) {
+        if (command.type == COMMAND_GET_ROUTE_DESCRIPTION) {
+            if (!describeRouteSocketServer(server->map, client,
+                                           command.routeId)) {
+                return false;
+            }
+            isCorrect = true;
+        } else if (isQueryCommandMap(&command)) {
+            if (!querySocketServer(server->map, client, &command,
+                                   &isCorrect)) {
+                return false;
+            }
+        } else {
+            isCorrect = executeCommandMap(server->map, &command);
+        }
+    }
+
+    if (isCorrect) {
+        return true;
+    }
+
+    char error[SOCKET_SERVER_ERROR_SIZE];
+    int size = snprintf(error, sizeof(error), "ERROR %" PRIu32 "\n",
+                        client->lineNumber);
+    return appendClientSocketServer(client, error, size);
+}
+
+/** @brief Sprawdza, czy niewykonane dane klienta zawierają znak '\n'.
+ * @param[in] client            - wskaźnik na klienta.
+ * @return Wartość @p true, jeśli dane zawierają cały wiersz.
+ */
+bool hasLineClientSocketServer(const ServerClient *client) {
+    assert(client);
+
+    size_t size = client->inputSize - client->inputStart;
+    return size > 0 &&
+           memchr(client->input + client->inputStart, '\n', size) != NULL;
+}
+
+/** @brief Sprawdza, czy klient ma wiersz gotowy do wykonania.
+ * Wiersz jest gotowy, jeśli jest zakończony znakiem '\n' albo jest ostatnim
+ * wierszem klienta, a niewysłane wyniki klienta nie przekraczają
+ * @ref SOCKET_SERVER_OUTPUT_LIMIT.
+ * @param[in] client            - wskaźnik na klienta.
+ * @return Wartość @p true, jeśli wiersz jest gotowy.
+ */
+bool isReadyClientSocketServer(const ServerClient *client) {
+    assert(client);
+
+    if (client->outputSize - client->outputSent >=
+            SOCKET_SERVER_OUTPUT_LIMIT) {
+        return false;
+    }
+
+    if (client->isInputClosed) {
+        return client->inputStart < client->inputSize;
+    }
+
+    return hasLineClientSocketServer(client);
+}
+
+/** @brief Wykonuje gotowe wiersze klienta.
+ * Wykonuje co najwyżej @ref SOCKET_SERVER_BATCH_SIZE wierszy.
+ * @param[in,out] server        - wskaźnik na serwer;
+ * @param[in,out] client        - wskaźnik na klienta.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool executeClientSocketServer(SocketServer *server, ServerClient *client) {
+    assert(server && client);
+
+    uint32_t count = 0;
+    while (count < SOCKET_SERVER_BATCH_SIZE &&
+           isReadyClientSocketServer(client)) {
+        char *line = client->input + client->inputStart;
+        size_t size = client->inputSize - client->inputStart;
+        char *newline = memchr(line, '\n', size);
+        bool isTerminated = newline != NULL;
+
+        /* Bufor ma zawsze miejsce na znak '\n' za odebranymi danymi. */
+        if (isTerminated) {
+            client->inputStart = newline + 1 - client->input;
+        } else {
+            line[size] = '\n';
+            client->inputStart = client->inputSize;
+        }
+
+        count++;
+        if (!executeLineSocketServer(server, client, line, isTerminated)) {
+            server->statistics->linesCount += count;
+            return false;
+        }
+    }
+
+    server->statistics->linesCount += count;
+    return true;
+}
+
+/** @brief Wysyła wyniki klienta.
+ * Wysyła tyle wyników, ile przyjmie połączenie bez czekania.
+ * @param[in,out] client        - wskaźnik na klienta.
+ * @return Wartość @p true lub @p false, jeśli połączenie zostało zerwane.
+ */
+bool flushClientSocketServer(ServerClient *client) {
+    assert(client);
+
+    while (client->outputSent < client->outputSize) {
+        ssize_t size = send(client->descriptor,
+                            client->output + client->outputSent,
+                            client->outputSize - client->outputSent,
+                            MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (size >= 0) {
+            client->outputSent += size;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return true;
+        } else if (errno != EINTR) {
+            return false;
+        }
+    }
+
+    client->outputSent = 0;
+    client->outputSize = 0;
+    return true;
+}
+
+/** @brief Uaktualnia zdarzenia klienta zarejestrowane w epoll.
+ * Czytanie jest wstrzymane po końcu danych klienta i wtedy, gdy
+ * niewykonane dane przekraczają @ref SOCKET_SERVER_INPUT_LIMIT i zawierają
+ * gotowy wiersz. Gotowość do wysyłania jest potrzebna, jeśli zostały
+ * niewysłane wyniki.
+ * @param[in] server            - wskaźnik na serwer;
+ * @param[in,out] client        - wskaźnik na klienta.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zmienić zdarzeń.
+ */
+bool updateEventsSocketServer(const SocketServer *server,
+                              ServerClient *client) {
+    assert(server && client);
+
+    uint32_t events = 0;
+    if (!client->isInputClosed &&
+            (client->inputSize - client->inputStart <
+             SOCKET_SERVER_INPUT_LIMIT || !hasLineClientSocketServer(client))) {
+        events |= EPOLLIN;
+    }
+    if (client->outputSent < client->outputSize) {
+        events |= EPOLLOUT;
+    }
+
+    if (events == client->events) {
+        return true;
+    }
+
+    struct epoll_event event = {.events = events, .data.ptr = client};
+    if (epoll_ctl(server->epoll, EPOLL_CTL_MOD, client->descriptor,
+                  &event) == -1) {
+        return false;
+    }
+
+    client->events = events;
+    return true;
+}
+
+/** @brief Wykonuje gotowe wiersze wszystkich klientów i wysyła wyniki.
+ * Zamyka połączenia klientów, którzy zakończyli wysyłanie i dostali
+ * wszystkie wyniki, oraz połączenia, których nie udało się obsłużyć.
+ * @param[in,out] server        - wskaźnik na serwer.
+ * @return Wartość @p true, jeśli któryś klient ma jeszcze gotowy wiersz.
+ */
+bool executeBatchSocketServer(SocketServer *server) {
+    assert(server);
+
+    uint64_t linesCount = server->statistics->linesCount;
+    bool isPending = false;
+    ListIterator *iterator = server->clients->begin;
+    while (iterator != server->clients->end) {
+        ServerClient *client = iterator->data;
+        iterator = iterator->next;
+
+        bool isCorrect = executeClientSocketServer(server, client) &&
+                         flushClientSocketServer(client) &&
+                         updateEventsSocketServer(server, client);
+        bool isFinished = client->isInputClosed &&
+                          client->inputStart == client->inputSize &&
+                          client->outputSize == 0;
+        if (!isCorrect || isFinished) {
+            deleteClientSocketServer(server, client);
+        } else if (isReadyClientSocketServer(client)) {
+            isPending = true;
+        }
+    }
+
+    if (server->statistics->linesCount != linesCount) {
+        server->statistics->batchesCount++;
+    }
+    return isPending;
+}
+
+/** @brief Tworzy gniazdo nasłuchujące.
+ * Wcześniej istniejące gniazdo o tej samej ścieżce jest usuwane.
+ * @param[in] path              - ścieżka gniazda.
+ * @return Deskryptor gniazda lub @p -1, jeśli nie udało się go utworzyć.
+ */
+int newListenerSocketServer(const char *path) {
+    assert(path);
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+
+    struct stat status;
+    if (stat(path, &status) == 0 && S_ISSOCK(status.st_mode)) {
+        unlink(path);
+    }
+
+    int descriptor = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK |
+                            SOCK_CLOEXEC, 0);
+    if (descriptor == -1) {
+        return -1;
+    }
+
+    if (bind(descriptor, (struct sockaddr *) &address,
+             sizeof(address)) == -1 ||
+            listen(descriptor, SOCKET_SERVER_BACKLOG) == -1) {
+        close(descriptor);
+        return -1;
+    }
+
+    return descriptor;
+}
+
+/** @brief Rejestruje deskryptor w pętli zdarzeń.
+ * @param[in] server            - wskaźnik na serwer;
+ * @param[in] descriptor        - deskryptor;
+ * @param[in] data              - wskaźnik zwracany ze zdarzeniami.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zarejestrować
+ * deskryptora.
+ */
+bool addDescriptorSocketServer(const SocketServer *server, int descriptor,
+                               void *data) {
+    assert(server);
+
+    struct epoll_event event = {.events = EPOLLIN, .data.ptr = data};
+    return epoll_ctl(server->epoll, EPOLL_CTL_ADD, descriptor, &event) == 0;
+}
+
+/** @brief Obsługuje zdarzenia do otrzymania sygnału kończącego.
+ * @param[in,out] server        - wskaźnik na serwer.
+ * @return Wartość @p true lub @p false, jeśli oczekiwanie na zdarzenia
+ * zakończyło się błędem.
+ */
+bool loopSocketServer(SocketServer *server) {
+    assert(server);
+
+    struct epoll_event events[SOCKET_SERVER_EVENTS_COUNT];
+    bool isPending = false;
+    while (true) {
+        int count = epoll_wait(server->epoll, events,
+                               SOCKET_SERVER_EVENTS_COUNT,
+                               isPending ? 0 : -1);
+        if (count == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        for (int i = 0; i < count; i++) {
+            void *data = events[i].data.ptr;
+            if (data == &server->listener) {
+                acceptClientsSocketServer(server);
+            } else if (data == &server->signals) {
+                return true;
+            } else {
+                ServerClient *client = data;
+                if ((events[i].events & EPOLLERR) ||
+                        ((events[i].events & (EPOLLIN | EPOLLHUP)) &&
+                         !client->isInputClosed &&
+                         !readClientSocketServer(client))) {
+                    deleteClientSocketServer(server, client);
+                }
+            }
+        }
+
+        isPending = executeBatchSocketServer(server);
+    }
+}
+
+/** @brief Obsługuje klientów do otrzymania sygnału SIGINT lub SIGTERM.
+ * Tworzy gniazdo o ścieżce @p path (usuwa wcześniej istniejące gniazdo
+ * o tej ścieżce) i usuwa je po zakończeniu. Każdy wiersz klienta jest
+ * obsługiwany jak w @ref nextCommandTextInterface, ale wyniki polecenia
+ * @ref COMMAND_GET_ROUTE_DESCRIPTION i zapytań (@ref isQueryCommandMap) oraz
+ * komunikat ERROR @p numer wiersza są wysyłane temu klientowi. Koniec danych
+ * klienta kończy jego ostatni wiersz; połączenie jest zamykane po wysłaniu
+ * wszystkich wyników. Połączenie jest
+ * zamykane także wtedy, gdy nie udało się zaalokować pamięci na dane
+ * klienta. Sygnały kończące muszą być zablokowane funkcją
+ * @ref blockSignalsSocketServer.
+ * @param[in,out] map           - wskaźnik na mapę;
+ * @param[in] path              - ścieżka gniazda;
+ * @param[out] statistics       - wskaźnik na liczniki serwera.
+ * @return Wartość @p true lub @p false, jeśli nie udało się utworzyć gniazda
+ * lub pętli zdarzeń.
+ */
+bool runSocketServer(Map *map, const char *path,
+                     SocketServerStatistics *statistics) {
+    assert(map && path && statistics);
+
+    memset(statistics, 0, sizeof(SocketServerStatistics));
+    SocketServer server;
+    memset(&server, 0, sizeof(SocketServer));
+    server.map = map;
+    server.statistics = statistics;
+    server.parser = newCommandParser(NULL);
+    server.clients = newList();
+    server.epoll = epoll_create1(EPOLL_CLOEXEC);
+    server.listener = newListenerSocketServer(path);
+
+    sigset_t signals;
+    fillSignalsSocketServer(&signals);
+    server.signals = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+
+    bool result = false;
+    if (server.parser != NULL && server.clients != NULL &&
+            server.epoll != -1 && server.listener != -1 &&
+            server.signals != -1 &&
+            addDescriptorSocketServer(&server, server.listener,
+                                      &server.listener) &&
+            addDescriptorSocketServer(&server, server.signals,
+                                      &server.signals)) {
+        result = loopSocketServer(&server);
+    }
+
+    if (server.clients != NULL) {
+        while (server.clients->begin != server.clients->end) {
+            deleteClientSocketServer(&server, server.clients->begin->data);
+        }
+        deleteList(server.clients, false);
+    }
+    if (server.listener != -1) {
+        close(server.listener);
+        unlink(path);
+    }
+    if (server.signals != -1) {
+        close(server.signals);
+    }
+    if (server.epoll != -1) {
+        close(server.epoll);
+    }
+    deleteCommandParser(server.parser);
+
+    return result;
+}
@@ -0,0 +1,63 @@
+/** @file
+ * Interfejs serwera obsługującego polecenia tekstowe wielu klientów przez
+ * gniazdo domeny uniksowej.
+ *
+ * Serwer w jednym wątku obsługuje pętlę zdarzeń epoll: przyjmuje połączenia,
+ * czyta dane klientów i wysyła im wyniki. W każdym obrocie pętli wykonuje
+ * na wspólnej mapie wszystkie gotowe (zakończone znakiem '\n') wiersze
+ * klientów, po kolei dla każdego klienta, a wyniki każdego klienta wysyła
+ * jednym wywołaniem send. Każdy klient dostaje tylko swoje wyniki i błędy,
+ * z numerami wierszy liczonymi od początku jego połączenia.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef SOCKET_SERVER_H
+#define SOCKET_SERVER_H
+
+#include "map.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Struktura przechowująca liczniki serwera.
+ */
+typedef struct SocketServerStatistics {
+    uint64_t clientsCount;          ///< liczba przyjętych połączeń
+    uint64_t maxClientsCount;       ///< największa liczba połączeń naraz
+    uint64_t linesCount;            ///< liczba obsłużonych wierszy
+    uint64_t batchesCount;          ///< liczba obrotów pętli z wierszami
+} SocketServerStatistics;
+
+/** @brief Blokuje sygnały kończące serwer.
+ * Sygnały SIGINT i SIGTERM są odbierane przez pętlę zdarzeń serwera, więc
+ * muszą być zablokowane we wszystkich wątkach. Funkcję trzeba wywołać przed
+ * utworzeniem wątków (także wątków mapy).
+ * @return Wartość @p true lub @p false, jeśli nie udało się zablokować
+ * sygnałów.
+ */
+bool blockSignalsSocketServer(void);
+
+/** @brief Obsługuje klientów do otrzymania sygnału SIGINT lub SIGTERM.
+ * Tworzy gniazdo o ścieżce @p path (usuwa wcześniej istniejące gniazdo
+ * o tej ścieżce) i usuwa je po zakończeniu. Każdy wiersz klienta jest
+ * obsługiwany jak w @ref nextCommandTextInterface, ale wyniki polecenia
+ * @ref COMMAND_GET_ROUTE_DESCRIPTION i zapytań (@ref isQueryCommandMap) oraz
+ * komunikat ERROR @p numer wiersza są wysyłane temu klientowi. Koniec danych
+ * klienta kończy jego ostatni wiersz; połączenie jest zamykane po wysłaniu
+ * wszystkich wyników. Połączenie jest
+ * zamykane także wtedy, gdy nie udało się zaalokować pamięci na dane
+ * klienta. Sygnały kończące muszą być zablokowane funkcją
+ * @ref blockSignalsSocketServer.
+ * @param[in,out] map           - wskaźnik na mapę;
+ * @param[in] path              - ścieżka gniazda;
+ * @param[out] statistics       - wskaźnik na liczniki serwera.
+ * @return Wartość @p true lub @p false, jeśli nie udało się utworzyć gniazda
+ * lub pętli zdarzeń.
+ */
+bool runSocketServer(Map *map, const char *path,
+                     SocketServerStatistics *statistics);
+
+#endif // SOCKET_SERVER_H
@@ -147,3 +147,85 @@ bool appendStringBuilderChar(StringBuilder *string, char character) {
 
     return true;
 }
+
+/** @brief Zaczyna tworzenie napisu w buforze.
+ * @param[out] writer               - wskaźnik na inicjalizowaną strukturę;
+ * @param[in] buffer                - wskaźnik na bufor lub NULL;
+ * @param[in] bufferSize            - rozmiar bufora (@p 0 dla NULL).
+ */
+void initStringWriter(StringWriter *writer, char *buffer, size_t bufferSize) {
+    assert(writer);
+    assert(buffer != NULL || bufferSize == 0);
+
+    writer->buffer = buffer;
+    writer->bufferSize = bufferSize;
+    writer->size = 0;
+}
+
+/** @brief Dodaje znaki do napisu w buforze.
+ * Kopiuje tylko znaki mieszczące się w buforze przed zerem kończącym napis.
+ * @param[in,out] writer            - wskaźnik na tworzony napis;
+ * @param[in] data                  - wskaźnik na znaki;
+ * @param[in] length                - liczba znaków.
+ */
+void appendStringWriterData(StringWriter *writer, const char *data,
+                            size_t length) {
+    if (writer->size + 1 < writer->bufferSize) {
+        size_t space = writer->bufferSize - 1 - writer->size;
+        memcpy(writer->buffer + writer->size, data,
+               length < space ? length : space);
+    }
+
+    writer->size += length;
+}
+
+/** @brief Dodaje słowo do napisu w buforze.
+ * Dodaje znak ';' (jeśli napis nie jest pusty) i dane słowo.
+ * @param[in,out] writer            - wskaźnik na tworzony napis;
+ * @param[in] string                - wskaźnik na dodawane słowo.
+ */
+void appendStringWriterString(StringWriter *writer, const char *string) {
+    assert(writer);
+    assert(string);
+
+    if (writer->size > 0) {
+        appendStringWriterData(writer, ";", 1);
+    }
+    appendStringWriterData(writer, string, strlen(string));
+}
+
+/** @brief Dodaje liczbę do napisu w buforze.
+ * Dodaje znak ';' (jeśli napis nie jest pusty) i daną liczbę.
+ * @param[in,out] writer            - wskaźnik na tworzony napis;
+ * @param[in] integer               - dodawana liczba.
+ */
+void appendStringWriterInteger(StringWriter *writer, int64_t integer) {
+    assert(writer);
+
+    char digits[INTEGER_LENGTH];
+    int length = sprintf(digits, "%" PRId64, integer);
+
+    if (writer->size > 0) {
+        appendStringWriterData(writer, ";", 1);
+    }
+    appendStringWriterData(writer, digits, (size_t)length);
+}
+
+/** @brief Kończy tworzenie napisu w buforze.
+ * Zapisuje zero kończące napis (jeśli bufor nie jest pusty), obcinając
+ * napis do rozmiaru bufora.
+ * @param[in,out] writer            - wskaźnik na tworzony napis.
+ * @return Długość całego napisu (bez zera na końcu), także jeśli nie
+ * zmieścił się w buforze.
+ */
+size_t finishStringWriter(StringWriter *writer) {
+    assert(writer);
+
+    if (writer->bufferSize > 0) {
+        size_t end = writer->size < writer->bufferSize ?
+                     writer->size : writer->bufferSize - 1;
+        writer->buffer[end] = 0;
+    }
+
+    return writer->size;
+}
@@ -10,6 +10,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 /**
   * Struktura przechowująca słowa.
@@ -20,6 +21,17 @@ typedef struct StringBuilder{
     uint32_t reservedMemory;    ///< wielkość zaalokowanej pamięci dla słowa
 } StringBuilder;
 
+/**
+ * Struktura przechowująca napis tworzony w buforze podanym przez
+ * wywołującego, bez alokowania pamięci. Znaki, które nie mieszczą się
+ * w buforze, są tylko liczone.
+ */
+typedef struct StringWriter {
+    char *buffer;               ///< bufor na napis lub NULL
+    size_t bufferSize;          ///< rozmiar bufora
+    size_t size;                ///< długość całego tworzonego napisu
+} StringWriter;
+
 /** @brief Tworzy strukturę.
  * @return Wskaźnik na utworzoną strukturę lub NULL, jeśli nie udało się
  * zaalokować pamięci.
@@ -62,4 +74,34 @@ bool appendStringBuilderInteger(StringBuilder *string, int64_t integer);
  */
 bool appendStringBuilderChar(StringBuilder *string, char character);
 
+/** @brief Zaczyna tworzenie napisu w buforze.
+ * @param[out] writer               - wskaźnik na inicjalizowaną strukturę;
+ * @param[in] buffer                - wskaźnik na bufor lub NULL;
+ * @param[in] bufferSize            - rozmiar bufora (@p 0 dla NULL).
+ */
+void initStringWriter(StringWriter *writer, char *buffer, size_t bufferSize);
+
+/** @brief Dodaje słowo do napisu w buforze.
+ * Dodaje znak ';' (jeśli napis nie jest pusty) i dane słowo.
+ * @param[in,out] writer            - wskaźnik na tworzony napis;
+ * @param[in] string                - wskaźnik na dodawane słowo.
+ */
+void appendStringWriterString(StringWriter *writer, const char *string);
+
+/** @brief Dodaje liczbę do napisu w buforze.
+ * Dodaje znak ';' (jeśli napis nie jest pusty) i daną liczbę.
+ * @param[in,out] writer            - wskaźnik na tworzony napis;
+ * @param[in] integer               - dodawana liczba.
+ */
+void appendStringWriterInteger(StringWriter *writer, int64_t integer);
+
+/** @brief Kończy tworzenie napisu w buforze.
+ * Zapisuje zero kończące napis (jeśli bufor nie jest pusty), obcinając
+ * napis do rozmiaru bufora.
+ * @param[in,out] writer            - wskaźnik na tworzony napis.
+ * @return Długość całego napisu (bez zera na końcu), także jeśli nie
+ * zmieścił się w buforze.
+ */
+size_t finishStringWriter(StringWriter *writer);
+
 #endif // STRING_BUILDER_H
@@ -10,10 +10,46 @@
 
 #include "string_builder.h"
 #include "map.h"
+#include "command_parser.h"
+
+/** @brief Wypisuje informacje o drodze krajowej.
+ * Wypisuje na standardowe wyjście jedną linię z wynikiem funkcji
+ * @ref getRouteDescription. Krótkie opisy zapisywane są w buforze na stosie,
+ * bez alokowania pamięci.
+ * @param[in,out] map       - wskaźnik na mapę;
+ * @param[in] routeId       - numer drogi krajowej.
+ * @return Wartość @p true lub @p false, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+bool printRouteDescriptionTextInterface(Map *map, unsigned routeId);
+
+/** @brief Wypisuje wynik zapytania.
+ * Wypisuje na standardowe wyjście wynik funkcji @ref queryCommandMap
+ * zakończony znakiem końca linii.
+ * @param[in,out] map       - wskaźnik na mapę;
+ * @param[in] command       - wskaźnik na zapytanie (@ref isQueryCommandMap).
+ * @return Wartość @p true lub @p false, jeśli zapytanie zakończyło się
+ * błędem.
+ */
+bool printQueryTextInterface(Map *map, const Command *command);
+
+/** @brief Wykonuje polecenie i wypisuje jego wynik.
+ * Polecenie @ref COMMAND_GET_ROUTE_DESCRIPTION wypisuje funkcją
+ * @ref printRouteDescriptionTextInterface, zapytania (@ref isQueryCommandMap)
+ * funkcją @ref printQueryTextInterface, a pozostałe wykonuje funkcją
+ * @ref executeCommandMap. Jeśli wykonanie zakończyło się błędem, to wypisuje
+ * na standardowe wyjście diagnostyczne jednoliniowy komunikat:
+ * ERROR @p lineNumber.
+ * @param[in,out] map       - wskźnik na mapę;
+ * @param[in] command       - wskaźnik na polecenie;
+ * @param[in] lineNumber    - numer wiersza zawierającego polecenie.
+ */
+void executeCommandTextInterface(Map *map, const Command *command,
+                                 uint32_t lineNumber);
 
 /** @brief Obsługuje pojedynczy wiersz wejścia.
- * Czyta pojedynczy wiersz i wywołuję odpowiednie operacje na danej mapie.
- * Jeśli wiersz jest postaci:
+ * Czyta pojedynczy wiersz parserem @ref nextCommandParser i wywołuję
+ * odpowiednie operacje na danej mapie. Jeśli wiersz jest postaci:
  *  - numer drogi krajowej;nazwa miasta;długość odcinka drogi;rok budowy lub
  *    ostatniego remontu;nazwa miasta;długość odcinka drogi;rok budowy lub
  *    ostatniego remontu;nazwa miasta;…;nazwa miasta - to dodaje drogę
@@ -33,7 +69,10 @@
  *  - removeRoad;city1;city2 - to wywołuje funkcję @ref removeRoad
  *      z podanymi parametrami;
  *  - removeRoute;routeId - to wywołuje funkcję @ref removeRoute
- *      z podanymi parametrami.
+ *      z podanymi parametrami;
+ *  - queryRoute;city1;city2 - to wywołuje funkcję @ref queryRoute
+ *      z podanymi parametrami i wypisuje na standardowe wyjście jedną linię
+ *      z wynikiem jej działania.
  *
  * Jeśli polecenie jest niepoprawne składniowo lub jego wykonanie
  * zakończyło się błędem, czyli odpowiednia funkcja zakończyła się wynikiem
@@ -41,11 +80,13 @@
  * jednoliniowy komunikat: ERROR @p lineNumber.
  * Funkcja akceptuje liczby z wiodącymi zerami.
  * @param[in,out] map       - wskźnik na mapę;
+ * @param[in,out] parser    - wskaźnik na parser poleceń;
  * @param[in] lineNumber    - numer aktualnie obsługiwanej linii wejścia.
  * @return Wartość @p 0 jeśli operacja zakończyła się sukcesem,
  * wartość @p 2 jeśli nie udało się zaalokować pamięci lub
  * wartość @p EOF jeśli wiersz zakończył się znakiem @p EOF.
  */
-int nextCommandTextInterface(Map *map, uint32_t lineNumber);
+int nextCommandTextInterface(Map *map, CommandParser *parser,
+                             uint32_t lineNumber);
 
 #endif // TEXT_INTERFACE_H
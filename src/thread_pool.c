@@ -0,0 +1,221 @@
+/** @file
+ * Implementacja interfejsu klasy przechowującej pulę wątków.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#include "thread_pool.h"
+
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+/**
+ * Struktura przechowująca pulę wątków.
+ */
+typedef struct ThreadPool {
+    pthread_t *threads;             ///< tablica utworzonych wątków
+    uint32_t threadsCount;          ///< liczba wątków wykonujących zadania
+    pthread_mutex_t mutex;          ///< blokada chroniąca pola struktury
+    pthread_cond_t tasksReady;      ///< sygnał o nowej partii zadań
+    pthread_cond_t tasksDone;       ///< sygnał o zakończeniu partii zadań
+    uint64_t generation;            ///< numer aktualnej partii zadań
+    uint32_t workingThreads;        ///< liczba wątków pracujących nad partią
+    bool isStopped;                 ///< czy wątki mają się zakończyć
+    ThreadPoolTask task;            ///< aktualnie wykonywane zadanie
+    void *argument;                 ///< argument aktualnego zadania
+    uint32_t tasksCount;            ///< liczba zadań w aktualnej partii
+    atomic_uint nextTask;           ///< numer kolejnego zadania do wykonania
+} ThreadPool;
+
+/**
+ * Struktura przekazywana do funkcji wątku.
+ */
+typedef struct ThreadPoolWorker {
+    ThreadPool *pool;               ///< wskaźnik na pulę wątków
+    uint32_t threadIndex;           ///< numer wątku
+} ThreadPoolWorker;
+
+/** @brief Wykonuje zadania z aktualnej partii.
+ * Pobiera kolejne numery zadań, dopóki jakieś pozostały.
+ * @param[in,out] pool          - wskaźnik na pulę wątków;
+ * @param[in] threadIndex       - numer wątku.
+ */
+void executeTasksThreadPool(ThreadPool *pool, uint32_t threadIndex) {
+    assert(pool);
+
+    unsigned taskIndex;
+    while ((taskIndex = atomic_fetch_add(&pool->nextTask, 1)) <
+           pool->tasksCount) {
+        pool->task(pool->argument, taskIndex, threadIndex);
+    }
+}
+
+/** @brief Funkcja wykonywana przez wątek puli.
+ * Czeka na kolejne partie zadań i je wykonuje.
+ * @param[in] data              - wskaźnik na @ref ThreadPoolWorker.
+ * @return Wartość NULL.
+ */
+void *workerThreadPool(void *data) {
+    ThreadPoolWorker *worker = data;
+    ThreadPool *pool = worker->pool;
+    uint32_t threadIndex = worker->threadIndex;
+    free(worker);
+
+    uint64_t generation = 0;
+    while (true) {
+        pthread_mutex_lock(&pool->mutex);
+        while (!pool->isStopped && pool->generation == generation) {
+            pthread_cond_wait(&pool->tasksReady, &pool->mutex);
+        }
+        if (pool->isStopped) {
+            pthread_mutex_unlock(&pool->mutex);
+            return NULL;
+        }
+        generation = pool->generation;
+        pthread_mutex_unlock(&pool->mutex);
+
+        executeTasksThreadPool(pool, threadIndex);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->workingThreads == 0) {
+            pthread_cond_signal(&pool->tasksDone);
+        }
+        pthread_mutex_unlock(&pool->mutex);
+    }
+}
+
+/** @brief Zatrzymuje i usuwa wątki puli.
+ * @param[in,out] pool          - wskaźnik na pulę wątków;
+ * @param[in] createdThreads    - liczba utworzonych wątków.
+ */
+void stopThreadsThreadPool(ThreadPool *pool, uint32_t createdThreads) {
+    assert(pool);
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->isStopped = true;
+    pthread_cond_broadcast(&pool->tasksReady);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (uint32_t i = 0; i < createdThreads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+}
+
+/** @brief Tworzy strukturę.
+ * Tworzy pulę wątków. Wątek wywołujący @ref runThreadPool również wykonuje
+ * zadania, więc tworzonych jest @p threadsCount - 1 nowych wątków.
+ * @param[in] threadsCount      - liczba wątków wykonujących zadania.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci lub utworzyć wątków.
+ */
+ThreadPool *newThreadPool(uint32_t threadsCount) {
+    assert(threadsCount > 0);
+
+    ThreadPool *result = malloc(sizeof(ThreadPool));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    result->threads = malloc(sizeof(pthread_t) * threadsCount);
+    if (result->threads == NULL) {
+        free(result);
+        return NULL;
+    }
+
+    result->threadsCount = threadsCount;
+    result->generation = 0;
+    result->workingThreads = 0;
+    result->isStopped = false;
+    result->task = NULL;
+    result->argument = NULL;
+    result->tasksCount = 0;
+    atomic_init(&result->nextTask, 0);
+    pthread_mutex_init(&result->mutex, NULL);
+    pthread_cond_init(&result->tasksReady, NULL);
+    pthread_cond_init(&result->tasksDone, NULL);
+
+    for (uint32_t i = 0; i + 1 < threadsCount; i++) {
+        ThreadPoolWorker *worker = malloc(sizeof(ThreadPoolWorker));
+        if (worker != NULL) {
+            worker->pool = result;
+            worker->threadIndex = i + 1;
+        }
+
+        if (worker == NULL ||
+                pthread_create(&result->threads[i], NULL, workerThreadPool,
+                               worker) != 0) {
+            free(worker);
+            stopThreadsThreadPool(result, i);
+            deleteThreadPool(result);
+            return NULL;
+        }
+    }
+
+    return result;
+}
+
+/** @brief Usuwa strukturę.
+ * Czeka na zakończenie wątków puli i usuwa strukturę.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] pool              - wskaźnik na usuwaną strukturę.
+ */
+void deleteThreadPool(ThreadPool *pool) {
+    if (pool == NULL) {
+        return;
+    }
+
+    if (!pool->isStopped) {
+        stopThreadsThreadPool(pool, pool->threadsCount - 1);
+    }
+
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->tasksReady);
+    pthread_cond_destroy(&pool->tasksDone);
+    free(pool->threads);
+    free(pool);
+}
+
+/** @brief Liczba wątków puli.
+ * @param[in] pool              - wskaźnik na pulę wątków.
+ * @return Liczba wątków wykonujących zadania (wliczając wątek wywołujący).
+ */
+uint32_t threadsCountThreadPool(ThreadPool *pool) {
+    assert(pool);
+
+    return pool->threadsCount;
+}
+
+/** @brief Wykonuje zadania równolegle.
+ * Wywołuje @p task dla każdego numeru zadania od @p 0 do @p tasksCount - 1
+ * i czeka na zakończenie wszystkich zadań.
+ * @param[in,out] pool          - wskaźnik na pulę wątków;
+ * @param[in] tasksCount        - liczba zadań;
+ * @param[in] task              - wykonywane zadanie;
+ * @param[in,out] argument      - wskaźnik przekazywany do zadania.
+ */
+void runThreadPool(ThreadPool *pool, uint32_t tasksCount, ThreadPoolTask task,
+                   void *argument) {
+    assert(pool);
+    assert(task);
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->task = task;
+    pool->argument = argument;
+    pool->tasksCount = tasksCount;
+    atomic_store(&pool->nextTask, 0);
+    pool->workingThreads = pool->threadsCount - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->tasksReady);
+    pthread_mutex_unlock(&pool->mutex);
+
+    executeTasksThreadPool(pool, 0);
+
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->workingThreads > 0) {
+        pthread_cond_wait(&pool->tasksDone, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
@@ -0,0 +1,61 @@
+/** @file
+ * Interfejs klasy przechowującej pulę wątków.
+ *
+ * @author Paweł Pawlik <pp406289@students.mimuw.edu.pl>
+ * @date 19.10.2026
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Struktura przechowująca pulę wątków.
+ */
+typedef struct ThreadPool ThreadPool;
+
+/** @brief Zadanie wykonywane przez pulę wątków.
+ * @param[in,out] argument      - wskaźnik przekazany do @ref runThreadPool;
+ * @param[in] taskIndex         - numer zadania;
+ * @param[in] threadIndex       - numer wątku wykonującego zadanie
+ *                                (od @p 0 do liczby wątków puli).
+ */
+typedef void (*ThreadPoolTask)(void *argument, uint32_t taskIndex,
+                               uint32_t threadIndex);
+
+/** @brief Tworzy strukturę.
+ * Tworzy pulę wątków. Wątek wywołujący @ref runThreadPool również wykonuje
+ * zadania, więc tworzonych jest @p threadsCount - 1 nowych wątków.
+ * @param[in] threadsCount      - liczba wątków wykonujących zadania.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci lub utworzyć wątków.
+ */
+ThreadPool *newThreadPool(uint32_t threadsCount);
+
+/** @brief Usuwa strukturę.
+ * Czeka na zakończenie wątków puli i usuwa strukturę.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] pool              - wskaźnik na usuwaną strukturę.
+ */
+void deleteThreadPool(ThreadPool *pool);
+
+/** @brief Liczba wątków puli.
+ * @param[in] pool              - wskaźnik na pulę wątków.
+ * @return Liczba wątków wykonujących zadania (wliczając wątek wywołujący).
+ */
+uint32_t threadsCountThreadPool(ThreadPool *pool);
+
+/** @brief Wykonuje zadania równolegle.
+ * Wywołuje @p task dla każdego numeru zadania od @p 0 do @p tasksCount - 1
+ * i czeka na zakończenie wszystkich zadań.
+ * @param[in,out] pool          - wskaźnik na pulę wątków;
+ * @param[in] tasksCount        - liczba zadań;
+ * @param[in] task              - wykonywane zadanie;
+ * @param[in,out] argument      - wskaźnik przekazywany do zadania.
+ */
+void runThreadPool(ThreadPool *pool, uint32_t tasksCount, ThreadPoolTask task,
+                   void *argument);
+
+#endif // THREAD_POOL_H